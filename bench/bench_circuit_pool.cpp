@@ -0,0 +1,157 @@
+// Time to the first message of a conversation over AnonymousRouting: with
+// a circuit built on the send path (build_route(), then send) against one
+// taken from a CircuitPool kept full by its worker. Conversations arrive
+// as a Poisson process over three exit classes, then as a burst on one
+// class; last, a pool with a lifetime of seconds shows circuits being
+// replaced ahead of expiry without a class running dry.
+
+#include "anonymous_routing.h"
+#include "circuit_pool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Crypto::AnonymousRouting;
+using Crypto::CircuitPool;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t RELAYS = 300;
+constexpr size_t CONVERSATIONS = 400;
+constexpr double RATE = 100.0;                  // conversations per second
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))];
+}
+
+struct Run {
+    std::vector<double> first_message;          // seconds
+    std::vector<double> take;
+    size_t hits = 0;
+};
+
+// One conversation: a circuit (from the pool when given), the first
+// message over it, then the circuit closed.
+void converse(AnonymousRouting& anon, CircuitPool* pool, uint32_t exit_class, Run& run) {
+    static const std::string hello(200, 'h');
+    const auto start = Clock::now();
+    std::unique_ptr<AnonymousRouting::Route> route = pool ? pool->take(exit_class) : nullptr;
+    if (pool) run.take.push_back(seconds_since(start));
+    if (route) {
+        ++run.hits;
+    } else {
+        route = std::make_unique<AnonymousRouting::Route>(anon.build_route(exit_class));
+    }
+    anon.send_anonymously(hello, *route);
+    run.first_message.push_back(seconds_since(start));
+    anon.destroy_route(*route);
+}
+
+Run poisson(AnonymousRouting& anon, CircuitPool* pool) {
+    std::mt19937_64 rng(2026);
+    std::exponential_distribution<double> gap(RATE);
+    Run run;
+    auto next = Clock::now();
+    for (size_t c = 0; c < CONVERSATIONS; ++c) {
+        next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(rng)));
+        std::this_thread::sleep_until(next);
+        converse(anon, pool, static_cast<uint32_t>(rng() % AnonymousRouting::EXIT_CLASSES), run);
+    }
+    return run;
+}
+
+void report(const char* label, const Run& run) {
+    std::printf("  %-28s p50 %8.1f us   p99 %8.1f us", label, percentile(run.first_message, 0.5) * 1e6,
+                percentile(run.first_message, 0.99) * 1e6);
+    if (!run.take.empty()) {
+        std::printf("   %3zu/%zu from the pool, take() p50 %.0f ns", run.hits, run.first_message.size(),
+                    percentile(run.take, 0.5) * 1e9);
+    }
+    std::printf("\n");
+}
+
+bool wait_full(const CircuitPool& pool, size_t per_class, double timeout) {
+    const auto start = Clock::now();
+    for (;;) {
+        size_t ready = 0;
+        for (uint32_t c = 0; c < AnonymousRouting::EXIT_CLASSES; ++c) ready += pool.ready(c);
+        if (ready == per_class * AnonymousRouting::EXIT_CLASSES) return true;
+        if (seconds_since(start) > timeout) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout.setstate(std::ios::failbit);
+    AnonymousRouting anon;
+    anon.setup_network(static_cast<int>(RELAYS));
+
+    std::printf("=== Circuit pool: %zu relays, %zu conversations at %.0f/s over %u exit classes ===\n\n", RELAYS,
+                CONVERSATIONS, RATE, AnonymousRouting::EXIT_CLASSES);
+
+    std::printf("Time to the first message (circuit, then 200 bytes through it):\n");
+    report("circuit built on send:", poisson(anon, nullptr));
+    {
+        CircuitPool::Options options;
+        options.per_class = 4;
+        const auto start = Clock::now();
+        CircuitPool pool(anon, options);
+        wait_full(pool, options.per_class, 30.0);
+        const double fill = seconds_since(start);
+        const Run run = poisson(anon, &pool);
+        report("CircuitPool, 4 per class:", run);
+        std::printf("  (pool filled in %.1f ms, %.2f ms per circuit)\n", fill * 1e3,
+                    fill * 1e3 / (options.per_class * AnonymousRouting::EXIT_CLASSES));
+
+        // A burst: 16 conversations at once on one class.
+        wait_full(pool, options.per_class, 30.0);
+        Run burst;
+        for (int i = 0; i < 16; ++i) converse(anon, &pool, AnonymousRouting::EXIT_WEB, burst);
+        report("burst of 16, one class:", burst);
+        const CircuitPool::Stats s = pool.stats();
+        std::printf("  worker: %llu built, %llu taken, %llu misses, %llu failed\n\n",
+                    static_cast<unsigned long long>(s.built), static_cast<unsigned long long>(s.taken),
+                    static_cast<unsigned long long>(s.misses), static_cast<unsigned long long>(s.failed));
+    }
+
+    // Lifetime 3 s, renewed 2 s ahead: each circuit is replaced about
+    // once a second. Sample how many are ready meanwhile.
+    {
+        CircuitPool::Options options;
+        options.per_class = 4;
+        options.lifetime = 3;
+        options.rebuild_ahead = 2;
+        options.poll = std::chrono::milliseconds(20);
+        CircuitPool pool(anon, options);
+        wait_full(pool, options.per_class, 30.0);
+        size_t lowest = options.per_class;
+        const auto start = Clock::now();
+        while (seconds_since(start) < 5.0) {
+            for (uint32_t c = 0; c < AnonymousRouting::EXIT_CLASSES; ++c) lowest = std::min(lowest, pool.ready(c));
+            std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        const CircuitPool::Stats s = pool.stats();
+        std::printf("Expiry, lifetime 3 s, renewed 2 s ahead, 5 s idle:\n");
+        std::printf("  %llu circuits replaced before expiry; fewest ready in a class at any sample: %zu of %zu\n",
+                    static_cast<unsigned long long>(s.replaced), lowest, options.per_class);
+    }
+    std::cout.clear();
+    return 0;
+}
@@ -0,0 +1,206 @@
+// Cover traffic under a budget. A thousand clients send real messages as
+// a Poisson process of 0.2 per second each through MetadataProtection
+// mixes for a minute of simulated time: first without cover (each message
+// out at once), then with CoverTraffic at 1 packet/s per client unbounded,
+// under a byte budget, and at 2 packets/s under a tight CPU budget. Each
+// run reports egress, cover bytes per real byte, the rate the budgets left,
+// how long real messages wait for an instant, and the loops that came back. Last, the same
+// generator over AnonymousRouting circuits, whose exits drop the cover.
+
+#include "anonymous_routing.h"
+#include "cover_traffic.h"
+#include "metadata_protection.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using Crypto::AnonymousRouting;
+using Crypto::CoverTraffic;
+using Crypto::MetadataProtection;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t CLIENTS = 1000;
+constexpr double REAL_RATE = 0.2;               // messages per second per client
+constexpr uint64_t DURATION_MS = 60000;
+constexpr uint64_t STEP_MS = 10;
+const std::string LOOP_ADDRESS = "loop";
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Real messages at REAL_RATE per client, all clients together.
+std::vector<std::pair<uint64_t, uint32_t>> real_schedule() {
+    std::mt19937_64 rng(2026);
+    std::exponential_distribution<double> gap(CLIENTS * REAL_RATE / 1000.0);
+    std::vector<std::pair<uint64_t, uint32_t>> sends;
+    for (double at = gap(rng); at < DURATION_MS; at += gap(rng)) {
+        sends.emplace_back(static_cast<uint64_t>(at), static_cast<uint32_t>(rng() % CLIENTS));
+    }
+    return sends;
+}
+
+// `options` null: no cover, each real message wrapped and sent at once.
+void mix_run(const char* label, const CoverTraffic::Options* options) {
+    MetadataProtection::Options mix_options;
+    mix_options.pool_threshold = 64;
+    mix_options.flush_interval_ms = 200;
+    mix_options.pool_minimum = 8;
+    std::cout.setstate(std::ios::failbit);
+    MetadataProtection mix(mix_options);
+    mix.setup_mix_network(16);
+    std::cout.clear();
+
+    uint64_t now = 0, packets = 0, delivered = 0;
+    auto emit = [&](uint32_t, CoverTraffic::Kind, const std::string& message, const std::string& recipient) {
+        MetadataProtection::MixPacket packet;
+        if (!mix.wrap_message(message, recipient, packet) || !mix.receive(packet, now)) return false;
+        ++packets;
+        return true;
+    };
+    std::unique_ptr<CoverTraffic> cover;
+    if (options) {
+        cover = std::make_unique<CoverTraffic>(emit, *options);
+        for (size_t c = 0; c < CLIENTS; ++c) cover->add_client(LOOP_ADDRESS, 0);
+    }
+    mix.set_delivery_handler([&](const MetadataProtection::Delivery& d) {
+        if (d.recipient == LOOP_ADDRESS) {
+            if (cover) cover->loop_returned(d.message, d.at_ms);
+        } else {
+            ++delivered;
+        }
+    });
+
+    const auto sends = real_schedule();
+    const std::string body(200, 'm');
+    size_t next = 0;
+    const auto start = Clock::now();
+    for (now = 0; now <= DURATION_MS; now += STEP_MS) {
+        for (; next < sends.size() && sends[next].first <= now; ++next) {
+            if (cover) {
+                cover->send(sends[next].second, body, "recipient", now);
+            } else {
+                emit(sends[next].second, CoverTraffic::Kind::REAL, body, "recipient");
+            }
+        }
+        if (cover) cover->advance(now);
+        mix.process(now);
+    }
+    const double wall = seconds_since(start);
+
+    const double seconds = DURATION_MS / 1000.0;
+    const double egress = static_cast<double>(packets * Crypto::Sphinx::PACKET_SIZE) / seconds;
+    std::printf("  %-24s egress %7.1f KB/s  %6llu packets  %5zu real sent  ", label, egress / 1e3,
+                static_cast<unsigned long long>(packets), static_cast<size_t>(cover ? cover->stats().real : packets));
+    if (!cover) {
+        std::printf("overhead  0.00x  wait      0 ms   (%.2f s wall)\n", wall);
+        return;
+    }
+    const CoverTraffic::Stats s = cover->stats();
+    uint64_t cover_dropped = 0;
+    for (size_t m = 0; m < mix.mix_count(); ++m) cover_dropped += mix.mix_stats(m).cover_dropped;
+    std::printf("overhead %5.2fx  wait %6.0f ms   (%.2f s wall)\n", s.overhead, s.mean_wait_ms, wall);
+    std::printf("  %-24s rate %.2f/s per client; %llu drops (%llu dropped by exits), %llu loops (%llu back, "
+                "%.1f s round trip)\n",
+                "", s.rate, static_cast<unsigned long long>(s.drops), static_cast<unsigned long long>(cover_dropped),
+                static_cast<unsigned long long>(s.loops), static_cast<unsigned long long>(s.loops_returned),
+                s.mean_loop_ms / 1e3);
+    std::printf("  %-24s %.1f ms CPU building cover, %.1f us each; backlog %zu\n", "", s.cpu_seconds * 1e3,
+                s.cpu_seconds * 1e6 / std::max<uint64_t>(1, s.drops + s.loops), s.backlog);
+}
+
+// Cover on AnonymousRouting circuits, relayed in process: every relay
+// forwards cover like any cell, the exit drops it or hands a loop back.
+void circuits(size_t clients) {
+    std::cout.setstate(std::ios::failbit);
+    AnonymousRouting anon;
+    anon.setup_network(300);
+    std::cout.clear();
+    std::vector<AnonymousRouting::Route> routes;
+    for (size_t c = 0; c < clients; ++c) routes.push_back(anon.build_route());
+
+    uint64_t now = 0, relayed = 0, dropped = 0, real = 0;
+    CoverTraffic::Options options;
+    options.rate = 2.0;
+    std::unique_ptr<CoverTraffic> cover;
+    cover = std::make_unique<CoverTraffic>(
+        [&](uint32_t client, CoverTraffic::Kind kind, const std::string& message, const std::string&) {
+            const auto& route = routes[client];
+            Crypto::Sphinx::Packet cell;
+            const bool built =
+                kind == CoverTraffic::Kind::DROP
+                    ? anon.build_cover_cell(route, cell)
+                    : anon.build_cell(route, {reinterpret_cast<const uint8_t*>(message.data()), message.size()}, cell);
+            if (route.relays.empty() || !built) return false;
+            uint32_t relay = route.relays.front(), circuit = route.entry_circuit;
+            for (size_t hop = 0; hop <= Crypto::Sphinx::MAX_HOPS; ++hop) {
+                const AnonymousRouting::Forward next = anon.relay_cell(relay, circuit, cell);
+                if (!next.ok) return false;
+                ++relayed;
+                if (next.cover) {
+                    ++dropped;
+                } else if (next.exit) {
+                    const std::string payload = Crypto::Sphinx::open_payload(cell);
+                    if (!cover->loop_returned(payload, now)) ++real;
+                }
+                if (next.exit) return true;
+                relay = next.next_relay;
+                circuit = next.next_circuit;
+            }
+            return false;
+        },
+        options);
+    for (size_t c = 0; c < clients; ++c) cover->add_client(LOOP_ADDRESS, 0);
+
+    std::mt19937_64 rng(7);
+    const std::string body(200, 'a');
+    for (now = 0; now <= DURATION_MS; now += STEP_MS) {
+        // REAL_RATE per client, as above: one message per step at most.
+        if (static_cast<double>(rng() % 1000) < clients * REAL_RATE * STEP_MS) cover->send(static_cast<uint32_t>(rng() % clients), body, "exit", now);
+        cover->advance(now);
+    }
+    const CoverTraffic::Stats s = cover->stats();
+    std::printf("AnonymousRouting, %zu circuits, cover at 2 packets/s per client:\n", clients);
+    std::printf("  %llu cells over %llu relay hops, all %zu bytes; %llu real at the exits, %llu cover dropped, "
+                "%llu loops back; overhead %.2fx\n",
+                static_cast<unsigned long long>(s.real + s.drops + s.loops), static_cast<unsigned long long>(relayed),
+                Crypto::Sphinx::PACKET_SIZE, static_cast<unsigned long long>(real),
+                static_cast<unsigned long long>(dropped), static_cast<unsigned long long>(s.loops_returned),
+                s.overhead);
+}
+
+} // namespace
+
+int main() {
+    Crypto::SecureRandom::seed_deterministic(2026);
+    std::printf("=== Cover traffic (%zu clients, %.1f real messages/s each, %llu s simulated) ===\n\n", CLIENTS,
+                REAL_RATE, static_cast<unsigned long long>(DURATION_MS / 1000));
+
+    std::printf("MetadataProtection, 3 mixes per path:\n");
+    mix_run("no cover", nullptr);
+
+    CoverTraffic::Options options;
+    options.cpu_fraction = 0;
+    mix_run("1/s, no budget", &options);
+
+    options.bytes_per_second = 300e3;
+    mix_run("1/s, 300 KB/s", &options);
+
+    options.rate = 2.0;
+    options.bytes_per_second = 0;
+    options.cpu_fraction = 0.01;
+    mix_run("2/s, 1% of a core", &options);
+    std::printf("\n");
+
+    circuits(200);
+    return 0;
+}
@@ -0,0 +1,119 @@
+// FlatHashMap against the containers the modules used for their state:
+// std::map keyed by "prefix_" + number strings (before Id128), and
+// std::unordered_map keyed by Id128. One million entries; nanoseconds per
+// insert while filling, per lookup of a present key in random order, per
+// lookup of an absent key, and per erase + reinsert at full size.
+
+#include "flat_hash_map.h"
+#include "id128.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using Crypto::FlatHashMap;
+using Crypto::Id128;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t ENTRIES = 1000000;
+constexpr size_t LOOKUPS = 4000000;
+
+// About the size of a module's index record; the bulky fields (content,
+// vectors) live on the heap either way.
+struct Record {
+    std::array<uint64_t, 4> fields;
+};
+
+struct Result {
+    double insert;
+    double hit;
+    double miss;
+    double churn;
+};
+
+template <typename Map, typename Key>
+Result run(const std::vector<Key>& keys, const std::vector<Key>& absent, const std::vector<uint32_t>& order) {
+    Result r{};
+    volatile uint64_t sink = 0;
+    {
+        Map map;
+        const auto start = Clock::now();
+        for (size_t i = 0; i < keys.size(); ++i) map[keys[i]] = Record{{i, 0, 0, 0}};
+        r.insert = std::chrono::duration<double>(Clock::now() - start).count() / keys.size();
+
+        auto t = Clock::now();
+        uint64_t sum = 0;
+        for (size_t i = 0; i < LOOKUPS; ++i) {
+            const auto it = map.find(keys[order[i % order.size()]]);
+            sum += it->second.fields[0];
+        }
+        r.hit = std::chrono::duration<double>(Clock::now() - t).count() / LOOKUPS;
+
+        t = Clock::now();
+        for (size_t i = 0; i < LOOKUPS; ++i) sum += map.find(absent[order[i % order.size()]]) == map.end();
+        r.miss = std::chrono::duration<double>(Clock::now() - t).count() / LOOKUPS;
+
+        // Steady state of a module: records leave and arrive at full size.
+        t = Clock::now();
+        for (size_t i = 0; i < order.size(); ++i) {
+            const Key& k = keys[order[i]];
+            map.erase(k);
+            map[k] = Record{{i, 0, 0, 0}};
+        }
+        r.churn = std::chrono::duration<double>(Clock::now() - t).count() / order.size();
+        sink = sum + map.size();
+    }
+    (void)sink;
+    return r;
+}
+
+void print(const char* name, const Result& r, const Result* base) {
+    std::printf("%-36s%9.1f%9.1f%9.1f%9.1f", name, r.insert * 1e9, r.hit * 1e9, r.miss * 1e9, r.churn * 1e9);
+    if (base != nullptr) std::printf("   (lookup %.1fx)", base->hit / r.hit);
+    std::printf("\n");
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== Module state map benchmark (%zu entries) ===\n\n", ENTRIES);
+
+    std::vector<Id128> ids(ENTRIES), absent_ids(ENTRIES);
+    for (auto& id : ids) id = Id128::generate();
+    for (auto& id : absent_ids) id = Id128::generate();
+
+    // What the modules keyed on before Id128, made unique.
+    std::vector<std::string> names(ENTRIES), absent_names(ENTRIES);
+    for (size_t i = 0; i < ENTRIES; ++i) {
+        names[i] = "file_" + std::to_string(i);
+        absent_names[i] = "file_" + std::to_string(ENTRIES + i);
+    }
+
+    std::mt19937_64 rng(7);
+    std::vector<uint32_t> order(ENTRIES);
+    for (size_t i = 0; i < ENTRIES; ++i) order[i] = static_cast<uint32_t>(i);
+    std::shuffle(order.begin(), order.end(), rng);
+
+    std::printf("%-36s%9s%9s%9s%9s   ns per operation\n", "", "insert", "hit", "miss", "churn");
+    const Result tree = run<std::map<std::string, Record>>(names, absent_names, order);
+    print("std::map<std::string>", tree, nullptr);
+    const Result node = run<std::unordered_map<Id128, Record>>(ids, absent_ids, order);
+    print("std::unordered_map<Id128>", node, &tree);
+    const Result flat = run<FlatHashMap<Id128, Record>>(ids, absent_ids, order);
+    print("FlatHashMap<Id128>", flat, &tree);
+    const Result flat_names = run<FlatHashMap<std::string, Record>>(names, absent_names, order);
+    print("FlatHashMap<std::string>", flat_names, &tree);
+
+    std::printf("\nFlatHashMap<Id128> vs std::unordered_map<Id128>: insert %.1fx, hit %.1fx, miss %.1fx\n",
+                node.insert / flat.insert, node.hit / flat.hit, node.miss / flat.miss);
+    return 0;
+}
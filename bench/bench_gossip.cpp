@@ -0,0 +1,182 @@
+// Gossip broadcast in MeshNetwork. First the duplicate filter alone:
+// nanoseconds per check_and_insert, false-positive rate and memory, against
+// a FlatHashSet<Id128> that remembers every id. Then one message to every
+// node of a 10k-node mesh (random overlay, 8 links per node), by gossip at
+// several fanouts against one route_message() per node: frames on the
+// wire, coverage and time. Last, gossip over real sockets on loopback.
+
+#include "bloom_filter.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+#include "mesh_network.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Crypto::FlatHashSet;
+using Crypto::Id128;
+using Crypto::MeshNetwork;
+using Crypto::RotatingBloomFilter;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t IDS = 4000000;
+constexpr size_t WINDOW = 1 << 16;
+constexpr size_t MESH_NODES = 10000;
+constexpr size_t MESH_DEGREE = 8;
+constexpr size_t BROADCASTS = 20;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+void filters() {
+    std::vector<Id128> ids(IDS);
+    for (auto& id : ids) id = Id128::generate();
+
+    RotatingBloomFilter filter(WINDOW);
+    size_t hits = 0;
+    auto start = Clock::now();
+    for (const auto& id : ids) hits += filter.check_and_insert(id);
+    const double bloom = seconds_since(start) / IDS;
+    // Everything was new: every hit was a false positive.
+    std::printf("RotatingBloomFilter (%zu-id window): %.1f ns per check_and_insert, %.3f%% false positives, "
+                "%.0f KB, %llu rotations\n",
+                WINDOW, bloom * 1e9, 100.0 * hits / IDS, filter.memory_bytes() / 1e3,
+                static_cast<unsigned long long>(filter.rotations()));
+
+    size_t recent = 0;
+    for (size_t i = IDS - WINDOW; i < IDS; ++i) recent += filter.contains(ids[i]);
+    std::printf("  last %zu ids still recognised: %zu\n", WINDOW, recent);
+
+    FlatHashSet<Id128> set;
+    start = Clock::now();
+    for (const auto& id : ids) hits += !set.insert(id).second;
+    const double flat = seconds_since(start) / IDS;
+    std::printf("FlatHashSet<Id128> (unbounded):      %.1f ns per insert, %.0f KB after %zu ids\n\n", flat * 1e9,
+                set.capacity() * (sizeof(Id128) + 1) / 1e3, IDS);
+}
+
+std::string node_name(size_t i) {
+    return "node" + std::to_string(i);
+}
+
+void build_overlay(MeshNetwork& network, size_t nodes, std::mt19937_64& rng) {
+    for (size_t i = 0; i < nodes; ++i) network.add_node(node_name(i), "overlay");
+    // Each node opens MESH_DEGREE / 2 links to random others.
+    for (size_t i = 0; i < nodes; ++i) {
+        for (size_t k = 0; k < MESH_DEGREE / 2; ++k) {
+            const size_t j = (i + 1 + rng() % (nodes - 1)) % nodes;
+            network.connect_nodes(node_name(i), node_name(j));
+        }
+    }
+}
+
+void in_process() {
+    std::mt19937_64 rng(3);
+    MeshNetwork network;
+    std::cout.setstate(std::ios::failbit);
+    build_overlay(network, MESH_NODES, rng);
+    std::cout.clear();
+
+    size_t reached = 0;
+    network.set_delivery_handler([&](const MeshNetwork::Message&) { ++reached; });
+
+    std::printf("one message to all %zu nodes (%zu links each, %zu broadcasts, TTL %u):\n", MESH_NODES, MESH_DEGREE,
+                BROADCASTS, static_cast<unsigned>(MeshNetwork::GossipOptions{}.ttl));
+    std::printf("%-24s%12s%12s%14s%12s\n", "", "coverage", "frames", "duplicates", "ms each");
+    for (size_t fanout : {2, 3, 4, 6}) {
+        MeshNetwork::GossipOptions options;
+        options.fanout = fanout;
+        network.set_gossip_options(options);
+        const MeshNetwork::GossipStats before = network.gossip_stats();
+        reached = 0;
+        const auto start = Clock::now();
+        for (size_t b = 0; b < BROADCASTS; ++b) network.broadcast(node_name(rng() % MESH_NODES), "hello");
+        const double seconds = seconds_since(start) / BROADCASTS;
+        const MeshNetwork::GossipStats after = network.gossip_stats();
+        char label[32];
+        std::snprintf(label, sizeof(label), "gossip, fanout %zu", fanout);
+        std::printf("%-24s%11.2f%%%12.0f%14.0f%12.2f\n", label, 100.0 * reached / (BROADCASTS * (MESH_NODES - 1)),
+                    static_cast<double>(after.frames - before.frames) / BROADCASTS,
+                    static_cast<double>(after.duplicates - before.duplicates) / BROADCASTS, seconds * 1e3);
+    }
+
+    // The alternative: a routed message per recipient, each hop a frame.
+    network.set_delivery_handler(nullptr);
+    const std::string origin = node_name(0);
+    size_t frames = 0, routed = 0;
+    std::cout.setstate(std::ios::failbit);
+    const auto start = Clock::now();
+    for (size_t i = 1; i < MESH_NODES; ++i) {
+        const MeshNetwork::Message msg = network.route_message(origin, node_name(i), "hello");
+        frames += msg.path.size() - 1;
+        routed += msg.path.size() > 1;
+    }
+    const double seconds = seconds_since(start);
+    std::cout.clear();
+    std::printf("%-24s%11.2f%%%12zu%14s%12.2f\n\n", "route_message per node", 100.0 * routed / (MESH_NODES - 1), frames,
+                "-", seconds * 1e3);
+}
+
+void over_sockets(size_t nodes, size_t messages) {
+    std::mt19937_64 rng(4);
+    MeshNetwork network;
+    std::atomic<uint64_t> delivered{0};
+    network.set_delivery_handler([&](const MeshNetwork::Message&) { delivered.fetch_add(1); });
+
+    std::cout.setstate(std::ios::failbit);
+    Crypto::Transport::Options options;
+    options.loops = 1;
+    const bool started = network.start_transport(options);
+    for (size_t i = 0; i < nodes; ++i) network.add_node(node_name(i), "127.0.0.1:0");
+    for (size_t i = 0; i < nodes; ++i) {
+        for (size_t k = 0; k < MESH_DEGREE / 2; ++k) {
+            network.connect_nodes(node_name(i), node_name((i + 1 + rng() % (nodes - 1)) % nodes));
+        }
+    }
+    std::cout.clear();
+    if (!started) {
+        std::printf("loopback: transport unavailable\n");
+        return;
+    }
+
+    const auto start = Clock::now();
+    for (size_t m = 0; m < messages; ++m) network.broadcast(node_name(m % nodes), std::string(256, 'x'));
+    // Done when every frame sent has been received, twice in a row (a
+    // frame being handled may still forward more).
+    for (uint64_t settled = 0, last = UINT64_MAX;;) {
+        const Crypto::Transport::Stats t = network.transport_stats();
+        settled = t.frames_received == t.frames_sent && t.frames_sent == last ? settled + 1 : 0;
+        if (settled == 2) break;
+        last = t.frames_sent;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    const double seconds = seconds_since(start);
+    const MeshNetwork::GossipStats stats = network.gossip_stats();
+    std::printf("loopback, %zu nodes, default options: %zu broadcasts of 256 B, %.2f%% coverage, %.1f frames per node "
+                "reached, %.0f deliveries/s\n",
+                nodes, messages, 100.0 * delivered.load() / (messages * (nodes - 1)),
+                static_cast<double>(stats.frames) / std::max<uint64_t>(1, delivered.load()),
+                delivered.load() / seconds);
+    network.stop_transport();
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== Mesh gossip benchmark ===\n\n");
+    filters();
+    in_process();
+    over_sockets(64, 2000);
+    return 0;
+}
@@ -0,0 +1,98 @@
+// ML-DSA-87 signing and verification cost, and inbound-queue throughput:
+// one signature per message, verified one by one against a fresh key,
+// with the signer's expanded key cached, and as a batch on the thread pool.
+
+#include "ml_dsa.h"
+#include "post_quantum_crypto.h"
+#include "thread_pool.h"
+#include "cpu_features.h"
+#include "kernel_registry.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using Crypto::MlDsa87;
+using Crypto::PostQuantumCrypto;
+
+namespace {
+
+// Seconds per call.
+template <typename Fn>
+double measure(Fn&& fn) {
+    using Clock = std::chrono::steady_clock;
+    size_t iterations = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) fn();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds > 0.2) {
+            return seconds / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!Crypto::apply_force_backend_flag(argc, argv)) return 1;
+
+    std::printf("=== ML-DSA-87 benchmark ===\n");
+    std::printf("CPU features: %s\n", Crypto::describe_cpu_features(Crypto::cpu_features()).c_str());
+    std::printf("Kernels: %s\n", Crypto::describe_kernels().c_str());
+    std::printf("Thread pool: %zu threads\n", Crypto::ThreadPool::shared().concurrency());
+
+    constexpr size_t SIGNERS = 8;
+    constexpr size_t MESSAGES = 256;
+    constexpr size_t MESSAGE_SIZE = 256;
+
+    std::vector<MlDsa87::KeyPair> signers;
+    for (size_t s = 0; s < SIGNERS; ++s) {
+        MlDsa87::Seed xi{};
+        xi[0] = static_cast<uint8_t>(s + 1);
+        signers.push_back(MlDsa87::generate_keypair(xi));
+    }
+
+    std::vector<std::vector<uint8_t>> messages(MESSAGES);
+    std::vector<MlDsa87::Signature> signatures(MESSAGES);
+    for (size_t i = 0; i < MESSAGES; ++i) {
+        messages[i].assign(MESSAGE_SIZE, static_cast<uint8_t>(i));
+        signatures[i] = *MlDsa87::sign(signers[i % SIGNERS].secret_key, messages[i]);
+    }
+
+    const MlDsa87::Seed seed{};
+    const auto& kp = signers[0];
+    const auto expanded = MlDsa87::expand_public_key(kp.public_key);
+    volatile bool sink = false;
+    const double keygen = measure([&] { sink = MlDsa87::generate_keypair(seed).public_key[0] != 0; });
+    const double sign = measure([&] { sink = MlDsa87::sign(kp.secret_key, messages[0], {}, seed).has_value(); });
+    const double verify = measure([&] { sink = MlDsa87::verify(kp.public_key, messages[0], signatures[0]); });
+    const double verify_cached = measure([&] { sink = MlDsa87::verify(*expanded, messages[0], signatures[0]); });
+
+    std::printf("%-14s%12s%12s%12s%16s\n", "backend", "keygen", "sign", "verify", "verify cached");
+    std::printf("%-14s%9.1f us%9.1f us%9.1f us%13.1f us\n", MlDsa87::backend_name(), keygen * 1e6, sign * 1e6,
+                verify * 1e6, verify_cached * 1e6);
+
+    PostQuantumCrypto pq;
+    std::vector<PostQuantumCrypto::DilithiumVerifyJob> jobs(MESSAGES);
+    for (size_t i = 0; i < MESSAGES; ++i) {
+        jobs[i].message = messages[i];
+        jobs[i].signature = signatures[i];
+        jobs[i].public_key = signers[i % SIGNERS].public_key;
+    }
+    size_t valid = 0;
+    const double uncached = measure([&] {
+        valid = 0;
+        for (const auto& job : jobs) {
+            valid += MlDsa87::verify(std::span<const uint8_t, MlDsa87::PUBLIC_KEY_SIZE>(job.public_key), job.message,
+                                     std::span<const uint8_t, MlDsa87::SIGNATURE_SIZE>(job.signature));
+        }
+    });
+    const double batch = measure([&] { valid = pq.dilithium_verify_batch(jobs); });
+    std::printf("\n%zu messages from %zu signers:\n", MESSAGES, SIGNERS);
+    std::printf("  one by one, key expanded per message: %9.0f msg/s\n", MESSAGES / uncached);
+    std::printf("  dilithium_verify_batch (cached keys): %9.0f msg/s  (%zu/%zu valid)\n", MESSAGES / batch, valid,
+                MESSAGES);
+    return valid == MESSAGES ? 0 : 1;
+}
@@ -0,0 +1,172 @@
+// Relay selection for AnonymousRouting circuits: AliasTable draws against
+// std::discrete_distribution (binary search over cumulative weights) from
+// 1k to 1M relays, and how closely draws follow the weights; then
+// select_relays() over thousands of relays with family and /16 exclusion,
+// the load it spreads across relays, and the cost of taking a relay
+// offline (one block rebuilt) against rebuilding the whole table.
+
+#include "alias_table.h"
+#include "anonymous_routing.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using Crypto::AliasTable;
+using Crypto::AnonymousRouting;
+using Crypto::SecureRandom;
+
+namespace {
+
+// Seconds per call.
+template <typename Fn>
+double measure(Fn&& fn) {
+    using Clock = std::chrono::steady_clock;
+    size_t iterations = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) fn();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds > 0.2) {
+            return seconds / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+// Log-uniform, as setup_network() advertises bandwidth.
+std::vector<double> relay_weights(size_t n, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> u(0.0, 1.0);
+    std::vector<double> w(n);
+    for (auto& x : w) x = 250e3 * std::pow(400.0, u(rng));
+    return w;
+}
+
+void draws(std::mt19937_64& rng) {
+    std::printf("%-10s%14s%16s%18s%14s\n", "relays", "alias draw", "discrete_dist", "alias build", "dd build");
+    volatile size_t sink = 0;
+    for (const size_t n : {1000, 10000, 100000, 1000000}) {
+        const std::vector<double> w = relay_weights(n, rng);
+        AliasTable table;
+        const double build = measure([&] { table.build(w); });
+        std::discrete_distribution<size_t> dd;
+        const double dd_build = measure([&] { dd = std::discrete_distribution<size_t>(w.begin(), w.end()); });
+        const double alias = measure([&] { sink = table.pick(SecureRandom::next_u64()); });
+        const double binary = measure([&] { sink = dd(rng); });
+        std::printf("%-10zu%11.1f ns%13.1f ns%15.2f ms%11.2f ms\n", n, alias * 1e9, binary * 1e9, build * 1e3,
+                    dd_build * 1e3);
+    }
+
+    // Fidelity: observed against expected counts, 1000 relays.
+    const std::vector<double> w = relay_weights(1000, rng);
+    const AliasTable table(w);
+    const double total = std::accumulate(w.begin(), w.end(), 0.0);
+    constexpr size_t DRAWS = 20000000;
+    std::vector<size_t> count(w.size(), 0);
+    for (size_t i = 0; i < DRAWS; ++i) ++count[table.pick(SecureRandom::next_u64())];
+    double tv = 0, worst = 0;
+    for (size_t i = 0; i < w.size(); ++i) {
+        const double expected = w[i] / total;
+        const double observed = static_cast<double>(count[i]) / DRAWS;
+        tv += std::fabs(observed - expected) / 2;
+        worst = std::max(worst, std::fabs(observed - expected) / std::sqrt(expected / DRAWS));
+    }
+    std::printf("20M draws over 1000 relays: total variation %.5f, worst relay %.1f sigma off its weight\n\n", tv,
+                worst);
+}
+
+void selection(size_t relays) {
+    std::cout.setstate(std::ios::failbit);
+    AnonymousRouting anon;
+    anon.setup_network(static_cast<int>(relays));
+    std::cout.clear();
+    const std::vector<AnonymousRouting::Node> nodes = anon.nodes();
+
+    std::array<uint32_t, 3> path;
+    const double select = measure([&] { anon.select_relays(path); });
+
+    // The old create_route(): collect the online relays, then pick.
+    volatile uint32_t sink = 0;
+    std::vector<uint32_t> online;
+    const double scan = measure([&] {
+        online.clear();
+        for (uint32_t i = 0; i < nodes.size(); ++i) {
+            if (nodes[i].is_online) online.push_back(i);
+        }
+        for (size_t i = 0; i < 3; ++i) {
+            std::swap(online[i], online[i + SecureRandom::uniform(online.size() - i)]);
+            sink = online[i];
+        }
+    });
+
+    // Load: share of hops on each relay against its share of the weight.
+    constexpr size_t PATHS = 300000;
+    std::vector<size_t> hops(relays, 0);
+    size_t clashes = 0, failed = 0;
+    for (size_t p = 0; p < PATHS; ++p) {
+        if (!anon.select_relays(path)) {
+            ++failed;
+            continue;
+        }
+        for (size_t i = 0; i < path.size(); ++i) {
+            ++hops[path[i]];
+            for (size_t j = 0; j < i; ++j) {
+                const auto& a = nodes[path[i]];
+                const auto& b = nodes[path[j]];
+                const bool same_16 = a.address.substr(0, a.address.find('.', 3)) ==
+                                     b.address.substr(0, b.address.find('.', 3));
+                clashes += a.family == b.family || same_16;
+            }
+        }
+    }
+    std::vector<double> weight(relays);
+    for (size_t i = 0; i < relays; ++i) weight[i] = nodes[i].bandwidth * nodes[i].uptime / 100.0;
+    const double total = std::accumulate(weight.begin(), weight.end(), 0.0);
+    std::vector<size_t> order(relays);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return weight[a] > weight[b]; });
+    double top_weight = 0, top_load = 0;
+    for (size_t i = 0; i < relays / 100; ++i) {
+        top_weight += weight[order[i]] / total;
+        top_load += static_cast<double>(hops[order[i]]) / (PATHS * path.size());
+    }
+    const size_t used = static_cast<size_t>(std::count_if(hops.begin(), hops.end(), [](size_t h) { return h > 0; }));
+
+    // Taking a relay offline rebuilds its block and the table over blocks.
+    uint32_t relay = 0;
+    const double toggle = measure([&] {
+        anon.set_relay_online(relay, false);
+        anon.set_relay_online(relay, true);
+        relay = (relay + 97) % static_cast<uint32_t>(relays);
+    }) / 2;
+    AliasTable full;
+    const double rebuild = measure([&] { full.build(weight); });
+
+    std::printf("AnonymousRouting, %zu relays (families of 4, %zu /16s):\n", relays, std::min<size_t>(relays, 256));
+    std::printf("  select_relays(), 3 hops        %8.0f ns per circuit   (uniform scan of online relays: %.0f ns)\n",
+                select * 1e9, scan * 1e9);
+    std::printf("  %zu paths: %zu failed, %zu same-family or same-/16 pairs, %zu relays used\n", PATHS, failed,
+                clashes, used);
+    std::printf("  top 1%% of relays by weight: %.1f%% of the weight, %.1f%% of the hops\n", top_weight * 100,
+                top_load * 100);
+    std::printf("  set_relay_online()              %8.2f us             (full table rebuild: %.2f us)\n\n",
+                toggle * 1e6, rebuild * 1e6);
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== Relay selection ===\n\n");
+    std::mt19937_64 rng(2026);
+    draws(rng);
+    selection(1000);
+    selection(10000);
+    return 0;
+}
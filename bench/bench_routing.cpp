@@ -0,0 +1,193 @@
+// MeshRouter on a random geometric graph: 100k nodes dropped in the unit
+// square, linked when closer than a radius giving ~10 neighbours on
+// average, node latencies 10-100 ms as MeshNetwork::add_node draws them.
+// Times the CSR build, a full Dijkstra per source table, next_hop() and
+// path() on cached tables, and link churn with the cached tables patched
+// incrementally against rebuilding them. The patched tables are checked
+// against fresh ones at the end.
+
+#include "mesh_router.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using Crypto::MeshRouter;
+using NodeIndex = MeshRouter::NodeIndex;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t NODES = 100000;
+constexpr double MEAN_DEGREE = 10.0;
+constexpr size_t SOURCES = 32;
+constexpr size_t LOOKUPS = 10000000;
+constexpr size_t PATHS = 100000;
+constexpr size_t CHURN = 2000;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+struct Graph {
+    std::vector<std::pair<double, double>> position;
+    std::vector<std::vector<NodeIndex>> cells;  // grid of radius-sized cells
+    size_t side = 0;
+    double radius = 0;
+
+    size_t cell_of(NodeIndex node) const {
+        const size_t x = std::min(side - 1, static_cast<size_t>(position[node].first * side));
+        const size_t y = std::min(side - 1, static_cast<size_t>(position[node].second * side));
+        return y * side + x;
+    }
+
+    // Nodes within the radius of `node`, other than itself.
+    template <typename F>
+    void near(NodeIndex node, F&& f) const {
+        const size_t cell = cell_of(node);
+        const long cx = static_cast<long>(cell % side), cy = static_cast<long>(cell / side);
+        for (long y = std::max(0L, cy - 1); y <= std::min<long>(side - 1, cy + 1); ++y) {
+            for (long x = std::max(0L, cx - 1); x <= std::min<long>(side - 1, cx + 1); ++x) {
+                for (NodeIndex other : cells[y * side + x]) {
+                    const double dx = position[node].first - position[other].first;
+                    const double dy = position[node].second - position[other].second;
+                    if (other != node && dx * dx + dy * dy < radius * radius) f(other);
+                }
+            }
+        }
+    }
+};
+
+Graph random_geometric(size_t n, std::mt19937_64& rng) {
+    Graph g;
+    g.radius = std::sqrt(MEAN_DEGREE / (3.14159265358979 * n));
+    g.side = static_cast<size_t>(1.0 / g.radius);
+    g.cells.resize(g.side * g.side);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    g.position.resize(n);
+    for (NodeIndex i = 0; i < n; ++i) {
+        g.position[i] = {unit(rng), unit(rng)};
+        g.cells[g.cell_of(i)].push_back(i);
+    }
+    return g;
+}
+
+} // namespace
+
+int main() {
+    std::printf("=== Mesh routing benchmark (%zu-node random geometric graph) ===\n\n", NODES);
+
+    std::mt19937_64 rng(17);
+    const Graph g = random_geometric(NODES, rng);
+    std::uniform_int_distribution<uint32_t> latency(10, 99);
+    std::uniform_int_distribution<NodeIndex> any(0, NODES - 1);
+
+    MeshRouter router(SOURCES);
+    std::vector<std::pair<NodeIndex, NodeIndex>> links;
+    auto start = Clock::now();
+    for (NodeIndex i = 0; i < NODES; ++i) router.add_node("node_" + std::to_string(i), latency(rng));
+    for (NodeIndex i = 0; i < NODES; ++i) {
+        g.near(i, [&](NodeIndex other) {
+            if (other > i && router.add_link(i, other)) links.emplace_back(i, other);
+        });
+    }
+    const double build = seconds_since(start);
+    std::printf("graph:        %zu links, mean degree %.1f, built in %.0f ms, CSR %.1f MB\n", router.link_count(),
+                2.0 * router.link_count() / NODES, build * 1e3, router.stats().graph_bytes / 1e6);
+
+    // One table per source: a full Dijkstra each.
+    std::vector<NodeIndex> sources(SOURCES);
+    for (auto& s : sources) s = any(rng);
+    start = Clock::now();
+    for (NodeIndex s : sources) router.next_hop(s, s == 0 ? 1 : 0);
+    const double dijkstra = seconds_since(start) / SOURCES;
+    MeshRouter::Stats stats = router.stats();
+    size_t reachable = 0;
+    for (NodeIndex i = 0; i < NODES; ++i) reachable += router.distance(sources[0], i) != INFINITY;
+    std::printf("dijkstra:     %.2f ms per source table (%.0f nodes settled), %.1f%% of nodes reachable, "
+                "%.1f MB per table\n",
+                dijkstra * 1e3, static_cast<double>(stats.nodes_settled) / SOURCES, 100.0 * reachable / NODES,
+                stats.table_bytes / 1e6 / SOURCES);
+
+    std::vector<std::pair<NodeIndex, NodeIndex>> queries(1 << 16);
+    std::uniform_int_distribution<size_t> pick_source(0, SOURCES - 1);
+    for (auto& q : queries) q = {sources[pick_source(rng)], any(rng)};
+    uint64_t sum = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        const auto& q = queries[i & (queries.size() - 1)];
+        sum += router.next_hop(q.first, q.second);
+    }
+    const double lookup = seconds_since(start) / LOOKUPS;
+
+    size_t hops = 0, routed = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < PATHS; ++i) {
+        const auto& q = queries[i & (queries.size() - 1)];
+        const auto p = router.path(q.first, q.second);
+        hops += p.size() > 1 ? p.size() - 1 : 0;
+        routed += !p.empty();
+    }
+    const double path = seconds_since(start) / PATHS;
+    std::printf("next_hop:     %.1f ns per lookup (cached table)\n", lookup * 1e9);
+    std::printf("path:         %.2f us per path, %.1f hops on average\n\n", path * 1e6,
+                routed ? static_cast<double>(hops) / routed : 0.0);
+
+    // Churn: a link goes away, a short new one appears; every cached table
+    // is patched each time.
+    const uint64_t settled_before = router.stats().nodes_settled;
+    const uint64_t updates_before = router.stats().incremental_updates;
+    size_t changes = 0;
+    start = Clock::now();
+    for (size_t i = 0; i < CHURN; ++i) {
+        std::uniform_int_distribution<size_t> pick_link(0, links.size() - 1);
+        const size_t victim = pick_link(rng);
+        router.remove_link(links[victim].first, links[victim].second);
+        links[victim] = links.back();
+        links.pop_back();
+        ++changes;
+
+        const NodeIndex a = any(rng);
+        NodeIndex b = MeshRouter::NONE;
+        g.near(a, [&](NodeIndex other) {
+            if (b == MeshRouter::NONE && !router.has_link(a, other)) b = other;
+        });
+        if (b != MeshRouter::NONE && router.add_link(a, b)) {
+            links.emplace_back(a, b);
+            ++changes;
+        }
+    }
+    const double churn = seconds_since(start) / changes;
+    stats = router.stats();
+    std::printf("link churn:   %zu changes, %.1f us each with %zu tables patched (%.2f us per table, "
+                "%llu patches, %.0f nodes settled per patch)\n",
+                changes, churn * 1e6, stats.tables, churn * 1e6 / stats.tables,
+                static_cast<unsigned long long>(stats.incremental_updates - updates_before),
+                static_cast<double>(stats.nodes_settled - settled_before) /
+                    std::max<uint64_t>(1, stats.incremental_updates - updates_before));
+    std::printf("              rebuilding the tables instead: %.1f us per change (%.0fx)\n",
+                dijkstra * SOURCES * 1e6, dijkstra * SOURCES / churn);
+
+    // The patched tables must match tables built from scratch.
+    std::vector<std::vector<double>> patched(SOURCES, std::vector<double>(NODES));
+    for (size_t s = 0; s < SOURCES; ++s) {
+        for (NodeIndex i = 0; i < NODES; ++i) patched[s][i] = router.distance(sources[s], i);
+    }
+    router.clear_tables();
+    size_t mismatches = 0;
+    for (size_t s = 0; s < SOURCES; ++s) {
+        for (NodeIndex i = 0; i < NODES; ++i) {
+            const double fresh = router.distance(sources[s], i);
+            const bool same = fresh == patched[s][i] || std::abs(fresh - patched[s][i]) <= 1e-4 * fresh;
+            mismatches += !same;
+        }
+    }
+    std::printf("check:        %zu of %zu distances differ from a fresh Dijkstra\n", mismatches, SOURCES * NODES);
+    return (sum == 0 || mismatches != 0) ? 1 : 0;
+}
@@ -0,0 +1,266 @@
+// RatchetSessionManager at bridge-node scale: opening 200k sessions, one
+// key derivation per call against derive_batch on random peers, the same
+// load spread over threads, decrypt_batch against deriving and opening
+// each message on its own, and the cost of persisting sessions to a
+// SessionStore: logging every key, reopening the store after a restart,
+// and the first message of a session loaded lazily.
+
+#include "ratchet_session_manager.h"
+#include "cipher_engine.h"
+#include "session_store.h"
+#include "cpu_features.h"
+#include "kernel_registry.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using Crypto::CipherEngine;
+using Crypto::RatchetSessionManager;
+using Crypto::SessionStore;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Seconds per call.
+template <typename Fn>
+double measure(Fn&& fn) {
+    size_t iterations = 1;
+    for (;;) {
+        const auto start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) fn();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds > 0.2) {
+            return seconds / iterations;
+        }
+        iterations *= 2;
+    }
+}
+
+constexpr size_t SESSIONS = 200000;
+constexpr size_t BATCH = 1024;
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (!Crypto::apply_force_backend_flag(argc, argv)) return 1;
+
+    std::printf("=== Ratchet session manager benchmark ===\n");
+    std::printf("CPU features: %s\n", Crypto::describe_cpu_features(Crypto::cpu_features()).c_str());
+    std::printf("Kernels: %s\n", Crypto::describe_kernels().c_str());
+
+    std::vector<std::string> peers(SESSIONS);
+    for (size_t i = 0; i < SESSIONS; ++i) peers[i] = "peer-" + std::to_string(i) + "@bridge";
+    RatchetSessionManager::RootKey root{};
+
+    RatchetSessionManager manager;
+    const auto open_start = Clock::now();
+    for (size_t i = 0; i < SESSIONS; ++i) {
+        root[0] = static_cast<uint8_t>(i);
+        manager.open_session(peers[i], root, true);
+    }
+    const double open_seconds = std::chrono::duration<double>(Clock::now() - open_start).count();
+    std::printf("\n%zu sessions in %zu shards, opened in %.0f ms (%.2f us each)\n", manager.size(),
+                manager.shard_count(), open_seconds * 1e3, open_seconds * 1e6 / SESSIONS);
+
+    std::mt19937_64 rng(11);
+    std::vector<uint32_t> picks(1 << 16);
+    for (auto& p : picks) p = static_cast<uint32_t>(rng() % SESSIONS);
+
+    volatile uint8_t sink = 0;
+    size_t next = 0;
+    const double single = measure([&] {
+        sink = manager.derive_message_key(peers[picks[next++ & (picks.size() - 1)]], true)->key[0];
+    });
+
+    std::vector<RatchetSessionManager::DeriveRequest> requests(BATCH);
+    const double batch = measure([&] {
+        for (auto& r : requests) {
+            r.peer_id = peers[picks[next++ & (picks.size() - 1)]];
+            r.sending = true;
+        }
+        manager.derive_batch(requests);
+        sink = requests[0].key->key[0];
+    });
+
+    std::printf("%-40s%10.1f ns\n", "derive_message_key, random peer", single * 1e9);
+    std::printf("%-40s%10.1f ns  (%.2fx)\n", "derive_batch(1024), per key", batch * 1e9 / BATCH,
+                single * BATCH / batch);
+
+    // Each thread derives on its own random peers; shards keep them apart.
+    const unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("\nThreads (derive_batch, random peers):\n");
+    for (unsigned threads = 1;; threads = std::min(2 * threads, max_threads)) {
+        constexpr size_t ROUNDS = 64;
+        std::atomic<bool> go{false};
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back([&, t] {
+                std::mt19937_64 local(t + 1);
+                std::vector<RatchetSessionManager::DeriveRequest> mine(BATCH);
+                while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+                for (size_t round = 0; round < ROUNDS; ++round) {
+                    for (auto& r : mine) {
+                        r.peer_id = peers[local() % SESSIONS];
+                        r.sending = true;
+                    }
+                    manager.derive_batch(mine);
+                }
+            });
+        }
+        const auto start = Clock::now();
+        go.store(true, std::memory_order_release);
+        for (auto& th : pool) th.join();
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        std::printf("  %2u thread(s): %8.2f M keys/s\n", threads, threads * ROUNDS * BATCH / seconds / 1e6);
+        if (threads == max_threads) break;
+    }
+
+    // Inbound queue: BATCH 64-byte messages from distinct peers, sealed by
+    // the initiator side and opened by a responder manager.
+    RatchetSessionManager responder;
+    for (size_t i = 0; i < BATCH; ++i) {
+        root[0] = static_cast<uint8_t>(i);
+        responder.open_session(peers[i], root, false);
+    }
+    RatchetSessionManager initiator;
+    for (size_t i = 0; i < BATCH; ++i) {
+        root[0] = static_cast<uint8_t>(i);
+        initiator.open_session(peers[i], root, true);
+    }
+
+    constexpr size_t MESSAGE = 64;
+    const size_t rounds = 64;
+    std::vector<std::vector<uint8_t>> wire(2 * rounds * BATCH, std::vector<uint8_t>(MESSAGE, 0x5a));
+    std::vector<CipherEngine::Tag> tags(wire.size());
+    std::vector<CipherEngine::Nonce> nonces(wire.size());
+    for (size_t m = 0; m < wire.size(); ++m) {
+        const auto mk = initiator.derive_message_key(peers[m % BATCH], true);
+        CipherEngine engine(std::span<const uint8_t, CipherEngine::KEY_SIZE>(mk->key));
+        nonces[m] = engine.next_nonce();
+        engine.seal(nonces[m], {}, wire[m], wire[m], tags[m]);
+    }
+
+    std::vector<uint8_t> plain(MESSAGE);
+    size_t opened = 0;
+    auto start = Clock::now();
+    for (size_t m = 0; m < rounds * BATCH; ++m) {
+        const auto mk = responder.derive_message_key(peers[m % BATCH], false);
+        CipherEngine engine(std::span<const uint8_t, CipherEngine::KEY_SIZE>(mk->key));
+        opened += engine.open(nonces[m], {}, wire[m], plain, tags[m]);
+    }
+    const double one_by_one = std::chrono::duration<double>(Clock::now() - start).count() / (rounds * BATCH);
+
+    std::vector<std::vector<uint8_t>> out(BATCH, std::vector<uint8_t>(MESSAGE));
+    std::vector<RatchetSessionManager::DecryptJob> jobs(BATCH);
+    start = Clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        for (size_t i = 0; i < BATCH; ++i) {
+            const size_t m = (rounds + round) * BATCH + i;
+            jobs[i].peer_id = peers[i];
+            jobs[i].nonce = nonces[m];
+            jobs[i].in = wire[m];
+            jobs[i].out = out[i];
+            jobs[i].tag = tags[m];
+        }
+        opened += responder.decrypt_batch(jobs);
+    }
+    const double batched = std::chrono::duration<double>(Clock::now() - start).count() / (rounds * BATCH);
+
+    std::printf("\nInbound 64-byte messages, %zu peers (%zu/%zu authenticated):\n", BATCH, opened, wire.size());
+    std::printf("%-40s%10.1f ns\n", "derive + open, one by one", one_by_one * 1e9);
+    std::printf("%-40s%10.1f ns  (%.2fx)\n", "decrypt_batch(1024), per message", batched * 1e9, one_by_one / batched);
+
+    // One message number twice in a batch: the second copy authenticates
+    // too, but its key is used up, so it must fail with its output wiped.
+    {
+        const auto mk = initiator.derive_message_key(peers[0], true);
+        CipherEngine engine(std::span<const uint8_t, CipherEngine::KEY_SIZE>(mk->key));
+        std::vector<uint8_t> sealed(MESSAGE, 0x5a);
+        CipherEngine::Tag tag;
+        const CipherEngine::Nonce nonce = engine.next_nonce();
+        engine.seal(nonce, {}, sealed, sealed, tag);
+        std::vector<std::vector<uint8_t>> copies(2, std::vector<uint8_t>(MESSAGE));
+        std::vector<RatchetSessionManager::DecryptJob> twice(2);
+        for (size_t i = 0; i < twice.size(); ++i) {
+            twice[i].peer_id = peers[0];
+            twice[i].message_number = 2 * rounds;
+            twice[i].nonce = nonce;
+            twice[i].in = sealed;
+            twice[i].out = copies[i];
+            twice[i].tag = tag;
+        }
+        responder.decrypt_batch(twice);
+        const bool wiped = std::all_of(copies[1].begin(), copies[1].end(), [](uint8_t b) { return b == 0; });
+        if (!twice[0].ok || twice[1].ok || !wiped) {
+            std::printf("[!] a message number repeated in one batch was not rejected and wiped\n");
+            return 1;
+        }
+        std::printf("%-40s%10s\n", "same number twice in a batch", "rejected");
+    }
+
+    // Persistence: the same sessions in a store, then a restart.
+    const std::string path = (std::filesystem::temp_directory_path() / "bench_sessions.db").string();
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".wal");
+    const std::array<uint8_t, 32> storage_key{};
+    SessionStore::Layout layout = SessionStore::DEFAULT_LAYOUT;
+    layout.wal_segments = std::max(layout.wal_segments, manager.shard_count());
+
+    // Uniform traffic over every session is the worst case for the log: at
+    // each checkpoint nearly every entry costs a record rewrite. A smaller
+    // active set lets a checkpoint cover many keys per session.
+    constexpr size_t ACTIVE = 1024;
+    const double hot = measure([&] { sink = manager.derive_message_key(peers[next++ % ACTIVE], true)->key[0]; });
+
+    double persisted_open, logged, hot_logged, reopen, first_touch;
+    {
+        SessionStore store(path, storage_key, layout);
+        RatchetSessionManager persisted;
+        persisted.attach_store(store);
+        start = Clock::now();
+        for (size_t i = 0; i < SESSIONS; ++i) {
+            root[0] = static_cast<uint8_t>(i);
+            persisted.open_session(peers[i], root, true);
+        }
+        persisted_open = std::chrono::duration<double>(Clock::now() - start).count() / SESSIONS;
+        logged = measure([&] {
+            sink = persisted.derive_message_key(peers[picks[next++ & (picks.size() - 1)]], true)->key[0];
+        });
+        hot_logged = measure([&] { sink = persisted.derive_message_key(peers[next++ % ACTIVE], true)->key[0]; });
+    }
+    {
+        start = Clock::now();
+        SessionStore store(path, storage_key);
+        RatchetSessionManager restarted;
+        restarted.attach_store(store);
+        reopen = std::chrono::duration<double>(Clock::now() - start).count();
+
+        constexpr size_t TOUCHED = 4096;
+        start = Clock::now();
+        for (size_t k = 0; k < TOUCHED; ++k) {
+            sink = restarted.derive_message_key(peers[(k * 7919) % SESSIONS], true)->key[0];
+        }
+        first_touch = std::chrono::duration<double>(Clock::now() - start).count() / TOUCHED;
+    }
+    std::filesystem::remove(path);
+    std::filesystem::remove(path + ".wal");
+
+    std::printf("\nSessionStore (%zu sessions, counters logged per key):\n", SESSIONS);
+    std::printf("%-40s%10.2f us\n", "open_session + save", persisted_open * 1e6);
+    std::printf("%-40s%10.1f ns  (+%.1f ns for the log)\n", "derive_message_key, random peer", logged * 1e9,
+                (logged - single) * 1e9);
+    std::printf("%-40s%10.1f ns  (+%.1f ns for the log)\n", "derive_message_key, 1024 active peers",
+                hot_logged * 1e9, (hot_logged - hot) * 1e9);
+    std::printf("%-40s%10.2f ms\n", "reopen after restart", reopen * 1e3);
+    std::printf("%-40s%10.2f us\n", "first key of a session (lazy load)", first_touch * 1e6);
+    return 0;
+}
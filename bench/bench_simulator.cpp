@@ -0,0 +1,398 @@
+// The network modules at scale on the discrete-event simulator: no sockets,
+// one thread, simulated links with latency, jitter, loss and bandwidth.
+//   - MeshNetwork: a random overlay (8 links per node) of 100k nodes by
+//     default (first argument), clients routing messages to random nodes
+//     and a few broadcasts, over 10 Mbit/s links with 0.1% loss;
+//   - AnonymousRouting: clients building circuits with create_route() and
+//     sending Sphinx cells through them, each relay peeling its layer with
+//     relay_cell() and forwarding over shared relay-to-relay links;
+//   - MetadataProtection: Sphinx packets from wrap_message() through a
+//     path of mixes, each holding them for an exponential delay and a
+//     pool flush before passing them on over simulated links.
+// Each reports throughput and p50/p99 delivery latency in simulated time,
+// heap per node, and wall time. First, the cost of the scheduler itself,
+// and the mesh run repeated small with the same seed to check that it
+// replays exactly.
+
+#include "anonymous_routing.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+#include "mesh_network.h"
+#include "metadata_protection.h"
+#include "network_simulator.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using Crypto::DeliveryTracker;
+using Crypto::MeshNetwork;
+using Crypto::NetworkSimulator;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint64_t SEED = 2026;
+constexpr size_t MESH_DEGREE = 8;
+constexpr size_t CELL = 514;
+
+double seconds_since(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+std::string node_name(size_t i) {
+    return "node" + std::to_string(i);
+}
+
+NetworkSimulator::LinkModel wan_link() {
+    NetworkSimulator::LinkModel link;
+    link.jitter = 0.005;
+    link.loss = 0.001;
+    link.bandwidth = 1.25e6;
+    return link;
+}
+
+// Exponential gap for a Poisson process of `rate` events per second.
+double poisson_gap(NetworkSimulator& sim, double rate) {
+    return -std::log(1.0 - sim.uniform_real()) / rate;
+}
+
+void print_summary(const char* label, const DeliveryTracker::Summary& s) {
+    std::printf("  %-22s %8llu sent, %6.2f%% delivered, %9.0f /s, p50 %7.1f ms, p99 %8.1f ms\n", label,
+                static_cast<unsigned long long>(s.sent), s.sent ? 100.0 * s.delivered / s.sent : 0.0, s.throughput,
+                s.p50 * 1e3, s.p99 * 1e3);
+}
+
+struct MeshRun {
+    DeliveryTracker::Summary unicast;
+    DeliveryTracker::Summary gossip;
+    double build = 0;                           // wall seconds
+    double run = 0;
+    size_t bytes_per_node = 0;
+    NetworkSimulator::Stats sim;
+    uint64_t fingerprint = 0;                   // of every delivery, in order
+};
+
+// `senders` clients send `messages` in total at `rate` per simulated
+// second, then `broadcasts` gossip messages go out.
+MeshRun mesh(size_t nodes, size_t senders, size_t messages, double rate, size_t broadcasts, uint64_t seed) {
+    MeshRun out;
+    Crypto::SecureRandom::seed_deterministic(seed);
+    NetworkSimulator sim(seed);
+    DeliveryTracker unicast, gossip;
+
+    std::cout.setstate(std::ios::failbit);
+    const size_t heap_before = Crypto::heap_bytes_in_use();
+    auto start = Clock::now();
+    auto network = std::make_unique<MeshNetwork>();
+    network->use_simulator(sim, wan_link());
+    for (size_t i = 0; i < nodes; ++i) network->add_node(node_name(i), "sim");
+    for (size_t i = 0; i < nodes; ++i) {
+        for (size_t k = 0; k < MESH_DEGREE / 2; ++k) {
+            network->connect_nodes(node_name(i), node_name((i + 1 + sim.rng()() % (nodes - 1)) % nodes));
+        }
+    }
+    out.build = seconds_since(start);
+    out.bytes_per_node = (Crypto::heap_bytes_in_use() - heap_before) / nodes;
+
+    network->set_delivery_handler([&](const MeshNetwork::Message& msg) {
+        const double now = sim.now();
+        if (!unicast.delivered(msg.message_id, now)) gossip.delivered(msg.message_id, now);
+        out.fingerprint = out.fingerprint * 0x100000001b3ull ^ static_cast<uint64_t>(now * 1e9);
+        out.fingerprint = out.fingerprint * 0x100000001b3ull ^ std::hash<std::string>{}(msg.recipient);
+    });
+
+    const std::string payload(256, 'm');
+    double at = 0;
+    for (size_t m = 0; m < messages; ++m) {
+        at += poisson_gap(sim, rate);
+        const size_t from = sim.rng()() % senders;
+        const size_t to = sim.rng()() % nodes;
+        sim.schedule(at, [&, from, to] {
+            const MeshNetwork::Message msg = network->route_message(node_name(from), node_name(to), payload);
+            if (msg.path.size() > 1) unicast.sent(msg.message_id, sim.now());
+        });
+    }
+    for (size_t b = 0; b < broadcasts; ++b) {
+        const size_t origin = sim.rng()() % nodes;
+        sim.schedule(at + 1.0 + b, [&, origin] {
+            const MeshNetwork::Message msg = network->broadcast(node_name(origin), payload);
+            // One "send" per node it should reach.
+            for (size_t n = 1; n < nodes; ++n) gossip.sent(msg.message_id, sim.now());
+        });
+    }
+
+    start = Clock::now();
+    sim.run();
+    out.run = seconds_since(start);
+    std::cout.clear();
+    out.unicast = unicast.summary();
+    out.gossip = gossip.summary();
+    out.sim = sim.stats();
+    return out;
+}
+
+void mesh_at_scale(size_t nodes) {
+    const MeshRun r = mesh(nodes, 64, 20000, 2000.0, 5, SEED);
+    std::printf("MeshNetwork, %zu nodes, %zu links each, 10 Mbit/s links, 20 ms +U(0,5) ms, 0.1%% loss:\n", nodes,
+                MESH_DEGREE);
+    std::printf("  built in %.1f s, %.1f KB of heap per node (mesh, router, DHT, simulated links)\n", r.build,
+                r.bytes_per_node / 1e3);
+    print_summary("route_message:", r.unicast);
+    print_summary("broadcast (per node):", r.gossip);
+    std::printf("  %llu events in %.2f s wall (%.2f M events/s), %llu frames lost, %llu dropped, "
+                "event queue peak %zu\n\n",
+                static_cast<unsigned long long>(r.sim.events), r.run, r.sim.events / r.run / 1e6,
+                static_cast<unsigned long long>(r.sim.frames_lost),
+                static_cast<unsigned long long>(r.sim.frames_dropped), r.sim.max_pending);
+}
+
+// The simulator alone: frames bouncing around a ring of links, each
+// arrival sending the frame on, with 64k frames in flight.
+void scheduler() {
+    constexpr size_t LINKS = 4096, IN_FLIGHT = 1 << 16, HOPS = 4000000;
+    NetworkSimulator sim(SEED);
+    std::vector<NetworkSimulator::ConnectionId> next(2 * LINKS + 2);
+    size_t hops = 0;
+    Crypto::Transport::Handler handler;
+    handler.on_frame = [&](NetworkSimulator::ConnectionId id, std::span<const uint8_t> frame) {
+        if (++hops < HOPS) sim.send(next[id], std::vector<uint8_t>(frame.begin(), frame.end()));
+    };
+    const NetworkSimulator::Endpoint endpoint = sim.attach(std::move(handler));
+    NetworkSimulator::LinkModel model;
+    model.jitter = 0.010;
+    std::vector<NetworkSimulator::ConnectionId> ring;
+    for (size_t i = 0; i < LINKS; ++i) ring.push_back(sim.link(endpoint, endpoint, model).first);
+    for (size_t i = 0; i < LINKS; ++i) next[ring[i] + 1] = ring[(i + 1) % LINKS];
+    for (size_t f = 0; f < IN_FLIGHT; ++f) sim.send(ring[f % LINKS], std::vector<uint8_t>(64));
+
+    const auto start = Clock::now();
+    const size_t events = sim.run();
+    const double wall = seconds_since(start);
+    std::printf("scheduler: %zu frame events, %zu in flight, %.0f ns per event (send + delivery)\n", events,
+                IN_FLIGHT, wall / events * 1e9);
+}
+
+void replay() {
+    const MeshRun a = mesh(2000, 16, 2000, 500.0, 2, SEED);
+    const MeshRun b = mesh(2000, 16, 2000, 500.0, 2, SEED);
+    const MeshRun c = mesh(2000, 16, 2000, 500.0, 2, SEED + 1);
+    std::printf("replay, 2k nodes: same seed %s (%llu events, p99 %.3f ms / %.3f ms), other seed %s\n\n",
+                a.fingerprint == b.fingerprint && a.sim.events == b.sim.events ? "identical" : "DIFFERENT",
+                static_cast<unsigned long long>(a.sim.events), a.unicast.p99 * 1e3, b.unicast.p99 * 1e3,
+                a.fingerprint != c.fingerprint ? "differs" : "IDENTICAL");
+}
+
+// Sphinx cells behind the circuit id of the link they cross; each relay
+// peels its layer with relay_cell() and forwards on the link to the next
+// relay. Links between two relays are shared by every circuit crossing them.
+void anonymous_routing(size_t relays, size_t clients, size_t cells, double rate) {
+    Crypto::SecureRandom::seed_deterministic(SEED);
+    NetworkSimulator sim(SEED);
+    DeliveryTracker tracker;
+
+    std::cout.setstate(std::ios::failbit);
+    const size_t heap_before = Crypto::heap_bytes_in_use();
+    Crypto::AnonymousRouting anon;
+    anon.setup_network(static_cast<int>(relays));
+    const size_t per_relay = (Crypto::heap_bytes_in_use() - heap_before) / relays;
+
+    std::vector<Crypto::AnonymousRouting::Route> routes;
+    Crypto::FlatHashMap<uint64_t, NetworkSimulator::ConnectionId> links;     // (from, to) -> sending end
+    Crypto::FlatHashMap<NetworkSimulator::ConnectionId, uint32_t> arriving;  // receiving end -> relay
+    Crypto::FlatHashSet<uint32_t> used;
+    uint64_t rejected = 0;
+
+    NetworkSimulator::Endpoint endpoint = 0;                                // attached below
+    auto link_between = [&](uint32_t from, uint32_t to) {
+        auto [it, added] = links.try_emplace((uint64_t{from} << 32) | to, 0);
+        if (added) {
+            NetworkSimulator::LinkModel model = wan_link();
+            model.latency = 0.010 + 0.090 * sim.uniform_real();
+            const auto ends = sim.link(endpoint, endpoint, model);
+            it->second = ends.first;
+            arriving[ends.second] = to;
+        }
+        return it->second;
+    };
+    auto send_cell = [&](uint32_t from, uint32_t to, uint32_t circuit, const Crypto::Sphinx::Packet& cell) {
+        std::vector<uint8_t> frame(sizeof(circuit) + cell.size());
+        std::memcpy(frame.data(), &circuit, sizeof(circuit));
+        std::memcpy(frame.data() + sizeof(circuit), cell.data(), cell.size());
+        sim.send(link_between(from, to), std::move(frame));
+    };
+
+    Crypto::Transport::Handler handler;
+    handler.on_frame = [&](NetworkSimulator::ConnectionId id, std::span<const uint8_t> frame) {
+        const uint32_t relay = arriving[id];
+        uint32_t circuit;
+        std::memcpy(&circuit, frame.data(), sizeof(circuit));
+        Crypto::Sphinx::Packet cell;
+        std::memcpy(cell.data(), frame.data() + sizeof(circuit), cell.size());
+        const Crypto::AnonymousRouting::Forward next = anon.relay_cell(relay, circuit, cell);
+        if (!next.ok) {
+            ++rejected;
+        } else if (next.exit) {
+            tracker.delivered(Crypto::Sphinx::open_payload(cell).substr(0, 16), sim.now());
+        } else {
+            send_cell(relay, next.next_relay, next.next_circuit, cell);
+        }
+    };
+    endpoint = sim.attach(std::move(handler));
+
+    for (size_t c = 0; c < clients; ++c) {
+        routes.push_back(anon.create_route());
+        for (uint32_t relay : routes.back().relays) used.insert(relay);
+    }
+
+    double at = 0;
+    for (size_t n = 0; n < cells; ++n) {
+        at += poisson_gap(sim, rate);
+        const uint32_t client = static_cast<uint32_t>(sim.rng()() % clients);
+        sim.schedule(at, [&, client] {
+            const auto& route = routes[client];
+            const auto id = Crypto::Id128::generate().bytes();
+            std::vector<uint8_t> message(Crypto::Sphinx::CELL_PAYLOAD, 'c');
+            std::memcpy(message.data(), id.data(), id.size());
+            Crypto::Sphinx::Packet cell;
+            if (route.relays.empty() || !anon.build_cell(route, message, cell)) return;
+            tracker.sent(std::string(reinterpret_cast<const char*>(id.data()), id.size()), sim.now());
+            send_cell(static_cast<uint32_t>(relays + client), route.relays.front(), route.entry_circuit, cell);
+        });
+    }
+    const auto start = Clock::now();
+    sim.run();
+    const double wall = seconds_since(start);
+    std::cout.clear();
+
+    std::printf("AnonymousRouting, %zu relays, %zu circuits from create_route(), %zu-byte Sphinx cells, "
+                "10 Mbit/s links:\n",
+                relays, clients, Crypto::Sphinx::PACKET_SIZE);
+    std::printf("  %zu distinct relays carry the circuits; %.1f KB of heap per relay\n", used.size(),
+                per_relay / 1e3);
+    print_summary("cells:", tracker.summary());
+    std::printf("  %llu cells rejected by a relay, %llu frames dropped at full relay queues, %.2f s wall\n\n",
+                static_cast<unsigned long long>(rejected),
+                static_cast<unsigned long long>(sim.stats().frames_dropped), wall);
+}
+
+void mix_network(size_t mixes, size_t messages, double rate) {
+    Crypto::SecureRandom::seed_deterministic(SEED);
+    NetworkSimulator sim(SEED);
+    DeliveryTracker tracker;
+
+    std::cout.setstate(std::ios::failbit);
+    Crypto::MetadataProtection::Options options;
+    options.pool_threshold = 256;
+    options.flush_interval_ms = 200;
+    options.pool_minimum = 32;
+    Crypto::MetadataProtection mix(options);
+    mix.setup_mix_network(static_cast<int>(mixes));
+
+    // One link into each mix, shared by the clients and the mixes before it.
+    std::vector<NetworkSimulator::ConnectionId> into(mixes);
+    Crypto::FlatHashMap<NetworkSimulator::ConnectionId, uint32_t> arriving;   // receiving end -> mix
+    auto now_ms = [&] { return static_cast<uint64_t>(sim.now() * 1000.0); };
+    auto send_packet = [&](const Crypto::MetadataProtection::MixPacket& packet) {
+        // Sender, sealed circuit id, packet.
+        std::vector<uint8_t> frame(sizeof(packet.from) + packet.circuit.size() + packet.packet.size());
+        std::memcpy(frame.data(), &packet.from, sizeof(packet.from));
+        std::memcpy(frame.data() + sizeof(packet.from), packet.circuit.data(), packet.circuit.size());
+        std::memcpy(frame.data() + sizeof(packet.from) + packet.circuit.size(), packet.packet.data(),
+                    packet.packet.size());
+        sim.send(into[packet.mix], std::move(frame));
+    };
+
+    Crypto::Transport::Handler handler;
+    handler.on_frame = [&](NetworkSimulator::ConnectionId id, std::span<const uint8_t> frame) {
+        Crypto::MetadataProtection::MixPacket packet;
+        packet.mix = arriving[id];
+        std::memcpy(&packet.from, frame.data(), sizeof(packet.from));
+        std::memcpy(packet.circuit.data(), frame.data() + sizeof(packet.from), packet.circuit.size());
+        std::memcpy(packet.packet.data(), frame.data() + sizeof(packet.from) + packet.circuit.size(),
+                    packet.packet.size());
+        mix.receive(packet, now_ms());
+    };
+    const NetworkSimulator::Endpoint endpoint = sim.attach(std::move(handler));
+    NetworkSimulator::LinkModel model = wan_link();
+    model.bandwidth = 12.5e6;
+    for (uint32_t m = 0; m < mixes; ++m) {
+        const auto ends = sim.link(endpoint, endpoint, model);
+        into[m] = ends.first;
+        arriving[ends.second] = m;
+    }
+    mix.set_forward_handler(send_packet);
+    size_t delivered = 0;
+    mix.set_delivery_handler([&](const Crypto::MetadataProtection::Delivery& d) {
+        delivered += tracker.delivered(d.message.substr(0, d.message.find(' ')), sim.now());
+    });
+
+    const size_t heap_before = Crypto::heap_bytes_in_use();
+    size_t peak_heap = 0;
+    double at = 0;
+    for (size_t m = 0; m < messages; ++m) {
+        at += poisson_gap(sim, rate);
+        sim.schedule(at, [&, m] {
+            const std::string id = "mix" + std::to_string(m);
+            std::string body = id;
+            body.resize(256, ' ');
+            Crypto::MetadataProtection::MixPacket packet;
+            if (!mix.wrap_message(body, "recipient", packet)) return;
+            tracker.sent(id, sim.now());
+            send_packet(packet);
+        });
+    }
+    // The mixes run every 10 ms of simulated time until the last message
+    // is out (or a minute after the last send).
+    const double last_send = at;
+    std::function<void()> tick = [&] {
+        mix.process(now_ms());
+        peak_heap = std::max(peak_heap, Crypto::heap_bytes_in_use() - heap_before);
+        if (delivered < messages && sim.now() < last_send + 60.0) sim.schedule(0.010, tick);
+    };
+    sim.schedule(0.010, tick);
+    const auto start = Clock::now();
+    sim.run();
+    const double wall = seconds_since(start);
+    std::cout.clear();
+
+    uint64_t flushes = 0, flushed = 0;
+    size_t peak_queued = 0;
+    for (size_t m = 0; m < mix.mix_count(); ++m) {
+        const auto s = mix.mix_stats(m);
+        flushes += s.flushes;
+        flushed += s.flushed;
+        peak_queued = std::max(peak_queued, s.peak_queued);
+    }
+    std::printf("MetadataProtection, %zu mixes (3 per path), %zu-byte Sphinx packets over 100 Mbit/s links, "
+                "pool of 256 or every 200 ms:\n",
+                mixes, Crypto::Sphinx::PACKET_SIZE);
+    std::printf("  %llu flushes of %.0f messages on average, peak queue %zu at a mix, peak heap %.1f MB\n",
+                static_cast<unsigned long long>(flushes), flushes ? static_cast<double>(flushed) / flushes : 0.0,
+                peak_queued, peak_heap / 1e6);
+    print_summary("messages:", tracker.summary());
+    std::printf("  %.2f s wall\n", wall);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t nodes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 100000;
+    std::printf("=== Discrete-event network simulator (seed %llu) ===\n\n", static_cast<unsigned long long>(SEED));
+    scheduler();
+    replay();
+    mesh_at_scale(std::max<size_t>(nodes, 16));
+    anonymous_routing(1000, 200, 30000, 3000.0);
+    mix_network(16, 100000, 5000.0);
+    return 0;
+}
@@ -0,0 +1,237 @@
+// Transport on loopback, epoll against io_uring: one-way frame throughput
+// for small and large frames (with system calls per frame, i.e. how much
+// sendmsg() batching and read coalescing buy), ping-pong round-trip
+// latency, and a MeshNetwork of many nodes in this process routing
+// messages hop by hop over real sockets.
+
+#include "transport.h"
+#include "mesh_network.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/resource.h>
+
+using Crypto::MeshNetwork;
+using Crypto::Transport;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void wait_until(const std::atomic<uint64_t>& counter, uint64_t target) {
+    const auto deadline = Clock::now() + std::chrono::seconds(30);
+    while (counter.load(std::memory_order_acquire) < target && Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+// epoll: one read() or sendmsg() per call plus epoll_wait(); io_uring: the
+// io_uring_enter() per tick is the only one.
+uint64_t syscalls(const Transport::Stats& s, Transport::Backend backend) {
+    return backend == Transport::Backend::IoUring ? s.wakeups : s.wakeups + s.read_calls + s.write_calls;
+}
+
+double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0;
+    const size_t k = std::min(samples.size() - 1, static_cast<size_t>(p * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + static_cast<std::ptrdiff_t>(k), samples.end());
+    return samples[k];
+}
+
+// Sender and receiver in one Transport, like two nodes of a process.
+void throughput(Transport::Backend backend, size_t loops, size_t frame_size, size_t frames) {
+    std::atomic<uint64_t> received{0};
+    std::atomic<uint64_t> opened{0};
+    Transport::Handler handler;
+    handler.on_open = [&](Transport::ConnectionId, bool) { opened.fetch_add(1, std::memory_order_release); };
+    handler.on_frame = [&](Transport::ConnectionId, std::span<const uint8_t>) {
+        received.fetch_add(1, std::memory_order_release);
+    };
+    Transport::Options options;
+    options.backend = backend;
+    options.loops = loops;
+    options.max_queued_bytes = size_t{1} << 30;
+    Transport transport(handler, options);
+    transport.start();
+    const uint16_t port = transport.listen("127.0.0.1", 0);
+    const Transport::ConnectionId link = transport.connect("127.0.0.1", port);
+    wait_until(opened, 2);
+
+    const std::vector<uint8_t> payload(frame_size, 0x5A);
+    const Transport::Stats before = transport.stats();
+    const auto start = Clock::now();
+    for (size_t i = 0; i < frames; ++i) transport.send(link, payload);
+    wait_until(received, frames);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const Transport::Stats after = transport.stats();
+
+    const double sent = static_cast<double>(after.frames_sent - before.frames_sent);
+    std::printf("%8zu B x %-8zu%10.0f frames/s%9.1f MB/s%8.1f frames/send%8.1f frames/read%8.2f syscalls/frame\n",
+                frame_size, frames, frames / seconds, frames * (frame_size + 4) / seconds / 1e6,
+                sent / std::max<uint64_t>(1, after.write_calls - before.write_calls),
+                static_cast<double>(frames) / std::max<uint64_t>(1, after.read_calls - before.read_calls),
+                static_cast<double>(syscalls(after, transport.backend()) - syscalls(before, transport.backend())) / frames);
+}
+
+void ping_pong(Transport::Backend backend, size_t loops, size_t rounds) {
+    std::atomic<uint64_t> opened{0};
+    std::atomic<uint64_t> replies{0};
+    Transport* self = nullptr;
+    std::atomic<Transport::ConnectionId> client{0};  // read by the echo side's loop
+    Transport::Handler handler;
+    handler.on_open = [&](Transport::ConnectionId, bool) { opened.fetch_add(1, std::memory_order_release); };
+    handler.on_frame = [&](Transport::ConnectionId id, std::span<const uint8_t> frame) {
+        if (id == client.load(std::memory_order_acquire)) {
+            replies.fetch_add(1, std::memory_order_release);
+        } else {
+            self->send(id, frame);              // echo
+        }
+    };
+    Transport::Options options;
+    options.backend = backend;
+    options.loops = loops;
+    Transport transport(handler, options);
+    self = &transport;
+    transport.start();
+    const uint16_t port = transport.listen("127.0.0.1", 0);
+    client.store(transport.connect("127.0.0.1", port), std::memory_order_release);
+    wait_until(opened, 2);
+
+    const std::vector<uint8_t> ping(64, 1);
+    std::vector<double> rtt;
+    rtt.reserve(rounds);
+    for (size_t i = 0; i < rounds; ++i) {
+        const auto start = Clock::now();
+        transport.send(client, ping);
+        wait_until(replies, i + 1);
+        rtt.push_back(std::chrono::duration<double>(Clock::now() - start).count() * 1e6);
+    }
+    const double p50 = percentile(rtt, 0.50);
+    const double p99 = percentile(rtt, 0.99);
+    std::printf("64 B ping-pong, %zu rounds: p50 %.1f us, p99 %.1f us\n", rounds, p50, p99);
+}
+
+void mesh(Transport::Backend backend, size_t node_count, size_t messages) {
+    MeshNetwork network;
+    Transport::Options options;
+    options.backend = backend;
+    options.loops = std::min<size_t>(4, std::max(1u, std::thread::hardware_concurrency()));
+
+    std::mutex latency_mutex;
+    std::vector<double> latency;
+    latency.reserve(messages);
+    std::atomic<uint64_t> delivered{0};
+    network.set_delivery_handler([&](const MeshNetwork::Message& msg) {
+        int64_t sent_ns = 0;
+        std::memcpy(&sent_ns, msg.encrypted_content.data(), sizeof(sent_ns));
+        const double us = (Clock::now().time_since_epoch().count() - sent_ns) / 1e3;
+        {
+            std::lock_guard<std::mutex> lock(latency_mutex);
+            latency.push_back(us);
+        }
+        delivered.fetch_add(1, std::memory_order_release);
+    });
+
+    // The module logs every call; keep the report readable.
+    std::cout.setstate(std::ios::failbit);
+    const bool started = network.start_transport(options);
+    const auto setup_start = Clock::now();
+    for (size_t i = 0; i < node_count; ++i) network.add_node("node" + std::to_string(i), "127.0.0.1:0");
+    for (size_t i = 0; i < node_count; ++i) {
+        for (size_t j = i + 1; j < node_count; ++j) {
+            network.connect_nodes("node" + std::to_string(i), "node" + std::to_string(j));
+        }
+    }
+    const double setup = std::chrono::duration<double>(Clock::now() - setup_start).count();
+    if (!started) {
+        std::cout.clear();
+        std::printf("mesh: transport unavailable\n");
+        return;
+    }
+
+    std::mt19937_64 rng(5);
+    std::string content(256, 'x');
+    auto route_random = [&] {
+        const size_t from = rng() % node_count;
+        const size_t to = (from + 1 + rng() % (node_count - 1)) % node_count;
+        const int64_t now = Clock::now().time_since_epoch().count();
+        std::memcpy(content.data(), &now, sizeof(now));
+        network.route_message("node" + std::to_string(from), "node" + std::to_string(to), content);
+    };
+
+    // Flooded: throughput, and how many system calls the batching saves.
+    const Transport::Stats before = network.transport_stats();
+    const auto start = Clock::now();
+    for (size_t i = 0; i < messages; ++i) route_random();
+    wait_until(delivered, messages);
+    const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    const Transport::Stats after = network.transport_stats();
+    const uint64_t flooded = delivered.load();
+
+    // One message in flight: latency without queueing.
+    {
+        std::lock_guard<std::mutex> lock(latency_mutex);
+        latency.clear();
+    }
+    const size_t paced = 2000;
+    for (size_t i = 0; i < paced; ++i) {
+        route_random();
+        wait_until(delivered, messages + i + 1);
+    }
+    std::cout.clear();
+
+    std::lock_guard<std::mutex> lock(latency_mutex);
+    const uint64_t frames = after.frames_sent - before.frames_sent;
+    std::printf("%zu nodes, %zu links on %zu loops, set up in %.0f ms\n", node_count,
+                node_count * (node_count - 1) / 2, options.loops, setup * 1e3);
+    std::printf("%zu/%zu messages of 256 B delivered: %.0f msg/s, %.2f frames/msg, %.2f syscalls/frame\n",
+                static_cast<size_t>(flooded), messages, flooded / seconds,
+                static_cast<double>(frames) / std::max<uint64_t>(1, flooded),
+                static_cast<double>(syscalls(after, backend) - syscalls(before, backend)) / std::max<uint64_t>(1, frames));
+    std::printf("one message in flight: p50 %.1f us, p99 %.1f us end to end\n", percentile(latency, 0.50),
+                percentile(latency, 0.99));
+}
+
+} // namespace
+
+int main() {
+    // A full mesh needs two descriptors per link.
+    rlimit limit{};
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+
+    const size_t loops = std::max(1u, std::thread::hardware_concurrency());
+    std::printf("=== Transport benchmark (loopback, %zu event loop(s)) ===\n", loops);
+
+    for (const Transport::Backend backend : {Transport::Backend::Epoll, Transport::Backend::IoUring}) {
+        std::printf("\n--- %s ---\n", Transport::backend_name(backend));
+        if (!Transport::backend_supported(backend)) {
+            std::printf("not supported by this kernel\n");
+            continue;
+        }
+        std::printf("One-way throughput:\n");
+        throughput(backend, loops, 64, 1000000);
+        throughput(backend, loops, 1024, 500000);
+        throughput(backend, loops, 16384, 50000);
+        throughput(backend, loops, 262144, 5000);
+
+        std::printf("\n");
+        ping_pong(backend, loops, 20000);
+
+        std::printf("\nMeshNetwork over the transport:\n");
+        mesh(backend, 48, 100000);
+    }
+    return 0;
+}
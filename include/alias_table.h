@@ -0,0 +1,48 @@
+#ifndef ALIAS_TABLE_H
+#define ALIAS_TABLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Crypto {
+
+// Weighted sampling in O(1) per draw (Walker's alias method, built with
+// Vose's O(n) construction). Entry i is drawn with probability
+// weights[i] / total(); entries of weight zero are never drawn.
+//
+// Each column holds a 32-bit threshold and an alias: a draw picks a column
+// uniformly from the high half of a 64-bit random word and keeps it when
+// the low half falls under the threshold, else takes its alias. One random
+// word and one 8-byte column per draw. Rounding thresholds to 32 bits moves
+// a probability by at most 2^-32 per column.
+class AliasTable {
+public:
+    AliasTable() = default;
+    explicit AliasTable(std::span<const double> weights) { build(weights); }
+
+    // Negative weights count as zero.
+    void build(std::span<const double> weights);
+    // `random` uniform over 64 bits. Only valid when total() > 0.
+    size_t pick(uint64_t random) const {
+        const size_t i = static_cast<size_t>(((random >> 32) * columns_.size()) >> 32);
+        return static_cast<uint32_t>(random) < columns_[i].threshold ? i : columns_[i].alias;
+    }
+
+    size_t size() const { return columns_.size(); }
+    double total() const { return total_; }
+
+private:
+    struct Column {
+        uint32_t threshold;                     // keep the column below it (of 2^32)
+        uint32_t alias;                         // itself when the column is full
+    };
+
+    std::vector<Column> columns_;
+    double total_ = 0;
+};
+
+} // namespace Crypto
+
+#endif // ALIAS_TABLE_H
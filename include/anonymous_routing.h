@@ -2,35 +2,137 @@
 #define ANONYMOUS_ROUTING_H
 
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
 
+#include "alias_table.h"
+#include "bloom_filter.h"
+#include "flat_hash_map.h"
+#include "sphinx.h"
+
 namespace Crypto {
 
+// Onion routing over relays held in this process. create_route() draws
+// three relays (select_relays()) and builds a circuit through them with a
+// Sphinx setup packet (see Sphinx): each relay derives its hop key
+// once, with one X25519 operation, and keeps it under the circuit id the
+// cell arrives on. send_anonymously() cuts the message into fixed-size
+// Sphinx cells layered with the route's hop keys; each relay peels its
+// layer with one AEAD and passes the cell on, and the exit recovers the
+// message. relay_cell() is that single relay step, for running relays over
+// a network or a NetworkSimulator.
+//
+// Relays are drawn with probability proportional to advertised bandwidth
+// times uptime, as the load should spread, and a path never holds two
+// relays of one family or one /16; its last relay allows the circuit's
+// exit class. A draw is two alias-table lookups, O(1): a block of
+// SELECTION_BLOCK relays by its total weight, then a relay in it. A relay
+// that conflicts with the path so far is drawn again. Adding relays or
+// taking one offline rebuilds only the blocks concerned and the small
+// table over blocks.
 class AnonymousRouting {
 public:
     struct Node {
         std::string node_id;
         std::string address;
-        std::string public_key;
+        X25519::Key public_key;
         bool is_online;
-        double uptime;
+        double uptime;                          // percent
+        double bandwidth;                       // advertised, bytes/s
+        std::string family;                     // relays of one operator; empty: none
+        uint32_t exit_policy;                   // bit per exit class it may end a circuit for
     };
-    
+
     struct Route {
         std::vector<std::string> nodes;
         std::string circuit_id;
         uint64_t created_at;
+        uint32_t exit_class = EXIT_INTERNAL;
+        // Once built: relay indices, the circuit id the entry relay knows,
+        // and the client's hop keys. Empty relays: no circuit.
+        std::vector<uint32_t> relays;
+        uint32_t entry_circuit = 0;
+        std::vector<Sphinx::Key> hop_keys;
+    };
+
+    // Where a cell goes after one relay.
+    struct Forward {
+        bool ok = false;                        // false: unknown circuit or bad tag, drop it
+        bool exit = false;                      // the cell's payload is readable here
+        bool cover = false;                     // at the exit, a cover cell: drop it (see CoverTraffic)
+        uint32_t next_relay = 0;
+        uint32_t next_circuit = 0;
     };
-    
+
+    static constexpr size_t SELECTION_BLOCK = 256;
+
+    // Where a circuit's last hop may deliver. Every relay allows
+    // EXIT_INTERNAL; the others follow Node::exit_policy.
+    static constexpr uint32_t EXIT_INTERNAL = 0;
+    static constexpr uint32_t EXIT_MESSAGING = 1;
+    static constexpr uint32_t EXIT_WEB = 2;
+    static constexpr uint32_t EXIT_CLASSES = 3;
+
     AnonymousRouting();
     void setup_network(int num_nodes);
-    Route create_route();
+    Route create_route(uint32_t exit_class = EXIT_INTERNAL);
+    // create_route() without the report, from any thread: the client's
+    // public-key work runs without the relays' lock. No circuit (empty
+    // relays) on failure.
+    Route build_route(uint32_t exit_class = EXIT_INTERNAL);
+    // Returns the message as the exit recovered it; empty when the route
+    // has no circuit or a cell was dropped on the way.
     std::string send_anonymously(const std::string& message, const Route& route);
+    // Forgets the circuit at every relay.
+    void destroy_route(const Route& route);
+
+    // Fills path with relays drawn by weight, pairwise distinct in relay,
+    // family and /16, the last one allowing exit_class. False when that
+    // many could not be found.
+    bool select_relays(std::span<uint32_t> path, uint32_t exit_class = EXIT_INTERNAL);
+    void set_relay_online(uint32_t relay, bool online);
+
+    // One cell of route's circuit carrying up to Sphinx::CELL_PAYLOAD bytes.
+    bool build_cell(const Route& route, std::span<const uint8_t> chunk, Sphinx::Packet& cell) const;
+    // A cover cell of route's circuit, which the exit drops.
+    bool build_cover_cell(const Route& route, Sphinx::Packet& cell) const;
+    // Relay `relay` handles `cell` arriving on `circuit`, in place.
+    Forward relay_cell(uint32_t relay, uint32_t circuit, Sphinx::Packet& cell);
+    std::vector<Node> nodes();
+    size_t circuit_count();
 
 private:
+    struct Hop {
+        std::unique_ptr<ChaCha20Poly1305> cipher;
+        uint32_t next_relay;
+        uint32_t next_circuit;
+        bool exit;
+    };
+
+    struct Relay {
+        X25519::Key secret_key;
+        FlatHashMap<uint32_t, Hop> circuits;
+        // Replay tags of setup packets taken, allocated by the first one.
+        std::unique_ptr<RotatingBloomFilter> seen_setups;
+        uint32_t family;                        // interned Node::family, unique when empty
+        uint32_t subnet;                        // first two octets of the address
+    };
+
+    // An id no circuit uses at relay; the caller holds the lock.
+    uint32_t free_circuit(const Relay& relay) const;
+    void destroy_circuit(uint32_t relay, uint32_t circuit);
+    bool draw_path(std::span<uint32_t> path, uint32_t exit_class) const;
+    // Rebuilds the tables of blocks [first, last) and the one over blocks.
+    void rebuild_selection(size_t first, size_t last);
+
     std::vector<Node> network_nodes;
+    std::vector<Relay> relays;
+    FlatHashMap<std::string, uint32_t> families;
+    std::vector<AliasTable> block_tables;
+    std::vector<double> block_weights;
+    AliasTable block_table;
     std::mutex network_mutex;
 };
 
@@ -5,9 +5,12 @@
 #include <string>
 #include <vector>
 #include <map>
+#include "slh_dsa.h"
 
 namespace Crypto {
 
+class MeshNetwork;
+
 class BlockchainIdentity {
 public:
     struct OnChainDID {
@@ -18,15 +21,33 @@ public:
         uint64_t timestamp;
         std::map<std::string, std::string> public_keys;
         std::map<std::string, std::string> services;
+        // SLH-DSA signature over the document by the registrar's identity key.
+        std::vector<uint8_t> signature;
     };
     
     BlockchainIdentity();
+    // Registered here, else looked up in the directory; a document with an
+    // empty did when neither has it or its signature does not verify.
     OnChainDID resolve_did(const std::string& did);
     void register_did(const OnChainDID& did_doc);
     void print_did_document(const OnChainDID& doc);
+    // Checks a registered document against the identity public key (or a
+    // trusted registrar's).
+    bool verify_did(const OnChainDID& doc) const;
+
+    // Publishes registered documents to the mesh's DHT from node_id and
+    // resolves unknown DIDs there. The mesh is not owned.
+    void use_directory(MeshNetwork* mesh, const std::string& node_id);
+    // Accepts documents signed by another registrar.
+    void trust_registrar(const SlhDsaShake256f::PublicKey& key);
+    const SlhDsaShake256f::PublicKey& registrar_key() const { return identity_key.public_key; }
 
 private:
     std::map<std::string, OnChainDID> registry;
+    SlhDsaShake256f::KeyPair identity_key;
+    std::vector<SlhDsaShake256f::PublicKey> trusted_registrars;
+    MeshNetwork* directory = nullptr;
+    std::string directory_node;
 };
 
 } // namespace Crypto
@@ -0,0 +1,73 @@
+#ifndef CHACHA20_POLY1305_H
+#define CHACHA20_POLY1305_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Crypto {
+
+// ChaCha20-Poly1305 (RFC 8439) for real-time media, where CPUs without
+// AES-NI still have to keep per-frame cost in the microseconds.
+//
+// The backend is chosen once per process by the kernel registry: 16-block
+// AVX-512 keystream, then 8-block AVX2 (both with a 4-way AVX2 Poly1305),
+// then portable code. Like CipherEngine, `in` and `out` may be the same
+// buffer so frames are encrypted in place.
+class ChaCha20Poly1305 {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 12;
+    static constexpr size_t TAG_SIZE = 16;
+
+    using Key = std::array<uint8_t, KEY_SIZE>;
+    using Nonce = std::array<uint8_t, NONCE_SIZE>;
+    using Tag = std::array<uint8_t, TAG_SIZE>;
+
+    enum class Backend {
+        Portable,
+        Avx2,
+        Avx512
+    };
+
+    explicit ChaCha20Poly1305(std::span<const uint8_t, KEY_SIZE> key);
+    ChaCha20Poly1305(std::span<const uint8_t, KEY_SIZE> key, Backend backend);
+    ~ChaCha20Poly1305();
+
+    ChaCha20Poly1305(const ChaCha20Poly1305&) = delete;
+    ChaCha20Poly1305& operator=(const ChaCha20Poly1305&) = delete;
+
+    void rekey(std::span<const uint8_t, KEY_SIZE> key);
+
+    // Detached AEAD; in.size() must equal out.size(). open() checks the tag
+    // before decrypting and wipes `out` on failure.
+    void seal(const Nonce& nonce, std::span<const uint8_t> aad,
+              std::span<const uint8_t> in, std::span<uint8_t> out, Tag& tag) const;
+    bool open(const Nonce& nonce, std::span<const uint8_t> aad,
+              std::span<const uint8_t> in, std::span<uint8_t> out, const Tag& tag) const;
+
+    // Same construction as CipherEngine::next_nonce: random 32-bit prefix
+    // plus a 64-bit counter.
+    Nonce next_nonce();
+
+    Backend backend() const { return backend_; }
+
+    static Backend best_backend();
+    static bool backend_supported(Backend backend);
+    static const char* backend_name(Backend backend);
+
+private:
+    void poly1305_tag(const uint8_t poly_key[32], std::span<const uint8_t> aad,
+                      std::span<const uint8_t> ciphertext, Tag& tag) const;
+
+    Backend backend_;
+    Key key_;
+    uint32_t nonce_prefix_;
+    std::atomic<uint64_t> nonce_counter_;
+};
+
+} // namespace Crypto
+
+#endif // CHACHA20_POLY1305_H
@@ -0,0 +1,135 @@
+#ifndef CIPHER_ENGINE_H
+#define CIPHER_ENGINE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Crypto {
+
+namespace aes_gcm {
+struct KeySchedule;
+}
+
+// AES-256-GCM shared by every message and file encryption path.
+//
+// The backend is chosen once per process by the kernel registry
+// (kernel_registry.h): VAES/VPCLMULQDQ, then AES-NI/PCLMULQDQ, then a
+// portable bitsliced implementation that is constant time but much slower.
+//
+// Detached calls take `in` and `out` spans of equal length that may be the
+// same buffer, so callers can encrypt in place. The sealed-box helpers use
+// the wire layout nonce || ciphertext || tag.
+class CipherEngine {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+    static constexpr size_t NONCE_SIZE = 12;
+    static constexpr size_t TAG_SIZE = 16;
+    static constexpr size_t OVERHEAD = NONCE_SIZE + TAG_SIZE;
+
+    using Key = std::array<uint8_t, KEY_SIZE>;
+    using Nonce = std::array<uint8_t, NONCE_SIZE>;
+    using Tag = std::array<uint8_t, TAG_SIZE>;
+
+    enum class Backend {
+        Portable,
+        AesNi,
+        Vaes
+    };
+
+    // Fresh random key.
+    CipherEngine();
+    explicit CipherEngine(std::span<const uint8_t, KEY_SIZE> key);
+    CipherEngine(std::span<const uint8_t, KEY_SIZE> key, Backend backend);
+    ~CipherEngine();
+
+    CipherEngine(const CipherEngine&) = delete;
+    CipherEngine& operator=(const CipherEngine&) = delete;
+
+    void rekey(std::span<const uint8_t, KEY_SIZE> key);
+
+    // Detached AEAD; in.size() must equal out.size().
+    void seal(const Nonce& nonce, std::span<const uint8_t> aad,
+              std::span<const uint8_t> in, std::span<uint8_t> out, Tag& tag) const;
+    bool open(const Nonce& nonce, std::span<const uint8_t> aad,
+              std::span<const uint8_t> in, std::span<uint8_t> out, const Tag& tag) const;
+
+    // Sealed box over a caller-owned buffer of payload + OVERHEAD bytes laid
+    // out as nonce || payload || tag; the payload is transformed in place.
+    void seal_box_in_place(std::span<uint8_t> box, std::span<const uint8_t> aad = {});
+    bool open_box_in_place(std::span<uint8_t> box, std::span<const uint8_t> aad = {}) const;
+
+    // Sealed box into a caller buffer: box.size() == plaintext.size() + OVERHEAD.
+    void seal_box_into(std::span<const uint8_t> plaintext, std::span<uint8_t> box,
+                       std::span<const uint8_t> aad = {});
+    bool open_box_into(std::span<const uint8_t> box, std::span<uint8_t> plaintext,
+                       std::span<const uint8_t> aad = {}) const;
+
+    std::vector<uint8_t> seal_box(std::span<const uint8_t> plaintext,
+                                  std::span<const uint8_t> aad = {});
+    std::optional<std::vector<uint8_t>> open_box(std::span<const uint8_t> box,
+                                                 std::span<const uint8_t> aad = {}) const;
+
+    // One message of a multi-buffer call. Each job names the engine (and so
+    // the key) it belongs to; in and out must have equal sizes and may alias.
+    struct BatchJob {
+        const CipherEngine* cipher = nullptr;
+        Nonce nonce{};
+        std::span<const uint8_t> aad;
+        std::span<const uint8_t> in;
+        std::span<uint8_t> out;
+        Tag tag{};          // written by seal_batch, checked by open_batch
+        bool ok = false;    // open_batch: tag verified
+    };
+
+    // Multi-buffer AEAD: independent messages under different keys are
+    // interleaved across SIMD lanes (8 with AES-NI or 256-bit VAES, 16 with
+    // 512-bit VAES), which is what makes many small messages fast. Jobs on a
+    // portable engine, and messages large enough to fill the single-message
+    // kernel, are processed one by one. open_batch wipes the output
+    // of every job that fails and returns how many authenticated.
+    static void seal_batch(std::span<BatchJob> jobs);
+    static size_t open_batch(std::span<BatchJob> jobs);
+    static const char* batch_backend_name();
+
+    static size_t plaintext_size(size_t box_size) {
+        return box_size < OVERHEAD ? 0 : box_size - OVERHEAD;
+    }
+
+    // 96-bit deterministic nonces: a random 32-bit prefix per engine plus a
+    // 64-bit counter (NIST SP 800-38D, section 8.2.1).
+    Nonce next_nonce();
+
+    Backend backend() const { return backend_; }
+
+    static Backend best_backend();
+    static bool backend_supported(Backend backend);
+    static const char* backend_name(Backend backend);
+    static Key generate_key();
+
+private:
+    static void run_batch(std::span<BatchJob> jobs, Tag* expected);
+
+    Backend backend_;
+    std::unique_ptr<aes_gcm::KeySchedule> schedule_;
+    uint32_t nonce_prefix_;
+    std::atomic<uint64_t> nonce_counter_;
+};
+
+inline std::span<const uint8_t> byte_view(std::string_view s) {
+    return {reinterpret_cast<const uint8_t*>(s.data()), s.size()};
+}
+
+inline std::span<uint8_t> byte_view(std::string& s) {
+    return {reinterpret_cast<uint8_t*>(s.data()), s.size()};
+}
+
+} // namespace Crypto
+
+#endif // CIPHER_ENGINE_H
@@ -0,0 +1,97 @@
+#ifndef CIRCUIT_POOL_H
+#define CIRCUIT_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "anonymous_routing.h"
+
+namespace Crypto {
+
+// Circuits built ahead of need. A worker thread keeps `per_class` ready
+// circuits for each AnonymousRouting exit class, so the first message of a
+// conversation does not wait for a circuit build (public-key operations at
+// the client and at every hop). The worker replaces a circuit
+// `rebuild_ahead` seconds before it expires (created_at + lifetime) and
+// builds the replacement before it retires the old one, so expiry alone
+// never leaves a class empty. rebuild_ahead must be less than lifetime
+// (otherwise std::invalid_argument): a circuit due for renewal as soon as
+// it is built would keep the worker rebuilding.
+//
+// Ready circuits sit in fixed slots of one atomic pointer each: take()
+// claims a circuit with an exchange and the worker publishes one with
+// another, so neither side takes a lock or waits on the other. A taken
+// circuit belongs to the caller, who closes it with
+// AnonymousRouting::destroy_route() when done. A take wakes the worker to
+// refill; a wakeup lost to the race with its sleep costs at most `poll`.
+// The AnonymousRouting must outlive the pool.
+class CircuitPool {
+public:
+    struct Options {
+        size_t per_class = 4;
+        uint64_t lifetime = 600;                // seconds from Route::created_at
+        uint64_t rebuild_ahead = 60;            // seconds before expiry
+        std::chrono::milliseconds poll{250};    // idle worker's check for expiring circuits
+    };
+
+    struct Stats {
+        uint64_t built = 0;
+        uint64_t replaced = 0;                  // retired before expiry by a fresh one
+        uint64_t taken = 0;
+        uint64_t misses = 0;                    // take() found the class empty
+        uint64_t failed = 0;                    // build_route() found no circuit
+    };
+
+    explicit CircuitPool(AnonymousRouting& routing);
+    CircuitPool(AnonymousRouting& routing, const Options& options);
+    ~CircuitPool();
+
+    CircuitPool(const CircuitPool&) = delete;
+    CircuitPool& operator=(const CircuitPool&) = delete;
+
+    // A ready circuit for exit_class, or nullptr when there is none (the
+    // caller then builds one itself).
+    std::unique_ptr<AnonymousRouting::Route> take(uint32_t exit_class);
+    size_t ready(uint32_t exit_class) const;
+    Stats stats() const;
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<AnonymousRouting::Route*> route{nullptr};
+        uint64_t renew_at = 0;                  // worker only
+    };
+
+    void worker_loop();
+    // Builds for the first empty slot, else the first due for renewal.
+    // False when there was nothing to do or the build failed.
+    bool refill();
+    void wake();
+
+    AnonymousRouting& routing_;
+    const Options options_;
+    // Exit class c owns slots [c * per_class, (c + 1) * per_class).
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<size_t> next_{0};
+
+    std::atomic<uint64_t> built_{0};
+    std::atomic<uint64_t> replaced_{0};
+    std::atomic<uint64_t> taken_{0};
+    std::atomic<uint64_t> misses_{0};
+    std::atomic<uint64_t> failed_{0};
+
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::atomic<bool> wanted_{false};
+    bool stopping_ = false;
+    std::thread worker_;
+};
+
+} // namespace Crypto
+
+#endif // CIRCUIT_POOL_H
@@ -0,0 +1,144 @@
+#ifndef COVER_TRAFFIC_H
+#define COVER_TRAFFIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "sphinx.h"
+#include "timer_wheel.h"
+
+namespace Crypto {
+
+// Cover traffic for MetadataProtection and AnonymousRouting, in the manner
+// of Loopix: each client sends at the instants of a Poisson process of
+// `rate` packets per second whatever it has to say. At each instant the
+// oldest waiting real message goes out; with none waiting, a cover packet
+// does, a loop (addressed back to the client, which sees it return) with
+// probability loop_fraction and a drop (discarded by the exit) otherwise.
+// Real messages thus take the place of cover instead of adding to it, and
+// an observer of the client's link sees the same process either way. The
+// packets are built by the caller's Emit, as ordinary Sphinx cells of the
+// client's circuit: only the exit can tell cover from a message.
+//
+// Two budgets bound the cost, and both act only through the rate: every
+// instant sends a packet, so the process an observer sees never depends
+// on whether a real message was waiting. bytes_per_second (all clients
+// together) lowers the per-client rate so the expected egress fits;
+// cpu_fraction bounds the share of one core spent building packets,
+// lowering the rate by the cost of a cover packet as measured around Emit
+// (a running average). Lowering rate trades anonymity for cost: real
+// messages wait longer for an instant, and fewer packets hide them. A rate
+// of zero or less is rejected with std::invalid_argument.
+//
+// Time is the caller's (milliseconds), passed to advance(), as for
+// MetadataProtection::process(); the CPU budget is then per second of that
+// time. The next instant of every client sits in one TimerWheel.
+class CoverTraffic {
+public:
+    enum class Kind : uint8_t { REAL, DROP, LOOP };
+
+    struct Options {
+        double rate = 1.0;                      // packets per second per client, real and cover
+        double loop_fraction = 0.5;             // share of cover sent as loops
+        size_t packet_bytes = Sphinx::PACKET_SIZE;  // on the wire, for the byte budget
+        double bytes_per_second = 0;            // all clients together; 0: no cap
+        double cpu_fraction = 0.05;             // of one core, building cover; 0: no cap
+        size_t max_backlog = 64;                // real messages waiting per client
+    };
+
+    struct Stats {
+        uint64_t real = 0;
+        uint64_t drops = 0;
+        uint64_t loops = 0;
+        uint64_t loops_returned = 0;
+        uint64_t rejected = 0;                  // send() with the backlog full
+        uint64_t failed = 0;                    // Emit returned false
+        uint64_t bytes_real = 0;
+        uint64_t bytes_cover = 0;
+        double cpu_seconds = 0;                 // in Emit for cover
+        double rate = 0;                        // per client, after both budgets
+        double overhead = 0;                    // cover bytes per real byte
+        double mean_wait_ms = 0;                // real message, send() to its instant
+        double mean_loop_ms = 0;                // loop out and back
+        size_t backlog = 0;                     // real messages waiting, all clients
+    };
+
+    // Sends one packet for `client`. REAL: `message` to `recipient`. DROP:
+    // `recipient` is empty; Emit marks the packet as cover for the exit to
+    // discard (an empty recipient for MetadataProtection::wrap_message(),
+    // AnonymousRouting::build_cover_cell() on a circuit). LOOP: `recipient` is
+    // the client's loop address; the message comes back to
+    // loop_returned(). False when it could not be sent.
+    using Emit = std::function<bool(uint32_t client, Kind kind, const std::string& message,
+                                    const std::string& recipient)>;
+
+    explicit CoverTraffic(Emit emit);
+    CoverTraffic(Emit emit, const Options& options);
+
+    CoverTraffic(const CoverTraffic&) = delete;
+    CoverTraffic& operator=(const CoverTraffic&) = delete;
+
+    // A client whose first instant follows now_ms; its loops go to
+    // loop_recipient.
+    uint32_t add_client(const std::string& loop_recipient, uint64_t now_ms);
+    // Queues a real message for the client's next instant. False when the
+    // client is unknown or its backlog is full.
+    bool send(uint32_t client, const std::string& message, const std::string& recipient, uint64_t now_ms);
+    // Sends whatever is due by now_ms. Emit runs without the lock held.
+    // Returns the packets sent, real and cover.
+    size_t advance(uint64_t now_ms);
+    // A message delivered to a loop address: true (and timed) when it is
+    // one of this generator's loops.
+    bool loop_returned(const std::string& message, uint64_t now_ms);
+
+    // Changes rate (as a new Options::rate) from each client's next
+    // instant; ignored unless positive.
+    void set_rate(double rate);
+    Stats stats();
+    size_t client_count();
+
+private:
+    struct Pending {
+        std::string message;
+        std::string recipient;
+        uint64_t queued_ms;
+    };
+
+    struct Client {
+        std::string loop_recipient;
+        std::deque<Pending> backlog;
+    };
+
+    struct Outgoing {
+        uint32_t client;
+        Kind kind;
+        std::string message;
+        std::string recipient;
+        uint64_t wait_ms;                       // REAL: send() to this instant
+    };
+
+    // The caller holds the lock.
+    double client_rate() const;
+    uint64_t next_instant(uint64_t after_ms);
+    void take_instant(uint32_t client, uint64_t due_ms, std::vector<Outgoing>& out);
+
+    const Emit emit_;
+    Options options_;
+    std::vector<Client> clients_;
+    TimerWheel instants_;
+    double cover_seconds_ = 0;                  // Emit for one cover packet, running average
+    uint64_t loop_nonce_;                       // tells our loops from anything else
+    Stats stats_;
+    double wait_ms_ = 0;
+    double loop_ms_ = 0;
+    std::mutex mutex_;
+};
+
+} // namespace Crypto
+
+#endif // COVER_TRAFFIC_H
@@ -0,0 +1,33 @@
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <string>
+
+namespace Crypto {
+
+// Instruction set extensions relevant to the crypto kernels. Probed once via
+// CPUID/XGETBV; an extension is only reported when the OS also saves the
+// register state it needs.
+struct CpuFeatures {
+    bool sse2 = false;
+    bool ssse3 = false;
+    bool sse41 = false;
+    bool aesni = false;
+    bool pclmulqdq = false;
+    bool avx = false;
+    bool avx2 = false;
+    bool bmi2 = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool sha_ni = false;
+    bool vaes = false;
+    bool vpclmulqdq = false;
+};
+
+const CpuFeatures& cpu_features();
+std::string describe_cpu_features(const CpuFeatures& features);
+
+} // namespace Crypto
+
+#endif // CPU_FEATURES_H
@@ -6,9 +6,19 @@
 #include <vector>
 #include <array>
 #include <mutex>
+#include <optional>
+#include <span>
+#include "hmac_sha256.h"
+#include "skipped_key_store.h"
 
 namespace Crypto {
 
+class SessionStore;
+
+// Signal-style Double Ratchet key schedule. Symmetric chains use
+// KDF_CK (message key = HMAC(ck, 0x01), next chain key = HMAC(ck, 0x02))
+// with the chain key's HMAC pads precomputed, so a derivation costs six
+// SHA-256 compressions; the root chain uses HKDF-SHA256 (KDF_RK).
 class DoubleRatchet {
 public:
     struct RatchetState {
@@ -19,23 +29,53 @@ public:
         uint64_t receiving_ratchet_counter;
         uint64_t previous_chain_length;
     };
-    
+
     struct MessageKey {
         std::array<uint8_t, 32> key;
         uint64_t message_number;
     };
-    
-    DoubleRatchet();
-    void initialize_session(const std::string& peer_id);
+
+    explicit DoubleRatchet(const SkippedKeyStore::Limits& limits = SkippedKeyStore::DEFAULT_LIMITS);
+    // The initiator's sending chain is the responder's receiving chain.
+    void initialize_session(const std::string& peer_id, bool initiator = true);
     MessageKey derive_message_key(bool sending);
-    void ratchet_forward();
+    // Receiving chain, fast-forwarded to `message_number` in one call: the
+    // keys stepped over go to the skipped-key store. Earlier numbers are
+    // served (once) from the store. nullopt if the key is not there or the
+    // message would skip more than max_skip keys.
+    std::optional<MessageKey> derive_message_key_at(uint64_t message_number);
+    // Same, for a message sent under `ratchet_public_key`: the current
+    // receiving chain, or a key skipped on an earlier one.
+    std::optional<MessageKey> derive_message_key_at(std::span<const uint8_t> ratchet_public_key,
+                                                    uint64_t message_number);
+    // DH ratchet step: KDF_RK(root key, dh_output) gives the new root and
+    // both chain keys. Skipped keys of earlier chains stay available when
+    // the peer's new ratchet public key is given; otherwise they are
+    // discarded. With a public key, the receiving chain's remaining keys
+    // up to the peer's previous chain length (PN of its header) are stored
+    // first; false, with no step taken, when that skips past max_skip.
+    bool ratchet_forward(std::span<const uint8_t> dh_output, std::span<const uint8_t> remote_ratchet_public_key = {},
+                         uint64_t remote_previous_chain_length = 0);
+    // Expires skipped keys older than max_age.
     void process_delayed_messages();
+    // Checkpoint to, or restore from, a SessionStore instead of a new
+    // handshake after a restart. Skipped keys are not kept. restore_session
+    // is false when the store has no readable record for the peer.
+    bool save_session(SessionStore& store);
+    bool restore_session(const std::string& peer_id, SessionStore& store);
 
 private:
+    // KDF_RK: new root key and both chain keys from the DH output.
+    void rekey_chains(std::span<const uint8_t> dh_output);
+
     RatchetState state;
     std::string peer_id;
+    bool initiator = true;
     std::mutex ratchet_mutex;
-    std::vector<MessageKey> message_keys;
+    SkippedKeyStore skipped_keys;
+    SkippedKeyStore::RatchetId receiving_ratchet{};  // SHA-256 of the peer's ratchet public key
+    std::optional<HmacSha256> sending_chain;     // keyed with sending_chain_key
+    std::optional<HmacSha256> receiving_chain;   // keyed with receiving_chain_key
 };
 
 } // namespace Crypto
@@ -0,0 +1,466 @@
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace Crypto {
+
+namespace detail {
+
+// Open-addressing table in the SwissTable layout: one control byte per
+// slot, either EMPTY, DELETED or the low 7 bits of the key's hash. A
+// lookup compares 16 control bytes at once and touches a slot only when
+// those 7 bits match, so a miss usually costs one control-byte load and a
+// hit one key compare. Slots hold values inline: no node per entry.
+//
+// The slot array is split into aligned groups of 16, probed in triangular
+// order, and is at most 7/8 full. An erased slot is marked EMPTY when its
+// group still has an EMPTY byte (no probe ever continued past that group),
+// DELETED otherwise; tombstones are dropped by the next rehash.
+//
+// Iterators and references are invalidated by any insertion that grows the
+// table, and stay valid across erase of other elements.
+template <typename Value, typename Key, typename KeyOf, typename Hash, typename Eq>
+class FlatTable {
+public:
+    using key_type = Key;
+    using value_type = Value;
+    using size_type = size_t;
+    using hasher = Hash;
+    using key_equal = Eq;
+
+    static constexpr size_t GROUP_WIDTH = 16;
+
+private:
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xFE;
+
+    static bool is_full(uint8_t c) { return c < 0x80; }
+
+    // Bit i set when control byte i of the group matches.
+    struct Group {
+#if defined(__SSE2__) || defined(_M_X64)
+        __m128i ctrl;
+        explicit Group(const uint8_t* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+        uint32_t match(uint8_t h2) const {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(static_cast<char>(h2)))));
+        }
+        uint32_t match_empty() const { return match(EMPTY); }
+        // EMPTY and DELETED are the only bytes with the top bit set.
+        uint32_t match_free() const { return static_cast<uint32_t>(_mm_movemask_epi8(ctrl)); }
+#else
+        uint8_t ctrl[GROUP_WIDTH];
+        explicit Group(const uint8_t* p) { std::memcpy(ctrl, p, GROUP_WIDTH); }
+        uint32_t match(uint8_t h2) const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) mask |= static_cast<uint32_t>(ctrl[i] == h2) << i;
+            return mask;
+        }
+        uint32_t match_empty() const { return match(EMPTY); }
+        uint32_t match_free() const {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < GROUP_WIDTH; ++i) mask |= static_cast<uint32_t>(ctrl[i] >> 7) << i;
+            return mask;
+        }
+#endif
+    };
+
+    static unsigned lowest_bit(uint32_t mask) { return static_cast<unsigned>(__builtin_ctz(mask)); }
+
+    // std::hash of an integer is the identity on common standard libraries:
+    // fold a 64x64->128 multiply so that both the group index (high bits)
+    // and the control byte (low 7 bits) depend on every input bit.
+    static uint64_t mix(size_t h) {
+        constexpr uint64_t K = 0x9E3779B97F4A7C15ULL;
+#if defined(__SIZEOF_INT128__)
+        __extension__ typedef unsigned __int128 u128;
+        const u128 p = static_cast<u128>(h) * K;
+        return static_cast<uint64_t>(p) ^ static_cast<uint64_t>(p >> 64);
+#else
+        uint64_t x = static_cast<uint64_t>(h) * K;
+        return x ^ (x >> 32);
+#endif
+    }
+    static uint8_t h2(uint64_t h) { return static_cast<uint8_t>(h & 0x7F); }
+
+    struct Slot {
+        alignas(Value) unsigned char bytes[sizeof(Value)];
+    };
+
+    Value* value_at(size_t i) const { return std::launder(reinterpret_cast<Value*>(slots_[i].bytes)); }
+
+public:
+    template <bool Const>
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Value;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const Value*, Value*>;
+        using reference = std::conditional_t<Const, const Value&, Value&>;
+
+        Iterator() = default;
+        // iterator -> const_iterator
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other) : table_(other.table_), index_(other.index_) {}
+
+        reference operator*() const { return *table_->value_at(index_); }
+        pointer operator->() const { return table_->value_at(index_); }
+
+        Iterator& operator++() {
+            index_ = table_->next_full(index_ + 1);
+            return *this;
+        }
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const Iterator& a, const Iterator& b) { return a.index_ == b.index_; }
+
+    private:
+        friend class FlatTable;
+        template <bool>
+        friend class Iterator;
+
+        Iterator(const FlatTable* table, size_t index) : table_(table), index_(index) {}
+
+        const FlatTable* table_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatTable() = default;
+    explicit FlatTable(size_t expected) { reserve(expected); }
+
+    FlatTable(const FlatTable& other) : hash_(other.hash_), eq_(other.eq_) {
+        reserve(other.size_);
+        for (const Value& v : other) construct_at(find_or_prepare_insert(KeyOf{}(v)), v);
+    }
+
+    FlatTable(FlatTable&& other) noexcept { swap(other); }
+
+    FlatTable& operator=(FlatTable other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~FlatTable() { release(); }
+
+    void swap(FlatTable& other) noexcept {
+        using std::swap;
+        swap(ctrl_, other.ctrl_);
+        swap(slots_, other.slots_);
+        swap(capacity_, other.capacity_);
+        swap(size_, other.size_);
+        swap(growth_left_, other.growth_left_);
+        swap(hash_, other.hash_);
+        swap(eq_, other.eq_);
+    }
+
+    iterator begin() { return iterator(this, next_full(0)); }
+    iterator end() { return iterator(this, capacity_); }
+    const_iterator begin() const { return const_iterator(this, next_full(0)); }
+    const_iterator end() const { return const_iterator(this, capacity_); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    size_t capacity() const { return capacity_; }
+
+    iterator find(const Key& key) { return iterator(this, find_index(key)); }
+    const_iterator find(const Key& key) const { return const_iterator(this, find_index(key)); }
+    bool contains(const Key& key) const { return find_index(key) != capacity_; }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+
+    size_t erase(const Key& key) {
+        const size_t i = find_index(key);
+        if (i == capacity_) return 0;
+        erase_at(i);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos) {
+        erase_at(pos.index_);
+        return iterator(this, next_full(pos.index_ + 1));
+    }
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    void clear() {
+        if (capacity_ == 0) return;
+        destroy_values();
+        std::memset(ctrl_.get(), EMPTY, capacity_);
+        size_ = 0;
+        growth_left_ = max_load(capacity_);
+    }
+
+    // Makes room for `expected` elements without further rehashing.
+    void reserve(size_t expected) {
+        size_t cap = GROUP_WIDTH;
+        while (max_load(cap) < expected) cap *= 2;
+        if (cap > capacity_) rehash(cap);
+    }
+
+protected:
+    // Index of an existing key, or of the free slot where it should be
+    // built (`inserted`), with the control byte it will take there.
+    struct InsertSlot {
+        size_t index;
+        bool inserted;
+        uint8_t tag;
+    };
+
+    // The caller must construct_at() the slot when `inserted` is true;
+    // until then the table is unchanged but for a possible growth.
+    InsertSlot find_or_prepare_insert(const Key& key) {
+        const uint64_t h = mix(hash_(key));
+        if (capacity_ != 0) {
+            const size_t found = probe(key, h);
+            if (found != capacity_) return {found, false, ctrl_[found]};
+        }
+        size_t i = capacity_ != 0 ? find_insert_slot(h) : 0;
+        if (capacity_ == 0 || (growth_left_ == 0 && ctrl_[i] == EMPTY)) {
+            grow();
+            i = find_insert_slot(h);
+        }
+        return {i, true, h2(h)};
+    }
+
+    // Marks the slot full only once the value is built: a throwing
+    // constructor leaves the table as it was.
+    template <typename... Args>
+    Value& construct_at(const InsertSlot& at, Args&&... args) {
+        Value* v = ::new (slots_[at.index].bytes) Value(std::forward<Args>(args)...);
+        if (ctrl_[at.index] == EMPTY) --growth_left_;
+        ctrl_[at.index] = at.tag;
+        ++size_;
+        return *v;
+    }
+
+    iterator iterator_at(size_t i) { return iterator(this, i); }
+
+private:
+    static size_t max_load(size_t cap) { return cap - cap / 8; }
+
+    size_t group_mask() const { return capacity_ / GROUP_WIDTH - 1; }
+
+    size_t find_index(const Key& key) const {
+        if (capacity_ == 0) return capacity_;
+        return probe(key, mix(hash_(key)));
+    }
+
+    size_t probe(const Key& key, uint64_t h) const {
+        const uint8_t tag = h2(h);
+        size_t group = static_cast<size_t>(h >> 7) & group_mask();
+        for (size_t step = 1;; ++step) {
+            const size_t base = group * GROUP_WIDTH;
+            const Group g(ctrl_.get() + base);
+            for (uint32_t m = g.match(tag); m != 0; m &= m - 1) {
+                const size_t i = base + lowest_bit(m);
+                if (eq_(KeyOf{}(*value_at(i)), key)) return i;
+            }
+            if (g.match_empty() != 0) return capacity_;
+            group = (group + step) & group_mask();
+        }
+    }
+
+    // First EMPTY or DELETED slot on the key's probe sequence.
+    size_t find_insert_slot(uint64_t h) const {
+        size_t group = static_cast<size_t>(h >> 7) & group_mask();
+        for (size_t step = 1;; ++step) {
+            const size_t base = group * GROUP_WIDTH;
+            const uint32_t free = Group(ctrl_.get() + base).match_free();
+            if (free != 0) return base + lowest_bit(free);
+            group = (group + step) & group_mask();
+        }
+    }
+
+    void erase_at(size_t i) {
+        value_at(i)->~Value();
+        const size_t base = i & ~(GROUP_WIDTH - 1);
+        if (Group(ctrl_.get() + base).match_empty() != 0) {
+            ctrl_[i] = EMPTY;
+            ++growth_left_;
+        } else {
+            ctrl_[i] = DELETED;
+        }
+        --size_;
+    }
+
+    size_t next_full(size_t i) const {
+        while (i < capacity_ && !is_full(ctrl_[i])) ++i;
+        return i;
+    }
+
+    // Out of EMPTY slots: double, or rebuild at the same size when more
+    // than half of the used slots are tombstones.
+    void grow() {
+        if (capacity_ != 0 && size_ * 2 <= max_load(capacity_)) {
+            rehash(capacity_);
+        } else {
+            rehash(capacity_ == 0 ? GROUP_WIDTH : capacity_ * 2);
+        }
+    }
+
+    void rehash(size_t new_capacity) {
+        std::unique_ptr<uint8_t[]> old_ctrl = std::move(ctrl_);
+        Slot* old_slots = slots_;
+        const size_t old_capacity = capacity_;
+
+        ctrl_.reset(new uint8_t[new_capacity]);
+        std::memset(ctrl_.get(), EMPTY, new_capacity);
+        slots_ = std::allocator<Slot>().allocate(new_capacity);
+        capacity_ = new_capacity;
+        growth_left_ = max_load(new_capacity) - size_;
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!is_full(old_ctrl[i])) continue;
+            Value* v = std::launder(reinterpret_cast<Value*>(old_slots[i].bytes));
+            const uint64_t h = mix(hash_(KeyOf{}(*v)));
+            const size_t j = find_insert_slot(h);
+            ctrl_[j] = h2(h);
+            relocate(v, slots_[j].bytes);
+        }
+        if (old_slots != nullptr) std::allocator<Slot>().deallocate(old_slots, old_capacity);
+    }
+
+    template <typename T>
+    struct is_pair : std::false_type {};
+    template <typename A, typename B>
+    struct is_pair<std::pair<A, B>> : std::true_type {};
+
+    // A map's key is const and pair's move constructor would copy it; it
+    // can be moved from since the source is destroyed right after.
+    static void relocate(Value* from, unsigned char* to) {
+        if constexpr (is_pair<Value>::value) {
+            using First = std::remove_const_t<typename Value::first_type>;
+            ::new (to) Value(std::piecewise_construct, std::forward_as_tuple(std::move(const_cast<First&>(from->first))),
+                             std::forward_as_tuple(std::move(from->second)));
+        } else {
+            ::new (to) Value(std::move(*from));
+        }
+        from->~Value();
+    }
+
+    void destroy_values() {
+        if constexpr (!std::is_trivially_destructible_v<Value>) {
+            for (size_t i = 0; i < capacity_; ++i) {
+                if (is_full(ctrl_[i])) value_at(i)->~Value();
+            }
+        }
+    }
+
+    void release() {
+        if (capacity_ == 0) return;
+        destroy_values();
+        std::allocator<Slot>().deallocate(slots_, capacity_);
+        ctrl_.reset();
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        growth_left_ = 0;
+    }
+
+    std::unique_ptr<uint8_t[]> ctrl_;
+    Slot* slots_ = nullptr;
+    size_t capacity_ = 0;                   // 0 or a power of two >= GROUP_WIDTH
+    size_t size_ = 0;
+    size_t growth_left_ = 0;                // EMPTY slots usable before a rehash
+    [[no_unique_address]] Hash hash_;
+    [[no_unique_address]] Eq eq_;
+};
+
+struct PairFirst {
+    template <typename P>
+    const auto& operator()(const P& p) const { return p.first; }
+};
+
+struct Identity {
+    template <typename T>
+    const T& operator()(const T& v) const { return v; }
+};
+
+} // namespace detail
+
+// Drop-in for the std::map / std::unordered_map uses in the modules:
+// find, operator[], try_emplace, erase by key or iterator, iteration.
+// Iteration order is unspecified.
+template <typename K, typename V, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashMap : public detail::FlatTable<std::pair<const K, V>, K, detail::PairFirst, Hash, Eq> {
+    using Base = detail::FlatTable<std::pair<const K, V>, K, detail::PairFirst, Hash, Eq>;
+
+public:
+    using mapped_type = V;
+    using typename Base::iterator;
+    using typename Base::value_type;
+
+    using Base::Base;
+
+    template <typename KK, typename... Args>
+    std::pair<iterator, bool> try_emplace(KK&& key, Args&&... args) {
+        const auto at = this->find_or_prepare_insert(key);
+        if (at.inserted) {
+            this->construct_at(at, std::piecewise_construct, std::forward_as_tuple(std::forward<KK>(key)),
+                               std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return {this->iterator_at(at.index), at.inserted};
+    }
+
+    template <typename KK, typename VV>
+    std::pair<iterator, bool> emplace(KK&& key, VV&& value) {
+        return try_emplace(std::forward<KK>(key), std::forward<VV>(value));
+    }
+
+    std::pair<iterator, bool> insert(const value_type& v) { return try_emplace(v.first, v.second); }
+    std::pair<iterator, bool> insert(value_type&& v) {
+        return try_emplace(std::move(const_cast<K&>(v.first)), std::move(v.second));
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+    V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+};
+
+// Elements are reachable only through const iterators: changing one in
+// place would leave it in the wrong slot.
+template <typename K, typename Hash = std::hash<K>, typename Eq = std::equal_to<K>>
+class FlatHashSet : public detail::FlatTable<K, K, detail::Identity, Hash, Eq> {
+    using Base = detail::FlatTable<K, K, detail::Identity, Hash, Eq>;
+
+public:
+    using iterator = typename Base::const_iterator;
+    using const_iterator = typename Base::const_iterator;
+
+    using Base::Base;
+
+    const_iterator begin() const { return Base::begin(); }
+    const_iterator end() const { return Base::end(); }
+    const_iterator find(const K& key) const { return Base::find(key); }
+
+    template <typename KK>
+    std::pair<const_iterator, bool> insert(KK&& key) {
+        const auto at = this->find_or_prepare_insert(key);
+        if (at.inserted) this->construct_at(at, std::forward<KK>(key));
+        return {this->iterator_at(at.index), at.inserted};
+    }
+};
+
+} // namespace Crypto
+
+#endif // FLAT_HASH_MAP_H
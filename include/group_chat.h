@@ -6,6 +6,11 @@
 #include <vector>
 #include <map>
 #include <mutex>
+#include <memory>
+#include <utility>
+
+#include "cipher_engine.h"
+#include "id128.h"
 
 namespace Crypto {
 
@@ -19,15 +24,16 @@ public:
     };
     
     struct GroupMessage {
-        std::string message_id;
+        Id128 message_id;
         std::string sender;
         std::string encrypted_content;
+        std::vector<uint8_t> nonce;
         std::vector<uint8_t> auth_tag;
         uint64_t timestamp;
     };
     
     struct Group {
-        std::string group_id;
+        Id128 group_id;
         std::string group_name;
         std::vector<GroupMember> members;
         std::vector<GroupMessage> message_history;
@@ -39,11 +45,18 @@ public:
     void add_member(Group& group, const std::string& user_id);
     void remove_member(Group& group, const std::string& user_id);
     GroupMessage send_message(Group& group, const std::string& sender, const std::string& message);
+    // (sender, message) pairs sealed together; each sender's key takes its own SIMD lane
+    std::vector<GroupMessage> send_messages(Group& group,
+                                            const std::vector<std::pair<std::string, std::string>>& outgoing);
     std::string receive_message(const Group& group, const GroupMessage& msg, const std::string& recipient);
 
 private:
     std::vector<Group> groups;
     std::mutex group_mutex;
+    // Expanded AES-GCM key per (group, sender); built on first use.
+    std::map<std::pair<Id128, std::string>, std::unique_ptr<CipherEngine>> sender_ciphers;
+
+    CipherEngine* sender_cipher(const Group& group, const std::string& user_id);
 };
 
 } // namespace Crypto
@@ -0,0 +1,43 @@
+#ifndef HMAC_SHA256_H
+#define HMAC_SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace Crypto {
+
+// HMAC-SHA256 (RFC 2104) keyed once: the inner and outer padded key blocks
+// are compressed at construction, so a MAC over a message of up to 55
+// bytes costs two compression calls instead of four. HKDF (RFC 5869) is
+// built on top for the root-key ratchet.
+class HmacSha256 {
+public:
+    static constexpr size_t MAC_SIZE = 32;
+    static constexpr size_t MAX_HKDF_OUTPUT = 255 * MAC_SIZE;
+
+    using Mac = std::array<uint8_t, MAC_SIZE>;
+
+    explicit HmacSha256(std::span<const uint8_t> key);
+    ~HmacSha256();
+
+    // Replaces the key in place (a ratchet step), without a new object.
+    void rekey(std::span<const uint8_t> key);
+
+    Mac mac(std::span<const uint8_t> data) const;
+
+    static Mac hkdf_extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm);
+    // Returns false when out is longer than MAX_HKDF_OUTPUT.
+    static bool hkdf_expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out);
+    static bool hkdf(std::span<const uint8_t> salt, std::span<const uint8_t> ikm, std::span<const uint8_t> info,
+                     std::span<uint8_t> out);
+
+private:
+    uint32_t inner_[8];     // state after H(K ^ ipad)
+    uint32_t outer_[8];     // state after H(K ^ opad)
+};
+
+} // namespace Crypto
+
+#endif // HMAC_SHA256_H
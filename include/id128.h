@@ -0,0 +1,76 @@
+#ifndef ID128_H
+#define ID128_H
+
+#include <array>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "secure_random.h"
+
+namespace Crypto {
+
+// Identifier of a message, conversation, file, task... 128 random bits, so
+// ids drawn independently do not collide in practice (a collision is
+// expected after about 2^64 of them, where "prefix_" + a number below 10^6
+// collided after about a thousand). Two words in memory: maps keyed by it
+// compare two integers instead of heap strings. The text form exists only
+// at the API edge (logs, user input): an optional "prefix_" followed by 26
+// lowercase base32 characters.
+struct Id128 {
+    static constexpr size_t TEXT_SIZE = 26;
+
+    uint64_t hi = 0;
+    uint64_t lo = 0;
+
+    static Id128 generate() { return {SecureRandom::next_u64(), SecureRandom::next_u64()}; }
+    // Accepts to_string()'s output with any prefix (or none); nullopt when
+    // malformed.
+    static std::optional<Id128> parse(std::string_view text);
+
+    // "msg" gives "msg_0k2..."; the prefix is for readers, not parsed.
+    std::string to_string(std::string_view prefix = {}) const;
+    // Big-endian, e.g. to bind the id to a ciphertext as AAD.
+    std::array<uint8_t, 16> bytes() const;
+
+    explicit operator bool() const { return (hi | lo) != 0; }
+    friend constexpr bool operator==(const Id128&, const Id128&) = default;
+    friend constexpr auto operator<=>(const Id128&, const Id128&) = default;
+};
+
+std::ostream& operator<<(std::ostream& os, const Id128& id);
+
+// Generated ids are uniform already, but parsed ones may be chosen by a
+// peer: the words are mixed with a per-process secret so that colliding
+// ids cannot be precomputed to flood a hash table.
+struct Id128Hash {
+    static uint64_t mix(uint64_t h) {
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    static uint64_t seed() {
+        static const uint64_t value = SecureRandom::next_u64();
+        return value;
+    }
+
+    size_t operator()(const Id128& id) const noexcept {
+        return static_cast<size_t>(mix(mix(id.hi ^ seed()) ^ id.lo));
+    }
+};
+
+} // namespace Crypto
+
+template <>
+struct std::hash<Crypto::Id128> : Crypto::Id128Hash {};
+
+#endif // ID128_H
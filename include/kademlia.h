@@ -0,0 +1,174 @@
+#ifndef KADEMLIA_H
+#define KADEMLIA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flat_hash_map.h"
+
+namespace Crypto {
+
+// Kademlia DHT for peer and record discovery, with every node in this
+// process, like MeshNetwork's nodes. Nodes are named by their mesh node id;
+// node ids and record keys are SHA-256 of those names, and distance is
+// their XOR.
+//
+// Each node keeps up to k contacts per k-bucket (bucket i: contacts whose
+// id shares exactly i leading bits with the node's), least recently seen
+// first. A full bucket pings its oldest contact before taking a new one,
+// and only drops it when it fails to answer. A node learns its callers
+// from every RPC it answers.
+//
+// Lookups are iterative: the initiator asks the alpha closest nodes it
+// knows in parallel (one round), merges what they return, and repeats
+// while that brings it closer to the target. Once a round brings no closer
+// node, it asks every unqueried node among the k closest in one last
+// round. FIND_VALUE stops at the first node holding the record. A lookup
+// takes O(log n) rounds; LookupStats reports the count.
+//
+// STORE puts a record on the k nodes closest to its key. Replicas expire
+// after record_ttl; the publisher stores its records again every
+// republish_interval, which also reaches nodes that joined closer to the
+// key meanwhile. advance() moves the simulated clock.
+//
+// RPCs go through the Link hook: false means the callee did not answer
+// (offline, unreachable). MeshNetwork binds it to its nodes' state; by
+// default any node marked online answers. Not thread-safe.
+class Kademlia {
+public:
+    struct Key {
+        std::array<uint64_t, 4> words{};        // words[0] most significant
+
+        static Key of(std::string_view name);
+        // Leading bits shared with `other` (256 when equal).
+        int common_prefix(const Key& other) const;
+
+        friend bool operator==(const Key&, const Key&) = default;
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& key) const noexcept { return static_cast<size_t>(key.words[0] ^ key.words[3]); }
+    };
+
+    struct Options {
+        size_t k = 20;                          // bucket size and replication factor
+        size_t alpha = 3;                       // RPCs in flight per lookup round
+        double record_ttl = 86400.0;            // seconds
+        double republish_interval = 3600.0;
+    };
+
+    struct LookupStats {
+        size_t rounds = 0;
+        size_t rpcs = 0;
+        size_t failed_rpcs = 0;
+    };
+
+    struct Stats {
+        uint64_t rpcs = 0;
+        uint64_t failed_rpcs = 0;
+        uint64_t lookups = 0;
+        uint64_t rounds = 0;
+        uint64_t stores = 0;                    // replicas written, republishing included
+        uint64_t republished = 0;               // records
+        uint64_t expired = 0;                   // replicas
+    };
+
+    using Link = std::function<bool(const std::string& from, const std::string& to)>;
+
+    explicit Kademlia(const Options& options);
+    Kademlia() : Kademlia(Options{}) {}
+
+    // Adds a node and joins through `bootstrap` (empty for the first node):
+    // a lookup of its own id fills its buckets and makes it known along
+    // the way. False when the name is taken or the bootstrap is unknown
+    // or does not answer.
+    bool join(const std::string& name, const std::string& bootstrap);
+    bool contains(const std::string& name) const;
+    // An offline node answers no RPC and runs no republishing.
+    void set_online(const std::string& name, bool online);
+    void set_link(Link link);
+
+    // Names of the k nodes closest to `target` that answered.
+    std::vector<std::string> find_node(const std::string& from, const Key& target, LookupStats* stats = nullptr);
+    // Number of replicas written (0 when `from` is unknown).
+    size_t store(const std::string& from, const std::string& key, const std::string& value,
+                 LookupStats* stats = nullptr);
+    std::optional<std::string> find_value(const std::string& from, const std::string& key,
+                                          LookupStats* stats = nullptr);
+
+    // Moves the clock on: replicas past their TTL go, due records are
+    // republished by their (online) publishers.
+    void advance(double seconds);
+    double now() const { return now_; }
+
+    size_t node_count() const { return nodes_.size(); }
+    // Contacts over all buckets of a node.
+    size_t contact_count(const std::string& name) const;
+    // Routing tables and replicas, all nodes.
+    size_t memory_bytes() const;
+    Stats stats() const { return stats_; }
+
+private:
+    using NodeIndex = uint32_t;
+
+    struct Record {
+        std::string value;
+        double expires = 0;
+    };
+
+    struct Published {
+        std::string key;
+        std::string value;
+        double next_republish = 0;
+    };
+
+    struct Node {
+        std::string name;
+        Key id;
+        bool online = true;
+        std::vector<std::vector<NodeIndex>> buckets;    // by common prefix length
+        FlatHashMap<Key, Record, KeyHash> records;
+        FlatHashMap<Key, Published, KeyHash> published;
+    };
+
+    // A lookup's view of one node.
+    struct Candidate {
+        Key distance;
+        NodeIndex node;
+        bool queried;
+        bool failed;
+    };
+
+    NodeIndex index_of(const std::string& name) const;
+    // Counted RPC; the callee learns the caller when it answers, the
+    // caller learns or drops the callee.
+    bool rpc(NodeIndex from, NodeIndex to);
+    bool answers(NodeIndex from, NodeIndex to);
+    void touch(NodeIndex node, NodeIndex contact);
+    void forget(NodeIndex node, NodeIndex contact);
+    // The k contacts of `node` closest to target.
+    std::vector<NodeIndex> closest(NodeIndex node, const Key& target) const;
+    // Iterative lookup from `from`: the k closest nodes that answered.
+    // With `value_key`, stops at the first node holding that record and
+    // sets *value.
+    std::vector<NodeIndex> lookup(NodeIndex from, const Key& target, const Key* value_key,
+                                  std::optional<std::string>* value, LookupStats* stats);
+    size_t store_at(NodeIndex from, const Key& key, const std::string& value, LookupStats* stats);
+
+    Options options_;
+    Link link_;
+    std::vector<Node> nodes_;
+    FlatHashMap<std::string, NodeIndex> index_;
+    double now_ = 0;
+    Stats stats_;
+};
+
+} // namespace Crypto
+
+#endif // KADEMLIA_H
@@ -0,0 +1,44 @@
+#ifndef KERNEL_REGISTRY_H
+#define KERNEL_REGISTRY_H
+
+#include <string>
+#include <string_view>
+
+namespace Crypto {
+
+// Instruction set tiers the SIMD kernels are built for. Each kernel family
+// (AES-GCM, ChaCha20-Poly1305, SHA-256, ...) maps its backends onto one of
+// these tiers; the binary is compiled for baseline x86-64 and only the
+// kernel translation units carry ISA flags.
+enum class IsaLevel {
+    Portable,
+    Sse41,      // SSSE3/SSE4.1 plus AES-NI, PCLMULQDQ, SHA-NI where present
+    Avx2,       // AVX2, VAES/VPCLMULQDQ on 256-bit registers
+    Avx512      // AVX-512F/BW/VL, VAES/VPCLMULQDQ on 512-bit registers
+};
+
+// Highest tier the CPU and OS support (see cpu_features()).
+IsaLevel detected_isa_level();
+
+// Ceiling applied to every kernel family; detected_isa_level() unless forced.
+IsaLevel isa_level_cap();
+bool isa_level_enabled(IsaLevel level);
+
+// Caps every kernel family at the named tier ("portable", "sse4.1", "avx2",
+// "avx512" or "auto"), for benchmarking slower paths on a fast host. Kernels
+// are bound on first use, so this only succeeds before any crypto runs;
+// tiers above what the CPU supports are clamped to it.
+bool force_backend(std::string_view name);
+
+// Applies `--force-backend=<tier>` or `--force-backend <tier>` from the
+// command line. Returns false if the flag is present but invalid.
+bool apply_force_backend_flag(int argc, char** argv);
+
+const char* isa_level_name(IsaLevel level);
+
+// One line naming the tier and the kernel bound for each family.
+std::string describe_kernels();
+
+} // namespace Crypto
+
+#endif // KERNEL_REGISTRY_H
@@ -5,7 +5,19 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <optional>
+
+#include "bloom_filter.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+#include "kademlia.h"
+#include "mesh_router.h"
+#include "network_simulator.h"
+#include "transport.h"
 
 namespace Crypto {
 
@@ -17,8 +29,12 @@ public:
         std::vector<std::string> peers;
         bool is_online;
         double latency;
+        // Peer id -> our end of the TCP link, once the transport runs.
+        FlatHashMap<std::string, Transport::ConnectionId> links;
+        // Gossip ids this node has taken, allocated by its first gossip.
+        std::unique_ptr<RotatingBloomFilter> seen;
     };
-    
+
     struct Message {
         std::string message_id;
         std::string sender;
@@ -26,16 +42,106 @@ public:
         std::string encrypted_content;
         std::vector<std::string> path;
     };
-    
+
+    // Epidemic broadcast: each node that receives a gossip message for the
+    // first time delivers it and passes it to `fanout` random peers (not
+    // the one it came from) while hops remain under `ttl`. Duplicates are
+    // dropped by a per-node RotatingBloomFilter holding at least
+    // `seen_capacity` recent ids, so a broadcast costs about N * fanout
+    // frames and every node bounded memory.
+    struct GossipOptions {
+        size_t fanout = 4;
+        uint8_t ttl = 12;
+        size_t seen_capacity = 8192;
+    };
+
+    struct GossipStats {
+        uint64_t originated = 0;
+        uint64_t frames = 0;                    // sent node to node
+        uint64_t delivered = 0;
+        uint64_t duplicates = 0;                // dropped by the seen filters
+    };
+
     MeshNetwork();
+    ~MeshNetwork();
     void add_node(const std::string& node_id, const std::string& address);
     void connect_nodes(const std::string& node1, const std::string& node2);
+    // Removes the link from the topology (and closes its TCP connection).
+    void disconnect_nodes(const std::string& node1, const std::string& node2);
+    // route_message() takes the lowest-latency path (see MeshRouter); a
+    // message with no route gets a path of just the sender.
     Message route_message(const std::string& sender, const std::string& recipient, const std::string& message);
     void print_network_topology();
 
+    // Every node joins a Kademlia DHT when added (through an existing
+    // node), with RPCs answered by online nodes. discover_peers() returns
+    // up to `count` of the nodes closest to node_id in the DHT that are not
+    // its peers yet, nearest first, for connect_nodes(); publish() and
+    // lookup() store and find records from a node (publish: false when no
+    // other node took a replica).
+    std::vector<std::string> discover_peers(const std::string& node_id, size_t count);
+    bool publish(const std::string& node_id, const std::string& key, const std::string& value);
+    std::optional<std::string> lookup(const std::string& node_id, const std::string& key);
+
+    // Gossips `message` from `origin` to the whole mesh; the delivery
+    // handler runs once per node reached (recipient: that node). Without
+    // the transport the epidemic runs in place before returning.
+    Message broadcast(const std::string& origin, const std::string& message);
+    void set_gossip_options(const GossipOptions& options);
+    GossipStats gossip_stats();
+
+    // Runs the mesh over real sockets: every node listens on its
+    // "host:port" address (port 0 picks one and rewrites the address),
+    // connect_nodes() opens a TCP link and waits until both ends know it,
+    // and route_message() sends the message hop by hop along its path, each
+    // node forwarding to the next. All nodes of this object share the
+    // transport's event loops, so a whole mesh can run on loopback in one
+    // process. Returns false when the transport cannot start.
+    bool start_transport(const Transport::Options& options = {});
+    void stop_transport();
+    // Called on a loop thread when a routed message reaches its recipient,
+    // and for each node a broadcast reaches.
+    void set_delivery_handler(std::function<void(const Message&)> handler);
+    Transport::Stats transport_stats() const;
+
+    // Runs the mesh over a NetworkSimulator instead: the same frames as
+    // over the transport, delivered as the simulator runs. Every link,
+    // existing or made by connect_nodes(), gets a simulated one with the
+    // router's cost as one-way latency (the mean of the two nodes'
+    // latencies) and the rest of `link`. False when the transport runs.
+    // The mesh must then be used from the simulator's thread only.
+    bool use_simulator(NetworkSimulator& simulator, const NetworkSimulator::LinkModel& link = {});
+
 private:
+    void listen_node(Node& node);
+    void on_frame(Transport::ConnectionId id, std::span<const uint8_t> frame);
+    void on_close(Transport::ConnectionId id);
+    bool forward(const Message& msg, size_t hop);
+    // Over the transport or the simulator, whichever runs.
+    bool linked() const { return transport || simulator; }
+    bool send_frame(Transport::ConnectionId link, std::vector<uint8_t>&& frame);
+    void link_simulated(Node& a, Node& b);
+    // False when the node has seen the id already.
+    bool accept_gossip(Node& node, const Id128& id);
+    // Up to fanout peers of node other than `from`, at random.
+    std::vector<std::string> gossip_targets(const Node& node, const std::string& from);
+    void send_gossip(const Node& node, const std::string& peer, const Id128& id, uint8_t ttl,
+                     const std::string& origin, const std::string& content);
+
     std::map<std::string, Node> nodes;
+    MeshRouter router;
+    Kademlia dht;
     std::mutex network_mutex;
+    std::condition_variable links_changed;
+    // Which node owns each end of a link.
+    FlatHashMap<Transport::ConnectionId, std::string> link_owners;
+    std::function<void(const Message&)> delivery_handler;
+    GossipOptions gossip_options;
+    GossipStats gossip_counters;
+    NetworkSimulator* simulator = nullptr;
+    NetworkSimulator::Endpoint simulator_endpoint = 0;
+    NetworkSimulator::LinkModel simulator_link;
+    std::unique_ptr<Transport> transport;   // last: its loops stop first
 };
 
 } // namespace Crypto
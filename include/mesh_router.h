@@ -0,0 +1,137 @@
+#ifndef MESH_ROUTER_H
+#define MESH_ROUTER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "flat_hash_map.h"
+
+namespace Crypto {
+
+// Lowest-latency routes over the mesh graph. Nodes get dense indexes in
+// the order they are added; links are undirected, and crossing the link
+// a-b costs the mean of the two nodes' latencies.
+//
+// The adjacency is a CSR array: each node's neighbours sit contiguously in
+// one targets array, with spare room at the end of every node's range so
+// that adding a link usually writes one slot. A node that runs out of room
+// moves to the end of the array with twice the room; the array is
+// compacted once half of it is abandoned ranges (amortized O(1) per link).
+//
+// Routing tables are per source: distance, shortest-path-tree parent and
+// first hop for every destination, built by Dijkstra on the first query
+// from that source and cached (up to max_tables, least recently used
+// evicted). next_hop() is then one array load. Link changes patch the
+// cached tables instead of dropping them: a new link relaxes outwards from
+// its ends; a removed link only matters when it is a tree edge, and then
+// only the subtree below it is recomputed, seeded from its surviving
+// neighbours.
+//
+// Not thread-safe; MeshNetwork calls it under its mutex.
+class MeshRouter {
+public:
+    using NodeIndex = uint32_t;
+    static constexpr NodeIndex NONE = UINT32_MAX;
+
+    struct Stats {
+        uint64_t full_builds = 0;               // Dijkstra from scratch
+        uint64_t incremental_updates = 0;       // cached tables patched by a link change
+        uint64_t nodes_settled = 0;             // queue pops, over both
+        size_t tables = 0;
+        size_t graph_bytes = 0;
+        size_t table_bytes = 0;
+    };
+
+    explicit MeshRouter(size_t max_tables = 64);
+
+    // Returns the node's index; an existing id keeps its index and takes
+    // the new latency (which drops the cached tables).
+    NodeIndex add_node(const std::string& id, double latency);
+    NodeIndex index_of(const std::string& id) const;
+    const std::string& name(NodeIndex node) const { return names_[node]; }
+    size_t node_count() const { return names_.size(); }
+    size_t link_count() const { return links_; }
+
+    // False for a self link, an unknown node, or a link that already
+    // exists / does not exist.
+    bool add_link(NodeIndex a, NodeIndex b);
+    bool remove_link(NodeIndex a, NodeIndex b);
+    bool has_link(NodeIndex a, NodeIndex b) const;
+
+    // NONE when `to` is unreachable (or when from == to). O(1) once the
+    // table of `from` exists.
+    NodeIndex next_hop(NodeIndex from, NodeIndex to);
+    // Sum of link costs in ms; infinity when unreachable.
+    double distance(NodeIndex from, NodeIndex to);
+    // from, ..., to; empty when unreachable.
+    std::vector<NodeIndex> path(NodeIndex from, NodeIndex to);
+
+    void clear_tables();
+    Stats stats() const;
+
+private:
+    struct Table {
+        NodeIndex source = NONE;
+        uint64_t last_used = 0;
+        std::vector<float> dist;
+        std::vector<NodeIndex> parent;
+        std::vector<NodeIndex> first;           // first hop from source
+    };
+
+    // Radix heap on the distance bits: Dijkstra only ever pushes distances
+    // at or above the last one popped, so an entry moves down at most 32
+    // buckets in total instead of sifting through a binary heap.
+    struct Queue {
+        std::vector<uint64_t> buckets[33];      // (distance bits << 32 | node)
+        uint32_t last = 0;
+        size_t size = 0;
+
+        void push(float dist, NodeIndex node);
+        uint64_t pop();
+        void clear();
+    };
+
+    float cost(NodeIndex a, NodeIndex b) const { return 0.5f * (latency_[a] + latency_[b]); }
+    void insert_target(NodeIndex node, NodeIndex target);
+    bool erase_target(NodeIndex node, NodeIndex target);
+    void compact();
+
+    Table& table(NodeIndex source);
+    void build(Table& t);
+    // Relax `node` from `via`; pushes it when its distance improved.
+    void relax(Table& t, NodeIndex via, NodeIndex node, float dist);
+    // Dijkstra from whatever queue_ holds.
+    void propagate(Table& t);
+    void link_added(Table& t, NodeIndex a, NodeIndex b);
+    void link_removed(Table& t, NodeIndex a, NodeIndex b);
+
+    const size_t max_tables_;
+
+    std::vector<std::string> names_;
+    FlatHashMap<std::string, NodeIndex> index_;
+    std::vector<float> latency_;
+
+    // CSR: node i's neighbours are targets_[begin_[i], begin_[i] + degree_[i]),
+    // with room_[i] slots reserved from begin_[i].
+    std::vector<uint32_t> begin_;
+    std::vector<uint32_t> degree_;
+    std::vector<uint32_t> room_;
+    std::vector<NodeIndex> targets_;
+    size_t abandoned_ = 0;                      // slots of ranges that moved
+    size_t links_ = 0;
+
+    std::vector<Table> tables_;
+    std::vector<uint32_t> table_of_;            // node -> slot in tables_, NONE if none
+    uint64_t clock_ = 0;
+    // Scratch for the searches.
+    Queue queue_;
+    std::vector<NodeIndex> subtree_;
+    std::vector<uint8_t> in_subtree_;
+    Stats stats_;
+};
+
+} // namespace Crypto
+
+#endif // MESH_ROUTER_H
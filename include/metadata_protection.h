@@ -1,28 +1,151 @@
 #ifndef METADATA_PROTECTION_H
 #define METADATA_PROTECTION_H
 
+#include <array>
+#include <functional>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <mutex>
 
+#include "flat_hash_map.h"
+#include "sphinx.h"
+
 namespace Crypto {
 
+// A mix network in this process. Messages travel as Sphinx cells (see
+// Sphinx) on a circuit through path_length distinct mixes, set up once;
+// what each mix adds is time. A mix holds an arriving packet for an
+// exponential delay of mean mix_delay_ms (per-mix hierarchical timer
+// wheel, O(1) per message), then drops it into its pool. The pool is
+// flushed when it reaches pool_threshold, and every flush_interval_ms
+// regardless (a timed dynamic pool mix): a flush takes a uniformly random
+// share of the pool, at most flush_fraction and never below pool_minimum
+// left behind, peels its layer off the whole batch in one pass, and
+// forwards it in random order. The circuit id travels sealed under the
+// key of the link it crosses (between two mixes, or the client and its
+// first mix), with a fresh nonce every time, so it is random bytes to an
+// observer. A mix drops a cell it has seen before (a rotating Bloom filter
+// over the layer's nonce), since peeling it again would give the same
+// output bits. Inputs and outputs are thus unlinkable by their bits (every
+// layer changes all 512 bytes, the sealed id is redrawn), by their order,
+// and by their timing beyond the pool's. Link keys here stand for those of
+// the authenticated channels between mixes; they are derived in process.
+//
+// Packets wait in fixed-size slots allocated in chunks, linked by index
+// through the timer wheel and the pool, so a queued message costs about
+// 530 bytes and no allocation; max_queued bounds each mix and arrivals
+// beyond it are dropped. Time is whatever the caller passes to process()
+// (milliseconds), so the same engine runs against the clock or a
+// NetworkSimulator. pool_threshold must exceed pool_minimum (otherwise
+// std::invalid_argument): a full pool could not flush.
 class MetadataProtection {
 public:
+    using Packet = Sphinx::Packet;
+
     struct MixNode {
         std::string node_id;
         std::string address;
-        std::vector<std::string> pending_messages;
-        uint64_t mix_delay_ms;
+        X25519::Key public_key;
+        uint64_t mix_delay_ms;                  // mean delay before the pool
     };
-    
+
+    struct Options {
+        size_t pool_threshold = 64;             // flush as soon as the pool holds this many
+        uint64_t flush_interval_ms = 1000;      // and at least this often
+        size_t pool_minimum = 16;               // left in the pool by a flush
+        double flush_fraction = 0.7;            // most of the pool one flush takes
+        size_t max_queued = size_t{1} << 22;    // per mix, delayed and pooled
+        size_t path_length = 3;                 // mixes per circuit, at most Sphinx::MAX_HOPS
+    };
+
+    static constexpr uint32_t CLIENT = UINT32_MAX;
+
+    // A circuit id on one link: nonce, the id sealed with the link's key, tag.
+    using SealedCircuit = std::array<uint8_t, ChaCha20Poly1305::NONCE_SIZE + 4 + ChaCha20Poly1305::TAG_SIZE>;
+
+    // A packet and the mix it is for, from a mix or the client, on the
+    // circuit it belongs to there.
+    struct MixPacket {
+        uint32_t mix = 0;
+        uint32_t from = CLIENT;
+        SealedCircuit circuit{};
+        Packet packet;
+    };
+
+    struct Delivery {
+        std::string recipient;
+        std::string message;
+        uint64_t at_ms;
+    };
+
+    struct MixStats {
+        size_t delayed = 0;                     // waiting in the timer wheel
+        size_t pooled = 0;
+        size_t peak_queued = 0;
+        size_t memory_bytes = 0;                // slots, wheel, pool and replay filter as allocated
+        uint64_t accepted = 0;
+        uint64_t dropped = 0;                   // store full, unknown circuit or bad tag or seal
+        uint64_t flushes = 0;
+        uint64_t flushed = 0;                   // messages out, forwarded or delivered
+        uint64_t cover_dropped = 0;             // at the exit, empty recipient
+        uint64_t replays = 0;                   // cells seen before, dropped
+    };
+
     MetadataProtection();
+    explicit MetadataProtection(const Options& options);
+    ~MetadataProtection();
+
     void setup_mix_network(int num_nodes);
-    void send_through_mix(const std::string& message, const std::string& recipient);
+    // Layers the message for the circuit and hands it to its first mix at
+    // the time of the last process(). False when recipient and message do
+    // not fit one cell or there is no circuit.
+    bool send_through_mix(const std::string& message, const std::string& recipient);
+    // The client half of send_through_mix(): the packet for the first mix.
+    // An empty recipient makes cover (see CoverTraffic), which the exit
+    // mix discards.
+    bool wrap_message(const std::string& message, const std::string& recipient, MixPacket& out);
+    // A packet reaching packet.mix at now_ms, from a client or a mix.
+    bool receive(const MixPacket& packet, uint64_t now_ms);
+    // Runs every mix to now_ms: delays ending, flushes due, packets passed
+    // on. Between mixes in this process unless a forward handler is set.
+    // Returns how many messages left the last mix.
+    size_t process(uint64_t now_ms);
+
+    void set_delivery_handler(std::function<void(const Delivery&)> handler);
+    // Takes over mix-to-mix traffic (for a network or a simulator), which
+    // comes back through receive().
+    void set_forward_handler(std::function<void(const MixPacket&)> handler);
+    MixStats mix_stats(size_t mix);
+    size_t mix_count();
 
 private:
+    struct MixState;
+
+    bool build_circuit();
+    // The caller holds the lock.
+    bool accept(const MixPacket& packet, uint64_t now_ms);
+    void flush(MixState& mix, uint64_t now_ms);
+    // Cipher of the link from `from` (a mix or CLIENT) to mix `to`.
+    const ChaCha20Poly1305& link(uint32_t from, uint32_t to);
+    SealedCircuit seal_circuit(uint32_t from, uint32_t to, uint32_t circuit);
+    bool open_circuit(const MixPacket& packet, uint32_t& circuit);
+
+    Options options;
     std::vector<MixNode> mix_network;
+    std::vector<std::unique_ptr<MixState>> mixes;
+    Sphinx::Key link_secret;
+    FlatHashMap<uint64_t, std::unique_ptr<ChaCha20Poly1305>> links;
+    // This client's circuit: mixes, entry circuit id and hop keys.
+    std::vector<uint32_t> path;
+    uint32_t entry_circuit = 0;
+    std::vector<Sphinx::Key> hop_keys;
+    uint64_t clock_ms = 0;                      // of the last process()
+    std::vector<MixPacket> outgoing;            // process()'s output, passed on after the mixes ran
+    std::vector<Delivery> deliveries;
+    std::function<void(const Delivery&)> delivery_handler;
+    std::function<void(const MixPacket&)> forward_handler;
     std::mutex mix_mutex;
 };
 
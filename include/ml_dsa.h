@@ -0,0 +1,89 @@
+#ifndef ML_DSA_H
+#define ML_DSA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace Crypto {
+
+// ML-DSA-87 (FIPS 204, formerly CRYSTALS-Dilithium-5), NIST category 5.
+//
+// NTT, pointwise products and the four-way Keccak used to expand the
+// matrix and the masking vectors come from the kernel registry, like
+// MlKem1024. Signing is hedged (fresh randomness per signature) unless a
+// seed is passed explicitly.
+class MlDsa87 {
+public:
+    static constexpr size_t PUBLIC_KEY_SIZE = 2592;
+    static constexpr size_t SECRET_KEY_SIZE = 4896;
+    static constexpr size_t SIGNATURE_SIZE = 4627;
+    static constexpr size_t SEED_SIZE = 32;
+    static constexpr size_t MAX_CONTEXT_SIZE = 255;
+
+    using PublicKey = std::array<uint8_t, PUBLIC_KEY_SIZE>;
+    using SecretKey = std::array<uint8_t, SECRET_KEY_SIZE>;
+    using Signature = std::array<uint8_t, SIGNATURE_SIZE>;
+    using Seed = std::array<uint8_t, SEED_SIZE>;
+
+    struct KeyPair {
+        PublicKey public_key;
+        SecretKey secret_key;
+    };
+
+    // Everything verification derives from the public key alone: the
+    // matrix A and t1 * 2^d in the NTT domain, and tr = H(pk). About 66 KB.
+    struct ExpandedPublicKey;
+
+    static KeyPair generate_keypair();
+    // Deterministic ML-DSA.KeyGen_internal(xi), for known-answer tests.
+    static KeyPair generate_keypair(const Seed& xi);
+
+    // nullopt only when the context is longer than 255 bytes.
+    static std::optional<Signature> sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                         std::span<const uint8_t> message,
+                                         std::span<const uint8_t> context = {});
+    // ML-DSA.Sign_internal with caller-chosen rnd (all zero: deterministic variant).
+    static std::optional<Signature> sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                         std::span<const uint8_t> message,
+                                         std::span<const uint8_t> context, const Seed& rnd);
+
+    static std::shared_ptr<const ExpandedPublicKey> expand_public_key(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key);
+
+    static bool verify(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key, std::span<const uint8_t> message,
+                       std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context = {});
+    static bool verify(const ExpandedPublicKey& key, std::span<const uint8_t> message,
+                       std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context = {});
+
+    static const char* backend_name();
+
+    // Expanded keys of recently seen signers, safe to share between
+    // verifier threads. The least recently used key is dropped when full.
+    class KeyCache {
+    public:
+        explicit KeyCache(size_t capacity = 128);
+
+        std::shared_ptr<const ExpandedPublicKey> get(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key);
+        size_t size() const;
+
+    private:
+        using Entry = std::pair<std::string, std::shared_ptr<const ExpandedPublicKey>>;
+
+        size_t capacity_;
+        mutable std::mutex mutex_;
+        std::list<Entry> entries_;     // most recently used first
+        std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    };
+};
+
+} // namespace Crypto
+
+#endif // ML_DSA_H
@@ -0,0 +1,62 @@
+#ifndef ML_KEM_H
+#define ML_KEM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Crypto {
+
+// ML-KEM-1024 (FIPS 203, formerly CRYSTALS-Kyber-1024), NIST category 5.
+//
+// Polynomial arithmetic (NTT, base multiplication, binomial sampling) and
+// the four-way Keccak used for matrix expansion come from the kernel
+// registry: AVX2 where available, portable code otherwise. Both produce
+// identical keys and ciphertexts.
+class MlKem1024 {
+public:
+    static constexpr size_t PUBLIC_KEY_SIZE = 1568;
+    static constexpr size_t SECRET_KEY_SIZE = 3168;
+    static constexpr size_t CIPHERTEXT_SIZE = 1568;
+    static constexpr size_t SHARED_SECRET_SIZE = 32;
+    static constexpr size_t SEED_SIZE = 32;
+
+    using PublicKey = std::array<uint8_t, PUBLIC_KEY_SIZE>;
+    using SecretKey = std::array<uint8_t, SECRET_KEY_SIZE>;
+    using Ciphertext = std::array<uint8_t, CIPHERTEXT_SIZE>;
+    using SharedSecret = std::array<uint8_t, SHARED_SECRET_SIZE>;
+    using Seed = std::array<uint8_t, SEED_SIZE>;
+
+    struct KeyPair {
+        PublicKey public_key;
+        SecretKey secret_key;
+    };
+
+    struct Encapsulation {
+        Ciphertext ciphertext;
+        SharedSecret shared_secret;
+    };
+
+    static KeyPair generate_keypair();
+    // Deterministic ML-KEM.KeyGen_internal(d, z), for known-answer tests.
+    static KeyPair generate_keypair(const Seed& d, const Seed& z);
+
+    // nullopt when the key fails the FIPS 203 encapsulation key check.
+    static std::optional<Encapsulation> encapsulate(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key);
+    // Deterministic ML-KEM.Encaps_internal(ek, m).
+    static std::optional<Encapsulation> encapsulate(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key,
+                                                    const Seed& m);
+
+    // Implicit rejection: a modified ciphertext yields an unrelated secret
+    // rather than an error. nullopt only when the secret key is malformed.
+    static std::optional<SharedSecret> decapsulate(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                   std::span<const uint8_t, CIPHERTEXT_SIZE> ciphertext);
+
+    static const char* backend_name();
+};
+
+} // namespace Crypto
+
+#endif // ML_KEM_H
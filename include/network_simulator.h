@@ -0,0 +1,190 @@
+#ifndef NETWORK_SIMULATOR_H
+#define NETWORK_SIMULATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "flat_hash_map.h"
+#include "transport.h"
+
+namespace Crypto {
+
+// Deterministic discrete-event network simulator, for running the network
+// modules at a scale no test box can host for real. Simulated time only
+// moves when an event runs: run() pops events in time order (a 4-ary heap,
+// ties in scheduling order) and calls them, so a 100k-node mesh runs on one
+// thread with no sockets, and the same seed and the same calls replay the
+// same run. Modules draw randomness from SecureRandom too: in a target
+// built with CRYPTO_SIMULATION, call SecureRandom::seed_deterministic() on
+// the simulating thread for an exact replay.
+//
+// Endpoints stand in for a Transport: each attaches a Transport::Handler,
+// and link() joins two endpoints with a duplex link whose two ends are
+// ConnectionIds, so code written against Transport (MeshNetwork's
+// use_simulator()) sends the same frames here. Each direction of a link
+// follows its LinkModel:
+//   - a frame leaves after the frames queued before it, taking size /
+//     bandwidth to serialise (no limit when bandwidth is 0), and is dropped
+//     when more than queue_limit bytes wait;
+//   - it is lost with probability `loss`;
+//   - otherwise it arrives latency + U(0, jitter) later, never before a
+//     frame sent earlier on the same direction (links do not reorder).
+// close() takes effect at once for the caller; the far end's on_close runs
+// one latency later. Not thread-safe: everything runs on the caller's
+// thread, callbacks included.
+class NetworkSimulator {
+public:
+    using ConnectionId = Transport::ConnectionId;
+    using Endpoint = uint32_t;
+
+    struct LinkModel {
+        double latency = 0.020;                 // seconds, one way
+        double jitter = 0.0;                    // seconds, uniform on top of latency
+        double loss = 0.0;                      // per frame
+        double bandwidth = 0.0;                 // bytes per second; 0: unlimited
+        size_t queue_limit = 4u << 20;          // bytes waiting to be serialised
+    };
+
+    struct Stats {
+        uint64_t events = 0;                    // run so far
+        uint64_t frames_sent = 0;
+        uint64_t frames_delivered = 0;
+        uint64_t frames_lost = 0;               // to `loss`
+        uint64_t frames_dropped = 0;            // queue full or link closed
+        uint64_t bytes_delivered = 0;
+        size_t max_pending = 0;                 // largest event queue seen
+    };
+
+    explicit NetworkSimulator(uint64_t seed = 1);
+
+    NetworkSimulator(const NetworkSimulator&) = delete;
+    NetworkSimulator& operator=(const NetworkSimulator&) = delete;
+
+    // Seconds since the simulation began.
+    double now() const { return static_cast<double>(now_) * 1e-9; }
+
+    // Runs `fn` at now() + delay.
+    void schedule(double delay, std::function<void()> fn);
+    // Runs events until none is left or the next is due after `until`;
+    // returns the number run. The clock ends at `until` when given.
+    size_t run();
+    size_t run_until(double until);
+    size_t pending() const { return heap_.size(); }
+
+    Endpoint attach(Transport::Handler handler);
+    // A duplex link: frames sent on .first arrive at b as .second, and the
+    // reverse. A model per direction, or the same both ways.
+    std::pair<ConnectionId, ConnectionId> link(Endpoint a, Endpoint b, const LinkModel& a_to_b,
+                                               const LinkModel& b_to_a);
+    std::pair<ConnectionId, ConnectionId> link(Endpoint a, Endpoint b, const LinkModel& model) {
+        return link(a, b, model, model);
+    }
+    // Frames are queued on the link as by Transport::send(); false when the
+    // id is unknown or closed, or the link's queue is full.
+    bool send(ConnectionId id, std::span<const uint8_t> frame);
+    bool send(ConnectionId id, std::vector<uint8_t>&& frame);
+    void close(ConnectionId id);
+
+    // The simulation's own generator (loss, jitter), for harnesses that
+    // want their draws in the same replay.
+    std::mt19937_64& rng() { return rng_; }
+    double uniform_real() { return static_cast<double>(rng_() >> 11) * 0x1.0p-53; }
+
+    Stats stats() const { return stats_; }
+
+private:
+    enum class EventKind : uint8_t {
+        Timer,
+        Frame,
+        Close
+    };
+
+    struct Event {
+        uint64_t time;                          // nanoseconds
+        uint64_t seq;
+        uint32_t slot;                          // into timers_, frames_, or the connection
+        EventKind kind;
+    };
+
+    struct Later {
+        bool operator()(const Event& a, const Event& b) const {
+            return a.time != b.time ? a.time > b.time : a.seq > b.seq;
+        }
+    };
+
+    struct Connection {
+        Endpoint owner;
+        ConnectionId peer;
+        LinkModel model;                        // outgoing direction
+        uint64_t busy_until = 0;                // serialiser free from
+        uint64_t last_arrival = 0;
+        bool open = true;
+    };
+
+    struct InFlight {
+        ConnectionId to;
+        std::vector<uint8_t> frame;
+    };
+
+    static uint64_t to_ns(double seconds);
+    void push(uint64_t time, EventKind kind, uint32_t slot);
+    Event pop();
+    Connection* find(ConnectionId id);
+    void dispatch(const Event& event);
+
+    uint64_t now_ = 0;
+    uint64_t seq_ = 0;
+    std::vector<Event> heap_;
+    std::vector<std::function<void()>> timers_;
+    std::vector<uint32_t> free_timers_;
+    std::vector<InFlight> frames_;
+    std::vector<uint32_t> free_frames_;
+    std::vector<Transport::Handler> endpoints_;
+    std::vector<Connection> connections_;       // id - 1
+    std::mt19937_64 rng_;
+    Stats stats_;
+};
+
+// Delivery accounting for a simulated run: record each message when sent
+// and when delivered (by id, at the simulator's clock), then summary()
+// gives throughput and latency percentiles over what arrived. A message
+// delivered several times (a broadcast) counts once per delivery.
+class DeliveryTracker {
+public:
+    struct Summary {
+        uint64_t sent = 0;
+        uint64_t delivered = 0;
+        double span = 0;                        // first send to last delivery, seconds
+        double throughput = 0;                  // deliveries per simulated second
+        double p50 = 0;                         // seconds
+        double p99 = 0;
+        double max = 0;
+    };
+
+    void sent(const std::string& id, double at);
+    // False for an id never sent (or already forgotten).
+    bool delivered(const std::string& id, double at);
+    void forget(const std::string& id);
+    Summary summary();
+    void clear();
+
+private:
+    FlatHashMap<std::string, double> sent_at_;
+    std::vector<double> latencies_;
+    uint64_t sent_ = 0;
+    double first_ = 0;
+    double last_ = 0;
+};
+
+// Heap bytes in use by the process (glibc's allocator statistics), for
+// memory-per-node figures; 0 where that is not available.
+size_t heap_bytes_in_use();
+
+} // namespace Crypto
+
+#endif // NETWORK_SIMULATOR_H
@@ -6,6 +6,9 @@
 #include <vector>
 #include <array>
 #include <cstdint>
+#include <span>
+#include "ml_dsa.h"
+#include "slh_dsa.h"
 
 namespace Crypto {
 
@@ -16,11 +19,29 @@ public:
         std::vector<uint8_t> secret_key;
     };
     
+    struct KyberEncapsulation {
+        std::vector<uint8_t> ciphertext;
+        std::vector<uint8_t> shared_secret;
+    };
+    
+    struct DilithiumKeyPair {
+        std::vector<uint8_t> public_key;
+        std::vector<uint8_t> secret_key;
+    };
+    
     struct DilithiumSignature {
         std::vector<uint8_t> signature;
         uint64_t nonce;
     };
     
+    // One inbound message for dilithium_verify_batch(); `ok` is the result.
+    struct DilithiumVerifyJob {
+        std::span<const uint8_t> message;
+        std::span<const uint8_t> signature;
+        std::span<const uint8_t> public_key;
+        bool ok = false;
+    };
+    
     struct SPHINCSKeyPair {
         std::vector<uint8_t> public_key;
         std::vector<uint8_t> secret_key;
@@ -28,17 +49,35 @@ public:
     
     PostQuantumCrypto();
     KyberKeyPair generate_kyber_keypair();
-    std::vector<uint8_t> kyber_encapsulate(const std::vector<uint8_t>& public_key);
+    // ML-KEM-1024. Both return empty buffers when the key is malformed.
+    KyberEncapsulation kyber_encapsulate(const std::vector<uint8_t>& public_key);
+    std::vector<uint8_t> kyber_decapsulate(const std::vector<uint8_t>& ciphertext,
+                                           const std::vector<uint8_t>& secret_key);
+    // ML-DSA-87. Verification reuses the expanded matrix of signers seen
+    // recently (see MlDsa87::KeyCache).
+    DilithiumKeyPair generate_dilithium_keypair();
     DilithiumSignature dilithium_sign(const std::vector<uint8_t>& message,
                                      const std::vector<uint8_t>& secret_key);
     bool dilithium_verify(const std::vector<uint8_t>& message,
                           const DilithiumSignature& sig,
                           const std::vector<uint8_t>& public_key);
+    // Verifies every job across ThreadPool::shared(), expanding each
+    // distinct uncached key once. Returns the number of valid signatures.
+    size_t dilithium_verify_batch(std::span<DilithiumVerifyJob> jobs);
+    // SLH-DSA-SHAKE-256f, for long-term identity keys. Signing takes tens
+    // of milliseconds; sphincs_sign() returns an empty buffer on a bad key.
     SPHINCSKeyPair generate_sphincs_keypair();
+    std::vector<uint8_t> sphincs_sign(const std::vector<uint8_t>& message,
+                                      const std::vector<uint8_t>& secret_key);
+    bool sphincs_verify(const std::vector<uint8_t>& message,
+                        const std::vector<uint8_t>& signature,
+                        const std::vector<uint8_t>& public_key);
     void print_capabilities();
 
 private:
     static const int MODULE_Q = 3329;
+    
+    MlDsa87::KeyCache dilithium_keys_;
 };
 
 } // namespace Crypto
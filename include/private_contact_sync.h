@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct PrivateContact {
-    std::string contact_id;
+    Id128 contact_id;
     std::string encrypted_name;
     std::string encrypted_phone;
     std::string encrypted_email;
@@ -21,7 +24,7 @@ struct PrivateContact {
 };
 
 struct SyncPackage {
-    std::string package_id;
+    Id128 package_id;
     std::vector<PrivateContact> contacts;
     std::vector<uint8_t> encrypted_payload;
     std::vector<uint8_t> signature;
@@ -30,7 +33,7 @@ struct SyncPackage {
 };
 
 struct ContactDiff {
-    std::string contact_id;
+    Id128 contact_id;
     std::string operation; // "add", "update", "delete"
     std::string encrypted_data;
     uint64_t version;
@@ -44,10 +47,10 @@ public:
     bool initialize();
     
     // Contact management
-    std::string add_contact(const std::string& name, const std::string& phone,
+    Id128 add_contact(const std::string& name, const std::string& phone,
                            const std::string& email, const std::string& public_key);
-    bool update_contact(const std::string& contact_id, const std::string& new_data);
-    bool delete_contact(const std::string& contact_id);
+    bool update_contact(const Id128& contact_id, const std::string& new_data);
+    bool delete_contact(const Id128& contact_id);
     
     // Sync operations
     SyncPackage create_sync_package(uint32_t sync_mode);
@@ -68,13 +71,13 @@ public:
     
 private:
     bool initialized_;
-    std::map<std::string, PrivateContact> contacts_;
+    FlatHashMap<Id128, PrivateContact> contacts_;
     std::vector<SyncPackage> sync_history_;
+    CipherEngine cipher_;
     
-    std::string generate_contact_id();
     std::vector<uint8_t> derive_sync_key(const std::string& user_id);
-    bool verify_contact_signature(const std::string& contact_id, const std::vector<uint8_t>& signature);
-    void update_sync_version(const std::string& contact_id);
+    bool verify_contact_signature(const Id128& contact_id, const std::vector<uint8_t>& signature);
+    void update_sync_version(const Id128& contact_id);
 };
 
 } // namespace Crypto
@@ -0,0 +1,140 @@
+#ifndef RATCHET_SESSION_MANAGER_H
+#define RATCHET_SESSION_MANAGER_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cipher_engine.h"
+#include "double_ratchet.h"
+#include "hmac_sha256.h"
+#include "skipped_key_store.h"
+
+namespace Crypto {
+
+class SessionStore;
+namespace ratchet {
+struct Peek;
+}
+
+// Double Ratchet state for many pairwise sessions on one node (bridge
+// nodes hold ~200k). Sessions are indexed by open-addressing tables
+// sharded by a hash of the peer id, each shard behind its own mutex and on
+// its own cache lines, so threads serving different peers rarely contend. A
+// session is a compact record (keys, precomputed HMAC pads, counters)
+// rather than a DoubleRatchet object; skipped keys go to one bounded
+// SkippedKeyStore per shard.
+//
+// The batch calls group their requests by shard and take each shard lock
+// once, which is how an inbound queue should drive the manager.
+//
+// With a SessionStore attached, sessions survive restarts: unknown peers
+// are loaded from the store on first use, so a restarted node serves
+// traffic at once instead of waiting for every client to re-handshake.
+class RatchetSessionManager {
+public:
+    using MessageKey = DoubleRatchet::MessageKey;
+    using RootKey = std::array<uint8_t, 32>;
+
+    // Passed as message_number: the next key of the chain.
+    static constexpr uint64_t NEXT = UINT64_MAX;
+
+    // shards == 0: a power of two of at least four per hardware thread.
+    // Each shard has its own skipped-key store with these limits.
+    explicit RatchetSessionManager(size_t shards = 0,
+                                   const SkippedKeyStore::Limits& shard_limits = SkippedKeyStore::DEFAULT_LIMITS);
+    ~RatchetSessionManager();
+
+    RatchetSessionManager(const RatchetSessionManager&) = delete;
+    RatchetSessionManager& operator=(const RatchetSessionManager&) = delete;
+
+    // Persist sessions to `store`, which must outlive the manager: a session
+    // is saved when opened and on every DH ratchet step, the counters of
+    // each derived key are logged before the key is returned, and shard
+    // logs that fill up are checkpointed. Call before opening sessions.
+    // False when the store has fewer log segments than there are shards.
+    bool attach_store(SessionStore& store);
+    // Saves every loaded session that changed and syncs the store.
+    void flush();
+
+    // False when a session with this peer already exists (loaded or stored).
+    bool open_session(std::string_view peer_id, const RootKey& root_key, bool initiator);
+    bool close_session(std::string_view peer_id);
+    bool contains(std::string_view peer_id) const;
+    size_t size() const;              // loaded sessions
+    size_t shard_count() const { return shards_.size(); }
+
+    // Same semantics as the DoubleRatchet calls; nullopt for unknown peers.
+    std::optional<MessageKey> derive_message_key(std::string_view peer_id, bool sending);
+    std::optional<MessageKey> derive_message_key_at(std::string_view peer_id, uint64_t message_number);
+    std::optional<MessageKey> derive_message_key_at(std::string_view peer_id,
+                                                    std::span<const uint8_t> ratchet_public_key,
+                                                    uint64_t message_number);
+    // Stores the receiving chain's keys up to the peer's previous chain
+    // length first; false, with no step taken, past max_skip.
+    bool ratchet_forward(std::string_view peer_id, std::span<const uint8_t> dh_output,
+                         std::span<const uint8_t> remote_ratchet_public_key = {},
+                         uint64_t remote_previous_chain_length = 0);
+
+    struct DeriveRequest {
+        std::string_view peer_id;
+        bool sending = false;
+        uint64_t message_number = NEXT;         // receiving only
+        std::optional<MessageKey> key;          // result
+    };
+
+    // One inbound message: the key for (peer, message_number) opens it.
+    struct DecryptJob {
+        std::string_view peer_id;
+        uint64_t message_number = NEXT;
+        CipherEngine::Nonce nonce{};
+        std::span<const uint8_t> aad;
+        std::span<const uint8_t> in;
+        std::span<uint8_t> out;
+        CipherEngine::Tag tag{};
+        bool ok = false;                        // result: authenticated, key used up
+    };
+
+    void derive_batch(std::span<DeriveRequest> requests);
+    // Derives every key shard by shard without moving any chain, opens all
+    // messages with one CipherEngine::open_batch call, then advances the
+    // chains (and the log) for the messages that authenticated only, so a
+    // forged message costs the session nothing. Returns how many
+    // authenticated.
+    size_t decrypt_batch(std::span<DecryptJob> jobs);
+
+private:
+    struct Session;
+    struct Shard;
+
+    size_t shard_of(uint64_t hash) const { return hash >> shard_shift_; }
+    // Loaded session, else the stored one loaded into the shard.
+    Session* resolve(Shard& shard, uint64_t hash, std::string_view peer_id);
+    // Session::derive, with the new counters logged to the store.
+    std::optional<MessageKey> derive_logged(Shard& shard, Session& session, bool sending, uint64_t message_number);
+    void log_counters(Shard& shard, Session& session);
+    // Uses up the key `peek` found, its message having authenticated. False
+    // when something else used it meanwhile (a replay in another batch).
+    bool commit_peek(Shard& shard, Session& session, const SkippedKeyStore::RatchetId& ratchet,
+                     const ratchet::Peek& peek);
+    void checkpoint(Shard& shard);
+    // Indices of `count` items grouped by shard, via a counting sort.
+    template <class PeerOf>
+    std::vector<uint32_t> group_by_shard(size_t count, std::vector<uint64_t>& hashes, PeerOf&& peer_of) const;
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+    int shard_shift_;
+    std::atomic<uint64_t> batches_{0};
+    SessionStore* store_ = nullptr;
+};
+
+} // namespace Crypto
+
+#endif // RATCHET_SESSION_MANAGER_H
@@ -5,13 +5,15 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
 #include <chrono>
 
+#include "flat_hash_map.h"
+#include "id128.h"
+
 namespace Crypto {
 
 struct AuthSession {
-    std::string session_id;
+    Id128 session_id;
     std::string user_id;
     std::string auth_method;
     uint64_t created_at;
@@ -24,7 +26,7 @@ struct AuthSession {
 };
 
 struct MFAMethod {
-    std::string method_id;
+    Id128 method_id;
     std::string method_type; // totp, sms, email, hardware, biometric
     std::string identifier; // phone number, email, device ID
     bool is_verified;
@@ -69,19 +71,19 @@ public:
     AuthenticationResult authenticate_with_mfa(const std::string& username, const std::string& password,
                                              const std::string& mfa_code);
     bool verify_biometric(const std::string& user_id, const std::vector<uint8_t>& biometric_data);
-    bool logout(const std::string& session_id);
+    bool logout(const Id128& session_id);
     
     // MFA management
     std::vector<MFAMethod> get_mfa_methods(const std::string& user_id);
     MFAMethod add_mfa_method(const std::string& user_id, const std::string& method_type, 
                             const std::string& identifier);
-    bool verify_mfa_method(const std::string& method_id, const std::string& code);
-    bool remove_mfa_method(const std::string& method_id);
+    bool verify_mfa_method(const Id128& method_id, const std::string& code);
+    bool remove_mfa_method(const Id128& method_id);
     
     // Sessions
     AuthSession create_session(const std::string& user_id, const std::string& auth_method);
-    bool validate_session(const std::string& session_id);
-    bool revoke_session(const std::string& session_id);
+    bool validate_session(const Id128& session_id);
+    bool revoke_session(const Id128& session_id);
     std::vector<AuthSession> get_active_sessions(const std::string& user_id);
     
     // Password management
@@ -97,7 +99,7 @@ public:
     // Risk-based auth
     uint32_t calculate_risk_score(const std::string& user_id, const std::string& ip_address,
                                  const std::string& device_fingerprint);
-    void trigger_step_up_auth(const std::string& session_id, uint32_t required_level);
+    void trigger_step_up_auth(const Id128& session_id, uint32_t required_level);
     
     void generate_auth_report();
     
@@ -105,15 +107,14 @@ private:
     bool initialized_;
     AuthPolicy auth_policy_;
     
-    std::map<std::string, AuthSession> sessions_;
-    std::map<std::string, std::vector<MFAMethod>> mfa_methods_;
-    std::map<std::string, std::string> passwords_;
+    FlatHashMap<Id128, AuthSession> sessions_;
+    FlatHashMap<std::string, std::vector<MFAMethod>> mfa_methods_;
+    FlatHashMap<std::string, std::string> passwords_;
     
     bool verify_password(const std::string& username, const std::string& password);
     std::string generate_totp(const std::string& secret);
     bool validate_totp(const std::string& secret, const std::string& code);
     std::string hash_password(const std::string& password);
-    std::string generate_session_id();
 };
 
 } // namespace Crypto
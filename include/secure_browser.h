@@ -5,14 +5,17 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct BrowserProfile {
-    std::string profile_id;
+    Id128 profile_id;
     std::string profile_name;
-    std::vector<std::string> bookmarks;
+    std::vector<Id128> bookmarks;
     std::string encryption_key;
     uint64_t created_at;
     uint64_t last_used;
@@ -20,7 +23,7 @@ struct BrowserProfile {
 };
 
 struct SecureBookmark {
-    std::string bookmark_id;
+    Id128 bookmark_id;
     std::string title;
     std::string encrypted_url;
     std::string favicon_hash;
@@ -30,9 +33,9 @@ struct SecureBookmark {
 };
 
 struct BrowserSession {
-    std::string session_id;
-    std::string profile_id;
-    std::vector<std::string> open_tabs;
+    Id128 session_id;
+    Id128 profile_id;
+    std::vector<Id128> open_tabs;
     uint64_t start_time;
     uint64_t duration;
     bool encrypted;
@@ -58,27 +61,27 @@ public:
     
     // Profile management
     BrowserProfile create_profile(const std::string& name);
-    bool switch_profile(const std::string& profile_id);
-    bool delete_profile(const std::string& profile_id);
+    bool switch_profile(const Id128& profile_id);
+    bool delete_profile(const Id128& profile_id);
     
     // Tab management
-    std::string open_secure_tab(const std::string& url, const std::string& profile_id);
-    bool close_tab(const std::string& tab_id);
-    std::vector<std::string> get_open_tabs(const std::string& profile_id);
+    Id128 open_secure_tab(const std::string& url, const Id128& profile_id);
+    bool close_tab(const Id128& tab_id);
+    std::vector<Id128> get_open_tabs(const Id128& profile_id);
     
     // Bookmarks
-    SecureBookmark add_bookmark(const std::string& profile_id, const std::string& title, const std::string& url);
-    bool remove_bookmark(const std::string& bookmark_id);
-    std::vector<SecureBookmark> get_bookmarks(const std::string& profile_id);
+    SecureBookmark add_bookmark(const Id128& profile_id, const std::string& title, const std::string& url);
+    bool remove_bookmark(const Id128& bookmark_id);
+    std::vector<SecureBookmark> get_bookmarks(const Id128& profile_id);
     
     // Privacy
     void configure_privacy(const PrivacySettings& settings);
-    void clear_browsing_data(const std::string& profile_id);
+    void clear_browsing_data(const Id128& profile_id);
     void enable_incognito_mode(bool enable);
     
     // Session
-    BrowserSession start_session(const std::string& profile_id);
-    void end_session(const std::string& session_id);
+    BrowserSession start_session(const Id128& profile_id);
+    void end_session(const Id128& session_id);
     
     // Security
     void enable_fingerprinting_protection(bool enable);
@@ -92,14 +95,13 @@ private:
     bool incognito_mode_;
     PrivacySettings privacy_settings_;
     
-    std::map<std::string, BrowserProfile> profiles_;
-    std::map<std::string, BrowserSession> sessions_;
+    FlatHashMap<Id128, BrowserProfile> profiles_;
+    FlatHashMap<Id128, BrowserSession> sessions_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> generate_browser_key();
     std::vector<uint8_t> encrypt_url(const std::string& url);
     std::string decrypt_url(const std::vector<uint8_t>& encrypted);
-    std::string generate_tab_id();
-    std::string generate_bookmark_id();
 };
 
 } // namespace Crypto
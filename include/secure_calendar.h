@@ -5,13 +5,16 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
 #include <chrono>
 
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+
 namespace Crypto {
 
 struct SecureEvent {
-    std::string event_id;
+    Id128 event_id;
     std::string title;
     std::string description;
     std::vector<uint8_t> encrypted_content;
@@ -27,11 +30,11 @@ struct SecureEvent {
     std::vector<std::string> tags;
     uint64_t created_at;
     uint64_t modified_at;
-    std::string calendar_id;
+    Id128 calendar_id;
 };
 
 struct Calendar {
-    std::string calendar_id;
+    Id128 calendar_id;
     std::string name;
     std::string description;
     std::string owner_id;
@@ -44,8 +47,8 @@ struct Calendar {
 };
 
 struct EventInvitation {
-    std::string invitation_id;
-    std::string event_id;
+    Id128 invitation_id;
+    Id128 event_id;
     std::string sender_id;
     std::string recipient_id;
     std::string status; // pending, accepted, declined, tentative
@@ -70,22 +73,22 @@ public:
     
     // Calendar management
     Calendar create_calendar(const std::string& name, const std::string& owner_id);
-    bool delete_calendar(const std::string& calendar_id);
-    bool share_calendar(const std::string& calendar_id, const std::string& user_id, const std::string& permission);
+    bool delete_calendar(const Id128& calendar_id);
+    bool share_calendar(const Id128& calendar_id, const std::string& user_id, const std::string& permission);
     std::vector<Calendar> list_calendars(const std::string& user_id);
     
     // Event management
-    SecureEvent create_event(const std::string& calendar_id, const std::string& title,
+    SecureEvent create_event(const Id128& calendar_id, const std::string& title,
                             const std::string& description, uint64_t start_time, uint64_t end_time);
-    bool update_event(const std::string& event_id, const SecureEvent& updates);
-    bool delete_event(const std::string& event_id);
-    bool invite_attendee(const std::string& event_id, const std::string& attendee_id);
-    bool respond_to_invitation(const std::string& invitation_id, const std::string& response);
+    bool update_event(const Id128& event_id, const SecureEvent& updates);
+    bool delete_event(const Id128& event_id);
+    bool invite_attendee(const Id128& event_id, const std::string& attendee_id);
+    bool respond_to_invitation(const Id128& invitation_id, const std::string& response);
     
     // Event queries
-    std::vector<SecureEvent> get_events(const std::string& calendar_id, uint64_t start_time, uint64_t end_time);
-    SecureEvent get_event(const std::string& event_id);
-    std::vector<SecureEvent> search_events(const std::string& calendar_id, const std::string& query);
+    std::vector<SecureEvent> get_events(const Id128& calendar_id, uint64_t start_time, uint64_t end_time);
+    SecureEvent get_event(const Id128& event_id);
+    std::vector<SecureEvent> search_events(const Id128& calendar_id, const std::string& query);
     
     // Availability
     std::vector<TimeSlot> find_available_slots(const std::vector<std::string>& attendee_ids,
@@ -93,7 +96,7 @@ public:
     std::vector<TimeSlot> get_busy_times(const std::string& user_id, uint64_t start_time, uint64_t end_time);
     
     // Reminders
-    void set_reminder(const std::string& event_id, uint64_t reminder_time);
+    void set_reminder(const Id128& event_id, uint64_t reminder_time);
     void snooze_reminder(const std::string& reminder_id, uint64_t new_time);
     
     // Security
@@ -109,15 +112,14 @@ private:
     uint32_t retention_days_;
     bool private_events_enabled_;
     
-    std::map<std::string, Calendar> calendars_;
-    std::map<std::string, SecureEvent> events_;
-    std::map<std::string, EventInvitation> invitations_;
+    FlatHashMap<Id128, Calendar> calendars_;
+    FlatHashMap<Id128, SecureEvent> events_;
+    FlatHashMap<Id128, EventInvitation> invitations_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> encrypt_event_data(const std::string& data);
     std::string decrypt_event_data(const std::vector<uint8_t>& encrypted);
-    std::string generate_event_id();
-    std::string generate_calendar_id();
-    bool check_calendar_access(const std::string& calendar_id, const std::string& user_id);
+    bool check_calendar_access(const Id128& calendar_id, const std::string& user_id);
 };
 
 } // namespace Crypto
@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct CloudFile {
-    std::string file_id;
+    Id128 file_id;
     std::string file_name;
     uint64_t file_size;
     std::string mime_type;
@@ -21,7 +24,7 @@ struct CloudFile {
     uint64_t created_at;
     uint64_t modified_at;
     bool is_folder;
-    std::string parent_id;
+    Id128 parent_id;                // nil: top level
 };
 
 struct StorageQuota {
@@ -49,23 +52,23 @@ public:
     CloudFile upload_file(const std::string& owner_id,
                          const std::string& file_name,
                          const std::vector<uint8_t>& content,
-                         const std::string& parent_id = "");
-    std::vector<uint8_t> download_file(const std::string& file_id, 
+                         const Id128& parent_id = {});
+    std::vector<uint8_t> download_file(const Id128& file_id, 
                                         const std::string& requester_id);
-    bool delete_file(const std::string& file_id, const std::string& requester_id);
-    bool move_file(const std::string& file_id, const std::string& new_parent_id);
-    bool copy_file(const std::string& file_id, const std::string& new_parent_id);
+    bool delete_file(const Id128& file_id, const std::string& requester_id);
+    bool move_file(const Id128& file_id, const Id128& new_parent_id);
+    bool copy_file(const Id128& file_id, const Id128& new_parent_id);
     
     // Folder operations
     CloudFile create_folder(const std::string& owner_id,
                            const std::string& folder_name,
-                           const std::string& parent_id = "");
-    std::vector<CloudFile> list_folder(const std::string& folder_id);
+                           const Id128& parent_id = {});
+    std::vector<CloudFile> list_folder(const Id128& folder_id);
     
     // Sharing
-    bool share_file(const std::string& file_id, const SharePermission& permission);
-    bool revoke_access(const std::string& file_id, const std::string& user_id);
-    std::vector<SharePermission> get_shares(const std::string& file_id);
+    bool share_file(const Id128& file_id, const SharePermission& permission);
+    bool revoke_access(const Id128& file_id, const std::string& user_id);
+    std::vector<SharePermission> get_shares(const Id128& file_id);
     
     // Security
     void enable_zero_knowledge(bool enable);
@@ -83,14 +86,14 @@ private:
     bool versioning_enabled_;
     bool backup_encryption_enabled_;
     
-    std::map<std::string, CloudFile> files_;
-    std::map<std::string, std::vector<SharePermission>> shares_;
+    FlatHashMap<Id128, CloudFile> files_;
+    FlatHashMap<Id128, std::vector<SharePermission>> shares_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> generate_file_key();
     std::vector<uint8_t> encrypt_file(const std::vector<uint8_t>& content);
     std::vector<uint8_t> decrypt_file(const std::vector<uint8_t>& encrypted);
-    std::string generate_file_id();
-    bool check_access(const std::string& file_id, const std::string& user_id, const std::string& level);
+    bool check_access(const Id128& file_id, const std::string& user_id, const std::string& level);
 };
 
 } // namespace Crypto
@@ -8,6 +8,9 @@
 #include <functional>
 #include <chrono>
 
+#include "flat_hash_map.h"
+#include "id128.h"
+
 namespace SecureChat {
 
 // Privacy-enhanced secure conference system
@@ -37,7 +40,7 @@ struct Participant {
 };
 
 struct ConferenceRoom {
-    std::string room_id;
+    Crypto::Id128 room_id;
     std::string room_name;
     std::string host_did;
     std::vector<Participant> participants;
@@ -65,49 +68,48 @@ public:
     
     // Room Management
     ConferenceRoom create_room(const std::string& room_name, const std::string& host_did);
-    ConferenceRoom join_room(const std::string& room_id, const std::string& participant_did);
-    void leave_room(const std::string& room_id, const std::string& participant_id);
-    void kick_participant(const std::string& room_id, const std::string& participant_id);
+    ConferenceRoom join_room(const Crypto::Id128& room_id, const std::string& participant_did);
+    void leave_room(const Crypto::Id128& room_id, const std::string& participant_id);
+    void kick_participant(const Crypto::Id128& room_id, const std::string& participant_id);
     
     // Conference Control
-    void mute_participant(const std::string& room_id, const std::string& participant_id);
-    void unmute_participant(const std::string& room_id, const std::string& participant_id);
-    void disable_video(const std::string& room_id, const std::string& participant_id);
-    void enable_video(const std::string& room_id, const std::string& participant_id);
+    void mute_participant(const Crypto::Id128& room_id, const std::string& participant_id);
+    void unmute_participant(const Crypto::Id128& room_id, const std::string& participant_id);
+    void disable_video(const Crypto::Id128& room_id, const std::string& participant_id);
+    void enable_video(const Crypto::Id128& room_id, const std::string& participant_id);
     
     // Media Streaming
-    ConferenceMedia send_video_frame(const std::string& room_id, const std::vector<uint8_t>& frame);
-    ConferenceMedia send_audio_frame(const std::string& room_id, const std::vector<uint8_t>& frame);
-    ConferenceMedia send_screen_share(const std::string& room_id, const std::vector<uint8_t>& screen_data);
+    ConferenceMedia send_video_frame(const Crypto::Id128& room_id, const std::vector<uint8_t>& frame);
+    ConferenceMedia send_audio_frame(const Crypto::Id128& room_id, const std::vector<uint8_t>& frame);
+    ConferenceMedia send_screen_share(const Crypto::Id128& room_id, const std::vector<uint8_t>& screen_data);
     
     // Privacy Features
-    void enable_privacy_mode(const std::string& room_id);
-    void enable_attendance_verification(const std::string& room_id);
-    void enable_zero_knowledge_attendance(const std::string& room_id);
-    void apply_privacy_filters(const std::string& room_id, const std::string& filter_type);
+    void enable_privacy_mode(const Crypto::Id128& room_id);
+    void enable_attendance_verification(const Crypto::Id128& room_id);
+    void enable_zero_knowledge_attendance(const Crypto::Id128& room_id);
+    void apply_privacy_filters(const Crypto::Id128& room_id, const std::string& filter_type);
     
     // Recording
-    void start_recording(const std::string& room_id);
-    void stop_recording(const std::string& room_id);
-    std::vector<uint8_t> get_encrypted_recording(const std::string& room_id);
+    void start_recording(const Crypto::Id128& room_id);
+    void stop_recording(const Crypto::Id128& room_id);
+    std::vector<uint8_t> get_encrypted_recording(const Crypto::Id128& room_id);
     
     // Security
-    void verify_participant_identity(const std::string& room_id, const std::string& participant_id);
-    void enable_end_to_end_encryption(const std::string& room_id);
-    void rotate_encryption_keys(const std::string& room_id);
+    void verify_participant_identity(const Crypto::Id128& room_id, const std::string& participant_id);
+    void enable_end_to_end_encryption(const Crypto::Id128& room_id);
+    void rotate_encryption_keys(const Crypto::Id128& room_id);
     
     // Spatial Audio
-    void enable_spatial_audio(const std::string& room_id);
-    void set_participant_position(const std::string& room_id, const std::string& participant_id, 
+    void enable_spatial_audio(const Crypto::Id128& room_id);
+    void set_participant_position(const Crypto::Id128& room_id, const std::string& participant_id, 
                                   float x, float y, float z);
 
 private:
     bool initialized_;
     ConferenceConfig config_;
-    std::map<std::string, ConferenceRoom> rooms_;
-    std::map<std::string, std::vector<ConferenceMedia>> recordings_;
+    Crypto::FlatHashMap<Crypto::Id128, ConferenceRoom> rooms_;
+    Crypto::FlatHashMap<Crypto::Id128, std::vector<ConferenceMedia>> recordings_;
     
-    std::string generate_room_id();
     ConferenceMedia encrypt_media(const std::vector<uint8_t>& data);
     std::vector<uint8_t> generate_media_key();
 };
@@ -5,12 +5,14 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct Wallet {
-    std::string wallet_id;
+    Id128 wallet_id;
     std::string wallet_type; // hot, cold, hardware
     std::string public_address;
     std::vector<uint8_t> encrypted_private_key;
@@ -22,7 +24,7 @@ struct Wallet {
 };
 
 struct Transaction {
-    std::string tx_id;
+    Id128 tx_id;
     std::string from_address;
     std::string to_address;
     double amount;
@@ -42,7 +44,7 @@ struct CoinBalance {
 };
 
 struct MultisigConfig {
-    std::string config_id;
+    Id128 config_id;
     uint32_t required_signers;
     uint32_t total_signers;
     std::vector<std::string> signer_addresses;
@@ -59,30 +61,30 @@ public:
     // Wallet management
     Wallet create_wallet(const std::string& coin_type, bool is_cold_storage);
     bool import_wallet(const std::string& private_key, const std::string& coin_type);
-    bool export_wallet(const std::string& wallet_id);
-    bool delete_wallet(const std::string& wallet_id);
+    bool export_wallet(const Id128& wallet_id);
+    bool delete_wallet(const Id128& wallet_id);
     std::vector<Wallet> list_wallets();
     
     // Transaction management
-    Transaction create_transaction(const std::string& from_wallet, const std::string& to_address,
+    Transaction create_transaction(const Id128& from_wallet, const std::string& to_address,
                                 double amount, const std::string& coin_type);
-    bool sign_transaction(const std::string& tx_id, const std::string& wallet_id);
-    bool broadcast_transaction(const std::string& tx_id);
-    std::vector<Transaction> get_transaction_history(const std::string& wallet_id);
+    bool sign_transaction(const Id128& tx_id, const Id128& wallet_id);
+    bool broadcast_transaction(const Id128& tx_id);
+    std::vector<Transaction> get_transaction_history(const Id128& wallet_id);
     
     // Address management
-    std::string generate_new_address(const std::string& wallet_id);
-    std::vector<std::string> get_addresses(const std::string& wallet_id);
+    std::string generate_new_address(const Id128& wallet_id);
+    std::vector<std::string> get_addresses(const Id128& wallet_id);
     bool validate_address(const std::string& address, const std::string& coin_type);
     
     // Balance
-    CoinBalance get_balance(const std::string& wallet_id, const std::string& coin_type);
-    std::vector<CoinBalance> get_all_balances(const std::string& wallet_id);
+    CoinBalance get_balance(const Id128& wallet_id, const std::string& coin_type);
+    std::vector<CoinBalance> get_all_balances(const Id128& wallet_id);
     
     // Multisig
     MultisigConfig create_multisig_wallet(uint32_t required, uint32_t total,
                                           const std::vector<std::string>& signers);
-    bool add_multisig_signer(const std::string& config_id, const std::string& signer_address);
+    bool add_multisig_signer(const Id128& config_id, const std::string& signer_address);
     
     // Security
     void enable_cold_storage(bool enable);
@@ -99,15 +101,14 @@ private:
     uint64_t transaction_fee_;
     std::string privacy_level_;
     
-    std::map<std::string, Wallet> wallets_;
-    std::map<std::string, Transaction> transactions_;
-    std::map<std::string, MultisigConfig> multisig_configs_;
+    FlatHashMap<Id128, Wallet> wallets_;
+    FlatHashMap<Id128, Transaction> transactions_;
+    FlatHashMap<Id128, MultisigConfig> multisig_configs_;
     
     std::vector<uint8_t> generate_private_key();
     std::string derive_public_address(const std::vector<uint8_t>& private_key);
     std::vector<uint8_t> sign_data(const std::vector<uint8_t>& data, const std::vector<uint8_t>& private_key);
     bool verify_signature(const std::vector<uint8_t>& data, const std::vector<uint8_t>& signature, const std::string& address);
-    std::string generate_wallet_id();
 };
 
 } // namespace Crypto
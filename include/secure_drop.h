@@ -6,6 +6,8 @@
 #include <vector>
 #include <cstdint>
 
+#include "cipher_engine.h"
+
 namespace Crypto {
 
 struct DropConfig {
@@ -49,6 +51,7 @@ private:
     bool initialized_;
     DropConfig config_;
     std::vector<DropFile> stored_files_;
+    CipherEngine cipher_;
     
     std::string generate_file_id();
     uint64_t calculate_expiration();
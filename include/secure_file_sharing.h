@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct SharedFile {
-    std::string file_id;
+    Id128 file_id;
     std::string file_name;
     uint64_t file_size;
     std::string mime_type;
@@ -29,8 +32,8 @@ struct SharedFile {
 };
 
 struct FileShareLink {
-    std::string link_id;
-    std::string file_id;
+    Id128 link_id;
+    Id128 file_id;
     std::string share_token;
     std::string short_url;
     uint64_t created_at;
@@ -44,8 +47,8 @@ struct FileShareLink {
 };
 
 struct FileAccessEvent {
-    std::string event_id;
-    std::string file_id;
+    Id128 event_id;
+    Id128 file_id;
     std::string user_id;
     std::string action; // view, download, upload, delete
     std::string ip_address;
@@ -64,24 +67,24 @@ public:
     // File operations
     SharedFile upload_file(const std::string& owner_id, const std::string& file_name,
                          const std::vector<uint8_t>& content, const std::string& mime_type);
-    std::vector<uint8_t> download_file(const std::string& file_id, const std::string& requester_id);
-    bool delete_file(const std::string& file_id, const std::string& requester_id);
-    bool update_file(const std::string& file_id, const std::vector<uint8_t>& new_content);
+    std::vector<uint8_t> download_file(const Id128& file_id, const std::string& requester_id);
+    bool delete_file(const Id128& file_id, const std::string& requester_id);
+    bool update_file(const Id128& file_id, const std::vector<uint8_t>& new_content);
     
     // Sharing
-    FileShareLink create_share_link(const std::string& file_id, const std::string& owner_id,
+    FileShareLink create_share_link(const Id128& file_id, const std::string& owner_id,
                                    uint32_t max_access_count, uint64_t expiration_hours);
-    bool share_with_users(const std::string& file_id, const std::string& owner_id,
+    bool share_with_users(const Id128& file_id, const std::string& owner_id,
                         const std::vector<std::string>& user_ids, const std::string& access_level);
-    bool share_with_emails(const std::string& file_id, const std::string& owner_id,
+    bool share_with_emails(const Id128& file_id, const std::string& owner_id,
                          const std::vector<std::string>& emails);
-    bool revoke_access(const std::string& file_id, const std::string& owner_id, const std::string& user_id);
+    bool revoke_access(const Id128& file_id, const std::string& owner_id, const std::string& user_id);
     
     // Link management
-    bool validate_share_link(const std::string& link_id, const std::string& password);
-    std::vector<uint8_t> download_via_link(const std::string& link_id, const std::string& password);
-    bool deactivate_link(const std::string& link_id);
-    std::vector<FileShareLink> get_active_links(const std::string& file_id);
+    bool validate_share_link(const Id128& link_id, const std::string& password);
+    std::vector<uint8_t> download_via_link(const Id128& link_id, const std::string& password);
+    bool deactivate_link(const Id128& link_id);
+    std::vector<FileShareLink> get_active_links(const Id128& file_id);
     
     // Security
     void enable_expiration(bool enable);
@@ -90,12 +93,12 @@ public:
     void enable_audit_logging(bool enable);
     
     // Access tracking
-    std::vector<FileAccessEvent> get_access_log(const std::string& file_id);
+    std::vector<FileAccessEvent> get_access_log(const Id128& file_id);
     std::vector<FileAccessEvent> get_user_activity(const std::string& user_id);
     
     // Preview
     std::vector<std::string> get_supported_preview_types();
-    std::vector<uint8_t> generate_preview(const std::string& file_id);
+    std::vector<uint8_t> generate_preview(const Id128& file_id);
     
     void generate_sharing_report();
     
@@ -106,16 +109,16 @@ private:
     bool audit_logging_enabled_;
     uint64_t max_file_size_mb_;
     
-    std::map<std::string, SharedFile> files_;
-    std::map<std::string, FileShareLink> links_;
-    std::map<std::string, std::vector<FileAccessEvent>> access_logs_;
+    FlatHashMap<Id128, SharedFile> files_;
+    FlatHashMap<Id128, FileShareLink> links_;
+    FlatHashMap<Id128, std::vector<FileAccessEvent>> access_logs_;
+    CipherEngine cipher_;
     
-    std::string generate_file_id();
     std::string generate_share_token();
     std::vector<uint8_t> encrypt_file(const std::vector<uint8_t>& content);
     std::vector<uint8_t> decrypt_file(const std::vector<uint8_t>& encrypted);
     bool validate_file_scan(const std::vector<uint8_t>& content);
-    void log_access(const std::string& file_id, const std::string& user_id, const std::string& action);
+    void log_access(const Id128& file_id, const std::string& user_id, const std::string& action);
 };
 
 } // namespace Crypto
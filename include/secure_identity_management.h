@@ -5,12 +5,14 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct Identity {
-    std::string identity_id;
+    Id128 identity_id;
     std::string display_name;
     std::string public_key;
     std::vector<uint8_t> encrypted_private_key;
@@ -26,7 +28,7 @@ struct Identity {
 };
 
 struct VerifiableCredential {
-    std::string vc_id;
+    Id128 vc_id;
     std::string issuer_id;
     std::string subject_id;
     std::string credential_type;
@@ -58,9 +60,9 @@ public:
     
     // Identity management
     Identity create_identity(const std::string& display_name, const std::string& identity_type);
-    bool update_identity(const std::string& identity_id, const Identity& updates);
-    bool revoke_identity(const std::string& identity_id, const std::string& reason);
-    Identity get_identity(const std::string& identity_id);
+    bool update_identity(const Id128& identity_id, const Identity& updates);
+    bool revoke_identity(const Id128& identity_id, const std::string& reason);
+    Identity get_identity(const Id128& identity_id);
     std::vector<Identity> list_identities();
     
     // Decentralized identifiers
@@ -72,11 +74,11 @@ public:
     VerifiableCredential issue_credential(const std::string& issuer_id, const std::string& subject_id,
                                         const std::vector<std::string>& claims);
     bool verify_credential(const VerifiableCredential& vc);
-    bool revoke_credential(const std::string& vc_id, const std::string& reason);
+    bool revoke_credential(const Id128& vc_id, const std::string& reason);
     
     // Claims
-    bool add_claim(const std::string& identity_id, const std::string& claim);
-    bool verify_claim(const std::string& identity_id, const std::string& claim);
+    bool add_claim(const Id128& identity_id, const std::string& claim);
+    bool verify_claim(const Id128& identity_id, const std::string& claim);
     
     // Privacy
     void enable_selective_disclosure(bool enable);
@@ -90,11 +92,10 @@ private:
     bool selective_disclosure_enabled_;
     bool zk_proofs_enabled_;
     
-    std::map<std::string, Identity> identities_;
-    std::map<std::string, VerifiableCredential> credentials_;
-    std::map<std::string, DecentralizedIdentifier> dids_;
+    FlatHashMap<Id128, Identity> identities_;
+    FlatHashMap<Id128, VerifiableCredential> credentials_;
+    FlatHashMap<std::string, DecentralizedIdentifier> dids_;
     
-    std::string generate_identity_id();
     std::string generate_did_id(const std::string& method);
     std::vector<uint8_t> sign_credential(const VerifiableCredential& vc, const std::vector<uint8_t>& private_key);
     bool verify_credential_signature(const VerifiableCredential& vc);
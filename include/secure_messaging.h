@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 
+#include "cipher_engine.h"
+#include "id128.h"
+
 namespace Crypto {
 
 class SecureMessaging {
 public:
     struct Message {
-        std::string message_id;
+        Id128 message_id;
         std::string sender;
         std::string recipient;
         std::string encrypted_content;
@@ -26,6 +29,7 @@ public:
 
 private:
     std::vector<Message> message_history;
+    CipherEngine cipher;
 };
 
 } // namespace Crypto
@@ -5,12 +5,15 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct MessageV2 {
-    std::string message_id;
+    Id128 message_id;
     std::string sender_id;
     std::string recipient_id;
     std::vector<uint8_t> encrypted_content;
@@ -23,7 +26,7 @@ struct MessageV2 {
 };
 
 struct Conversation {
-    std::string conversation_id;
+    Id128 conversation_id;
     std::vector<std::string> participants;
     std::vector<MessageV2> messages;
     uint64_t created_at;
@@ -33,7 +36,7 @@ struct Conversation {
 };
 
 struct DeliveryReceipt {
-    std::string message_id;
+    Id128 message_id;
     std::string recipient_id;
     std::string status;
     uint64_t delivered_at;
@@ -49,18 +52,22 @@ public:
     
     // Conversation management
     Conversation create_conversation(const std::vector<std::string>& participants);
-    bool add_participant(const std::string& conversation_id, const std::string& participant_id);
-    bool remove_participant(const std::string& conversation_id, const std::string& participant_id);
+    bool add_participant(const Id128& conversation_id, const std::string& participant_id);
+    bool remove_participant(const Id128& conversation_id, const std::string& participant_id);
     
     // Message operations
-    MessageV2 send_message(const std::string& conversation_id,
+    MessageV2 send_message(const Id128& conversation_id,
                           const std::string& sender_id,
                           const std::string& content,
                           bool ephemeral = false,
                           uint64_t ttl_seconds = 0);
-    std::vector<MessageV2> receive_messages(const std::string& conversation_id,
+    // Encrypts the whole batch in one multi-buffer AEAD call
+    std::vector<MessageV2> send_messages(const Id128& conversation_id,
+                                         const std::string& sender_id,
+                                         const std::vector<std::string>& contents);
+    std::vector<MessageV2> receive_messages(const Id128& conversation_id,
                                            const std::string& recipient_id);
-    bool acknowledge_delivery(const std::string& message_id, const std::string& recipient_id);
+    bool acknowledge_delivery(const Id128& message_id, const std::string& recipient_id);
     
     // Security features
     void enable_forward_secrecy(bool enable);
@@ -69,10 +76,10 @@ public:
     void enable_screen_recording_protection(bool enable);
     
     // Group messaging
-    MessageV2 create_group_message(const std::string& conversation_id,
+    MessageV2 create_group_message(const Id128& conversation_id,
                                    const std::string& sender_id,
                                    const std::string& content);
-    bool rotate_group_key(const std::string& conversation_id);
+    bool rotate_group_key(const Id128& conversation_id);
     
     void generate_messaging_report();
     
@@ -83,13 +90,14 @@ private:
     bool screenshot_detection_enabled_;
     bool screen_recording_protection_enabled_;
     
-    std::map<std::string, Conversation> conversations_;
-    std::map<std::string, DeliveryReceipt> receipts_;
+    FlatHashMap<Id128, Conversation> conversations_;
+    FlatHashMap<Id128, DeliveryReceipt> receipts_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> generate_message_key();
     std::vector<uint8_t> encrypt_message(const std::string& content);
+    std::vector<std::vector<uint8_t>> encrypt_messages(const std::vector<std::string>& contents);
     std::string decrypt_message(const std::vector<uint8_t>& encrypted);
-    std::string generate_message_id();
 };
 
 } // namespace Crypto
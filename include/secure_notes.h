@@ -5,16 +5,19 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct SecureNote {
-    std::string note_id;
+    Id128 note_id;
     std::string title;
     std::vector<uint8_t> encrypted_content;
     std::string content_hash;
-    std::string notebook_id;
+    Id128 notebook_id;
     uint64_t created_at;
     uint64_t modified_at;
     std::vector<std::string> tags;
@@ -23,18 +26,18 @@ struct SecureNote {
 };
 
 struct Notebook {
-    std::string notebook_id;
+    Id128 notebook_id;
     std::string name;
     std::string encryption_key;
-    std::vector<std::string> notes;
+    std::vector<Id128> notes;
     uint64_t created_at;
     uint64_t modified_at;
     bool is_encrypted;
 };
 
 struct NoteSharing {
-    std::string share_id;
-    std::string note_id;
+    Id128 share_id;
+    Id128 note_id;
     std::string shared_with;
     std::string permission; // "view", "edit"
     uint64_t expires_at;
@@ -42,7 +45,7 @@ struct NoteSharing {
 };
 
 struct SearchResult {
-    std::string note_id;
+    Id128 note_id;
     std::string title;
     std::string snippet;
     double relevance_score;
@@ -58,27 +61,27 @@ public:
     
     // Notebook management
     Notebook create_notebook(const std::string& name);
-    bool delete_notebook(const std::string& notebook_id);
+    bool delete_notebook(const Id128& notebook_id);
     std::vector<Notebook> list_notebooks();
     
     // Note management
-    SecureNote create_note(const std::string& notebook_id, const std::string& title, const std::string& content);
-    bool update_note(const std::string& note_id, const std::string& new_content);
-    bool delete_note(const std::string& note_id);
-    SecureNote get_note(const std::string& note_id);
+    SecureNote create_note(const Id128& notebook_id, const std::string& title, const std::string& content);
+    bool update_note(const Id128& note_id, const std::string& new_content);
+    bool delete_note(const Id128& note_id);
+    SecureNote get_note(const Id128& note_id);
     
     // Tags
-    bool add_tag(const std::string& note_id, const std::string& tag);
-    bool remove_tag(const std::string& note_id, const std::string& tag);
+    bool add_tag(const Id128& note_id, const std::string& tag);
+    bool remove_tag(const Id128& note_id, const std::string& tag);
     std::vector<SecureNote> get_notes_by_tag(const std::string& tag);
     
     // Search
     std::vector<SearchResult> search_notes(const std::string& query);
     
     // Sharing
-    NoteSharing share_note(const std::string& note_id, const std::string& recipient_id, 
+    NoteSharing share_note(const Id128& note_id, const std::string& recipient_id, 
                           const std::string& permission, uint64_t expires_at);
-    bool revoke_share(const std::string& share_id);
+    bool revoke_share(const Id128& share_id);
     
     // Security
     void enable_end_to_end_encryption(bool enable);
@@ -93,15 +96,14 @@ private:
     uint32_t auto_lock_timeout_;
     bool biometric_enabled_;
     
-    std::map<std::string, Notebook> notebooks_;
-    std::map<std::string, SecureNote> notes_;
-    std::map<std::string, NoteSharing> shares_;
+    FlatHashMap<Id128, Notebook> notebooks_;
+    FlatHashMap<Id128, SecureNote> notes_;
+    FlatHashMap<Id128, NoteSharing> shares_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> generate_note_key();
     std::vector<uint8_t> encrypt_content(const std::string& content);
     std::string decrypt_content(const std::vector<uint8_t>& encrypted);
-    std::string generate_note_id();
-    std::string generate_notebook_id();
     std::string calculate_content_hash(const std::string& content);
 };
 
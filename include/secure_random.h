@@ -0,0 +1,65 @@
+#ifndef SECURE_RANDOM_H
+#define SECURE_RANDOM_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace Crypto {
+
+// Randomness for keys, nonces, salts and identifiers. Each thread runs its
+// own ChaCha20 DRBG (no locking), seeded from the kernel (getrandom on
+// Linux, std::random_device elsewhere) and reseeded every RESEED_INTERVAL
+// bytes. Output is produced 1 KiB at a time with fast key erasure: the
+// first 32 bytes of each keystream batch become the next key, and bytes
+// are wiped from the buffer as they are handed out, so a later memory
+// disclosure does not reveal earlier output. A child process reseeds
+// before its first draw instead of repeating its parent's stream.
+class SecureRandom {
+public:
+    static constexpr uint64_t RESEED_INTERVAL = 1 << 20;    // bytes per thread
+
+    static void fill(std::span<uint8_t> out);
+
+    template <size_t N>
+    static std::array<uint8_t, N> bytes() {
+        std::array<uint8_t, N> out;
+        fill(out);
+        return out;
+    }
+
+    static uint32_t next_u32();
+    static uint64_t next_u64();
+    // Uniform in [0, bound), without modulo bias; bound must be non-zero.
+    static uint64_t uniform(uint64_t bound);
+    // Uniform in [0, 1), 53 random bits.
+    static double uniform_real();
+
+    // Mixes fresh kernel entropy into this thread's generator now, e.g.
+    // after a VM snapshot is restored.
+    static void reseed();
+
+#if defined(CRYPTO_SIMULATION)
+    // Rekeys this thread's generator from `seed` alone and stops its
+    // reseeding, so the same sequence of calls returns the same values run
+    // after run: for simulations that must replay exactly, never for keys.
+    // reseed() puts the thread back on kernel entropy. Only targets built
+    // with CRYPTO_SIMULATION (the simulator benches) have it.
+    static void seed_deterministic(uint64_t seed);
+#endif
+
+    // UniformRandomBitGenerator over the calling thread's DRBG, for the
+    // <random> distributions and std::shuffle.
+    struct Engine {
+        using result_type = uint64_t;
+        static constexpr result_type min() { return 0; }
+        static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+        result_type operator()() { return next_u64(); }
+    };
+};
+
+} // namespace Crypto
+
+#endif // SECURE_RANDOM_H
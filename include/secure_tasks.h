@@ -8,10 +8,14 @@
 #include <map>
 #include <chrono>
 
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+
 namespace Crypto {
 
 struct SecureTask {
-    std::string task_id;
+    Id128 task_id;
     std::string title;
     std::string description;
     std::vector<uint8_t> encrypted_content;
@@ -23,7 +27,7 @@ struct SecureTask {
     std::string priority; // low, medium, high, urgent
     std::string category;
     std::vector<std::string> tags;
-    std::string project_id;
+    Id128 project_id;
     std::string assignee_id;
     std::string creator_id;
     std::vector<std::string> checklist;
@@ -35,12 +39,12 @@ struct SecureTask {
 };
 
 struct Project {
-    std::string project_id;
+    Id128 project_id;
     std::string name;
     std::string description;
     std::string owner_id;
     std::vector<std::string> members;
-    std::vector<std::string> task_ids;
+    std::vector<Id128> task_ids;
     uint64_t created_at;
     uint64_t deadline;
     std::string status; // active, completed, archived
@@ -48,7 +52,7 @@ struct Project {
 };
 
 struct TaskTemplate {
-    std::string template_id;
+    Id128 template_id;
     std::string name;
     std::string description;
     std::vector<std::string> default_tags;
@@ -66,33 +70,33 @@ public:
     
     // Task management
     SecureTask create_task(const std::string& title, const std::string& creator_id);
-    bool update_task(const std::string& task_id, const SecureTask& updates);
-    bool delete_task(const std::string& task_id);
-    bool complete_task(const std::string& task_id);
+    bool update_task(const Id128& task_id, const SecureTask& updates);
+    bool delete_task(const Id128& task_id);
+    bool complete_task(const Id128& task_id);
     
     // Task queries
     std::vector<SecureTask> get_tasks(const std::string& user_id, const std::string& status);
     std::vector<SecureTask> get_overdue_tasks(const std::string& user_id);
     std::vector<SecureTask> search_tasks(const std::string& query, const std::string& user_id);
-    SecureTask get_task(const std::string& task_id);
+    SecureTask get_task(const Id128& task_id);
     
     // Task operations
-    bool assign_task(const std::string& task_id, const std::string& assignee_id);
-    bool set_due_date(const std::string& task_id, uint64_t due_date);
-    bool set_priority(const std::string& task_id, const std::string& priority);
-    bool add_comment(const std::string& task_id, const std::string& comment);
-    bool add_checklist_item(const std::string& task_id, const std::string& item);
-    bool toggle_checklist_item(const std::string& task_id, const std::string& item);
+    bool assign_task(const Id128& task_id, const std::string& assignee_id);
+    bool set_due_date(const Id128& task_id, uint64_t due_date);
+    bool set_priority(const Id128& task_id, const std::string& priority);
+    bool add_comment(const Id128& task_id, const std::string& comment);
+    bool add_checklist_item(const Id128& task_id, const std::string& item);
+    bool toggle_checklist_item(const Id128& task_id, const std::string& item);
     
     // Project management
     Project create_project(const std::string& name, const std::string& owner_id);
-    bool delete_project(const std::string& project_id);
-    bool add_task_to_project(const std::string& task_id, const std::string& project_id);
+    bool delete_project(const Id128& project_id);
+    bool add_task_to_project(const Id128& task_id, const Id128& project_id);
     std::vector<Project> get_projects(const std::string& user_id);
     
     // Templates
     TaskTemplate create_template(const std::string& name);
-    SecureTask create_task_from_template(const std::string& template_id, const std::string& creator_id);
+    SecureTask create_task_from_template(const Id128& template_id, const std::string& creator_id);
     
     // Statistics
     std::map<std::string, uint32_t> get_task_statistics(const std::string& user_id);
@@ -112,15 +116,13 @@ private:
     uint32_t retention_days_;
     bool task_privacy_enabled_;
     
-    std::map<std::string, SecureTask> tasks_;
-    std::map<std::string, Project> projects_;
-    std::map<std::string, TaskTemplate> templates_;
+    FlatHashMap<Id128, SecureTask> tasks_;
+    FlatHashMap<Id128, Project> projects_;
+    FlatHashMap<Id128, TaskTemplate> templates_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> encrypt_task_data(const std::string& data);
     std::string decrypt_task_data(const std::vector<uint8_t>& encrypted);
-    std::string generate_task_id();
-    std::string generate_project_id();
-    std::string generate_template_id();
 };
 
 } // namespace Crypto
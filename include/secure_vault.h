@@ -5,17 +5,20 @@
 #include <string>
 #include <vector>
 #include <cstdint>
-#include <map>
+
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
 struct VaultItem {
-    std::string item_id;
+    Id128 item_id;
     std::string item_type; // "password", "note", "card", "identity"
     std::string title;
     std::vector<uint8_t> encrypted_data;
     std::string data_hash;
-    std::string vault_id;
+    Id128 vault_id;
     uint64_t created_at;
     uint64_t modified_at;
     std::vector<std::string> tags;
@@ -23,7 +26,7 @@ struct VaultItem {
 };
 
 struct Vault {
-    std::string vault_id;
+    Id128 vault_id;
     std::string name;
     std::vector<uint8_t> master_key_encrypted;
     uint64_t created_at;
@@ -32,7 +35,7 @@ struct Vault {
 };
 
 struct PasswordItem {
-    std::string item_id;
+    Id128 item_id;
     std::string title;
     std::string username;
     std::string password_encrypted;
@@ -44,7 +47,7 @@ struct PasswordItem {
 };
 
 struct CreditCardItem {
-    std::string item_id;
+    Id128 item_id;
     std::string cardholder_name;
     std::string number_encrypted;
     std::string cvv_encrypted;
@@ -62,20 +65,20 @@ public:
     
     // Vault management
     Vault create_vault(const std::string& name, const std::string& master_password);
-    bool unlock_vault(const std::string& vault_id, const std::string& master_password);
-    bool lock_vault(const std::string& vault_id);
-    bool delete_vault(const std::string& vault_id);
+    bool unlock_vault(const Id128& vault_id, const std::string& master_password);
+    bool lock_vault(const Id128& vault_id);
+    bool delete_vault(const Id128& vault_id);
     
     // Password items
-    PasswordItem add_password(const std::string& vault_id, const std::string& title,
+    PasswordItem add_password(const Id128& vault_id, const std::string& title,
                              const std::string& username, const std::string& password,
                              const std::string& website_url = "");
-    bool update_password(const std::string& item_id, const std::string& new_password);
-    bool delete_password(const std::string& item_id);
-    PasswordItem get_password(const std::string& item_id);
+    bool update_password(const Id128& item_id, const std::string& new_password);
+    bool delete_password(const Id128& item_id);
+    PasswordItem get_password(const Id128& item_id);
     
     // Credit card items
-    CreditCardItem add_credit_card(const std::string& vault_id, const std::string& cardholder_name,
+    CreditCardItem add_credit_card(const Id128& vault_id, const std::string& cardholder_name,
                                    const std::string& number, const std::string& cvv,
                                    const std::string& expiry_date);
     
@@ -88,7 +91,7 @@ public:
     
     // Import/Export
     std::vector<VaultItem> import_data(const std::string& format, const std::vector<uint8_t>& data);
-    std::vector<uint8_t> export_data(const std::string& vault_id, const std::string& format);
+    std::vector<uint8_t> export_data(const Id128& vault_id, const std::string& format);
     
     void generate_vault_report();
     
@@ -98,13 +101,13 @@ private:
     uint32_t auto_lock_timeout_;
     bool biometric_enabled_;
     
-    std::map<std::string, Vault> vaults_;
-    std::map<std::string, VaultItem> items_;
+    FlatHashMap<Id128, Vault> vaults_;
+    FlatHashMap<Id128, VaultItem> items_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> derive_master_key(const std::string& password, const std::string& salt);
     std::vector<uint8_t> encrypt_data(const std::vector<uint8_t>& data, const std::vector<uint8_t>& key);
     std::vector<uint8_t> decrypt_data(const std::vector<uint8_t>& encrypted, const std::vector<uint8_t>& key);
-    std::string generate_item_id();
     uint32_t calculate_entropy(const std::string& password);
     bool validate_luhn_check(const std::string& number);
 };
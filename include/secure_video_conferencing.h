@@ -6,6 +6,8 @@
 #include <vector>
 #include <cstdint>
 
+#include "cipher_engine.h"
+
 namespace Crypto {
 
 struct VideoConference {
@@ -63,6 +65,7 @@ private:
     bool e2e_encryption_;
     bool screen_sharing_;
     std::vector<VideoConference> active_conferences_;
+    CipherEngine cipher_;
     
     std::string generate_conference_id();
     std::vector<uint8_t> encrypt_frame(const std::vector<uint8_t>& frame);
@@ -6,10 +6,14 @@
 #include <vector>
 #include <cstdint>
 
+#include "cipher_engine.h"
+#include "flat_hash_map.h"
+#include "id128.h"
+
 namespace Crypto {
 
 struct MediaSession {
-    std::string session_id;
+    Id128 session_id;
     std::string caller_id;
     std::string callee_id;
     std::string media_type; // "audio", "video", "screen"
@@ -59,10 +63,10 @@ public:
     // Call management
     MediaSession initiate_call(const std::string& caller_id, const std::string& callee_id,
                                const std::string& media_type);
-    MediaSession answer_call(const std::string& session_id);
-    bool end_call(const std::string& session_id);
-    bool hold_call(const std::string& session_id);
-    bool resume_call(const std::string& session_id);
+    MediaSession answer_call(const Id128& session_id);
+    bool end_call(const Id128& session_id);
+    bool hold_call(const Id128& session_id);
+    bool resume_call(const Id128& session_id);
     
     // Audio/video
     AudioFrame capture_audio();
@@ -72,8 +76,8 @@ public:
     void decode_video_frame(VideoFrame& frame);
     
     // Quality
-    CallQuality get_call_quality(const std::string& session_id);
-    void adapt_bitrate(const std::string& session_id, uint32_t target_bitrate);
+    CallQuality get_call_quality(const Id128& session_id);
+    void adapt_bitrate(const Id128& session_id, uint32_t target_bitrate);
     
     // Security
     void enable_e2e_encryption(bool enable);
@@ -90,12 +94,12 @@ private:
     bool srtp_enabled_;
     bool turn_stun_enabled_;
     
-    std::map<std::string, MediaSession> active_sessions_;
+    FlatHashMap<Id128, MediaSession> active_sessions_;
+    CipherEngine cipher_;
     
     std::vector<uint8_t> encrypt_media(const std::vector<uint8_t>& data);
     std::vector<uint8_t> decrypt_media(const std::vector<uint8_t>& data);
-    std::string generate_session_id();
-    CallQuality measure_quality(const std::string& session_id);
+    CallQuality measure_quality(const Id128& session_id);
 };
 
 } // namespace Crypto
@@ -0,0 +1,141 @@
+#ifndef SESSION_STORE_H
+#define SESSION_STORE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "cipher_engine.h"
+#include "double_ratchet.h"
+#include "hmac_sha256.h"
+#include "skipped_key_store.h"
+
+namespace Crypto {
+
+// Ratchet sessions persisted across restarts in two memory-mapped files
+// (POSIX):
+//
+//   <path>      header, an open-addressing index of 64-bit keyed peer-id
+//               hashes, and one fixed 640-byte slot per session holding
+//               two AES-256-GCM sealed copies of the record. Writes go to
+//               the older copy, so a write torn by a crash leaves the
+//               previous one readable.
+//   <path>.wal  write-ahead log of counter updates, split into segments
+//               that are appended to without locking (the caller
+//               serializes each segment; RatchetSessionManager uses one
+//               per shard, so a store needs at least as many segments as
+//               the manager has shards). Each entry carries a truncated
+//               HMAC under a key derived from the storage key.
+//
+// A message key costs one 32-byte log entry instead of a record rewrite:
+// chain keys are never logged, since they follow from the stored chain key
+// and the logged counter. Opening a store reads the header and folds the
+// log into the records it names; every other session is paged in and
+// decrypted on its first lookup.
+//
+// Skipped message keys are not persisted. Until a record is rewritten,
+// its stored chain keys can re-derive the message keys logged since, so
+// callers should checkpoint (save) sessions regularly.
+class SessionStore {
+public:
+    static constexpr size_t MAX_PEER_ID = 120;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // Fixed when the files are created; an existing store keeps its own.
+    struct Layout {
+        size_t capacity;            // session slots, a power of two
+        size_t wal_segments;
+        size_t segment_entries;     // counter updates per segment
+    };
+    static constexpr Layout DEFAULT_LAYOUT = {1 << 19, 256, 4096};
+
+    struct Record {
+        std::string peer_id;
+        bool initiator = false;
+        DoubleRatchet::RatchetState state{};
+        SkippedKeyStore::RatchetId receiving_ratchet{};
+        uint64_t epoch = 0;
+    };
+
+    // Where a loaded or saved record lives; kept by the caller so that
+    // updates skip the index.
+    struct Handle {
+        uint32_t slot = NO_SLOT;
+        uint64_t generation = 0;
+    };
+
+    // Opens or creates the store. Throws std::runtime_error on I/O errors,
+    // a foreign file, or a wrong storage key.
+    SessionStore(const std::string& path, std::span<const uint8_t, 32> storage_key,
+                 const Layout& layout = DEFAULT_LAYOUT);
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    // Record with the log applied; nullopt when absent or unreadable.
+    std::optional<Record> load(std::string_view peer_id, Handle& handle);
+    bool contains(std::string_view peer_id);
+    // Writes the whole record (a checkpoint); an empty handle is looked up
+    // or given a new slot. False when the peer id is too long or the
+    // index is full.
+    bool save(const Record& record, Handle& handle);
+    bool erase(std::string_view peer_id);
+
+    // Appends the counters reached by `handle`'s session. False when the
+    // segment is full: save() the sessions it covers, then reset_segment().
+    bool log_counters(size_t segment, const Handle& handle, uint64_t sending_counter, uint64_t receiving_counter);
+    void reset_segment(size_t segment);
+    size_t segment_count() const { return segments_.size(); }
+
+    // Sessions folded from the log when the store was opened.
+    size_t replayed() const { return replayed_; }
+    // msync both files (the page cache already survives a process crash).
+    void sync();
+
+private:
+    struct Header;
+    struct Segment {
+        alignas(64) size_t tail = 0;
+    };
+
+    uint64_t index_tag(std::string_view peer_id) const;
+    // Slot of the peer (its record and generation decrypted on the way),
+    // or NO_SLOT; with `insert`, a free slot instead.
+    uint32_t find(std::string_view peer_id, uint64_t tag, bool insert, Record* found = nullptr,
+                  uint64_t* generation = nullptr);
+    bool read(uint32_t slot, Record& record, uint64_t& generation) const;
+    void write(const Record& record, Handle& handle);
+    void replay_log();
+    void release();
+
+    int fd_ = -1;
+    int wal_fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    uint8_t* wal_ = nullptr;
+    size_t wal_size_ = 0;
+
+    Header* header_ = nullptr;
+    uint64_t* tags_ = nullptr;
+    uint8_t* slots_ = nullptr;
+    size_t mask_ = 0;
+    size_t segment_entries_ = 0;
+
+    std::optional<CipherEngine> cipher_;
+    std::optional<HmacSha256> index_mac_;
+    std::optional<HmacSha256> log_mac_;
+    std::array<uint8_t, 16> file_id_{};
+    std::mutex index_mutex_;
+    std::vector<Segment> segments_;
+    size_t replayed_ = 0;
+};
+
+} // namespace Crypto
+
+#endif // SESSION_STORE_H
@@ -0,0 +1,40 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Crypto {
+
+// SHA-256 (FIPS 180-4). The compression function comes from the kernel
+// registry: SHA-NI when the CPU has it, portable code otherwise.
+class Sha256 {
+public:
+    static constexpr size_t DIGEST_SIZE = 32;
+    static constexpr size_t BLOCK_SIZE = 64;
+
+    using Digest = std::array<uint8_t, DIGEST_SIZE>;
+
+    Sha256();
+
+    void reset();
+    Sha256& update(std::span<const uint8_t> data);
+    Digest finish();
+
+    static Digest hash(std::span<const uint8_t> data);
+    static std::string hex(const Digest& digest);
+    static const char* backend_name();
+
+private:
+    uint32_t state_[8];
+    uint8_t buffer_[BLOCK_SIZE];
+    size_t buffered_;
+    uint64_t total_;
+};
+
+} // namespace Crypto
+
+#endif // SHA256_H
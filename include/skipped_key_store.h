@@ -0,0 +1,82 @@
+#ifndef SKIPPED_KEY_STORE_H
+#define SKIPPED_KEY_STORE_H
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Crypto {
+
+// Message keys the Double Ratchet stepped over, waiting for out-of-order
+// messages. Keyed by (fingerprint of the sender's ratchet public key,
+// message number) in a fixed-size open-addressing table, so lookup, insert
+// and delete are O(1) and memory is allocated once. Keys leave the store
+// when used, when the capacity is reached (oldest first) or when older
+// than max_age.
+class SkippedKeyStore {
+public:
+    using RatchetId = std::array<uint8_t, 32>;
+    using Key = std::array<uint8_t, 32>;
+    using Clock = std::chrono::steady_clock;
+
+    struct Limits {
+        size_t max_skip;            // keys a single message may skip ahead
+        size_t capacity;            // keys held across all chains
+        Clock::duration max_age;
+    };
+
+    static constexpr Limits DEFAULT_LIMITS = {1000, 2000, std::chrono::hours(72)};
+
+    explicit SkippedKeyStore(const Limits& limits = DEFAULT_LIMITS);
+    ~SkippedKeyStore();
+
+    SkippedKeyStore(const SkippedKeyStore&) = delete;
+    SkippedKeyStore& operator=(const SkippedKeyStore&) = delete;
+
+    // Evicts the oldest key when full; replaces an existing entry.
+    void insert(const RatchetId& ratchet, uint64_t message_number, const Key& key, Clock::time_point now = Clock::now());
+    // Removes the key and returns it.
+    std::optional<Key> take(const RatchetId& ratchet, uint64_t message_number);
+    // The key, left in the store.
+    std::optional<Key> peek(const RatchetId& ratchet, uint64_t message_number) const;
+    // Drops keys older than max_age; returns how many.
+    size_t evict_expired(Clock::time_point now = Clock::now());
+    void clear();
+
+    size_t size() const { return size_; }
+    const Limits& limits() const { return limits_; }
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    struct Entry {
+        RatchetId ratchet;
+        uint64_t message_number;
+        Key key;
+        Clock::time_point inserted;
+        uint32_t hash;
+        uint32_t older;             // insertion-order list; free list in `newer`
+        uint32_t newer;
+    };
+
+    static uint32_t hash_of(const RatchetId& ratchet, uint64_t message_number);
+    size_t find_slot(const RatchetId& ratchet, uint64_t message_number, uint32_t hash) const;
+    void erase_slot(size_t slot);
+    void unlink(uint32_t entry);
+
+    Limits limits_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> slots_;   // entry index or NONE, linear probing
+    size_t mask_;
+    uint32_t oldest_ = NONE;
+    uint32_t newest_ = NONE;
+    uint32_t free_ = NONE;
+    size_t size_ = 0;
+};
+
+} // namespace Crypto
+
+#endif // SKIPPED_KEY_STORE_H
@@ -0,0 +1,59 @@
+#ifndef SLH_DSA_H
+#define SLH_DSA_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Crypto {
+
+// SLH-DSA-SHAKE-256f (FIPS 205, formerly SPHINCS+-SHAKE-256f), NIST
+// category 5: stateless hash-based signatures whose security rests on
+// SHAKE256 alone, used for long-term identity keys.
+//
+// A signature costs some 350 000 Keccak permutations. They are run eight
+// (AVX-512) or four (AVX2, portable) at a time over independent chains and
+// tree nodes, and the 17 hypertree subtrees and 35 FORS trees are spread
+// over ThreadPool::shared().
+class SlhDsaShake256f {
+public:
+    static constexpr size_t N = 32;
+    static constexpr size_t PUBLIC_KEY_SIZE = 2 * N;
+    static constexpr size_t SECRET_KEY_SIZE = 4 * N;
+    static constexpr size_t SIGNATURE_SIZE = 49856;
+    static constexpr size_t MAX_CONTEXT_SIZE = 255;
+
+    using PublicKey = std::array<uint8_t, PUBLIC_KEY_SIZE>;
+    using SecretKey = std::array<uint8_t, SECRET_KEY_SIZE>;
+    using Signature = std::array<uint8_t, SIGNATURE_SIZE>;
+    using Seed = std::array<uint8_t, N>;
+
+    struct KeyPair {
+        PublicKey public_key;
+        SecretKey secret_key;
+    };
+
+    static KeyPair generate_keypair();
+    // Deterministic slh_keygen_internal, for known-answer tests.
+    static KeyPair generate_keypair(const Seed& sk_seed, const Seed& sk_prf, const Seed& pk_seed);
+
+    // Hedged signing; nullopt only when the context is longer than 255 bytes.
+    static std::optional<Signature> sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                         std::span<const uint8_t> message,
+                                         std::span<const uint8_t> context = {});
+    // slh_sign_internal with caller-chosen opt_rand (PK.seed: deterministic variant).
+    static std::optional<Signature> sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                         std::span<const uint8_t> message,
+                                         std::span<const uint8_t> context, const Seed& opt_rand);
+
+    static bool verify(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key, std::span<const uint8_t> message,
+                       std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context = {});
+
+    static const char* backend_name();
+};
+
+} // namespace Crypto
+
+#endif // SLH_DSA_H
@@ -0,0 +1,101 @@
+#ifndef SPHINX_H
+#define SPHINX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "chacha20_poly1305.h"
+#include "id128.h"
+#include "x25519.h"
+
+namespace Crypto {
+
+// Sphinx-format onion packets (Danezis & Goldberg, 2009) for circuits of up
+// to MAX_HOPS relays. Every packet on the wire is PACKET_SIZE bytes,
+// whatever its kind, path length or position on the path.
+//
+// Layer format, shared by both kinds of packet:
+//   nonce (12) | tag (16) | beta: MAX_HOPS slots | body
+// A relay opens beta || body with one ChaCha20-Poly1305 AEAD under its key,
+// nonce and tag. The first plaintext slot holds its routing information and
+// the next hop's nonce and tag; the rest of beta moves up one slot and a
+// zero slot fills the end. The sender precomputes what those zero slots
+// turn into under later hops' keystreams (the Sphinx filler), so every
+// hop's tag checks and no relay can tell how far along the path it is.
+//
+// Setup packets build a circuit. They start with a group element alpha
+// (X25519): relay i computes s = X25519(secret, alpha), derives its keys
+// from s, and passes on alpha blinded by a factor derived from s, so alpha
+// changes at every hop and only the sender knows all the secrets. Each
+// relay keeps the forward key of its hop, and data cells on the circuit
+// then cost one AEAD per hop, with no group operation.
+//
+// Relays drop a setup packet whose secret they have already seen (replay).
+// Packets are processed in place.
+class Sphinx {
+public:
+    static constexpr size_t MAX_HOPS = 5;
+    static constexpr size_t PACKET_SIZE = 512;
+    static constexpr size_t NONCE_SIZE = ChaCha20Poly1305::NONCE_SIZE;
+    static constexpr size_t TAG_SIZE = ChaCha20Poly1305::TAG_SIZE;
+    static constexpr uint32_t EXIT = UINT32_MAX;
+
+    using Key = std::array<uint8_t, 32>;
+    using Packet = std::array<uint8_t, PACKET_SIZE>;
+
+    // Data cell: slots carry only the next nonce and tag.
+    static constexpr size_t CELL_SLOT = NONCE_SIZE + TAG_SIZE;
+    static constexpr size_t CELL_HEADER = NONCE_SIZE + TAG_SIZE + MAX_HOPS * CELL_SLOT;
+    // Message bytes per cell, after a 2-byte length whose top bit marks cover.
+    static constexpr size_t CELL_PAYLOAD = PACKET_SIZE - CELL_HEADER - 2;
+    static constexpr uint16_t CELL_COVER = 0x8000;
+
+    // Setup packet: alpha, then slots with the next relay (u32, or EXIT).
+    static constexpr size_t SETUP_SLOT = 4 + NONCE_SIZE + TAG_SIZE;
+    static constexpr size_t SETUP_HEADER = X25519::KEY_SIZE + NONCE_SIZE + TAG_SIZE + MAX_HOPS * SETUP_SLOT;
+
+    struct Hop {
+        X25519::Key public_key;
+        uint32_t relay;                         // what the previous hop forwards to
+    };
+
+    struct Setup {
+        Packet packet;                          // for the first hop
+        std::vector<Key> forward_keys;          // per hop, for build_cell()
+    };
+
+    struct SetupResult {
+        bool ok = false;
+        uint32_t next = EXIT;                   // relay to forward to; EXIT at the last hop
+        Key forward_key{};
+        Id128 replay_tag;                       // same secret, same tag
+    };
+
+    // forward_keys comes back empty when the path is empty or longer than
+    // MAX_HOPS, or a public key is a small-order point.
+    static Setup build_setup(std::span<const Hop> path);
+    // One relay's step: `packet` becomes the next hop's setup packet.
+    static SetupResult process_setup(std::span<const uint8_t, X25519::KEY_SIZE> secret_key, Packet& packet);
+
+    // Layers `message` (up to CELL_PAYLOAD bytes) for the circuit whose
+    // hop keys are given, first hop first. A cover cell carries no message
+    // and tells the exit, which alone reads it, to drop it.
+    static bool build_cell(std::span<const Key> forward_keys, std::span<const uint8_t> message, Packet& cell,
+                           bool cover = false);
+    // One relay's step with its cached key: false when the tag fails (the
+    // cell is then garbage and must be dropped). Otherwise the cell is
+    // ready for the next hop, or, at the exit, open_payload() reads it.
+    static bool process_cell(const ChaCha20Poly1305& forward, Packet& cell);
+    static std::string open_payload(const Packet& cell);
+    // Its length alone, without copying it out.
+    static size_t payload_size(const Packet& cell);
+    static bool is_cover(const Packet& cell);
+};
+
+} // namespace Crypto
+
+#endif // SPHINX_H
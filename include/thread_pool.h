@@ -0,0 +1,58 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Crypto {
+
+// Fixed set of worker threads for data-parallel crypto work (batch
+// signature verification). parallel_for() blocks until every index has
+// run; the calling thread takes indices too, so a pool with no workers
+// degrades to a plain loop. Calls from different threads are serialized;
+// fn must not call parallel_for() on the same pool.
+class ThreadPool {
+public:
+    // workers == 0: one per hardware thread, minus the caller.
+    explicit ThreadPool(size_t workers = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void parallel_for(size_t count, const std::function<void(size_t)>& fn);
+
+    // Workers plus the calling thread.
+    size_t concurrency() const { return workers_.size() + 1; }
+
+    // Process-wide pool sized to the machine, created on first use.
+    static ThreadPool& shared();
+
+private:
+    void worker_loop();
+    void run_indices();
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;           // one parallel_for at a time
+
+    std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    uint64_t generation_ = 0;
+    size_t busy_ = 0;                   // workers still inside the current job
+    bool stopping_ = false;
+
+    const std::function<void(size_t)>* fn_ = nullptr;
+    size_t count_ = 0;
+    std::atomic<size_t> next_{0};
+};
+
+} // namespace Crypto
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,105 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Crypto {
+
+// Hierarchical timing wheel (Varghese & Lauck, 1987): scheduling and
+// firing cost O(1) per timer whatever the delay, against O(log n) for a
+// heap. Four levels of 256 slots span 2^32 ticks; a level-L slot holds the
+// timers due in one 256^L-tick span and is redistributed one level down
+// when the wheel reaches it, so a timer moves at most three times. Timers
+// further out than 2^32 ticks wait at the top level and are put back
+// until they come within reach.
+//
+// Timers are caller-assigned ids (slots of a store, say) linked through
+// arrays indexed by id: 12 bytes per id, nothing allocated per schedule().
+// advance() skips empty stretches with one bitmap per level instead of
+// visiting every tick.
+class TimerWheel {
+public:
+    static constexpr uint32_t NONE = UINT32_MAX;
+
+    explicit TimerWheel(uint64_t now = 0);
+
+    // `id` must not be pending already. A due tick already passed fires at
+    // the next advance().
+    void schedule(uint32_t id, uint64_t due);
+    // Fires every timer due by `now` as fire(id, due), tick by tick. fire
+    // may schedule more timers.
+    template <typename Fn>
+    void advance(uint64_t now, Fn&& fire);
+
+    // Ticks before `next_tick()` have been processed.
+    uint64_t next_tick() const { return current_; }
+    size_t size() const { return size_; }
+    // Room for ids below `ids` without growing.
+    void reserve(size_t ids);
+    size_t memory_bytes() const;
+
+private:
+    static constexpr int LEVELS = 4;
+    static constexpr size_t SLOTS = 256;
+
+    void place(uint32_t id);
+    void push(int level, size_t slot, uint32_t id);
+    uint32_t take_slot(int level, size_t slot);
+    // First occupied level-0 slot at or after `from`, or SLOTS.
+    size_t next_occupied(size_t from) const;
+
+    uint32_t heads_[LEVELS][SLOTS];
+    uint64_t occupied_[LEVELS][SLOTS / 64] = {};
+    std::vector<uint32_t> next_;
+    std::vector<uint64_t> due_;
+    uint64_t current_;
+    size_t size_ = 0;
+};
+
+template <typename Fn>
+void TimerWheel::advance(uint64_t now, Fn&& fire) {
+    while (current_ <= now) {
+        if (size_ == 0) {
+            current_ = now + 1;
+            return;
+        }
+        const uint64_t t = current_;
+        if ((t & (SLOTS - 1)) == 0) {
+            // Entering a new 256-tick span: bring the level above down,
+            // starting from the highest level that rolls over here.
+            int top = 1;
+            while (top < LEVELS - 1 && ((t >> (8 * top)) & (SLOTS - 1)) == 0) ++top;
+            for (int level = top; level >= 1; --level) {
+                for (uint32_t id = take_slot(level, (t >> (8 * level)) & (SLOTS - 1)); id != NONE;) {
+                    const uint32_t next = next_[id];
+                    place(id);
+                    id = next;
+                }
+            }
+        }
+
+        const size_t slot = next_occupied(t & (SLOTS - 1));
+        if (slot == SLOTS || t - (t & (SLOTS - 1)) + slot > now) {
+            // Nothing due in this span by `now`: on to the next span.
+            const uint64_t span_end = (t | (SLOTS - 1)) + 1;
+            current_ = span_end > now ? now + 1 : span_end;
+            continue;
+        }
+        const uint64_t tick = t - (t & (SLOTS - 1)) + slot;
+        current_ = tick + 1;
+        for (uint32_t id = take_slot(0, slot); id != NONE;) {
+            const uint32_t next = next_[id];
+            --size_;
+            next_[id] = NONE;
+            fire(id, due_[id]);
+            id = next;
+        }
+    }
+}
+
+} // namespace Crypto
+
+#endif // TIMER_WHEEL_H
@@ -0,0 +1,143 @@
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Crypto {
+
+// Framed TCP transport: one event loop thread per core, non-blocking
+// sockets and a SO_REUSEPORT listener per loop and bound port, so the
+// kernel spreads incoming connections across loops. Frames are a 4-byte
+// big-endian length followed by the payload.
+//
+// A connection lives on one loop for its whole life. send() appends to the
+// connection's write queue; the loop flushes queued frames with one
+// gathered sendmsg() per connection per wakeup, so frames sent in a burst
+// share system calls. Sends from another thread are handed over through
+// the loop's inbox and a single eventfd wakeup per batch.
+//
+// Two backends run the loops:
+//   Epoll    readiness: epoll_wait, then read()/sendmsg() per connection.
+//   IoUring  completions: multishot accept and recv into a registered ring
+//            of provided buffers, SENDMSG for batches and SEND_ZC for large
+//            payloads, and all of a tick's submissions in the same
+//            io_uring_enter() that waits for the next completions.
+// Epoll is the default. IoUring (or Auto) runs io_uring when the kernel
+// offers everything above (Linux 6.0+) and falls back to epoll otherwise;
+// backend() reports what runs. io_uring saves the per-read/per-write
+// system calls of small frames; frames larger than a provided buffer
+// (16 KiB) cost it an extra copy, which epoll's direct reads avoid.
+//
+// Callbacks run on the loop thread that owns the connection, so they must
+// be thread-safe when there is more than one loop and should not block.
+// The span passed to on_frame is only valid during the call. Linux only;
+// start() throws std::runtime_error elsewhere or when the kernel refuses
+// the loop's epoll set or eventfd.
+class Transport {
+public:
+    using ConnectionId = uint64_t;              // 0 is never a valid id
+
+    struct Handler {
+        // A connection we accepted, or one of ours that finished connecting.
+        std::function<void(ConnectionId, bool accepted)> on_open;
+        std::function<void(ConnectionId, std::span<const uint8_t> frame)> on_frame;
+        // Closed by the peer, by close(), on an I/O error or a failed
+        // connect. Called once per id, also for connections never opened.
+        std::function<void(ConnectionId)> on_close;
+    };
+
+    enum class Backend {
+        Auto,
+        Epoll,
+        IoUring
+    };
+
+    struct Options {
+        Backend backend = Backend::Epoll;
+        size_t loops = 0;                       // 0: one per hardware thread
+        uint32_t max_frame = 16u << 20;         // larger frames close the connection
+        size_t max_queued_bytes = 64u << 20;    // per connection; frames beyond are dropped
+        size_t zero_copy_threshold = 16u << 10; // io_uring: SEND_ZC from this payload size; 0: never
+    };
+
+    struct Stats {
+        uint64_t frames_sent = 0;
+        uint64_t frames_received = 0;
+        uint64_t bytes_sent = 0;                // including length prefixes
+        uint64_t bytes_received = 0;
+        uint64_t write_calls = 0;               // sendmsg() calls or send requests
+        uint64_t read_calls = 0;                // read() calls or recv completions
+        uint64_t zero_copy_sends = 0;
+        uint64_t wakeups = 0;                   // epoll_wait() or io_uring_enter() returns
+        uint64_t frames_dropped = 0;            // write queue over max_queued_bytes
+    };
+
+    Transport(Handler handler, const Options& options);
+    explicit Transport(Handler handler) : Transport(std::move(handler), Options{}) {}
+    ~Transport();
+
+    Transport(const Transport&) = delete;
+    Transport& operator=(const Transport&) = delete;
+
+    // Starts the loop threads. Idempotent. listen() and connect() need a
+    // running transport.
+    void start();
+    // Closes every connection and listener (on_close runs for each open
+    // connection) and joins the loops. Called by the destructor.
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Binds host:port on every loop; port 0 picks a free port. Returns the
+    // bound port, 0 on failure.
+    uint16_t listen(const std::string& host, uint16_t port);
+    // Starts a non-blocking connect; frames sent before it completes are
+    // queued. Returns 0 when the address does not resolve.
+    ConnectionId connect(const std::string& host, uint16_t port);
+
+    // Queues one frame. False when the transport is stopped, the id was
+    // never issued, or (from the owning loop's thread, where the answer is
+    // known at once) the connection is gone or its queue is full. Frames
+    // handed to another loop for a connection that has closed meanwhile
+    // are dropped there.
+    bool send(ConnectionId id, std::span<const uint8_t> frame);
+    bool send(ConnectionId id, std::vector<uint8_t>&& frame);
+    // Closes at once; queued frames are discarded.
+    void close(ConnectionId id);
+
+    size_t loop_count() const { return loops_.size(); }
+    // Epoll or IoUring once started.
+    Backend backend() const { return backend_; }
+    // Summed over loops; approximate while they run.
+    Stats stats() const;
+
+    // "host:port" -> host, port; false when malformed.
+    static bool split_address(const std::string& address, std::string& host, uint16_t& port);
+
+    // Whether this kernel can run the backend (Auto: always).
+    static bool backend_supported(Backend backend);
+    static const char* backend_name(Backend backend);
+
+    class EventLoop;
+
+private:
+    EventLoop& loop_of(ConnectionId id) const;
+
+    Handler handler_;
+    Options options_;
+    Backend backend_ = Backend::Epoll;
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> next_connection_{1};
+    std::atomic<size_t> next_loop_{0};
+};
+
+} // namespace Crypto
+
+#endif // TRANSPORT_H
@@ -5,6 +5,11 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
+
+#include "chacha20_poly1305.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
@@ -13,12 +18,13 @@ public:
     struct VideoFrame {
         std::vector<uint8_t> encrypted_data;
         std::vector<uint8_t> iv;
+        std::vector<uint8_t> auth_tag;
         uint32_t frame_number;
         uint64_t timestamp;
     };
     
     struct VideoSession {
-        std::string session_id;
+        Id128 session_id;
         std::string codec;
         std::vector<uint8_t> encryption_key;
         uint32_t width;
@@ -34,6 +40,10 @@ public:
 
 private:
     std::vector<VideoSession> active_sessions;
+    // ChaCha20-Poly1305 state per session, keyed by session_id.
+    FlatHashMap<Id128, std::unique_ptr<ChaCha20Poly1305>> session_ciphers;
+
+    ChaCha20Poly1305* session_cipher(const VideoSession& session);
 };
 
 } // namespace Crypto
@@ -5,6 +5,11 @@
 #include <string>
 #include <vector>
 #include <cstdint>
+#include <memory>
+
+#include "chacha20_poly1305.h"
+#include "flat_hash_map.h"
+#include "id128.h"
 
 namespace Crypto {
 
@@ -14,14 +19,16 @@ public:
         std::vector<uint8_t> encrypted_data;
         uint32_t sequence_number;
         uint64_t timestamp;
+        std::vector<uint8_t> nonce;
         std::vector<uint8_t> auth_tag;
     };
     
     struct VoiceSession {
-        std::string session_id;
+        Id128 session_id;
         std::string participant_a;
         std::string participant_b;
         std::vector<uint8_t> session_key;
+        uint64_t started_at;
         bool active;
     };
     
@@ -33,6 +40,10 @@ public:
 
 private:
     std::vector<VoiceSession> active_sessions;
+    // ChaCha20-Poly1305 state per session, keyed by session_id.
+    FlatHashMap<Id128, std::unique_ptr<ChaCha20Poly1305>> session_ciphers;
+
+    ChaCha20Poly1305* session_cipher(const VoiceSession& session);
 };
 
 } // namespace Crypto
@@ -0,0 +1,40 @@
+#ifndef X25519_H
+#define X25519_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+
+namespace Crypto {
+
+// X25519 Diffie-Hellman (RFC 7748): scalar multiplication on Curve25519's
+// Montgomery form, u-coordinates only, constant time (Montgomery ladder
+// with conditional swaps, 51-bit limbs). Scalars are clamped on every
+// call, so X25519(b, X25519(a, P)) == X25519(a, X25519(b, P)): Sphinx
+// relies on this to blind group elements hop by hop.
+class X25519 {
+public:
+    static constexpr size_t KEY_SIZE = 32;
+
+    using Key = std::array<uint8_t, KEY_SIZE>;  // scalar or u-coordinate, little-endian
+
+    struct KeyPair {
+        Key public_key;
+        Key secret_key;
+    };
+
+    static KeyPair generate_keypair();
+    static Key public_key(std::span<const uint8_t, KEY_SIZE> secret_key);
+    // scalar * point. nullopt when the result is the all-zero value (a
+    // small-order point), which must not be used as a shared secret.
+    static std::optional<Key> shared_secret(std::span<const uint8_t, KEY_SIZE> scalar,
+                                            std::span<const uint8_t, KEY_SIZE> point);
+    // The raw function, no output check.
+    static Key scalarmult(std::span<const uint8_t, KEY_SIZE> scalar, std::span<const uint8_t, KEY_SIZE> point);
+};
+
+} // namespace Crypto
+
+#endif // X25519_H
@@ -1,36 +1,179 @@
 #include "blockchain_identity.h"
+#include "mesh_network.h"
+
+#include <chrono>
+#include <optional>
 
 namespace Crypto {
 
-BlockchainIdentity::BlockchainIdentity() {}
+namespace {
 
-BlockchainIdentity::OnChainDID BlockchainIdentity::resolve_did(const std::string& did) {
-    OnChainDID doc;
-    
-    if (did.find("did:ethr:") == 0) {
-        doc.did = did;
-        doc.owner = "0x" + did.substr(11);
-        doc.block_number = 18500000 + rand() % 100000;
-        doc.timestamp = time(nullptr) - rand() % 86400 * 30;
-        doc.document_hash = "Qm" + std::to_string(rand() % 1000000);
-        
-        doc.public_keys["primary"] = "0x04" + std::to_string(rand() % 1000000);
-        doc.public_keys["recovery"] = "0x04" + std::to_string(rand() % 1000000);
-        
-        doc.services["MessagingService"] = "https://msg.example.com/" + doc.owner.substr(0, 10);
-        doc.services["KeyDirectory"] = "https://keys.example.com/" + doc.owner.substr(0, 10);
+// Signed form of a DID document: every field length-prefixed (u32,
+// big-endian) and each map preceded by its entry count, as in
+// encode_document(), so no entry can move from one map to the other.
+std::vector<uint8_t> canonical_bytes(const BlockchainIdentity::OnChainDID& doc) {
+    std::vector<uint8_t> out;
+    auto put_u32 = [&](size_t v) {
+        for (int i = 3; i >= 0; --i) out.push_back(static_cast<uint8_t>(static_cast<uint32_t>(v) >> (8 * i)));
+    };
+    auto put = [&](const std::string& field) {
+        put_u32(field.size());
+        out.insert(out.end(), field.begin(), field.end());
+    };
+    put(doc.did);
+    put(doc.owner);
+    put(doc.document_hash);
+    put(std::to_string(doc.block_number));
+    put(std::to_string(doc.timestamp));
+    for (const auto* map : {&doc.public_keys, &doc.services}) {
+        put_u32(map->size());
+        for (const auto& [id, value] : *map) {
+            put(id);
+            put(value);
+        }
     }
-    
+    return out;
+}
+
+constexpr uint8_t DID_CONTEXT[] = {'d', 'i', 'd', '-', 'd', 'o', 'c'};
+
+// Directory record: the document with its signature, fields and maps
+// length-prefixed (u32, big-endian).
+std::string encode_document(const BlockchainIdentity::OnChainDID& doc) {
+    std::string out;
+    auto put_u32 = [&](size_t v) {
+        for (int i = 3; i >= 0; --i) out.push_back(static_cast<char>(static_cast<uint32_t>(v) >> (8 * i)));
+    };
+    auto put = [&](const std::string& field) {
+        put_u32(field.size());
+        out += field;
+    };
+    put(doc.did);
+    put(doc.owner);
+    put(doc.document_hash);
+    put(std::to_string(doc.block_number));
+    put(std::to_string(doc.timestamp));
+    for (const auto* map : {&doc.public_keys, &doc.services}) {
+        put_u32(map->size());
+        for (const auto& [id, value] : *map) {
+            put(id);
+            put(value);
+        }
+    }
+    put(std::string(doc.signature.begin(), doc.signature.end()));
+    return out;
+}
+
+std::optional<BlockchainIdentity::OnChainDID> decode_document(const std::string& in) {
+    size_t pos = 0;
+    bool ok = true;
+    auto get_u32 = [&]() -> size_t {
+        if (in.size() - pos < 4) {
+            ok = false;
+            return 0;
+        }
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v = (v << 8) | static_cast<uint8_t>(in[pos++]);
+        return v;
+    };
+    auto get = [&]() -> std::string {
+        const size_t n = get_u32();
+        if (!ok || in.size() - pos < n) {
+            ok = false;
+            return {};
+        }
+        std::string field = in.substr(pos, n);
+        pos += n;
+        return field;
+    };
+    auto number = [&](const std::string& text) -> uint64_t {
+        if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos || text.size() > 19) {
+            ok = false;
+            return 0;
+        }
+        return std::stoull(text);
+    };
+
+    BlockchainIdentity::OnChainDID doc;
+    doc.did = get();
+    doc.owner = get();
+    doc.document_hash = get();
+    doc.block_number = number(get());
+    doc.timestamp = number(get());
+    for (auto* map : {&doc.public_keys, &doc.services}) {
+        const size_t count = get_u32();
+        for (size_t i = 0; i < count && ok; ++i) {
+            std::string id = get();
+            (*map)[id] = get();
+        }
+    }
+    const std::string signature = get();
+    doc.signature.assign(signature.begin(), signature.end());
+    if (!ok || pos != in.size()) return std::nullopt;
     return doc;
 }
 
+} // namespace
+
+BlockchainIdentity::BlockchainIdentity() : identity_key(SlhDsaShake256f::generate_keypair()) {}
+
+BlockchainIdentity::OnChainDID BlockchainIdentity::resolve_did(const std::string& did) {
+    auto known = registry.find(did);
+    if (known != registry.end()) return known->second;
+
+    if (directory != nullptr) {
+        const std::optional<std::string> record = directory->lookup(directory_node, did);
+        std::optional<OnChainDID> doc = record ? decode_document(*record) : std::nullopt;
+        if (doc && doc->did == did && verify_did(*doc)) return *doc;
+        if (record) std::cout << "[!] Directory record for " << did << " rejected" << std::endl;
+    }
+    return {};
+}
+
 void BlockchainIdentity::register_did(const OnChainDID& did_doc) {
-    registry[did_doc.did] = did_doc;
+    const auto start = std::chrono::steady_clock::now();
+    const auto signature = SlhDsaShake256f::sign(identity_key.secret_key, canonical_bytes(did_doc), DID_CONTEXT);
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    OnChainDID& entry = registry[did_doc.did];
+    entry = did_doc;
+    entry.signature.assign(signature->begin(), signature->end());
     std::cout << "\n=== DID Registration ===" << std::endl;
     std::cout << "DID: " << did_doc.did << std::endl;
     std::cout << "Owner: " << did_doc.owner << std::endl;
     std::cout << "Block: " << did_doc.block_number << std::endl;
+    std::cout << "Signature: SLH-DSA-SHAKE-256f, " << entry.signature.size() << " bytes in " << ms << " ms ("
+              << SlhDsaShake256f::backend_name() << ")" << std::endl;
     std::cout << "Status: CONFIRMED" << std::endl;
+
+    if (directory != nullptr && !directory->publish(directory_node, entry.did, encode_document(entry))) {
+        std::cout << "[!] DID not published: no other directory node reachable" << std::endl;
+    }
+}
+
+void BlockchainIdentity::use_directory(MeshNetwork* mesh, const std::string& node_id) {
+    directory = mesh;
+    directory_node = node_id;
+}
+
+void BlockchainIdentity::trust_registrar(const SlhDsaShake256f::PublicKey& key) {
+    trusted_registrars.push_back(key);
+}
+
+bool BlockchainIdentity::verify_did(const OnChainDID& doc) const {
+    if (doc.signature.size() != SlhDsaShake256f::SIGNATURE_SIZE) {
+        return false;
+    }
+    const std::vector<uint8_t> message = canonical_bytes(doc);
+    const std::span<const uint8_t, SlhDsaShake256f::SIGNATURE_SIZE> signature(doc.signature.data(),
+                                                                             doc.signature.size());
+    if (SlhDsaShake256f::verify(identity_key.public_key, message, signature, DID_CONTEXT)) {
+        return true;
+    }
+    for (const auto& key : trusted_registrars) {
+        if (SlhDsaShake256f::verify(key, message, signature, DID_CONTEXT)) return true;
+    }
+    return false;
 }
 
 void BlockchainIdentity::print_did_document(const OnChainDID& doc) {
@@ -1,4 +1,5 @@
 #include "mpc_wallet.h"
+#include "secure_random.h"
 #include <iomanip>
 
 namespace Crypto {
@@ -12,8 +13,8 @@ std::vector<MPCWallet::Share> MPCWallet::generate_shares(int total_shares, int t
         Share share;
         share.share_id = i + 1;
         share.threshold = threshold;
-        for (auto& b : share.share_value) b = rand() % 256;
-        for (auto& b : share.public_key) b = rand() % 256;
+        SecureRandom::fill(share.share_value);
+        SecureRandom::fill(share.public_key);
         result.push_back(share);
     }
     
@@ -29,7 +30,7 @@ MPCWallet::Transaction MPCWallet::create_transaction(const std::string& to, doub
     std::lock_guard<std::mutex> lock(wallet_mutex);
     
     Transaction tx;
-    tx.tx_id = "0x" + std::to_string(rand() % 0xFFFFFFFF);
+    tx.tx_id = "0x" + std::to_string(SecureRandom::uniform(0xFFFFFFFF));
     tx.amount = amount;
     tx.to_address = to;
     
@@ -69,7 +70,7 @@ MPCWallet::Transaction MPCWallet::finalize_transaction(const std::string& tx_id,
     for (auto& tx : pending_txs) {
         if (tx.tx_id == tx_id) {
             if ((int)tx.signers.size() >= required_signatures) {
-                for (auto& b : tx.signature) b = rand() % 256;
+                SecureRandom::fill(tx.signature);
                 
                 std::cout << "\n=== Transaction Finalized ===" << std::endl;
                 std::cout << "TX ID: " << tx_id << std::endl;
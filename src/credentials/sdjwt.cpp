@@ -1,4 +1,5 @@
 #include "sdjwt.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -16,7 +17,7 @@ SDJWT::Credential SDJWT::issue_credential(const std::string& subject,
     }
     
     for (int i = 0; i < 16; ++i) {
-        cred.salt += (char)('a' + rand() % 26);
+        cred.salt += (char)('a' + SecureRandom::uniform(26));
     }
     
     issued_credentials.push_back(cred);
@@ -52,7 +53,7 @@ SDJWT::Presentation SDJWT::create_presentation(const Credential& cred,
         }
     }
     
-    pres.proof = "sdjwt_proof_" + std::to_string(rand() % 1000000);
+    pres.proof = "sdjwt_proof_" + std::to_string(SecureRandom::uniform(1000000));
     
     std::cout << "\n=== SD-JWT Presentation Created ===" << std::endl;
     std::cout << "Disclosed: " << pres.disclosed_claims.size() << " claims" << std::endl;
@@ -0,0 +1,106 @@
+#include "aes_gcm_kernels.h"
+
+// AES-NI + PCLMULQDQ backend. Built with -maes -mpclmul -mssse3 -msse4.1;
+// only reached after CipherEngine has confirmed CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include "aes_gcm_batch.h"
+
+namespace Crypto {
+namespace aes_gcm {
+
+namespace {
+
+template <int Rcon>
+__m128i expand_even(__m128i prev_even, __m128i prev_odd) {
+    const __m128i t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(prev_odd, Rcon), 0xFF);
+    prev_even = _mm_xor_si128(prev_even, _mm_slli_si128(prev_even, 4));
+    prev_even = _mm_xor_si128(prev_even, _mm_slli_si128(prev_even, 4));
+    prev_even = _mm_xor_si128(prev_even, _mm_slli_si128(prev_even, 4));
+    return _mm_xor_si128(prev_even, t);
+}
+
+__m128i expand_odd(__m128i prev_odd, __m128i even) {
+    const __m128i t = _mm_shuffle_epi32(_mm_aeskeygenassist_si128(even, 0), 0xAA);
+    prev_odd = _mm_xor_si128(prev_odd, _mm_slli_si128(prev_odd, 4));
+    prev_odd = _mm_xor_si128(prev_odd, _mm_slli_si128(prev_odd, 4));
+    prev_odd = _mm_xor_si128(prev_odd, _mm_slli_si128(prev_odd, 4));
+    return _mm_xor_si128(prev_odd, t);
+}
+
+struct Xmm {
+    using V = __m128i;
+    static constexpr int W = 1;
+    static constexpr int R = 8;
+    static V load(const uint8_t* p) { return _mm_load_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void store(uint8_t* p, V v) { _mm_store_si128(reinterpret_cast<__m128i*>(p), v); }
+    static V gather(const uint8_t* const p[W]) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p[0])); }
+    static void scatter(uint8_t* const p[W], V v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p[0]), v); }
+    static V zero() { return _mm_setzero_si128(); }
+    static V broadcast(__m128i v) { return v; }
+    static V bxor(V a, V b) { return _mm_xor_si128(a, b); }
+    static V band(V a, V b) { return _mm_and_si128(a, b); }
+    static V bor(V a, V b) { return _mm_or_si128(a, b); }
+    static V bandnot(V a, V b) { return _mm_andnot_si128(a, b); }
+    static V shuffle(V a, V m) { return _mm_shuffle_epi8(a, m); }
+    static V add32(V a, V b) { return _mm_add_epi32(a, b); }
+    static V aesenc(V a, V k) { return _mm_aesenc_si128(a, k); }
+    static V aesenclast(V a, V k) { return _mm_aesenclast_si128(a, k); }
+    template <int N> static V slli32(V a) { return _mm_slli_epi32(a, N); }
+    template <int N> static V srli32(V a) { return _mm_srli_epi32(a, N); }
+    template <int N> static V bslli(V a) { return _mm_slli_si128(a, N); }
+    template <int N> static V bsrli(V a) { return _mm_srli_si128(a, N); }
+    template <int I> static V clmul(V a, V b) { return _mm_clmulepi64_si128(a, b, I); }
+};
+
+} // namespace
+
+void expand_key_aesni(const uint8_t key[32], KeySchedule& ks) {
+    __m128i rk[ROUNDS + 1];
+    rk[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key));
+    rk[1] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + 16));
+    rk[2] = expand_even<0x01>(rk[0], rk[1]);
+    rk[3] = expand_odd(rk[1], rk[2]);
+    rk[4] = expand_even<0x02>(rk[2], rk[3]);
+    rk[5] = expand_odd(rk[3], rk[4]);
+    rk[6] = expand_even<0x04>(rk[4], rk[5]);
+    rk[7] = expand_odd(rk[5], rk[6]);
+    rk[8] = expand_even<0x08>(rk[6], rk[7]);
+    rk[9] = expand_odd(rk[7], rk[8]);
+    rk[10] = expand_even<0x10>(rk[8], rk[9]);
+    rk[11] = expand_odd(rk[9], rk[10]);
+    rk[12] = expand_even<0x20>(rk[10], rk[11]);
+    rk[13] = expand_odd(rk[11], rk[12]);
+    rk[14] = expand_even<0x40>(rk[12], rk[13]);
+    for (int r = 0; r <= ROUNDS; ++r) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ks.round_keys[r]), rk[r]);
+    }
+
+    const __m128i h = _mm_shuffle_epi8(x86::encrypt_block(rk, _mm_setzero_si128()), x86::bswap_mask());
+    __m128i power = h;
+    for (int i = 0; i < 16; ++i) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(ks.h_powers[i]), power);
+        power = x86::gf_mul(power, h);
+    }
+}
+
+void crypt_aesni(const KeySchedule& ks, const uint8_t nonce[12],
+                 const uint8_t* aad, size_t aad_len,
+                 const uint8_t* in, uint8_t* out, size_t len,
+                 bool decrypt, uint8_t tag[16]) {
+    __m128i rk[ROUNDS + 1];
+    x86::load_round_keys(ks, rk);
+    x86::State st = x86::begin(ks, nonce, aad, aad_len);
+    const size_t done = x86::crypt_blocks8(rk, ks, st, in, out, len, decrypt);
+    x86::finish(rk, ks, st, in + done, out + done, len - done, decrypt, aad_len, len, tag);
+}
+
+void crypt_batch_aesni(const BatchLane* lanes, size_t count, bool decrypt) {
+    batch::crypt<Xmm>(lanes, count, decrypt);
+}
+
+} // namespace aes_gcm
+} // namespace Crypto
+
+#endif
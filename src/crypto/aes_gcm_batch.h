@@ -0,0 +1,236 @@
+#ifndef AES_GCM_BATCH_H
+#define AES_GCM_BATCH_H
+
+// Multi-buffer AES-256-GCM: up to LANES independent messages, each with its
+// own key schedule, nonce and length, advance in lockstep one block per
+// step. Each 128-bit lane of a SIMD register carries a different message,
+// so AES rounds and GHASH multiplies of unrelated messages share one
+// instruction. Lanes that run out of blocks keep computing but are masked
+// out of stores and of the GHASH update.
+//
+// Instantiated per ISA through a traits type providing the vector type V,
+// W (128-bit lanes per V), R (registers per step) and the primitive ops;
+// gather(p) assembles one V from W unaligned 16-byte blocks p[0..W-1] and
+// scatter(p, v) stores them back.
+// Include only from translation units built with matching ISA flags.
+
+#include "aes_gcm_x86.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Crypto {
+namespace aes_gcm {
+namespace batch {
+
+template <class T>
+inline typename T::V reduce(typename T::V lo, typename T::V mid, typename T::V hi) {
+    using V = typename T::V;
+    lo = T::bxor(lo, T::template bslli<8>(mid));
+    hi = T::bxor(hi, T::template bsrli<8>(mid));
+
+    V lo_carry = T::template srli32<31>(lo);
+    V hi_carry = T::template srli32<31>(hi);
+    lo = T::template slli32<1>(lo);
+    hi = T::template slli32<1>(hi);
+    const V cross = T::template bsrli<12>(lo_carry);
+    hi_carry = T::template bslli<4>(hi_carry);
+    lo_carry = T::template bslli<4>(lo_carry);
+    lo = T::bor(lo, lo_carry);
+    hi = T::bor(hi, T::bor(hi_carry, cross));
+
+    V a = T::bxor(T::template slli32<31>(lo), T::bxor(T::template slli32<30>(lo), T::template slli32<25>(lo)));
+    const V b = T::template bsrli<4>(a);
+    a = T::template bslli<12>(a);
+    lo = T::bxor(lo, a);
+
+    V d = T::bxor(T::template srli32<1>(lo), T::bxor(T::template srli32<2>(lo), T::template srli32<7>(lo)));
+    lo = T::bxor(lo, T::bxor(d, b));
+    return T::bxor(hi, lo);
+}
+
+template <class T>
+inline void clmul_acc(typename T::V a, typename T::V b, typename T::V& lo, typename T::V& mid, typename T::V& hi) {
+    lo = T::bxor(lo, T::template clmul<0x00>(a, b));
+    hi = T::bxor(hi, T::template clmul<0x11>(a, b));
+    mid = T::bxor(mid, T::bxor(T::template clmul<0x10>(a, b), T::template clmul<0x01>(a, b)));
+}
+
+template <class T>
+inline typename T::V gf_mul(typename T::V a, typename T::V b) {
+    using V = typename T::V;
+    V lo = T::zero(), mid = lo, hi = lo;
+    clmul_acc<T>(a, b, lo, mid, hi);
+    return reduce<T>(lo, mid, hi);
+}
+
+template <class T>
+void crypt(const BatchLane* lanes, size_t count, bool decrypt) {
+    using V = typename T::V;
+    constexpr int W = T::W;
+    constexpr int R = T::R;
+    constexpr int LANES = W * R;
+    constexpr size_t VBYTES = 16 * W;
+    constexpr int AGG = 4;
+
+    const __m128i bswap128 = x86::bswap_mask();
+    const V bswap = T::broadcast(bswap128);
+    const V one = T::broadcast(_mm_set_epi32(0, 0, 0, 1));
+
+    for (size_t base = 0; base < count; base += LANES) {
+        const int used = static_cast<int>(std::min<size_t>(LANES, count - base));
+        const BatchLane* group = lanes + base;
+
+        // Lane-interleaved operands: vector r holds lanes r*W .. r*W+W-1.
+        alignas(64) uint8_t rk[ROUNDS + 1][R][VBYTES];
+        alignas(64) uint8_t h[AGG][R][VBYTES];
+        alignas(64) uint8_t ctr[R][VBYTES];
+        alignas(64) uint8_t x[R][VBYTES];
+        size_t blocks[LANES];
+        size_t max_blocks = 0;
+
+        for (int lane = 0; lane < LANES; ++lane) {
+            // Idle lanes reuse lane 0's key so every AES round stays valid.
+            const BatchLane& l = group[lane < used ? lane : 0];
+            const int r = lane / W;
+            const size_t off = 16 * (lane % W);
+            for (int k = 0; k <= ROUNDS; ++k) std::memcpy(&rk[k][r][off], l.ks->round_keys[k], 16);
+            // h[j] holds H^(AGG-j): the multiplier for step j of an aggregated run.
+            for (int j = 0; j < AGG; ++j) std::memcpy(&h[j][r][off], l.ks->h_powers[AGG - 1 - j], 16);
+            const x86::State st = x86::begin(*l.ks, l.nonce, l.aad, lane < used ? l.aad_len : 0);
+            // J0 first: the first step produces E(J0) for the tag.
+            _mm_store_si128(reinterpret_cast<__m128i*>(&ctr[r][off]), _mm_shuffle_epi8(st.j0, bswap128));
+            _mm_store_si128(reinterpret_cast<__m128i*>(&x[r][off]), st.x);
+            blocks[lane] = lane < used ? (l.len + 15) / 16 : 0;
+            max_blocks = std::max(max_blocks, blocks[lane]);
+        }
+
+        V vctr[R], vx[R], vh[R], ej0[R];
+        for (int r = 0; r < R; ++r) {
+            vctr[r] = T::load(ctr[r]);
+            vx[r] = T::load(x[r]);
+            vh[r] = T::load(h[AGG - 1][r]);
+        }
+
+        auto aes = [&](V out[R]) {
+            V b[R];
+            for (int r = 0; r < R; ++r) {
+                b[r] = T::bxor(T::shuffle(vctr[r], bswap), T::load(rk[0][r]));
+                vctr[r] = T::add32(vctr[r], one);
+            }
+            for (int k = 1; k < ROUNDS; ++k) {
+                for (int r = 0; r < R; ++r) b[r] = T::aesenc(b[r], T::load(rk[k][r]));
+            }
+            for (int r = 0; r < R; ++r) out[r] = T::aesenclast(b[r], T::load(rk[ROUNDS][r]));
+        };
+
+        aes(ej0);
+
+        // Lanes load and store straight from their messages, one 16-byte
+        // block per lane, which avoids store-forwarding stalls on a staging
+        // buffer. Idle lanes read zeros and write to a scratch block.
+        alignas(16) static const uint8_t zero_block[16] = {};
+        alignas(16) uint8_t discard[16];
+        const uint8_t* src_ptr[LANES];
+        uint8_t* dst_ptr[LANES];
+        for (int lane = used; lane < LANES; ++lane) {
+            src_ptr[lane] = zero_block;
+            dst_ptr[lane] = discard;
+        }
+
+        // Phase 1: while every lane still has a full block nothing needs
+        // masking, and GHASH is aggregated over AGG steps with one reduction.
+        size_t common = max_blocks;
+        for (int lane = 0; lane < used; ++lane) common = std::min(common, group[lane].len / 16);
+        size_t step = 0;
+        for (; step + AGG <= common; step += AGG) {
+            V lo[R], mid[R], hi[R];
+            for (int r = 0; r < R; ++r) lo[r] = mid[r] = hi[r] = T::zero();
+            for (int j = 0; j < AGG; ++j) {
+                const size_t offset = 16 * (step + j);
+                for (int lane = 0; lane < used; ++lane) {
+                    src_ptr[lane] = group[lane].in + offset;
+                    dst_ptr[lane] = group[lane].out + offset;
+                }
+                V stream[R];
+                aes(stream);
+                for (int r = 0; r < R; ++r) {
+                    const V src = T::gather(src_ptr + r * W);
+                    const V dst = T::bxor(stream[r], src);
+                    T::scatter(dst_ptr + r * W, dst);
+                    V c = T::shuffle(decrypt ? src : dst, bswap);
+                    if (j == 0) c = T::bxor(c, vx[r]);
+                    clmul_acc<T>(c, T::load(h[j][r]), lo[r], mid[r], hi[r]);
+                }
+            }
+            for (int r = 0; r < R; ++r) vx[r] = reduce<T>(lo[r], mid[r], hi[r]);
+        }
+
+        // Phase 2: the remaining blocks one step at a time. A lane's final
+        // partial block comes from a zero-padded copy and its output is
+        // masked; lanes that have finished are left out of GHASH.
+        alignas(16) uint8_t tail[LANES][16] = {};
+        alignas(64) uint8_t out_stage[R][VBYTES];
+        alignas(64) uint8_t keep[R][VBYTES];
+        alignas(64) uint8_t active[R][VBYTES];
+        std::memset(keep, 0xFF, sizeof(keep));
+        std::memset(active, 0xFF, sizeof(active));
+        for (; step < max_blocks; ++step) {
+            for (int lane = 0; lane < LANES; ++lane) {
+                if (step + 1 < blocks[lane]) {
+                    src_ptr[lane] = group[lane].in + 16 * step;
+                } else if (step + 1 == blocks[lane]) {
+                    const size_t n = group[lane].len - 16 * step;
+                    std::memcpy(tail[lane], group[lane].in + 16 * step, n);
+                    std::memset(&keep[lane / W][16 * (lane % W) + n], 0, 16 - n);
+                    src_ptr[lane] = tail[lane];
+                } else {
+                    if (step == blocks[lane]) std::memset(&active[lane / W][16 * (lane % W)], 0, 16);
+                    src_ptr[lane] = zero_block;
+                }
+            }
+
+            V stream[R];
+            aes(stream);
+            for (int r = 0; r < R; ++r) {
+                const V src = T::gather(src_ptr + r * W);
+                const V dst = T::band(T::bxor(stream[r], src), T::load(keep[r]));
+                T::store(out_stage[r], dst);
+                const V c = T::shuffle(decrypt ? src : dst, bswap);
+                const V next = gf_mul<T>(T::bxor(vx[r], c), vh[r]);
+                const V act = T::load(active[r]);
+                vx[r] = T::bor(T::band(act, next), T::bandnot(act, vx[r]));
+            }
+
+            for (int lane = 0; lane < used; ++lane) {
+                const uint8_t* out_lane = &out_stage[lane / W][16 * (lane % W)];
+                if (step + 1 < blocks[lane]) {
+                    std::memcpy(group[lane].out + 16 * step, out_lane, 16);
+                } else if (step + 1 == blocks[lane]) {
+                    std::memcpy(group[lane].out + 16 * step, out_lane, group[lane].len - 16 * step);
+                }
+            }
+        }
+
+        alignas(64) uint8_t lengths[R][VBYTES] = {};
+        for (int lane = 0; lane < used; ++lane) {
+            const __m128i len_block = _mm_set_epi64x(static_cast<long long>(group[lane].aad_len) * 8,
+                                                     static_cast<long long>(group[lane].len) * 8);
+            _mm_store_si128(reinterpret_cast<__m128i*>(&lengths[lane / W][16 * (lane % W)]), len_block);
+        }
+        alignas(64) uint8_t tags[R][VBYTES];
+        for (int r = 0; r < R; ++r) {
+            vx[r] = gf_mul<T>(T::bxor(vx[r], T::load(lengths[r])), vh[r]);
+            T::store(tags[r], T::bxor(T::shuffle(vx[r], bswap), ej0[r]));
+        }
+        for (int lane = 0; lane < used; ++lane) {
+            std::memcpy(group[lane].tag, &tags[lane / W][16 * (lane % W)], 16);
+        }
+    }
+}
+
+} // namespace batch
+} // namespace aes_gcm
+} // namespace Crypto
+
+#endif // AES_GCM_BATCH_H
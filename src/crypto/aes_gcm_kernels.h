@@ -0,0 +1,77 @@
+#ifndef AES_GCM_KERNELS_H
+#define AES_GCM_KERNELS_H
+
+// Internal interface between CipherEngine and its AES-256-GCM backends.
+// Every backend implements the complete GCM construction so that it can
+// keep counters, round keys and the GHASH accumulator in registers.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Crypto {
+namespace aes_gcm {
+
+constexpr int ROUNDS = 14;
+
+struct alignas(64) KeySchedule {
+    // FIPS-197 byte order; AES-NI consumes this layout directly.
+    uint8_t round_keys[ROUNDS + 1][16];
+    // Portable backend: each round key replicated over four blocks and
+    // bitsliced into eight planes.
+    uint64_t sliced_keys[ROUNDS + 1][8];
+    // Portable backend: H as two big-endian 64-bit words.
+    uint64_t h[2];
+    // SIMD backends: byte-reflected H^1 .. H^16.
+    uint8_t h_powers[16][16];
+};
+
+using ExpandKeyFn = void (*)(const uint8_t key[32], KeySchedule& ks);
+using CryptFn = void (*)(const KeySchedule& ks, const uint8_t nonce[12],
+                         const uint8_t* aad, size_t aad_len,
+                         const uint8_t* in, uint8_t* out, size_t len,
+                         bool decrypt, uint8_t tag[16]);
+
+// One message of a multi-buffer call. Every lane has its own schedule,
+// nonce and lengths; in and out may alias.
+struct BatchLane {
+    const KeySchedule* ks;
+    const uint8_t* nonce;
+    const uint8_t* aad;
+    size_t aad_len;
+    const uint8_t* in;
+    uint8_t* out;
+    size_t len;
+    uint8_t* tag;
+};
+
+using CryptBatchFn = void (*)(const BatchLane* lanes, size_t count, bool decrypt);
+
+void expand_key_portable(const uint8_t key[32], KeySchedule& ks);
+void crypt_portable(const KeySchedule& ks, const uint8_t nonce[12],
+                    const uint8_t* aad, size_t aad_len,
+                    const uint8_t* in, uint8_t* out, size_t len,
+                    bool decrypt, uint8_t tag[16]);
+
+// Available when compiled for x86-64; callers must check CPU support first.
+void expand_key_aesni(const uint8_t key[32], KeySchedule& ks);
+void crypt_aesni(const KeySchedule& ks, const uint8_t nonce[12],
+                 const uint8_t* aad, size_t aad_len,
+                 const uint8_t* in, uint8_t* out, size_t len,
+                 bool decrypt, uint8_t tag[16]);
+
+void expand_key_vaes(const uint8_t key[32], KeySchedule& ks);
+void crypt_vaes(const KeySchedule& ks, const uint8_t nonce[12],
+                const uint8_t* aad, size_t aad_len,
+                const uint8_t* in, uint8_t* out, size_t len,
+                bool decrypt, uint8_t tag[16]);
+
+// Multi-buffer kernels (SIMD schedules only): 8 lanes of 128-bit AES-NI,
+// 8 lanes over 256-bit VAES and 16 lanes over 512-bit VAES.
+void crypt_batch_aesni(const BatchLane* lanes, size_t count, bool decrypt);
+void crypt_batch_vaes(const BatchLane* lanes, size_t count, bool decrypt);
+void crypt_batch_vaes512(const BatchLane* lanes, size_t count, bool decrypt);
+
+} // namespace aes_gcm
+} // namespace Crypto
+
+#endif // AES_GCM_KERNELS_H
@@ -0,0 +1,338 @@
+#include "aes_gcm_kernels.h"
+
+#include <cstring>
+
+// Constant-time AES-256-GCM without table lookups. AES runs bitsliced over
+// four blocks at a time (64 bytes -> eight 64-bit planes); the S-box is
+// computed as x^254 in GF(2^8) followed by the affine map. GHASH uses
+// integer multiplications with "holes" so no secret-dependent carries leak.
+
+namespace Crypto {
+namespace aes_gcm {
+
+namespace {
+
+using Planes = uint64_t[8];
+
+uint64_t load_le64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+void store_le64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+uint64_t load_be64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i) v = (v << 8) | p[i];
+    return v;
+}
+
+void store_be64(uint8_t* p, uint64_t v) {
+    for (int i = 7; i >= 0; --i) {
+        p[i] = static_cast<uint8_t>(v);
+        v >>= 8;
+    }
+}
+
+// Transposes the 8x8 bit matrix held in x (row = byte, column = bit).
+uint64_t transpose8(uint64_t x) {
+    uint64_t t;
+    t = (x ^ (x >> 7)) & 0x00AA00AA00AA00AAULL;
+    x = x ^ t ^ (t << 7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC0000CCCCULL;
+    x = x ^ t ^ (t << 14);
+    t = (x ^ (x >> 28)) & 0x00000000F0F0F0F0ULL;
+    x = x ^ t ^ (t << 28);
+    return x;
+}
+
+// Bit j of q[b] = bit b of byte j.
+void bitslice(const uint8_t in[64], Planes q) {
+    uint64_t t[8];
+    for (int k = 0; k < 8; ++k) t[k] = transpose8(load_le64(in + 8 * k));
+    for (int b = 0; b < 8; ++b) {
+        uint64_t v = 0;
+        for (int k = 0; k < 8; ++k) v |= ((t[k] >> (8 * b)) & 0xFF) << (8 * k);
+        q[b] = v;
+    }
+}
+
+void unbitslice(const Planes q, uint8_t out[64]) {
+    for (int k = 0; k < 8; ++k) {
+        uint64_t v = 0;
+        for (int b = 0; b < 8; ++b) v |= ((q[b] >> (8 * k)) & 0xFF) << (8 * b);
+        store_le64(out + 8 * k, transpose8(v));
+    }
+}
+
+void gf_mul(const Planes a, const Planes b, Planes r) {
+    uint64_t p[15] = {};
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 8; ++j) p[i + j] ^= a[i] & b[j];
+    }
+    // x^8 = x^4 + x^3 + x + 1
+    for (int k = 14; k >= 8; --k) {
+        p[k - 4] ^= p[k];
+        p[k - 5] ^= p[k];
+        p[k - 7] ^= p[k];
+        p[k - 8] ^= p[k];
+    }
+    for (int i = 0; i < 8; ++i) r[i] = p[i];
+}
+
+void gf_square(const Planes a, Planes r) {
+    // Squaring is linear: a_i x^i -> a_i x^2i, then reduce.
+    uint64_t p[15] = {};
+    for (int i = 0; i < 8; ++i) p[2 * i] = a[i];
+    for (int k = 14; k >= 8; --k) {
+        p[k - 4] ^= p[k];
+        p[k - 5] ^= p[k];
+        p[k - 7] ^= p[k];
+        p[k - 8] ^= p[k];
+    }
+    for (int i = 0; i < 8; ++i) r[i] = p[i];
+}
+
+void sub_bytes(Planes q) {
+    // x^254 = x^-1 (and 0 -> 0)
+    uint64_t x2[8], x3[8], x12[8], x15[8], t[8];
+    gf_square(q, x2);
+    gf_mul(x2, q, x3);
+    gf_square(x3, t);
+    gf_square(t, x12);
+    gf_mul(x12, x3, x15);
+    gf_square(x15, t);
+    gf_square(t, t);
+    gf_square(t, t);
+    gf_square(t, t);          // x^240
+    gf_mul(t, x12, t);        // x^252
+    gf_mul(t, x2, t);         // x^254
+
+    constexpr uint8_t c = 0x63;
+    for (int i = 0; i < 8; ++i) {
+        uint64_t v = t[i] ^ t[(i + 4) & 7] ^ t[(i + 5) & 7] ^ t[(i + 6) & 7] ^ t[(i + 7) & 7];
+        q[i] = ((c >> i) & 1) ? ~v : v;
+    }
+}
+
+constexpr uint64_t rep16(uint64_t m) { return m * 0x0001000100010001ULL; }
+
+void shift_rows(Planes q) {
+    // Byte 4c + r of each block moves to column c - r; within each 16-bit
+    // group that is a rotation of row r's bits by 4r.
+    for (int b = 0; b < 8; ++b) {
+        const uint64_t x = q[b];
+        uint64_t out = x & rep16(0x1111);
+        for (int r = 1; r < 4; ++r) {
+            const int s = 4 * r;
+            const uint64_t v = x & (rep16(0x1111) << r);
+            out |= (v >> s) & rep16(0xFFFFu >> s);
+            out |= (v << (16 - s)) & rep16((0xFFFFu << (16 - s)) & 0xFFFFu);
+        }
+        q[b] = out;
+    }
+}
+
+uint64_t rot_rows1(uint64_t x) {
+    return ((x >> 1) & 0x7777777777777777ULL) | ((x << 3) & 0x8888888888888888ULL);
+}
+
+uint64_t rot_rows2(uint64_t x) {
+    return ((x >> 2) & 0x3333333333333333ULL) | ((x << 2) & 0xCCCCCCCCCCCCCCCCULL);
+}
+
+void mix_columns(Planes q) {
+    uint64_t t[8], r1[8];
+    for (int b = 0; b < 8; ++b) {
+        r1[b] = rot_rows1(q[b]);
+        t[b] = q[b] ^ r1[b];
+    }
+    // out_r = 2 * (a_r ^ a_r+1) ^ a_r+1 ^ a_r+2 ^ a_r+3
+    const uint64_t xt[8] = {
+        t[7], t[0] ^ t[7], t[1], t[2] ^ t[7], t[3] ^ t[7], t[4], t[5], t[6]
+    };
+    for (int b = 0; b < 8; ++b) {
+        q[b] = xt[b] ^ r1[b] ^ rot_rows2(t[b]);
+    }
+}
+
+void add_round_key(Planes q, const uint64_t k[8]) {
+    for (int b = 0; b < 8; ++b) q[b] ^= k[b];
+}
+
+void encrypt4(const KeySchedule& ks, const uint8_t in[64], uint8_t out[64]) {
+    uint64_t q[8];
+    bitslice(in, q);
+    add_round_key(q, ks.sliced_keys[0]);
+    for (int r = 1; r < ROUNDS; ++r) {
+        sub_bytes(q);
+        shift_rows(q);
+        mix_columns(q);
+        add_round_key(q, ks.sliced_keys[r]);
+    }
+    sub_bytes(q);
+    shift_rows(q);
+    add_round_key(q, ks.sliced_keys[ROUNDS]);
+    unbitslice(q, out);
+}
+
+void sub_word_bytes(uint8_t* bytes, size_t n) {
+    uint8_t buf[64] = {};
+    std::memcpy(buf, bytes, n);
+    uint64_t q[8];
+    bitslice(buf, q);
+    sub_bytes(q);
+    unbitslice(q, buf);
+    std::memcpy(bytes, buf, n);
+}
+
+// Carry-less 64x64 multiply, low 64 bits, using sparse operands so that
+// integer carries never reach a meaningful bit.
+uint64_t bmul64(uint64_t x, uint64_t y) {
+    const uint64_t m0 = 0x1111111111111111ULL, m1 = m0 << 1, m2 = m0 << 2, m3 = m0 << 3;
+    const uint64_t x0 = x & m0, x1 = x & m1, x2 = x & m2, x3 = x & m3;
+    const uint64_t y0 = y & m0, y1 = y & m1, y2 = y & m2, y3 = y & m3;
+    uint64_t z0 = (x0 * y0) ^ (x1 * y3) ^ (x2 * y2) ^ (x3 * y1);
+    uint64_t z1 = (x0 * y1) ^ (x1 * y0) ^ (x2 * y3) ^ (x3 * y2);
+    uint64_t z2 = (x0 * y2) ^ (x1 * y1) ^ (x2 * y0) ^ (x3 * y3);
+    uint64_t z3 = (x0 * y3) ^ (x1 * y2) ^ (x2 * y1) ^ (x3 * y0);
+    return (z0 & m0) | (z1 & m1) | (z2 & m2) | (z3 & m3);
+}
+
+uint64_t rev64(uint64_t x) {
+    x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+    x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+    x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+    x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+    return (x >> 32) | (x << 32);
+}
+
+void clmul64(uint64_t a, uint64_t b, uint64_t& lo, uint64_t& hi) {
+    lo = bmul64(a, b);
+    hi = rev64(bmul64(rev64(a), rev64(b))) >> 1;
+}
+
+// y <- y * H in GCM's bit-reflected representation (y[0] holds bytes 0..7).
+void ghash_mul(uint64_t y[2], const uint64_t h[2]) {
+    uint64_t l0, l1, h0, h1, m0, m1;
+    clmul64(y[1], h[1], l0, l1);
+    clmul64(y[0], h[0], h0, h1);
+    clmul64(y[0] ^ y[1], h[0] ^ h[1], m0, m1);
+    m0 ^= l0 ^ h0;
+    m1 ^= l1 ^ h1;
+
+    uint64_t z0 = l0, z1 = l1 ^ m0, z2 = h0 ^ m1, z3 = h1;
+    z3 = (z3 << 1) | (z2 >> 63);
+    z2 = (z2 << 1) | (z1 >> 63);
+    z1 = (z1 << 1) | (z0 >> 63);
+    z0 <<= 1;
+
+    z2 ^= z0 ^ (z0 >> 1) ^ (z0 >> 2) ^ (z0 >> 7);
+    z1 ^= (z0 << 63) ^ (z0 << 62) ^ (z0 << 57);
+    z3 ^= z1 ^ (z1 >> 1) ^ (z1 >> 2) ^ (z1 >> 7);
+    z2 ^= (z1 << 63) ^ (z1 << 62) ^ (z1 << 57);
+    y[0] = z3;
+    y[1] = z2;
+}
+
+void ghash_update(uint64_t y[2], const uint64_t h[2], const uint8_t* data, size_t len) {
+    while (len >= 16) {
+        y[0] ^= load_be64(data);
+        y[1] ^= load_be64(data + 8);
+        ghash_mul(y, h);
+        data += 16;
+        len -= 16;
+    }
+    if (len > 0) {
+        uint8_t block[16] = {};
+        std::memcpy(block, data, len);
+        y[0] ^= load_be64(block);
+        y[1] ^= load_be64(block + 8);
+        ghash_mul(y, h);
+    }
+}
+
+void counter_block(const uint8_t nonce[12], uint32_t counter, uint8_t out[16]) {
+    std::memcpy(out, nonce, 12);
+    out[12] = static_cast<uint8_t>(counter >> 24);
+    out[13] = static_cast<uint8_t>(counter >> 16);
+    out[14] = static_cast<uint8_t>(counter >> 8);
+    out[15] = static_cast<uint8_t>(counter);
+}
+
+} // namespace
+
+void expand_key_portable(const uint8_t key[32], KeySchedule& ks) {
+    uint8_t w[60][4];
+    std::memcpy(w, key, 32);
+    uint8_t rcon = 0x01;
+    for (int i = 8; i < 60; ++i) {
+        uint8_t t[4] = {w[i - 1][0], w[i - 1][1], w[i - 1][2], w[i - 1][3]};
+        if (i % 8 == 0) {
+            const uint8_t first = t[0];
+            t[0] = t[1];
+            t[1] = t[2];
+            t[2] = t[3];
+            t[3] = first;
+            sub_word_bytes(t, 4);
+            t[0] ^= rcon;
+            rcon = static_cast<uint8_t>((rcon << 1) ^ ((rcon >> 7) * 0x1B));
+        } else if (i % 8 == 4) {
+            sub_word_bytes(t, 4);
+        }
+        for (int j = 0; j < 4; ++j) w[i][j] = w[i - 8][j] ^ t[j];
+    }
+    std::memcpy(ks.round_keys, w, sizeof(ks.round_keys));
+
+    for (int r = 0; r <= ROUNDS; ++r) {
+        uint8_t wide[64];
+        for (int blk = 0; blk < 4; ++blk) std::memcpy(wide + 16 * blk, ks.round_keys[r], 16);
+        bitslice(wide, ks.sliced_keys[r]);
+    }
+
+    uint8_t zero[64] = {}, hblocks[64];
+    encrypt4(ks, zero, hblocks);
+    ks.h[0] = load_be64(hblocks);
+    ks.h[1] = load_be64(hblocks + 8);
+}
+
+void crypt_portable(const KeySchedule& ks, const uint8_t nonce[12],
+                    const uint8_t* aad, size_t aad_len,
+                    const uint8_t* in, uint8_t* out, size_t len,
+                    bool decrypt, uint8_t tag[16]) {
+    uint64_t y[2] = {0, 0};
+    ghash_update(y, ks.h, aad, aad_len);
+    if (decrypt) ghash_update(y, ks.h, in, len);
+
+    uint32_t counter = 2;
+    uint8_t ctr[64], stream[64];
+    size_t offset = 0;
+    while (offset < len) {
+        for (int blk = 0; blk < 4; ++blk) counter_block(nonce, counter + blk, ctr + 16 * blk);
+        counter += 4;
+        encrypt4(ks, ctr, stream);
+        const size_t n = (len - offset < 64) ? len - offset : 64;
+        for (size_t i = 0; i < n; ++i) out[offset + i] = in[offset + i] ^ stream[i];
+        offset += n;
+    }
+
+    if (!decrypt) ghash_update(y, ks.h, out, len);
+
+    y[0] ^= static_cast<uint64_t>(aad_len) * 8;
+    y[1] ^= static_cast<uint64_t>(len) * 8;
+    ghash_mul(y, ks.h);
+
+    uint8_t j0[64] = {};
+    counter_block(nonce, 1, j0);
+    encrypt4(ks, j0, stream);
+    store_be64(tag, y[0]);
+    store_be64(tag + 8, y[1]);
+    for (int i = 0; i < 16; ++i) tag[i] ^= stream[i];
+}
+
+} // namespace aes_gcm
+} // namespace Crypto
@@ -0,0 +1,70 @@
+#include "aes_gcm_kernels.h"
+
+// Multi-buffer AES-256-GCM on 512-bit VAES/VPCLMULQDQ: four messages per
+// register, sixteen in flight. Built with -mavx512f -mavx512bw -mvaes
+// -mvpclmulqdq on top of the AES-NI flags; only reached after CipherEngine
+// has confirmed CPU and OS support for ZMM state.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// GCC 12's AVX-512 intrinsics seed their pass-through operand with
+// _mm512_undefined_epi32(), which trips -Wmaybe-uninitialized once inlined
+// (GCC bug 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include "aes_gcm_batch.h"
+
+namespace Crypto {
+namespace aes_gcm {
+
+namespace {
+
+struct Zmm {
+    using V = __m512i;
+    static constexpr int W = 4;
+    static constexpr int R = 4;
+    static V load(const uint8_t* p) { return _mm512_load_si512(p); }
+    static void store(uint8_t* p, V v) { _mm512_store_si512(p, v); }
+    static V gather(const uint8_t* const p[W]) {
+        const __m256i lo = _mm256_loadu2_m128i(reinterpret_cast<const __m128i*>(p[1]),
+                                               reinterpret_cast<const __m128i*>(p[0]));
+        const __m256i hi = _mm256_loadu2_m128i(reinterpret_cast<const __m128i*>(p[3]),
+                                               reinterpret_cast<const __m128i*>(p[2]));
+        return _mm512_inserti64x4(_mm512_castsi256_si512(lo), hi, 1);
+    }
+    static void scatter(uint8_t* const p[W], V v) {
+        const __m256i hi = _mm512_extracti64x4_epi64(v, 1);
+        _mm256_storeu2_m128i(reinterpret_cast<__m128i*>(p[1]), reinterpret_cast<__m128i*>(p[0]),
+                             _mm512_castsi512_si256(v));
+        _mm256_storeu2_m128i(reinterpret_cast<__m128i*>(p[3]), reinterpret_cast<__m128i*>(p[2]), hi);
+    }
+    static V zero() { return _mm512_setzero_si512(); }
+    static V broadcast(__m128i v) { return _mm512_broadcast_i32x4(v); }
+    static V bxor(V a, V b) { return _mm512_xor_si512(a, b); }
+    static V band(V a, V b) { return _mm512_and_si512(a, b); }
+    static V bor(V a, V b) { return _mm512_or_si512(a, b); }
+    static V bandnot(V a, V b) { return _mm512_andnot_si512(a, b); }
+    static V shuffle(V a, V m) { return _mm512_shuffle_epi8(a, m); }
+    static V add32(V a, V b) { return _mm512_add_epi32(a, b); }
+    static V aesenc(V a, V k) { return _mm512_aesenc_epi128(a, k); }
+    static V aesenclast(V a, V k) { return _mm512_aesenclast_epi128(a, k); }
+    template <int N> static V slli32(V a) { return _mm512_slli_epi32(a, N); }
+    template <int N> static V srli32(V a) { return _mm512_srli_epi32(a, N); }
+    template <int N> static V bslli(V a) { return _mm512_bslli_epi128(a, N); }
+    template <int N> static V bsrli(V a) { return _mm512_bsrli_epi128(a, N); }
+    template <int I> static V clmul(V a, V b) { return _mm512_clmulepi64_epi128(a, b, I); }
+};
+
+} // namespace
+
+void crypt_batch_vaes512(const BatchLane* lanes, size_t count, bool decrypt) {
+    batch::crypt<Zmm>(lanes, count, decrypt);
+}
+
+} // namespace aes_gcm
+} // namespace Crypto
+
+#endif
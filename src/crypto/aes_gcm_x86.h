@@ -0,0 +1,197 @@
+#ifndef AES_GCM_X86_H
+#define AES_GCM_X86_H
+
+// 128-bit AES-NI/PCLMULQDQ building blocks shared by the x86 AES-GCM
+// backends. Only include from translation units built with -maes -mpclmul
+// -mssse3 (or wider).
+
+#include "aes_gcm_kernels.h"
+
+#include <immintrin.h>
+#include <cstring>
+
+namespace Crypto {
+namespace aes_gcm {
+namespace x86 {
+
+inline __m128i bswap_mask() {
+    return _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+}
+
+inline void load_round_keys(const KeySchedule& ks, __m128i rk[ROUNDS + 1]) {
+    for (int r = 0; r <= ROUNDS; ++r) {
+        rk[r] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ks.round_keys[r]));
+    }
+}
+
+inline __m128i load_h_power(const KeySchedule& ks, int power) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ks.h_powers[power - 1]));
+}
+
+inline __m128i encrypt_block(const __m128i rk[ROUNDS + 1], __m128i b) {
+    b = _mm_xor_si128(b, rk[0]);
+    for (int r = 1; r < ROUNDS; ++r) b = _mm_aesenc_si128(b, rk[r]);
+    return _mm_aesenclast_si128(b, rk[ROUNDS]);
+}
+
+// Unreduced 128x128 carry-less product accumulated into (lo, mid, hi).
+inline void clmul_acc(__m128i a, __m128i b, __m128i& lo, __m128i& mid, __m128i& hi) {
+    lo = _mm_xor_si128(lo, _mm_clmulepi64_si128(a, b, 0x00));
+    hi = _mm_xor_si128(hi, _mm_clmulepi64_si128(a, b, 0x11));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x10));
+    mid = _mm_xor_si128(mid, _mm_clmulepi64_si128(a, b, 0x01));
+}
+
+// Reduces a 256-bit product of byte-reflected operands modulo the GCM
+// polynomial (Intel's shift-left-by-one formulation).
+inline __m128i ghash_reduce(__m128i lo, __m128i mid, __m128i hi) {
+    lo = _mm_xor_si128(lo, _mm_slli_si128(mid, 8));
+    hi = _mm_xor_si128(hi, _mm_srli_si128(mid, 8));
+
+    __m128i lo_carry = _mm_srli_epi32(lo, 31);
+    __m128i hi_carry = _mm_srli_epi32(hi, 31);
+    lo = _mm_slli_epi32(lo, 1);
+    hi = _mm_slli_epi32(hi, 1);
+    const __m128i cross = _mm_srli_si128(lo_carry, 12);
+    hi_carry = _mm_slli_si128(hi_carry, 4);
+    lo_carry = _mm_slli_si128(lo_carry, 4);
+    lo = _mm_or_si128(lo, lo_carry);
+    hi = _mm_or_si128(hi, hi_carry);
+    hi = _mm_or_si128(hi, cross);
+
+    __m128i a = _mm_slli_epi32(lo, 31);
+    __m128i b = _mm_slli_epi32(lo, 30);
+    const __m128i c = _mm_slli_epi32(lo, 25);
+    a = _mm_xor_si128(a, _mm_xor_si128(b, c));
+    b = _mm_srli_si128(a, 4);
+    a = _mm_slli_si128(a, 12);
+    lo = _mm_xor_si128(lo, a);
+
+    __m128i d = _mm_srli_epi32(lo, 1);
+    d = _mm_xor_si128(d, _mm_srli_epi32(lo, 2));
+    d = _mm_xor_si128(d, _mm_srli_epi32(lo, 7));
+    d = _mm_xor_si128(d, b);
+    lo = _mm_xor_si128(lo, d);
+    return _mm_xor_si128(hi, lo);
+}
+
+inline __m128i gf_mul(__m128i a, __m128i b) {
+    __m128i lo = _mm_setzero_si128(), mid = lo, hi = lo;
+    clmul_acc(a, b, lo, mid, hi);
+    return ghash_reduce(lo, mid, hi);
+}
+
+inline __m128i load_partial(const uint8_t* p, size_t n) {
+    alignas(16) uint8_t buf[16] = {};
+    std::memcpy(buf, p, n);
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+}
+
+inline void store_partial(uint8_t* p, __m128i v, size_t n) {
+    alignas(16) uint8_t buf[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(buf), v);
+    std::memcpy(p, buf, n);
+}
+
+inline __m128i ghash_bytes(__m128i x, __m128i h, const uint8_t* data, size_t len) {
+    const __m128i bswap = bswap_mask();
+    while (len >= 16) {
+        const __m128i b = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), bswap);
+        x = gf_mul(_mm_xor_si128(x, b), h);
+        data += 16;
+        len -= 16;
+    }
+    if (len > 0) {
+        x = gf_mul(_mm_xor_si128(x, _mm_shuffle_epi8(load_partial(data, len), bswap)), h);
+    }
+    return x;
+}
+
+// Per-message GCM state: J0, the byte-reversed running counter (the 32-bit
+// big-endian counter sits in lane 0, so _mm_add_epi32 implements inc32) and
+// the reflected GHASH accumulator.
+struct State {
+    __m128i j0;
+    __m128i ctr;
+    __m128i x;
+};
+
+inline State begin(const KeySchedule& ks, const uint8_t nonce[12], const uint8_t* aad, size_t aad_len) {
+    alignas(16) uint8_t j0_bytes[16];
+    std::memcpy(j0_bytes, nonce, 12);
+    j0_bytes[12] = 0;
+    j0_bytes[13] = 0;
+    j0_bytes[14] = 0;
+    j0_bytes[15] = 1;
+    State st;
+    st.j0 = _mm_load_si128(reinterpret_cast<const __m128i*>(j0_bytes));
+    st.ctr = _mm_add_epi32(_mm_shuffle_epi8(st.j0, bswap_mask()), _mm_set_epi32(0, 0, 0, 1));
+    st.x = ghash_bytes(_mm_setzero_si128(), load_h_power(ks, 1), aad, aad_len);
+    return st;
+}
+
+// Eight blocks per iteration with one GHASH reduction; returns bytes done.
+inline size_t crypt_blocks8(const __m128i rk[ROUNDS + 1], const KeySchedule& ks, State& st,
+                            const uint8_t* in, uint8_t* out, size_t len, bool decrypt) {
+    const __m128i bswap = bswap_mask();
+    __m128i hp[8];
+    for (int k = 0; k < 8; ++k) hp[k] = load_h_power(ks, 8 - k);
+
+    size_t i = 0;
+    for (; i + 128 <= len; i += 128) {
+        __m128i b[8];
+        for (int k = 0; k < 8; ++k) {
+            b[k] = _mm_xor_si128(_mm_shuffle_epi8(_mm_add_epi32(st.ctr, _mm_set_epi32(0, 0, 0, k)), bswap), rk[0]);
+        }
+        st.ctr = _mm_add_epi32(st.ctr, _mm_set_epi32(0, 0, 0, 8));
+        for (int r = 1; r < ROUNDS; ++r) {
+            for (int k = 0; k < 8; ++k) b[k] = _mm_aesenc_si128(b[k], rk[r]);
+        }
+
+        __m128i lo = _mm_setzero_si128(), mid = lo, hi = lo;
+        for (int k = 0; k < 8; ++k) {
+            const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16 * k));
+            const __m128i dst = _mm_xor_si128(_mm_aesenclast_si128(b[k], rk[ROUNDS]), src);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i + 16 * k), dst);
+            __m128i c = _mm_shuffle_epi8(decrypt ? src : dst, bswap);
+            if (k == 0) c = _mm_xor_si128(c, st.x);
+            clmul_acc(c, hp[k], lo, mid, hi);
+        }
+        st.x = ghash_reduce(lo, mid, hi);
+    }
+    return i;
+}
+
+// Remaining blocks one at a time, then the length block and the tag.
+inline void finish(const __m128i rk[ROUNDS + 1], const KeySchedule& ks, State& st,
+                   const uint8_t* in, uint8_t* out, size_t len, bool decrypt,
+                   size_t aad_len, size_t total_len, uint8_t tag[16]) {
+    const __m128i bswap = bswap_mask();
+    const __m128i h = load_h_power(ks, 1);
+    for (size_t i = 0; i < len; i += 16) {
+        const size_t n = (len - i < 16) ? len - i : 16;
+        const __m128i stream = encrypt_block(rk, _mm_shuffle_epi8(st.ctr, bswap));
+        st.ctr = _mm_add_epi32(st.ctr, _mm_set_epi32(0, 0, 0, 1));
+        const __m128i src = load_partial(in + i, n);
+        __m128i dst = _mm_xor_si128(stream, src);
+        store_partial(out + i, dst, n);
+        if (n < 16) {
+            // GHASH must see C || 0*, not the keystream past the tail.
+            dst = load_partial(out + i, n);
+        }
+        const __m128i c = _mm_shuffle_epi8(decrypt ? src : dst, bswap);
+        st.x = gf_mul(_mm_xor_si128(st.x, c), h);
+    }
+
+    const __m128i lengths = _mm_set_epi64x(static_cast<long long>(aad_len) * 8,
+                                           static_cast<long long>(total_len) * 8);
+    st.x = gf_mul(_mm_xor_si128(st.x, lengths), h);
+    const __m128i t = _mm_xor_si128(_mm_shuffle_epi8(st.x, bswap), encrypt_block(rk, st.j0));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(tag), t);
+}
+
+} // namespace x86
+} // namespace aes_gcm
+} // namespace Crypto
+
+#endif // AES_GCM_X86_H
@@ -1,4 +1,5 @@
 #include "attribute_based_encryption.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -8,8 +9,8 @@ AttributeBasedEncryption::~AttributeBasedEncryption() {}
 
 ABEKeyPair AttributeBasedEncryption::generate_keys(const std::vector<std::string>& attributes) {
     ABEKeyPair key_pair;
-    key_pair.public_parameters = "abe_pk_" + std::to_string(rand() % 1000000);
-    key_pair.master_secret_key = "abe_msk_" + std::to_string(rand() % 1000000);
+    key_pair.public_parameters = "abe_pk_" + std::to_string(SecureRandom::uniform(1000000));
+    key_pair.master_secret_key = "abe_msk_" + std::to_string(SecureRandom::uniform(1000000));
     key_pair.attributes = attributes;
     
     std::cout << "[*] Generating ABE key pair with " << attributes.size() << " attributes..." << std::endl;
@@ -22,7 +23,7 @@ ABEKeyPair AttributeBasedEncryption::generate_keys(const std::vector<std::string
 ABEPrivateKey AttributeBasedEncryption::derive_user_key(const ABEKeyPair& master_key,
                                                          const std::set<std::string>& user_attributes) {
     ABEPrivateKey private_key;
-    private_key.key_id = "abe_sk_" + std::to_string(rand() % 1000000);
+    private_key.key_id = "abe_sk_" + std::to_string(SecureRandom::uniform(1000000));
     private_key.attributes = user_attributes;
     private_key.key_material = {0xAA, 0xBB, 0xCC, 0xDD};
     
@@ -36,7 +37,7 @@ ABECiphertext AttributeBasedEncryption::encrypt(const std::vector<uint8_t>& plai
     ABECiphertext ciphertext;
     ciphertext.encrypted_data = plaintext;
     ciphertext.encryption_policy = access_policy;
-    ciphertext.ciphertext_id = "abe_ct_" + std::to_string(rand() % 1000000);
+    ciphertext.ciphertext_id = "abe_ct_" + std::to_string(SecureRandom::uniform(1000000));
     
     std::cout << "[*] Encrypting with access policy: " << access_policy << std::endl;
     
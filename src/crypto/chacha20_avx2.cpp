@@ -0,0 +1,203 @@
+#include "chacha20_kernels.h"
+
+// AVX2 backend: ChaCha20 eight blocks at a time with one state word per
+// ymm register (lane i = block counter + i), and Poly1305 with four
+// accumulators in 64-bit lanes multiplied by r^4. Built with -mavx2; only
+// reached after ChaCha20Poly1305 has confirmed CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace chacha {
+
+namespace {
+
+template <int N>
+inline __m256i rotl(__m256i v) {
+    if constexpr (N == 16) {
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                       2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13));
+    } else if constexpr (N == 8) {
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14,
+                                                       3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14));
+    } else {
+        return _mm256_or_si256(_mm256_slli_epi32(v, N), _mm256_srli_epi32(v, 32 - N));
+    }
+}
+
+inline void quarter_round(__m256i& a, __m256i& b, __m256i& c, __m256i& d) {
+    a = _mm256_add_epi32(a, b); d = rotl<16>(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d); b = rotl<12>(_mm256_xor_si256(b, c));
+    a = _mm256_add_epi32(a, b); d = rotl<8>(_mm256_xor_si256(d, a));
+    c = _mm256_add_epi32(c, d); b = rotl<7>(_mm256_xor_si256(b, c));
+}
+
+// 512 bytes of keystream for blocks s[12] .. s[12] + 7, XORed into dst
+// from src (or stored raw when src is null).
+void blocks8(const __m256i s[16], const uint8_t* src, uint8_t* dst) {
+    __m256i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = s[i];
+    for (int i = 0; i < 10; ++i) {
+        quarter_round(x[0], x[4], x[8], x[12]);
+        quarter_round(x[1], x[5], x[9], x[13]);
+        quarter_round(x[2], x[6], x[10], x[14]);
+        quarter_round(x[3], x[7], x[11], x[15]);
+        quarter_round(x[0], x[5], x[10], x[15]);
+        quarter_round(x[1], x[6], x[11], x[12]);
+        quarter_round(x[2], x[7], x[8], x[13]);
+        quarter_round(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = _mm256_add_epi32(x[i], s[i]);
+
+    // Two 8x8 transposes of 32-bit words turn "word w of blocks 0..7" into
+    // "words 0..7 / 8..15 of block b".
+    for (int half = 0; half < 2; ++half) {
+        const __m256i* w = x + 8 * half;
+        const __m256i t0 = _mm256_unpacklo_epi32(w[0], w[1]);
+        const __m256i t1 = _mm256_unpackhi_epi32(w[0], w[1]);
+        const __m256i t2 = _mm256_unpacklo_epi32(w[2], w[3]);
+        const __m256i t3 = _mm256_unpackhi_epi32(w[2], w[3]);
+        const __m256i t4 = _mm256_unpacklo_epi32(w[4], w[5]);
+        const __m256i t5 = _mm256_unpackhi_epi32(w[4], w[5]);
+        const __m256i t6 = _mm256_unpacklo_epi32(w[6], w[7]);
+        const __m256i t7 = _mm256_unpackhi_epi32(w[6], w[7]);
+        const __m256i lo[4] = {_mm256_unpacklo_epi64(t0, t2), _mm256_unpackhi_epi64(t0, t2),
+                               _mm256_unpacklo_epi64(t1, t3), _mm256_unpackhi_epi64(t1, t3)};
+        const __m256i hi[4] = {_mm256_unpacklo_epi64(t4, t6), _mm256_unpackhi_epi64(t4, t6),
+                               _mm256_unpacklo_epi64(t5, t7), _mm256_unpackhi_epi64(t5, t7)};
+        for (int k = 0; k < 4; ++k) {
+            const __m256i rows[2] = {_mm256_permute2x128_si256(lo[k], hi[k], 0x20),
+                                     _mm256_permute2x128_si256(lo[k], hi[k], 0x31)};
+            for (int j = 0; j < 2; ++j) {
+                const size_t off = 64 * (k + 4 * j) + 32 * half;
+                __m256i v = rows[j];
+                if (src) v = _mm256_xor_si256(v, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + off)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + off), v);
+            }
+        }
+    }
+}
+
+// --- Poly1305 ---------------------------------------------------------------
+
+struct Limbs {
+    __m256i v[5];
+};
+
+// h * r for four independent accumulators; s holds 5 * r[1..4].
+inline void mul(Limbs& h, const Limbs& r, const Limbs& s) {
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    const __m256i* a = h.v;
+    auto m = [](__m256i x, __m256i y) { return _mm256_mul_epu32(x, y); };
+    auto add = [](__m256i x, __m256i y) { return _mm256_add_epi64(x, y); };
+    __m256i d0 = add(add(add(add(m(a[0], r.v[0]), m(a[1], s.v[4])), m(a[2], s.v[3])), m(a[3], s.v[2])), m(a[4], s.v[1]));
+    __m256i d1 = add(add(add(add(m(a[0], r.v[1]), m(a[1], r.v[0])), m(a[2], s.v[4])), m(a[3], s.v[3])), m(a[4], s.v[2]));
+    __m256i d2 = add(add(add(add(m(a[0], r.v[2]), m(a[1], r.v[1])), m(a[2], r.v[0])), m(a[3], s.v[4])), m(a[4], s.v[3]));
+    __m256i d3 = add(add(add(add(m(a[0], r.v[3]), m(a[1], r.v[2])), m(a[2], r.v[1])), m(a[3], r.v[0])), m(a[4], s.v[4]));
+    __m256i d4 = add(add(add(add(m(a[0], r.v[4]), m(a[1], r.v[3])), m(a[2], r.v[2])), m(a[3], r.v[1])), m(a[4], r.v[0]));
+
+    d1 = add(d1, _mm256_srli_epi64(d0, 26)); d0 = _mm256_and_si256(d0, mask);
+    d2 = add(d2, _mm256_srli_epi64(d1, 26)); d1 = _mm256_and_si256(d1, mask);
+    d3 = add(d3, _mm256_srli_epi64(d2, 26)); d2 = _mm256_and_si256(d2, mask);
+    d4 = add(d4, _mm256_srli_epi64(d3, 26)); d3 = _mm256_and_si256(d3, mask);
+    const __m256i c = _mm256_srli_epi64(d4, 26);
+    d4 = _mm256_and_si256(d4, mask);
+    d0 = add(d0, add(c, _mm256_slli_epi64(c, 2)));
+    d1 = add(d1, _mm256_srli_epi64(d0, 26)); d0 = _mm256_and_si256(d0, mask);
+    h.v[0] = d0; h.v[1] = d1; h.v[2] = d2; h.v[3] = d3; h.v[4] = d4;
+}
+
+// Blocks j of a 64-byte chunk split into limbs, block j in 64-bit lane j.
+inline void add_chunk(Limbs& h, const uint8_t* m) {
+    const __m256i mask = _mm256_set1_epi64x(0x3ffffff);
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m));
+    const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m + 32));
+    // unpack yields block order 0, 2, 1, 3; permute restores 0, 1, 2, 3.
+    const __m256i lo = _mm256_permute4x64_epi64(_mm256_unpacklo_epi64(a, b), 0xD8);
+    const __m256i hi = _mm256_permute4x64_epi64(_mm256_unpackhi_epi64(a, b), 0xD8);
+    h.v[0] = _mm256_add_epi64(h.v[0], _mm256_and_si256(lo, mask));
+    h.v[1] = _mm256_add_epi64(h.v[1], _mm256_and_si256(_mm256_srli_epi64(lo, 26), mask));
+    h.v[2] = _mm256_add_epi64(h.v[2], _mm256_and_si256(
+        _mm256_or_si256(_mm256_srli_epi64(lo, 52), _mm256_slli_epi64(hi, 12)), mask));
+    h.v[3] = _mm256_add_epi64(h.v[3], _mm256_and_si256(_mm256_srli_epi64(hi, 14), mask));
+    h.v[4] = _mm256_add_epi64(h.v[4], _mm256_or_si256(_mm256_srli_epi64(hi, 40), _mm256_set1_epi64x(1 << 24)));
+}
+
+inline void set_powers(Limbs& r, Limbs& s, const uint32_t* const lane_powers[4]) {
+    for (int i = 0; i < 5; ++i) {
+        r.v[i] = _mm256_setr_epi64x(lane_powers[0][i], lane_powers[1][i], lane_powers[2][i], lane_powers[3][i]);
+        s.v[i] = _mm256_add_epi64(r.v[i], _mm256_slli_epi64(r.v[i], 2));
+    }
+}
+
+} // namespace
+
+void xor_avx2(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+              const uint8_t* in, uint8_t* out, size_t len) {
+    __m256i s[16];
+    for (int i = 0; i < 4; ++i) s[i] = _mm256_set1_epi32(static_cast<int>(SIGMA[i]));
+    for (int i = 0; i < 8; ++i) s[4 + i] = _mm256_set1_epi32(static_cast<int>(load_le32(key + 4 * i)));
+    s[12] = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(counter)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    for (int i = 0; i < 3; ++i) s[13 + i] = _mm256_set1_epi32(static_cast<int>(load_le32(nonce + 4 * i)));
+    const __m256i step = _mm256_set1_epi32(8);
+
+    for (; len >= 512; in += 512, out += 512, len -= 512) {
+        blocks8(s, in, out);
+        s[12] = _mm256_add_epi32(s[12], step);
+    }
+    if (len > 0) {
+        alignas(32) uint8_t stream[512];
+        blocks8(s, nullptr, stream);
+        for (size_t i = 0; i < len; ++i) out[i] = in[i] ^ stream[i];
+    }
+}
+
+size_t poly1305_blocks_avx2(Poly1305& st, const uint8_t* m, size_t len) {
+    const size_t chunks = len / 64;
+    if (chunks < 4) return 0;
+
+    uint32_t pow[4][5];  // r^1 .. r^4
+    for (int i = 0; i < 5; ++i) pow[0][i] = st.r[i];
+    poly1305_mul(pow[1], pow[0], st.r);
+    poly1305_mul(pow[2], pow[1], st.r);
+    poly1305_mul(pow[3], pow[2], st.r);
+
+    const uint32_t* const r4[4] = {pow[3], pow[3], pow[3], pow[3]};
+    // Final step: lane j holds blocks 4i + j and still owes r^(4 - j).
+    const uint32_t* const tail[4] = {pow[3], pow[2], pow[1], pow[0]};
+    Limbs r, s;
+    set_powers(r, s, r4);
+
+    Limbs h;
+    for (int i = 0; i < 5; ++i) h.v[i] = _mm256_setr_epi64x(st.h[i], 0, 0, 0);
+    for (size_t c = 0; c + 1 < chunks; ++c, m += 64) {
+        add_chunk(h, m);
+        mul(h, r, s);
+    }
+    add_chunk(h, m);
+    set_powers(r, s, tail);
+    mul(h, r, s);
+
+    // Sum the lanes and carry back into the scalar state.
+    uint64_t sum[5];
+    for (int i = 0; i < 5; ++i) {
+        alignas(32) uint64_t lanes[4];
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), h.v[i]);
+        sum[i] = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+    sum[1] += sum[0] >> 26; sum[0] &= 0x3ffffff;
+    sum[2] += sum[1] >> 26; sum[1] &= 0x3ffffff;
+    sum[3] += sum[2] >> 26; sum[2] &= 0x3ffffff;
+    sum[4] += sum[3] >> 26; sum[3] &= 0x3ffffff;
+    sum[0] += (sum[4] >> 26) * 5; sum[4] &= 0x3ffffff;
+    sum[1] += sum[0] >> 26; sum[0] &= 0x3ffffff;
+    for (int i = 0; i < 5; ++i) st.h[i] = static_cast<uint32_t>(sum[i]);
+    return chunks * 64;
+}
+
+} // namespace chacha
+} // namespace Crypto
+
+#endif
@@ -0,0 +1,112 @@
+#include "chacha20_kernels.h"
+
+// AVX-512 ChaCha20: sixteen blocks per iteration, one state word per zmm
+// register, rotations with VPROLD. Built with -mavx512f on top of -mavx2;
+// only reached after ChaCha20Poly1305 has confirmed CPU and OS support for
+// ZMM state. Poly1305 stays on the AVX2 path.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+// See aes_gcm_vaes512.cpp: GCC 12 AVX-512 intrinsics trip
+// -Wmaybe-uninitialized through _mm512_undefined_epi32() (GCC bug 105593).
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace chacha {
+
+namespace {
+
+inline void quarter_round(__m512i& a, __m512i& b, __m512i& c, __m512i& d) {
+    a = _mm512_add_epi32(a, b); d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 16);
+    c = _mm512_add_epi32(c, d); b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 12);
+    a = _mm512_add_epi32(a, b); d = _mm512_rol_epi32(_mm512_xor_si512(d, a), 8);
+    c = _mm512_add_epi32(c, d); b = _mm512_rol_epi32(_mm512_xor_si512(b, c), 7);
+}
+
+// 1024 bytes of keystream for blocks s[12] .. s[12] + 15, XORed into dst
+// from src (or stored raw when src is null).
+void blocks16(const __m512i s[16], const uint8_t* src, uint8_t* dst) {
+    __m512i x[16];
+    for (int i = 0; i < 16; ++i) x[i] = s[i];
+    for (int i = 0; i < 10; ++i) {
+        quarter_round(x[0], x[4], x[8], x[12]);
+        quarter_round(x[1], x[5], x[9], x[13]);
+        quarter_round(x[2], x[6], x[10], x[14]);
+        quarter_round(x[3], x[7], x[11], x[15]);
+        quarter_round(x[0], x[5], x[10], x[15]);
+        quarter_round(x[1], x[6], x[11], x[12]);
+        quarter_round(x[2], x[7], x[8], x[13]);
+        quarter_round(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) x[i] = _mm512_add_epi32(x[i], s[i]);
+
+    // 4x4 transpose of words inside each 128-bit lane: a[g][k] lane L then
+    // holds words 4g .. 4g+3 of block 4L + k.
+    __m512i a[4][4];
+    for (int g = 0; g < 4; ++g) {
+        const __m512i* w = x + 4 * g;
+        const __m512i t0 = _mm512_unpacklo_epi32(w[0], w[1]);
+        const __m512i t1 = _mm512_unpackhi_epi32(w[0], w[1]);
+        const __m512i t2 = _mm512_unpacklo_epi32(w[2], w[3]);
+        const __m512i t3 = _mm512_unpackhi_epi32(w[2], w[3]);
+        a[g][0] = _mm512_unpacklo_epi64(t0, t2);
+        a[g][1] = _mm512_unpackhi_epi64(t0, t2);
+        a[g][2] = _mm512_unpacklo_epi64(t1, t3);
+        a[g][3] = _mm512_unpackhi_epi64(t1, t3);
+    }
+
+    // 4x4 transpose of 128-bit lanes gathers the four groups of one block.
+    for (int k = 0; k < 4; ++k) {
+        const __m512i p0 = _mm512_shuffle_i32x4(a[0][k], a[1][k], 0x44);
+        const __m512i p1 = _mm512_shuffle_i32x4(a[0][k], a[1][k], 0xEE);
+        const __m512i p2 = _mm512_shuffle_i32x4(a[2][k], a[3][k], 0x44);
+        const __m512i p3 = _mm512_shuffle_i32x4(a[2][k], a[3][k], 0xEE);
+        const __m512i rows[4] = {_mm512_shuffle_i32x4(p0, p2, 0x88), _mm512_shuffle_i32x4(p0, p2, 0xDD),
+                                 _mm512_shuffle_i32x4(p1, p3, 0x88), _mm512_shuffle_i32x4(p1, p3, 0xDD)};
+        for (int lane = 0; lane < 4; ++lane) {
+            const size_t off = 64 * (4 * lane + k);
+            __m512i v = rows[lane];
+            if (src) v = _mm512_xor_si512(v, _mm512_loadu_si512(src + off));
+            _mm512_storeu_si512(dst + off, v);
+        }
+    }
+}
+
+} // namespace
+
+void xor_avx512(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+                const uint8_t* in, uint8_t* out, size_t len) {
+    __m512i s[16];
+    for (int i = 0; i < 4; ++i) s[i] = _mm512_set1_epi32(static_cast<int>(SIGMA[i]));
+    for (int i = 0; i < 8; ++i) s[4 + i] = _mm512_set1_epi32(static_cast<int>(load_le32(key + 4 * i)));
+    s[12] = _mm512_add_epi32(_mm512_set1_epi32(static_cast<int>(counter)),
+                             _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    for (int i = 0; i < 3; ++i) s[13 + i] = _mm512_set1_epi32(static_cast<int>(load_le32(nonce + 4 * i)));
+    const __m512i step = _mm512_set1_epi32(16);
+
+    for (; len >= 1024; in += 1024, out += 1024, len -= 1024) {
+        blocks16(s, in, out);
+        s[12] = _mm512_add_epi32(s[12], step);
+    }
+    if (len > 0) {
+        // Short frames and tails: the 8-block kernel wastes less keystream.
+        const uint32_t next = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm512_castsi512_si128(s[12])));
+        if (len <= 512) {
+            xor_avx2(key, nonce, next, in, out, len);
+            return;
+        }
+        alignas(64) uint8_t stream[1024];
+        blocks16(s, nullptr, stream);
+        for (size_t i = 0; i < len; ++i) out[i] = in[i] ^ stream[i];
+    }
+}
+
+} // namespace chacha
+} // namespace Crypto
+
+#endif
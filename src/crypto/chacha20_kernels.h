@@ -0,0 +1,63 @@
+#ifndef CHACHA20_KERNELS_H
+#define CHACHA20_KERNELS_H
+
+// Internal interface between ChaCha20Poly1305 and its backends: ChaCha20
+// keystream XOR (RFC 8439, 32-bit block counter) and Poly1305 in 26-bit
+// limbs, so that the scalar and the 4-way AVX2 code share one state.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Crypto {
+namespace chacha {
+
+constexpr uint32_t SIGMA[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+
+inline uint32_t load_le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline void store_le32(uint8_t* p, uint32_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+    p[2] = static_cast<uint8_t>(v >> 16);
+    p[3] = static_cast<uint8_t>(v >> 24);
+}
+
+// out = in ^ ChaCha20(key, nonce) starting at block `counter`; in and out
+// may alias.
+using XorFn = void (*)(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+                       const uint8_t* in, uint8_t* out, size_t len);
+
+void xor_portable(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+                  const uint8_t* in, uint8_t* out, size_t len);
+
+// Available when compiled for x86-64; callers must check CPU support first.
+// 8 blocks per iteration in ymm registers / 16 in zmm registers.
+void xor_avx2(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+              const uint8_t* in, uint8_t* out, size_t len);
+void xor_avx512(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+                const uint8_t* in, uint8_t* out, size_t len);
+
+struct Poly1305 {
+    uint32_t r[5];
+    uint32_t h[5];
+    uint32_t pad[4];
+};
+
+void poly1305_init(Poly1305& st, const uint8_t key[32]);
+// Whole 16-byte blocks only.
+void poly1305_blocks(Poly1305& st, const uint8_t* m, size_t len);
+void poly1305_finish(Poly1305& st, uint8_t tag[16]);
+// h = a * b mod 2^130 - 5 on 26-bit limbs (inputs below 2^27); h may alias a.
+void poly1305_mul(uint32_t h[5], const uint32_t a[5], const uint32_t b[5]);
+
+// Four interleaved accumulators over r^4; consumes whole 64-byte chunks and
+// returns the number of bytes absorbed (0 for inputs too short to pay off).
+size_t poly1305_blocks_avx2(Poly1305& st, const uint8_t* m, size_t len);
+
+} // namespace chacha
+} // namespace Crypto
+
+#endif // CHACHA20_KERNELS_H
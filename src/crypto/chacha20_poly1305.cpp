@@ -0,0 +1,171 @@
+#include "chacha20_poly1305.h"
+#include "cpu_features.h"
+#include "chacha20_kernels.h"
+#include "kernel_table.h"
+#include "secure_random.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace Crypto {
+
+namespace {
+
+chacha::XorFn xor_for(ChaCha20Poly1305::Backend backend) {
+    switch (backend) {
+#if defined(__x86_64__) || defined(_M_X64)
+    case ChaCha20Poly1305::Backend::Avx512:
+        return chacha::xor_avx512;
+    case ChaCha20Poly1305::Backend::Avx2:
+        return chacha::xor_avx2;
+#endif
+    default:
+        return chacha::xor_portable;
+    }
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// Poly1305 over data zero-padded to 16 bytes.
+void absorb_padded(chacha::Poly1305& st, const uint8_t* data, size_t len) {
+    const size_t whole = len & ~size_t{15};
+    chacha::poly1305_blocks(st, data, whole);
+    if (whole < len) {
+        uint8_t block[16] = {};
+        std::memcpy(block, data + whole, len - whole);
+        chacha::poly1305_blocks(st, block, 16);
+    }
+}
+
+} // namespace
+
+ChaCha20Poly1305::ChaCha20Poly1305(std::span<const uint8_t, KEY_SIZE> key)
+    : ChaCha20Poly1305(key, kernel_table().chacha20) {}
+
+ChaCha20Poly1305::ChaCha20Poly1305(std::span<const uint8_t, KEY_SIZE> key, Backend backend)
+    : backend_(backend),
+      key_{},
+      nonce_prefix_(SecureRandom::next_u32()),
+      nonce_counter_(0) {
+    if (!backend_supported(backend)) {
+        throw std::invalid_argument(std::string("ChaCha20Poly1305: backend not supported on this CPU: ") +
+                                    backend_name(backend));
+    }
+    rekey(key);
+}
+
+ChaCha20Poly1305::~ChaCha20Poly1305() {
+    secure_wipe(key_.data(), key_.size());
+}
+
+void ChaCha20Poly1305::rekey(std::span<const uint8_t, KEY_SIZE> key) {
+    std::memcpy(key_.data(), key.data(), KEY_SIZE);
+    nonce_prefix_ = SecureRandom::next_u32();
+    nonce_counter_.store(0, std::memory_order_relaxed);
+}
+
+void ChaCha20Poly1305::poly1305_tag(const uint8_t poly_key[32], std::span<const uint8_t> aad,
+                                    std::span<const uint8_t> ciphertext, Tag& tag) const {
+    chacha::Poly1305 st;
+    chacha::poly1305_init(st, poly_key);
+    absorb_padded(st, aad.data(), aad.size());
+
+    size_t done = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+    if (backend_ != Backend::Portable) {
+        done = chacha::poly1305_blocks_avx2(st, ciphertext.data(), ciphertext.size());
+    }
+#endif
+    absorb_padded(st, ciphertext.data() + done, ciphertext.size() - done);
+
+    uint8_t lengths[16];
+    for (int i = 0; i < 8; ++i) {
+        lengths[i] = static_cast<uint8_t>(static_cast<uint64_t>(aad.size()) >> (8 * i));
+        lengths[8 + i] = static_cast<uint8_t>(static_cast<uint64_t>(ciphertext.size()) >> (8 * i));
+    }
+    chacha::poly1305_blocks(st, lengths, 16);
+    chacha::poly1305_finish(st, tag.data());
+    secure_wipe(&st, sizeof(st));
+}
+
+void ChaCha20Poly1305::seal(const Nonce& nonce, std::span<const uint8_t> aad,
+                            std::span<const uint8_t> in, std::span<uint8_t> out, Tag& tag) const {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("ChaCha20Poly1305::seal: input and output sizes differ");
+    }
+    uint8_t poly_key[32] = {};
+    chacha::xor_portable(key_.data(), nonce.data(), 0, poly_key, poly_key, sizeof(poly_key));
+    xor_for(backend_)(key_.data(), nonce.data(), 1, in.data(), out.data(), in.size());
+    poly1305_tag(poly_key, aad, out, tag);
+    secure_wipe(poly_key, sizeof(poly_key));
+}
+
+bool ChaCha20Poly1305::open(const Nonce& nonce, std::span<const uint8_t> aad,
+                            std::span<const uint8_t> in, std::span<uint8_t> out, const Tag& tag) const {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("ChaCha20Poly1305::open: input and output sizes differ");
+    }
+    uint8_t poly_key[32] = {};
+    chacha::xor_portable(key_.data(), nonce.data(), 0, poly_key, poly_key, sizeof(poly_key));
+    Tag expected;
+    poly1305_tag(poly_key, aad, in, expected);
+    secure_wipe(poly_key, sizeof(poly_key));
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < TAG_SIZE; ++i) diff |= expected[i] ^ tag[i];
+    if (diff != 0) {
+        secure_wipe(out.data(), out.size());
+        return false;
+    }
+    xor_for(backend_)(key_.data(), nonce.data(), 1, in.data(), out.data(), in.size());
+    return true;
+}
+
+ChaCha20Poly1305::Nonce ChaCha20Poly1305::next_nonce() {
+    const uint64_t counter = nonce_counter_.fetch_add(1, std::memory_order_relaxed);
+    Nonce nonce;
+    for (int i = 0; i < 4; ++i) nonce[i] = static_cast<uint8_t>(nonce_prefix_ >> (24 - 8 * i));
+    for (int i = 0; i < 8; ++i) nonce[4 + i] = static_cast<uint8_t>(counter >> (56 - 8 * i));
+    return nonce;
+}
+
+ChaCha20Poly1305::Backend ChaCha20Poly1305::best_backend() {
+    if (backend_supported(Backend::Avx512)) return Backend::Avx512;
+    if (backend_supported(Backend::Avx2)) return Backend::Avx2;
+    return Backend::Portable;
+}
+
+bool ChaCha20Poly1305::backend_supported(Backend backend) {
+#if defined(__x86_64__) || defined(_M_X64)
+    const CpuFeatures& f = cpu_features();
+    switch (backend) {
+    case Backend::Avx512:
+        return f.avx2 && f.avx512f && isa_level_enabled(IsaLevel::Avx512);
+    case Backend::Avx2:
+        return f.avx2 && isa_level_enabled(IsaLevel::Avx2);
+    case Backend::Portable:
+        return true;
+    }
+    return false;
+#else
+    return backend == Backend::Portable;
+#endif
+}
+
+const char* ChaCha20Poly1305::backend_name(Backend backend) {
+    switch (backend) {
+    case Backend::Avx512:
+        return "avx512-x16";
+    case Backend::Avx2:
+        return "avx2-x8";
+    case Backend::Portable:
+        return "portable";
+    }
+    return "unknown";
+}
+
+} // namespace Crypto
@@ -0,0 +1,149 @@
+#include "chacha20_kernels.h"
+
+#include <cstring>
+
+// Portable ChaCha20 and Poly1305 (26-bit limbs, 32x32->64 multiplies).
+// Both are constant time; the SIMD backends only replace the bulk loops.
+
+namespace Crypto {
+namespace chacha {
+
+namespace {
+
+inline uint32_t rotl(uint32_t v, int n) {
+    return (v << n) | (v >> (32 - n));
+}
+
+inline void quarter_round(uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d) {
+    a += b; d ^= a; d = rotl(d, 16);
+    c += d; b ^= c; b = rotl(b, 12);
+    a += b; d ^= a; d = rotl(d, 8);
+    c += d; b ^= c; b = rotl(b, 7);
+}
+
+void block(const uint32_t state[16], uint8_t out[64]) {
+    uint32_t x[16];
+    std::memcpy(x, state, sizeof(x));
+    for (int i = 0; i < 10; ++i) {
+        quarter_round(x[0], x[4], x[8], x[12]);
+        quarter_round(x[1], x[5], x[9], x[13]);
+        quarter_round(x[2], x[6], x[10], x[14]);
+        quarter_round(x[3], x[7], x[11], x[15]);
+        quarter_round(x[0], x[5], x[10], x[15]);
+        quarter_round(x[1], x[6], x[11], x[12]);
+        quarter_round(x[2], x[7], x[8], x[13]);
+        quarter_round(x[3], x[4], x[9], x[14]);
+    }
+    for (int i = 0; i < 16; ++i) store_le32(out + 4 * i, x[i] + state[i]);
+}
+
+constexpr uint32_t MASK26 = 0x3ffffff;
+
+} // namespace
+
+void xor_portable(const uint8_t key[32], const uint8_t nonce[12], uint32_t counter,
+                  const uint8_t* in, uint8_t* out, size_t len) {
+    uint32_t state[16];
+    for (int i = 0; i < 4; ++i) state[i] = SIGMA[i];
+    for (int i = 0; i < 8; ++i) state[4 + i] = load_le32(key + 4 * i);
+    state[12] = counter;
+    for (int i = 0; i < 3; ++i) state[13 + i] = load_le32(nonce + 4 * i);
+
+    uint8_t stream[64];
+    while (len > 0) {
+        block(state, stream);
+        ++state[12];
+        const size_t n = len < 64 ? len : 64;
+        for (size_t i = 0; i < n; ++i) out[i] = in[i] ^ stream[i];
+        in += n;
+        out += n;
+        len -= n;
+    }
+}
+
+void poly1305_init(Poly1305& st, const uint8_t key[32]) {
+    // r with the RFC 8439 clamp applied while splitting into limbs.
+    st.r[0] = load_le32(key + 0) & 0x3ffffff;
+    st.r[1] = (load_le32(key + 3) >> 2) & 0x3ffff03;
+    st.r[2] = (load_le32(key + 6) >> 4) & 0x3ffc0ff;
+    st.r[3] = (load_le32(key + 9) >> 6) & 0x3f03fff;
+    st.r[4] = (load_le32(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 5; ++i) st.h[i] = 0;
+    for (int i = 0; i < 4; ++i) st.pad[i] = load_le32(key + 16 + 4 * i);
+}
+
+void poly1305_mul(uint32_t h[5], const uint32_t a[5], const uint32_t b[5]) {
+    const uint64_t s1 = b[1] * 5ull, s2 = b[2] * 5ull, s3 = b[3] * 5ull, s4 = b[4] * 5ull;
+    const uint64_t d0 = a[0] * uint64_t{b[0]} + a[1] * s4 + a[2] * s3 + a[3] * s2 + a[4] * s1;
+    uint64_t d1 = a[0] * uint64_t{b[1]} + a[1] * uint64_t{b[0]} + a[2] * s4 + a[3] * s3 + a[4] * s2;
+    uint64_t d2 = a[0] * uint64_t{b[2]} + a[1] * uint64_t{b[1]} + a[2] * uint64_t{b[0]} + a[3] * s4 + a[4] * s3;
+    uint64_t d3 = a[0] * uint64_t{b[3]} + a[1] * uint64_t{b[2]} + a[2] * uint64_t{b[1]} + a[3] * uint64_t{b[0]} +
+                  a[4] * s4;
+    uint64_t d4 = a[0] * uint64_t{b[4]} + a[1] * uint64_t{b[3]} + a[2] * uint64_t{b[2]} + a[3] * uint64_t{b[1]} +
+                  a[4] * uint64_t{b[0]};
+
+    d1 += d0 >> 26;
+    d2 += d1 >> 26;
+    d3 += d2 >> 26;
+    d4 += d3 >> 26;
+    uint64_t h0 = (d0 & MASK26) + (d4 >> 26) * 5;
+    h[1] = static_cast<uint32_t>((d1 & MASK26) + (h0 >> 26));
+    h[0] = static_cast<uint32_t>(h0 & MASK26);
+    h[2] = static_cast<uint32_t>(d2 & MASK26);
+    h[3] = static_cast<uint32_t>(d3 & MASK26);
+    h[4] = static_cast<uint32_t>(d4 & MASK26);
+}
+
+void poly1305_blocks(Poly1305& st, const uint8_t* m, size_t len) {
+    for (; len >= 16; m += 16, len -= 16) {
+        st.h[0] += load_le32(m + 0) & MASK26;
+        st.h[1] += (load_le32(m + 3) >> 2) & MASK26;
+        st.h[2] += (load_le32(m + 6) >> 4) & MASK26;
+        st.h[3] += (load_le32(m + 9) >> 6) & MASK26;
+        st.h[4] += (load_le32(m + 12) >> 8) | (1u << 24);
+        poly1305_mul(st.h, st.h, st.r);
+    }
+}
+
+void poly1305_finish(Poly1305& st, uint8_t tag[16]) {
+    uint32_t h0 = st.h[0], h1 = st.h[1], h2 = st.h[2], h3 = st.h[3], h4 = st.h[4];
+
+    // Full carry, then h - p computed alongside and selected in constant time.
+    uint32_t c = h1 >> 26; h1 &= MASK26;
+    h2 += c; c = h2 >> 26; h2 &= MASK26;
+    h3 += c; c = h3 >> 26; h3 &= MASK26;
+    h4 += c; c = h4 >> 26; h4 &= MASK26;
+    h0 += c * 5; c = h0 >> 26; h0 &= MASK26;
+    h1 += c;
+
+    uint32_t g0 = h0 + 5; c = g0 >> 26; g0 &= MASK26;
+    uint32_t g1 = h1 + c; c = g1 >> 26; g1 &= MASK26;
+    uint32_t g2 = h2 + c; c = g2 >> 26; g2 &= MASK26;
+    uint32_t g3 = h3 + c; c = g3 >> 26; g3 &= MASK26;
+    const uint32_t g4 = h4 + c - (1u << 26);
+
+    const uint32_t keep_g = (g4 >> 31) - 1;  // all ones when h >= p
+    h0 = (h0 & ~keep_g) | (g0 & keep_g);
+    h1 = (h1 & ~keep_g) | (g1 & keep_g);
+    h2 = (h2 & ~keep_g) | (g2 & keep_g);
+    h3 = (h3 & ~keep_g) | (g3 & keep_g);
+    h4 = (h4 & ~keep_g) | (g4 & keep_g);
+
+    // h mod 2^128 as four 32-bit words, plus s.
+    const uint32_t w0 = h0 | (h1 << 26);
+    const uint32_t w1 = (h1 >> 6) | (h2 << 20);
+    const uint32_t w2 = (h2 >> 12) | (h3 << 14);
+    const uint32_t w3 = (h3 >> 18) | (h4 << 8);
+
+    uint64_t f = uint64_t{w0} + st.pad[0];
+    store_le32(tag + 0, static_cast<uint32_t>(f));
+    f = uint64_t{w1} + st.pad[1] + (f >> 32);
+    store_le32(tag + 4, static_cast<uint32_t>(f));
+    f = uint64_t{w2} + st.pad[2] + (f >> 32);
+    store_le32(tag + 8, static_cast<uint32_t>(f));
+    f = uint64_t{w3} + st.pad[3] + (f >> 32);
+    store_le32(tag + 12, static_cast<uint32_t>(f));
+}
+
+} // namespace chacha
+} // namespace Crypto
@@ -0,0 +1,263 @@
+#include "cipher_engine.h"
+#include "cpu_features.h"
+#include "aes_gcm_kernels.h"
+#include "kernel_table.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Crypto {
+
+namespace {
+
+struct BackendOps {
+    aes_gcm::ExpandKeyFn expand_key;
+    aes_gcm::CryptFn crypt;
+};
+
+BackendOps ops_for(CipherEngine::Backend backend) {
+    switch (backend) {
+#if defined(__x86_64__) || defined(_M_X64)
+    case CipherEngine::Backend::Vaes:
+        return {aes_gcm::expand_key_vaes, aes_gcm::crypt_vaes};
+    case CipherEngine::Backend::AesNi:
+        return {aes_gcm::expand_key_aesni, aes_gcm::crypt_aesni};
+#endif
+    default:
+        return {aes_gcm::expand_key_portable, aes_gcm::crypt_portable};
+    }
+}
+
+// From about this size the single-message kernels already keep 8-16 blocks
+// in flight, so interleaving messages stops paying for its bookkeeping.
+constexpr size_t BATCH_MAX_LEN = 256;
+
+bool tags_equal(const uint8_t* a, const uint8_t* b) {
+    uint8_t diff = 0;
+    for (size_t i = 0; i < CipherEngine::TAG_SIZE; ++i) diff |= a[i] ^ b[i];
+    return diff == 0;
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+} // namespace
+
+CipherEngine::CipherEngine()
+    : CipherEngine(generate_key()) {}
+
+CipherEngine::CipherEngine(std::span<const uint8_t, KEY_SIZE> key)
+    : CipherEngine(key, kernel_table().aes_gcm) {}
+
+CipherEngine::CipherEngine(std::span<const uint8_t, KEY_SIZE> key, Backend backend)
+    : backend_(backend),
+      schedule_(std::make_unique<aes_gcm::KeySchedule>()),
+      nonce_prefix_(SecureRandom::next_u32()),
+      nonce_counter_(0) {
+    if (!backend_supported(backend)) {
+        throw std::invalid_argument(std::string("CipherEngine: backend not supported on this CPU: ") +
+                                    backend_name(backend));
+    }
+    rekey(key);
+}
+
+CipherEngine::~CipherEngine() {
+    secure_wipe(schedule_.get(), sizeof(aes_gcm::KeySchedule));
+}
+
+void CipherEngine::rekey(std::span<const uint8_t, KEY_SIZE> key) {
+    ops_for(backend_).expand_key(key.data(), *schedule_);
+    nonce_prefix_ = SecureRandom::next_u32();
+    nonce_counter_.store(0, std::memory_order_relaxed);
+}
+
+void CipherEngine::seal(const Nonce& nonce, std::span<const uint8_t> aad,
+                        std::span<const uint8_t> in, std::span<uint8_t> out, Tag& tag) const {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("CipherEngine::seal: input and output sizes differ");
+    }
+    ops_for(backend_).crypt(*schedule_, nonce.data(), aad.data(), aad.size(),
+                            in.data(), out.data(), in.size(), false, tag.data());
+}
+
+bool CipherEngine::open(const Nonce& nonce, std::span<const uint8_t> aad,
+                        std::span<const uint8_t> in, std::span<uint8_t> out, const Tag& tag) const {
+    if (in.size() != out.size()) {
+        throw std::invalid_argument("CipherEngine::open: input and output sizes differ");
+    }
+    Tag expected;
+    ops_for(backend_).crypt(*schedule_, nonce.data(), aad.data(), aad.size(),
+                            in.data(), out.data(), in.size(), true, expected.data());
+    if (!tags_equal(expected.data(), tag.data())) {
+        secure_wipe(out.data(), out.size());
+        return false;
+    }
+    return true;
+}
+
+void CipherEngine::seal_box_in_place(std::span<uint8_t> box, std::span<const uint8_t> aad) {
+    if (box.size() < OVERHEAD) {
+        throw std::invalid_argument("CipherEngine::seal_box_in_place: buffer too small");
+    }
+    const Nonce nonce = next_nonce();
+    std::memcpy(box.data(), nonce.data(), NONCE_SIZE);
+    auto payload = box.subspan(NONCE_SIZE, box.size() - OVERHEAD);
+    Tag tag;
+    seal(nonce, aad, payload, payload, tag);
+    std::memcpy(box.data() + box.size() - TAG_SIZE, tag.data(), TAG_SIZE);
+}
+
+bool CipherEngine::open_box_in_place(std::span<uint8_t> box, std::span<const uint8_t> aad) const {
+    if (box.size() < OVERHEAD) return false;
+    Nonce nonce;
+    Tag tag;
+    std::memcpy(nonce.data(), box.data(), NONCE_SIZE);
+    std::memcpy(tag.data(), box.data() + box.size() - TAG_SIZE, TAG_SIZE);
+    auto payload = box.subspan(NONCE_SIZE, box.size() - OVERHEAD);
+    return open(nonce, aad, payload, payload, tag);
+}
+
+void CipherEngine::seal_box_into(std::span<const uint8_t> plaintext, std::span<uint8_t> box,
+                                 std::span<const uint8_t> aad) {
+    if (box.size() != plaintext.size() + OVERHEAD) {
+        throw std::invalid_argument("CipherEngine::seal_box_into: box must be plaintext + OVERHEAD bytes");
+    }
+    const Nonce nonce = next_nonce();
+    std::memcpy(box.data(), nonce.data(), NONCE_SIZE);
+    Tag tag;
+    seal(nonce, aad, plaintext, box.subspan(NONCE_SIZE, plaintext.size()), tag);
+    std::memcpy(box.data() + NONCE_SIZE + plaintext.size(), tag.data(), TAG_SIZE);
+}
+
+bool CipherEngine::open_box_into(std::span<const uint8_t> box, std::span<uint8_t> plaintext,
+                                 std::span<const uint8_t> aad) const {
+    if (box.size() < OVERHEAD || box.size() - OVERHEAD != plaintext.size()) return false;
+    Nonce nonce;
+    Tag tag;
+    std::memcpy(nonce.data(), box.data(), NONCE_SIZE);
+    std::memcpy(tag.data(), box.data() + box.size() - TAG_SIZE, TAG_SIZE);
+    return open(nonce, aad, box.subspan(NONCE_SIZE, plaintext.size()), plaintext, tag);
+}
+
+std::vector<uint8_t> CipherEngine::seal_box(std::span<const uint8_t> plaintext,
+                                            std::span<const uint8_t> aad) {
+    std::vector<uint8_t> box(plaintext.size() + OVERHEAD);
+    seal_box_into(plaintext, box, aad);
+    return box;
+}
+
+std::optional<std::vector<uint8_t>> CipherEngine::open_box(std::span<const uint8_t> box,
+                                                           std::span<const uint8_t> aad) const {
+    if (box.size() < OVERHEAD) return std::nullopt;
+    std::vector<uint8_t> plaintext(box.size() - OVERHEAD);
+    if (!open_box_into(box, plaintext, aad)) return std::nullopt;
+    return plaintext;
+}
+
+// Sealing writes each job's tag; opening writes the recomputed tags to
+// expected[] for the caller to compare.
+void CipherEngine::run_batch(std::span<BatchJob> jobs, Tag* expected) {
+    const bool decrypt = expected != nullptr;
+    const aes_gcm::CryptBatchFn crypt_batch = kernel_table().aes_gcm_batch;
+    std::vector<aes_gcm::BatchLane> lanes;
+    lanes.reserve(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        BatchJob& job = jobs[i];
+        uint8_t* tag = decrypt ? expected[i].data() : job.tag.data();
+        if (!job.cipher || job.in.size() != job.out.size()) {
+            throw std::invalid_argument("CipherEngine: batch job needs an engine and equal in/out sizes");
+        }
+        if (!crypt_batch || job.cipher->backend_ == Backend::Portable || job.in.size() >= BATCH_MAX_LEN) {
+            ops_for(job.cipher->backend_).crypt(*job.cipher->schedule_, job.nonce.data(),
+                                                job.aad.data(), job.aad.size(),
+                                                job.in.data(), job.out.data(), job.in.size(),
+                                                decrypt, tag);
+            continue;
+        }
+        lanes.push_back({job.cipher->schedule_.get(), job.nonce.data(), job.aad.data(), job.aad.size(),
+                         job.in.data(), job.out.data(), job.in.size(), tag});
+    }
+    // Lanes advance in lockstep, so grouping similar lengths wastes fewer blocks.
+    const auto by_length = [](const aes_gcm::BatchLane& a, const aes_gcm::BatchLane& b) { return a.len < b.len; };
+    if (!std::is_sorted(lanes.begin(), lanes.end(), by_length)) {
+        std::sort(lanes.begin(), lanes.end(), by_length);
+    }
+    if (!lanes.empty()) crypt_batch(lanes.data(), lanes.size(), decrypt);
+}
+
+void CipherEngine::seal_batch(std::span<BatchJob> jobs) {
+    run_batch(jobs, nullptr);
+}
+
+size_t CipherEngine::open_batch(std::span<BatchJob> jobs) {
+    std::vector<Tag> expected(jobs.size());
+    run_batch(jobs, expected.data());
+    size_t verified = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].ok = tags_equal(expected[i].data(), jobs[i].tag.data());
+        if (jobs[i].ok) {
+            ++verified;
+        } else {
+            secure_wipe(jobs[i].out.data(), jobs[i].out.size());
+        }
+    }
+    return verified;
+}
+
+const char* CipherEngine::batch_backend_name() {
+    return kernel_table().aes_gcm_batch_name;
+}
+
+CipherEngine::Nonce CipherEngine::next_nonce() {
+    const uint64_t counter = nonce_counter_.fetch_add(1, std::memory_order_relaxed);
+    Nonce nonce;
+    for (int i = 0; i < 4; ++i) nonce[i] = static_cast<uint8_t>(nonce_prefix_ >> (24 - 8 * i));
+    for (int i = 0; i < 8; ++i) nonce[4 + i] = static_cast<uint8_t>(counter >> (56 - 8 * i));
+    return nonce;
+}
+
+CipherEngine::Backend CipherEngine::best_backend() {
+    if (backend_supported(Backend::Vaes)) return Backend::Vaes;
+    if (backend_supported(Backend::AesNi)) return Backend::AesNi;
+    return Backend::Portable;
+}
+
+bool CipherEngine::backend_supported(Backend backend) {
+#if defined(__x86_64__) || defined(_M_X64)
+    const CpuFeatures& f = cpu_features();
+    const bool aesni = f.aesni && f.pclmulqdq && f.ssse3 && f.sse41;
+    switch (backend) {
+    case Backend::Vaes:
+        return aesni && f.avx2 && f.vaes && f.vpclmulqdq && isa_level_enabled(IsaLevel::Avx2);
+    case Backend::AesNi:
+        return aesni && isa_level_enabled(IsaLevel::Sse41);
+    case Backend::Portable:
+        return true;
+    }
+    return false;
+#else
+    return backend == Backend::Portable;
+#endif
+}
+
+const char* CipherEngine::backend_name(Backend backend) {
+    switch (backend) {
+    case Backend::Vaes:
+        return "vaes-vpclmulqdq";
+    case Backend::AesNi:
+        return "aesni-pclmulqdq";
+    case Backend::Portable:
+        return "portable-ct";
+    }
+    return "unknown";
+}
+
+CipherEngine::Key CipherEngine::generate_key() {
+    return SecureRandom::bytes<KEY_SIZE>();
+}
+
+} // namespace Crypto
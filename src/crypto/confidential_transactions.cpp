@@ -1,4 +1,5 @@
 #include "confidential_transactions.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -22,7 +23,7 @@ ConfidentialTransaction ConfidentialTransactions::create_transaction(const std::
                                                                       const std::vector<Output>& outputs,
                                                                       uint64_t fee) {
     ConfidentialTransaction tx;
-    tx.tx_id = "tx_ct_" + std::to_string(rand() % 1000000);
+    tx.tx_id = "tx_ct_" + std::to_string(SecureRandom::uniform(1000000));
     tx.inputs = inputs;
     tx.outputs = outputs;
     tx.fee = fee;
@@ -0,0 +1,113 @@
+#include "cpu_features.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#define P2P_CPUID_GCC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#include <immintrin.h>
+#define P2P_CPUID_MSVC 1
+#endif
+
+namespace Crypto {
+
+namespace {
+
+#if defined(P2P_CPUID_GCC) || defined(P2P_CPUID_MSVC)
+void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t regs[4]) {
+#if defined(P2P_CPUID_GCC)
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#else
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+    for (int i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(out[i]);
+#endif
+}
+
+uint64_t xgetbv0() {
+#if defined(P2P_CPUID_GCC)
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#else
+    return _xgetbv(0);
+#endif
+}
+#endif
+
+CpuFeatures probe() {
+    CpuFeatures f;
+#if defined(P2P_CPUID_GCC) || defined(P2P_CPUID_MSVC)
+    uint32_t r[4];
+    cpuid(0, 0, r);
+    const uint32_t max_leaf = r[0];
+    if (max_leaf < 1) return f;
+
+    cpuid(1, 0, r);
+    const uint32_t ecx1 = r[2];
+    const uint32_t edx1 = r[3];
+    f.sse2 = (edx1 >> 26) & 1;
+    f.ssse3 = (ecx1 >> 9) & 1;
+    f.sse41 = (ecx1 >> 19) & 1;
+    f.aesni = (ecx1 >> 25) & 1;
+    f.pclmulqdq = (ecx1 >> 1) & 1;
+
+    // AVX state must be enabled by the OS (XMM|YMM in XCR0), AVX-512 additionally
+    // needs opmask and ZMM state.
+    const bool osxsave = (ecx1 >> 27) & 1;
+    const uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+    const bool ymm_state = (xcr0 & 0x6) == 0x6;
+    const bool zmm_state = (xcr0 & 0xE6) == 0xE6;
+    f.avx = ymm_state && ((ecx1 >> 28) & 1);
+
+    if (max_leaf >= 7) {
+        cpuid(7, 0, r);
+        const uint32_t ebx7 = r[1];
+        const uint32_t ecx7 = r[2];
+        f.avx2 = f.avx && ((ebx7 >> 5) & 1);
+        f.bmi2 = (ebx7 >> 8) & 1;
+        f.sha_ni = (ebx7 >> 29) & 1;
+        f.avx512f = zmm_state && ((ebx7 >> 16) & 1);
+        f.avx512bw = f.avx512f && ((ebx7 >> 30) & 1);
+        f.avx512vl = f.avx512f && ((ebx7 >> 31) & 1);
+        f.vaes = f.avx && ((ecx7 >> 9) & 1);
+        f.vpclmulqdq = f.avx && ((ecx7 >> 10) & 1);
+    }
+#endif
+    return f;
+}
+
+} // namespace
+
+const CpuFeatures& cpu_features() {
+    static const CpuFeatures features = probe();
+    return features;
+}
+
+std::string describe_cpu_features(const CpuFeatures& f) {
+    std::string out;
+    auto add = [&out](bool present, const char* name) {
+        if (!present) return;
+        if (!out.empty()) out += ' ';
+        out += name;
+    };
+    add(f.sse2, "sse2");
+    add(f.ssse3, "ssse3");
+    add(f.sse41, "sse4.1");
+    add(f.aesni, "aes");
+    add(f.pclmulqdq, "pclmulqdq");
+    add(f.avx, "avx");
+    add(f.avx2, "avx2");
+    add(f.bmi2, "bmi2");
+    add(f.avx512f, "avx512f");
+    add(f.avx512bw, "avx512bw");
+    add(f.avx512vl, "avx512vl");
+    add(f.sha_ni, "sha");
+    add(f.vaes, "vaes");
+    add(f.vpclmulqdq, "vpclmulqdq");
+    return out.empty() ? "none" : out;
+}
+
+} // namespace Crypto
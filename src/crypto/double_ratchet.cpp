@@ -1,78 +1,223 @@
 #include "double_ratchet.h"
+#include "ratchet_kdf.h"
+#include "secure_random.h"
+#include "session_store.h"
+#include "sha256.h"
+
+#include <cstring>
 
 namespace Crypto {
 
-DoubleRatchet::DoubleRatchet() {}
+namespace {
+
+constexpr uint8_t MESSAGE_KEY_CONSTANT[1] = {0x01};
+constexpr uint8_t CHAIN_KEY_CONSTANT[1] = {0x02};
+constexpr uint8_t ROOT_KDF_INFO[] = {'P', '2', 'P', 'C', 'h', 'a', 't', 'R', 'a', 't', 'c', 'h', 'e', 't'};
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+} // namespace
+
+namespace ratchet {
+
+DoubleRatchet::MessageKey chain_step(ChainKey& chain_key, HmacSha256& chain, uint64_t& counter) {
+    DoubleRatchet::MessageKey mk;
+    mk.key = chain.mac(MESSAGE_KEY_CONSTANT);
+    mk.message_number = counter++;
+    chain_key = chain.mac(CHAIN_KEY_CONSTANT);
+    chain.rekey(chain_key);
+    return mk;
+}
+
+void root_step(DoubleRatchet::RatchetState& state, std::span<const uint8_t> dh_output, bool initiator) {
+    uint8_t okm[96];
+    HmacSha256::hkdf(state.root_key, dh_output, ROOT_KDF_INFO, okm);
+    std::memcpy(state.root_key.data(), okm, 32);
+    std::memcpy(state.sending_chain_key.data(), okm + (initiator ? 32 : 64), 32);
+    std::memcpy(state.receiving_chain_key.data(), okm + (initiator ? 64 : 32), 32);
+    secure_wipe(okm, sizeof(okm));
+}
+
+std::optional<DoubleRatchet::MessageKey> receive_at(DoubleRatchet::RatchetState& state, HmacSha256& chain,
+                                                    const SkippedKeyStore::RatchetId& ratchet,
+                                                    SkippedKeyStore& store, uint64_t message_number) {
+    if (message_number < state.receiving_ratchet_counter) {
+        const auto key = store.take(ratchet, message_number);
+        if (!key) return std::nullopt;
+        return DoubleRatchet::MessageKey{*key, message_number};
+    }
+
+    if (!skip_to(state, chain, ratchet, store, message_number)) {
+        std::cout << "[!] Message #" << message_number << " would skip more than " << store.limits().max_skip
+                  << " keys, rejected" << std::endl;
+        return std::nullopt;
+    }
+    return chain_step(state.receiving_chain_key, chain, state.receiving_ratchet_counter);
+}
+
+bool skip_to(DoubleRatchet::RatchetState& state, HmacSha256& chain, const SkippedKeyStore::RatchetId& ratchet,
+             SkippedKeyStore& store, uint64_t until) {
+    if (until <= state.receiving_ratchet_counter) return true;
+    if (until - state.receiving_ratchet_counter > store.limits().max_skip) return false;
+    const auto now = SkippedKeyStore::Clock::now();
+    while (state.receiving_ratchet_counter < until) {
+        DoubleRatchet::MessageKey mk = chain_step(state.receiving_chain_key, chain, state.receiving_ratchet_counter);
+        store.insert(ratchet, mk.message_number, mk.key, now);
+        secure_wipe(mk.key.data(), mk.key.size());
+    }
+    return true;
+}
+
+std::optional<Peek> peek_at(const DoubleRatchet::RatchetState& state, const HmacSha256& chain,
+                            const SkippedKeyStore::RatchetId& ratchet, const SkippedKeyStore& store,
+                            uint64_t message_number) {
+    const uint64_t counter = state.receiving_ratchet_counter;
+    if (message_number < counter) {
+        const auto key = store.peek(ratchet, message_number);
+        if (!key) return std::nullopt;
+        return Peek{{*key, message_number}, {}, std::nullopt, counter};
+    }
+    if (message_number - counter > store.limits().max_skip) return std::nullopt;
 
-void DoubleRatchet::initialize_session(const std::string& peer) {
+    Peek peek{{}, state.receiving_chain_key, chain, counter};
+    uint64_t at = counter;
+    while (at < message_number) {
+        DoubleRatchet::MessageKey mk = chain_step(peek.next_chain_key, *peek.next_chain, at);
+        secure_wipe(mk.key.data(), mk.key.size());
+    }
+    peek.key = chain_step(peek.next_chain_key, *peek.next_chain, at);
+    return peek;
+}
+
+} // namespace ratchet
+
+DoubleRatchet::DoubleRatchet(const SkippedKeyStore::Limits& limits) : skipped_keys(limits) {}
+
+void DoubleRatchet::initialize_session(const std::string& peer, bool is_initiator) {
+    std::lock_guard<std::mutex> lock(ratchet_mutex);
     peer_id = peer;
-    
-    // Initialize root key
-    for (auto& b : state.root_key) b = rand() % 256;
-    for (auto& b : state.sending_chain_key) b = rand() % 256;
-    for (auto& b : state.receiving_chain_key) b = rand() % 256;
-    
+    initiator = is_initiator;
+
+    // Initialize root key; both chains come from it through KDF_RK
+    SecureRandom::fill(state.root_key);
+
     state.sending_ratchet_counter = 0;
     state.receiving_ratchet_counter = 0;
     state.previous_chain_length = 0;
-    
+    rekey_chains({});
+
     std::cout << "\n=== Double Ratchet Session Initialized ===" << std::endl;
     std::cout << "Peer: " << peer << std::endl;
     std::cout << "Root Key: Generated" << std::endl;
-    std::cout << "Algorithm: Signal Protocol-style" << std::endl;
+    std::cout << "Algorithm: Signal Protocol-style (HMAC-SHA256 chains, HKDF root)" << std::endl;
     std::cout << "Forward Secrecy: ENABLED" << std::endl;
 }
 
+void DoubleRatchet::rekey_chains(std::span<const uint8_t> dh_output) {
+    ratchet::root_step(state, dh_output, initiator);
+    sending_chain.emplace(state.sending_chain_key);
+    receiving_chain.emplace(state.receiving_chain_key);
+}
+
 DoubleRatchet::MessageKey DoubleRatchet::derive_message_key(bool sending) {
     std::lock_guard<std::mutex> lock(ratchet_mutex);
-    
-    MessageKey mk;
-    
-    // Derive message key from chain key
-    for (auto& b : mk.key) b = rand() % 256;
-    
-    if (sending) {
-        mk.message_number = state.sending_ratchet_counter;
-        state.sending_ratchet_counter++;
-    } else {
-        mk.message_number = state.receiving_ratchet_counter;
-        state.receiving_ratchet_counter++;
+
+    // In-order keys are used once and not kept; only keys stepped over by
+    // derive_message_key_at() wait for delayed messages.
+    return sending ? ratchet::chain_step(state.sending_chain_key, *sending_chain, state.sending_ratchet_counter)
+                   : ratchet::chain_step(state.receiving_chain_key, *receiving_chain, state.receiving_ratchet_counter);
+}
+
+std::optional<DoubleRatchet::MessageKey> DoubleRatchet::derive_message_key_at(uint64_t message_number) {
+    std::lock_guard<std::mutex> lock(ratchet_mutex);
+    return ratchet::receive_at(state, *receiving_chain, receiving_ratchet, skipped_keys, message_number);
+}
+
+std::optional<DoubleRatchet::MessageKey> DoubleRatchet::derive_message_key_at(
+    std::span<const uint8_t> ratchet_public_key, uint64_t message_number) {
+    const SkippedKeyStore::RatchetId id = Sha256::hash(ratchet_public_key);
+
+    std::lock_guard<std::mutex> lock(ratchet_mutex);
+    if (id == receiving_ratchet) {
+        return ratchet::receive_at(state, *receiving_chain, receiving_ratchet, skipped_keys, message_number);
     }
-    
-    // Store key for potential delayed messages
-    message_keys.push_back(mk);
-    
-    std::cout << "[*] Message key derived (#" << mk.message_number << ")" << std::endl;
-    
-    return mk;
+    const auto key = skipped_keys.take(id, message_number);
+    if (!key) return std::nullopt;
+    return MessageKey{*key, message_number};
 }
 
-void DoubleRatchet::ratchet_forward() {
+bool DoubleRatchet::ratchet_forward(std::span<const uint8_t> dh_output,
+                                    std::span<const uint8_t> remote_ratchet_public_key,
+                                    uint64_t remote_previous_chain_length) {
     std::lock_guard<std::mutex> lock(ratchet_mutex);
-    
+
+    // Keys left on the current receiving chain, for messages sent on it
+    // before the peer's step and still on their way. Only reachable when
+    // the new chain has a public key to tell it from.
+    if (!remote_ratchet_public_key.empty() &&
+        !ratchet::skip_to(state, *receiving_chain, receiving_ratchet, skipped_keys, remote_previous_chain_length)) {
+        std::cout << "[!] Ratchet step would skip more than " << skipped_keys.limits().max_skip
+                  << " keys, rejected" << std::endl;
+        return false;
+    }
+
     // DH ratchet step
-    for (auto& b : state.sending_chain_key) b = rand() % 256;
-    for (auto& b : state.receiving_chain_key) b = rand() % 256;
-    
     state.previous_chain_length = state.sending_ratchet_counter;
     state.sending_ratchet_counter = 0;
     state.receiving_ratchet_counter = 0;
-    
-    // Clear old message keys (forward secrecy)
-    message_keys.clear();
-    
-    std::cout << "[*] Ratchet forwarded - old keys discarded" << std::endl;
+    rekey_chains(dh_output);
+
+    if (remote_ratchet_public_key.empty()) {
+        // No way to tell old chains apart: clear old message keys (forward secrecy)
+        skipped_keys.clear();
+        receiving_ratchet = {};
+    } else {
+        receiving_ratchet = Sha256::hash(remote_ratchet_public_key);
+    }
+
+    std::cout << "[*] Ratchet forwarded - " << skipped_keys.size() << " skipped keys kept" << std::endl;
     std::cout << "    Forward secrecy maintained" << std::endl;
+    return true;
 }
 
 void DoubleRatchet::process_delayed_messages() {
     std::lock_guard<std::mutex> lock(ratchet_mutex);
-    
+
+    const size_t expired = skipped_keys.evict_expired();
     std::cout << "[*] Processing delayed messages..." << std::endl;
-    std::cout << "    Stored keys: " << message_keys.size() << std::endl;
-    
-    // In a real implementation, this would decrypt buffered messages
-    // using the stored message keys
+    std::cout << "    Stored keys: " << skipped_keys.size() << " (" << expired << " expired)" << std::endl;
+}
+
+bool DoubleRatchet::save_session(SessionStore& store) {
+    std::lock_guard<std::mutex> lock(ratchet_mutex);
+    SessionStore::Record record{peer_id, initiator, state, receiving_ratchet, 0};
+    SessionStore::Handle handle;
+    const bool saved = store.save(record, handle);
+    secure_wipe(&record.state, sizeof(record.state));
+    return saved;
+}
+
+bool DoubleRatchet::restore_session(const std::string& peer, SessionStore& store) {
+    SessionStore::Handle handle;
+    auto record = store.load(peer, handle);
+    if (!record) return false;
+
+    std::lock_guard<std::mutex> lock(ratchet_mutex);
+    peer_id = peer;
+    initiator = record->initiator;
+    state = record->state;
+    receiving_ratchet = record->receiving_ratchet;
+    sending_chain.emplace(state.sending_chain_key);
+    receiving_chain.emplace(state.receiving_chain_key);
+    skipped_keys.clear();
+    secure_wipe(&record->state, sizeof(record->state));
+
+    std::cout << "[*] Session restored - Peer: " << peer << ", message #" << state.sending_ratchet_counter
+              << " next" << std::endl;
+    return true;
 }
 
 } // namespace Crypto
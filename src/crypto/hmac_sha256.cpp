@@ -0,0 +1,129 @@
+#include "hmac_sha256.h"
+#include "sha256.h"
+#include "kernel_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Crypto {
+
+namespace {
+
+constexpr size_t BLOCK = Sha256::BLOCK_SIZE;
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// Writes SHA-256 padding after `len` bytes already in `block` (< 64);
+// `total` is the hashed length. Returns the number of blocks to compress.
+size_t pad_blocks(uint8_t block[2 * BLOCK], size_t len, uint64_t total) {
+    const size_t blocks = len + 9 <= BLOCK ? 1 : 2;
+    block[len] = 0x80;
+    std::memset(block + len + 1, 0, blocks * BLOCK - len - 1);
+    const uint64_t bits = total * 8;
+    for (int i = 0; i < 8; ++i) block[blocks * BLOCK - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    return blocks;
+}
+
+void store_digest(uint8_t out[32], const uint32_t state[8]) {
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) out[4 * i + j] = static_cast<uint8_t>(state[i] >> (24 - 8 * j));
+    }
+}
+
+} // namespace
+
+HmacSha256::HmacSha256(std::span<const uint8_t> key) {
+    rekey(key);
+}
+
+HmacSha256::~HmacSha256() {
+    secure_wipe(inner_, sizeof(inner_));
+    secure_wipe(outer_, sizeof(outer_));
+}
+
+void HmacSha256::rekey(std::span<const uint8_t> key) {
+    const sha256::CompressFn compress = kernel_table().sha256_compress;
+    uint8_t block[BLOCK] = {};
+    if (key.size() > BLOCK) {
+        const Sha256::Digest digest = Sha256::hash(key);
+        std::memcpy(block, digest.data(), digest.size());
+    } else {
+        std::copy(key.begin(), key.end(), block);
+    }
+    const size_t key_len = key.size() > BLOCK ? Sha256::DIGEST_SIZE : key.size();
+
+    for (auto& b : block) b ^= 0x36;
+    std::memcpy(inner_, sha256::INITIAL_STATE, sizeof(inner_));
+    compress(inner_, block, 1);
+
+    for (auto& b : block) b ^= 0x36 ^ 0x5c;
+    std::memcpy(outer_, sha256::INITIAL_STATE, sizeof(outer_));
+    compress(outer_, block, 1);
+    // Only the key bytes differ from the public pad constants.
+    secure_wipe(block, key_len);
+}
+
+HmacSha256::Mac HmacSha256::mac(std::span<const uint8_t> data) const {
+    const sha256::CompressFn compress = kernel_table().sha256_compress;
+
+    uint32_t state[8];
+    std::memcpy(state, inner_, sizeof(state));
+    const size_t whole = data.size() / BLOCK;
+    if (whole > 0) compress(state, data.data(), whole);
+    uint8_t block[2 * BLOCK];
+    const size_t tail = data.size() - whole * BLOCK;
+    std::memcpy(block, data.data() + whole * BLOCK, tail);
+    compress(state, block, pad_blocks(block, tail, BLOCK + data.size()));
+
+    // Outer hash over the inner digest: a single block.
+    store_digest(block, state);
+    pad_blocks(block, MAC_SIZE, BLOCK + MAC_SIZE);
+    std::memcpy(state, outer_, sizeof(state));
+    compress(state, block, 1);
+
+    Mac out;
+    store_digest(out.data(), state);
+    secure_wipe(block, MAC_SIZE);
+    secure_wipe(state, sizeof(state));
+    return out;
+}
+
+HmacSha256::Mac HmacSha256::hkdf_extract(std::span<const uint8_t> salt, std::span<const uint8_t> ikm) {
+    static constexpr uint8_t zero_salt[MAC_SIZE] = {};
+    return HmacSha256(salt.empty() ? std::span<const uint8_t>(zero_salt) : salt).mac(ikm);
+}
+
+bool HmacSha256::hkdf_expand(std::span<const uint8_t> prk, std::span<const uint8_t> info, std::span<uint8_t> out) {
+    if (out.size() > MAX_HKDF_OUTPUT) {
+        return false;
+    }
+    const HmacSha256 hmac(prk);
+    // T(i) = HMAC(PRK, T(i-1) || info || i), T(0) empty.
+    std::vector<uint8_t> input(MAC_SIZE + info.size() + 1);
+    std::copy(info.begin(), info.end(), input.begin() + MAC_SIZE);
+    Mac t{};
+    for (size_t off = 0, i = 1; off < out.size(); off += MAC_SIZE, ++i) {
+        input.back() = static_cast<uint8_t>(i);
+        const size_t skip = i == 1 ? MAC_SIZE : 0;
+        t = hmac.mac(std::span<const uint8_t>(input).subspan(skip));
+        std::memcpy(input.data(), t.data(), MAC_SIZE);
+        std::memcpy(out.data() + off, t.data(), std::min(MAC_SIZE, out.size() - off));
+    }
+    secure_wipe(input.data(), input.size());
+    secure_wipe(t.data(), t.size());
+    return true;
+}
+
+bool HmacSha256::hkdf(std::span<const uint8_t> salt, std::span<const uint8_t> ikm, std::span<const uint8_t> info,
+                      std::span<uint8_t> out) {
+    Mac prk = hkdf_extract(salt, ikm);
+    const bool ok = hkdf_expand(prk, info, out);
+    secure_wipe(prk.data(), prk.size());
+    return ok;
+}
+
+} // namespace Crypto
@@ -0,0 +1,67 @@
+#include "id128.h"
+
+namespace Crypto {
+
+namespace {
+
+// Crockford's alphabet, lowercase: no i, l, o or u to misread.
+constexpr char ALPHABET[] = "0123456789abcdefghjkmnpqrstvwxyz";
+
+int decode_char(char c) {
+    if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    for (int v = 0; v < 32; ++v) {
+        if (ALPHABET[v] == c) return v;
+    }
+    return -1;
+}
+
+} // namespace
+
+std::optional<Id128> Id128::parse(std::string_view text) {
+    const size_t sep = text.rfind('_');
+    if (sep != std::string_view::npos) text.remove_prefix(sep + 1);
+    if (text.size() != TEXT_SIZE) return std::nullopt;
+
+    // 26 digits hold 130 bits; the first carries only the top 3.
+    Id128 id;
+    for (size_t i = 0; i < TEXT_SIZE; ++i) {
+        const int v = decode_char(text[i]);
+        if (v < 0 || (i == 0 && v > 7)) return std::nullopt;
+        id.hi = (id.hi << 5) | (id.lo >> 59);
+        id.lo = (id.lo << 5) | static_cast<uint64_t>(v);
+    }
+    return id;
+}
+
+std::string Id128::to_string(std::string_view prefix) const {
+    std::string text;
+    text.reserve(prefix.size() + 1 + TEXT_SIZE);
+    if (!prefix.empty()) {
+        text.append(prefix);
+        text.push_back('_');
+    }
+    const size_t start = text.size();
+    text.resize(start + TEXT_SIZE);
+    uint64_t h = hi, l = lo;
+    for (size_t i = text.size(); i-- > start;) {
+        text[i] = ALPHABET[l & 31];
+        l = (l >> 5) | (h << 59);
+        h >>= 5;
+    }
+    return text;
+}
+
+std::array<uint8_t, 16> Id128::bytes() const {
+    std::array<uint8_t, 16> out;
+    for (size_t i = 0; i < 8; ++i) {
+        out[i] = static_cast<uint8_t>(hi >> (56 - 8 * i));
+        out[8 + i] = static_cast<uint8_t>(lo >> (56 - 8 * i));
+    }
+    return out;
+}
+
+std::ostream& operator<<(std::ostream& os, const Id128& id) {
+    return os << id.to_string();
+}
+
+} // namespace Crypto
@@ -0,0 +1,181 @@
+#include "keccak.h"
+
+#include <cstring>
+
+namespace Crypto {
+namespace keccak {
+
+namespace {
+
+template <int N>
+inline uint64_t rotl(uint64_t v) {
+    if constexpr (N == 0) {
+        return v;
+    } else {
+        return (v << N) | (v >> (64 - N));
+    }
+}
+
+// Unrolled at compile time so the 25 lanes can stay in registers.
+template <int I>
+inline void rho_pi(uint64_t a[25], uint64_t& t) {
+    if constexpr (I < 24) {
+        const uint64_t next = a[PI[I]];
+        a[PI[I]] = rotl<RHO[I]>(t);
+        t = next;
+        rho_pi<I + 1>(a, t);
+    }
+}
+
+inline uint64_t load_le64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void store_le64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+inline void xor_byte(uint64_t* state, size_t pos, uint8_t b) {
+    state[pos / 8] ^= static_cast<uint64_t>(b) << (8 * (pos % 8));
+}
+
+inline uint8_t get_byte(const uint64_t* state, size_t pos) {
+    return static_cast<uint8_t>(state[pos / 8] >> (8 * (pos % 8)));
+}
+
+void hash(uint8_t* out, size_t out_len, size_t rate, uint8_t domain, const uint8_t* in, size_t len) {
+    Sponge sponge(rate, domain);
+    sponge.absorb(in, len);
+    sponge.squeeze(out, out_len);
+}
+
+} // namespace
+
+void permute(uint64_t a[25]) {
+    for (int round = 0; round < 24; ++round) {
+        uint64_t c[5];
+        for (int x = 0; x < 5; ++x) c[x] = a[x] ^ a[x + 5] ^ a[x + 10] ^ a[x + 15] ^ a[x + 20];
+        for (int x = 0; x < 5; ++x) {
+            const uint64_t d = c[(x + 4) % 5] ^ rotl<1>(c[(x + 1) % 5]);
+            for (int y = 0; y < 25; y += 5) a[y + x] ^= d;
+        }
+
+        uint64_t t = a[1];
+        rho_pi<0>(a, t);
+
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t row[5];
+            for (int x = 0; x < 5; ++x) row[x] = a[y + x];
+            for (int x = 0; x < 5; ++x) a[y + x] = row[x] ^ (~row[(x + 1) % 5] & row[(x + 2) % 5]);
+        }
+
+        a[0] ^= ROUND_CONSTANTS[round];
+    }
+}
+
+Sponge::Sponge(size_t rate, uint8_t domain)
+    : state_{}, rate_(rate), pos_(0), domain_(domain), squeezing_(false) {}
+
+void Sponge::absorb(const uint8_t* data, size_t len) {
+    while (len > 0) {
+        if (pos_ == 0 && len >= rate_) {
+            for (size_t i = 0; i < rate_ / 8; ++i) state_[i] ^= load_le64(data + 8 * i);
+            permute(state_);
+            data += rate_;
+            len -= rate_;
+            continue;
+        }
+        xor_byte(state_, pos_++, *data++);
+        --len;
+        if (pos_ == rate_) {
+            permute(state_);
+            pos_ = 0;
+        }
+    }
+}
+
+void Sponge::finalize() {
+    xor_byte(state_, pos_, domain_);
+    xor_byte(state_, rate_ - 1, 0x80);
+    permute(state_);
+    pos_ = 0;
+    squeezing_ = true;
+}
+
+void Sponge::squeeze(uint8_t* out, size_t len) {
+    if (!squeezing_) finalize();
+    while (len > 0) {
+        if (pos_ == rate_) {
+            permute(state_);
+            pos_ = 0;
+        }
+        *out++ = get_byte(state_, pos_++);
+        --len;
+    }
+}
+
+void Sponge::squeeze_blocks(uint8_t* out, size_t blocks) {
+    if (!squeezing_) finalize();
+    for (; blocks > 0; --blocks, out += rate_) {
+        if (pos_ == rate_) permute(state_);
+        for (size_t i = 0; i < rate_ / 8; ++i) store_le64(out + 8 * i, state_[i]);
+        pos_ = rate_;
+    }
+}
+
+void sha3_256(uint8_t out[32], const uint8_t* in, size_t len) {
+    hash(out, 32, SHA3_256_RATE, 0x06, in, len);
+}
+
+void sha3_512(uint8_t out[64], const uint8_t* in, size_t len) {
+    hash(out, 64, SHA3_512_RATE, 0x06, in, len);
+}
+
+void shake128(uint8_t* out, size_t out_len, const uint8_t* in, size_t len) {
+    hash(out, out_len, SHAKE128_RATE, 0x1F, in, len);
+}
+
+void shake256(uint8_t* out, size_t out_len, const uint8_t* in, size_t len) {
+    hash(out, out_len, SHAKE256_RATE, 0x1F, in, len);
+}
+
+void permute_x4_portable(X4State& state) {
+    for (int j = 0; j < 4; ++j) {
+        uint64_t a[25];
+        for (int i = 0; i < 25; ++i) a[i] = state.s[i][j];
+        permute(a);
+        for (int i = 0; i < 25; ++i) state.s[i][j] = a[i];
+    }
+}
+
+void absorb_x4(X4State& state, size_t rate, const uint8_t* const in[4], size_t len, PermuteX4Fn permute_x4) {
+    std::memset(&state, 0, sizeof(state));
+    size_t off = 0;
+    for (; len - off >= rate; off += rate) {
+        for (size_t i = 0; i < rate / 8; ++i) {
+            for (int j = 0; j < 4; ++j) state.s[i][j] ^= load_le64(in[j] + off + 8 * i);
+        }
+        permute_x4(state);
+    }
+    for (int j = 0; j < 4; ++j) {
+        uint64_t lane[25] = {};
+        for (size_t i = 0; off + i < len; ++i) xor_byte(lane, i, in[j][off + i]);
+        xor_byte(lane, len - off, 0x1F);
+        xor_byte(lane, rate - 1, 0x80);
+        for (size_t i = 0; i < rate / 8; ++i) state.s[i][j] ^= lane[i];
+    }
+}
+
+void squeeze_x4(X4State& state, size_t rate, uint8_t* const out[4], size_t blocks, PermuteX4Fn permute_x4) {
+    for (size_t b = 0; b < blocks; ++b) {
+        permute_x4(state);
+        for (size_t i = 0; i < rate / 8; ++i) {
+            for (int j = 0; j < 4; ++j) store_le64(out[j] + b * rate + 8 * i, state.s[i][j]);
+        }
+    }
+}
+
+} // namespace keccak
+} // namespace Crypto
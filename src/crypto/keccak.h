@@ -0,0 +1,92 @@
+#ifndef KECCAK_H
+#define KECCAK_H
+
+// Keccak-f[1600] and the FIPS 202 functions built on it (SHA3-256/512,
+// SHAKE128/256), used by the lattice schemes for hashing, PRFs and matrix
+// expansion. X4State runs four independent sponges in lockstep so that the
+// AVX2 permutation can process them together; X8State does the same for
+// eight with AVX-512 (hash-based signatures).
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Crypto {
+namespace keccak {
+
+constexpr size_t SHAKE128_RATE = 168;
+constexpr size_t SHAKE256_RATE = 136;
+constexpr size_t SHA3_256_RATE = 136;
+constexpr size_t SHA3_512_RATE = 72;
+
+inline constexpr uint64_t ROUND_CONSTANTS[24] = {
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+    0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+    0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL};
+
+// Combined rho and pi steps: lane PI[i] receives the previous lane rotated
+// left by RHO[i], starting from lane 1.
+inline constexpr int RHO[24] = {1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44};
+inline constexpr int PI[24] = {10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1};
+
+void permute(uint64_t state[25]);
+
+// Incremental sponge; absorb() may be called repeatedly before the first
+// squeeze(), which pads with the domain byte (0x06 SHA-3, 0x1F SHAKE).
+class Sponge {
+public:
+    Sponge(size_t rate, uint8_t domain);
+
+    void absorb(const uint8_t* data, size_t len);
+    void squeeze(uint8_t* out, size_t len);
+    // Whole rate-sized blocks straight from the state, for rejection sampling.
+    void squeeze_blocks(uint8_t* out, size_t blocks);
+
+private:
+    void finalize();
+
+    uint64_t state_[25];
+    size_t rate_;
+    size_t pos_;
+    uint8_t domain_;
+    bool squeezing_;
+};
+
+void sha3_256(uint8_t out[32], const uint8_t* in, size_t len);
+void sha3_512(uint8_t out[64], const uint8_t* in, size_t len);
+void shake128(uint8_t* out, size_t out_len, const uint8_t* in, size_t len);
+void shake256(uint8_t* out, size_t out_len, const uint8_t* in, size_t len);
+
+// Four sponges, word i of instance j at s[i][j]: one ymm register per word.
+struct alignas(32) X4State {
+    uint64_t s[25][4];
+};
+
+using PermuteX4Fn = void (*)(X4State& state);
+
+void permute_x4_portable(X4State& state);
+// Available when compiled for x86-64; callers must check CPU support first.
+void permute_x4_avx2(X4State& state);
+
+// Eight sponges in zmm registers, same layout as X4State.
+struct alignas(64) X8State {
+    uint64_t s[25][8];
+};
+
+using PermuteX8Fn = void (*)(X8State& state);
+
+// Available when compiled for x86-64; callers must check CPU support first.
+void permute_x8_avx512(X8State& state);
+
+// Four SHAKE instances over equal-length inputs, squeezing `blocks` whole
+// blocks into each output. Returns with the state ready for more blocks
+// through squeeze_x4().
+void absorb_x4(X4State& state, size_t rate, const uint8_t* const in[4], size_t len, PermuteX4Fn permute);
+void squeeze_x4(X4State& state, size_t rate, uint8_t* const out[4], size_t blocks, PermuteX4Fn permute);
+
+} // namespace keccak
+} // namespace Crypto
+
+#endif // KECCAK_H
@@ -0,0 +1,74 @@
+#include "keccak.h"
+
+// Four Keccak-f[1600] permutations side by side: word i of the four states
+// lives in one ymm register, so every step of the round is a handful of
+// 256-bit operations. AVX2 has no 64-bit rotate; rotations are two shifts
+// and an OR. Built with -mavx2; only reached after the kernel registry has
+// confirmed CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace keccak {
+
+namespace {
+
+template <int N>
+inline __m256i rotl(__m256i v) {
+    if constexpr (N == 0) {
+        return v;
+    } else {
+        return _mm256_or_si256(_mm256_slli_epi64(v, N), _mm256_srli_epi64(v, 64 - N));
+    }
+}
+
+template <int I>
+inline void rho_pi(__m256i a[25], __m256i& t) {
+    if constexpr (I < 24) {
+        const __m256i next = a[PI[I]];
+        a[PI[I]] = rotl<RHO[I]>(t);
+        t = next;
+        rho_pi<I + 1>(a, t);
+    }
+}
+
+} // namespace
+
+void permute_x4_avx2(X4State& state) {
+    __m256i a[25];
+    for (int i = 0; i < 25; ++i) a[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(state.s[i]));
+
+    for (int round = 0; round < 24; ++round) {
+        __m256i c[5];
+        for (int x = 0; x < 5; ++x) {
+            c[x] = _mm256_xor_si256(_mm256_xor_si256(a[x], a[x + 5]),
+                                    _mm256_xor_si256(_mm256_xor_si256(a[x + 10], a[x + 15]), a[x + 20]));
+        }
+        for (int x = 0; x < 5; ++x) {
+            const __m256i d = _mm256_xor_si256(c[(x + 4) % 5], rotl<1>(c[(x + 1) % 5]));
+            for (int y = 0; y < 25; y += 5) a[y + x] = _mm256_xor_si256(a[y + x], d);
+        }
+
+        __m256i t = a[1];
+        rho_pi<0>(a, t);
+
+        for (int y = 0; y < 25; y += 5) {
+            __m256i row[5];
+            for (int x = 0; x < 5; ++x) row[x] = a[y + x];
+            for (int x = 0; x < 5; ++x) {
+                a[y + x] = _mm256_xor_si256(row[x], _mm256_andnot_si256(row[(x + 1) % 5], row[(x + 2) % 5]));
+            }
+        }
+
+        a[0] = _mm256_xor_si256(a[0], _mm256_set1_epi64x(static_cast<long long>(ROUND_CONSTANTS[round])));
+    }
+
+    for (int i = 0; i < 25; ++i) _mm256_store_si256(reinterpret_cast<__m256i*>(state.s[i]), a[i]);
+}
+
+} // namespace keccak
+} // namespace Crypto
+
+#endif
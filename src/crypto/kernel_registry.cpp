@@ -0,0 +1,177 @@
+#include "kernel_registry.h"
+#include "kernel_table.h"
+#include "cpu_features.h"
+
+#include <atomic>
+#include <iostream>
+
+namespace Crypto {
+
+namespace {
+
+constexpr int CAP_AUTO = -1;
+
+std::atomic<int> forced_cap{CAP_AUTO};
+std::atomic<bool> kernels_bound{false};
+
+bool parse_isa_level(std::string_view name, int& cap) {
+    if (name == "auto") { cap = CAP_AUTO; return true; }
+    if (name == "portable") { cap = static_cast<int>(IsaLevel::Portable); return true; }
+    if (name == "sse4.1" || name == "sse41") { cap = static_cast<int>(IsaLevel::Sse41); return true; }
+    if (name == "avx2") { cap = static_cast<int>(IsaLevel::Avx2); return true; }
+    if (name == "avx512") { cap = static_cast<int>(IsaLevel::Avx512); return true; }
+    return false;
+}
+
+KernelTable bind_kernels() {
+    kernels_bound.store(true, std::memory_order_relaxed);
+
+    KernelTable table{};
+    table.level = isa_level_cap();
+    table.aes_gcm = CipherEngine::best_backend();
+    table.chacha20 = ChaCha20Poly1305::best_backend();
+    table.chacha20_xor = chacha::xor_portable;
+
+    table.aes_gcm_batch = nullptr;
+    table.aes_gcm_batch_name = "sequential";
+    table.sha256_compress = sha256::compress_portable;
+    table.sha256_name = "portable";
+    table.ml_kem = &mlkem::PORTABLE_KERNELS;
+    table.ml_dsa = &mldsa::PORTABLE_KERNELS;
+    table.keccak_x4 = keccak::permute_x4_portable;
+    table.keccak_x8 = nullptr;
+    table.keccak_name = "portable-x4";
+
+#if defined(__x86_64__) || defined(_M_X64)
+    const CpuFeatures& f = cpu_features();
+    if (table.aes_gcm == CipherEngine::Backend::Vaes && isa_level_enabled(IsaLevel::Avx512) && f.avx512bw) {
+        table.aes_gcm_batch = aes_gcm::crypt_batch_vaes512;
+        table.aes_gcm_batch_name = "vaes512-x16";
+    } else if (table.aes_gcm == CipherEngine::Backend::Vaes) {
+        table.aes_gcm_batch = aes_gcm::crypt_batch_vaes;
+        table.aes_gcm_batch_name = "vaes256-x8";
+    } else if (table.aes_gcm == CipherEngine::Backend::AesNi) {
+        table.aes_gcm_batch = aes_gcm::crypt_batch_aesni;
+        table.aes_gcm_batch_name = "aesni-x8";
+    }
+
+    if (table.chacha20 == ChaCha20Poly1305::Backend::Avx512) {
+        table.chacha20_xor = chacha::xor_avx512;
+    } else if (table.chacha20 == ChaCha20Poly1305::Backend::Avx2) {
+        table.chacha20_xor = chacha::xor_avx2;
+    }
+
+    if (f.sha_ni && f.ssse3 && f.sse41 && isa_level_enabled(IsaLevel::Sse41)) {
+        table.sha256_compress = sha256::compress_shani;
+        table.sha256_name = "sha-ni";
+    }
+
+    if (f.avx2 && isa_level_enabled(IsaLevel::Avx2)) {
+        table.ml_kem = &mlkem::AVX2_KERNELS;
+        table.ml_dsa = &mldsa::AVX2_KERNELS;
+        table.keccak_x4 = keccak::permute_x4_avx2;
+        table.keccak_name = "avx2-x4";
+    }
+    if (f.avx512f && isa_level_enabled(IsaLevel::Avx512)) {
+        table.keccak_x8 = keccak::permute_x8_avx512;
+        table.keccak_name = "avx512-x8";
+    }
+#endif
+    return table;
+}
+
+} // namespace
+
+IsaLevel detected_isa_level() {
+    const CpuFeatures& f = cpu_features();
+    if (f.avx2 && f.avx512f && f.avx512bw && f.avx512vl) return IsaLevel::Avx512;
+    if (f.avx2) return IsaLevel::Avx2;
+    if (f.ssse3 && f.sse41) return IsaLevel::Sse41;
+    return IsaLevel::Portable;
+}
+
+IsaLevel isa_level_cap() {
+    const IsaLevel detected = detected_isa_level();
+    const int forced = forced_cap.load(std::memory_order_relaxed);
+    if (forced == CAP_AUTO || forced > static_cast<int>(detected)) return detected;
+    return static_cast<IsaLevel>(forced);
+}
+
+bool isa_level_enabled(IsaLevel level) {
+    return static_cast<int>(level) <= static_cast<int>(isa_level_cap());
+}
+
+bool force_backend(std::string_view name) {
+    int cap = CAP_AUTO;
+    if (!parse_isa_level(name, cap)) {
+        std::cout << "[!] Unknown backend '" << name << "' (expected portable, sse4.1, avx2, avx512 or auto)"
+                  << std::endl;
+        return false;
+    }
+    if (kernels_bound.load(std::memory_order_relaxed)) {
+        std::cout << "[!] Kernels already bound, --force-backend must be applied at startup" << std::endl;
+        return false;
+    }
+    forced_cap.store(cap, std::memory_order_relaxed);
+    return true;
+}
+
+bool apply_force_backend_flag(int argc, char** argv) {
+    static constexpr std::string_view flag = "--force-backend";
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == flag) {
+            if (i + 1 >= argc) {
+                std::cout << "[!] --force-backend needs a value" << std::endl;
+                return false;
+            }
+            return force_backend(argv[i + 1]);
+        }
+        if (arg.size() > flag.size() && arg.substr(0, flag.size()) == flag && arg[flag.size()] == '=') {
+            return force_backend(arg.substr(flag.size() + 1));
+        }
+    }
+    return true;
+}
+
+const char* isa_level_name(IsaLevel level) {
+    switch (level) {
+    case IsaLevel::Portable:
+        return "portable";
+    case IsaLevel::Sse41:
+        return "sse4.1";
+    case IsaLevel::Avx2:
+        return "avx2";
+    case IsaLevel::Avx512:
+        return "avx512";
+    }
+    return "unknown";
+}
+
+const KernelTable& kernel_table() {
+    static const KernelTable table = bind_kernels();
+    return table;
+}
+
+std::string describe_kernels() {
+    const KernelTable& k = kernel_table();
+    std::string out = "isa=";
+    out += isa_level_name(k.level);
+    out += " aes-gcm=";
+    out += CipherEngine::backend_name(k.aes_gcm);
+    out += " aes-gcm-batch=";
+    out += k.aes_gcm_batch_name;
+    out += " chacha20=";
+    out += ChaCha20Poly1305::backend_name(k.chacha20);
+    out += " sha256=";
+    out += k.sha256_name;
+    out += " ml-kem=";
+    out += k.ml_kem->name;
+    out += " ml-dsa=";
+    out += k.ml_dsa->name;
+    out += " keccak=";
+    out += k.keccak_name;
+    return out;
+}
+
+} // namespace Crypto
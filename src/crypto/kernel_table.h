@@ -0,0 +1,50 @@
+#ifndef KERNEL_TABLE_H
+#define KERNEL_TABLE_H
+
+// Function pointers bound once per process by the kernel registry. Family
+// classes read their default backend from here; explicit-backend
+// constructors (benchmarks) still go through the family's own
+// backend_supported() check, which honours the same ISA cap.
+
+#include "aes_gcm_kernels.h"
+#include "chacha20_kernels.h"
+#include "sha256_kernels.h"
+#include "ml_kem_kernels.h"
+#include "ml_dsa_kernels.h"
+#include "keccak.h"
+#include "cipher_engine.h"
+#include "chacha20_poly1305.h"
+#include "kernel_registry.h"
+
+namespace Crypto {
+
+struct KernelTable {
+    IsaLevel level;
+
+    CipherEngine::Backend aes_gcm;
+    aes_gcm::CryptBatchFn aes_gcm_batch;        // null: one message at a time
+    const char* aes_gcm_batch_name;
+
+    ChaCha20Poly1305::Backend chacha20;
+    chacha::XorFn chacha20_xor;                 // the same backend's keystream (SecureRandom)
+
+    sha256::CompressFn sha256_compress;
+    const char* sha256_name;
+
+    // NTT, base multiplication, CBD sampling and four-way Keccak.
+    const mlkem::Kernels* ml_kem;
+    // NTT and pointwise products mod 8380417, four-way Keccak.
+    const mldsa::Kernels* ml_dsa;
+
+    // Multi-lane Keccak for hash-based signatures; keccak_x8 is null
+    // without AVX-512 and callers fall back to keccak_x4.
+    keccak::PermuteX4Fn keccak_x4;
+    keccak::PermuteX8Fn keccak_x8;
+    const char* keccak_name;
+};
+
+const KernelTable& kernel_table();
+
+} // namespace Crypto
+
+#endif // KERNEL_TABLE_H
@@ -0,0 +1,682 @@
+#include "ml_dsa.h"
+#include "ml_dsa_kernels.h"
+#include "kernel_table.h"
+#include "secure_random.h"
+
+#include <cstring>
+
+namespace Crypto {
+
+using mldsa::K;
+using mldsa::L;
+using mldsa::N;
+using mldsa::Poly;
+using mldsa::Q;
+
+struct alignas(32) MlDsa87::ExpandedPublicKey {
+    Poly a[K][L];       // A_hat
+    Poly t1[K];         // NTT(t1 * 2^d)
+    uint8_t tr[64];
+};
+
+namespace {
+
+constexpr size_t RHO_BYTES = 32;
+constexpr size_t CRH_BYTES = 64;
+constexpr size_t TR_BYTES = 64;
+constexpr size_t CTILDE_BYTES = 64;
+constexpr size_t POLYT1_BYTES = 320;
+constexpr size_t POLYT0_BYTES = 416;
+constexpr size_t POLYETA_BYTES = 96;
+constexpr size_t POLYZ_BYTES = 640;
+constexpr size_t POLYW1_BYTES = 128;
+constexpr size_t UNIFORM_BLOCKS = 5;    // 840 bytes: enough for 256 samples almost always
+constexpr size_t ETA_BLOCKS = 1;
+constexpr size_t GAMMA1_BLOCKS = 5;     // 680 bytes >= POLYZ_BYTES
+
+static_assert(RHO_BYTES + K * POLYT1_BYTES == MlDsa87::PUBLIC_KEY_SIZE);
+static_assert(2 * RHO_BYTES + TR_BYTES + (K + L) * POLYETA_BYTES + K * POLYT0_BYTES == MlDsa87::SECRET_KEY_SIZE);
+static_assert(CTILDE_BYTES + L * POLYZ_BYTES + mldsa::OMEGA + K == MlDsa87::SIGNATURE_SIZE);
+static_assert(GAMMA1_BLOCKS * keccak::SHAKE256_RATE >= POLYZ_BYTES);
+
+struct PolyVecL {
+    Poly vec[L];
+};
+
+struct PolyVecK {
+    Poly vec[K];
+};
+
+const mldsa::Kernels& kernels() {
+    return *kernel_table().ml_dsa;
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+int32_t reduce32(int32_t a) {
+    const int32_t t = (a + (1 << 22)) >> 23;
+    return a - t * Q;
+}
+
+int32_t caddq(int32_t a) {
+    return a + ((a >> 31) & Q);
+}
+
+void poly_reduce(Poly& a) {
+    for (int i = 0; i < N; ++i) a.coeffs[i] = reduce32(a.coeffs[i]);
+}
+
+void poly_caddq(Poly& a) {
+    for (int i = 0; i < N; ++i) a.coeffs[i] = caddq(a.coeffs[i]);
+}
+
+void poly_add(Poly& r, const Poly& a) {
+    for (int i = 0; i < N; ++i) r.coeffs[i] += a.coeffs[i];
+}
+
+void poly_sub(Poly& r, const Poly& a) {
+    for (int i = 0; i < N; ++i) r.coeffs[i] -= a.coeffs[i];
+}
+
+// True if some coefficient of a reduced polynomial has |c| >= bound.
+bool poly_exceeds(const Poly& a, int32_t bound) {
+    bool out = false;
+    for (int i = 0; i < N; ++i) {
+        int32_t t = a.coeffs[i] >> 31;
+        t = a.coeffs[i] - (t & 2 * a.coeffs[i]);
+        out |= t >= bound;
+    }
+    return out;
+}
+
+// a = a1 * 2^d + a0 with a0 in (-2^(d-1), 2^(d-1)], for a in [0, q).
+int32_t power2round(int32_t& a0, int32_t a) {
+    const int32_t a1 = (a + (1 << (mldsa::D - 1)) - 1) >> mldsa::D;
+    a0 = a - (a1 << mldsa::D);
+    return a1;
+}
+
+// a = a1 * 2 gamma2 + a0 with a0 centered, a1 in [0, 16), for a in [0, q).
+int32_t decompose(int32_t& a0, int32_t a) {
+    int32_t a1 = (a + 127) >> 7;
+    a1 = (a1 * 1025 + (1 << 21)) >> 22;
+    a1 &= 15;
+    a0 = a - a1 * 2 * mldsa::GAMMA2;
+    a0 -= (((Q - 1) / 2 - a0) >> 31) & Q;
+    return a1;
+}
+
+int32_t make_hint(int32_t a0, int32_t a1) {
+    return (a0 > mldsa::GAMMA2 || a0 < -mldsa::GAMMA2 || (a0 == -mldsa::GAMMA2 && a1 != 0)) ? 1 : 0;
+}
+
+int32_t use_hint(int32_t a, int32_t hint) {
+    int32_t a0;
+    const int32_t a1 = decompose(a0, a);
+    if (hint == 0) return a1;
+    return a0 > 0 ? (a1 + 1) & 15 : (a1 - 1) & 15;
+}
+
+// SimpleBitPack / BitPack: map(c) is the unsigned value stored for
+// coefficient c, `bits` bits each, least significant bit first.
+template <typename Map>
+void pack_bits(uint8_t* r, const Poly& a, int bits, Map map) {
+    uint64_t acc = 0;
+    int filled = 0;
+    for (int i = 0; i < N; ++i) {
+        acc |= static_cast<uint64_t>(map(a.coeffs[i])) << filled;
+        filled += bits;
+        while (filled >= 8) {
+            *r++ = static_cast<uint8_t>(acc);
+            acc >>= 8;
+            filled -= 8;
+        }
+    }
+}
+
+template <typename Map>
+void unpack_bits(Poly& r, const uint8_t* a, int bits, Map map) {
+    const uint32_t mask = (1u << bits) - 1;
+    uint64_t acc = 0;
+    int filled = 0;
+    for (int i = 0; i < N; ++i) {
+        while (filled < bits) {
+            acc |= static_cast<uint64_t>(*a++) << filled;
+            filled += 8;
+        }
+        r.coeffs[i] = map(static_cast<uint32_t>(acc) & mask);
+        acc >>= bits;
+        filled -= bits;
+    }
+}
+
+void polyt1_pack(uint8_t* r, const Poly& a) {
+    pack_bits(r, a, 10, [](int32_t c) { return static_cast<uint32_t>(c); });
+}
+
+void polyt1_unpack(Poly& r, const uint8_t* a) {
+    unpack_bits(r, a, 10, [](uint32_t v) { return static_cast<int32_t>(v); });
+}
+
+void polyt0_pack(uint8_t* r, const Poly& a) {
+    pack_bits(r, a, mldsa::D, [](int32_t c) { return static_cast<uint32_t>((1 << (mldsa::D - 1)) - c); });
+}
+
+void polyt0_unpack(Poly& r, const uint8_t* a) {
+    unpack_bits(r, a, mldsa::D, [](uint32_t v) { return (1 << (mldsa::D - 1)) - static_cast<int32_t>(v); });
+}
+
+void polyeta_pack(uint8_t* r, const Poly& a) {
+    pack_bits(r, a, 3, [](int32_t c) { return static_cast<uint32_t>(mldsa::ETA - c); });
+}
+
+void polyeta_unpack(Poly& r, const uint8_t* a) {
+    unpack_bits(r, a, 3, [](uint32_t v) { return mldsa::ETA - static_cast<int32_t>(v); });
+}
+
+void polyz_pack(uint8_t* r, const Poly& a) {
+    pack_bits(r, a, 20, [](int32_t c) { return static_cast<uint32_t>(mldsa::GAMMA1 - c); });
+}
+
+void polyz_unpack(Poly& r, const uint8_t* a) {
+    unpack_bits(r, a, 20, [](uint32_t v) { return mldsa::GAMMA1 - static_cast<int32_t>(v); });
+}
+
+void polyw1_pack(uint8_t* r, const Poly& a) {
+    pack_bits(r, a, 4, [](int32_t c) { return static_cast<uint32_t>(c); });
+}
+
+// RejNTTPoly: 23-bit candidates below q, in stream order.
+int rej_uniform(int32_t* a, int needed, const uint8_t* buf, size_t len) {
+    int count = 0;
+    for (size_t pos = 0; count < needed && pos + 3 <= len; pos += 3) {
+        const uint32_t t = (buf[pos] | (static_cast<uint32_t>(buf[pos + 1]) << 8) |
+                            (static_cast<uint32_t>(buf[pos + 2]) << 16)) & 0x7FFFFF;
+        if (t < static_cast<uint32_t>(Q)) a[count++] = static_cast<int32_t>(t);
+    }
+    return count;
+}
+
+// RejBoundedPoly for eta = 2: nibbles below 15, reduced mod 5.
+int rej_eta(int32_t* a, int needed, const uint8_t* buf, size_t len) {
+    int count = 0;
+    for (size_t pos = 0; count < needed && pos < len; ++pos) {
+        uint32_t t0 = buf[pos] & 0x0F;
+        uint32_t t1 = buf[pos] >> 4;
+        if (t0 < 15) {
+            t0 = t0 - ((205 * t0) >> 10) * 5;
+            a[count++] = 2 - static_cast<int32_t>(t0);
+        }
+        if (t1 < 15 && count < needed) {
+            t1 = t1 - ((205 * t1) >> 10) * 5;
+            a[count++] = 2 - static_cast<int32_t>(t1);
+        }
+    }
+    return count;
+}
+
+// ExpandMask output is not rejection sampled: the first 640 bytes decode.
+int unpack_gamma1(int32_t* a, int needed, const uint8_t* buf, size_t len) {
+    if (needed != N || len < POLYZ_BYTES) return 0;
+    Poly p;
+    polyz_unpack(p, buf);
+    std::memcpy(a, p.coeffs, sizeof(p.coeffs));
+    return N;
+}
+
+using SampleFn = int (*)(int32_t* a, int needed, const uint8_t* buf, size_t len);
+
+// out[i] = sample(XOF(seed || nonces[i])), nonce as two little-endian
+// bytes. Polynomials go four at a time through one four-way SHAKE.
+void sample_polys(Poly* const* out, const uint16_t* nonces, size_t count, const uint8_t* seed, size_t seed_len,
+                  size_t rate, size_t blocks, SampleFn sample) {
+    const keccak::PermuteX4Fn permute_x4 = kernels().permute_x4;
+    alignas(32) uint8_t seeds[4][CRH_BYTES + 2];
+    alignas(32) uint8_t buf[4][UNIFORM_BLOCKS * keccak::SHAKE128_RATE];
+    static_assert(GAMMA1_BLOCKS * keccak::SHAKE256_RATE <= sizeof(buf[0]));
+    Poly spare;
+    const uint8_t* in[4];
+    uint8_t* bufs[4];
+
+    for (size_t first = 0; first < count; first += 4) {
+        Poly* r[4];
+        for (size_t j = 0; j < 4; ++j) {
+            const size_t idx = first + j < count ? first + j : count - 1;
+            r[j] = first + j < count ? out[idx] : &spare;
+            std::memcpy(seeds[j], seed, seed_len);
+            seeds[j][seed_len] = static_cast<uint8_t>(nonces[idx]);
+            seeds[j][seed_len + 1] = static_cast<uint8_t>(nonces[idx] >> 8);
+            in[j] = seeds[j];
+            bufs[j] = buf[j];
+        }
+        keccak::X4State state;
+        keccak::absorb_x4(state, rate, in, seed_len + 2, permute_x4);
+        keccak::squeeze_x4(state, rate, bufs, blocks, permute_x4);
+
+        int ctr[4];
+        for (int j = 0; j < 4; ++j) ctr[j] = sample(r[j]->coeffs, N, buf[j], blocks * rate);
+        while (ctr[0] < N || ctr[1] < N || ctr[2] < N || ctr[3] < N) {
+            keccak::squeeze_x4(state, rate, bufs, 1, permute_x4);
+            for (int j = 0; j < 4; ++j) ctr[j] += sample(r[j]->coeffs + ctr[j], N - ctr[j], buf[j], rate);
+        }
+        secure_wipe(&state, sizeof(state));
+    }
+    secure_wipe(buf, sizeof(buf));
+    secure_wipe(&spare, sizeof(spare));
+}
+
+// ExpandA: A_hat[i][j] = RejNTTPoly(rho || j || i).
+void expand_matrix(Poly a[K][L], const uint8_t rho[RHO_BYTES]) {
+    Poly* out[K * L];
+    uint16_t nonces[K * L];
+    for (int i = 0; i < K; ++i) {
+        for (int j = 0; j < L; ++j) {
+            out[i * L + j] = &a[i][j];
+            nonces[i * L + j] = static_cast<uint16_t>((i << 8) + j);
+        }
+    }
+    sample_polys(out, nonces, K * L, rho, RHO_BYTES, keccak::SHAKE128_RATE, UNIFORM_BLOCKS, rej_uniform);
+}
+
+// ExpandS: s1 from nonces 0..l-1, s2 from l..l+k-1.
+void expand_secrets(PolyVecL& s1, PolyVecK& s2, const uint8_t rhoprime[CRH_BYTES]) {
+    Poly* out[K + L];
+    uint16_t nonces[K + L];
+    for (int i = 0; i < L; ++i) out[i] = &s1.vec[i];
+    for (int i = 0; i < K; ++i) out[L + i] = &s2.vec[i];
+    for (int i = 0; i < K + L; ++i) nonces[i] = static_cast<uint16_t>(i);
+    sample_polys(out, nonces, K + L, rhoprime, CRH_BYTES, keccak::SHAKE256_RATE, ETA_BLOCKS, rej_eta);
+}
+
+// ExpandMask(rho'', kappa).
+void expand_mask(PolyVecL& y, const uint8_t rhoprime[CRH_BYTES], uint16_t kappa) {
+    Poly* out[L];
+    uint16_t nonces[L];
+    for (int i = 0; i < L; ++i) {
+        out[i] = &y.vec[i];
+        nonces[i] = static_cast<uint16_t>(kappa + i);
+    }
+    sample_polys(out, nonces, L, rhoprime, CRH_BYTES, keccak::SHAKE256_RATE, GAMMA1_BLOCKS, unpack_gamma1);
+}
+
+// SampleInBall: tau coefficients set to +-1 by a Fisher-Yates walk.
+void sample_in_ball(Poly& c, const uint8_t c_tilde[CTILDE_BYTES]) {
+    uint8_t buf[keccak::SHAKE256_RATE];
+    keccak::Sponge xof(keccak::SHAKE256_RATE, 0x1F);
+    xof.absorb(c_tilde, CTILDE_BYTES);
+    xof.squeeze_blocks(buf, 1);
+
+    uint64_t signs = 0;
+    for (int i = 0; i < 8; ++i) signs |= static_cast<uint64_t>(buf[i]) << (8 * i);
+    size_t pos = 8;
+
+    std::memset(c.coeffs, 0, sizeof(c.coeffs));
+    for (int i = N - mldsa::TAU; i < N; ++i) {
+        int b;
+        do {
+            if (pos >= sizeof(buf)) {
+                xof.squeeze_blocks(buf, 1);
+                pos = 0;
+            }
+            b = buf[pos++];
+        } while (b > i);
+        c.coeffs[i] = c.coeffs[b];
+        c.coeffs[b] = 1 - 2 * static_cast<int32_t>(signs & 1);
+        signs >>= 1;
+    }
+}
+
+// mu = H(tr || M'), M' = 0 || |ctx| || ctx || M for pure ML-DSA.
+void message_representative(uint8_t mu[CRH_BYTES], const uint8_t tr[TR_BYTES], std::span<const uint8_t> context,
+                            std::span<const uint8_t> message) {
+    const uint8_t prefix[2] = {0, static_cast<uint8_t>(context.size())};
+    keccak::Sponge h(keccak::SHAKE256_RATE, 0x1F);
+    h.absorb(tr, TR_BYTES);
+    h.absorb(prefix, sizeof(prefix));
+    h.absorb(context.data(), context.size());
+    h.absorb(message.data(), message.size());
+    h.squeeze(mu, CRH_BYTES);
+}
+
+// c_tilde = H(mu || w1Encode(w1)).
+void commitment_hash(uint8_t c_tilde[CTILDE_BYTES], const uint8_t mu[CRH_BYTES], const PolyVecK& w1) {
+    uint8_t packed[K * POLYW1_BYTES];
+    for (int i = 0; i < K; ++i) polyw1_pack(packed + i * POLYW1_BYTES, w1.vec[i]);
+    keccak::Sponge h(keccak::SHAKE256_RATE, 0x1F);
+    h.absorb(mu, CRH_BYTES);
+    h.absorb(packed, sizeof(packed));
+    h.squeeze(c_tilde, CTILDE_BYTES);
+}
+
+// HintBitPack: positions of the set bits, then the running count per row.
+void pack_hint(uint8_t* r, const PolyVecK& h) {
+    std::memset(r, 0, mldsa::OMEGA + K);
+    int k = 0;
+    for (int i = 0; i < K; ++i) {
+        for (int j = 0; j < N; ++j) {
+            if (h.vec[i].coeffs[j] != 0) r[k++] = static_cast<uint8_t>(j);
+        }
+        r[mldsa::OMEGA + i] = static_cast<uint8_t>(k);
+    }
+}
+
+// HintBitUnpack, rejecting non-canonical encodings (unsorted positions,
+// decreasing counts, non-zero padding) so signatures are not malleable.
+bool unpack_hint(PolyVecK& h, const uint8_t* r) {
+    std::memset(&h, 0, sizeof(h));
+    int k = 0;
+    for (int i = 0; i < K; ++i) {
+        const int end = r[mldsa::OMEGA + i];
+        if (end < k || end > mldsa::OMEGA) return false;
+        for (int j = k; j < end; ++j) {
+            if (j > k && r[j] <= r[j - 1]) return false;
+            h.vec[i].coeffs[r[j]] = 1;
+        }
+        k = end;
+    }
+    for (int j = k; j < mldsa::OMEGA; ++j) {
+        if (r[j] != 0) return false;
+    }
+    return true;
+}
+
+void ntt_all(Poly* p, size_t count) {
+    const mldsa::Kernels& k = kernels();
+    for (size_t i = 0; i < count; ++i) k.ntt(p[i]);
+}
+
+} // namespace
+
+MlDsa87::KeyPair MlDsa87::generate_keypair() {
+    Seed xi;
+    SecureRandom::fill(xi);
+    KeyPair kp = generate_keypair(xi);
+    secure_wipe(xi.data(), xi.size());
+    return kp;
+}
+
+// pk = rho || t1, sk = rho || K || tr || s1 || s2 || t0
+MlDsa87::KeyPair MlDsa87::generate_keypair(const Seed& xi) {
+    const mldsa::Kernels& k = kernels();
+
+    // (rho, rho', K) = H(xi || k || l)
+    uint8_t seedbuf[2 * RHO_BYTES + CRH_BYTES];
+    uint8_t input[SEED_SIZE + 2];
+    std::memcpy(input, xi.data(), SEED_SIZE);
+    input[SEED_SIZE] = K;
+    input[SEED_SIZE + 1] = L;
+    keccak::shake256(seedbuf, sizeof(seedbuf), input, sizeof(input));
+    const uint8_t* rho = seedbuf;
+    const uint8_t* rhoprime = seedbuf + RHO_BYTES;
+    const uint8_t* key = seedbuf + RHO_BYTES + CRH_BYTES;
+
+    Poly a[K][L];
+    expand_matrix(a, rho);
+    PolyVecL s1, s1_hat;
+    PolyVecK s2, t1, t0;
+    expand_secrets(s1, s2, rhoprime);
+    s1_hat = s1;
+    ntt_all(s1_hat.vec, L);
+
+    KeyPair kp;
+    uint8_t* pk = kp.public_key.data();
+    std::memcpy(pk, rho, RHO_BYTES);
+    for (int i = 0; i < K; ++i) {
+        Poly& t = t1.vec[i];
+        k.pointwise_acc(t, a[i], s1_hat.vec, L);
+        poly_reduce(t);
+        k.invntt_tomont(t);
+        poly_add(t, s2.vec[i]);
+        poly_caddq(t);
+        for (int j = 0; j < N; ++j) t.coeffs[j] = power2round(t0.vec[i].coeffs[j], t.coeffs[j]);
+        polyt1_pack(pk + RHO_BYTES + i * POLYT1_BYTES, t);
+    }
+
+    uint8_t* sk = kp.secret_key.data();
+    std::memcpy(sk, rho, RHO_BYTES);
+    std::memcpy(sk + RHO_BYTES, key, RHO_BYTES);
+    keccak::shake256(sk + 2 * RHO_BYTES, TR_BYTES, pk, PUBLIC_KEY_SIZE);
+    uint8_t* p = sk + 2 * RHO_BYTES + TR_BYTES;
+    for (int i = 0; i < L; ++i, p += POLYETA_BYTES) polyeta_pack(p, s1.vec[i]);
+    for (int i = 0; i < K; ++i, p += POLYETA_BYTES) polyeta_pack(p, s2.vec[i]);
+    for (int i = 0; i < K; ++i, p += POLYT0_BYTES) polyt0_pack(p, t0.vec[i]);
+
+    secure_wipe(seedbuf, sizeof(seedbuf));
+    secure_wipe(input, sizeof(input));
+    secure_wipe(&s1, sizeof(s1));
+    secure_wipe(&s1_hat, sizeof(s1_hat));
+    secure_wipe(&s2, sizeof(s2));
+    secure_wipe(&t0, sizeof(t0));
+    return kp;
+}
+
+std::optional<MlDsa87::Signature> MlDsa87::sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                std::span<const uint8_t> message,
+                                                std::span<const uint8_t> context) {
+    Seed rnd;
+    SecureRandom::fill(rnd);
+    auto sig = sign(secret_key, message, context, rnd);
+    secure_wipe(rnd.data(), rnd.size());
+    return sig;
+}
+
+std::optional<MlDsa87::Signature> MlDsa87::sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                std::span<const uint8_t> message,
+                                                std::span<const uint8_t> context, const Seed& rnd) {
+    if (context.size() > MAX_CONTEXT_SIZE) {
+        return std::nullopt;
+    }
+    const mldsa::Kernels& k = kernels();
+
+    const uint8_t* sk = secret_key.data();
+    const uint8_t* rho = sk;
+    const uint8_t* key = sk + RHO_BYTES;
+    const uint8_t* tr = sk + 2 * RHO_BYTES;
+    PolyVecL s1;
+    PolyVecK s2, t0;
+    const uint8_t* p = sk + 2 * RHO_BYTES + TR_BYTES;
+    for (int i = 0; i < L; ++i, p += POLYETA_BYTES) polyeta_unpack(s1.vec[i], p);
+    for (int i = 0; i < K; ++i, p += POLYETA_BYTES) polyeta_unpack(s2.vec[i], p);
+    for (int i = 0; i < K; ++i, p += POLYT0_BYTES) polyt0_unpack(t0.vec[i], p);
+    ntt_all(s1.vec, L);
+    ntt_all(s2.vec, K);
+    ntt_all(t0.vec, K);
+
+    Poly a[K][L];
+    expand_matrix(a, rho);
+
+    uint8_t mu[CRH_BYTES];
+    message_representative(mu, tr, context, message);
+
+    // rho'' = H(K || rnd || mu)
+    uint8_t rhoprime[CRH_BYTES];
+    keccak::Sponge h(keccak::SHAKE256_RATE, 0x1F);
+    h.absorb(key, RHO_BYTES);
+    h.absorb(rnd.data(), rnd.size());
+    h.absorb(mu, CRH_BYTES);
+    h.squeeze(rhoprime, CRH_BYTES);
+
+    Signature sig;
+    uint8_t* c_tilde = sig.data();
+    PolyVecL y, z;
+    PolyVecK w1, w0, hint;
+    Poly c, t;
+    for (uint16_t kappa = 0;; kappa = static_cast<uint16_t>(kappa + L)) {
+        expand_mask(y, rhoprime, kappa);
+        z = y;
+        ntt_all(z.vec, L);
+
+        // w = A y, split into high bits w1 (committed) and low bits w0.
+        for (int i = 0; i < K; ++i) {
+            k.pointwise_acc(w1.vec[i], a[i], z.vec, L);
+            poly_reduce(w1.vec[i]);
+            k.invntt_tomont(w1.vec[i]);
+            poly_caddq(w1.vec[i]);
+            for (int j = 0; j < N; ++j) {
+                w1.vec[i].coeffs[j] = decompose(w0.vec[i].coeffs[j], w1.vec[i].coeffs[j]);
+            }
+        }
+        commitment_hash(c_tilde, mu, w1);
+        sample_in_ball(c, c_tilde);
+        k.ntt(c);
+
+        // z = y + c s1
+        bool reject = false;
+        for (int i = 0; i < L && !reject; ++i) {
+            k.pointwise_acc(z.vec[i], &c, &s1.vec[i], 1);
+            k.invntt_tomont(z.vec[i]);
+            poly_add(z.vec[i], y.vec[i]);
+            poly_reduce(z.vec[i]);
+            reject = poly_exceeds(z.vec[i], mldsa::GAMMA1 - mldsa::BETA);
+        }
+        if (reject) continue;
+
+        // r0 = LowBits(w - c s2), then the hint for -c t0.
+        int hints = 0;
+        for (int i = 0; i < K && !reject; ++i) {
+            k.pointwise_acc(t, &c, &s2.vec[i], 1);
+            k.invntt_tomont(t);
+            poly_sub(w0.vec[i], t);
+            poly_reduce(w0.vec[i]);
+            if (poly_exceeds(w0.vec[i], mldsa::GAMMA2 - mldsa::BETA)) {
+                reject = true;
+                break;
+            }
+            k.pointwise_acc(t, &c, &t0.vec[i], 1);
+            k.invntt_tomont(t);
+            poly_reduce(t);
+            if (poly_exceeds(t, mldsa::GAMMA2)) {
+                reject = true;
+                break;
+            }
+            poly_add(w0.vec[i], t);
+            for (int j = 0; j < N; ++j) {
+                hint.vec[i].coeffs[j] = make_hint(w0.vec[i].coeffs[j], w1.vec[i].coeffs[j]);
+                hints += hint.vec[i].coeffs[j];
+            }
+        }
+        if (reject || hints > mldsa::OMEGA) continue;
+        break;
+    }
+
+    uint8_t* out = sig.data() + CTILDE_BYTES;
+    for (int i = 0; i < L; ++i, out += POLYZ_BYTES) polyz_pack(out, z.vec[i]);
+    pack_hint(out, hint);
+
+    secure_wipe(&s1, sizeof(s1));
+    secure_wipe(&s2, sizeof(s2));
+    secure_wipe(&t0, sizeof(t0));
+    secure_wipe(&y, sizeof(y));
+    secure_wipe(&w0, sizeof(w0));
+    secure_wipe(rhoprime, sizeof(rhoprime));
+    return sig;
+}
+
+std::shared_ptr<const MlDsa87::ExpandedPublicKey> MlDsa87::expand_public_key(
+    std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key) {
+    const mldsa::Kernels& k = kernels();
+    auto key = std::make_shared<ExpandedPublicKey>();
+    expand_matrix(key->a, public_key.data());
+    for (int i = 0; i < K; ++i) {
+        polyt1_unpack(key->t1[i], public_key.data() + RHO_BYTES + i * POLYT1_BYTES);
+        for (int j = 0; j < N; ++j) key->t1[i].coeffs[j] <<= mldsa::D;
+        k.ntt(key->t1[i]);
+    }
+    keccak::shake256(key->tr, TR_BYTES, public_key.data(), PUBLIC_KEY_SIZE);
+    return key;
+}
+
+bool MlDsa87::verify(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key, std::span<const uint8_t> message,
+                     std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context) {
+    return verify(*expand_public_key(public_key), message, signature, context);
+}
+
+bool MlDsa87::verify(const ExpandedPublicKey& key, std::span<const uint8_t> message,
+                     std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context) {
+    if (context.size() > MAX_CONTEXT_SIZE) {
+        return false;
+    }
+    const mldsa::Kernels& k = kernels();
+
+    const uint8_t* c_tilde = signature.data();
+    PolyVecL z;
+    PolyVecK hint;
+    const uint8_t* p = signature.data() + CTILDE_BYTES;
+    for (int i = 0; i < L; ++i, p += POLYZ_BYTES) {
+        polyz_unpack(z.vec[i], p);
+        if (poly_exceeds(z.vec[i], mldsa::GAMMA1 - mldsa::BETA)) return false;
+    }
+    if (!unpack_hint(hint, p)) {
+        return false;
+    }
+
+    uint8_t mu[CRH_BYTES];
+    message_representative(mu, key.tr, context, message);
+
+    Poly c;
+    sample_in_ball(c, c_tilde);
+    k.ntt(c);
+    ntt_all(z.vec, L);
+
+    // w1' = UseHint(h, A z - c t1 2^d)
+    PolyVecK w1;
+    Poly t;
+    for (int i = 0; i < K; ++i) {
+        k.pointwise_acc(w1.vec[i], key.a[i], z.vec, L);
+        k.pointwise_acc(t, &c, &key.t1[i], 1);
+        poly_sub(w1.vec[i], t);
+        poly_reduce(w1.vec[i]);
+        k.invntt_tomont(w1.vec[i]);
+        poly_caddq(w1.vec[i]);
+        for (int j = 0; j < N; ++j) w1.vec[i].coeffs[j] = use_hint(w1.vec[i].coeffs[j], hint.vec[i].coeffs[j]);
+    }
+
+    uint8_t expected[CTILDE_BYTES];
+    commitment_hash(expected, mu, w1);
+    return std::memcmp(expected, c_tilde, CTILDE_BYTES) == 0;
+}
+
+const char* MlDsa87::backend_name() {
+    return kernels().name;
+}
+
+MlDsa87::KeyCache::KeyCache(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {}
+
+std::shared_ptr<const MlDsa87::ExpandedPublicKey> MlDsa87::KeyCache::get(
+    std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key) {
+    const std::string_view lookup(reinterpret_cast<const char*>(public_key.data()), public_key.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = index_.find(lookup);
+        if (it != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, it->second);
+            return it->second->second;
+        }
+    }
+
+    // Expand outside the lock: it costs as much as several verifications.
+    auto expanded = expand_public_key(public_key);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(lookup);
+    if (it != index_.end()) {
+        return it->second->second;     // another thread won the race
+    }
+    entries_.emplace_front(std::string(lookup), expanded);
+    index_.emplace(entries_.front().first, entries_.begin());
+    if (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+    return expanded;
+}
+
+size_t MlDsa87::KeyCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+} // namespace Crypto
@@ -0,0 +1,242 @@
+#include "ml_dsa_kernels.h"
+
+// AVX2 ML-DSA polynomial arithmetic. A polynomial is 32 ymm vectors of
+// eight int32 coefficients, processed in four groups of eight registers.
+// The two widest NTT layers run across groups, the next three pair
+// registers inside a group, and for the last three the 8x8 group is
+// transposed so those layers pair registers as well, with per-lane
+// twiddles; it is transposed back so the NTT domain keeps the FIPS 204
+// order. This is the same scheme as ml_kem_avx2.cpp at half the lane
+// count. Montgomery products use VPMULDQ on even and odd lanes and match
+// the portable code bit for bit.
+// Built with -mavx2; only reached after the kernel registry has confirmed
+// CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace mldsa {
+
+namespace {
+
+struct alignas(32) LaneZetas {
+    int32_t z[8];
+};
+
+// Twiddles of the transposed layers for lane l of group g, registers served
+// by table entry h: len 4 uses ZETAS[32 + 8g + l], len 2 ZETAS[64 + 2(8g + l)
+// + h], len 1 ZETAS[128 + 4(8g + l) + h]. The inverse reads the same blocks
+// from the end of each layer's range, negated, as invntt_tomont_portable()
+// does.
+constexpr LaneZetas lane_zetas(int len, int g, int h, bool inverse) {
+    const int base = 128 / len;     // first zeta index of the layer
+    const int stride = 4 / len;     // blocks per 8 coefficients
+    LaneZetas t{};
+    for (int l = 0; l < 8; ++l) {
+        const int block = stride * (8 * g + l) + h;
+        t.z[l] = inverse ? -ZETAS[2 * base - 1 - block] : ZETAS[base + block];
+    }
+    return t;
+}
+
+template <int Len, bool Inverse>
+constexpr std::array<std::array<LaneZetas, 4 / Len>, 4> lane_table() {
+    std::array<std::array<LaneZetas, 4 / Len>, 4> t{};
+    for (int g = 0; g < 4; ++g) {
+        for (int h = 0; h < 4 / Len; ++h) t[g][h] = lane_zetas(Len, g, h, Inverse);
+    }
+    return t;
+}
+
+constexpr auto NTT_LEN4 = lane_table<4, false>();
+constexpr auto NTT_LEN2 = lane_table<2, false>();
+constexpr auto NTT_LEN1 = lane_table<1, false>();
+constexpr auto INVNTT_LEN4 = lane_table<4, true>();
+constexpr auto INVNTT_LEN2 = lane_table<2, true>();
+constexpr auto INVNTT_LEN1 = lane_table<1, true>();
+
+inline __m256i load(const int32_t* p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline void store(int32_t* p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// montgomery_reduce(a * b) per lane: 64-bit products of the even and the
+// odd lanes, each reduced to its high half.
+inline __m256i mont_mul(__m256i a, __m256i b) {
+    const __m256i q = _mm256_set1_epi32(Q);
+    const __m256i qinv = _mm256_set1_epi32(QINV);
+    const __m256i p_even = _mm256_mul_epi32(a, b);
+    const __m256i p_odd = _mm256_mul_epi32(_mm256_srli_epi64(a, 32), _mm256_srli_epi64(b, 32));
+    const __m256i t_even = _mm256_mul_epi32(_mm256_mul_epi32(p_even, qinv), q);
+    const __m256i t_odd = _mm256_mul_epi32(_mm256_mul_epi32(p_odd, qinv), q);
+    const __m256i r_even = _mm256_srli_epi64(_mm256_sub_epi64(p_even, t_even), 32);
+    const __m256i r_odd = _mm256_sub_epi64(p_odd, t_odd);
+    return _mm256_blend_epi32(r_even, r_odd, 0xAA);
+}
+
+inline void ct_butterfly(__m256i& a, __m256i& b, __m256i z) {
+    const __m256i t = mont_mul(b, z);
+    b = _mm256_sub_epi32(a, t);
+    a = _mm256_add_epi32(a, t);
+}
+
+inline void gs_butterfly(__m256i& a, __m256i& b, __m256i z) {
+    const __m256i t = a;
+    a = _mm256_add_epi32(t, b);
+    b = mont_mul(_mm256_sub_epi32(t, b), z);
+}
+
+// 8x8 transpose of 32-bit words.
+inline void transpose8(__m256i r[8]) {
+    __m256i t[8], u[8];
+    for (int i = 0; i < 4; ++i) {
+        t[2 * i] = _mm256_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm256_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+    }
+    for (int i = 0; i < 2; ++i) {
+        u[4 * i] = _mm256_unpacklo_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm256_unpackhi_epi64(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm256_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm256_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[i] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x20);
+        r[i + 4] = _mm256_permute2x128_si256(u[i], u[i + 4], 0x31);
+    }
+}
+
+// Layer with butterflies Dist registers apart inside group g (len = 8 Dist).
+template <int Dist, bool Inverse>
+inline void register_layer(__m256i r[8], int g) {
+    constexpr int len = 8 * Dist;
+    constexpr int base = 128 / len;
+    for (int i = 0; i < 8; ++i) {
+        if (i & Dist) continue;
+        const int block = (8 * g + i) * 8 / (2 * len);
+        if (Inverse) {
+            gs_butterfly(r[i], r[i + Dist], _mm256_set1_epi32(-ZETAS[2 * base - 1 - block]));
+        } else {
+            ct_butterfly(r[i], r[i + Dist], _mm256_set1_epi32(ZETAS[base + block]));
+        }
+    }
+}
+
+// Layer on a transposed group: register c holds coefficient c of each of the
+// eight original vectors, so distance Len pairs registers c and c + Len.
+template <int Len, bool Inverse, size_t H>
+inline void lane_layer(__m256i r[8], const std::array<LaneZetas, H>& zetas) {
+    for (int c = 0; c < 8; ++c) {
+        if (c & Len) continue;
+        const __m256i z = _mm256_load_si256(reinterpret_cast<const __m256i*>(zetas[c / (2 * Len)].z));
+        if (Inverse) {
+            gs_butterfly(r[c], r[c + Len], z);
+        } else {
+            ct_butterfly(r[c], r[c + Len], z);
+        }
+    }
+}
+
+void ntt_avx2(Poly& p) {
+    int32_t* a = p.coeffs;
+
+    // len 128 and 64: vectors i, i + 8, i + 16, i + 24.
+    const __m256i z1 = _mm256_set1_epi32(ZETAS[1]);
+    const __m256i z2 = _mm256_set1_epi32(ZETAS[2]);
+    const __m256i z3 = _mm256_set1_epi32(ZETAS[3]);
+    for (int i = 0; i < 8; ++i) {
+        __m256i r0 = load(a + 8 * i);
+        __m256i r1 = load(a + 8 * i + 64);
+        __m256i r2 = load(a + 8 * i + 128);
+        __m256i r3 = load(a + 8 * i + 192);
+        ct_butterfly(r0, r2, z1);
+        ct_butterfly(r1, r3, z1);
+        ct_butterfly(r0, r1, z2);
+        ct_butterfly(r2, r3, z3);
+        store(a + 8 * i, r0);
+        store(a + 8 * i + 64, r1);
+        store(a + 8 * i + 128, r2);
+        store(a + 8 * i + 192, r3);
+    }
+
+    for (int g = 0; g < 4; ++g) {
+        __m256i r[8];
+        for (int i = 0; i < 8; ++i) r[i] = load(a + 64 * g + 8 * i);
+        register_layer<4, false>(r, g);
+        register_layer<2, false>(r, g);
+        register_layer<1, false>(r, g);
+        transpose8(r);
+        lane_layer<4, false>(r, NTT_LEN4[g]);
+        lane_layer<2, false>(r, NTT_LEN2[g]);
+        lane_layer<1, false>(r, NTT_LEN1[g]);
+        transpose8(r);
+        for (int i = 0; i < 8; ++i) store(a + 64 * g + 8 * i, r[i]);
+    }
+}
+
+void invntt_tomont_avx2(Poly& p) {
+    int32_t* a = p.coeffs;
+
+    for (int g = 0; g < 4; ++g) {
+        __m256i r[8];
+        for (int i = 0; i < 8; ++i) r[i] = load(a + 64 * g + 8 * i);
+        transpose8(r);
+        lane_layer<1, true>(r, INVNTT_LEN1[g]);
+        lane_layer<2, true>(r, INVNTT_LEN2[g]);
+        lane_layer<4, true>(r, INVNTT_LEN4[g]);
+        transpose8(r);
+        register_layer<1, true>(r, g);
+        register_layer<2, true>(r, g);
+        register_layer<4, true>(r, g);
+        for (int i = 0; i < 8; ++i) store(a + 64 * g + 8 * i, r[i]);
+    }
+
+    // len 64 and 128, then the 2^64 / 256 scaling.
+    const __m256i z1 = _mm256_set1_epi32(-ZETAS[1]);
+    const __m256i z2 = _mm256_set1_epi32(-ZETAS[2]);
+    const __m256i z3 = _mm256_set1_epi32(-ZETAS[3]);
+    const __m256i f = _mm256_set1_epi32(INVNTT_F);
+    for (int i = 0; i < 8; ++i) {
+        __m256i r0 = load(a + 8 * i);
+        __m256i r1 = load(a + 8 * i + 64);
+        __m256i r2 = load(a + 8 * i + 128);
+        __m256i r3 = load(a + 8 * i + 192);
+        gs_butterfly(r0, r1, z3);
+        gs_butterfly(r2, r3, z2);
+        gs_butterfly(r0, r2, z1);
+        gs_butterfly(r1, r3, z1);
+        store(a + 8 * i, mont_mul(r0, f));
+        store(a + 8 * i + 64, mont_mul(r1, f));
+        store(a + 8 * i + 128, mont_mul(r2, f));
+        store(a + 8 * i + 192, mont_mul(r3, f));
+    }
+}
+
+void pointwise_acc_avx2(Poly& r, const Poly* a, const Poly* b, size_t count) {
+    for (int i = 0; i < N; i += 8) {
+        __m256i acc = _mm256_setzero_si256();
+        for (size_t p = 0; p < count; ++p) {
+            acc = _mm256_add_epi32(acc, mont_mul(load(a[p].coeffs + i), load(b[p].coeffs + i)));
+        }
+        store(r.coeffs + i, acc);
+    }
+}
+
+} // namespace
+
+const Kernels AVX2_KERNELS = {
+    ntt_avx2,
+    invntt_tomont_avx2,
+    pointwise_acc_avx2,
+    keccak::permute_x4_avx2,
+    "avx2",
+};
+
+} // namespace mldsa
+} // namespace Crypto
+
+#endif
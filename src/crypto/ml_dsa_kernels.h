@@ -0,0 +1,79 @@
+#ifndef ML_DSA_KERNELS_H
+#define ML_DSA_KERNELS_H
+
+// Internal interface between MlDsa87 and its polynomial backends. The
+// modulus is 23 bits, so coefficients are int32 and products go through
+// 64-bit Montgomery reduction; otherwise the layout mirrors ml_kem_kernels.h
+// (NTT outputs in bit-reversed order, sampling and packing shared).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "keccak.h"
+
+namespace Crypto {
+namespace mldsa {
+
+constexpr int N = 256;
+constexpr int32_t Q = 8380417;
+constexpr int32_t QINV = 58728449;     // q^-1 mod 2^32
+constexpr int D = 13;
+constexpr int K = 8;
+constexpr int L = 7;
+constexpr int ETA = 2;
+constexpr int TAU = 60;
+constexpr int32_t BETA = TAU * ETA;
+constexpr int32_t GAMMA1 = 1 << 19;
+constexpr int32_t GAMMA2 = (Q - 1) / 32;
+constexpr int OMEGA = 75;
+
+struct alignas(32) Poly {
+    int32_t coeffs[N];
+};
+
+// a * 2^-32 mod q, for |a| < q * 2^31; result in (-q, q).
+inline int32_t montgomery_reduce(int64_t a) {
+    const int32_t t = static_cast<int32_t>(static_cast<int64_t>(static_cast<int32_t>(a)) * QINV);
+    return static_cast<int32_t>((a - static_cast<int64_t>(t) * Q) >> 32);
+}
+
+// zetas[i] = 1753^bitrev8(i) * 2^32 mod q, centered (zetas[0] unused).
+constexpr std::array<int32_t, N> make_zetas() {
+    std::array<int32_t, N> z{};
+    for (int i = 1; i < N; ++i) {
+        int rev = 0;
+        for (int b = 0; b < 8; ++b) rev |= ((i >> b) & 1) << (7 - b);
+        int64_t v = (int64_t{1} << 32) % Q;
+        for (int e = 0; e < rev; ++e) v = v * 1753 % Q;
+        if (v > Q / 2) v -= Q;
+        z[i] = static_cast<int32_t>(v);
+    }
+    return z;
+}
+
+inline constexpr std::array<int32_t, N> ZETAS = make_zetas();
+static_assert(ZETAS[1] == 25847 && ZETAS[2] == -2608894 && ZETAS[255] == 1976782);
+
+// 2^64 / 256 mod q: scales the inverse NTT output back into Montgomery form.
+constexpr int32_t INVNTT_F = 41978;
+
+struct Kernels {
+    // In place, |input| < q; output bounded by 9q, not reduced.
+    void (*ntt)(Poly& p);
+    // In place, |input| < q; output times 2^32, in (-q, q).
+    void (*invntt_tomont)(Poly& p);
+    // r = sum a[i] o b[i] in the NTT domain (times 2^-32), not reduced.
+    void (*pointwise_acc)(Poly& r, const Poly* a, const Poly* b, size_t count);
+    keccak::PermuteX4Fn permute_x4;
+    const char* name;
+};
+
+extern const Kernels PORTABLE_KERNELS;
+// Available when compiled for x86-64; callers must check CPU support first.
+extern const Kernels AVX2_KERNELS;
+
+} // namespace mldsa
+} // namespace Crypto
+
+#endif // ML_DSA_KERNELS_H
@@ -0,0 +1,64 @@
+#include "ml_dsa_kernels.h"
+
+// Portable ML-DSA polynomial arithmetic: Cooley-Tukey NTT and
+// Gentleman-Sande inverse over Z_q[X]/(X^256 + 1) with 64-bit Montgomery
+// multiplication. The 23-bit modulus leaves enough headroom that no
+// reduction is needed between layers.
+
+namespace Crypto {
+namespace mldsa {
+
+namespace {
+
+void ntt_portable(Poly& p) {
+    int32_t* a = p.coeffs;
+    int k = 0;
+    for (int len = 128; len > 0; len >>= 1) {
+        for (int start = 0; start < N; start += 2 * len) {
+            const int64_t zeta = ZETAS[++k];
+            for (int j = start; j < start + len; ++j) {
+                const int32_t t = montgomery_reduce(zeta * a[j + len]);
+                a[j + len] = a[j] - t;
+                a[j] = a[j] + t;
+            }
+        }
+    }
+}
+
+void invntt_tomont_portable(Poly& p) {
+    int32_t* a = p.coeffs;
+    int k = N;
+    for (int len = 1; len < N; len <<= 1) {
+        for (int start = 0; start < N; start += 2 * len) {
+            const int64_t zeta = -ZETAS[--k];
+            for (int j = start; j < start + len; ++j) {
+                const int32_t t = a[j];
+                a[j] = t + a[j + len];
+                a[j + len] = montgomery_reduce(zeta * (t - a[j + len]));
+            }
+        }
+    }
+    for (int j = 0; j < N; ++j) a[j] = montgomery_reduce(static_cast<int64_t>(INVNTT_F) * a[j]);
+}
+
+void pointwise_acc_portable(Poly& r, const Poly* a, const Poly* b, size_t count) {
+    for (int i = 0; i < N; ++i) r.coeffs[i] = 0;
+    for (size_t p = 0; p < count; ++p) {
+        for (int i = 0; i < N; ++i) {
+            r.coeffs[i] += montgomery_reduce(static_cast<int64_t>(a[p].coeffs[i]) * b[p].coeffs[i]);
+        }
+    }
+}
+
+} // namespace
+
+const Kernels PORTABLE_KERNELS = {
+    ntt_portable,
+    invntt_tomont_portable,
+    pointwise_acc_portable,
+    keccak::permute_x4_portable,
+    "portable",
+};
+
+} // namespace mldsa
+} // namespace Crypto
@@ -0,0 +1,409 @@
+#include "ml_kem.h"
+#include "ml_kem_kernels.h"
+#include "kernel_table.h"
+#include "secure_random.h"
+
+#include <cstring>
+
+namespace Crypto {
+
+namespace {
+
+using mlkem::K;
+using mlkem::N;
+using mlkem::Poly;
+using mlkem::Q;
+
+constexpr size_t POLY_BYTES = 384;
+constexpr size_t POLYVEC_BYTES = K * POLY_BYTES;
+constexpr size_t POLYVEC_COMPRESSED_BYTES = K * N * mlkem::DU / 8;
+constexpr size_t POLY_COMPRESSED_BYTES = N * mlkem::DV / 8;
+constexpr size_t PRF_BYTES = 64 * mlkem::ETA;
+constexpr size_t MATRIX_BLOCKS = 3;     // 504 bytes: enough for 256 samples most of the time
+
+static_assert(POLYVEC_BYTES + 32 == MlKem1024::PUBLIC_KEY_SIZE);
+static_assert(2 * POLYVEC_BYTES + 96 == MlKem1024::SECRET_KEY_SIZE);
+static_assert(POLYVEC_COMPRESSED_BYTES + POLY_COMPRESSED_BYTES == MlKem1024::CIPHERTEXT_SIZE);
+static_assert(PRF_BYTES <= keccak::SHAKE256_RATE);
+
+struct PolyVec {
+    Poly vec[K];
+};
+
+const mlkem::Kernels& kernels() {
+    return *kernel_table().ml_kem;
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// ByteEncode_12 of canonical coefficients.
+void poly_tobytes(uint8_t r[POLY_BYTES], const Poly& a) {
+    for (int i = 0; i < N / 2; ++i) {
+        const uint16_t t0 = mlkem::canonical(a.coeffs[2 * i]);
+        const uint16_t t1 = mlkem::canonical(a.coeffs[2 * i + 1]);
+        r[3 * i] = static_cast<uint8_t>(t0);
+        r[3 * i + 1] = static_cast<uint8_t>((t0 >> 8) | (t1 << 4));
+        r[3 * i + 2] = static_cast<uint8_t>(t1 >> 4);
+    }
+}
+
+// ByteDecode_12; false if a coefficient is not reduced mod q (the FIPS 203
+// modulus check on encapsulation keys).
+bool poly_frombytes(Poly& r, const uint8_t a[POLY_BYTES]) {
+    uint16_t bad = 0;
+    for (int i = 0; i < N / 2; ++i) {
+        const uint16_t t0 = static_cast<uint16_t>(a[3 * i] | ((a[3 * i + 1] & 0x0F) << 8));
+        const uint16_t t1 = static_cast<uint16_t>((a[3 * i + 1] >> 4) | (a[3 * i + 2] << 4));
+        bad |= static_cast<uint16_t>((Q - 1 - t0) | (Q - 1 - t1)) & 0x8000;
+        r.coeffs[2 * i] = static_cast<int16_t>(t0);
+        r.coeffs[2 * i + 1] = static_cast<int16_t>(t1);
+    }
+    return bad == 0;
+}
+
+// Compress_d then ByteEncode_d, least significant bit first.
+void poly_compress(uint8_t* r, const Poly& a, int d) {
+    const uint32_t mask = (1u << d) - 1;
+    uint64_t acc = 0;
+    int bits = 0;
+    for (int i = 0; i < N; ++i) {
+        const uint32_t x = mlkem::canonical(a.coeffs[i]);
+        const uint32_t y = (((x << d) + Q / 2) / Q) & mask;
+        acc |= static_cast<uint64_t>(y) << bits;
+        bits += d;
+        while (bits >= 8) {
+            *r++ = static_cast<uint8_t>(acc);
+            acc >>= 8;
+            bits -= 8;
+        }
+    }
+}
+
+void poly_decompress(Poly& r, const uint8_t* a, int d) {
+    const uint32_t mask = (1u << d) - 1;
+    uint64_t acc = 0;
+    int bits = 0;
+    for (int i = 0; i < N; ++i) {
+        while (bits < d) {
+            acc |= static_cast<uint64_t>(*a++) << bits;
+            bits += 8;
+        }
+        const uint32_t y = static_cast<uint32_t>(acc) & mask;
+        acc >>= d;
+        bits -= d;
+        r.coeffs[i] = static_cast<int16_t>((y * Q + (1u << (d - 1))) >> d);
+    }
+}
+
+void poly_frommsg(Poly& r, const uint8_t msg[32]) {
+    for (int i = 0; i < N; ++i) {
+        const int16_t bit = static_cast<int16_t>((msg[i / 8] >> (i % 8)) & 1);
+        r.coeffs[i] = static_cast<int16_t>(-bit & ((Q + 1) / 2));
+    }
+}
+
+void poly_tomsg(uint8_t msg[32], const Poly& a) {
+    std::memset(msg, 0, 32);
+    for (int i = 0; i < N; ++i) {
+        const uint32_t x = mlkem::canonical(a.coeffs[i]);
+        const uint32_t bit = (((x << 1) + Q / 2) / Q) & 1;
+        msg[i / 8] |= static_cast<uint8_t>(bit << (i % 8));
+    }
+}
+
+// SampleNTT rejection step: 12-bit candidates below q, in stream order.
+int rej_uniform(int16_t* r, int needed, const uint8_t* buf, size_t len) {
+    int count = 0;
+    for (size_t pos = 0; count < needed && pos + 3 <= len; pos += 3) {
+        const uint16_t d1 = static_cast<uint16_t>(buf[pos] | ((buf[pos + 1] & 0x0F) << 8));
+        const uint16_t d2 = static_cast<uint16_t>((buf[pos + 1] >> 4) | (buf[pos + 2] << 4));
+        if (d1 < Q) r[count++] = static_cast<int16_t>(d1);
+        if (d2 < Q && count < needed) r[count++] = static_cast<int16_t>(d2);
+    }
+    return count;
+}
+
+// A[i][j] = SampleNTT(rho || j || i), or its transpose. Each row is four
+// SHAKE128 streams expanded together.
+void gen_matrix(PolyVec a[K], const uint8_t rho[32], bool transposed) {
+    const keccak::PermuteX4Fn permute_x4 = kernels().permute_x4;
+    alignas(32) uint8_t seeds[4][34];
+    alignas(32) uint8_t buf[4][MATRIX_BLOCKS * keccak::SHAKE128_RATE];
+    const uint8_t* in[4];
+    uint8_t* out[4];
+
+    for (int i = 0; i < K; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            std::memcpy(seeds[j], rho, 32);
+            seeds[j][32] = static_cast<uint8_t>(transposed ? i : j);
+            seeds[j][33] = static_cast<uint8_t>(transposed ? j : i);
+            in[j] = seeds[j];
+            out[j] = buf[j];
+        }
+        keccak::X4State state;
+        keccak::absorb_x4(state, keccak::SHAKE128_RATE, in, 34, permute_x4);
+        keccak::squeeze_x4(state, keccak::SHAKE128_RATE, out, MATRIX_BLOCKS, permute_x4);
+
+        int ctr[4];
+        for (int j = 0; j < 4; ++j) ctr[j] = rej_uniform(a[i].vec[j].coeffs, N, buf[j], sizeof(buf[j]));
+        while (ctr[0] < N || ctr[1] < N || ctr[2] < N || ctr[3] < N) {
+            keccak::squeeze_x4(state, keccak::SHAKE128_RATE, out, 1, permute_x4);
+            for (int j = 0; j < 4; ++j) {
+                ctr[j] += rej_uniform(a[i].vec[j].coeffs + ctr[j], N - ctr[j], buf[j], keccak::SHAKE128_RATE);
+            }
+        }
+    }
+}
+
+// Four CBD samples from PRF(sigma, nonce + 0..3) through one four-way SHAKE256.
+void noise_x4(Poly* const r[4], const uint8_t sigma[32], uint8_t nonce) {
+    const mlkem::Kernels& k = kernels();
+    alignas(32) uint8_t seeds[4][33];
+    alignas(32) uint8_t buf[4][keccak::SHAKE256_RATE];
+    const uint8_t* in[4];
+    uint8_t* out[4];
+    for (int j = 0; j < 4; ++j) {
+        std::memcpy(seeds[j], sigma, 32);
+        seeds[j][32] = static_cast<uint8_t>(nonce + j);
+        in[j] = seeds[j];
+        out[j] = buf[j];
+    }
+    keccak::X4State state;
+    keccak::absorb_x4(state, keccak::SHAKE256_RATE, in, 33, k.permute_x4);
+    keccak::squeeze_x4(state, keccak::SHAKE256_RATE, out, 1, k.permute_x4);
+    for (int j = 0; j < 4; ++j) k.cbd2(*r[j], buf[j]);
+    secure_wipe(buf, sizeof(buf));
+    secure_wipe(&state, sizeof(state));
+}
+
+void noise(Poly& r, const uint8_t sigma[32], uint8_t nonce) {
+    uint8_t seed[33];
+    uint8_t buf[PRF_BYTES];
+    std::memcpy(seed, sigma, 32);
+    seed[32] = nonce;
+    keccak::shake256(buf, sizeof(buf), seed, sizeof(seed));
+    kernels().cbd2(r, buf);
+    secure_wipe(buf, sizeof(buf));
+}
+
+// r = a * 2^16 + e, reduced: moves a Montgomery product back to the normal domain.
+void poly_tomont_add(Poly& r, const Poly& e) {
+    constexpr int16_t MONT_SQ = 1353;   // 2^32 mod q
+    for (int i = 0; i < N; ++i) {
+        r.coeffs[i] = mlkem::barrett_reduce(static_cast<int16_t>(mlkem::fqmul(r.coeffs[i], MONT_SQ) + e.coeffs[i]));
+    }
+}
+
+void poly_add_reduce(Poly& r, const Poly& a) {
+    for (int i = 0; i < N; ++i) r.coeffs[i] = mlkem::barrett_reduce(static_cast<int16_t>(r.coeffs[i] + a.coeffs[i]));
+}
+
+// K-PKE.KeyGen(d): ek = ByteEncode_12(t_hat) || rho, dk = ByteEncode_12(s_hat).
+void pke_keypair(uint8_t ek[MlKem1024::PUBLIC_KEY_SIZE], uint8_t dk[POLYVEC_BYTES], const uint8_t d[32]) {
+    const mlkem::Kernels& k = kernels();
+    uint8_t seed[33];
+    uint8_t rho_sigma[64];
+    std::memcpy(seed, d, 32);
+    seed[32] = K;
+    keccak::sha3_512(rho_sigma, seed, sizeof(seed));
+    const uint8_t* rho = rho_sigma;
+    const uint8_t* sigma = rho_sigma + 32;
+
+    PolyVec a[K];
+    gen_matrix(a, rho, false);
+
+    PolyVec s, e, t;
+    Poly* const s_out[4] = {&s.vec[0], &s.vec[1], &s.vec[2], &s.vec[3]};
+    Poly* const e_out[4] = {&e.vec[0], &e.vec[1], &e.vec[2], &e.vec[3]};
+    noise_x4(s_out, sigma, 0);
+    noise_x4(e_out, sigma, K);
+    for (int i = 0; i < K; ++i) {
+        k.ntt(s.vec[i]);
+        k.ntt(e.vec[i]);
+    }
+
+    for (int i = 0; i < K; ++i) {
+        k.basemul_acc(t.vec[i], a[i].vec, s.vec, K);
+        poly_tomont_add(t.vec[i], e.vec[i]);
+        poly_tobytes(ek + i * POLY_BYTES, t.vec[i]);
+        poly_tobytes(dk + i * POLY_BYTES, s.vec[i]);
+    }
+    std::memcpy(ek + POLYVEC_BYTES, rho, 32);
+
+    secure_wipe(rho_sigma, sizeof(rho_sigma));
+    secure_wipe(seed, sizeof(seed));
+    secure_wipe(&s, sizeof(s));
+    secure_wipe(&e, sizeof(e));
+}
+
+// K-PKE.Encrypt(ek, m, r) with t_hat already decoded.
+void pke_encrypt(uint8_t c[MlKem1024::CIPHERTEXT_SIZE], const PolyVec& t, const uint8_t rho[32],
+                 const uint8_t m[32], const uint8_t coins[32]) {
+    const mlkem::Kernels& k = kernels();
+    PolyVec at[K];
+    gen_matrix(at, rho, true);
+
+    PolyVec y, e1, u;
+    Poly e2, v, mu;
+    Poly* const y_out[4] = {&y.vec[0], &y.vec[1], &y.vec[2], &y.vec[3]};
+    Poly* const e1_out[4] = {&e1.vec[0], &e1.vec[1], &e1.vec[2], &e1.vec[3]};
+    noise_x4(y_out, coins, 0);
+    noise_x4(e1_out, coins, K);
+    noise(e2, coins, 2 * K);
+    for (int i = 0; i < K; ++i) k.ntt(y.vec[i]);
+
+    for (int i = 0; i < K; ++i) {
+        k.basemul_acc(u.vec[i], at[i].vec, y.vec, K);
+        k.invntt_tomont(u.vec[i]);
+        poly_add_reduce(u.vec[i], e1.vec[i]);
+        poly_compress(c + i * (N * mlkem::DU / 8), u.vec[i], mlkem::DU);
+    }
+
+    k.basemul_acc(v, t.vec, y.vec, K);
+    k.invntt_tomont(v);
+    poly_frommsg(mu, m);
+    poly_add_reduce(e2, mu);
+    poly_add_reduce(v, e2);
+    poly_compress(c + POLYVEC_COMPRESSED_BYTES, v, mlkem::DV);
+
+    secure_wipe(&y, sizeof(y));
+    secure_wipe(&e1, sizeof(e1));
+    secure_wipe(&e2, sizeof(e2));
+    secure_wipe(&mu, sizeof(mu));
+}
+
+// K-PKE.Decrypt(dk, c).
+void pke_decrypt(uint8_t m[32], const uint8_t dk[POLYVEC_BYTES], const uint8_t c[MlKem1024::CIPHERTEXT_SIZE]) {
+    const mlkem::Kernels& k = kernels();
+    PolyVec u, s;
+    Poly v, w;
+    for (int i = 0; i < K; ++i) {
+        poly_decompress(u.vec[i], c + i * (N * mlkem::DU / 8), mlkem::DU);
+        k.ntt(u.vec[i]);
+        poly_frombytes(s.vec[i], dk + i * POLY_BYTES);
+    }
+    poly_decompress(v, c + POLYVEC_COMPRESSED_BYTES, mlkem::DV);
+
+    k.basemul_acc(w, s.vec, u.vec, K);
+    k.invntt_tomont(w);
+    for (int i = 0; i < N; ++i) w.coeffs[i] = mlkem::barrett_reduce(static_cast<int16_t>(v.coeffs[i] - w.coeffs[i]));
+    poly_tomsg(m, w);
+
+    secure_wipe(&s, sizeof(s));
+    secure_wipe(&w, sizeof(w));
+}
+
+bool decode_public_key(PolyVec& t, const uint8_t ek[MlKem1024::PUBLIC_KEY_SIZE]) {
+    bool ok = true;
+    for (int i = 0; i < K; ++i) ok &= poly_frombytes(t.vec[i], ek + i * POLY_BYTES);
+    return ok;
+}
+
+} // namespace
+
+MlKem1024::KeyPair MlKem1024::generate_keypair() {
+    Seed d, z;
+    SecureRandom::fill(d);
+    SecureRandom::fill(z);
+    KeyPair kp = generate_keypair(d, z);
+    secure_wipe(d.data(), d.size());
+    secure_wipe(z.data(), z.size());
+    return kp;
+}
+
+// dk = dk_pke || ek || H(ek) || z
+MlKem1024::KeyPair MlKem1024::generate_keypair(const Seed& d, const Seed& z) {
+    KeyPair kp;
+    pke_keypair(kp.public_key.data(), kp.secret_key.data(), d.data());
+    uint8_t* dk = kp.secret_key.data();
+    std::memcpy(dk + POLYVEC_BYTES, kp.public_key.data(), PUBLIC_KEY_SIZE);
+    keccak::sha3_256(dk + POLYVEC_BYTES + PUBLIC_KEY_SIZE, kp.public_key.data(), PUBLIC_KEY_SIZE);
+    std::memcpy(dk + SECRET_KEY_SIZE - SEED_SIZE, z.data(), SEED_SIZE);
+    return kp;
+}
+
+std::optional<MlKem1024::Encapsulation> MlKem1024::encapsulate(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key) {
+    Seed m;
+    SecureRandom::fill(m);
+    auto result = encapsulate(public_key, m);
+    secure_wipe(m.data(), m.size());
+    return result;
+}
+
+std::optional<MlKem1024::Encapsulation> MlKem1024::encapsulate(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key,
+                                                               const Seed& m) {
+    PolyVec t;
+    if (!decode_public_key(t, public_key.data())) {
+        return std::nullopt;
+    }
+
+    // (K, r) = G(m || H(ek))
+    uint8_t buf[64];
+    uint8_t kr[64];
+    std::memcpy(buf, m.data(), 32);
+    keccak::sha3_256(buf + 32, public_key.data(), PUBLIC_KEY_SIZE);
+    keccak::sha3_512(kr, buf, sizeof(buf));
+
+    Encapsulation out;
+    pke_encrypt(out.ciphertext.data(), t, public_key.data() + POLYVEC_BYTES, m.data(), kr + 32);
+    std::memcpy(out.shared_secret.data(), kr, SHARED_SECRET_SIZE);
+
+    secure_wipe(buf, sizeof(buf));
+    secure_wipe(kr, sizeof(kr));
+    return out;
+}
+
+std::optional<MlKem1024::SharedSecret> MlKem1024::decapsulate(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                              std::span<const uint8_t, CIPHERTEXT_SIZE> ciphertext) {
+    const uint8_t* dk_pke = secret_key.data();
+    const uint8_t* ek = dk_pke + POLYVEC_BYTES;
+    const uint8_t* h = ek + PUBLIC_KEY_SIZE;
+    const uint8_t* z = h + 32;
+
+    // FIPS 203 decapsulation key check: H(ek) must match the stored hash.
+    uint8_t ek_hash[32];
+    keccak::sha3_256(ek_hash, ek, PUBLIC_KEY_SIZE);
+    PolyVec t;
+    if (std::memcmp(ek_hash, h, 32) != 0 || !decode_public_key(t, ek)) {
+        return std::nullopt;
+    }
+
+    uint8_t buf[64];
+    uint8_t kr[64];
+    pke_decrypt(buf, dk_pke, ciphertext.data());
+    std::memcpy(buf + 32, h, 32);
+    keccak::sha3_512(kr, buf, sizeof(buf));
+
+    Ciphertext reencrypted;
+    pke_encrypt(reencrypted.data(), t, ek + POLYVEC_BYTES, buf, kr + 32);
+
+    // K_bar = J(z || c), selected in constant time when c' != c.
+    SharedSecret rejection;
+    keccak::Sponge j(keccak::SHAKE256_RATE, 0x1F);
+    j.absorb(z, 32);
+    j.absorb(ciphertext.data(), CIPHERTEXT_SIZE);
+    j.squeeze(rejection.data(), rejection.size());
+
+    uint8_t diff = 0;
+    for (size_t i = 0; i < CIPHERTEXT_SIZE; ++i) diff |= reencrypted[i] ^ ciphertext[i];
+    const uint8_t keep = static_cast<uint8_t>((static_cast<uint32_t>(diff) - 1) >> 8);   // 0xFF iff equal
+
+    SharedSecret ss;
+    for (size_t i = 0; i < SHARED_SECRET_SIZE; ++i) {
+        ss[i] = static_cast<uint8_t>((kr[i] & keep) | (rejection[i] & ~keep));
+    }
+
+    secure_wipe(buf, sizeof(buf));
+    secure_wipe(kr, sizeof(kr));
+    secure_wipe(rejection.data(), rejection.size());
+    return ss;
+}
+
+const char* MlKem1024::backend_name() {
+    return kernels().name;
+}
+
+} // namespace Crypto
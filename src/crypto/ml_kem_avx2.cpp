@@ -0,0 +1,291 @@
+#include "ml_kem_kernels.h"
+
+// AVX2 ML-KEM polynomial arithmetic. A polynomial is sixteen ymm registers
+// of sixteen coefficients (coefficient 16v + l in lane l of register v).
+// NTT layers with distance >= 16 pair whole registers; for the last three
+// the 16x16 matrix is transposed so those layers pair registers as well,
+// with per-lane twiddles, and transposed back so the NTT domain keeps the
+// FIPS 203 order. Montgomery products use VPMULHW/VPMULLW, Barrett
+// reduction VPMULHRSW, and both match the portable code bit for bit.
+// Built with -mavx2; only reached after the kernel registry has confirmed
+// CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace mlkem {
+
+namespace {
+
+struct alignas(32) LaneZetas {
+    int16_t z[16];
+    int16_t zqinv[16];
+};
+
+// Twiddles of the transposed layers for lane u of the registers served by
+// table entry h: len 8 uses ZETAS[16 + u], len 4 ZETAS[32 + 2u + h], len 2
+// ZETAS[64 + 4u + h]. The inverse reads the same blocks from the end of
+// each layer's range, as invntt_tomont_portable() does.
+constexpr LaneZetas lane_zetas(int len, int h, bool inverse) {
+    const int base = 128 / len;     // first zeta index of the layer
+    const int stride = 8 / len;     // blocks per 16 coefficients
+    LaneZetas t{};
+    for (int u = 0; u < 16; ++u) {
+        const int block = stride * u + h;
+        const int16_t z = ZETAS[inverse ? 2 * base - 1 - block : base + block];
+        t.z[u] = z;
+        t.zqinv[u] = static_cast<int16_t>(z * QINV);
+    }
+    return t;
+}
+
+constexpr LaneZetas NTT_LEN8 = lane_zetas(8, 0, false);
+constexpr LaneZetas NTT_LEN4[2] = {lane_zetas(4, 0, false), lane_zetas(4, 1, false)};
+constexpr LaneZetas NTT_LEN2[4] = {lane_zetas(2, 0, false), lane_zetas(2, 1, false),
+                                   lane_zetas(2, 2, false), lane_zetas(2, 3, false)};
+constexpr LaneZetas INVNTT_LEN8 = lane_zetas(8, 0, true);
+constexpr LaneZetas INVNTT_LEN4[2] = {lane_zetas(4, 0, true), lane_zetas(4, 1, true)};
+constexpr LaneZetas INVNTT_LEN2[4] = {lane_zetas(2, 0, true), lane_zetas(2, 1, true),
+                                      lane_zetas(2, 2, true), lane_zetas(2, 3, true)};
+
+// Base multiplication twiddle of each coefficient pair: +zeta for even
+// pairs, -zeta for odd ones, sixteen pairs per 32 coefficients.
+constexpr LaneZetas basemul_zetas(int group) {
+    LaneZetas t{};
+    for (int l = 0; l < 16; ++l) {
+        const int pair = 16 * group + l;
+        const int16_t z = static_cast<int16_t>((pair & 1) ? -ZETAS[64 + pair / 2] : ZETAS[64 + pair / 2]);
+        t.z[l] = z;
+        t.zqinv[l] = static_cast<int16_t>(z * QINV);
+    }
+    return t;
+}
+
+constexpr LaneZetas BASEMUL_ZETAS[8] = {basemul_zetas(0), basemul_zetas(1), basemul_zetas(2), basemul_zetas(3),
+                                        basemul_zetas(4), basemul_zetas(5), basemul_zetas(6), basemul_zetas(7)};
+
+inline __m256i load(const int16_t* p) {
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+inline void store(int16_t* p, __m256i v) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(p), v);
+}
+
+// Montgomery product with a precomputed zeta * q^-1.
+inline __m256i fqmul(__m256i a, __m256i z, __m256i zqinv) {
+    const __m256i hi = _mm256_mulhi_epi16(a, z);
+    const __m256i t = _mm256_mulhi_epi16(_mm256_mullo_epi16(a, zqinv), _mm256_set1_epi16(Q));
+    return _mm256_sub_epi16(hi, t);
+}
+
+inline __m256i fqmul(__m256i a, __m256i b) {
+    return fqmul(a, b, _mm256_mullo_epi16(b, _mm256_set1_epi16(QINV)));
+}
+
+// Same rounding as barrett_reduce(): floor((a * v + 2^25) / 2^26).
+inline __m256i barrett(__m256i a) {
+    __m256i t = _mm256_mulhi_epi16(a, _mm256_set1_epi16(BARRETT_V));
+    t = _mm256_mulhrs_epi16(t, _mm256_set1_epi16(1 << 5));
+    return _mm256_sub_epi16(a, _mm256_mullo_epi16(t, _mm256_set1_epi16(Q)));
+}
+
+inline void ct_butterfly(__m256i& a, __m256i& b, __m256i z, __m256i zqinv) {
+    const __m256i t = fqmul(b, z, zqinv);
+    b = _mm256_sub_epi16(a, t);
+    a = _mm256_add_epi16(a, t);
+}
+
+inline void gs_butterfly(__m256i& a, __m256i& b, __m256i z, __m256i zqinv) {
+    const __m256i t = a;
+    a = barrett(_mm256_add_epi16(t, b));
+    b = fqmul(_mm256_sub_epi16(b, t), z, zqinv);
+}
+
+// 8x8 transpose of 16-bit words inside each 128-bit lane.
+inline void transpose8(__m256i r[8]) {
+    __m256i t[8], u[8];
+    for (int i = 0; i < 4; ++i) {
+        t[2 * i] = _mm256_unpacklo_epi16(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm256_unpackhi_epi16(r[2 * i], r[2 * i + 1]);
+    }
+    for (int i = 0; i < 2; ++i) {
+        u[4 * i] = _mm256_unpacklo_epi32(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm256_unpackhi_epi32(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm256_unpacklo_epi32(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm256_unpackhi_epi32(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for (int i = 0; i < 4; ++i) {
+        r[2 * i] = _mm256_unpacklo_epi64(u[i], u[i + 4]);
+        r[2 * i + 1] = _mm256_unpackhi_epi64(u[i], u[i + 4]);
+    }
+}
+
+// 16x16 transpose: pair up the 8x8 quadrants, then transpose in-lane.
+inline void transpose16(__m256i r[16]) {
+    __m256i lo[8], hi[8];
+    for (int i = 0; i < 8; ++i) {
+        lo[i] = _mm256_permute2x128_si256(r[i], r[i + 8], 0x20);
+        hi[i] = _mm256_permute2x128_si256(r[i], r[i + 8], 0x31);
+    }
+    transpose8(lo);
+    transpose8(hi);
+    for (int i = 0; i < 8; ++i) {
+        r[i] = lo[i];
+        r[i + 8] = hi[i];
+    }
+}
+
+// Layer on register pairs (v, v + d), one broadcast zeta per block.
+template <int D>
+inline void ntt_layer(__m256i r[16]) {
+    constexpr int base = 8 / D;
+    for (int v = 0; v < 16; ++v) {
+        if (v & D) continue;
+        const int16_t z = ZETAS[base + v / (2 * D)];
+        ct_butterfly(r[v], r[v + D], _mm256_set1_epi16(z), _mm256_set1_epi16(static_cast<int16_t>(z * QINV)));
+    }
+}
+
+template <int D>
+inline void invntt_layer(__m256i r[16]) {
+    constexpr int base = 8 / D;
+    for (int v = 0; v < 16; ++v) {
+        if (v & D) continue;
+        const int16_t z = ZETAS[2 * base - 1 - v / (2 * D)];
+        gs_butterfly(r[v], r[v + D], _mm256_set1_epi16(z), _mm256_set1_epi16(static_cast<int16_t>(z * QINV)));
+    }
+}
+
+// Layer on transposed registers with per-lane zetas; table[h] serves
+// register w with h = w / (2 * D).
+template <int D, bool Inverse>
+inline void lane_layer(__m256i r[16], const LaneZetas* table) {
+    for (int w = 0; w < 16; ++w) {
+        if (w & D) continue;
+        const LaneZetas& t = table[w / (2 * D)];
+        if constexpr (Inverse) {
+            gs_butterfly(r[w], r[w + D], load(t.z), load(t.zqinv));
+        } else {
+            ct_butterfly(r[w], r[w + D], load(t.z), load(t.zqinv));
+        }
+    }
+}
+
+void ntt_avx2(Poly& p) {
+    __m256i r[16];
+    for (int v = 0; v < 16; ++v) r[v] = load(p.coeffs + 16 * v);
+
+    ntt_layer<8>(r);        // len 128
+    ntt_layer<4>(r);        // len 64
+    ntt_layer<2>(r);        // len 32
+    ntt_layer<1>(r);        // len 16
+    transpose16(r);
+    lane_layer<8, false>(r, &NTT_LEN8);
+    lane_layer<4, false>(r, NTT_LEN4);
+    lane_layer<2, false>(r, NTT_LEN2);
+    transpose16(r);
+
+    for (int v = 0; v < 16; ++v) store(p.coeffs + 16 * v, barrett(r[v]));
+}
+
+void invntt_tomont_avx2(Poly& p) {
+    __m256i r[16];
+    for (int v = 0; v < 16; ++v) r[v] = load(p.coeffs + 16 * v);
+
+    transpose16(r);
+    lane_layer<2, true>(r, INVNTT_LEN2);
+    lane_layer<4, true>(r, INVNTT_LEN4);
+    lane_layer<8, true>(r, &INVNTT_LEN8);
+    transpose16(r);
+    invntt_layer<1>(r);     // len 16
+    invntt_layer<2>(r);     // len 32
+    invntt_layer<4>(r);     // len 64
+    invntt_layer<8>(r);     // len 128
+
+    const __m256i f = _mm256_set1_epi16(INVNTT_F);
+    const __m256i fqinv = _mm256_set1_epi16(static_cast<int16_t>(INVNTT_F * QINV));
+    for (int v = 0; v < 16; ++v) store(p.coeffs + 16 * v, fqmul(r[v], f, fqinv));
+}
+
+// Coefficients 32g .. 32g + 31 as even (a0 of each pair) and odd (a1) words.
+inline void deinterleave(const int16_t* c, __m256i& even, __m256i& odd) {
+    const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15,
+                                           0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+    const __m256i a = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(load(c), split), 0xD8);
+    const __m256i b = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(load(c + 16), split), 0xD8);
+    even = _mm256_permute2x128_si256(a, b, 0x20);
+    odd = _mm256_permute2x128_si256(a, b, 0x31);
+}
+
+void basemul_acc_avx2(Poly& r, const Poly* a, const Poly* b, size_t count) {
+    for (int g = 0; g < 8; ++g) {
+        const __m256i z = load(BASEMUL_ZETAS[g].z);
+        const __m256i zqinv = load(BASEMUL_ZETAS[g].zqinv);
+        __m256i acc0 = _mm256_setzero_si256();
+        __m256i acc1 = _mm256_setzero_si256();
+        for (size_t p = 0; p < count; ++p) {
+            __m256i a0, a1, b0, b1;
+            deinterleave(a[p].coeffs + 32 * g, a0, a1);
+            deinterleave(b[p].coeffs + 32 * g, b0, b1);
+            const __m256i r0 = _mm256_add_epi16(fqmul(fqmul(a1, b1), z, zqinv), fqmul(a0, b0));
+            const __m256i r1 = _mm256_add_epi16(fqmul(a0, b1), fqmul(a1, b0));
+            acc0 = _mm256_add_epi16(acc0, r0);
+            acc1 = _mm256_add_epi16(acc1, r1);
+        }
+        acc0 = barrett(acc0);
+        acc1 = barrett(acc1);
+        const __m256i lo = _mm256_unpacklo_epi16(acc0, acc1);
+        const __m256i hi = _mm256_unpackhi_epi16(acc0, acc1);
+        store(r.coeffs + 32 * g, _mm256_permute2x128_si256(lo, hi, 0x20));
+        store(r.coeffs + 32 * g + 16, _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+}
+
+// Each nibble of the PRF output is one coefficient: (b0 + b1) - (b2 + b3).
+void cbd2_avx2(Poly& r, const uint8_t buf[64 * ETA]) {
+    const __m256i mask55 = _mm256_set1_epi32(0x55555555);
+    const __m256i mask33 = _mm256_set1_epi32(0x33333333);
+    const __m256i mask03 = _mm256_set1_epi32(0x03030303);
+    const __m256i mask0f = _mm256_set1_epi32(0x0F0F0F0F);
+    for (int i = 0; i < 4; ++i) {
+        __m256i f0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf + 32 * i));
+        __m256i f1 = _mm256_srli_epi16(f0, 1);
+        f0 = _mm256_add_epi8(_mm256_and_si256(f0, mask55), _mm256_and_si256(f1, mask55));
+
+        f1 = _mm256_and_si256(_mm256_srli_epi16(f0, 2), mask33);
+        f0 = _mm256_and_si256(f0, mask33);
+        f0 = _mm256_sub_epi8(_mm256_add_epi8(f0, mask33), f1);
+
+        f1 = _mm256_and_si256(_mm256_srli_epi16(f0, 4), mask0f);
+        f0 = _mm256_and_si256(f0, mask0f);
+        f0 = _mm256_sub_epi8(f0, mask03);
+        f1 = _mm256_sub_epi8(f1, mask03);
+
+        const __m256i lo = _mm256_unpacklo_epi8(f0, f1);
+        const __m256i hi = _mm256_unpackhi_epi8(f0, f1);
+        int16_t* out = r.coeffs + 64 * i;
+        store(out, _mm256_cvtepi8_epi16(_mm256_castsi256_si128(lo)));
+        store(out + 16, _mm256_cvtepi8_epi16(_mm256_castsi256_si128(hi)));
+        store(out + 32, _mm256_cvtepi8_epi16(_mm256_extracti128_si256(lo, 1)));
+        store(out + 48, _mm256_cvtepi8_epi16(_mm256_extracti128_si256(hi, 1)));
+    }
+}
+
+} // namespace
+
+const Kernels AVX2_KERNELS = {
+    ntt_avx2,
+    invntt_tomont_avx2,
+    basemul_acc_avx2,
+    cbd2_avx2,
+    keccak::permute_x4_avx2,
+    "avx2",
+};
+
+} // namespace mlkem
+} // namespace Crypto
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef ML_KEM_KERNELS_H
+#define ML_KEM_KERNELS_H
+
+// Internal interface between MlKem1024 and its polynomial backends.
+// Coefficients are int16 in Montgomery-friendly signed form; every backend
+// keeps polynomials in the FIPS 203 coefficient order (NTT outputs in
+// bit-reversed order), so encodings and sampling are shared code.
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "keccak.h"
+
+namespace Crypto {
+namespace mlkem {
+
+constexpr int N = 256;
+constexpr int16_t Q = 3329;
+constexpr int K = 4;
+constexpr int ETA = 2;          // eta1 = eta2 = 2 for ML-KEM-1024
+constexpr int DU = 11;
+constexpr int DV = 5;
+
+constexpr int16_t QINV = -3327; // q^-1 mod 2^16
+constexpr int16_t BARRETT_V = 20159;  // round(2^26 / q)
+
+struct alignas(32) Poly {
+    int16_t coeffs[N];
+};
+
+// a * 2^-16 mod q, for |a| < q * 2^15; result in (-q, q).
+inline int16_t montgomery_reduce(int32_t a) {
+    const int16_t t = static_cast<int16_t>(static_cast<int16_t>(a) * QINV);
+    return static_cast<int16_t>((a - static_cast<int32_t>(t) * Q) >> 16);
+}
+
+inline int16_t fqmul(int16_t a, int16_t b) {
+    return montgomery_reduce(static_cast<int32_t>(a) * b);
+}
+
+// Centered representative of a mod q.
+inline int16_t barrett_reduce(int16_t a) {
+    const int16_t t = static_cast<int16_t>((static_cast<int32_t>(BARRETT_V) * a + (1 << 25)) >> 26);
+    return static_cast<int16_t>(a - t * Q);
+}
+
+// Any backend output in (-q, q] to the canonical [0, q).
+inline uint16_t canonical(int16_t a) {
+    a = static_cast<int16_t>(a + ((a >> 15) & Q));
+    a = static_cast<int16_t>(a - Q);
+    a = static_cast<int16_t>(a + ((a >> 15) & Q));
+    return static_cast<uint16_t>(a);
+}
+
+// zetas[i] = 17^bitrev7(i) * 2^16 mod q, centered: the twiddles of the
+// forward NTT in Montgomery form. The inverse walks the table backwards.
+constexpr std::array<int16_t, 128> make_zetas() {
+    std::array<int16_t, 128> z{};
+    for (int i = 0; i < 128; ++i) {
+        int rev = 0;
+        for (int b = 0; b < 7; ++b) rev |= ((i >> b) & 1) << (6 - b);
+        int64_t v = 1 << 16;
+        for (int e = 0; e < rev; ++e) v = v * 17 % Q;
+        v %= Q;
+        if (v > Q / 2) v -= Q;
+        z[i] = static_cast<int16_t>(v);
+    }
+    return z;
+}
+
+inline constexpr std::array<int16_t, 128> ZETAS = make_zetas();
+
+// 2^32 / 128 mod q: scales the inverse NTT output back into Montgomery form.
+constexpr int16_t INVNTT_F = 1441;
+
+struct Kernels {
+    // In place, |input| < q; output Barrett-reduced.
+    void (*ntt)(Poly& p);
+    // In place; output multiplied by 2^16 (undoes one Montgomery factor).
+    void (*invntt_tomont)(Poly& p);
+    // r = sum a[i] o b[i] in the NTT domain (times 2^-16), Barrett-reduced.
+    void (*basemul_acc)(Poly& r, const Poly* a, const Poly* b, size_t count);
+    // Centered binomial distribution with eta = 2 from 128 PRF bytes.
+    void (*cbd2)(Poly& r, const uint8_t buf[64 * ETA]);
+    keccak::PermuteX4Fn permute_x4;
+    const char* name;
+};
+
+extern const Kernels PORTABLE_KERNELS;
+// Available when compiled for x86-64; callers must check CPU support first.
+extern const Kernels AVX2_KERNELS;
+
+} // namespace mlkem
+} // namespace Crypto
+
+#endif // ML_KEM_KERNELS_H
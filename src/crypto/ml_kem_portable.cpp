@@ -0,0 +1,90 @@
+#include "ml_kem_kernels.h"
+
+// Portable ML-KEM polynomial arithmetic: Cooley-Tukey NTT with Montgomery
+// multiplication, Gentleman-Sande inverse with Barrett reduction between
+// layers, and degree-1 base multiplication in the NTT domain.
+
+namespace Crypto {
+namespace mlkem {
+
+namespace {
+
+void ntt_portable(Poly& p) {
+    int16_t* r = p.coeffs;
+    int k = 1;
+    for (int len = 128; len >= 2; len >>= 1) {
+        for (int start = 0; start < N; start += 2 * len) {
+            const int16_t zeta = ZETAS[k++];
+            for (int j = start; j < start + len; ++j) {
+                const int16_t t = fqmul(zeta, r[j + len]);
+                r[j + len] = static_cast<int16_t>(r[j] - t);
+                r[j] = static_cast<int16_t>(r[j] + t);
+            }
+        }
+    }
+    for (int i = 0; i < N; ++i) r[i] = barrett_reduce(r[i]);
+}
+
+void invntt_tomont_portable(Poly& p) {
+    int16_t* r = p.coeffs;
+    int k = 127;
+    for (int len = 2; len <= 128; len <<= 1) {
+        for (int start = 0; start < N; start += 2 * len) {
+            const int16_t zeta = ZETAS[k--];
+            for (int j = start; j < start + len; ++j) {
+                const int16_t t = r[j];
+                r[j] = barrett_reduce(static_cast<int16_t>(t + r[j + len]));
+                r[j + len] = fqmul(zeta, static_cast<int16_t>(r[j + len] - t));
+            }
+        }
+    }
+    for (int i = 0; i < N; ++i) r[i] = fqmul(r[i], INVNTT_F);
+}
+
+// (a0 + a1 X)(b0 + b1 X) mod (X^2 - zeta).
+inline void basemul(int16_t r[2], const int16_t a[2], const int16_t b[2], int16_t zeta) {
+    r[0] = static_cast<int16_t>(fqmul(fqmul(a[1], b[1]), zeta) + fqmul(a[0], b[0]));
+    r[1] = static_cast<int16_t>(fqmul(a[0], b[1]) + fqmul(a[1], b[0]));
+}
+
+void basemul_acc_portable(Poly& r, const Poly* a, const Poly* b, size_t count) {
+    for (int i = 0; i < N; ++i) r.coeffs[i] = 0;
+    for (size_t p = 0; p < count; ++p) {
+        for (int i = 0; i < N / 4; ++i) {
+            const int16_t zeta = ZETAS[64 + i];
+            int16_t t[4];
+            basemul(t, a[p].coeffs + 4 * i, b[p].coeffs + 4 * i, zeta);
+            basemul(t + 2, a[p].coeffs + 4 * i + 2, b[p].coeffs + 4 * i + 2, static_cast<int16_t>(-zeta));
+            for (int j = 0; j < 4; ++j) r.coeffs[4 * i + j] = static_cast<int16_t>(r.coeffs[4 * i + j] + t[j]);
+        }
+    }
+    for (int i = 0; i < N; ++i) r.coeffs[i] = barrett_reduce(r.coeffs[i]);
+}
+
+void cbd2_portable(Poly& r, const uint8_t buf[64 * ETA]) {
+    for (int i = 0; i < N / 8; ++i) {
+        const uint32_t t = static_cast<uint32_t>(buf[4 * i]) | (static_cast<uint32_t>(buf[4 * i + 1]) << 8) |
+                           (static_cast<uint32_t>(buf[4 * i + 2]) << 16) |
+                           (static_cast<uint32_t>(buf[4 * i + 3]) << 24);
+        const uint32_t d = (t & 0x55555555) + ((t >> 1) & 0x55555555);
+        for (int j = 0; j < 8; ++j) {
+            const int16_t a = static_cast<int16_t>((d >> (4 * j)) & 3);
+            const int16_t b = static_cast<int16_t>((d >> (4 * j + 2)) & 3);
+            r.coeffs[8 * i + j] = static_cast<int16_t>(a - b);
+        }
+    }
+}
+
+} // namespace
+
+const Kernels PORTABLE_KERNELS = {
+    ntt_portable,
+    invntt_tomont_portable,
+    basemul_acc_portable,
+    cbd2_portable,
+    keccak::permute_x4_portable,
+    "portable",
+};
+
+} // namespace mlkem
+} // namespace Crypto
@@ -1,46 +1,89 @@
 #include "post_quantum_crypto.h"
+#include "ml_kem.h"
+#include "thread_pool.h"
+
+#include <atomic>
+#include <chrono>
+#include <span>
+#include <string_view>
+#include <unordered_map>
 
 namespace Crypto {
 
 PostQuantumCrypto::PostQuantumCrypto() {}
 
 PostQuantumCrypto::KyberKeyPair PostQuantumCrypto::generate_kyber_keypair() {
-    KyberKeyPair kp;
-    
-    kp.public_key.resize(768);
-    kp.secret_key.resize(1632);
-    
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    const MlKem1024::KeyPair generated = MlKem1024::generate_keypair();
     
-    for (auto& b : kp.public_key) b = dis(gen);
-    for (auto& b : kp.secret_key) b = dis(gen);
+    KyberKeyPair kp;
+    kp.public_key.assign(generated.public_key.begin(), generated.public_key.end());
+    kp.secret_key.assign(generated.secret_key.begin(), generated.secret_key.end());
     
     std::cout << "\n=== Post-Quantum Key Generation ===" << std::endl;
-    std::cout << "Algorithm: CRYSTALS-Kyber-768" << std::endl;
+    std::cout << "Algorithm: ML-KEM-1024 (FIPS 203)" << std::endl;
     std::cout << "Public Key Size: " << kp.public_key.size() << " bytes" << std::endl;
     std::cout << "Secret Key Size: " << kp.secret_key.size() << " bytes" << std::endl;
+    std::cout << "Polynomial kernels: " << MlKem1024::backend_name() << std::endl;
     
     return kp;
 }
 
-std::vector<uint8_t> PostQuantumCrypto::kyber_encapsulate(
+PostQuantumCrypto::KyberEncapsulation PostQuantumCrypto::kyber_encapsulate(
     const std::vector<uint8_t>& public_key) {
     
-    std::vector<uint8_t> ciphertext(768);
-    std::vector<uint8_t> shared_secret(32);
+    if (public_key.size() != MlKem1024::PUBLIC_KEY_SIZE) {
+        std::cout << "[!] Encapsulation: public key must be " << MlKem1024::PUBLIC_KEY_SIZE << " bytes" << std::endl;
+        return {};
+    }
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    const auto encapsulation =
+        MlKem1024::encapsulate(std::span<const uint8_t, MlKem1024::PUBLIC_KEY_SIZE>(public_key.data(), public_key.size()));
+    if (!encapsulation) {
+        std::cout << "[!] Encapsulation: public key failed the modulus check" << std::endl;
+        return {};
+    }
     
-    for (auto& b : ciphertext) b = dis(gen);
-    for (auto& b : shared_secret) b = dis(gen);
+    KyberEncapsulation result;
+    result.ciphertext.assign(encapsulation->ciphertext.begin(), encapsulation->ciphertext.end());
+    result.shared_secret.assign(encapsulation->shared_secret.begin(), encapsulation->shared_secret.end());
     
-    std::cout << "Encapsulation: OK (ciphertext " << ciphertext.size() << " bytes)" << std::endl;
+    std::cout << "Encapsulation: OK (ciphertext " << result.ciphertext.size() << " bytes)" << std::endl;
     
-    return shared_secret;
+    return result;
+}
+
+std::vector<uint8_t> PostQuantumCrypto::kyber_decapsulate(
+    const std::vector<uint8_t>& ciphertext,
+    const std::vector<uint8_t>& secret_key) {
+    
+    if (ciphertext.size() != MlKem1024::CIPHERTEXT_SIZE || secret_key.size() != MlKem1024::SECRET_KEY_SIZE) {
+        std::cout << "[!] Decapsulation: expected " << MlKem1024::CIPHERTEXT_SIZE << "-byte ciphertext and "
+                  << MlKem1024::SECRET_KEY_SIZE << "-byte secret key" << std::endl;
+        return {};
+    }
+    
+    const auto shared_secret = MlKem1024::decapsulate(
+        std::span<const uint8_t, MlKem1024::SECRET_KEY_SIZE>(secret_key.data(), secret_key.size()),
+        std::span<const uint8_t, MlKem1024::CIPHERTEXT_SIZE>(ciphertext.data(), ciphertext.size()));
+    if (!shared_secret) {
+        std::cout << "[!] Decapsulation: secret key failed the hash check" << std::endl;
+        return {};
+    }
+    
+    return std::vector<uint8_t>(shared_secret->begin(), shared_secret->end());
+}
+
+PostQuantumCrypto::DilithiumKeyPair PostQuantumCrypto::generate_dilithium_keypair() {
+    const MlDsa87::KeyPair generated = MlDsa87::generate_keypair();
+    
+    DilithiumKeyPair kp;
+    kp.public_key.assign(generated.public_key.begin(), generated.public_key.end());
+    kp.secret_key.assign(generated.secret_key.begin(), generated.secret_key.end());
+    
+    std::cout << "ML-DSA-87 Key Pair Generated (public " << kp.public_key.size() << " bytes, secret "
+              << kp.secret_key.size() << " bytes)" << std::endl;
+    
+    return kp;
 }
 
 PostQuantumCrypto::DilithiumSignature PostQuantumCrypto::dilithium_sign(
@@ -48,17 +91,19 @@ PostQuantumCrypto::DilithiumSignature PostQuantumCrypto::dilithium_sign(
     const std::vector<uint8_t>& secret_key) {
     
     DilithiumSignature sig;
-    sig.signature.resize(2420);
     sig.nonce = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    if (secret_key.size() != MlDsa87::SECRET_KEY_SIZE) {
+        std::cout << "[!] Dilithium: secret key must be " << MlDsa87::SECRET_KEY_SIZE << " bytes" << std::endl;
+        return sig;
+    }
     
-    for (auto& b : sig.signature) b = dis(gen);
+    const auto signature = MlDsa87::sign(
+        std::span<const uint8_t, MlDsa87::SECRET_KEY_SIZE>(secret_key.data(), secret_key.size()), message);
+    sig.signature.assign(signature->begin(), signature->end());
     
-    std::cout << "Dilithium-5 Signature: OK (" << sig.signature.size() << " bytes)" << std::endl;
+    std::cout << "ML-DSA-87 Signature: OK (" << sig.signature.size() << " bytes)" << std::endl;
     
     return sig;
 }
@@ -68,33 +113,99 @@ bool PostQuantumCrypto::dilithium_verify(
     const DilithiumSignature& sig,
     const std::vector<uint8_t>& public_key) {
     
-    return sig.signature.size() == 2420;
+    if (sig.signature.size() != MlDsa87::SIGNATURE_SIZE || public_key.size() != MlDsa87::PUBLIC_KEY_SIZE) {
+        return false;
+    }
+    
+    const auto key = dilithium_keys_.get(
+        std::span<const uint8_t, MlDsa87::PUBLIC_KEY_SIZE>(public_key.data(), public_key.size()));
+    return MlDsa87::verify(*key, message,
+                           std::span<const uint8_t, MlDsa87::SIGNATURE_SIZE>(sig.signature.data(), sig.signature.size()));
+}
+
+size_t PostQuantumCrypto::dilithium_verify_batch(std::span<DilithiumVerifyJob> jobs) {
+    // Resolve keys first so a signer appearing many times in one batch is
+    // expanded once rather than by every worker that misses the cache.
+    std::vector<std::shared_ptr<const MlDsa87::ExpandedPublicKey>> keys(jobs.size());
+    std::unordered_map<std::string_view, size_t> first_use;
+    std::vector<size_t> distinct;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].ok = false;
+        if (jobs[i].public_key.size() != MlDsa87::PUBLIC_KEY_SIZE ||
+            jobs[i].signature.size() != MlDsa87::SIGNATURE_SIZE) {
+            continue;
+        }
+        const std::string_view pk(reinterpret_cast<const char*>(jobs[i].public_key.data()), jobs[i].public_key.size());
+        if (first_use.emplace(pk, i).second) distinct.push_back(i);
+    }
+    
+    ThreadPool& pool = ThreadPool::shared();
+    pool.parallel_for(distinct.size(), [&](size_t d) {
+        const size_t i = distinct[d];
+        keys[i] = dilithium_keys_.get(std::span<const uint8_t, MlDsa87::PUBLIC_KEY_SIZE>(jobs[i].public_key));
+    });
+    
+    std::atomic<size_t> valid{0};
+    pool.parallel_for(jobs.size(), [&](size_t i) {
+        DilithiumVerifyJob& job = jobs[i];
+        if (job.public_key.size() != MlDsa87::PUBLIC_KEY_SIZE || job.signature.size() != MlDsa87::SIGNATURE_SIZE) {
+            return;
+        }
+        const std::string_view pk(reinterpret_cast<const char*>(job.public_key.data()), job.public_key.size());
+        const auto& key = keys[first_use.find(pk)->second];
+        job.ok = MlDsa87::verify(*key, job.message, std::span<const uint8_t, MlDsa87::SIGNATURE_SIZE>(job.signature));
+        if (job.ok) valid.fetch_add(1, std::memory_order_relaxed);
+    });
+    return valid.load();
 }
 
 PostQuantumCrypto::SPHINCSKeyPair PostQuantumCrypto::generate_sphincs_keypair() {
+    const SlhDsaShake256f::KeyPair generated = SlhDsaShake256f::generate_keypair();
+    
     SPHINCSKeyPair kp;
+    kp.public_key.assign(generated.public_key.begin(), generated.public_key.end());
+    kp.secret_key.assign(generated.secret_key.begin(), generated.secret_key.end());
     
-    kp.public_key.resize(32);
-    kp.secret_key.resize(64);
+    std::cout << "SLH-DSA-SHAKE-256f Key Pair Generated (public " << kp.public_key.size() << " bytes, secret "
+              << kp.secret_key.size() << " bytes)" << std::endl;
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
+    return kp;
+}
+
+std::vector<uint8_t> PostQuantumCrypto::sphincs_sign(
+    const std::vector<uint8_t>& message,
+    const std::vector<uint8_t>& secret_key) {
     
-    for (auto& b : kp.public_key) b = dis(gen);
-    for (auto& b : kp.secret_key) b = dis(gen);
+    if (secret_key.size() != SlhDsaShake256f::SECRET_KEY_SIZE) {
+        std::cout << "[!] SPHINCS+: secret key must be " << SlhDsaShake256f::SECRET_KEY_SIZE << " bytes" << std::endl;
+        return {};
+    }
     
-    std::cout << "SPHINCS+-256f Key Pair Generated" << std::endl;
+    const auto signature = SlhDsaShake256f::sign(
+        std::span<const uint8_t, SlhDsaShake256f::SECRET_KEY_SIZE>(secret_key.data(), secret_key.size()), message);
+    return std::vector<uint8_t>(signature->begin(), signature->end());
+}
+
+bool PostQuantumCrypto::sphincs_verify(
+    const std::vector<uint8_t>& message,
+    const std::vector<uint8_t>& signature,
+    const std::vector<uint8_t>& public_key) {
     
-    return kp;
+    if (signature.size() != SlhDsaShake256f::SIGNATURE_SIZE || public_key.size() != SlhDsaShake256f::PUBLIC_KEY_SIZE) {
+        return false;
+    }
+    return SlhDsaShake256f::verify(
+        std::span<const uint8_t, SlhDsaShake256f::PUBLIC_KEY_SIZE>(public_key.data(), public_key.size()), message,
+        std::span<const uint8_t, SlhDsaShake256f::SIGNATURE_SIZE>(signature.data(), signature.size()));
 }
 
 void PostQuantumCrypto::print_capabilities() {
     std::cout << "\n=== Post-Quantum Cryptography Suite ===" << std::endl;
     std::cout << "Supported Algorithms:" << std::endl;
-    std::cout << "  - CRYSTALS-Kyber (KEM): IND-CCA2 secure" << std::endl;
-    std::cout << "  - CRYSTALS-Dilithium (Signatures): EUF-CMA secure" << std::endl;
-    std::cout << "  - SPHINCS+ (Stateless signatures): Hash-based" << std::endl;
+    std::cout << "  - ML-KEM-1024 / Kyber (KEM): IND-CCA2 secure, NTT kernels: " << MlKem1024::backend_name() << std::endl;
+    std::cout << "  - ML-DSA-87 / Dilithium (Signatures): EUF-CMA secure, NTT kernels: " << MlDsa87::backend_name() << std::endl;
+    std::cout << "  - SLH-DSA-SHAKE-256f / SPHINCS+ (Stateless signatures): Hash-based, Keccak: "
+              << SlhDsaShake256f::backend_name() << std::endl;
     std::cout << "Security Level: Level 5 (NIST PQC)" << std::endl;
 }
 
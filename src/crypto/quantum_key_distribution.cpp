@@ -1,4 +1,5 @@
 #include "quantum_key_distribution.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -6,7 +7,7 @@ QuantumKeyDistribution::QuantumKeyDistribution() {}
 
 QuantumKeyDistribution::QKDSession QuantumKeyDistribution::start_session() {
     QKDSession session;
-    session.session_id = "qkd_" + std::to_string(rand() % 1000000);
+    session.session_id = "qkd_" + std::to_string(SecureRandom::uniform(1000000));
     session.alice_basis = "rectilinear";
     session.bob_basis = "random";
     session.final_key_length = 0;
@@ -25,8 +26,8 @@ void QuantumKeyDistribution::transmit_photons(QKDSession& session) {
     // Simulate photon transmission
     for (int i = 0; i < 100; ++i) {
         QKDPhoton photon;
-        photon.polarization = rand() % 4; // 0, 1, 2, 3
-        photon.basis = rand() % 2; // 0 or 1
+        photon.polarization = SecureRandom::uniform(4); // 0, 1, 2, 3
+        photon.basis = SecureRandom::uniform(2); // 0 or 1
         session.key_bits.push_back(photon);
     }
     
@@ -39,7 +40,7 @@ void QuantumKeyDistribution::measure_photons(QKDSession& session) {
     // Simulate measurement
     for (auto& photon : session.key_bits) {
         // Random measurement basis
-        photon.basis = rand() % 2;
+        photon.basis = SecureRandom::uniform(2);
     }
     
     std::cout << "Measurement complete" << std::endl;
@@ -78,7 +79,7 @@ void QuantumKeyDistribution::detect_eavesdropper(QKDSession& session) {
     std::cout << "[*] Checking for eavesdropper (QBER measurement)..." << std::endl;
     
     // Simulate error rate check
-    double qber = (rand() % 15) / 10.0; // 0-15% simulated
+    double qber = (SecureRandom::uniform(15)) / 10.0; // 0-15% simulated
     
     std::cout << "Quantum Bit Error Rate (QBER): " << std::fixed << std::setprecision(2) << qber << "%" << std::endl;
     
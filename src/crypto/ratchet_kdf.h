@@ -0,0 +1,58 @@
+#ifndef RATCHET_KDF_H
+#define RATCHET_KDF_H
+
+// Key schedule shared by DoubleRatchet and RatchetSessionManager, which
+// keep the same per-session state in different containers.
+
+#include "double_ratchet.h"
+#include "hmac_sha256.h"
+#include "skipped_key_store.h"
+
+#include <array>
+#include <optional>
+#include <span>
+
+namespace Crypto {
+namespace ratchet {
+
+using ChainKey = std::array<uint8_t, 32>;
+
+// KDF_CK: message key = HMAC(ck, 0x01); the chain key becomes
+// HMAC(ck, 0x02) and `chain` is rekeyed with it.
+DoubleRatchet::MessageKey chain_step(ChainKey& chain_key, HmacSha256& chain, uint64_t& counter);
+
+// KDF_RK: HKDF(salt = root key, ikm = DH output) -> root || initiator
+// chain || responder chain.
+void root_step(DoubleRatchet::RatchetState& state, std::span<const uint8_t> dh_output, bool initiator);
+
+// Steps the receiving chain up to `until`, storing each key under
+// `ratchet`: the keys of a chain about to be replaced, up to the peer's
+// previous chain length. False (nothing done) past max_skip.
+bool skip_to(DoubleRatchet::RatchetState& state, HmacSha256& chain, const SkippedKeyStore::RatchetId& ratchet,
+             SkippedKeyStore& store, uint64_t until);
+
+// Receiving-chain key for `message_number`, fast-forwarding and storing
+// the keys stepped over under `ratchet`, or taking an earlier one from
+// `store`. nullopt past max_skip or when the key is gone.
+std::optional<DoubleRatchet::MessageKey> receive_at(DoubleRatchet::RatchetState& state, HmacSha256& chain,
+                                                    const SkippedKeyStore::RatchetId& ratchet,
+                                                    SkippedKeyStore& store, uint64_t message_number);
+
+// receive_at() without its side effects, for a message not yet
+// authenticated: the key from a copy of the chain, or read from `store`.
+// Commit with receive_at() (or the chain after the key) once the message
+// checks out.
+struct Peek {
+    DoubleRatchet::MessageKey key;
+    ChainKey next_chain_key;                // after the key; unset when read from the store
+    std::optional<HmacSha256> next_chain;   // keyed with next_chain_key
+    uint64_t from;                          // receiving counter at the peek
+};
+std::optional<Peek> peek_at(const DoubleRatchet::RatchetState& state, const HmacSha256& chain,
+                            const SkippedKeyStore::RatchetId& ratchet, const SkippedKeyStore& store,
+                            uint64_t message_number);
+
+} // namespace ratchet
+} // namespace Crypto
+
+#endif // RATCHET_KDF_H
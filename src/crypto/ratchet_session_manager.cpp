@@ -0,0 +1,545 @@
+#include "ratchet_session_manager.h"
+#include "ratchet_kdf.h"
+#include "secure_random.h"
+#include "session_store.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+namespace Crypto {
+
+namespace {
+
+constexpr uint64_t EMPTY = 0;
+constexpr size_t INITIAL_SLOTS = 16;
+
+// std::hash of the peer id, finalized so that both the top bits (shard)
+// and the low bits (slot) are well mixed. Never 0 (the empty tag).
+uint64_t peer_hash(std::string_view peer) {
+    uint64_t h = std::hash<std::string_view>{}(peer);
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h | 1;
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// Skipped keys of all sessions share the shard's store, so the ratchet id
+// binds the peer as well as its ratchet public key. Chains started without
+// a public key are told apart by the ratchet step count instead, and by
+// the session's random salt: a session reopened with the same peer counts
+// from zero again, and must not reach the keys its predecessor skipped.
+SkippedKeyStore::RatchetId ratchet_id(std::string_view peer, std::span<const uint8_t> ratchet_public_key,
+                                      uint64_t epoch, uint64_t salt) {
+    Sha256 ctx;
+    ctx.update(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(peer.data()), peer.size()));
+    if (ratchet_public_key.empty()) {
+        uint8_t counter[17] = {0xFF};
+        for (int i = 0; i < 8; ++i) counter[1 + i] = static_cast<uint8_t>(epoch >> (8 * i));
+        for (int i = 0; i < 8; ++i) counter[9 + i] = static_cast<uint8_t>(salt >> (8 * i));
+        ctx.update(counter);
+    } else {
+        ctx.update(ratchet_public_key);
+    }
+    return ctx.finish();
+}
+
+} // namespace
+
+struct alignas(64) RatchetSessionManager::Session {
+    std::string peer_id;
+    uint64_t hash = 0;
+    DoubleRatchet::RatchetState state{};
+    std::optional<HmacSha256> sending_chain;
+    std::optional<HmacSha256> receiving_chain;
+    SkippedKeyStore::RatchetId receiving_ratchet{};
+    uint64_t epoch = 0;                 // DH ratchet steps so far
+    uint64_t salt = 0;                  // per open or load, for ratchet_id()
+    bool initiator = false;
+    bool dirty = false;                 // counters logged since the last save
+    uint64_t batch = 0;                 // decrypt_batch() that last numbered NEXT jobs here
+    uint64_t batch_next = 0;            // NEXT jobs it numbered
+    SessionStore::Handle stored;
+
+    void rekey_chains(std::span<const uint8_t> dh_output) {
+        ratchet::root_step(state, dh_output, initiator);
+        sending_chain.emplace(state.sending_chain_key);
+        receiving_chain.emplace(state.receiving_chain_key);
+    }
+
+    std::optional<MessageKey> derive(bool sending, uint64_t message_number, SkippedKeyStore& skipped) {
+        if (sending) {
+            return ratchet::chain_step(state.sending_chain_key, *sending_chain, state.sending_ratchet_counter);
+        }
+        if (message_number == NEXT) {
+            return ratchet::chain_step(state.receiving_chain_key, *receiving_chain, state.receiving_ratchet_counter);
+        }
+        return ratchet::receive_at(state, *receiving_chain, receiving_ratchet, skipped, message_number);
+    }
+
+    SessionStore::Record record() const {
+        return {peer_id, initiator, state, receiving_ratchet, epoch};
+    }
+
+    void restore(const SessionStore::Record& record, const SessionStore::Handle& handle) {
+        initiator = record.initiator;
+        state = record.state;
+        receiving_ratchet = record.receiving_ratchet;
+        epoch = record.epoch;
+        salt = SecureRandom::next_u64();
+        stored = handle;
+        sending_chain.emplace(state.sending_chain_key);
+        receiving_chain.emplace(state.receiving_chain_key);
+    }
+
+    void wipe() {
+        secure_wipe(&state, sizeof(state));
+        sending_chain.reset();
+        receiving_chain.reset();
+    }
+};
+
+// Sessions are stored densely; the open-addressing index holds only
+// (hash, position) pairs, so probing stays within a few cache lines and a
+// half-empty index costs 16 bytes per free slot, not a whole session.
+struct alignas(64) RatchetSessionManager::Shard {
+    struct Slot {
+        uint64_t hash;                  // EMPTY: free
+        uint32_t index;                 // into sessions
+    };
+
+    Shard(size_t shard_index, const SkippedKeyStore::Limits& limits)
+        : index(shard_index), slots(INITIAL_SLOTS, Slot{EMPTY, 0}), skipped(limits) {}
+    ~Shard() {
+        for (auto& session : sessions) session.wipe();
+    }
+
+    size_t index;                       // also the session store log segment
+    mutable std::mutex mutex;
+    std::vector<Slot> slots;
+    std::vector<Session> sessions;
+    SkippedKeyStore skipped;
+
+    size_t mask() const { return slots.size() - 1; }
+
+    // Slot holding the peer's session, or the empty slot ending its run.
+    size_t find(uint64_t hash, std::string_view peer) const {
+        for (size_t slot = hash & mask();; slot = (slot + 1) & mask()) {
+            if (slots[slot].hash == EMPTY) return slot;
+            if (slots[slot].hash == hash && sessions[slots[slot].index].peer_id == peer) return slot;
+        }
+    }
+
+    Session* lookup(uint64_t hash, std::string_view peer) {
+        const size_t slot = find(hash, peer);
+        return slots[slot].hash == EMPTY ? nullptr : &sessions[slots[slot].index];
+    }
+
+    // Index kept at most half full.
+    void grow() {
+        std::vector<Slot> old(2 * slots.size(), Slot{EMPTY, 0});
+        old.swap(slots);
+        for (const Slot& entry : old) {
+            if (entry.hash == EMPTY) continue;
+            size_t slot = entry.hash & mask();
+            while (slots[slot].hash != EMPTY) slot = (slot + 1) & mask();
+            slots[slot] = entry;
+        }
+    }
+
+    Session& insert(uint64_t hash, std::string_view peer) {
+        if (2 * (sessions.size() + 1) > slots.size()) grow();
+        const size_t slot = find(hash, peer);
+        slots[slot] = {hash, static_cast<uint32_t>(sessions.size())};
+        Session& session = sessions.emplace_back();
+        session.peer_id.assign(peer);
+        session.hash = hash;
+        return session;
+    }
+
+    // Backward-shift deletion, as in SkippedKeyStore: no tombstones. The
+    // last session then moves into the freed position.
+    void erase(size_t slot) {
+        const uint32_t index = slots[slot].index;
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & mask(); slots[next].hash != EMPTY; next = (next + 1) & mask()) {
+            const size_t home = slots[next].hash & mask();
+            const bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+            if (!stays) {
+                slots[hole] = slots[next];
+                hole = next;
+            }
+        }
+        slots[hole].hash = EMPTY;
+
+        sessions[index].wipe();
+        if (index + 1 != sessions.size()) {
+            Session& last = sessions.back();
+            slots[find(last.hash, last.peer_id)].index = index;
+            sessions[index] = std::move(last);
+            last.wipe();
+        }
+        sessions.pop_back();
+    }
+};
+
+RatchetSessionManager::RatchetSessionManager(size_t shards, const SkippedKeyStore::Limits& shard_limits) {
+    if (shards == 0) {
+        shards = 4 * std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t rounded = 2;
+    int bits = 1;
+    while (rounded < shards) {
+        rounded <<= 1;
+        ++bits;
+    }
+    shard_shift_ = 64 - bits;
+    shards_.reserve(rounded);
+    for (size_t i = 0; i < rounded; ++i) shards_.push_back(std::make_unique<Shard>(i, shard_limits));
+}
+
+RatchetSessionManager::~RatchetSessionManager() {
+    if (store_ != nullptr) flush();
+}
+
+bool RatchetSessionManager::attach_store(SessionStore& store) {
+    if (store.segment_count() < shards_.size()) {
+        std::cout << "[!] Session store has " << store.segment_count() << " log segments for " << shards_.size()
+                  << " shards" << std::endl;
+        return false;
+    }
+    store_ = &store;
+    return true;
+}
+
+void RatchetSessionManager::flush() {
+    if (store_ == nullptr) return;
+    for (auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        checkpoint(*shard);
+    }
+    store_->sync();
+}
+
+RatchetSessionManager::Session* RatchetSessionManager::resolve(Shard& shard, uint64_t hash,
+                                                               std::string_view peer_id) {
+    if (Session* session = shard.lookup(hash, peer_id)) return session;
+    if (store_ == nullptr) return nullptr;
+
+    SessionStore::Handle handle;
+    auto record = store_->load(peer_id, handle);
+    if (!record) return nullptr;
+    Session& session = shard.insert(hash, peer_id);
+    session.restore(*record, handle);
+    secure_wipe(&record->state, sizeof(record->state));
+    return &session;
+}
+
+// Write-ahead: the counters reach the log before the key is handed out,
+// so a restart never derives the same key twice.
+std::optional<RatchetSessionManager::MessageKey> RatchetSessionManager::derive_logged(Shard& shard, Session& session,
+                                                                                     bool sending,
+                                                                                     uint64_t message_number) {
+    auto key = session.derive(sending, message_number, shard.skipped);
+    if (key) log_counters(shard, session);
+    return key;
+}
+
+void RatchetSessionManager::log_counters(Shard& shard, Session& session) {
+    if (store_ == nullptr || session.stored.slot == SessionStore::NO_SLOT) return;
+    session.dirty = true;
+    if (!store_->log_counters(shard.index, session.stored, session.state.sending_ratchet_counter,
+                              session.state.receiving_ratchet_counter)) {
+        checkpoint(shard);
+    }
+}
+
+bool RatchetSessionManager::commit_peek(Shard& shard, Session& session, const SkippedKeyStore::RatchetId& ratchet,
+                                        const ratchet::Peek& peek) {
+    const uint64_t n = peek.key.message_number;
+    if (ratchet != session.receiving_ratchet) {
+        // The chain moved on (DH step) since: the key is a skipped one now.
+        auto key = shard.skipped.take(ratchet, n);
+        if (key) secure_wipe(key->data(), key->size());
+        return key.has_value();
+    }
+    if (peek.from == n && session.state.receiving_ratchet_counter == n) {
+        // In order and nothing moved: the next chain key is already known.
+        session.state.receiving_chain_key = peek.next_chain_key;
+        session.receiving_chain = peek.next_chain;
+        ++session.state.receiving_ratchet_counter;
+        log_counters(shard, session);
+        return true;
+    }
+    auto key = derive_logged(shard, session, false, n);
+    if (key) secure_wipe(key->key.data(), key->key.size());
+    return key.has_value();
+}
+
+// Saves the shard's changed sessions, after which its log is not needed.
+void RatchetSessionManager::checkpoint(Shard& shard) {
+    for (Session& session : shard.sessions) {
+        if (!session.dirty) continue;
+        SessionStore::Record record = session.record();
+        store_->save(record, session.stored);
+        secure_wipe(&record.state, sizeof(record.state));
+        session.dirty = false;
+    }
+    store_->reset_segment(shard.index);
+}
+
+bool RatchetSessionManager::open_session(std::string_view peer_id, const RootKey& root_key, bool initiator) {
+    const uint64_t hash = peer_hash(peer_id);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    if (resolve(shard, hash, peer_id) != nullptr) {
+        return false;
+    }
+    Session& session = shard.insert(hash, peer_id);
+    session.initiator = initiator;
+    session.state.root_key = root_key;
+    session.state.sending_ratchet_counter = 0;
+    session.state.receiving_ratchet_counter = 0;
+    session.state.previous_chain_length = 0;
+    session.epoch = 0;
+    session.salt = SecureRandom::next_u64();
+    session.receiving_ratchet = ratchet_id(peer_id, {}, 0, session.salt);
+    session.rekey_chains({});
+    if (store_ != nullptr) {
+        SessionStore::Record record = session.record();
+        store_->save(record, session.stored);
+        secure_wipe(&record.state, sizeof(record.state));
+    }
+    return true;
+}
+
+bool RatchetSessionManager::close_session(std::string_view peer_id) {
+    const uint64_t hash = peer_hash(peer_id);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    const size_t slot = shard.find(hash, peer_id);
+    const bool loaded = shard.slots[slot].hash != EMPTY;
+    // Its skipped keys age out of the shard's store; a reopened session
+    // has another salt, so it cannot reach them.
+    if (loaded) shard.erase(slot);
+    const bool stored = store_ != nullptr && store_->erase(peer_id);
+    return loaded || stored;
+}
+
+bool RatchetSessionManager::contains(std::string_view peer_id) const {
+    const uint64_t hash = peer_hash(peer_id);
+    const Shard& shard = *shards_[shard_of(hash)];
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.slots[shard.find(hash, peer_id)].hash != EMPTY) return true;
+    }
+    return store_ != nullptr && store_->contains(peer_id);
+}
+
+size_t RatchetSessionManager::size() const {
+    size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        total += shard->sessions.size();
+    }
+    return total;
+}
+
+std::optional<RatchetSessionManager::MessageKey> RatchetSessionManager::derive_message_key(std::string_view peer_id,
+                                                                                         bool sending) {
+    const uint64_t hash = peer_hash(peer_id);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Session* session = resolve(shard, hash, peer_id);
+    if (session == nullptr) return std::nullopt;
+    return derive_logged(shard, *session, sending, NEXT);
+}
+
+std::optional<RatchetSessionManager::MessageKey> RatchetSessionManager::derive_message_key_at(
+    std::string_view peer_id, uint64_t message_number) {
+    const uint64_t hash = peer_hash(peer_id);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Session* session = resolve(shard, hash, peer_id);
+    if (session == nullptr) return std::nullopt;
+    return derive_logged(shard, *session, false, message_number);
+}
+
+std::optional<RatchetSessionManager::MessageKey> RatchetSessionManager::derive_message_key_at(
+    std::string_view peer_id, std::span<const uint8_t> ratchet_public_key, uint64_t message_number) {
+    const uint64_t hash = peer_hash(peer_id);
+    const SkippedKeyStore::RatchetId id = ratchet_id(peer_id, ratchet_public_key, 0, 0);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Session* session = resolve(shard, hash, peer_id);
+    if (session == nullptr) return std::nullopt;
+    if (id == session->receiving_ratchet) {
+        return derive_logged(shard, *session, false, message_number);
+    }
+    const auto key = shard.skipped.take(id, message_number);
+    if (!key) return std::nullopt;
+    return MessageKey{*key, message_number};
+}
+
+bool RatchetSessionManager::ratchet_forward(std::string_view peer_id, std::span<const uint8_t> dh_output,
+                                            std::span<const uint8_t> remote_ratchet_public_key,
+                                            uint64_t remote_previous_chain_length) {
+    const uint64_t hash = peer_hash(peer_id);
+    Shard& shard = *shards_[shard_of(hash)];
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    Session* session = resolve(shard, hash, peer_id);
+    if (session == nullptr) return false;
+    // Messages of the old chain still on their way keep their keys.
+    if (!ratchet::skip_to(session->state, *session->receiving_chain, session->receiving_ratchet, shard.skipped,
+                          remote_previous_chain_length)) {
+        return false;
+    }
+    session->state.previous_chain_length = session->state.sending_ratchet_counter;
+    session->state.sending_ratchet_counter = 0;
+    session->state.receiving_ratchet_counter = 0;
+    session->rekey_chains(dh_output);
+    // Without a public key, the old chain's skipped keys become unreachable
+    // and age out of the store.
+    session->receiving_ratchet =
+        ratchet_id(peer_id, remote_ratchet_public_key, ++session->epoch, session->salt);
+    if (store_ != nullptr) {
+        SessionStore::Record record = session->record();
+        store_->save(record, session->stored);
+        secure_wipe(&record.state, sizeof(record.state));
+        session->dirty = false;
+    }
+    return true;
+}
+
+template <class PeerOf>
+std::vector<uint32_t> RatchetSessionManager::group_by_shard(size_t count, std::vector<uint64_t>& hashes,
+                                                            PeerOf&& peer_of) const {
+    hashes.resize(count);
+    std::vector<uint32_t> starts(shards_.size() + 1, 0);
+    for (size_t i = 0; i < count; ++i) {
+        hashes[i] = peer_hash(peer_of(i));
+        ++starts[shard_of(hashes[i]) + 1];
+    }
+    for (size_t s = 0; s < shards_.size(); ++s) starts[s + 1] += starts[s];
+    std::vector<uint32_t> order(count);
+    for (size_t i = 0; i < count; ++i) order[starts[shard_of(hashes[i])]++] = static_cast<uint32_t>(i);
+    return order;
+}
+
+void RatchetSessionManager::derive_batch(std::span<DeriveRequest> requests) {
+    std::vector<uint64_t> hashes;
+    const std::vector<uint32_t> order =
+        group_by_shard(requests.size(), hashes, [&](size_t i) { return requests[i].peer_id; });
+
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t s = shard_of(hashes[order[begin]]);
+        size_t end = begin;
+        while (end < order.size() && shard_of(hashes[order[end]]) == s) ++end;
+
+        Shard& shard = *shards_[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        for (size_t k = begin; k < end; ++k) {
+            DeriveRequest& r = requests[order[k]];
+            Session* session = resolve(shard, hashes[order[k]], r.peer_id);
+            r.key = session ? derive_logged(shard, *session, r.sending, r.message_number) : std::nullopt;
+        }
+        begin = end;
+    }
+}
+
+// Three passes: peek every key (shard by shard), open the whole batch,
+// commit the keys of what authenticated (shard by shard again).
+size_t RatchetSessionManager::decrypt_batch(std::span<DecryptJob> jobs) {
+    std::vector<uint64_t> hashes;
+    const std::vector<uint32_t> order =
+        group_by_shard(jobs.size(), hashes, [&](size_t i) { return jobs[i].peer_id; });
+    auto for_each_shard = [&](auto&& fn) {
+        for (size_t begin = 0; begin < order.size();) {
+            const size_t s = shard_of(hashes[order[begin]]);
+            size_t end = begin;
+            while (end < order.size() && shard_of(hashes[order[end]]) == s) ++end;
+            Shard& shard = *shards_[s];
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (size_t k = begin; k < end; ++k) {
+                const uint32_t i = order[k];
+                fn(shard, resolve(shard, hashes[i], jobs[i].peer_id), i);
+            }
+            begin = end;
+        }
+    };
+
+    std::vector<std::optional<ratchet::Peek>> peeks(jobs.size());
+    std::vector<SkippedKeyStore::RatchetId> ratchets(jobs.size());
+    // NEXT jobs of one peer take consecutive numbers, as derive_batch() would.
+    const uint64_t batch_id = batches_.fetch_add(1, std::memory_order_relaxed) + 1;
+    for_each_shard([&](Shard& shard, Session* session, uint32_t i) {
+        if (session == nullptr) return;
+        uint64_t n = jobs[i].message_number;
+        if (n == NEXT) {
+            if (session->batch != batch_id) {
+                session->batch = batch_id;
+                session->batch_next = 0;
+            }
+            n = session->state.receiving_ratchet_counter + session->batch_next++;
+        }
+        ratchets[i] = session->receiving_ratchet;
+        peeks[i] = ratchet::peek_at(session->state, *session->receiving_chain, ratchets[i], shard.skipped, n);
+    });
+
+    // Constructed in place: the vector never reallocates.
+    std::vector<std::optional<CipherEngine>> engines(jobs.size());
+    std::vector<CipherEngine::BatchJob> batch;
+    std::vector<size_t> owners;
+    batch.reserve(jobs.size());
+    owners.reserve(jobs.size());
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        jobs[i].ok = false;
+        if (!peeks[i]) continue;
+        engines[i].emplace(std::span<const uint8_t, CipherEngine::KEY_SIZE>(peeks[i]->key.key));
+        secure_wipe(peeks[i]->key.key.data(), peeks[i]->key.key.size());
+        CipherEngine::BatchJob job;
+        job.cipher = &*engines[i];
+        job.nonce = jobs[i].nonce;
+        job.aad = jobs[i].aad;
+        job.in = jobs[i].in;
+        job.out = jobs[i].out;
+        job.tag = jobs[i].tag;
+        batch.push_back(job);
+        owners.push_back(i);
+    }
+
+    CipherEngine::open_batch(batch);
+    std::vector<uint8_t> authentic(jobs.size(), 0);
+    for (size_t k = 0; k < batch.size(); ++k) authentic[owners[k]] = batch[k].ok;
+
+    size_t valid = 0;
+    for_each_shard([&](Shard& shard, Session* session, uint32_t i) {
+        if (!authentic[i]) return;
+        jobs[i].ok = session != nullptr && commit_peek(shard, *session, ratchets[i], *peeks[i]);
+        // Authentic but its key already used (a replay, or a number twice
+        // in this batch): wiped like any failed open.
+        if (!jobs[i].ok) secure_wipe(jobs[i].out.data(), jobs[i].out.size());
+        valid += jobs[i].ok;
+    });
+    for (auto& peek : peeks) {
+        if (peek) secure_wipe(peek->next_chain_key.data(), peek->next_chain_key.size());
+    }
+    return valid;
+}
+
+} // namespace Crypto
@@ -1,4 +1,5 @@
 #include "ring_signatures.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -10,7 +11,7 @@ RingKeyPair RingSignatures::generate_key_pair() {
     RingKeyPair key_pair;
     key_pair.private_key = {0x01, 0x02, 0x03, 0x04, 0x05};
     key_pair.public_key = {0x10, 0x11, 0x12, 0x13, 0x14};
-    key_pair.key_image = "ring_ki_" + std::to_string(rand() % 1000000);
+    key_pair.key_image = "ring_ki_" + std::to_string(SecureRandom::uniform(1000000));
     
     std::cout << "[*] Generating ring signature key pair..." << std::endl;
     std::cout << "[+] Private key generated" << std::endl;
@@ -50,7 +51,7 @@ std::vector<uint8_t> RingSignatures::generate_key_image(const std::vector<uint8_
 
 LinkableTag RingSignatures::create_linkable_tag(const std::string& group_id) {
     LinkableTag tag;
-    tag.tag_id = "tag_" + std::to_string(rand() % 1000000);
+    tag.tag_id = "tag_" + std::to_string(SecureRandom::uniform(1000000));
     tag.linked_group = group_id;
     tag.is_spent = false;
     
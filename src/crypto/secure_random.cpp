@@ -0,0 +1,192 @@
+#include "secure_random.h"
+#include "kernel_table.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <random>
+
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+#if defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#endif
+
+namespace Crypto {
+
+namespace {
+
+constexpr size_t BUFFER_SIZE = 1024;            // 16 blocks: one AVX-512 keystream call
+constexpr size_t BULK_CHUNK = 64 * 1024;        // large fills rekey at least this often
+constexpr uint8_t NONCE[12] = {};               // every key is used for one call only
+
+// Bumped in the child after fork(); threads compare it before each draw.
+std::atomic<uint64_t> fork_generation{0};
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+void os_entropy(uint8_t* out, size_t len) {
+#if defined(__linux__)
+    while (len > 0) {
+        const ssize_t n = ::getrandom(out, len, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        out += n;
+        len -= static_cast<size_t>(n);
+    }
+#endif
+    if (len > 0) {
+        std::random_device rd;
+        for (size_t i = 0; i < len; i += 4) {
+            const uint32_t v = rd();
+            std::memcpy(out + i, &v, std::min<size_t>(4, len - i));
+        }
+    }
+}
+
+void watch_fork() {
+#if defined(__unix__) || defined(__APPLE__)
+    static const bool registered = [] {
+        pthread_atfork(nullptr, nullptr, [] { fork_generation.fetch_add(1, std::memory_order_relaxed); });
+        return true;
+    }();
+    (void)registered;
+#endif
+}
+
+struct Drbg {
+    uint8_t key[32];
+    uint8_t buffer[BUFFER_SIZE];
+    size_t available = 0;                       // unread bytes at the end of buffer
+    uint64_t since_reseed = 0;
+    uint64_t generation = 0;
+    bool seeded = false;
+    bool deterministic = false;                 // keyed by seed_deterministic()
+
+    ~Drbg() { secure_wipe(this, sizeof(*this)); }
+
+    void reseed() {
+        watch_fork();
+        uint8_t fresh[32];
+        os_entropy(fresh, sizeof(fresh));
+        // A seeded key is public: drop it rather than mix it in.
+        const bool keep = seeded && !deterministic;
+        for (size_t i = 0; i < 32; ++i) key[i] = (keep ? key[i] : 0) ^ fresh[i];
+        secure_wipe(fresh, sizeof(fresh));
+        secure_wipe(buffer, sizeof(buffer));
+        available = 0;
+        since_reseed = 0;
+        generation = fork_generation.load(std::memory_order_relaxed);
+        seeded = true;
+        deterministic = false;
+    }
+
+#if defined(CRYPTO_SIMULATION)
+    void seed_with(uint64_t seed) {
+        std::memset(key, 0, sizeof(key));
+        for (size_t i = 0; i < 8; ++i) key[i] = static_cast<uint8_t>(seed >> (8 * i));
+        secure_wipe(buffer, sizeof(buffer));
+        available = 0;
+        since_reseed = 0;
+        generation = fork_generation.load(std::memory_order_relaxed);
+        seeded = true;
+        deterministic = true;
+    }
+#endif
+
+    // Keystream of `key` into out[0, len), then a new key from one more
+    // block: the old key is gone before any output is used.
+    void generate(uint8_t* out, size_t len) {
+        const auto xor_keystream = kernel_table().chacha20_xor;
+        std::memset(out, 0, len);
+        xor_keystream(key, NONCE, 1, out, out, len);
+        uint8_t block[64] = {};
+        xor_keystream(key, NONCE, 0, block, block, sizeof(block));
+        std::memcpy(key, block, sizeof(key));
+        secure_wipe(block, sizeof(block));
+    }
+
+    void fill(uint8_t* out, size_t len) {
+        if (!seeded || (!deterministic && (since_reseed >= SecureRandom::RESEED_INTERVAL ||
+                                           generation != fork_generation.load(std::memory_order_relaxed)))) {
+            reseed();
+        }
+        since_reseed += len;
+        while (len > 0) {
+            if (available == 0 && len >= BUFFER_SIZE) {
+                const size_t chunk = std::min(len, BULK_CHUNK);
+                generate(out, chunk);
+                out += chunk;
+                len -= chunk;
+                continue;
+            }
+            if (available == 0) {
+                generate(buffer, BUFFER_SIZE);
+                available = BUFFER_SIZE;
+            }
+            uint8_t* src = buffer + BUFFER_SIZE - available;
+            const size_t n = std::min(len, available);
+            std::memcpy(out, src, n);
+            secure_wipe(src, n);
+            available -= n;
+            out += n;
+            len -= n;
+        }
+    }
+};
+
+Drbg& thread_drbg() {
+    thread_local Drbg drbg;
+    return drbg;
+}
+
+} // namespace
+
+void SecureRandom::fill(std::span<uint8_t> out) {
+    thread_drbg().fill(out.data(), out.size());
+}
+
+uint32_t SecureRandom::next_u32() {
+    uint32_t v;
+    thread_drbg().fill(reinterpret_cast<uint8_t*>(&v), sizeof(v));
+    return v;
+}
+
+uint64_t SecureRandom::next_u64() {
+    uint64_t v;
+    thread_drbg().fill(reinterpret_cast<uint8_t*>(&v), sizeof(v));
+    return v;
+}
+
+uint64_t SecureRandom::uniform(uint64_t bound) {
+    // Reject the top partial range so every residue is equally likely.
+    const uint64_t limit = UINT64_MAX - UINT64_MAX % bound;
+    uint64_t v;
+    do {
+        v = next_u64();
+    } while (v >= limit);
+    return v % bound;
+}
+
+double SecureRandom::uniform_real() {
+    return static_cast<double>(next_u64() >> 11) * 0x1.0p-53;
+}
+
+void SecureRandom::reseed() {
+    thread_drbg().reseed();
+}
+
+#if defined(CRYPTO_SIMULATION)
+void SecureRandom::seed_deterministic(uint64_t seed) {
+    thread_drbg().seed_with(seed);
+}
+#endif
+
+} // namespace Crypto
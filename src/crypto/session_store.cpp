@@ -0,0 +1,471 @@
+#include "session_store.h"
+#include "ratchet_kdf.h"
+#include "secure_random.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace Crypto {
+
+namespace {
+
+constexpr char MAGIC[8] = {'P', '2', 'P', 'S', 'E', 'S', 'S', '1'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t PAGE = 4096;
+constexpr uint8_t KDF_INFO[] = {'P', '2', 'P', 'C', 'h', 'a', 't', 'S', 'e', 's', 's', 'i', 'o', 'n',
+                                'S', 't', 'o', 'r', 'e'};
+
+// Index tags: 0 free, 1 erased, anything else (low bit forced) in use.
+constexpr uint64_t FREE = 0;
+constexpr uint64_t ERASED = 1;
+
+// Plaintext of one record copy.
+constexpr size_t PEER_OFFSET = 8;
+constexpr size_t KEYS_OFFSET = PEER_OFFSET + SessionStore::MAX_PEER_ID;   // root, sending, receiving chain
+constexpr size_t COUNTERS_OFFSET = KEYS_OFFSET + 96;
+constexpr size_t RATCHET_OFFSET = COUNTERS_OFFSET + 24;
+constexpr size_t EPOCH_OFFSET = RATCHET_OFFSET + 32;
+constexpr size_t PLAINTEXT_SIZE = EPOCH_OFFSET + 8 + 8;
+
+struct RecordCopy {
+    uint64_t generation;            // 0: never written
+    uint8_t sealed[PLAINTEXT_SIZE];
+    uint8_t tag[CipherEngine::TAG_SIZE];
+};
+static_assert(sizeof(RecordCopy) == 320);
+constexpr size_t SLOT_SIZE = 2 * sizeof(RecordCopy);
+
+struct WalEntry {
+    uint32_t slot;
+    uint32_t check;                 // 0: end of segment
+    uint64_t generation;
+    uint64_t sending;
+    uint64_t receiving;
+};
+static_assert(sizeof(WalEntry) == 32);
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// Chain steps one logged key may account for: it can skip max_skip keys.
+constexpr uint64_t MAX_STEPS_PER_ENTRY = SkippedKeyStore::DEFAULT_LIMITS.max_skip + 1;
+
+// A truncated HMAC under a key derived from the storage key: detects torn
+// and stale entries, and forged ones, which could otherwise move counters
+// anywhere. A log cut short or replaced by an older one still rolls
+// counters back to the last checkpoint, which any storage without a
+// trusted counter allows anyway.
+uint32_t entry_check(const WalEntry& e, const HmacSha256& mac) {
+    uint8_t data[4 + 3 * 8];
+    std::memcpy(data, &e.slot, 4);
+    std::memcpy(data + 4, &e.generation, 8);
+    std::memcpy(data + 12, &e.sending, 8);
+    std::memcpy(data + 20, &e.receiving, 8);
+    const HmacSha256::Mac full = mac.mac(data);
+    uint32_t check;
+    std::memcpy(&check, full.data(), sizeof(check));
+    return check | 1;
+}
+
+size_t round_up(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+void encode(const SessionStore::Record& record, uint8_t* out) {
+    std::memset(out, 0, PLAINTEXT_SIZE);
+    out[0] = static_cast<uint8_t>(record.peer_id.size());
+    out[1] = record.initiator ? 1 : 0;
+    std::memcpy(out + PEER_OFFSET, record.peer_id.data(), record.peer_id.size());
+    std::memcpy(out + KEYS_OFFSET, record.state.root_key.data(), 32);
+    std::memcpy(out + KEYS_OFFSET + 32, record.state.sending_chain_key.data(), 32);
+    std::memcpy(out + KEYS_OFFSET + 64, record.state.receiving_chain_key.data(), 32);
+    std::memcpy(out + COUNTERS_OFFSET, &record.state.sending_ratchet_counter, 8);
+    std::memcpy(out + COUNTERS_OFFSET + 8, &record.state.receiving_ratchet_counter, 8);
+    std::memcpy(out + COUNTERS_OFFSET + 16, &record.state.previous_chain_length, 8);
+    std::memcpy(out + RATCHET_OFFSET, record.receiving_ratchet.data(), 32);
+    std::memcpy(out + EPOCH_OFFSET, &record.epoch, 8);
+}
+
+bool decode(const uint8_t* in, SessionStore::Record& record) {
+    if (in[0] > SessionStore::MAX_PEER_ID) return false;
+    record.peer_id.assign(reinterpret_cast<const char*>(in + PEER_OFFSET), in[0]);
+    record.initiator = in[1] != 0;
+    std::memcpy(record.state.root_key.data(), in + KEYS_OFFSET, 32);
+    std::memcpy(record.state.sending_chain_key.data(), in + KEYS_OFFSET + 32, 32);
+    std::memcpy(record.state.receiving_chain_key.data(), in + KEYS_OFFSET + 64, 32);
+    std::memcpy(&record.state.sending_ratchet_counter, in + COUNTERS_OFFSET, 8);
+    std::memcpy(&record.state.receiving_ratchet_counter, in + COUNTERS_OFFSET + 8, 8);
+    std::memcpy(&record.state.previous_chain_length, in + COUNTERS_OFFSET + 16, 8);
+    std::memcpy(record.receiving_ratchet.data(), in + RATCHET_OFFSET, 32);
+    std::memcpy(&record.epoch, in + EPOCH_OFFSET, 8);
+    return true;
+}
+
+// Steps a stored chain to a logged counter; the keys stepped over are gone.
+void advance(std::array<uint8_t, 32>& chain_key, uint64_t& counter, uint64_t target) {
+    if (target <= counter) return;
+    HmacSha256 chain(chain_key);
+    while (counter < target) {
+        DoubleRatchet::MessageKey mk = ratchet::chain_step(chain_key, chain, counter);
+        secure_wipe(mk.key.data(), mk.key.size());
+    }
+}
+
+[[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("SessionStore: " + what + (errno ? std::string(": ") + std::strerror(errno) : ""));
+}
+
+// Opens (creating at `size` bytes if empty) and maps a file.
+uint8_t* map_file(const std::string& path, size_t size, int& fd, size_t& mapped, bool& created) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0) fail("cannot open " + path);
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) fail("cannot stat " + path);
+    created = st.st_size == 0;
+    if (created) {
+        // Sparse: untouched slots take no disk space.
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) fail("cannot size " + path);
+        mapped = size;
+    } else {
+        mapped = static_cast<size_t>(st.st_size);
+    }
+    void* p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) fail("cannot map " + path);
+    return static_cast<uint8_t*>(p);
+}
+
+} // namespace
+
+struct SessionStore::Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t slot_size;
+    uint64_t capacity;
+    uint64_t used;                  // slots in use or erased
+    uint32_t wal_segments;
+    uint32_t segment_entries;
+    uint8_t salt[16];
+    uint8_t key_check[32];
+};
+
+SessionStore::SessionStore(const std::string& path, std::span<const uint8_t, 32> storage_key, const Layout& layout) {
+    if (layout.capacity == 0 || (layout.capacity & (layout.capacity - 1)) != 0 || layout.capacity > NO_SLOT ||
+        layout.wal_segments == 0 || layout.segment_entries == 0) {
+        throw std::invalid_argument("SessionStore: capacity must be a power of two, segments non-empty");
+    }
+    // The destructor does not run for a throwing constructor.
+    try {
+        const size_t tags_size = round_up(layout.capacity * sizeof(uint64_t), PAGE);
+        bool created = false;
+        map_ = map_file(path, PAGE + tags_size + layout.capacity * SLOT_SIZE, fd_, map_size_, created);
+        header_ = reinterpret_cast<Header*>(map_);
+
+        if (created) {
+            std::memcpy(header_->magic, MAGIC, sizeof(MAGIC));
+            header_->version = VERSION;
+            header_->slot_size = SLOT_SIZE;
+            header_->capacity = layout.capacity;
+            header_->used = 0;
+            header_->wal_segments = static_cast<uint32_t>(layout.wal_segments);
+            header_->segment_entries = static_cast<uint32_t>(layout.segment_entries);
+            SecureRandom::fill(header_->salt);
+        } else if (map_size_ < PAGE || std::memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 ||
+                   header_->version != VERSION || header_->slot_size != SLOT_SIZE || header_->capacity == 0 ||
+                   (header_->capacity & (header_->capacity - 1)) != 0 || header_->wal_segments == 0 ||
+                   header_->segment_entries == 0 ||
+                   map_size_ < PAGE + round_up(header_->capacity * sizeof(uint64_t), PAGE) +
+                                   header_->capacity * SLOT_SIZE) {
+            errno = 0;
+            fail(path + " is not a session store");
+        }
+
+        // record key || index key || key check || log key
+        uint8_t okm[128];
+        HmacSha256::hkdf(std::span<const uint8_t>(header_->salt), storage_key, KDF_INFO, okm);
+        if (created) {
+            std::memcpy(header_->key_check, okm + 64, 32);
+            ::msync(map_, PAGE, MS_SYNC);
+        } else if (std::memcmp(header_->key_check, okm + 64, 32) != 0) {
+            secure_wipe(okm, sizeof(okm));
+            errno = 0;
+            fail("wrong storage key for " + path);
+        }
+        cipher_.emplace(std::span<const uint8_t, CipherEngine::KEY_SIZE>(okm, 32));
+        index_mac_.emplace(std::span<const uint8_t>(okm + 32, 32));
+        log_mac_.emplace(std::span<const uint8_t>(okm + 96, 32));
+        secure_wipe(okm, sizeof(okm));
+
+        std::memcpy(file_id_.data(), header_->salt, file_id_.size());
+        mask_ = header_->capacity - 1;
+        tags_ = reinterpret_cast<uint64_t*>(map_ + PAGE);
+        slots_ = map_ + PAGE + round_up(header_->capacity * sizeof(uint64_t), PAGE);
+
+        segment_entries_ = header_->segment_entries;
+        segments_ = std::vector<Segment>(header_->wal_segments);
+        wal_ = map_file(path + ".wal", segments_.size() * segment_entries_ * sizeof(WalEntry), wal_fd_, wal_size_,
+                        created);
+        if (wal_size_ < segments_.size() * segment_entries_ * sizeof(WalEntry)) {
+            errno = 0;
+            fail(path + ".wal is truncated");
+        }
+        replay_log();
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+SessionStore::~SessionStore() { release(); }
+
+void SessionStore::release() {
+    if (wal_ != nullptr) ::munmap(wal_, wal_size_);
+    if (map_ != nullptr) ::munmap(map_, map_size_);
+    if (wal_fd_ >= 0) ::close(wal_fd_);
+    if (fd_ >= 0) ::close(fd_);
+    wal_ = map_ = nullptr;
+    wal_fd_ = fd_ = -1;
+}
+
+uint64_t SessionStore::index_tag(std::string_view peer_id) const {
+    const auto mac = index_mac_->mac(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(peer_id.data()),
+                                                               peer_id.size()));
+    uint64_t tag;
+    std::memcpy(&tag, mac.data(), sizeof(tag));
+    return tag | 2;
+}
+
+uint32_t SessionStore::find(std::string_view peer_id, uint64_t tag, bool insert, Record* found,
+                           uint64_t* generation) {
+    size_t reuse = SIZE_MAX;
+    for (size_t slot = tag & mask_, probes = 0; probes <= mask_; slot = (slot + 1) & mask_, ++probes) {
+        const uint64_t t = tags_[slot];
+        if (t == FREE) {
+            if (!insert) return NO_SLOT;
+            if (reuse != SIZE_MAX) return static_cast<uint32_t>(reuse);
+            // At most 3/4 of the index in use keeps probe runs short.
+            if (4 * (header_->used + 1) > 3 * (mask_ + 1)) return NO_SLOT;
+            return static_cast<uint32_t>(slot);
+        }
+        if (t == ERASED) {
+            if (reuse == SIZE_MAX) reuse = slot;
+            continue;
+        }
+        if (t == tag) {
+            // Tags are 64-bit keyed hashes; the sealed peer id settles it.
+            Record record;
+            uint64_t g;
+            const bool match = read(static_cast<uint32_t>(slot), record, g) && record.peer_id == peer_id;
+            if (match && found != nullptr) *found = record;
+            if (match && generation != nullptr) *generation = g;
+            secure_wipe(&record.state, sizeof(record.state));
+            if (match) return static_cast<uint32_t>(slot);
+        }
+    }
+    return insert && reuse != SIZE_MAX ? static_cast<uint32_t>(reuse) : NO_SLOT;
+}
+
+bool SessionStore::read(uint32_t slot, Record& record, uint64_t& generation) const {
+    const auto* copies = reinterpret_cast<const RecordCopy*>(slots_ + static_cast<size_t>(slot) * SLOT_SIZE);
+    const RecordCopy* order[2] = {&copies[0], &copies[1]};
+    if (copies[1].generation > copies[0].generation) std::swap(order[0], order[1]);
+
+    uint8_t aad[20];
+    std::memcpy(aad, file_id_.data(), 16);
+    std::memcpy(aad + 16, &slot, 4);
+    uint8_t plain[PLAINTEXT_SIZE];
+    for (const RecordCopy* copy : order) {
+        if (copy->generation == 0) continue;
+        CipherEngine::Nonce nonce;
+        std::memcpy(nonce.data(), &slot, 4);
+        std::memcpy(nonce.data() + 4, &copy->generation, 8);
+        CipherEngine::Tag tag;
+        std::memcpy(tag.data(), copy->tag, tag.size());
+        if (cipher_->open(nonce, aad, copy->sealed, plain, tag) && decode(plain, record)) {
+            generation = copy->generation;
+            secure_wipe(plain, sizeof(plain));
+            return true;
+        }
+    }
+    secure_wipe(plain, sizeof(plain));
+    return false;
+}
+
+// Overwrites the copy that does not hold `handle`'s record. The new
+// generation is above both copies', so a nonce (slot || generation) is
+// never reused, not even after a torn write.
+void SessionStore::write(const Record& record, Handle& handle) {
+    const uint32_t slot = handle.slot;
+    auto* copies = reinterpret_cast<RecordCopy*>(slots_ + static_cast<size_t>(slot) * SLOT_SIZE);
+    size_t target = copies[1].generation < copies[0].generation ? 1 : 0;
+    if (handle.generation != 0 && copies[0].generation == handle.generation) target = 1;
+    if (handle.generation != 0 && copies[1].generation == handle.generation) target = 0;
+    const uint64_t generation = std::max(copies[0].generation, copies[1].generation) + 1;
+    RecordCopy* copy = &copies[target];
+
+    uint8_t aad[20];
+    std::memcpy(aad, file_id_.data(), 16);
+    std::memcpy(aad + 16, &slot, 4);
+    CipherEngine::Nonce nonce;
+    std::memcpy(nonce.data(), &slot, 4);
+    std::memcpy(nonce.data() + 4, &generation, 8);
+    uint8_t plain[PLAINTEXT_SIZE];
+    encode(record, plain);
+    CipherEngine::Tag tag;
+    // Generation first: a copy killed mid-write fails authentication and
+    // still counts for the next generation.
+    copy->generation = generation;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    cipher_->seal(nonce, aad, plain, copy->sealed, tag);
+    std::memcpy(copy->tag, tag.data(), tag.size());
+    secure_wipe(plain, sizeof(plain));
+    handle.generation = generation;
+}
+
+std::optional<SessionStore::Record> SessionStore::load(std::string_view peer_id, Handle& handle) {
+    const uint64_t tag = index_tag(peer_id);
+    Record record;
+    uint64_t generation = 0;
+    uint32_t slot;
+    {
+        std::lock_guard<std::mutex> lock(index_mutex_);
+        slot = find(peer_id, tag, false, &record, &generation);
+    }
+    if (slot == NO_SLOT) return std::nullopt;
+    handle = {slot, generation};
+    return record;
+}
+
+bool SessionStore::contains(std::string_view peer_id) {
+    const uint64_t tag = index_tag(peer_id);
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    return find(peer_id, tag, false) != NO_SLOT;
+}
+
+bool SessionStore::save(const Record& record, Handle& handle) {
+    if (record.peer_id.size() > MAX_PEER_ID) return false;
+    if (handle.slot != NO_SLOT) {
+        write(record, handle);
+        return true;
+    }
+
+    const uint64_t tag = index_tag(record.peer_id);
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    uint64_t generation = 0;
+    const uint32_t slot = find(record.peer_id, tag, true, nullptr, &generation);
+    if (slot == NO_SLOT) {
+        std::cout << "[!] Session store full (" << header_->used << " slots used)" << std::endl;
+        return false;
+    }
+    if (tags_[slot] == tag) {
+        handle = {slot, generation};
+        write(record, handle);
+        return true;
+    }
+
+    // Record first, then the tag: a crash in between leaves the slot free.
+    handle = {slot, 0};
+    write(record, handle);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    if (tags_[slot] == FREE) ++header_->used;
+    tags_[slot] = tag;
+    return true;
+}
+
+bool SessionStore::erase(std::string_view peer_id) {
+    const uint64_t tag = index_tag(peer_id);
+    std::lock_guard<std::mutex> lock(index_mutex_);
+    const uint32_t slot = find(peer_id, tag, false);
+    if (slot == NO_SLOT) return false;
+    tags_[slot] = ERASED;
+    // Keeps the generations: the slot's next session continues them.
+    auto* copies = reinterpret_cast<RecordCopy*>(slots_ + static_cast<size_t>(slot) * SLOT_SIZE);
+    for (int i = 0; i < 2; ++i) {
+        secure_wipe(copies[i].sealed, sizeof(copies[i].sealed));
+        secure_wipe(copies[i].tag, sizeof(copies[i].tag));
+    }
+    return true;
+}
+
+bool SessionStore::log_counters(size_t segment, const Handle& handle, uint64_t sending_counter,
+                                uint64_t receiving_counter) {
+    Segment& seg = segments_[segment];
+    if (seg.tail == segment_entries_) return false;
+    WalEntry entry{handle.slot, 0, handle.generation, sending_counter, receiving_counter};
+    entry.check = entry_check(entry, *log_mac_);
+    std::memcpy(wal_ + (segment * segment_entries_ + seg.tail++) * sizeof(WalEntry), &entry, sizeof(entry));
+    return true;
+}
+
+void SessionStore::reset_segment(size_t segment) {
+    Segment& seg = segments_[segment];
+    std::memset(wal_ + segment * segment_entries_ * sizeof(WalEntry), 0, seg.tail * sizeof(WalEntry));
+    seg.tail = 0;
+}
+
+// Folds the log left by the previous run into the records it names, then
+// clears it. Only those records are read; a segment ends at its first
+// empty, torn or forged entry. A record is left at its checkpoint when the
+// log would move a counter further than its entries can account for.
+void SessionStore::replay_log() {
+    struct Counters {
+        uint64_t generation, sending, receiving, entries;
+    };
+    std::unordered_map<uint32_t, Counters> latest;
+    for (size_t s = 0; s < segments_.size(); ++s) {
+        const auto* entries = reinterpret_cast<const WalEntry*>(wal_) + s * segment_entries_;
+        size_t n = 0;
+        for (; n < segment_entries_ && entries[n].check != 0; ++n) {
+            const WalEntry& e = entries[n];
+            if (e.check != entry_check(e, *log_mac_) || e.slot > mask_) break;
+            Counters& c = latest[e.slot];
+            if (e.generation > c.generation) c = {e.generation, 0, 0, 0};
+            if (e.generation == c.generation) {
+                c.sending = std::max(c.sending, e.sending);
+                c.receiving = std::max(c.receiving, e.receiving);
+                ++c.entries;
+            }
+        }
+        segments_[s].tail = n;
+    }
+
+    for (const auto& [slot, c] : latest) {
+        if (tags_[slot] == FREE || tags_[slot] == ERASED) continue;
+        Record record;
+        uint64_t generation;
+        if (!read(slot, record, generation) || generation != c.generation) continue;
+        const uint64_t reach = c.entries * MAX_STEPS_PER_ENTRY;
+        if (c.sending - std::min(c.sending, record.state.sending_ratchet_counter) > reach ||
+            c.receiving - std::min(c.receiving, record.state.receiving_ratchet_counter) > reach) {
+            secure_wipe(&record.state, sizeof(record.state));
+            continue;
+        }
+        advance(record.state.sending_chain_key, record.state.sending_ratchet_counter, c.sending);
+        advance(record.state.receiving_chain_key, record.state.receiving_ratchet_counter, c.receiving);
+        Handle handle{slot, generation};
+        write(record, handle);
+        secure_wipe(&record.state, sizeof(record.state));
+        ++replayed_;
+    }
+    for (size_t s = 0; s < segments_.size(); ++s) {
+        // Torn tails are cleared as well.
+        segments_[s].tail = std::min(segments_[s].tail + 1, segment_entries_);
+        reset_segment(s);
+    }
+}
+
+void SessionStore::sync() {
+    ::msync(map_, map_size_, MS_SYNC);
+    ::msync(wal_, wal_size_, MS_SYNC);
+}
+
+} // namespace Crypto
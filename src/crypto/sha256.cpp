@@ -0,0 +1,84 @@
+#include "sha256.h"
+#include "kernel_table.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Crypto {
+
+Sha256::Sha256() {
+    reset();
+}
+
+void Sha256::reset() {
+    std::memcpy(state_, sha256::INITIAL_STATE, sizeof(state_));
+    buffered_ = 0;
+    total_ = 0;
+}
+
+Sha256& Sha256::update(std::span<const uint8_t> data) {
+    const sha256::CompressFn compress = kernel_table().sha256_compress;
+    const uint8_t* p = data.data();
+    size_t len = data.size();
+    total_ += len;
+
+    if (buffered_ > 0) {
+        const size_t take = std::min(len, BLOCK_SIZE - buffered_);
+        std::memcpy(buffer_ + buffered_, p, take);
+        buffered_ += take;
+        p += take;
+        len -= take;
+        if (buffered_ < BLOCK_SIZE) return *this;
+        compress(state_, buffer_, 1);
+        buffered_ = 0;
+    }
+
+    const size_t whole = len / BLOCK_SIZE;
+    if (whole > 0) {
+        compress(state_, p, whole);
+        p += whole * BLOCK_SIZE;
+        len -= whole * BLOCK_SIZE;
+    }
+    std::memcpy(buffer_, p, len);
+    buffered_ = len;
+    return *this;
+}
+
+Sha256::Digest Sha256::finish() {
+    const uint64_t bits = total_ * 8;
+    uint8_t tail[2 * BLOCK_SIZE] = {};
+    std::memcpy(tail, buffer_, buffered_);
+    tail[buffered_] = 0x80;
+    const size_t tail_len = buffered_ + 9 <= BLOCK_SIZE ? BLOCK_SIZE : 2 * BLOCK_SIZE;
+    for (int i = 0; i < 8; ++i) tail[tail_len - 1 - i] = static_cast<uint8_t>(bits >> (8 * i));
+    kernel_table().sha256_compress(state_, tail, tail_len / BLOCK_SIZE);
+
+    Digest digest;
+    for (int i = 0; i < 8; ++i) {
+        for (int j = 0; j < 4; ++j) digest[4 * i + j] = static_cast<uint8_t>(state_[i] >> (24 - 8 * j));
+    }
+    reset();
+    return digest;
+}
+
+Sha256::Digest Sha256::hash(std::span<const uint8_t> data) {
+    Sha256 ctx;
+    ctx.update(data);
+    return ctx.finish();
+}
+
+std::string Sha256::hex(const Digest& digest) {
+    static const char* digits = "0123456789abcdef";
+    std::string out(2 * DIGEST_SIZE, '0');
+    for (size_t i = 0; i < DIGEST_SIZE; ++i) {
+        out[2 * i] = digits[digest[i] >> 4];
+        out[2 * i + 1] = digits[digest[i] & 0x0F];
+    }
+    return out;
+}
+
+const char* Sha256::backend_name() {
+    return kernel_table().sha256_name;
+}
+
+} // namespace Crypto
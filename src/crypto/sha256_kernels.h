@@ -0,0 +1,29 @@
+#ifndef SHA256_KERNELS_H
+#define SHA256_KERNELS_H
+
+// Internal interface between Sha256 and its compression backends.
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Crypto {
+namespace sha256 {
+
+constexpr uint32_t INITIAL_STATE[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+
+extern const uint32_t K[64];
+
+// Absorbs `count` whole 64-byte blocks into `state`.
+using CompressFn = void (*)(uint32_t state[8], const uint8_t* blocks, size_t count);
+
+void compress_portable(uint32_t state[8], const uint8_t* blocks, size_t count);
+
+// Available when compiled for x86-64; callers must check CPU support first.
+void compress_shani(uint32_t state[8], const uint8_t* blocks, size_t count);
+
+} // namespace sha256
+} // namespace Crypto
+
+#endif // SHA256_KERNELS_H
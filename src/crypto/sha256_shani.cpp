@@ -0,0 +1,75 @@
+#include "sha256_kernels.h"
+
+// SHA-256 compression with the SHA extensions: SHA256RNDS2 does two rounds
+// per instruction on the state held as ABEF/CDGH, SHA256MSG1/MSG2 extend the
+// message schedule four words at a time. Built with -msha -msse4.1 -mssse3;
+// only reached after the kernel registry has confirmed CPU support.
+
+#if defined(__x86_64__) || defined(_M_X64)
+
+#include <immintrin.h>
+
+namespace Crypto {
+namespace sha256 {
+
+namespace {
+
+// Four rounds on message words `msg` (already byte-swapped) with K[4i..4i+3].
+inline void rounds4(__m128i& abef, __m128i& cdgh, __m128i msg, int i) {
+    __m128i wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(K + 4 * i)));
+    cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+    wk = _mm_shuffle_epi32(wk, 0x0E);
+    abef = _mm_sha256rnds2_epu32(abef, cdgh, wk);
+}
+
+// W[i..i+3] from the four previous groups: m0 = W[i-16..], m3 = W[i-4..].
+inline __m128i schedule(__m128i m0, __m128i m1, __m128i m2, __m128i m3) {
+    __m128i t = _mm_sha256msg1_epu32(m0, m1);
+    t = _mm_add_epi32(t, _mm_alignr_epi8(m3, m2, 4));
+    return _mm_sha256msg2_epu32(t, m3);
+}
+
+} // namespace
+
+void compress_shani(uint32_t state[8], const uint8_t* blocks, size_t count) {
+    const __m128i bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // state is A..H; the instructions want ABEF and CDGH (high to low).
+    __m128i t = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));         // D C B A
+    __m128i cdgh = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));  // H G F E
+    t = _mm_shuffle_epi32(t, 0xB1);                                                // C D A B
+    cdgh = _mm_shuffle_epi32(cdgh, 0x1B);                                          // E F G H
+    __m128i abef = _mm_alignr_epi8(t, cdgh, 8);                                    // A B E F
+    cdgh = _mm_blend_epi16(cdgh, t, 0xF0);                                         // C D G H
+
+    for (; count > 0; --count, blocks += 64) {
+        const __m128i abef_saved = abef;
+        const __m128i cdgh_saved = cdgh;
+
+        __m128i m[4];
+        for (int i = 0; i < 4; ++i) {
+            m[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), bswap);
+            rounds4(abef, cdgh, m[i], i);
+        }
+        for (int i = 4; i < 16; ++i) {
+            const __m128i next = schedule(m[i & 3], m[(i + 1) & 3], m[(i + 2) & 3], m[(i + 3) & 3]);
+            m[i & 3] = next;
+            rounds4(abef, cdgh, next, i);
+        }
+
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    t = _mm_shuffle_epi32(abef, 0x1B);                                             // F E B A
+    cdgh = _mm_shuffle_epi32(cdgh, 0xB1);                                          // D C H G
+    abef = _mm_blend_epi16(t, cdgh, 0xF0);                                         // D C B A
+    cdgh = _mm_alignr_epi8(cdgh, t, 8);                                            // H G F E
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), abef);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), cdgh);
+}
+
+} // namespace sha256
+} // namespace Crypto
+
+#endif
@@ -0,0 +1,149 @@
+#include "skipped_key_store.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Crypto {
+
+namespace {
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+} // namespace
+
+SkippedKeyStore::SkippedKeyStore(const Limits& limits) : limits_(limits) {
+    limits_.capacity = std::max<size_t>(limits_.capacity, 1);
+    entries_.resize(limits_.capacity);
+    for (size_t i = 0; i < entries_.size(); ++i) {
+        entries_[i].newer = i + 1 < entries_.size() ? static_cast<uint32_t>(i + 1) : NONE;
+    }
+    free_ = 0;
+
+    // At most half full, so probe sequences stay short.
+    size_t table = 1;
+    while (table < 2 * limits_.capacity) table <<= 1;
+    slots_.assign(table, NONE);
+    mask_ = table - 1;
+}
+
+SkippedKeyStore::~SkippedKeyStore() {
+    clear();
+}
+
+uint32_t SkippedKeyStore::hash_of(const RatchetId& ratchet, uint64_t message_number) {
+    // The fingerprint is already uniform; mix in the message number.
+    uint64_t id;
+    std::memcpy(&id, ratchet.data(), sizeof(id));
+    const uint64_t h = (id ^ message_number) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<uint32_t>(h >> 32);
+}
+
+size_t SkippedKeyStore::find_slot(const RatchetId& ratchet, uint64_t message_number, uint32_t hash) const {
+    for (size_t slot = hash & mask_;; slot = (slot + 1) & mask_) {
+        const uint32_t e = slots_[slot];
+        if (e == NONE) return slot;
+        const Entry& entry = entries_[e];
+        if (entry.hash == hash && entry.message_number == message_number && entry.ratchet == ratchet) return slot;
+    }
+}
+
+void SkippedKeyStore::unlink(uint32_t e) {
+    Entry& entry = entries_[e];
+    if (entry.older != NONE) entries_[entry.older].newer = entry.newer; else oldest_ = entry.newer;
+    if (entry.newer != NONE) entries_[entry.newer].older = entry.older; else newest_ = entry.older;
+}
+
+// Frees the entry in `slot`, then shifts later members of its probe run
+// back so that lookups never stop at a hole (no tombstones).
+void SkippedKeyStore::erase_slot(size_t slot) {
+    const uint32_t e = slots_[slot];
+    secure_wipe(entries_[e].key.data(), entries_[e].key.size());
+    unlink(e);
+    entries_[e].newer = free_;
+    free_ = e;
+    --size_;
+
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask_; slots_[next] != NONE; next = (next + 1) & mask_) {
+        const size_t home = entries_[slots_[next]].hash & mask_;
+        // Move it unless its home lies cyclically in (hole, next].
+        const bool stays = hole <= next ? (home > hole && home <= next) : (home > hole || home <= next);
+        if (!stays) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+    slots_[hole] = NONE;
+}
+
+void SkippedKeyStore::insert(const RatchetId& ratchet, uint64_t message_number, const Key& key,
+                             Clock::time_point now) {
+    const uint32_t hash = hash_of(ratchet, message_number);
+    size_t slot = find_slot(ratchet, message_number, hash);
+    uint32_t e = slots_[slot];
+    if (e != NONE) {
+        unlink(e);
+    } else {
+        if (size_ == limits_.capacity) {
+            const Entry& oldest = entries_[oldest_];
+            erase_slot(find_slot(oldest.ratchet, oldest.message_number, oldest.hash));
+            slot = find_slot(ratchet, message_number, hash);
+        }
+        e = free_;
+        free_ = entries_[e].newer;
+        slots_[slot] = e;
+        ++size_;
+    }
+
+    Entry& entry = entries_[e];
+    entry.ratchet = ratchet;
+    entry.message_number = message_number;
+    entry.key = key;
+    entry.inserted = now;
+    entry.hash = hash;
+    entry.older = newest_;
+    entry.newer = NONE;
+    if (newest_ != NONE) entries_[newest_].newer = e; else oldest_ = e;
+    newest_ = e;
+}
+
+std::optional<SkippedKeyStore::Key> SkippedKeyStore::take(const RatchetId& ratchet, uint64_t message_number) {
+    const size_t slot = find_slot(ratchet, message_number, hash_of(ratchet, message_number));
+    if (slots_[slot] == NONE) {
+        return std::nullopt;
+    }
+    const Key key = entries_[slots_[slot]].key;
+    erase_slot(slot);
+    return key;
+}
+
+std::optional<SkippedKeyStore::Key> SkippedKeyStore::peek(const RatchetId& ratchet, uint64_t message_number) const {
+    const size_t slot = find_slot(ratchet, message_number, hash_of(ratchet, message_number));
+    if (slots_[slot] == NONE) {
+        return std::nullopt;
+    }
+    return entries_[slots_[slot]].key;
+}
+
+// Insertion order is age order, so expired keys sit at the old end.
+size_t SkippedKeyStore::evict_expired(Clock::time_point now) {
+    size_t evicted = 0;
+    while (oldest_ != NONE && now - entries_[oldest_].inserted > limits_.max_age) {
+        const Entry& oldest = entries_[oldest_];
+        erase_slot(find_slot(oldest.ratchet, oldest.message_number, oldest.hash));
+        ++evicted;
+    }
+    return evicted;
+}
+
+void SkippedKeyStore::clear() {
+    while (oldest_ != NONE) {
+        const Entry& oldest = entries_[oldest_];
+        erase_slot(find_slot(oldest.ratchet, oldest.message_number, oldest.hash));
+    }
+}
+
+} // namespace Crypto
@@ -0,0 +1,626 @@
+#include "slh_dsa.h"
+#include "keccak.h"
+#include "kernel_table.h"
+#include "thread_pool.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace Crypto {
+
+namespace {
+
+using Slh = SlhDsaShake256f;
+
+constexpr size_t N = Slh::N;
+constexpr int H = 68;           // hypertree height
+constexpr int D = 17;           // hypertree layers
+constexpr int HP = H / D;       // height of one XMSS tree
+constexpr int A = 9;            // FORS tree height
+constexpr int K = 35;           // FORS trees
+constexpr uint32_t WOTS_W = 16;
+constexpr int LEN1 = 64;
+constexpr int LEN = 67;         // len1 + len2 chains per WOTS+ key
+constexpr size_t MD_BYTES = 40; // ceil(k * a / 8)
+constexpr size_t DIGEST_BYTES = MD_BYTES + 8 + 1;
+constexpr int XMSS_LEAVES = 1 << HP;
+constexpr int FORS_LEAVES = 1 << A;
+constexpr int LEAVES_PER_JOB = 4;
+
+constexpr size_t FORS_SIG_BYTES = K * (A + 1) * N;
+constexpr size_t XMSS_SIG_BYTES = (LEN + HP) * N;
+static_assert(N + FORS_SIG_BYTES + D * XMSS_SIG_BYTES == Slh::SIGNATURE_SIZE);
+
+enum AdrsType : uint32_t {
+    WOTS_HASH = 0,
+    WOTS_PK = 1,
+    TREE = 2,
+    FORS_TREE = 3,
+    FORS_ROOTS = 4,
+    WOTS_PRF = 5,
+    FORS_PRF = 6,
+};
+
+// FIPS 205 address: layer, 96-bit tree, type, then three type-specific
+// words, all big-endian.
+struct Adrs {
+    uint8_t b[32] = {};
+
+    void set_word(size_t off, uint32_t v) {
+        b[off] = static_cast<uint8_t>(v >> 24);
+        b[off + 1] = static_cast<uint8_t>(v >> 16);
+        b[off + 2] = static_cast<uint8_t>(v >> 8);
+        b[off + 3] = static_cast<uint8_t>(v);
+    }
+    void set_layer(uint32_t layer) { set_word(0, layer); }
+    void set_tree(uint64_t tree) {
+        set_word(8, static_cast<uint32_t>(tree >> 32));
+        set_word(12, static_cast<uint32_t>(tree));
+    }
+    void set_type_and_clear(uint32_t type) {
+        set_word(16, type);
+        std::memset(b + 20, 0, 12);
+    }
+    void set_keypair(uint32_t i) { set_word(20, i); }
+    void set_chain(uint32_t i) { set_word(24, i); }
+    void set_tree_height(uint32_t z) { set_word(24, z); }
+    void set_hash(uint32_t i) { set_word(28, i); }
+    void set_tree_index(uint32_t i) { set_word(28, i); }
+};
+
+Adrs make_adrs(uint32_t layer, uint64_t tree, uint32_t type, uint32_t keypair = 0) {
+    Adrs a;
+    a.set_layer(layer);
+    a.set_tree(tree);
+    a.set_type_and_clear(type);
+    a.set_keypair(keypair);
+    return a;
+}
+
+inline uint64_t load64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void store64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+// One tweakable hash call: out = SHAKE256(PK.seed || adrs || in).
+struct HashJob {
+    Adrs adrs;
+    const uint8_t* in;
+    uint8_t* out;
+};
+
+// `steps` applications of F starting at hash address `start`, in place.
+struct ChainJob {
+    Adrs adrs;
+    uint8_t* value;
+    uint32_t start;
+    uint32_t steps;
+};
+
+// F, H, PRF and T_l over independent calls, LANES of them per Keccak
+// permutation. With n = 32 the prefix PK.seed || ADRS is exactly eight
+// words, so F and H inputs are placed straight into the state.
+template <class State>
+class Hasher {
+public:
+    static constexpr size_t LANES = std::extent_v<decltype(State::s), 1>;
+    static constexpr size_t RATE_WORDS = keccak::SHAKE256_RATE / 8;
+    using Permute = void (*)(State&);
+
+    Hasher(const uint8_t* pk_seed, const uint8_t* sk_seed, Permute permute)
+        : pk_seed_(pk_seed), sk_seed_(sk_seed), permute_(permute) {
+        for (int i = 0; i < 4; ++i) seed_words_[i] = load64(pk_seed + 8 * i);
+    }
+
+    const uint8_t* sk_seed() const { return sk_seed_; }
+
+    // Inputs of one (F, PRF) or two (H) n-byte blocks: one permutation.
+    void hash(const HashJob* jobs, size_t count, size_t blocks) const {
+        for (size_t first = 0; first < count; first += LANES) {
+            const size_t lanes = std::min(LANES, count - first);
+            State st;
+            std::memset(&st, 0, sizeof(st));
+            for (size_t j = 0; j < lanes; ++j) load_lane(st, j, jobs[first + j].adrs, jobs[first + j].in, blocks);
+            pad(st, 8 + 4 * blocks);
+            permute_(st);
+            for (size_t j = 0; j < lanes; ++j) store_lane(st, j, jobs[first + j].out);
+        }
+    }
+
+    // Chains sorted by length so that lanes of a group finish together.
+    void chains(ChainJob* jobs, size_t count) const {
+        std::sort(jobs, jobs + count, [](const ChainJob& a, const ChainJob& b) { return a.steps < b.steps; });
+        for (size_t first = 0; first < count; first += LANES) {
+            const size_t lanes = std::min(LANES, count - first);
+            const uint32_t rounds = jobs[first + lanes - 1].steps;
+            for (uint32_t t = 0; t < rounds; ++t) {
+                State st;
+                std::memset(&st, 0, sizeof(st));
+                for (size_t j = 0; j < lanes; ++j) {
+                    ChainJob& c = jobs[first + j];
+                    if (t >= c.steps) continue;
+                    c.adrs.set_hash(c.start + t);
+                    load_lane(st, j, c.adrs, c.value, 1);
+                }
+                pad(st, 12);
+                permute_(st);
+                for (size_t j = 0; j < lanes; ++j) {
+                    if (t < jobs[first + j].steps) store_lane(st, j, jobs[first + j].value);
+                }
+            }
+        }
+    }
+
+    // T_l: inputs of `len` bytes (a multiple of 8), any number of blocks.
+    void compress(const HashJob* jobs, size_t count, size_t len) const {
+        const size_t total = 64 + len;
+        std::vector<uint8_t> buf(LANES * total);
+        for (size_t first = 0; first < count; first += LANES) {
+            const size_t lanes = std::min(LANES, count - first);
+            for (size_t j = 0; j < lanes; ++j) {
+                uint8_t* b = buf.data() + j * total;
+                std::memcpy(b, pk_seed_, N);
+                std::memcpy(b + N, jobs[first + j].adrs.b, N);
+                std::memcpy(b + 2 * N, jobs[first + j].in, len);
+            }
+            State st;
+            std::memset(&st, 0, sizeof(st));
+            size_t off = 0;
+            for (; total - off >= keccak::SHAKE256_RATE; off += keccak::SHAKE256_RATE) {
+                for (size_t i = 0; i < RATE_WORDS; ++i) {
+                    for (size_t j = 0; j < lanes; ++j) st.s[i][j] ^= load64(buf.data() + j * total + off + 8 * i);
+                }
+                permute_(st);
+            }
+            for (size_t i = 0; off + 8 * i < total; ++i) {
+                for (size_t j = 0; j < lanes; ++j) st.s[i][j] ^= load64(buf.data() + j * total + off + 8 * i);
+            }
+            pad(st, (total - off) / 8);
+            permute_(st);
+            for (size_t j = 0; j < lanes; ++j) store_lane(st, j, jobs[first + j].out);
+        }
+        secure_wipe(buf.data(), buf.size());
+    }
+
+private:
+    void load_lane(State& st, size_t j, const Adrs& adrs, const uint8_t* in, size_t blocks) const {
+        for (int i = 0; i < 4; ++i) st.s[i][j] = seed_words_[i];
+        for (int i = 0; i < 4; ++i) st.s[4 + i][j] = load64(adrs.b + 8 * i);
+        for (size_t i = 0; i < 4 * blocks; ++i) st.s[8 + i][j] = load64(in + 8 * i);
+    }
+
+    static void store_lane(const State& st, size_t j, uint8_t* out) {
+        for (int i = 0; i < 4; ++i) store64(out + 8 * i, st.s[i][j]);
+    }
+
+    // SHAKE padding after `words` message words, in every lane.
+    static void pad(State& st, size_t words) {
+        for (size_t j = 0; j < LANES; ++j) {
+            st.s[words][j] ^= 0x1F;
+            st.s[RATE_WORDS - 1][j] ^= 0x80ULL << 56;
+        }
+    }
+
+    const uint8_t* pk_seed_;
+    const uint8_t* sk_seed_;
+    uint64_t seed_words_[4];
+    Permute permute_;
+};
+
+// base_2^b(X, b, out_len), most significant bits first.
+void base_2b(uint32_t* out, const uint8_t* in, int b, int out_len) {
+    uint32_t total = 0;
+    int bits = 0;
+    for (int i = 0; i < out_len; ++i) {
+        while (bits < b) {
+            total = (total << 8) | *in++;
+            bits += 8;
+        }
+        bits -= b;
+        out[i] = (total >> bits) & ((1u << b) - 1);
+    }
+}
+
+// Message digits of a WOTS+ signature: 64 nibbles and a 3-nibble checksum.
+void wots_digits(uint32_t digits[LEN], const uint8_t msg[N]) {
+    base_2b(digits, msg, 4, LEN1);
+    uint32_t csum = 0;
+    for (int i = 0; i < LEN1; ++i) csum += WOTS_W - 1 - digits[i];
+    csum <<= 4;
+    const uint8_t bytes[2] = {static_cast<uint8_t>(csum >> 8), static_cast<uint8_t>(csum)};
+    base_2b(digits + LEN1, bytes, 4, LEN - LEN1);
+}
+
+// WOTS+ public keys (XMSS leaves) [first, first + count) of one tree.
+template <class State>
+void wots_leaves(const Hasher<State>& hs, uint32_t layer, uint64_t tree, uint32_t first, uint32_t count,
+                 uint8_t* leaves) {
+    std::vector<uint8_t> values(count * LEN * N);
+    std::vector<HashJob> jobs(count * LEN);
+    std::vector<ChainJob> chains(count * LEN);
+    for (uint32_t l = 0; l < count; ++l) {
+        for (int c = 0; c < LEN; ++c) {
+            const size_t idx = l * LEN + c;
+            Adrs sk = make_adrs(layer, tree, WOTS_PRF, first + l);
+            sk.set_chain(c);
+            jobs[idx] = {sk, hs.sk_seed(), values.data() + idx * N};
+            Adrs chain = make_adrs(layer, tree, WOTS_HASH, first + l);
+            chain.set_chain(c);
+            chains[idx] = {chain, values.data() + idx * N, 0, WOTS_W - 1};
+        }
+    }
+    hs.hash(jobs.data(), jobs.size(), 1);
+    hs.chains(chains.data(), chains.size());
+    for (uint32_t l = 0; l < count; ++l) {
+        jobs[l] = {make_adrs(layer, tree, WOTS_PK, first + l), values.data() + l * LEN * N, leaves + l * N};
+    }
+    hs.compress(jobs.data(), count, LEN * N);
+    secure_wipe(values.data(), values.size());
+}
+
+// Builds one Merkle tree bottom-up from `leaves` (overwritten level by
+// level): the authentication path of `index` and the root.
+template <class State>
+void merkle_tree(const Hasher<State>& hs, Adrs adrs, uint32_t base_index, int height, uint8_t* leaves,
+                 uint32_t index, uint8_t* auth, uint8_t* root) {
+    std::vector<HashJob> jobs(1u << (height - 1));
+    std::vector<uint8_t> next((1u << (height - 1)) * N);
+    uint8_t* level = leaves;
+    for (int z = 1; z <= height; ++z) {
+        std::memcpy(auth + (z - 1) * N, level + (((index >> (z - 1)) ^ 1) * N), N);
+        const uint32_t count = 1u << (height - z);
+        for (uint32_t i = 0; i < count; ++i) {
+            adrs.set_tree_height(z);
+            adrs.set_tree_index((base_index >> z) + i);
+            jobs[i] = {adrs, level + 2 * i * N, next.data() + i * N};
+        }
+        hs.hash(jobs.data(), count, 2);
+        std::memcpy(leaves, next.data(), count * N);
+        level = leaves;
+    }
+    std::memcpy(root, level, N);
+}
+
+struct ForsTree {
+    uint8_t sk[N];
+    uint8_t auth[A * N];
+    uint8_t root[N];
+};
+
+// FORS tree t of the key pair selected by the digest: the revealed secret
+// for leaf `index`, its authentication path and the root.
+template <class State>
+void fors_tree(const Hasher<State>& hs, uint64_t tree, uint32_t keypair, uint32_t t, uint32_t index, ForsTree& out) {
+    std::vector<uint8_t> secrets(FORS_LEAVES * N);
+    std::vector<uint8_t> leaves(FORS_LEAVES * N);
+    std::vector<HashJob> jobs(FORS_LEAVES);
+    const uint32_t base = t * FORS_LEAVES;
+    for (uint32_t j = 0; j < FORS_LEAVES; ++j) {
+        Adrs sk = make_adrs(0, tree, FORS_PRF, keypair);
+        sk.set_tree_index(base + j);
+        jobs[j] = {sk, hs.sk_seed(), secrets.data() + j * N};
+    }
+    hs.hash(jobs.data(), FORS_LEAVES, 1);
+    for (uint32_t j = 0; j < FORS_LEAVES; ++j) {
+        Adrs leaf = make_adrs(0, tree, FORS_TREE, keypair);
+        leaf.set_tree_index(base + j);
+        jobs[j] = {leaf, secrets.data() + j * N, leaves.data() + j * N};
+    }
+    hs.hash(jobs.data(), FORS_LEAVES, 1);
+    std::memcpy(out.sk, secrets.data() + index * N, N);
+    merkle_tree(hs, make_adrs(0, tree, FORS_TREE, keypair), base, A, leaves.data(), index, out.auth, out.root);
+    secure_wipe(secrets.data(), secrets.size());
+}
+
+// WOTS+ signature of `msg` by key pair `keypair` of one XMSS tree.
+template <class State>
+void wots_sign(const Hasher<State>& hs, uint32_t layer, uint64_t tree, uint32_t keypair, const uint8_t msg[N],
+               uint8_t* sig) {
+    uint32_t digits[LEN];
+    wots_digits(digits, msg);
+    HashJob jobs[LEN];
+    ChainJob chains[LEN];
+    for (int c = 0; c < LEN; ++c) {
+        Adrs sk = make_adrs(layer, tree, WOTS_PRF, keypair);
+        sk.set_chain(c);
+        jobs[c] = {sk, hs.sk_seed(), sig + c * N};
+        Adrs chain = make_adrs(layer, tree, WOTS_HASH, keypair);
+        chain.set_chain(c);
+        chains[c] = {chain, sig + c * N, 0, digits[c]};
+    }
+    hs.hash(jobs, LEN, 1);
+    hs.chains(chains, LEN);
+}
+
+// Root of an XMSS tree from a WOTS+ signature and its authentication path.
+template <class State>
+void xmss_root_from_sig(const Hasher<State>& hs, uint32_t layer, uint64_t tree, uint32_t keypair,
+                        const uint8_t* sig, const uint8_t msg[N], uint8_t root[N]) {
+    uint32_t digits[LEN];
+    wots_digits(digits, msg);
+    uint8_t values[LEN * N];
+    std::memcpy(values, sig, sizeof(values));
+    ChainJob chains[LEN];
+    for (int c = 0; c < LEN; ++c) {
+        Adrs chain = make_adrs(layer, tree, WOTS_HASH, keypair);
+        chain.set_chain(c);
+        chains[c] = {chain, values + c * N, digits[c], WOTS_W - 1 - digits[c]};
+    }
+    hs.chains(chains, LEN);
+
+    uint8_t node[2 * N];
+    const HashJob pk = {make_adrs(layer, tree, WOTS_PK, keypair), values, node};
+    hs.compress(&pk, 1, LEN * N);
+
+    const uint8_t* auth = sig + LEN * N;
+    Adrs adrs = make_adrs(layer, tree, TREE);
+    for (int z = 0; z < HP; ++z) {
+        const bool right = (keypair >> z) & 1;
+        if (right) {
+            std::memmove(node + N, node, N);
+            std::memcpy(node, auth + z * N, N);
+        } else {
+            std::memcpy(node + N, auth + z * N, N);
+        }
+        adrs.set_tree_height(z + 1);
+        adrs.set_tree_index(keypair >> (z + 1));
+        const HashJob job = {adrs, node, node};
+        hs.hash(&job, 1, 2);
+    }
+    std::memcpy(root, node, N);
+}
+
+// Address of the XMSS tree and leaf used at each hypertree layer.
+void hypertree_path(uint64_t tree, uint32_t leaf, uint64_t trees[D], uint32_t leaves[D]) {
+    for (int j = 0; j < D; ++j) {
+        trees[j] = tree;
+        leaves[j] = leaf;
+        leaf = static_cast<uint32_t>(tree & (XMSS_LEAVES - 1));
+        tree >>= HP;
+    }
+}
+
+// md || idx_tree || idx_leaf = H_msg(R, PK.seed, PK.root, M').
+void message_digest(uint8_t digest[DIGEST_BYTES], const uint8_t r[N], const uint8_t* pk,
+                    std::span<const uint8_t> context, std::span<const uint8_t> message, uint64_t& tree,
+                    uint32_t& leaf) {
+    const uint8_t prefix[2] = {0, static_cast<uint8_t>(context.size())};
+    keccak::Sponge h(keccak::SHAKE256_RATE, 0x1F);
+    h.absorb(r, N);
+    h.absorb(pk, Slh::PUBLIC_KEY_SIZE);
+    h.absorb(prefix, sizeof(prefix));
+    h.absorb(context.data(), context.size());
+    h.absorb(message.data(), message.size());
+    h.squeeze(digest, DIGEST_BYTES);
+    tree = 0;
+    for (int i = 0; i < 8; ++i) tree = (tree << 8) | digest[MD_BYTES + i];
+    leaf = digest[MD_BYTES + 8] & (XMSS_LEAVES - 1);
+}
+
+// Runs fn with the widest Keccak the kernel registry bound.
+template <class Fn>
+void with_hasher(const uint8_t* pk_seed, const uint8_t* sk_seed, Fn&& fn) {
+    const KernelTable& k = kernel_table();
+    if (k.keccak_x8 != nullptr) {
+        fn(Hasher<keccak::X8State>(pk_seed, sk_seed, k.keccak_x8));
+    } else {
+        fn(Hasher<keccak::X4State>(pk_seed, sk_seed, k.keccak_x4));
+    }
+}
+
+template <class State>
+void xmss_root(const Hasher<State>& hs, uint32_t layer, uint64_t tree, uint8_t root[N]) {
+    uint8_t leaves[XMSS_LEAVES * N];
+    uint8_t auth[HP * N];
+    ThreadPool::shared().parallel_for(XMSS_LEAVES / LEAVES_PER_JOB, [&](size_t part) {
+        const uint32_t first = static_cast<uint32_t>(part * LEAVES_PER_JOB);
+        wots_leaves(hs, layer, tree, first, LEAVES_PER_JOB, leaves + first * N);
+    });
+    merkle_tree(hs, make_adrs(layer, tree, TREE), 0, HP, leaves, 0, auth, root);
+}
+
+template <class State>
+void sign_internal(const Hasher<State>& hs, const uint8_t* sk, std::span<const uint8_t> context,
+                   std::span<const uint8_t> message, const uint8_t opt_rand[N], uint8_t* sig) {
+    const uint8_t* sk_prf = sk + N;
+    const uint8_t* pk = sk + 2 * N;
+
+    // R = PRF_msg(SK.prf, opt_rand, M')
+    const uint8_t prefix[2] = {0, static_cast<uint8_t>(context.size())};
+    keccak::Sponge prf(keccak::SHAKE256_RATE, 0x1F);
+    prf.absorb(sk_prf, N);
+    prf.absorb(opt_rand, N);
+    prf.absorb(prefix, sizeof(prefix));
+    prf.absorb(context.data(), context.size());
+    prf.absorb(message.data(), message.size());
+    prf.squeeze(sig, N);
+
+    uint8_t digest[DIGEST_BYTES];
+    uint64_t tree;
+    uint32_t leaf;
+    message_digest(digest, sig, pk, context, message, tree, leaf);
+    uint32_t indices[K];
+    base_2b(indices, digest, A, K);
+
+    uint64_t trees[D];
+    uint32_t leaves[D];
+    hypertree_path(tree, leaf, trees, leaves);
+
+    // Every XMSS subtree and FORS tree is independent of the others; only
+    // the WOTS+ signatures chain the layers together. Subtrees first: they
+    // are the larger jobs.
+    std::vector<uint8_t> xmss_leaves(D * XMSS_LEAVES * N);
+    std::vector<ForsTree> fors(K);
+    constexpr size_t XMSS_JOBS = D * (XMSS_LEAVES / LEAVES_PER_JOB);
+    ThreadPool::shared().parallel_for(XMSS_JOBS + K, [&](size_t job) {
+        if (job < XMSS_JOBS) {
+            const int layer = static_cast<int>(job / (XMSS_LEAVES / LEAVES_PER_JOB));
+            const uint32_t first = static_cast<uint32_t>(job % (XMSS_LEAVES / LEAVES_PER_JOB)) * LEAVES_PER_JOB;
+            wots_leaves(hs, layer, trees[layer], first, LEAVES_PER_JOB,
+                        xmss_leaves.data() + (layer * XMSS_LEAVES + first) * N);
+        } else {
+            const uint32_t t = static_cast<uint32_t>(job - XMSS_JOBS);
+            fors_tree(hs, tree, leaf, t, indices[t], fors[t]);
+        }
+    });
+
+    uint8_t* out = sig + N;
+    uint8_t roots[K * N];
+    for (int t = 0; t < K; ++t) {
+        std::memcpy(out, fors[t].sk, N);
+        std::memcpy(out + N, fors[t].auth, A * N);
+        std::memcpy(roots + t * N, fors[t].root, N);
+        out += (A + 1) * N;
+    }
+    secure_wipe(fors.data(), fors.size() * sizeof(ForsTree));
+
+    // Messages signed at each layer: PK_fors, then the root below.
+    uint8_t messages[D][N];
+    const HashJob fors_pk = {make_adrs(0, tree, FORS_ROOTS, leaf), roots, messages[0]};
+    hs.compress(&fors_pk, 1, K * N);
+    for (int j = 0; j < D; ++j) {
+        uint8_t* layer_sig = out + j * XMSS_SIG_BYTES;
+        uint8_t root[N];
+        merkle_tree(hs, make_adrs(j, trees[j], TREE), 0, HP, xmss_leaves.data() + j * XMSS_LEAVES * N, leaves[j],
+                    layer_sig + LEN * N, root);
+        if (j + 1 < D) std::memcpy(messages[j + 1], root, N);
+    }
+    ThreadPool::shared().parallel_for(D, [&](size_t j) {
+        wots_sign(hs, static_cast<uint32_t>(j), trees[j], leaves[j], messages[j], out + j * XMSS_SIG_BYTES);
+    });
+}
+
+template <class State>
+bool verify_internal(const Hasher<State>& hs, const uint8_t* pk, std::span<const uint8_t> context,
+                     std::span<const uint8_t> message, const uint8_t* sig) {
+    uint8_t digest[DIGEST_BYTES];
+    uint64_t tree;
+    uint32_t leaf;
+    message_digest(digest, sig, pk, context, message, tree, leaf);
+    uint32_t indices[K];
+    base_2b(indices, digest, A, K);
+
+    // FORS: all K trees climb together, one hash per tree and level.
+    const uint8_t* fors_sig = sig + N;
+    uint8_t nodes[K][2 * N];
+    uint32_t positions[K];
+    HashJob jobs[K];
+    for (int t = 0; t < K; ++t) {
+        positions[t] = t * FORS_LEAVES + indices[t];
+        Adrs adrs = make_adrs(0, tree, FORS_TREE, leaf);
+        adrs.set_tree_index(positions[t]);
+        jobs[t] = {adrs, fors_sig + t * (A + 1) * N, nodes[t]};
+    }
+    hs.hash(jobs, K, 1);
+    for (int z = 0; z < A; ++z) {
+        for (int t = 0; t < K; ++t) {
+            const uint8_t* auth = fors_sig + t * (A + 1) * N + (z + 1) * N;
+            if (positions[t] & 1) {
+                std::memmove(nodes[t] + N, nodes[t], N);
+                std::memcpy(nodes[t], auth, N);
+            } else {
+                std::memcpy(nodes[t] + N, auth, N);
+            }
+            positions[t] >>= 1;
+            jobs[t].adrs.set_tree_height(z + 1);
+            jobs[t].adrs.set_tree_index(positions[t]);
+            jobs[t].in = nodes[t];
+        }
+        hs.hash(jobs, K, 2);
+    }
+    uint8_t roots[K * N];
+    for (int t = 0; t < K; ++t) std::memcpy(roots + t * N, nodes[t], N);
+
+    uint8_t node[N];
+    const HashJob fors_pk = {make_adrs(0, tree, FORS_ROOTS, leaf), roots, node};
+    hs.compress(&fors_pk, 1, K * N);
+
+    uint64_t trees[D];
+    uint32_t leaves[D];
+    hypertree_path(tree, leaf, trees, leaves);
+    const uint8_t* ht_sig = fors_sig + FORS_SIG_BYTES;
+    for (int j = 0; j < D; ++j) {
+        xmss_root_from_sig(hs, j, trees[j], leaves[j], ht_sig + j * XMSS_SIG_BYTES, node, node);
+    }
+    return std::memcmp(node, pk + N, N) == 0;
+}
+
+} // namespace
+
+SlhDsaShake256f::KeyPair SlhDsaShake256f::generate_keypair() {
+    Seed sk_seed, sk_prf, pk_seed;
+    SecureRandom::fill(sk_seed);
+    SecureRandom::fill(sk_prf);
+    SecureRandom::fill(pk_seed);
+    KeyPair kp = generate_keypair(sk_seed, sk_prf, pk_seed);
+    secure_wipe(sk_seed.data(), sk_seed.size());
+    secure_wipe(sk_prf.data(), sk_prf.size());
+    return kp;
+}
+
+// pk = PK.seed || PK.root, sk = SK.seed || SK.prf || pk
+SlhDsaShake256f::KeyPair SlhDsaShake256f::generate_keypair(const Seed& sk_seed, const Seed& sk_prf,
+                                                           const Seed& pk_seed) {
+    KeyPair kp;
+    std::memcpy(kp.public_key.data(), pk_seed.data(), N);
+    with_hasher(pk_seed.data(), sk_seed.data(),
+                [&](const auto& hs) { xmss_root(hs, D - 1, 0, kp.public_key.data() + N); });
+    std::memcpy(kp.secret_key.data(), sk_seed.data(), N);
+    std::memcpy(kp.secret_key.data() + N, sk_prf.data(), N);
+    std::memcpy(kp.secret_key.data() + 2 * N, kp.public_key.data(), PUBLIC_KEY_SIZE);
+    return kp;
+}
+
+std::optional<SlhDsaShake256f::Signature> SlhDsaShake256f::sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                                std::span<const uint8_t> message,
+                                                                std::span<const uint8_t> context) {
+    Seed opt_rand;
+    SecureRandom::fill(opt_rand);
+    return sign(secret_key, message, context, opt_rand);
+}
+
+std::optional<SlhDsaShake256f::Signature> SlhDsaShake256f::sign(std::span<const uint8_t, SECRET_KEY_SIZE> secret_key,
+                                                                std::span<const uint8_t> message,
+                                                                std::span<const uint8_t> context,
+                                                                const Seed& opt_rand) {
+    if (context.size() > MAX_CONTEXT_SIZE) {
+        return std::nullopt;
+    }
+    Signature sig;
+    const uint8_t* sk = secret_key.data();
+    with_hasher(sk + 2 * N, sk, [&](const auto& hs) {
+        sign_internal(hs, sk, context, message, opt_rand.data(), sig.data());
+    });
+    return sig;
+}
+
+bool SlhDsaShake256f::verify(std::span<const uint8_t, PUBLIC_KEY_SIZE> public_key, std::span<const uint8_t> message,
+                             std::span<const uint8_t, SIGNATURE_SIZE> signature, std::span<const uint8_t> context) {
+    if (context.size() > MAX_CONTEXT_SIZE) {
+        return false;
+    }
+    bool ok = false;
+    with_hasher(public_key.data(), nullptr, [&](const auto& hs) {
+        ok = verify_internal(hs, public_key.data(), context, message, signature.data());
+    });
+    return ok;
+}
+
+const char* SlhDsaShake256f::backend_name() {
+    return kernel_table().keccak_name;
+}
+
+} // namespace Crypto
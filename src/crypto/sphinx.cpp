@@ -0,0 +1,217 @@
+#include "sphinx.h"
+#include "hmac_sha256.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+namespace Crypto {
+
+namespace {
+
+// Where a layer sits in the packet and how wide its slots are.
+struct Layout {
+    size_t start;                               // nonce, then tag, then beta
+    size_t slot;
+    size_t routing;                             // routing bytes at the head of a slot
+
+    size_t beta() const { return start + Sphinx::NONCE_SIZE + Sphinx::TAG_SIZE; }
+    size_t beta_size() const { return slot * Sphinx::MAX_HOPS; }
+    size_t region_size() const { return Sphinx::PACKET_SIZE - beta(); }
+};
+
+constexpr Layout CELL{0, Sphinx::CELL_SLOT, 0};
+constexpr Layout SETUP{X25519::KEY_SIZE, Sphinx::SETUP_SLOT, 4};
+
+constexpr uint8_t SALT[] = {'s', 'p', 'h', 'i', 'n', 'x'};
+
+// Everything a hop derives from its shared secret, bound to its alpha.
+struct HopSecrets {
+    Sphinx::Key header;
+    Sphinx::Key forward;
+    X25519::Key blind;
+    uint8_t replay[16];
+};
+
+HopSecrets derive(const X25519::Key& secret, std::span<const uint8_t, X25519::KEY_SIZE> alpha) {
+    uint8_t okm[32 * 3 + 16];
+    HmacSha256::hkdf(SALT, secret, alpha, okm);
+    HopSecrets out;
+    std::memcpy(out.header.data(), okm, 32);
+    std::memcpy(out.forward.data(), okm + 32, 32);
+    std::memcpy(out.blind.data(), okm + 64, 32);
+    std::memcpy(out.replay, okm + 96, 16);
+    std::fill(std::begin(okm), std::end(okm), uint8_t{0});
+    return out;
+}
+
+// The sender's side of a layered packet: `keys`, `nonces` and `routing`
+// per hop (routing: layout.routing bytes each), `body` as the last hop
+// reads it. Writes the first hop's nonce, tag and region.
+void wrap(const Layout& layout, std::span<const Sphinx::Key> keys, std::span<const ChaCha20Poly1305::Nonce> nonces,
+          std::span<const uint8_t> routing, std::span<const uint8_t> body, Sphinx::Packet& packet) {
+    const size_t n = keys.size();
+    const size_t slot = layout.slot, beta = layout.beta_size(), size = layout.region_size();
+    std::vector<std::unique_ptr<ChaCha20Poly1305>> aead;
+    aead.reserve(n);
+    for (const auto& key : keys) aead.push_back(std::make_unique<ChaCha20Poly1305>(key));
+
+    // What the zero slots appended by hops 0..n-2 look like at the last
+    // hop: each hop XORs its keystream over those already there.
+    std::vector<uint8_t> filler, stream(beta, 0);
+    ChaCha20Poly1305::Tag ignored;
+    for (size_t i = 0; i + 1 < n; ++i) {
+        std::fill(stream.begin(), stream.end(), uint8_t{0});
+        aead[i]->seal(nonces[i], {}, stream, stream, ignored);
+        const size_t offset = beta - filler.size();
+        for (size_t j = 0; j < filler.size(); ++j) filler[j] ^= stream[offset + j];
+        filler.resize(filler.size() + slot, 0);
+    }
+
+    // Last hop: its routing slot, then plaintext chosen so that the tail
+    // of beta encrypts to the filler.
+    std::vector<uint8_t> plain(size, 0), sealed(size);
+    if (layout.routing > 0) std::memcpy(plain.data(), routing.data() + (n - 1) * layout.routing, layout.routing);
+    if (!filler.empty()) {
+        std::fill(stream.begin(), stream.end(), uint8_t{0});
+        aead[n - 1]->seal(nonces[n - 1], {}, stream, stream, ignored);
+        const size_t offset = beta - filler.size();
+        for (size_t j = 0; j < filler.size(); ++j) plain[offset + j] = filler[j] ^ stream[offset + j];
+    }
+    if (!body.empty()) std::memcpy(plain.data() + beta, body.data(), std::min(body.size(), size - beta));
+    ChaCha20Poly1305::Tag tag;
+    aead[n - 1]->seal(nonces[n - 1], {}, plain, sealed, tag);
+
+    // Inwards: hop i's plaintext is its routing slot (next nonce and tag
+    // included) then hop i+1's beta minus its zero slot, then the body.
+    for (size_t i = n - 1; i-- > 0;) {
+        uint8_t* p = plain.data();
+        if (layout.routing > 0) std::memcpy(p, routing.data() + i * layout.routing, layout.routing);
+        std::memcpy(p + layout.routing, nonces[i + 1].data(), Sphinx::NONCE_SIZE);
+        std::memcpy(p + layout.routing + Sphinx::NONCE_SIZE, tag.data(), Sphinx::TAG_SIZE);
+        std::memcpy(p + slot, sealed.data(), beta - slot);
+        std::memcpy(p + beta, sealed.data() + beta, size - beta);
+        aead[i]->seal(nonces[i], {}, plain, sealed, tag);
+    }
+
+    std::memcpy(packet.data() + layout.start, nonces[0].data(), Sphinx::NONCE_SIZE);
+    std::memcpy(packet.data() + layout.start + Sphinx::NONCE_SIZE, tag.data(), Sphinx::TAG_SIZE);
+    std::memcpy(packet.data() + layout.beta(), sealed.data(), size);
+}
+
+// A relay's side: opens its layer in place and shifts beta up one slot.
+// Copies its routing bytes out.
+bool peel(const Layout& layout, const ChaCha20Poly1305& aead, Sphinx::Packet& packet, uint8_t* routing) {
+    ChaCha20Poly1305::Nonce nonce;
+    ChaCha20Poly1305::Tag tag;
+    std::memcpy(nonce.data(), packet.data() + layout.start, nonce.size());
+    std::memcpy(tag.data(), packet.data() + layout.start + nonce.size(), tag.size());
+    const std::span<uint8_t> region(packet.data() + layout.beta(), layout.region_size());
+    if (!aead.open(nonce, {}, region, region, tag)) return false;
+
+    uint8_t head[Sphinx::SETUP_SLOT];
+    const size_t slot = layout.slot, beta = layout.beta_size();
+    std::memcpy(head, region.data(), slot);
+    std::memmove(region.data(), region.data() + slot, beta - slot);
+    std::memset(region.data() + beta - slot, 0, slot);
+    if (layout.routing > 0) std::memcpy(routing, head, layout.routing);
+    std::memcpy(packet.data() + layout.start, head + layout.routing, Sphinx::NONCE_SIZE + Sphinx::TAG_SIZE);
+    return true;
+}
+
+std::vector<ChaCha20Poly1305::Nonce> random_nonces(size_t n) {
+    std::vector<ChaCha20Poly1305::Nonce> nonces(n);
+    for (auto& nonce : nonces) SecureRandom::fill(nonce);
+    return nonces;
+}
+
+} // namespace
+
+Sphinx::Setup Sphinx::build_setup(std::span<const Hop> path) {
+    Setup setup;
+    setup.packet.fill(0);
+    const size_t n = path.size();
+    if (n == 0 || n > MAX_HOPS) return setup;
+
+    const X25519::KeyPair ephemeral = X25519::generate_keypair();
+    X25519::Key alpha = ephemeral.public_key;
+    std::vector<X25519::Key> blinds;
+    std::vector<Key> header_keys;
+    std::vector<uint8_t> routing(n * 4);
+    for (size_t i = 0; i < n; ++i) {
+        // x * b_0 * ... * b_{i-1} * y_i, the secret relay i gets from alpha_i.
+        auto secret = X25519::shared_secret(ephemeral.secret_key, path[i].public_key);
+        for (size_t j = 0; secret && j < i; ++j) secret = X25519::shared_secret(blinds[j], *secret);
+        if (!secret) {
+            setup.forward_keys.clear();
+            return setup;
+        }
+        const HopSecrets hop = derive(*secret, alpha);
+        header_keys.push_back(hop.header);
+        setup.forward_keys.push_back(hop.forward);
+        blinds.push_back(hop.blind);
+        if (i == 0) std::memcpy(setup.packet.data(), alpha.data(), alpha.size());
+        alpha = X25519::scalarmult(hop.blind, alpha);
+
+        const uint32_t next = i + 1 < n ? path[i + 1].relay : EXIT;
+        for (int b = 0; b < 4; ++b) routing[i * 4 + b] = static_cast<uint8_t>(next >> (24 - 8 * b));
+    }
+    wrap(SETUP, header_keys, random_nonces(n), routing, {}, setup.packet);
+    return setup;
+}
+
+Sphinx::SetupResult Sphinx::process_setup(std::span<const uint8_t, X25519::KEY_SIZE> secret_key, Packet& packet) {
+    SetupResult result;
+    const std::span<const uint8_t, X25519::KEY_SIZE> alpha(packet.data(), X25519::KEY_SIZE);
+    const auto secret = X25519::shared_secret(secret_key, alpha);
+    if (!secret) return result;
+    const HopSecrets hop = derive(*secret, alpha);
+
+    const ChaCha20Poly1305 header(hop.header);
+    uint8_t routing[4];
+    if (!peel(SETUP, header, packet, routing)) return result;
+    const X25519::Key blinded = X25519::scalarmult(hop.blind, alpha);
+    std::memcpy(packet.data(), blinded.data(), blinded.size());
+
+    result.ok = true;
+    result.next = (uint32_t{routing[0]} << 24) | (uint32_t{routing[1]} << 16) | (uint32_t{routing[2]} << 8) | routing[3];
+    result.forward_key = hop.forward;
+    for (int i = 0; i < 8; ++i) result.replay_tag.hi = (result.replay_tag.hi << 8) | hop.replay[i];
+    for (int i = 8; i < 16; ++i) result.replay_tag.lo = (result.replay_tag.lo << 8) | hop.replay[i];
+    return result;
+}
+
+bool Sphinx::build_cell(std::span<const Key> forward_keys, std::span<const uint8_t> message, Packet& cell,
+                        bool cover) {
+    const size_t n = forward_keys.size();
+    if (n == 0 || n > MAX_HOPS || message.size() > CELL_PAYLOAD || (cover && !message.empty())) return false;
+    uint8_t body[PACKET_SIZE - CELL_HEADER] = {};
+    const size_t length = cover ? CELL_COVER : message.size();
+    body[0] = static_cast<uint8_t>(length >> 8);
+    body[1] = static_cast<uint8_t>(length);
+    std::copy(message.begin(), message.end(), body + 2);
+    wrap(CELL, forward_keys, random_nonces(n), {}, body, cell);
+    return true;
+}
+
+bool Sphinx::process_cell(const ChaCha20Poly1305& forward, Packet& cell) {
+    return peel(CELL, forward, cell, nullptr);
+}
+
+std::string Sphinx::open_payload(const Packet& cell) {
+    const uint8_t* body = cell.data() + CELL_HEADER;
+    const size_t n = payload_size(cell);
+    return std::string(reinterpret_cast<const char*>(body + 2), n);
+}
+
+size_t Sphinx::payload_size(const Packet& cell) {
+    const uint8_t* body = cell.data() + CELL_HEADER;
+    return std::min<size_t>((size_t{body[0]} << 8 | body[1]) & ~size_t{CELL_COVER}, CELL_PAYLOAD);
+}
+
+bool Sphinx::is_cover(const Packet& cell) {
+    return (cell[CELL_HEADER] << 8 & CELL_COVER) != 0;
+}
+
+} // namespace Crypto
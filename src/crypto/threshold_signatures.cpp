@@ -1,4 +1,5 @@
 #include "threshold_signatures.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -16,7 +17,7 @@ ThresholdSignatures::generate_shares(int total_shares, int threshold) {
     for (int i = 0; i < total_shares; ++i) {
         Share share;
         share.share_id = i + 1;
-        for (auto& b : share.share_value) b = rand() % 256;
+        SecureRandom::fill(share.share_value);
         shares.push_back(share);
     }
     
@@ -35,7 +36,7 @@ ThresholdSignatures::combine_shares(const std::vector<Share>& shares) {
     
     if ((int)shares.size() >= threshold_level) {
         // Simulate signature combination
-        for (auto& b : sig.signature) b = rand() % 256;
+        SecureRandom::fill(sig.signature);
         sig.threshold = threshold_level;
         sig.total_shares = shares.size();
         
@@ -0,0 +1,214 @@
+#include "x25519.h"
+#include "secure_random.h"
+
+#include <cstring>
+
+namespace Crypto {
+
+namespace {
+
+__extension__ typedef unsigned __int128 u128;
+
+// GF(2^255 - 19) in five 51-bit limbs. Products of limbs below 2^54 fit in
+// 128 bits with room for the x19 folding of the high half.
+struct Fe {
+    uint64_t v[5];
+};
+
+constexpr uint64_t MASK51 = (uint64_t{1} << 51) - 1;
+
+uint64_t load64(const uint8_t* p) {
+    uint64_t r = 0;
+    for (int i = 7; i >= 0; --i) r = (r << 8) | p[i];
+    return r;
+}
+
+Fe fe_load(const uint8_t in[32]) {
+    // The top bit of a u-coordinate is ignored (RFC 7748, 5).
+    return Fe{{load64(in) & MASK51, (load64(in + 6) >> 3) & MASK51, (load64(in + 12) >> 6) & MASK51,
+               (load64(in + 19) >> 1) & MASK51, (load64(in + 24) >> 12) & MASK51}};
+}
+
+Fe fe_add(const Fe& a, const Fe& b) {
+    return Fe{{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3], a.v[4] + b.v[4]}};
+}
+
+// a - b + 2p, for reduced b.
+Fe fe_sub(const Fe& a, const Fe& b) {
+    return Fe{{a.v[0] + 0xfffffffffffdaull - b.v[0], a.v[1] + 0xffffffffffffeull - b.v[1],
+               a.v[2] + 0xffffffffffffeull - b.v[2], a.v[3] + 0xffffffffffffeull - b.v[3],
+               a.v[4] + 0xffffffffffffeull - b.v[4]}};
+}
+
+Fe fe_carry(const u128 t[5]) {
+    Fe r;
+    u128 c = t[0];
+    r.v[0] = static_cast<uint64_t>(c) & MASK51;
+    c = t[1] + static_cast<uint64_t>(c >> 51);
+    r.v[1] = static_cast<uint64_t>(c) & MASK51;
+    c = t[2] + static_cast<uint64_t>(c >> 51);
+    r.v[2] = static_cast<uint64_t>(c) & MASK51;
+    c = t[3] + static_cast<uint64_t>(c >> 51);
+    r.v[3] = static_cast<uint64_t>(c) & MASK51;
+    c = t[4] + static_cast<uint64_t>(c >> 51);
+    r.v[4] = static_cast<uint64_t>(c) & MASK51;
+    r.v[0] += static_cast<uint64_t>(c >> 51) * 19;
+    r.v[1] += r.v[0] >> 51;
+    r.v[0] &= MASK51;
+    return r;
+}
+
+Fe fe_mul(const Fe& a, const Fe& b) {
+    const uint64_t b1 = b.v[1] * 19, b2 = b.v[2] * 19, b3 = b.v[3] * 19, b4 = b.v[4] * 19;
+    u128 t[5];
+    t[0] = (u128)a.v[0] * b.v[0] + (u128)a.v[1] * b4 + (u128)a.v[2] * b3 + (u128)a.v[3] * b2 + (u128)a.v[4] * b1;
+    t[1] = (u128)a.v[0] * b.v[1] + (u128)a.v[1] * b.v[0] + (u128)a.v[2] * b4 + (u128)a.v[3] * b3 + (u128)a.v[4] * b2;
+    t[2] = (u128)a.v[0] * b.v[2] + (u128)a.v[1] * b.v[1] + (u128)a.v[2] * b.v[0] + (u128)a.v[3] * b4 +
+           (u128)a.v[4] * b3;
+    t[3] = (u128)a.v[0] * b.v[3] + (u128)a.v[1] * b.v[2] + (u128)a.v[2] * b.v[1] + (u128)a.v[3] * b.v[0] +
+           (u128)a.v[4] * b4;
+    t[4] = (u128)a.v[0] * b.v[4] + (u128)a.v[1] * b.v[3] + (u128)a.v[2] * b.v[2] + (u128)a.v[3] * b.v[1] +
+           (u128)a.v[4] * b.v[0];
+    return fe_carry(t);
+}
+
+Fe fe_sq(const Fe& a) {
+    const uint64_t d0 = a.v[0] * 2, d1 = a.v[1] * 2, d2 = a.v[2] * 2 * 19, d4 = a.v[4] * 19, d419 = d4 * 2;
+    const uint64_t a3_19 = a.v[3] * 19;
+    u128 t[5];
+    t[0] = (u128)a.v[0] * a.v[0] + (u128)d419 * a.v[1] + (u128)d2 * a.v[3];
+    t[1] = (u128)d0 * a.v[1] + (u128)d419 * a.v[2] + (u128)a3_19 * a.v[3];
+    t[2] = (u128)d0 * a.v[2] + (u128)a.v[1] * a.v[1] + (u128)d419 * a.v[3];
+    t[3] = (u128)d0 * a.v[3] + (u128)d1 * a.v[2] + (u128)d4 * a.v[4];
+    t[4] = (u128)d0 * a.v[4] + (u128)d1 * a.v[3] + (u128)a.v[2] * a.v[2];
+    return fe_carry(t);
+}
+
+Fe fe_mul_small(const Fe& a, uint64_t k) {
+    u128 t[5];
+    for (int i = 0; i < 5; ++i) t[i] = (u128)a.v[i] * k;
+    return fe_carry(t);
+}
+
+Fe fe_sq_n(Fe a, int n) {
+    while (n-- > 0) a = fe_sq(a);
+    return a;
+}
+
+// z^(p - 2) = z^-1, the usual addition chain.
+Fe fe_invert(const Fe& z) {
+    const Fe z2 = fe_sq(z);
+    const Fe z9 = fe_mul(fe_sq_n(z2, 2), z);
+    const Fe z11 = fe_mul(z9, z2);
+    const Fe z2_5_0 = fe_mul(fe_sq(z11), z9);
+    const Fe z2_10_0 = fe_mul(fe_sq_n(z2_5_0, 5), z2_5_0);
+    const Fe z2_20_0 = fe_mul(fe_sq_n(z2_10_0, 10), z2_10_0);
+    const Fe z2_40_0 = fe_mul(fe_sq_n(z2_20_0, 20), z2_20_0);
+    const Fe z2_50_0 = fe_mul(fe_sq_n(z2_40_0, 10), z2_10_0);
+    const Fe z2_100_0 = fe_mul(fe_sq_n(z2_50_0, 50), z2_50_0);
+    const Fe z2_200_0 = fe_mul(fe_sq_n(z2_100_0, 100), z2_100_0);
+    const Fe z2_250_0 = fe_mul(fe_sq_n(z2_200_0, 50), z2_50_0);
+    return fe_mul(fe_sq_n(z2_250_0, 5), z11);
+}
+
+void fe_store(uint8_t out[32], Fe a) {
+    // Fully reduce: carry twice, then subtract p when a >= p.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int i = 0; i < 4; ++i) {
+            a.v[i + 1] += a.v[i] >> 51;
+            a.v[i] &= MASK51;
+        }
+        a.v[0] += (a.v[4] >> 51) * 19;
+        a.v[4] &= MASK51;
+    }
+    // a + 19 overflows 2^255 exactly when a >= p.
+    uint64_t carry = (a.v[0] + 19) >> 51;
+    for (int i = 1; i < 5; ++i) carry = (a.v[i] + carry) >> 51;
+    a.v[0] += 19 * carry;
+    for (int i = 0; i < 4; ++i) {
+        a.v[i + 1] += a.v[i] >> 51;
+        a.v[i] &= MASK51;
+    }
+    a.v[4] &= MASK51;
+
+    const uint64_t words[4] = {a.v[0] | (a.v[1] << 51), (a.v[1] >> 13) | (a.v[2] << 38),
+                               (a.v[2] >> 26) | (a.v[3] << 25), (a.v[3] >> 39) | (a.v[4] << 12)};
+    for (int w = 0; w < 4; ++w) {
+        for (int b = 0; b < 8; ++b) out[8 * w + b] = static_cast<uint8_t>(words[w] >> (8 * b));
+    }
+}
+
+void fe_cswap(Fe& a, Fe& b, uint64_t swap) {
+    const uint64_t mask = 0 - swap;
+    for (int i = 0; i < 5; ++i) {
+        const uint64_t x = mask & (a.v[i] ^ b.v[i]);
+        a.v[i] ^= x;
+        b.v[i] ^= x;
+    }
+}
+
+void secure_wipe(void* p, size_t n) {
+    volatile uint8_t* v = static_cast<volatile uint8_t*>(p);
+    while (n--) *v++ = 0;
+}
+
+} // namespace
+
+X25519::Key X25519::scalarmult(std::span<const uint8_t, KEY_SIZE> scalar, std::span<const uint8_t, KEY_SIZE> point) {
+    uint8_t k[32];
+    std::memcpy(k, scalar.data(), sizeof(k));
+    k[0] &= 248;
+    k[31] &= 127;
+    k[31] |= 64;
+
+    const Fe x1 = fe_load(point.data());
+    Fe x2{{1, 0, 0, 0, 0}}, z2{{0, 0, 0, 0, 0}}, x3 = x1, z3{{1, 0, 0, 0, 0}};
+    uint64_t swap = 0;
+    for (int t = 254; t >= 0; --t) {
+        const uint64_t bit = (k[t >> 3] >> (t & 7)) & 1;
+        swap ^= bit;
+        fe_cswap(x2, x3, swap);
+        fe_cswap(z2, z3, swap);
+        swap = bit;
+
+        const Fe a = fe_add(x2, z2), aa = fe_sq(a);
+        const Fe b = fe_sub(x2, z2), bb = fe_sq(b);
+        const Fe e = fe_sub(aa, bb);
+        const Fe c = fe_add(x3, z3), d = fe_sub(x3, z3);
+        const Fe da = fe_mul(d, a), cb = fe_mul(c, b);
+        x3 = fe_sq(fe_add(da, cb));
+        z3 = fe_mul(x1, fe_sq(fe_sub(da, cb)));
+        x2 = fe_mul(aa, bb);
+        z2 = fe_mul(e, fe_add(aa, fe_mul_small(e, 121665)));
+    }
+    fe_cswap(x2, x3, swap);
+    fe_cswap(z2, z3, swap);
+
+    Key out;
+    fe_store(out.data(), fe_mul(x2, fe_invert(z2)));
+    secure_wipe(k, sizeof(k));
+    return out;
+}
+
+X25519::Key X25519::public_key(std::span<const uint8_t, KEY_SIZE> secret_key) {
+    static constexpr Key BASE = {9};
+    return scalarmult(secret_key, BASE);
+}
+
+X25519::KeyPair X25519::generate_keypair() {
+    KeyPair pair;
+    SecureRandom::fill(pair.secret_key);
+    pair.public_key = public_key(pair.secret_key);
+    return pair;
+}
+
+std::optional<X25519::Key> X25519::shared_secret(std::span<const uint8_t, KEY_SIZE> scalar,
+                                                 std::span<const uint8_t, KEY_SIZE> point) {
+    const Key out = scalarmult(scalar, point);
+    uint8_t any = 0;
+    for (uint8_t b : out) any |= b;
+    if (any == 0) return std::nullopt;
+    return out;
+}
+
+} // namespace Crypto
@@ -1,4 +1,5 @@
 #include "zero_knowledge_proofs.h"
+#include "secure_random.h"
 #include <sstream>
 
 namespace Crypto {
@@ -15,13 +16,13 @@ ZeroKnowledgeProofs::ZKProof ZeroKnowledgeProofs::create_proof(
     std::cout << "[*] Creating ZK proof..." << std::endl;
     
     // Generate commitment
-    for (auto& b : proof.commitment) b = rand() % 256;
+    SecureRandom::fill(proof.commitment);
     
     // Generate challenge
-    for (auto& b : proof.challenge) b = rand() % 256;
+    SecureRandom::fill(proof.challenge);
     
     // Generate response
-    for (auto& b : proof.response) b = rand() % 256;
+    SecureRandom::fill(proof.response);
     
     std::cout << "  Commitment: " << proof.commitment.size() << " bytes" << std::endl;
     std::cout << "  Challenge: " << proof.challenge.size() << " bytes" << std::endl;
@@ -57,9 +58,9 @@ ZeroKnowledgeProofs::ZKProof ZeroKnowledgeProofs::create_range_proof(
     std::cout << "[*] Creating range proof..." << std::endl;
     std::cout << "  Value: " << value << " in range [" << min << ", " << max << "]" << std::endl;
     
-    for (auto& b : proof.commitment) b = rand() % 256;
-    for (auto& b : proof.challenge) b = rand() % 256;
-    for (auto& b : proof.response) b = rand() % 256;
+    SecureRandom::fill(proof.commitment);
+    SecureRandom::fill(proof.challenge);
+    SecureRandom::fill(proof.response);
     
     proof.verified = (value >= min && value <= max);
     
@@ -84,9 +85,9 @@ ZeroKnowledgeProofs::ZKProof ZeroKnowledgeProofs::create_membership_proof(
         }
     }
     
-    for (auto& b : proof.commitment) b = rand() % 256;
-    for (auto& b : proof.challenge) b = rand() % 256;
-    for (auto& b : proof.response) b = rand() % 256;
+    SecureRandom::fill(proof.commitment);
+    SecureRandom::fill(proof.challenge);
+    SecureRandom::fill(proof.response);
     
     proof.verified = found;
     
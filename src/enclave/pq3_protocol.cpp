@@ -1,12 +1,13 @@
 #include "pq3_protocol.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
 PQ3Protocol::PQ3Protocol() {}
 
 void PQ3Protocol::initialize_session() {
-    for (auto& b : session.root_key.ratchet_key) b = rand() % 256;
-    for (auto& b : session.root_key.chain_key) b = rand() % 256;
+    SecureRandom::fill(session.root_key.ratchet_key);
+    SecureRandom::fill(session.root_key.chain_key);
     session.sending_ratchet_counter = 0;
     session.receiving_ratchet_counter = 0;
     
@@ -19,7 +20,7 @@ void PQ3Protocol::initialize_session() {
 PQ3Protocol::MessageKeys PQ3Protocol::derive_message_key() {
     MessageKeys mk;
     
-    for (auto& b : mk.message_key) b = rand() % 256;
+    SecureRandom::fill(mk.message_key);
     
     session.sending_ratchet_counter++;
     
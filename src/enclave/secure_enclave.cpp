@@ -1,4 +1,5 @@
 #include "secure_enclave.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -24,9 +25,9 @@ SecureEnclave::AttestationQuote SecureEnclave::generate_attestation(const std::s
     AttestationQuote quote;
     
     quote.quote_data.resize(128);
-    for (auto& b : quote.quote_data) b = rand() % 256;
+    SecureRandom::fill(quote.quote_data);
     
-    quote.qe_target_info = "qe_target_" + std::to_string(rand() % 100000);
+    quote.qe_target_info = "qe_target_" + std::to_string(SecureRandom::uniform(100000));
     quote.nonce = challenge;
     
     std::cout << "\n=== Remote Attestation ===" << std::endl;
@@ -1,4 +1,5 @@
 #include "tls_handshake.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -21,7 +22,7 @@ QRTLSHandshake::HandshakeResult QRTLSHandshake::perform_handshake(const std::str
     }
     
     result.cipher_suite = supported_suites[0];
-    for (auto& b : result.session_id) b = rand() % 256;
+    SecureRandom::fill(result.session_id);
     
     std::cout << "\n[2] Server Hello" << std::endl;
     std::cout << "  Selected Suite: " << result.cipher_suite << std::endl;
@@ -33,12 +34,12 @@ QRTLSHandshake::HandshakeResult QRTLSHandshake::perform_handshake(const std::str
     
     result.certificates.resize(2);
     for (auto& cert : result.certificates) {
-        for (auto& b : cert) b = rand() % 256;
+        SecureRandom::fill(cert);
     }
     std::cout << "\n[4] Certificate Exchange" << std::endl;
     std::cout << "  Chain Length: " << result.certificates.size() << std::endl;
     
-    for (auto& b : result.master_secret) b = rand() % 256;
+    SecureRandom::fill(result.master_secret);
     result.success = true;
     
     std::cout << "\n[5] Handshake Complete" << std::endl;
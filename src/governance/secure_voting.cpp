@@ -1,8 +1,10 @@
 #include "secure_voting.h"
+#include "sha256.h"
+#include "cipher_engine.h"
+#include "secure_random.h"
 #include <iostream>
 #include <random>
 #include <sstream>
-#include <iomanip>
 #include <algorithm>
 
 namespace SecureChat {
@@ -27,8 +29,7 @@ bool SecureVoting::initialize(const VotingConfig& config) {
 }
 
 std::string SecureVoting::generate_proposal_id() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    Crypto::SecureRandom::Engine gen;
     std::uniform_int_distribution<> dis(0, 15);
     
     std::stringstream ss;
@@ -43,12 +44,7 @@ std::string SecureVoting::generate_vote_hash(const Vote& vote) {
     std::stringstream ss;
     ss << vote.proposal_id << vote.voter_did << vote.choice << vote.weight;
     
-    std::hash<std::string> hasher;
-    size_t hash = hasher(ss.str());
-    
-    std::stringstream hash_ss;
-    hash_ss << std::hex << std::setfill('0') << std::setw(16) << hash;
-    return hash_ss.str();
+    return Crypto::Sha256::hex(Crypto::Sha256::hash(Crypto::byte_view(ss.str())));
 }
 
 Proposal SecureVoting::create_proposal(const std::string& title, const std::string& description,
@@ -120,12 +116,7 @@ Vote SecureVoting::cast_vote(const std::string& proposal_id, const std::string&
     
     // Generate ZK proof (simplified)
     vote.zk_proof.resize(32);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    for (auto& b : vote.zk_proof) {
-        b = static_cast<uint8_t>(dis(gen));
-    }
+    Crypto::SecureRandom::fill(vote.zk_proof);
     
     votes_[proposal_id].push_back(vote);
     
@@ -149,12 +140,7 @@ Vote SecureVoting::cast_anonymous_vote(const std::string& proposal_id, const std
     
     // Generate anonymous ZK proof
     vote.zk_proof.resize(64);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    for (auto& b : vote.zk_proof) {
-        b = static_cast<uint8_t>(dis(gen));
-    }
+    Crypto::SecureRandom::fill(vote.zk_proof);
     
     votes_[proposal_id].push_back(vote);
     
@@ -368,13 +354,7 @@ void SecureVoting::execute_after_timelock(const std::string& proposal_id) {
 std::vector<uint8_t> SecureVoting::generate_merkle_root(const std::vector<Vote>& votes) {
     std::vector<uint8_t> root(32);
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (auto& b : root) {
-        b = static_cast<uint8_t>(dis(gen));
-    }
+    Crypto::SecureRandom::fill(root);
     
     return root;
 }
@@ -57,9 +57,12 @@
 #include "include/secure_identity_management.h"
 #include "include/secure_authentication.h"
 #include "include/secure_file_sharing.h"
+#include "include/kernel_registry.h"
 
-int main() {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+int main(int argc, char** argv) {
+    if (!Crypto::apply_force_backend_flag(argc, argv)) {
+        return 1;
+    }
     
     std::cout << R"(
     ╔═════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════╗
@@ -68,6 +71,7 @@ int main() {
     ║     Author: Olivier Robert-Duboille                                                                                             ║
     ╚═════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════════╝
     )" << std::endl;
+    std::cout << "[*] Crypto kernels: " << Crypto::describe_kernels() << std::endl;
     
     std::unique_ptr<Crypto::SDJWT> sdjwt(new Crypto::SDJWT());
     std::unique_ptr<Crypto::SecureEnclave> secure_enclave(new Crypto::SecureEnclave());
@@ -113,7 +117,7 @@ int main() {
     identity->initialize();
     auto id = identity->create_identity("Olivier Robert", "personal");
     auto did = identity->create_did("web");
-    auto vc = identity->issue_credential(id.identity_id, "issuer_123", {"email_verified", "phone_verified"});
+    auto vc = identity->issue_credential(id.identity_id.to_string("identity"), "issuer_123", {"email_verified", "phone_verified"});
     identity->verify_credential(vc);
     identity->enable_selective_disclosure(true);
     identity->enable_zero_knowledge_proofs(true);
@@ -0,0 +1,53 @@
+#include "alias_table.h"
+
+#include <algorithm>
+
+namespace Crypto {
+
+namespace {
+
+uint32_t threshold(double p) {
+    return p >= 1.0 ? UINT32_MAX : static_cast<uint32_t>(p * 4294967296.0);
+}
+
+} // namespace
+
+void AliasTable::build(std::span<const double> weights) {
+    const size_t n = weights.size();
+    columns_.assign(n, Column{UINT32_MAX, 0});
+    total_ = 0;
+    for (const double w : weights) total_ += std::max(w, 0.0);
+    if (!(total_ > 0)) {
+        total_ = 0;
+        return;
+    }
+
+    // Column weights scaled so that the mean is 1. Each pass fills an
+    // under-full column from an over-full one, which may become under-full.
+    std::vector<double> scaled(n);
+    std::vector<uint32_t> small, large;
+    for (size_t i = 0; i < n; ++i) {
+        scaled[i] = std::max(weights[i], 0.0) * static_cast<double>(n) / total_;
+        (scaled[i] < 1.0 ? small : large).push_back(static_cast<uint32_t>(i));
+    }
+    uint32_t donor = large.empty() ? 0 : large.back();
+    while (!small.empty() && !large.empty()) {
+        const uint32_t s = small.back();
+        small.pop_back();
+        donor = large.back();
+        columns_[s] = Column{threshold(scaled[s]), donor};
+        scaled[donor] = (scaled[donor] + scaled[s]) - 1.0;
+        if (scaled[donor] < 1.0) {
+            large.pop_back();
+            small.push_back(donor);
+        }
+    }
+    // What is left is full up to rounding, except a weightless entry that
+    // rounding stranded: it keeps pointing away from itself.
+    for (const uint32_t l : large) columns_[l] = Column{UINT32_MAX, l};
+    for (const uint32_t s : small) {
+        columns_[s] = weights[s] > 0 ? Column{UINT32_MAX, s} : Column{0, donor};
+    }
+}
+
+} // namespace Crypto
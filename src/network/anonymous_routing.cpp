@@ -1,60 +1,300 @@
 #include "anonymous_routing.h"
+#include "secure_random.h"
+
+#include <array>
+#include <charconv>
+#include <cmath>
 
 namespace Crypto {
 
+namespace {
+
+constexpr size_t HOPS = 3;
+constexpr size_t SEEN_SETUPS = 4096;
+// Draws per hop before select_relays() gives up on a path.
+constexpr size_t MAX_DRAWS = 32;
+
+double selection_weight(const AnonymousRouting::Node& node) {
+    return node.is_online ? node.bandwidth * node.uptime / 100.0 : 0.0;
+}
+
+// "a.b.c.d" -> a << 8 | b.
+uint32_t subnet16(const std::string& address) {
+    uint32_t a = 0, b = 0;
+    const char* end = address.data() + address.size();
+    const auto first = std::from_chars(address.data(), end, a);
+    if (first.ptr != end && *first.ptr == '.') std::from_chars(first.ptr + 1, end, b);
+    return (a << 8) | (b & 0xff);
+}
+
+} // namespace
+
 AnonymousRouting::AnonymousRouting() {}
 
 void AnonymousRouting::setup_network(int num_nodes) {
     std::lock_guard<std::mutex> lock(network_mutex);
-    
+
+    const size_t first = network_nodes.size();
     for (int i = 0; i < num_nodes; ++i) {
+        const X25519::KeyPair keys = X25519::generate_keypair();
+        const size_t index = network_nodes.size();
         Node node;
-        node.node_id = "node_" + std::to_string(i);
-        node.address = "10.0." + std::to_string(i / 255) + "." + std::to_string(i % 255);
-        node.public_key = "pubkey_" + std::to_string(rand() % 100000);
+        node.node_id = "node_" + std::to_string(index);
+        node.address = "10." + std::to_string(index % 256) + "." + std::to_string(index / 256 % 256) + "." +
+                       std::to_string(1 + index / 65536 % 254);
+        node.public_key = keys.public_key;
         node.is_online = true;
-        node.uptime = 95.0 + (rand() % 5);
+        node.uptime = 95.0 + (SecureRandom::uniform(5));
+        // Log-uniform from 250 KB/s to 100 MB/s: a few fast relays, many slow.
+        node.bandwidth = 250e3 * std::pow(400.0, SecureRandom::uniform_real());
+        node.family = "family_" + std::to_string(index / 4);
+        // Every relay delivers inside the network; about a third also
+        // deliver to messaging gateways, a fifth to the web.
+        node.exit_policy = 1u << EXIT_INTERNAL;
+        if (SecureRandom::uniform(3) == 0) node.exit_policy |= 1u << EXIT_MESSAGING;
+        if (SecureRandom::uniform(5) == 0) node.exit_policy |= 1u << EXIT_WEB;
         network_nodes.push_back(node);
+
+        Relay relay;
+        relay.secret_key = keys.secret_key;
+        relay.family = node.family.empty()
+                           ? UINT32_MAX - static_cast<uint32_t>(index)
+                           : families.try_emplace(node.family, static_cast<uint32_t>(families.size())).first->second;
+        relay.subnet = subnet16(node.address);
+        relays.push_back(std::move(relay));
     }
-    
+    rebuild_selection(first / SELECTION_BLOCK, (relays.size() + SELECTION_BLOCK - 1) / SELECTION_BLOCK);
+
     std::cout << "\n=== Anonymous Network Setup ===" << std::endl;
     std::cout << "Nodes: " << num_nodes << std::endl;
-    std::cout << "Network: Tor-like mix network" << std::endl;
+    std::cout << "Network: Sphinx onion routing, X25519 + ChaCha20-Poly1305" << std::endl;
+    std::cout << "Path selection: weighted by bandwidth and uptime, one relay per family and /16" << std::endl;
     std::cout << "Status: OPERATIONAL" << std::endl;
 }
 
-AnonymousRouting::Route AnonymousRouting::create_route() {
-    std::lock_guard<std::mutex> lock(network_mutex);
-    
-    Route route;
-    route.circuit_id = "circuit_" + std::to_string(rand() % 1000000);
-    route.created_at = time(nullptr);
-    
-    // Select 3 random nodes for the route
-    for (int i = 0; i < 3 && i < (int)network_nodes.size(); ++i) {
-        route.nodes.push_back(network_nodes[i % network_nodes.size()].node_id);
+AnonymousRouting::Route AnonymousRouting::create_route(uint32_t exit_class) {
+    Route route = build_route(exit_class);
+    if (route.relays.empty()) {
+        std::cout << "[!] Circuit not built: no path of " << HOPS
+                  << " relays in distinct families and subnets, or a relay rejected the setup" << std::endl;
+        return route;
     }
-    
+
     std::cout << "\n=== Route Created ===" << std::endl;
     std::cout << "Circuit ID: " << route.circuit_id << std::endl;
     std::cout << "Hops: " << route.nodes.size() << std::endl;
     for (size_t i = 0; i < route.nodes.size(); ++i) {
         std::cout << "  " << (i + 1) << ". " << route.nodes[i] << std::endl;
     }
-    
+
+    return route;
+}
+
+AnonymousRouting::Route AnonymousRouting::build_route(uint32_t exit_class) {
+    Route route;
+    route.circuit_id = "circuit_" + std::to_string(SecureRandom::uniform(1000000));
+    route.created_at = time(nullptr);
+    route.exit_class = exit_class;
+
+    std::array<uint32_t, HOPS> chosen;
+    std::vector<Sphinx::Hop> path;
+    {
+        std::lock_guard<std::mutex> lock(network_mutex);
+        if (!draw_path(chosen, exit_class)) return route;
+        for (const uint32_t relay : chosen) path.push_back(Sphinx::Hop{network_nodes[relay].public_key, relay});
+    }
+
+    // The client's share of the public-key work, without holding up relays.
+    // Then the setup packet goes relay to relay; each keeps its hop key
+    // under the circuit id it was reached on and picks the id for the next
+    // link.
+    const Sphinx::Setup setup = Sphinx::build_setup(path);
+    std::lock_guard<std::mutex> lock(network_mutex);
+    Sphinx::Packet packet = setup.packet;
+    uint32_t relay = path[0].relay;
+    uint32_t circuit = free_circuit(relays[relay]);
+    route.entry_circuit = circuit;
+    std::vector<std::pair<uint32_t, uint32_t>> built;
+    for (size_t hop = 0; hop < path.size(); ++hop) {
+        Relay& r = relays[relay];
+        const Sphinx::SetupResult result = Sphinx::process_setup(r.secret_key, packet);
+        if (!r.seen_setups) r.seen_setups = std::make_unique<RotatingBloomFilter>(SEEN_SETUPS);
+        if (!result.ok || r.seen_setups->check_and_insert(result.replay_tag) ||
+            (result.next != Sphinx::EXIT && result.next >= relays.size())) {
+            for (const auto& [at, id] : built) relays[at].circuits.erase(id);
+            route.relays.clear();
+            route.nodes.clear();
+            route.entry_circuit = 0;
+            return route;
+        }
+        Hop state;
+        state.cipher = std::make_unique<ChaCha20Poly1305>(result.forward_key);
+        state.exit = result.next == Sphinx::EXIT;
+        state.next_relay = state.exit ? 0 : result.next;
+        state.next_circuit = state.exit ? 0 : free_circuit(relays[result.next]);
+        const uint32_t next_circuit = state.next_circuit;
+        r.circuits.emplace(circuit, std::move(state));
+        built.emplace_back(relay, circuit);
+        route.relays.push_back(relay);
+        route.nodes.push_back(network_nodes[relay].node_id);
+        if (result.next == Sphinx::EXIT) break;
+        relay = result.next;
+        circuit = next_circuit;
+    }
+    route.hop_keys = setup.forward_keys;
     return route;
 }
 
-std::string AnonymousRouting::send_anonymously(const std::string& message, 
+std::string AnonymousRouting::send_anonymously(const std::string& message,
                                                const Route& route) {
+    std::string received;
+    size_t cells = 0;
+    bool delivered = !route.relays.empty();
+    Sphinx::Packet cell;
+    for (size_t offset = 0; delivered && (offset < message.size() || cells == 0); offset += Sphinx::CELL_PAYLOAD) {
+        const size_t n = std::min(Sphinx::CELL_PAYLOAD, message.size() - offset);
+        if (!build_cell(route, {reinterpret_cast<const uint8_t*>(message.data()) + offset, n}, cell)) {
+            delivered = false;
+            break;
+        }
+        ++cells;
+        uint32_t relay = route.relays.front(), circuit = route.entry_circuit;
+        for (size_t hop = 0;; ++hop) {
+            const Forward next = relay_cell(relay, circuit, cell);
+            if (!next.ok || hop >= Sphinx::MAX_HOPS) {
+                delivered = false;
+                break;
+            }
+            if (next.exit) {
+                received += Sphinx::open_payload(cell);
+                break;
+            }
+            relay = next.next_relay;
+            circuit = next.next_circuit;
+        }
+    }
+
     std::cout << "\n=== Sending Anonymously ===" << std::endl;
     std::cout << "Message: " << message.size() << " bytes" << std::endl;
     std::cout << "Circuit: " << route.circuit_id << std::endl;
     std::cout << "Hops: " << route.nodes.size() << std::endl;
-    std::cout << "Encryption: Layered (like Tor)" << std::endl;
-    std::cout << "Status: DELIVERED" << std::endl;
-    
-    return "acknowledgment";
+    std::cout << "Encryption: Sphinx, " << cells << " cell(s) of " << Sphinx::PACKET_SIZE
+              << " bytes, one AEAD layer per hop" << std::endl;
+    std::cout << "Status: " << (delivered ? "DELIVERED" : "FAILED") << std::endl;
+
+    return delivered ? received : std::string();
+}
+
+void AnonymousRouting::destroy_route(const Route& route) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    if (route.relays.empty()) return;
+    destroy_circuit(route.relays.front(), route.entry_circuit);
+}
+
+bool AnonymousRouting::select_relays(std::span<uint32_t> path, uint32_t exit_class) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    return draw_path(path, exit_class);
+}
+
+void AnonymousRouting::set_relay_online(uint32_t relay, bool online) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    if (relay >= network_nodes.size() || network_nodes[relay].is_online == online) return;
+    network_nodes[relay].is_online = online;
+    rebuild_selection(relay / SELECTION_BLOCK, relay / SELECTION_BLOCK + 1);
+}
+
+bool AnonymousRouting::build_cell(const Route& route, std::span<const uint8_t> chunk, Sphinx::Packet& cell) const {
+    return Sphinx::build_cell(route.hop_keys, chunk, cell);
+}
+
+bool AnonymousRouting::build_cover_cell(const Route& route, Sphinx::Packet& cell) const {
+    return Sphinx::build_cell(route.hop_keys, {}, cell, true);
+}
+
+AnonymousRouting::Forward AnonymousRouting::relay_cell(uint32_t relay, uint32_t circuit, Sphinx::Packet& cell) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    Forward out;
+    if (relay >= relays.size()) return out;
+    auto hop = relays[relay].circuits.find(circuit);
+    if (hop == relays[relay].circuits.end() || !Sphinx::process_cell(*hop->second.cipher, cell)) return out;
+    out.ok = true;
+    out.exit = hop->second.exit;
+    out.cover = out.exit && Sphinx::is_cover(cell);
+    out.next_relay = hop->second.next_relay;
+    out.next_circuit = hop->second.next_circuit;
+    return out;
+}
+
+std::vector<AnonymousRouting::Node> AnonymousRouting::nodes() {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    return network_nodes;
+}
+
+size_t AnonymousRouting::circuit_count() {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    size_t count = 0;
+    for (const auto& relay : relays) count += relay.circuits.size();
+    return count;
+}
+
+uint32_t AnonymousRouting::free_circuit(const Relay& relay) const {
+    for (;;) {
+        const uint32_t id = SecureRandom::next_u32();
+        if (id != 0 && !relay.circuits.contains(id)) return id;
+    }
+}
+
+// Along the circuit from its entry; the caller holds the lock.
+void AnonymousRouting::destroy_circuit(uint32_t relay, uint32_t circuit) {
+    for (size_t hop = 0; hop < Sphinx::MAX_HOPS && relay < relays.size(); ++hop) {
+        auto it = relays[relay].circuits.find(circuit);
+        if (it == relays[relay].circuits.end()) return;
+        const bool exit = it->second.exit;
+        const uint32_t next_relay = it->second.next_relay, next_circuit = it->second.next_circuit;
+        relays[relay].circuits.erase(it);
+        if (exit) return;
+        relay = next_relay;
+        circuit = next_circuit;
+    }
+}
+
+// The exit is drawn first, among relays whose policy allows exit_class;
+// then the others, last to first. The caller holds the lock.
+bool AnonymousRouting::draw_path(std::span<uint32_t> path, uint32_t exit_class) const {
+    if (!(block_table.total() > 0) || exit_class >= EXIT_CLASSES) return path.empty();
+    const uint32_t exit_bit = 1u << exit_class;
+    size_t chosen = 0;
+    for (size_t draws = 0; chosen < path.size() && draws < path.size() * MAX_DRAWS; ++draws) {
+        const size_t block = block_table.pick(SecureRandom::next_u64());
+        const uint32_t relay =
+            static_cast<uint32_t>(block * SELECTION_BLOCK + block_tables[block].pick(SecureRandom::next_u64()));
+        if (chosen == 0 && !(network_nodes[relay].exit_policy & exit_bit)) continue;
+        bool clash = false;
+        for (size_t i = path.size() - chosen; i < path.size(); ++i) {
+            const Relay& other = relays[path[i]];
+            clash |= path[i] == relay || other.family == relays[relay].family || other.subnet == relays[relay].subnet;
+        }
+        if (!clash) path[path.size() - 1 - chosen++] = relay;
+    }
+    return chosen == path.size();
+}
+
+// The caller holds the lock.
+void AnonymousRouting::rebuild_selection(size_t first, size_t last) {
+    const size_t blocks = (relays.size() + SELECTION_BLOCK - 1) / SELECTION_BLOCK;
+    block_tables.resize(blocks);
+    block_weights.resize(blocks, 0.0);
+    std::vector<double> weights;
+    for (size_t block = first; block < std::min(last, blocks); ++block) {
+        weights.clear();
+        const size_t end = std::min(relays.size(), (block + 1) * SELECTION_BLOCK);
+        for (size_t relay = block * SELECTION_BLOCK; relay < end; ++relay) {
+            weights.push_back(selection_weight(network_nodes[relay]));
+        }
+        block_tables[block].build(weights);
+        block_weights[block] = block_tables[block].total();
+    }
+    block_table.build(block_weights);
 }
 
 } // namespace Crypto
@@ -0,0 +1,66 @@
+#include "bloom_filter.h"
+#include "secure_random.h"
+
+#include <algorithm>
+
+namespace Crypto {
+
+RotatingBloomFilter::RotatingBloomFilter(size_t capacity, size_t bits_per_id)
+    : capacity_(std::max<size_t>(capacity, 1)),
+      blocks_(std::max<size_t>((capacity_ * std::max<size_t>(bits_per_id, 1) + 511) / 512, 1)),
+      key_{SecureRandom::next_u64(), SecureRandom::next_u64()} {
+    filters_[0].assign(blocks_, Block{});
+    filters_[1].assign(blocks_, Block{});
+}
+
+RotatingBloomFilter::Probe RotatingBloomFilter::probe(const Id128& id) const {
+    const uint64_t h1 = Id128Hash::mix(Id128Hash::mix(id.hi ^ key_[0]) ^ id.lo);
+    const uint64_t h2 = Id128Hash::mix(h1 ^ key_[1]);
+    Probe p;
+    p.block = static_cast<size_t>(((h1 >> 32) * blocks_) >> 32);    // blocks_ < 2^32
+    // Six bits of h2 pick the bit in each word.
+    for (int i = 0; i < 8; ++i) p.mask.words[i] = uint64_t{1} << ((h2 >> (6 * i)) & 63);
+    return p;
+}
+
+bool RotatingBloomFilter::test(const Block& block, const Block& mask) {
+    uint64_t missing = 0;
+    for (int i = 0; i < 8; ++i) missing |= mask.words[i] & ~block.words[i];
+    return missing == 0;
+}
+
+bool RotatingBloomFilter::contains(const Id128& id) const {
+    const Probe p = probe(id);
+    return test(filters_[current_][p.block], p.mask) || test(filters_[current_ ^ 1][p.block], p.mask);
+}
+
+void RotatingBloomFilter::insert(const Id128& id) {
+    (void)check_and_insert(id);
+}
+
+bool RotatingBloomFilter::check_and_insert(const Id128& id) {
+    const Probe p = probe(id);
+    if (test(filters_[current_][p.block], p.mask)) return true;
+    // Seen in the older generation only: carry it over, so that it stays
+    // known for a full window from now like a new id would.
+    const bool seen = test(filters_[current_ ^ 1][p.block], p.mask);
+
+    if (inserted_ == capacity_) {
+        // The older generation goes; what only it held is forgotten.
+        current_ ^= 1;
+        std::fill(filters_[current_].begin(), filters_[current_].end(), Block{});
+        inserted_ = 0;
+        ++rotations_;
+    }
+    Block& target = filters_[current_][p.block];
+    for (int i = 0; i < 8; ++i) target.words[i] |= p.mask.words[i];
+    ++inserted_;
+    return seen;
+}
+
+void RotatingBloomFilter::clear() {
+    for (auto& filter : filters_) std::fill(filter.begin(), filter.end(), Block{});
+    inserted_ = 0;
+}
+
+} // namespace Crypto
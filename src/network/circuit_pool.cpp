@@ -0,0 +1,134 @@
+#include "circuit_pool.h"
+
+#include <ctime>
+#include <stdexcept>
+
+namespace Crypto {
+
+namespace {
+
+constexpr size_t CLASSES = AnonymousRouting::EXIT_CLASSES;
+
+uint64_t now_seconds() {
+    return static_cast<uint64_t>(time(nullptr));
+}
+
+} // namespace
+
+CircuitPool::CircuitPool(AnonymousRouting& routing) : CircuitPool(routing, Options{}) {}
+
+CircuitPool::CircuitPool(AnonymousRouting& routing, const Options& options)
+    : routing_(routing),
+      options_(options),
+      slots_(std::make_unique<Slot[]>(CLASSES * options.per_class)) {
+    if (options.rebuild_ahead >= options.lifetime) {
+        throw std::invalid_argument("CircuitPool: rebuild_ahead must be less than lifetime");
+    }
+    worker_ = std::thread([this] { worker_loop(); });
+}
+
+CircuitPool::~CircuitPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_cv_.notify_one();
+    worker_.join();
+    for (size_t i = 0; i < CLASSES * options_.per_class; ++i) {
+        std::unique_ptr<AnonymousRouting::Route> route(slots_[i].route.exchange(nullptr));
+        if (route) routing_.destroy_route(*route);
+    }
+}
+
+std::unique_ptr<AnonymousRouting::Route> CircuitPool::take(uint32_t exit_class) {
+    const size_t k = options_.per_class;
+    if (exit_class >= CLASSES || k == 0) return nullptr;
+    Slot* slots = &slots_[exit_class * k];
+    const size_t start = next_.fetch_add(1, std::memory_order_relaxed) % k;
+    for (size_t i = 0; i < k; ++i) {
+        std::unique_ptr<AnonymousRouting::Route> route(
+            slots[(start + i) % k].route.exchange(nullptr, std::memory_order_acquire));
+        if (!route) continue;
+        wake();
+        // Only when the worker fell behind.
+        if (route->created_at + options_.lifetime <= now_seconds()) {
+            routing_.destroy_route(*route);
+            continue;
+        }
+        taken_.fetch_add(1, std::memory_order_relaxed);
+        return route;
+    }
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    wake();
+    return nullptr;
+}
+
+size_t CircuitPool::ready(uint32_t exit_class) const {
+    if (exit_class >= CLASSES) return 0;
+    size_t count = 0;
+    for (size_t i = 0; i < options_.per_class; ++i) {
+        count += slots_[exit_class * options_.per_class + i].route.load(std::memory_order_relaxed) != nullptr;
+    }
+    return count;
+}
+
+CircuitPool::Stats CircuitPool::stats() const {
+    Stats s;
+    s.built = built_.load(std::memory_order_relaxed);
+    s.replaced = replaced_.load(std::memory_order_relaxed);
+    s.taken = taken_.load(std::memory_order_relaxed);
+    s.misses = misses_.load(std::memory_order_relaxed);
+    s.failed = failed_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void CircuitPool::wake() {
+    if (!wanted_.exchange(true, std::memory_order_acq_rel)) wake_cv_.notify_one();
+}
+
+void CircuitPool::worker_loop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopping_) {
+        lock.unlock();
+        const bool busy = refill();
+        lock.lock();
+        if (!busy) {
+            wake_cv_.wait_for(lock, options_.poll,
+                              [&] { return stopping_ || wanted_.exchange(false, std::memory_order_acq_rel); });
+        }
+    }
+}
+
+bool CircuitPool::refill() {
+    const size_t total = CLASSES * options_.per_class;
+    Slot* target = nullptr;
+    for (size_t i = 0; i < total && !target; ++i) {
+        if (!slots_[i].route.load(std::memory_order_relaxed)) target = &slots_[i];
+    }
+    const uint64_t now = now_seconds();
+    for (size_t i = 0; i < total && !target; ++i) {
+        if (slots_[i].renew_at <= now) target = &slots_[i];
+    }
+    if (!target) return false;
+
+    const uint32_t exit_class = static_cast<uint32_t>((target - slots_.get()) / options_.per_class);
+    auto fresh = std::make_unique<AnonymousRouting::Route>(routing_.build_route(exit_class));
+    if (fresh->relays.empty()) {
+        failed_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint64_t expires = fresh->created_at + options_.lifetime;
+    target->renew_at = expires > options_.rebuild_ahead ? expires - options_.rebuild_ahead : 0;
+    built_.fetch_add(1, std::memory_order_relaxed);
+
+    // The slot may have been emptied by a take() since it was looked at;
+    // whatever was there is retired now that its replacement is ready.
+    std::unique_ptr<AnonymousRouting::Route> old(target->route.exchange(fresh.release(), std::memory_order_acq_rel));
+    if (old) {
+        routing_.destroy_route(*old);
+        replaced_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+}
+
+} // namespace Crypto
@@ -1,4 +1,7 @@
 #include "group_chat.h"
+#include "secure_random.h"
+
+#include <algorithm>
 
 namespace Crypto {
 
@@ -9,23 +12,23 @@ GroupChat::Group GroupChat::create_group(const std::string& group_name,
     std::lock_guard<std::mutex> lock(group_mutex);
     
     Group group;
-    group.group_id = "group_" + std::to_string(rand() % 1000000);
+    group.group_id = Id128::generate();
     group.group_name = group_name;
     group.admin_id = admin_id;
     
     // Add admin as first member
     GroupMember admin;
     admin.user_id = admin_id;
-    admin.public_key = "pubkey_" + std::to_string(rand() % 100000);
+    admin.public_key = "pubkey_" + std::to_string(SecureRandom::uniform(100000));
     admin.sender_key.resize(32);
-    for (auto& b : admin.sender_key) b = rand() % 256;
+    SecureRandom::fill(admin.sender_key);
     admin.is_admin = true;
     group.members.push_back(admin);
     
     groups.push_back(group);
     
     std::cout << "\n=== Group Created ===" << std::endl;
-    std::cout << "Group ID: " << group.group_id << std::endl;
+    std::cout << "Group ID: " << group.group_id.to_string("group") << std::endl;
     std::cout << "Group Name: " << group_name << std::endl;
     std::cout << "Admin: " << admin_id << std::endl;
     std::cout << "Encryption: Sender Keys (MLS-style)" << std::endl;
@@ -38,9 +41,9 @@ void GroupChat::add_member(Group& group, const std::string& user_id) {
     
     GroupMember member;
     member.user_id = user_id;
-    member.public_key = "pubkey_" + std::to_string(rand() % 100000);
+    member.public_key = "pubkey_" + std::to_string(SecureRandom::uniform(100000));
     member.sender_key.resize(32);
-    for (auto& b : member.sender_key) b = rand() % 256;
+    SecureRandom::fill(member.sender_key);
     member.is_admin = false;
     
     group.members.push_back(member);
@@ -56,6 +59,7 @@ void GroupChat::remove_member(Group& group, const std::string& user_id) {
     for (auto it = group.members.begin(); it != group.members.end(); ++it) {
         if (it->user_id == user_id) {
             group.members.erase(it);
+            sender_ciphers.erase({group.group_id, user_id});
             std::cout << "\n=== Member Removed ===" << std::endl;
             std::cout << "User: " << user_id << std::endl;
             break;
@@ -66,36 +70,113 @@ void GroupChat::remove_member(Group& group, const std::string& user_id) {
 GroupChat::GroupMessage GroupChat::send_message(Group& group, const std::string& sender,
                                                  const std::string& message) {
     GroupMessage msg;
-    msg.message_id = "msg_" + std::to_string(rand() % 1000000);
+    msg.message_id = Id128::generate();
     msg.sender = sender;
     msg.timestamp = time(nullptr);
     
-    // Encrypt with sender key
+    // Encrypt with sender key, in place; the message ID is bound as AAD
     msg.encrypted_content = message;
-    for (size_t i = 0; i < msg.encrypted_content.size(); ++i) {
-        msg.encrypted_content[i] ^= 0x42;
+    {
+        std::lock_guard<std::mutex> lock(group_mutex);
+        CipherEngine* cipher = sender_cipher(group, sender);
+        if (!cipher) {
+            std::cout << "[!] " << sender << " is not a member of " << group.group_name << std::endl;
+            msg.encrypted_content.clear();
+            return msg;
+        }
+        const CipherEngine::Nonce nonce = cipher->next_nonce();
+        const auto aad = msg.message_id.bytes();
+        CipherEngine::Tag tag;
+        cipher->seal(nonce, aad, byte_view(msg.encrypted_content),
+                     byte_view(msg.encrypted_content), tag);
+        msg.nonce.assign(nonce.begin(), nonce.end());
+        msg.auth_tag.assign(tag.begin(), tag.end());
     }
     
-    // Auth tag
-    msg.auth_tag.resize(16);
-    for (auto& b : msg.auth_tag) b = rand() % 256;
-    
     group.message_history.push_back(msg);
     
     std::cout << "\n=== Group Message Sent ===" << std::endl;
-    std::cout << "Message ID: " << msg.message_id << std::endl;
+    std::cout << "Message ID: " << msg.message_id.to_string("msg") << std::endl;
     std::cout << "Sender: " << sender << std::endl;
     std::cout << "Recipients: " << group.members.size() << std::endl;
     
     return msg;
 }
 
+std::vector<GroupChat::GroupMessage> GroupChat::send_messages(
+    Group& group, const std::vector<std::pair<std::string, std::string>>& outgoing) {
+    std::vector<GroupMessage> sent(outgoing.size());
+    std::vector<std::array<uint8_t, 16>> aads(outgoing.size());
+    {
+        std::lock_guard<std::mutex> lock(group_mutex);
+        std::vector<CipherEngine::BatchJob> jobs;
+        std::vector<size_t> job_message;
+        jobs.reserve(outgoing.size());
+        job_message.reserve(outgoing.size());
+        
+        for (size_t i = 0; i < outgoing.size(); ++i) {
+            GroupMessage& msg = sent[i];
+            msg.message_id = Id128::generate();
+            aads[i] = msg.message_id.bytes();
+            msg.sender = outgoing[i].first;
+            msg.timestamp = time(nullptr);
+            
+            CipherEngine* cipher = sender_cipher(group, msg.sender);
+            if (!cipher) {
+                std::cout << "[!] " << msg.sender << " is not a member of " << group.group_name << std::endl;
+                continue;
+            }
+            msg.encrypted_content = outgoing[i].second;
+            
+            CipherEngine::BatchJob job;
+            job.cipher = cipher;
+            job.nonce = cipher->next_nonce();
+            job.aad = aads[i];
+            job.in = byte_view(msg.encrypted_content);
+            job.out = byte_view(msg.encrypted_content);
+            jobs.push_back(job);
+            job_message.push_back(i);
+        }
+        
+        CipherEngine::seal_batch(jobs);
+        
+        for (size_t j = 0; j < jobs.size(); ++j) {
+            GroupMessage& msg = sent[job_message[j]];
+            msg.nonce.assign(jobs[j].nonce.begin(), jobs[j].nonce.end());
+            msg.auth_tag.assign(jobs[j].tag.begin(), jobs[j].tag.end());
+        }
+    }
+    
+    for (const auto& msg : sent) {
+        if (!msg.auth_tag.empty()) group.message_history.push_back(msg);
+    }
+    
+    std::cout << "\n=== Group Messages Sent ===" << std::endl;
+    std::cout << "Messages: " << sent.size() << std::endl;
+    std::cout << "Recipients: " << group.members.size() << std::endl;
+    
+    return sent;
+}
+
 std::string GroupChat::receive_message(const Group& group, const GroupMessage& msg,
                                        const std::string& recipient) {
     // Decrypt message
     std::string decrypted = msg.encrypted_content;
-    for (size_t i = 0; i < decrypted.size(); ++i) {
-        decrypted[i] ^= 0x42;
+    {
+        std::lock_guard<std::mutex> lock(group_mutex);
+        CipherEngine* cipher = sender_cipher(group, msg.sender);
+        CipherEngine::Nonce nonce;
+        CipherEngine::Tag tag;
+        if (!cipher || msg.nonce.size() != nonce.size() || msg.auth_tag.size() != tag.size()) {
+            return {};
+        }
+        std::copy(msg.nonce.begin(), msg.nonce.end(), nonce.begin());
+        std::copy(msg.auth_tag.begin(), msg.auth_tag.end(), tag.begin());
+        const auto aad = msg.message_id.bytes();
+        if (!cipher->open(nonce, aad, byte_view(decrypted), byte_view(decrypted), tag)) {
+            std::cout << "[!] Authentication failed for " << msg.message_id.to_string("msg") << std::endl;
+            return {};
+        }
     }
     
     std::cout << "\n=== Message Received ===" << std::endl;
@@ -105,4 +186,20 @@ std::string GroupChat::receive_message(const Group& group, const GroupMessage& m
     return decrypted;
 }
 
+CipherEngine* GroupChat::sender_cipher(const Group& group, const std::string& user_id) {
+    auto cached = sender_ciphers.find({group.group_id, user_id});
+    if (cached != sender_ciphers.end()) {
+        return cached->second.get();
+    }
+    
+    for (const auto& member : group.members) {
+        if (member.user_id == user_id && member.sender_key.size() == CipherEngine::KEY_SIZE) {
+            auto cipher = std::make_unique<CipherEngine>(
+                std::span<const uint8_t, CipherEngine::KEY_SIZE>(member.sender_key.data(), CipherEngine::KEY_SIZE));
+            return sender_ciphers.emplace(std::make_pair(group.group_id, user_id), std::move(cipher)).first->second.get();
+        }
+    }
+    return nullptr;
+}
+
 } // namespace Crypto
@@ -0,0 +1,320 @@
+#include "kademlia.h"
+#include "sha256.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Crypto {
+
+namespace {
+
+constexpr uint32_t NONE = UINT32_MAX;
+
+Kademlia::Key distance(const Kademlia::Key& a, const Kademlia::Key& b) {
+    Kademlia::Key d;
+    for (size_t i = 0; i < d.words.size(); ++i) d.words[i] = a.words[i] ^ b.words[i];
+    return d;
+}
+
+} // namespace
+
+Kademlia::Key Kademlia::Key::of(std::string_view name) {
+    const Sha256::Digest digest =
+        Sha256::hash(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(name.data()), name.size()));
+    Key key;
+    for (size_t i = 0; i < digest.size(); ++i) key.words[i / 8] = (key.words[i / 8] << 8) | digest[i];
+    return key;
+}
+
+int Kademlia::Key::common_prefix(const Key& other) const {
+    for (size_t i = 0; i < words.size(); ++i) {
+        const uint64_t x = words[i] ^ other.words[i];
+        if (x != 0) return static_cast<int>(i * 64) + std::countl_zero(x);
+    }
+    return 256;
+}
+
+Kademlia::Kademlia(const Options& options) : options_(options) {
+    options_.k = std::max<size_t>(options_.k, 1);
+    options_.alpha = std::max<size_t>(options_.alpha, 1);
+}
+
+bool Kademlia::join(const std::string& name, const std::string& bootstrap) {
+    if (index_.contains(name)) return false;
+    NodeIndex via = NONE;
+    if (!bootstrap.empty() && (via = index_of(bootstrap)) == NONE) return false;
+
+    const NodeIndex self = static_cast<NodeIndex>(nodes_.size());
+    Node& node = nodes_.emplace_back();
+    node.name = name;
+    node.id = Key::of(name);
+    index_.emplace(name, self);
+    if (via == NONE) return true;
+
+    if (!rpc(self, via)) {
+        // Nobody learnt of it: it can go again.
+        index_.erase(name);
+        nodes_.pop_back();
+        return false;
+    }
+    lookup(self, nodes_[self].id, nullptr, nullptr, nullptr);
+    return true;
+}
+
+bool Kademlia::contains(const std::string& name) const {
+    return index_.contains(name);
+}
+
+void Kademlia::set_online(const std::string& name, bool online) {
+    const NodeIndex node = index_of(name);
+    if (node != NONE) nodes_[node].online = online;
+}
+
+void Kademlia::set_link(Link link) {
+    link_ = std::move(link);
+}
+
+std::vector<std::string> Kademlia::find_node(const std::string& from, const Key& target, LookupStats* stats) {
+    std::vector<std::string> names;
+    const NodeIndex node = index_of(from);
+    if (node == NONE) return names;
+    for (NodeIndex found : lookup(node, target, nullptr, nullptr, stats)) names.push_back(nodes_[found].name);
+    return names;
+}
+
+size_t Kademlia::store(const std::string& from, const std::string& key, const std::string& value,
+                       LookupStats* stats) {
+    const NodeIndex node = index_of(from);
+    if (node == NONE) return 0;
+    const Key id = Key::of(key);
+    nodes_[node].published[id] = Published{key, value, now_ + options_.republish_interval};
+    return store_at(node, id, value, stats);
+}
+
+std::optional<std::string> Kademlia::find_value(const std::string& from, const std::string& key,
+                                                LookupStats* stats) {
+    const NodeIndex node = index_of(from);
+    if (node == NONE) return std::nullopt;
+    const Key id = Key::of(key);
+
+    const Node& self = nodes_[node];
+    if (auto own = self.published.find(id); own != self.published.end()) return own->second.value;
+    if (auto held = self.records.find(id); held != self.records.end() && held->second.expires > now_) {
+        return held->second.value;
+    }
+    std::optional<std::string> value;
+    lookup(node, id, &id, &value, stats);
+    return value;
+}
+
+void Kademlia::advance(double seconds) {
+    now_ += seconds;
+    std::vector<std::pair<Key, std::string>> due;
+    for (NodeIndex i = 0; i < nodes_.size(); ++i) {
+        Node& node = nodes_[i];
+        for (auto it = node.records.begin(); it != node.records.end();) {
+            if (it->second.expires <= now_) {
+                it = node.records.erase(it);
+                ++stats_.expired;
+            } else {
+                ++it;
+            }
+        }
+        if (!node.online) continue;
+
+        due.clear();
+        for (auto& [id, record] : node.published) {
+            if (record.next_republish > now_) continue;
+            record.next_republish = now_ + options_.republish_interval;
+            due.emplace_back(id, record.value);
+        }
+        for (const auto& [id, value] : due) {
+            store_at(i, id, value, nullptr);
+            ++stats_.republished;
+        }
+    }
+}
+
+size_t Kademlia::contact_count(const std::string& name) const {
+    const NodeIndex node = index_of(name);
+    if (node == NONE) return 0;
+    size_t count = 0;
+    for (const auto& bucket : nodes_[node].buckets) count += bucket.size();
+    return count;
+}
+
+size_t Kademlia::memory_bytes() const {
+    size_t bytes = nodes_.capacity() * sizeof(Node);
+    for (const Node& node : nodes_) {
+        bytes += node.name.capacity();
+        bytes += node.buckets.capacity() * sizeof(node.buckets[0]);
+        for (const auto& bucket : node.buckets) bytes += bucket.capacity() * sizeof(NodeIndex);
+        bytes += node.records.capacity() * (sizeof(Key) + sizeof(Record) + 1);
+        for (const auto& [id, record] : node.records) bytes += record.value.capacity();
+        bytes += node.published.capacity() * (sizeof(Key) + sizeof(Published) + 1);
+    }
+    return bytes;
+}
+
+Kademlia::NodeIndex Kademlia::index_of(const std::string& name) const {
+    auto it = index_.find(name);
+    return it == index_.end() ? NONE : it->second;
+}
+
+bool Kademlia::answers(NodeIndex from, NodeIndex to) {
+    ++stats_.rpcs;
+    const bool ok = nodes_[to].online && (!link_ || link_(nodes_[from].name, nodes_[to].name));
+    if (!ok) ++stats_.failed_rpcs;
+    return ok;
+}
+
+bool Kademlia::rpc(NodeIndex from, NodeIndex to) {
+    if (!answers(from, to)) {
+        forget(from, to);
+        return false;
+    }
+    touch(to, from);
+    touch(from, to);
+    return true;
+}
+
+void Kademlia::touch(NodeIndex node, NodeIndex contact) {
+    if (node == contact) return;
+    Node& self = nodes_[node];
+    const size_t b = static_cast<size_t>(self.id.common_prefix(nodes_[contact].id));
+    if (self.buckets.size() <= b) self.buckets.resize(b + 1);
+    auto& bucket = self.buckets[b];
+
+    auto it = std::find(bucket.begin(), bucket.end(), contact);
+    if (it != bucket.end()) {
+        std::rotate(it, it + 1, bucket.end());  // most recently seen last
+        return;
+    }
+    if (bucket.size() < options_.k) {
+        bucket.push_back(contact);
+        return;
+    }
+    // Full: long-lived contacts are the likeliest to stay, so the newcomer
+    // only gets in when the oldest fails to answer.
+    if (answers(node, bucket.front())) {
+        std::rotate(bucket.begin(), bucket.begin() + 1, bucket.end());
+    } else {
+        bucket.erase(bucket.begin());
+        bucket.push_back(contact);
+    }
+}
+
+void Kademlia::forget(NodeIndex node, NodeIndex contact) {
+    Node& self = nodes_[node];
+    const size_t b = static_cast<size_t>(self.id.common_prefix(nodes_[contact].id));
+    if (b >= self.buckets.size()) return;
+    std::erase(self.buckets[b], contact);
+}
+
+std::vector<Kademlia::NodeIndex> Kademlia::closest(NodeIndex node, const Key& target) const {
+    std::vector<NodeIndex> out;
+    for (const auto& bucket : nodes_[node].buckets) out.insert(out.end(), bucket.begin(), bucket.end());
+    auto nearer = [&](NodeIndex a, NodeIndex b) {
+        return distance(nodes_[a].id, target).words < distance(nodes_[b].id, target).words;
+    };
+    if (out.size() > options_.k) {
+        std::nth_element(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(options_.k), out.end(), nearer);
+        out.resize(options_.k);
+    }
+    return out;
+}
+
+std::vector<Kademlia::NodeIndex> Kademlia::lookup(NodeIndex from, const Key& target, const Key* value_key,
+                                                  std::optional<std::string>* value, LookupStats* stats) {
+    ++stats_.lookups;
+    LookupStats local;
+
+    // Candidates by distance to the target, each queried at most once.
+    std::vector<Candidate> shortlist;
+    FlatHashSet<NodeIndex> seen;
+    seen.insert(from);
+    auto add = [&](NodeIndex node) {
+        if (!seen.insert(node).second) return;
+        Candidate c{distance(nodes_[node].id, target), node, false, false};
+        auto at = std::upper_bound(shortlist.begin(), shortlist.end(), c, [](const Candidate& x, const Candidate& y) {
+            return x.distance.words < y.distance.words;
+        });
+        shortlist.insert(at, c);
+    };
+    auto nearest_live = [&]() -> const Candidate* {
+        for (const Candidate& c : shortlist) {
+            if (!c.failed) return &c;
+        }
+        return nullptr;
+    };
+    for (NodeIndex node : closest(from, target)) add(node);
+
+    std::vector<NodeIndex> batch;
+    const Candidate* best = nearest_live();
+    Key best_distance = best ? best->distance : Key{{~0ull, ~0ull, ~0ull, ~0ull}};
+    bool final_round = false;
+    while (value == nullptr || !value->has_value()) {
+        // alpha of the k nearest live candidates not asked yet; all of them
+        // once the previous round got no closer.
+        batch.clear();
+        const size_t width = final_round ? options_.k : options_.alpha;
+        size_t live = 0;
+        for (Candidate& c : shortlist) {
+            if (c.failed) continue;
+            if (batch.size() == width || live++ == options_.k) break;
+            if (c.queried) continue;
+            c.queried = true;
+            batch.push_back(c.node);
+        }
+        if (batch.empty()) break;
+        ++local.rounds;
+
+        for (NodeIndex node : batch) {
+            ++local.rpcs;
+            if (!rpc(from, node)) {
+                ++local.failed_rpcs;
+                for (Candidate& c : shortlist) {
+                    if (c.node == node) c.failed = true;
+                }
+                continue;
+            }
+            if (value_key != nullptr) {
+                const Node& holder = nodes_[node];
+                auto record = holder.records.find(*value_key);
+                if (record != holder.records.end() && record->second.expires > now_) {
+                    *value = record->second.value;
+                    break;
+                }
+            }
+            for (NodeIndex contact : closest(node, target)) add(contact);
+        }
+
+        best = nearest_live();
+        const bool closer = best != nullptr && best->distance.words < best_distance.words;
+        if (closer) best_distance = best->distance;
+        final_round = !closer;
+    }
+
+    stats_.rounds += local.rounds;
+    if (stats != nullptr) *stats = local;
+
+    std::vector<NodeIndex> found;
+    for (const Candidate& c : shortlist) {
+        if (found.size() == options_.k) break;
+        if (c.queried && !c.failed) found.push_back(c.node);
+    }
+    return found;
+}
+
+size_t Kademlia::store_at(NodeIndex from, const Key& key, const std::string& value, LookupStats* stats) {
+    size_t stored = 0;
+    for (NodeIndex node : lookup(from, key, nullptr, nullptr, stats)) {
+        if (!rpc(from, node)) continue;
+        nodes_[node].records[key] = Record{value, now_ + options_.record_ttl};
+        ++stats_.stores;
+        ++stored;
+    }
+    return stored;
+}
+
+} // namespace Crypto
@@ -1,8 +1,112 @@
 #include "mesh_network.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <numeric>
+#include <stdexcept>
+#include <tuple>
 
 namespace Crypto {
 
-MeshNetwork::MeshNetwork() {}
+namespace {
+
+// Frames between nodes: a type byte, then u16-length-prefixed strings.
+enum FrameType : uint8_t {
+    HELLO = 1,          // from, to: names the node behind a new link
+    ROUTE = 2,          // hop, id, sender, recipient, path, content
+    GOSSIP = 3          // from, id, ttl, origin, content
+};
+
+constexpr auto LINK_TIMEOUT = std::chrono::seconds(5);
+constexpr size_t MAX_PATH = 255;
+
+struct FrameWriter {
+    std::vector<uint8_t> out;
+
+    void u8(uint8_t v) { out.push_back(v); }
+    void u32(uint32_t v) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(v >> shift));
+    }
+    void id(const Id128& v) {
+        const auto b = v.bytes();
+        out.insert(out.end(), b.begin(), b.end());
+    }
+    void str(const std::string& s) {
+        const size_t n = std::min<size_t>(s.size(), UINT16_MAX);
+        out.push_back(static_cast<uint8_t>(n >> 8));
+        out.push_back(static_cast<uint8_t>(n));
+        out.insert(out.end(), s.begin(), s.begin() + static_cast<std::ptrdiff_t>(n));
+    }
+};
+
+struct FrameReader {
+    std::span<const uint8_t> in;
+    size_t pos = 0;
+    bool ok = true;
+
+    bool has(size_t n) {
+        ok = ok && in.size() - pos >= n;
+        return ok;
+    }
+    uint8_t u8() { return has(1) ? in[pos++] : 0; }
+    uint32_t u32() {
+        if (!has(4)) return 0;
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v = (v << 8) | in[pos++];
+        return v;
+    }
+    Id128 id() {
+        Id128 v;
+        if (!has(16)) return v;
+        for (int i = 0; i < 8; ++i) v.hi = (v.hi << 8) | in[pos++];
+        for (int i = 0; i < 8; ++i) v.lo = (v.lo << 8) | in[pos++];
+        return v;
+    }
+    std::string str() {
+        if (!has(2)) return {};
+        const size_t n = (size_t{in[pos]} << 8) | in[pos + 1];
+        pos += 2;
+        return bytes(n);
+    }
+    std::string bytes(size_t n) {
+        if (!has(n)) return {};
+        std::string s(reinterpret_cast<const char*>(in.data() + pos), n);
+        pos += n;
+        return s;
+    }
+};
+
+std::vector<uint8_t> encode_route(const MeshNetwork::Message& msg, size_t hop) {
+    FrameWriter w;
+    w.out.reserve(16 + msg.message_id.size() + msg.sender.size() + msg.recipient.size() +
+                  msg.encrypted_content.size() + msg.path.size() * 16);
+    w.u8(ROUTE);
+    w.u8(static_cast<uint8_t>(hop));
+    w.str(msg.message_id);
+    w.str(msg.sender);
+    w.str(msg.recipient);
+    w.u8(static_cast<uint8_t>(msg.path.size()));
+    for (const auto& node : msg.path) w.str(node);
+    w.u32(static_cast<uint32_t>(msg.encrypted_content.size()));
+    w.out.insert(w.out.end(), msg.encrypted_content.begin(), msg.encrypted_content.end());
+    return std::move(w.out);
+}
+
+} // namespace
+
+MeshNetwork::MeshNetwork() {
+    // DHT calls happen under network_mutex.
+    dht.set_link([this](const std::string&, const std::string& to) {
+        auto node = nodes.find(to);
+        return node != nodes.end() && node->second.is_online;
+    });
+}
+
+MeshNetwork::~MeshNetwork() {
+    stop_transport();
+}
 
 void MeshNetwork::add_node(const std::string& node_id, const std::string& address) {
     std::lock_guard<std::mutex> lock(network_mutex);
@@ -11,24 +115,91 @@ void MeshNetwork::add_node(const std::string& node_id, const std::string& addres
     node.node_id = node_id;
     node.address = address;
     node.is_online = true;
-    node.latency = 10.0 + (rand() % 90);
+    node.latency = 10.0 + (SecureRandom::uniform(90));
     
-    nodes[node_id] = node;
+    Node& stored = nodes[node_id] = std::move(node);
+    router.add_node(node_id, stored.latency);
+    if (!dht.contains(node_id)) {
+        std::string bootstrap;
+        for (const auto& [id, other] : nodes) {
+            if (id != node_id && other.is_online && dht.contains(id)) {
+                bootstrap = id;
+                break;
+            }
+        }
+        if (!dht.join(node_id, bootstrap)) std::cout << "[!] " << node_id << " could not join the DHT" << std::endl;
+    }
+    if (transport) listen_node(stored);
     
     std::cout << "\n=== Node Added ===" << std::endl;
     std::cout << "Node ID: " << node_id << std::endl;
-    std::cout << "Address: " << address << std::endl;
+    std::cout << "Address: " << stored.address << std::endl;
 }
 
 void MeshNetwork::connect_nodes(const std::string& node1, const std::string& node2) {
-    std::lock_guard<std::mutex> lock(network_mutex);
+    std::unique_lock<std::mutex> lock(network_mutex);
     
-    if (nodes.find(node1) != nodes.end() && nodes.find(node2) != nodes.end()) {
-        nodes[node1].peers.push_back(node2);
-        nodes[node2].peers.push_back(node1);
-        
-        std::cout << "\n=== Nodes Connected ===" << std::endl;
-        std::cout << node1 << " <-> " << node2 << std::endl;
+    auto first = nodes.find(node1);
+    auto second = nodes.find(node2);
+    if (first == nodes.end() || second == nodes.end()) return;
+
+    first->second.peers.push_back(node2);
+    second->second.peers.push_back(node1);
+    router.add_link(router.index_of(node1), router.index_of(node2));
+    
+    std::cout << "\n=== Nodes Connected ===" << std::endl;
+    std::cout << node1 << " <-> " << node2 << std::endl;
+
+    if (simulator) link_simulated(first->second, second->second);
+    if (!transport) return;
+    std::string host;
+    uint16_t port = 0;
+    const Transport::ConnectionId link =
+        Transport::split_address(second->second.address, host, port) ? transport->connect(host, port) : 0;
+    if (link == 0) {
+        std::cout << "[!] Cannot reach " << node2 << " at " << second->second.address << std::endl;
+        return;
+    }
+    first->second.links[node2] = link;
+    link_owners[link] = node1;
+
+    FrameWriter hello;
+    hello.u8(HELLO);
+    hello.str(node1);
+    hello.str(node2);
+    transport->send(link, std::move(hello.out));
+
+    // The far end learns the link from HELLO; wait so that traffic can flow
+    // both ways once we return. Node references stay valid: std::map.
+    Node& far = second->second;
+    if (!links_changed.wait_for(lock, LINK_TIMEOUT, [&] { return far.links.contains(node1); })) {
+        std::cout << "[!] Link " << node1 << " -> " << node2 << " not acknowledged" << std::endl;
+    }
+}
+
+void MeshNetwork::disconnect_nodes(const std::string& node1, const std::string& node2) {
+    std::vector<Transport::ConnectionId> closing;
+    {
+        std::lock_guard<std::mutex> lock(network_mutex);
+        auto first = nodes.find(node1);
+        auto second = nodes.find(node2);
+        if (first == nodes.end() || second == nodes.end()) return;
+        if (!router.remove_link(router.index_of(node1), router.index_of(node2))) return;
+
+        std::erase(first->second.peers, node2);
+        std::erase(second->second.peers, node1);
+        auto link = first->second.links.find(node2);
+        if (link != first->second.links.end()) closing.push_back(link->second);
+        link = second->second.links.find(node1);
+        if (link != second->second.links.end()) closing.push_back(link->second);
+
+        std::cout << "\n=== Nodes Disconnected ===" << std::endl;
+        std::cout << node1 << " </> " << node2 << std::endl;
+    }
+    // on_close() takes the lock and drops the links.
+    for (Transport::ConnectionId link : closing) {
+        if (transport) transport->close(link);
+        if (simulator) simulator->close(link);
     }
 }
 
@@ -36,40 +207,127 @@ MeshNetwork::Message MeshNetwork::route_message(const std::string& sender,
                                               const std::string& recipient,
                                               const std::string& message) {
     Message msg;
-    msg.message_id = "msg_" + std::to_string(rand() % 1000000);
+    msg.message_id = Id128::generate().to_string("msg");
     msg.sender = sender;
     msg.recipient = recipient;
     msg.encrypted_content = message;
     
+    std::lock_guard<std::mutex> lock(network_mutex);
+
     std::cout << "\n=== Routing Message ===" << std::endl;
     std::cout << "From: " << sender << std::endl;
     std::cout << "To: " << recipient << std::endl;
     
-    // Simple routing: find path through mesh
-    msg.path.push_back(sender);
-    
-    // Simulate multi-hop routing
-    if (nodes.size() > 2) {
-        for (const auto& [id, node] : nodes) {
-            if (id != sender && id != recipient) {
-                msg.path.push_back(id);
-                if (msg.path.size() >= 3) break;
-            }
-        }
+    const std::vector<MeshRouter::NodeIndex> route =
+        router.path(router.index_of(sender), router.index_of(recipient));
+    if (route.empty()) {
+        msg.path.push_back(sender);
+        std::cout << "[!] No route from " << sender << " to " << recipient << std::endl;
+        return msg;
     }
-    
-    msg.path.push_back(recipient);
+    msg.path.reserve(route.size());
+    for (MeshRouter::NodeIndex hop : route) msg.path.push_back(router.name(hop));
     
     std::cout << "Path: ";
     for (size_t i = 0; i < msg.path.size(); ++i) {
         std::cout << msg.path[i];
         if (i < msg.path.size() - 1) std::cout << " -> ";
     }
-    std::cout << std::endl;
+    std::cout << " (" << router.distance(route.front(), route.back()) << "ms)" << std::endl;
+
+    if (linked() && msg.path.size() > 1 && !forward(msg, 0)) {
+        std::cout << "[!] No link " << msg.path[0] << " -> " << msg.path[1] << ", message dropped" << std::endl;
+    }
     
     return msg;
 }
 
+std::vector<std::string> MeshNetwork::discover_peers(const std::string& node_id, size_t count) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    std::vector<std::string> found;
+    auto node = nodes.find(node_id);
+    if (node == nodes.end()) return found;
+    const auto& peers = node->second.peers;
+    for (auto& name : dht.find_node(node_id, Kademlia::Key::of(node_id))) {
+        if (found.size() == count) break;
+        if (std::find(peers.begin(), peers.end(), name) == peers.end()) found.push_back(std::move(name));
+    }
+    return found;
+}
+
+bool MeshNetwork::publish(const std::string& node_id, const std::string& key, const std::string& value) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    return dht.store(node_id, key, value) > 0;
+}
+
+std::optional<std::string> MeshNetwork::lookup(const std::string& node_id, const std::string& key) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    return dht.find_value(node_id, key);
+}
+
+MeshNetwork::Message MeshNetwork::broadcast(const std::string& origin, const std::string& message) {
+    const Id128 id = Id128::generate();
+    Message msg;
+    msg.message_id = id.to_string("gossip");
+    msg.sender = origin;
+    msg.encrypted_content = message;
+
+    std::vector<std::string> reached;
+    std::function<void(const Message&)> deliver;
+    {
+        std::lock_guard<std::mutex> lock(network_mutex);
+        auto start = nodes.find(origin);
+        if (start == nodes.end()) return msg;
+        accept_gossip(start->second, id);
+        ++gossip_counters.originated;
+        const uint8_t ttl = gossip_options.ttl;
+
+        if (linked()) {
+            for (const auto& peer : gossip_targets(start->second, {})) {
+                send_gossip(start->second, peer, id, ttl, origin, message);
+            }
+            return msg;
+        }
+
+        // No sockets: the same epidemic, one frame at a time in the order
+        // they would be sent. Entries: to, from, hops left.
+        std::deque<std::tuple<std::string, std::string, uint8_t>> frames;
+        for (auto& peer : gossip_targets(start->second, {})) frames.emplace_back(std::move(peer), origin, ttl);
+        while (!frames.empty()) {
+            auto [to, from, hops_left] = std::move(frames.front());
+            frames.pop_front();
+            ++gossip_counters.frames;
+            auto node = nodes.find(to);
+            if (node == nodes.end() || !accept_gossip(node->second, id)) continue;
+            ++gossip_counters.delivered;
+            if (hops_left > 1) {
+                for (auto& peer : gossip_targets(node->second, from)) frames.emplace_back(std::move(peer), to, hops_left - 1);
+            }
+            reached.push_back(std::move(to));
+        }
+        deliver = delivery_handler;
+    }
+
+    if (deliver) {
+        Message copy = msg;
+        for (auto& node : reached) {
+            copy.recipient = std::move(node);
+            deliver(copy);
+        }
+    }
+    return msg;
+}
+
+void MeshNetwork::set_gossip_options(const GossipOptions& options) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    gossip_options = options;
+}
+
+MeshNetwork::GossipStats MeshNetwork::gossip_stats() {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    return gossip_counters;
+}
+
 void MeshNetwork::print_network_topology() {
     std::lock_guard<std::mutex> lock(network_mutex);
     
@@ -85,4 +343,242 @@ void MeshNetwork::print_network_topology() {
     }
 }
 
+bool MeshNetwork::start_transport(const Transport::Options& options) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    if (transport) return true;
+    if (simulator) {
+        std::cout << "[!] Mesh runs on a simulator, transport not started" << std::endl;
+        return false;
+    }
+
+    Transport::Handler handler;
+    handler.on_frame = [this](Transport::ConnectionId id, std::span<const uint8_t> frame) { on_frame(id, frame); };
+    handler.on_close = [this](Transport::ConnectionId id) { on_close(id); };
+    auto t = std::make_unique<Transport>(std::move(handler), options);
+    try {
+        t->start();
+    } catch (const std::runtime_error& e) {
+        std::cout << "[!] Mesh transport unavailable: " << e.what() << std::endl;
+        return false;
+    }
+    transport = std::move(t);
+    for (auto& [id, node] : nodes) listen_node(node);
+
+    std::cout << "[*] Mesh transport started on " << transport->loop_count() << " "
+              << Transport::backend_name(transport->backend()) << " event loop(s)" << std::endl;
+    return true;
+}
+
+void MeshNetwork::stop_transport() {
+    // Without the lock: closing links calls back into on_close().
+    if (!transport) return;
+    transport->stop();
+
+    std::lock_guard<std::mutex> lock(network_mutex);
+    transport.reset();
+    link_owners.clear();
+    for (auto& [id, node] : nodes) node.links.clear();
+}
+
+void MeshNetwork::set_delivery_handler(std::function<void(const Message&)> handler) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    delivery_handler = std::move(handler);
+}
+
+Transport::Stats MeshNetwork::transport_stats() const {
+    return transport ? transport->stats() : Transport::Stats{};
+}
+
+bool MeshNetwork::use_simulator(NetworkSimulator& sim, const NetworkSimulator::LinkModel& link) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    if (transport) return false;
+    if (simulator == &sim) return true;
+
+    Transport::Handler handler;
+    handler.on_frame = [this](Transport::ConnectionId id, std::span<const uint8_t> frame) { on_frame(id, frame); };
+    handler.on_close = [this](Transport::ConnectionId id) { on_close(id); };
+    simulator = &sim;
+    simulator_endpoint = sim.attach(std::move(handler));
+    simulator_link = link;
+    link_owners.clear();
+    for (auto& [id, node] : nodes) node.links.clear();
+    // Each peering once, from the node with the smaller id.
+    for (auto& [id, node] : nodes) {
+        for (const auto& peer : node.peers) {
+            auto other = nodes.find(peer);
+            if (id < peer && other != nodes.end()) link_simulated(node, other->second);
+        }
+    }
+    return true;
+}
+
+void MeshNetwork::listen_node(Node& node) {
+    std::string host;
+    uint16_t port = 0;
+    if (!Transport::split_address(node.address, host, port)) {
+        std::cout << "[!] " << node.node_id << ": address is not host:port, not listening" << std::endl;
+        return;
+    }
+    const uint16_t bound = transport->listen(host, port);
+    if (bound == 0) {
+        std::cout << "[!] " << node.node_id << ": cannot listen on " << node.address << std::endl;
+        return;
+    }
+    node.address = host + ":" + std::to_string(bound);
+}
+
+// Sends msg from path[hop] to path[hop + 1]; the caller holds the lock.
+bool MeshNetwork::forward(const Message& msg, size_t hop) {
+    if (hop + 1 >= msg.path.size() || msg.path.size() > MAX_PATH) return false;
+    auto node = nodes.find(msg.path[hop]);
+    if (node == nodes.end()) return false;
+    auto link = node->second.links.find(msg.path[hop + 1]);
+    if (link == node->second.links.end()) return false;
+    return send_frame(link->second, encode_route(msg, hop + 1));
+}
+
+bool MeshNetwork::send_frame(Transport::ConnectionId link, std::vector<uint8_t>&& frame) {
+    if (transport) return transport->send(link, std::move(frame));
+    return simulator != nullptr && simulator->send(link, std::move(frame));
+}
+
+// Both ends at once: there is no handshake to wait for. The caller holds
+// the lock.
+void MeshNetwork::link_simulated(Node& a, Node& b) {
+    NetworkSimulator::LinkModel model = simulator_link;
+    model.latency = (a.latency + b.latency) / 2 / 1000.0;
+    const auto [ab, ba] = simulator->link(simulator_endpoint, simulator_endpoint, model);
+    if (ab == 0) return;
+    a.links[b.node_id] = ab;
+    b.links[a.node_id] = ba;
+    link_owners[ab] = a.node_id;
+    link_owners[ba] = b.node_id;
+}
+
+bool MeshNetwork::accept_gossip(Node& node, const Id128& id) {
+    if (!node.seen) node.seen = std::make_unique<RotatingBloomFilter>(gossip_options.seen_capacity);
+    if (node.seen->check_and_insert(id)) {
+        ++gossip_counters.duplicates;
+        return false;
+    }
+    return true;
+}
+
+std::vector<std::string> MeshNetwork::gossip_targets(const Node& node, const std::string& from) {
+    std::vector<std::string> targets;
+    std::vector<uint32_t> order(node.peers.size());
+    std::iota(order.begin(), order.end(), 0u);
+    // Partial Fisher-Yates: stops once fanout peers are drawn.
+    for (size_t i = 0; i < order.size() && targets.size() < gossip_options.fanout; ++i) {
+        std::swap(order[i], order[i + SecureRandom::uniform(order.size() - i)]);
+        const std::string& peer = node.peers[order[i]];
+        if (peer != from) targets.push_back(peer);
+    }
+    return targets;
+}
+
+// The caller holds the lock.
+void MeshNetwork::send_gossip(const Node& node, const std::string& peer, const Id128& id, uint8_t ttl,
+                              const std::string& origin, const std::string& content) {
+    auto link = node.links.find(peer);
+    if (link == node.links.end()) return;
+    FrameWriter w;
+    w.out.reserve(32 + node.node_id.size() + origin.size() + content.size());
+    w.u8(GOSSIP);
+    w.str(node.node_id);
+    w.id(id);
+    w.u8(ttl);
+    w.str(origin);
+    w.u32(static_cast<uint32_t>(content.size()));
+    w.out.insert(w.out.end(), content.begin(), content.end());
+    if (send_frame(link->second, std::move(w.out))) ++gossip_counters.frames;
+}
+
+void MeshNetwork::on_frame(Transport::ConnectionId id, std::span<const uint8_t> frame) {
+    FrameReader r{frame};
+    const uint8_t type = r.u8();
+
+    if (type == HELLO) {
+        std::string from = r.str();
+        std::string to = r.str();
+        if (!r.ok) return;
+        std::lock_guard<std::mutex> lock(network_mutex);
+        auto node = nodes.find(to);
+        if (node == nodes.end()) return;
+        node->second.links[from] = id;
+        link_owners[id] = to;
+        links_changed.notify_all();
+        return;
+    }
+
+    if (type == GOSSIP) {
+        const std::string from = r.str();
+        const Id128 gossip_id = r.id();
+        const uint8_t ttl = r.u8();
+        Message msg;
+        msg.sender = r.str();
+        msg.encrypted_content = r.bytes(r.u32());
+        if (!r.ok) return;
+
+        std::function<void(const Message&)> deliver;
+        {
+            std::lock_guard<std::mutex> lock(network_mutex);
+            auto owner = link_owners.find(id);
+            if (owner == link_owners.end()) return;
+            auto node = nodes.find(owner->second);
+            if (node == nodes.end() || !accept_gossip(node->second, gossip_id)) return;
+            ++gossip_counters.delivered;
+            if (ttl > 1) {
+                for (const auto& peer : gossip_targets(node->second, from)) {
+                    send_gossip(node->second, peer, gossip_id, ttl - 1, msg.sender, msg.encrypted_content);
+                }
+            }
+            msg.recipient = node->first;
+            deliver = delivery_handler;
+        }
+        msg.message_id = gossip_id.to_string("gossip");
+        if (deliver) deliver(msg);
+        return;
+    }
+
+    if (type != ROUTE) return;
+    Message msg;
+    const size_t hop = r.u8();
+    msg.message_id = r.str();
+    msg.sender = r.str();
+    msg.recipient = r.str();
+    const size_t hops = r.u8();
+    msg.path.reserve(hops);
+    for (size_t i = 0; i < hops && r.ok; ++i) msg.path.push_back(r.str());
+    msg.encrypted_content = r.bytes(r.u32());
+    if (!r.ok || hop >= msg.path.size()) return;
+
+    std::function<void(const Message&)> deliver;
+    {
+        std::lock_guard<std::mutex> lock(network_mutex);
+        auto owner = link_owners.find(id);
+        if (owner == link_owners.end() || owner->second != msg.path[hop]) return;
+        if (hop + 1 < msg.path.size()) {
+            forward(msg, hop);
+            return;
+        }
+        deliver = delivery_handler;
+    }
+    if (deliver) deliver(msg);
+}
+
+void MeshNetwork::on_close(Transport::ConnectionId id) {
+    std::lock_guard<std::mutex> lock(network_mutex);
+    auto owner = link_owners.find(id);
+    if (owner == link_owners.end()) return;
+    auto node = nodes.find(owner->second);
+    if (node != nodes.end()) {
+        for (auto it = node->second.links.begin(); it != node->second.links.end();) {
+            it = it->second == id ? node->second.links.erase(it) : std::next(it);
+        }
+    }
+    link_owners.erase(owner);
+    links_changed.notify_all();
+}
+
 } // namespace Crypto
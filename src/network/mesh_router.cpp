@@ -0,0 +1,296 @@
+#include "mesh_router.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Crypto {
+
+namespace {
+
+constexpr uint32_t MIN_ROOM = 4;                // neighbour slots per node
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+} // namespace
+
+// Non-negative floats order like their bit patterns.
+void MeshRouter::Queue::push(float dist, NodeIndex node) {
+    const uint32_t key = std::bit_cast<uint32_t>(dist);
+    const int bucket = key == last ? 0 : 32 - std::countl_zero(key ^ last);
+    buckets[bucket].push_back((uint64_t{key} << 32) | node);
+    ++size;
+}
+
+uint64_t MeshRouter::Queue::pop() {
+    if (buckets[0].empty()) {
+        // Redistribute the first non-empty bucket around its minimum; they
+        // all land in lower buckets.
+        size_t i = 1;
+        while (buckets[i].empty()) ++i;
+        last = static_cast<uint32_t>(*std::min_element(buckets[i].begin(), buckets[i].end()) >> 32);
+        for (uint64_t entry : buckets[i]) {
+            const uint32_t key = static_cast<uint32_t>(entry >> 32);
+            buckets[key == last ? 0 : 32 - std::countl_zero(key ^ last)].push_back(entry);
+        }
+        buckets[i].clear();
+    }
+    const uint64_t entry = buckets[0].back();
+    buckets[0].pop_back();
+    --size;
+    return entry;
+}
+
+void MeshRouter::Queue::clear() {
+    for (auto& bucket : buckets) bucket.clear();
+    last = 0;
+    size = 0;
+}
+
+MeshRouter::MeshRouter(size_t max_tables) : max_tables_(std::max<size_t>(max_tables, 1)) {}
+
+MeshRouter::NodeIndex MeshRouter::add_node(const std::string& id, double latency) {
+    auto it = index_.find(id);
+    if (it != index_.end()) {
+        latency_[it->second] = static_cast<float>(latency);
+        clear_tables();                         // every link cost of the node changed
+        return it->second;
+    }
+
+    const NodeIndex node = static_cast<NodeIndex>(names_.size());
+    names_.push_back(id);
+    index_.emplace(id, node);
+    latency_.push_back(static_cast<float>(latency));
+    begin_.push_back(static_cast<uint32_t>(targets_.size()));
+    degree_.push_back(0);
+    room_.push_back(MIN_ROOM);
+    targets_.resize(targets_.size() + MIN_ROOM, NONE);
+    table_of_.push_back(NONE);
+    in_subtree_.push_back(0);
+    for (Table& t : tables_) {
+        t.dist.push_back(INF);
+        t.parent.push_back(NONE);
+        t.first.push_back(NONE);
+    }
+    return node;
+}
+
+MeshRouter::NodeIndex MeshRouter::index_of(const std::string& id) const {
+    auto it = index_.find(id);
+    return it == index_.end() ? NONE : it->second;
+}
+
+bool MeshRouter::has_link(NodeIndex a, NodeIndex b) const {
+    if (a >= names_.size() || b >= names_.size()) return false;
+    // Search from the end with fewer neighbours.
+    if (degree_[b] < degree_[a]) std::swap(a, b);
+    const NodeIndex* first = targets_.data() + begin_[a];
+    return std::find(first, first + degree_[a], b) != first + degree_[a];
+}
+
+bool MeshRouter::add_link(NodeIndex a, NodeIndex b) {
+    if (a == b || a >= names_.size() || b >= names_.size() || has_link(a, b)) return false;
+    insert_target(a, b);
+    insert_target(b, a);
+    ++links_;
+    for (Table& t : tables_) link_added(t, a, b);
+    return true;
+}
+
+bool MeshRouter::remove_link(NodeIndex a, NodeIndex b) {
+    if (a >= names_.size() || b >= names_.size() || !erase_target(a, b)) return false;
+    erase_target(b, a);
+    --links_;
+    for (Table& t : tables_) link_removed(t, a, b);
+    return true;
+}
+
+MeshRouter::NodeIndex MeshRouter::next_hop(NodeIndex from, NodeIndex to) {
+    if (from >= names_.size() || to >= names_.size() || from == to) return NONE;
+    return table(from).first[to];
+}
+
+double MeshRouter::distance(NodeIndex from, NodeIndex to) {
+    if (from >= names_.size() || to >= names_.size()) return std::numeric_limits<double>::infinity();
+    if (from == to) return 0.0;
+    return table(from).dist[to];
+}
+
+std::vector<MeshRouter::NodeIndex> MeshRouter::path(NodeIndex from, NodeIndex to) {
+    std::vector<NodeIndex> hops;
+    if (from >= names_.size() || to >= names_.size()) return hops;
+    if (from == to) return {from};
+    const Table& t = table(from);
+    if (t.dist[to] == INF) return hops;
+    for (NodeIndex node = to; node != NONE; node = t.parent[node]) hops.push_back(node);
+    std::reverse(hops.begin(), hops.end());
+    return hops;
+}
+
+void MeshRouter::clear_tables() {
+    for (const Table& t : tables_) table_of_[t.source] = NONE;
+    tables_.clear();
+}
+
+MeshRouter::Stats MeshRouter::stats() const {
+    Stats s = stats_;
+    s.tables = tables_.size();
+    s.graph_bytes = (begin_.size() + degree_.size() + room_.size() + targets_.size() + latency_.size()) * sizeof(uint32_t);
+    s.table_bytes = tables_.size() * names_.size() * (sizeof(float) + 2 * sizeof(NodeIndex));
+    return s;
+}
+
+void MeshRouter::insert_target(NodeIndex node, NodeIndex target) {
+    if (degree_[node] == room_[node]) {
+        // Move to the end with twice the room; the old range is dead.
+        const uint32_t begin = static_cast<uint32_t>(targets_.size());
+        targets_.resize(targets_.size() + 2 * room_[node], NONE);
+        std::copy_n(targets_.begin() + begin_[node], degree_[node], targets_.begin() + begin);
+        abandoned_ += room_[node];
+        begin_[node] = begin;
+        room_[node] *= 2;
+        if (abandoned_ > targets_.size() / 2) compact();
+    }
+    targets_[begin_[node] + degree_[node]++] = target;
+}
+
+bool MeshRouter::erase_target(NodeIndex node, NodeIndex target) {
+    NodeIndex* first = targets_.data() + begin_[node];
+    NodeIndex* last = first + degree_[node];
+    NodeIndex* it = std::find(first, last, target);
+    if (it == last) return false;
+    *it = *(last - 1);                          // order within a node does not matter
+    --degree_[node];
+    return true;
+}
+
+void MeshRouter::compact() {
+    // Back to index order, which is also the order Dijkstra tends to scan
+    // a node's neighbours in.
+    std::vector<NodeIndex> targets;
+    targets.reserve(targets_.size() - abandoned_);
+    for (size_t i = 0; i < names_.size(); ++i) {
+        const uint32_t begin = static_cast<uint32_t>(targets.size());
+        targets.insert(targets.end(), targets_.begin() + begin_[i], targets_.begin() + begin_[i] + degree_[i]);
+        targets.resize(begin + room_[i], NONE);
+        begin_[i] = begin;
+    }
+    targets_ = std::move(targets);
+    abandoned_ = 0;
+}
+
+MeshRouter::Table& MeshRouter::table(NodeIndex source) {
+    if (table_of_[source] != NONE) {
+        Table& t = tables_[table_of_[source]];
+        t.last_used = ++clock_;
+        return t;
+    }
+
+    uint32_t slot;
+    if (tables_.size() < max_tables_) {
+        slot = static_cast<uint32_t>(tables_.size());
+        tables_.emplace_back();
+    } else {
+        auto oldest = std::min_element(tables_.begin(), tables_.end(),
+                                       [](const Table& x, const Table& y) { return x.last_used < y.last_used; });
+        slot = static_cast<uint32_t>(oldest - tables_.begin());
+        table_of_[oldest->source] = NONE;
+    }
+    Table& t = tables_[slot];
+    t.source = source;
+    t.last_used = ++clock_;
+    table_of_[source] = slot;
+    build(t);
+    return t;
+}
+
+void MeshRouter::build(Table& t) {
+    const size_t n = names_.size();
+    t.dist.assign(n, INF);
+    t.parent.assign(n, NONE);
+    t.first.assign(n, NONE);
+    t.dist[t.source] = 0.0f;
+    queue_.clear();
+    queue_.push(0.0f, t.source);
+    propagate(t);
+    ++stats_.full_builds;
+}
+
+void MeshRouter::relax(Table& t, NodeIndex via, NodeIndex node, float dist) {
+    if (dist >= t.dist[node]) return;
+    t.dist[node] = dist;
+    t.parent[node] = via;
+    t.first[node] = via == t.source ? node : t.first[via];
+    queue_.push(dist, node);
+}
+
+void MeshRouter::propagate(Table& t) {
+    while (queue_.size != 0) {
+        const uint64_t key = queue_.pop();
+        const NodeIndex node = static_cast<NodeIndex>(key);
+        const float dist = std::bit_cast<float>(static_cast<uint32_t>(key >> 32));
+        if (dist > t.dist[node]) continue;      // superseded by a later push
+        ++stats_.nodes_settled;
+
+        const NodeIndex* first = targets_.data() + begin_[node];
+        for (const NodeIndex* it = first; it != first + degree_[node]; ++it) {
+            relax(t, node, *it, dist + cost(node, *it));
+        }
+    }
+}
+
+void MeshRouter::link_added(Table& t, NodeIndex a, NodeIndex b) {
+    // Only paths through the new link get shorter, and they all start by
+    // reaching a or b the old way.
+    queue_.clear();
+    const float w = cost(a, b);
+    if (t.dist[a] != INF) relax(t, a, b, t.dist[a] + w);
+    if (t.dist[b] != INF) relax(t, b, a, t.dist[b] + w);
+    if (queue_.size == 0) return;
+    propagate(t);
+    ++stats_.incremental_updates;
+}
+
+void MeshRouter::link_removed(Table& t, NodeIndex a, NodeIndex b) {
+    NodeIndex root;
+    if (t.parent[b] == a) {
+        root = b;
+    } else if (t.parent[a] == b) {
+        root = a;
+    } else {
+        return;                                 // not on any shortest path we hold
+    }
+
+    // Everything below the cut edge lost its route; nothing else did.
+    subtree_.clear();
+    subtree_.push_back(root);
+    in_subtree_[root] = 1;
+    for (size_t i = 0; i < subtree_.size(); ++i) {
+        const NodeIndex node = subtree_[i];
+        const NodeIndex* first = targets_.data() + begin_[node];
+        for (const NodeIndex* it = first; it != first + degree_[node]; ++it) {
+            if (t.parent[*it] == node && !in_subtree_[*it]) {
+                in_subtree_[*it] = 1;
+                subtree_.push_back(*it);
+            }
+        }
+    }
+    for (NodeIndex node : subtree_) {
+        t.dist[node] = INF;
+        t.parent[node] = NONE;
+        t.first[node] = NONE;
+    }
+
+    // Re-enter the subtree from its border with the rest of the tree.
+    queue_.clear();
+    for (NodeIndex node : subtree_) {
+        const NodeIndex* first = targets_.data() + begin_[node];
+        for (const NodeIndex* it = first; it != first + degree_[node]; ++it) {
+            if (!in_subtree_[*it] && t.dist[*it] != INF) relax(t, *it, node, t.dist[*it] + cost(*it, node));
+        }
+    }
+    for (NodeIndex node : subtree_) in_subtree_[node] = 0;
+    propagate(t);
+    ++stats_.incremental_updates;
+}
+
+} // namespace Crypto
@@ -0,0 +1,264 @@
+#include "network_simulator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+namespace Crypto {
+
+NetworkSimulator::NetworkSimulator(uint64_t seed) : rng_(seed) {}
+
+uint64_t NetworkSimulator::to_ns(double seconds) {
+    return seconds > 0 ? static_cast<uint64_t>(std::llround(seconds * 1e9)) : 0;
+}
+
+// The event queue is a 4-ary min-heap: half the depth of a binary heap,
+// and a node's four children share a cache line or two.
+void NetworkSimulator::push(uint64_t time, EventKind kind, uint32_t slot) {
+    const Event event{time, seq_++, slot, kind};
+    size_t i = heap_.size();
+    heap_.push_back(event);
+    while (i > 0) {
+        const size_t parent = (i - 1) / 4;
+        if (!Later{}(heap_[parent], event)) break;
+        heap_[i] = heap_[parent];
+        i = parent;
+    }
+    heap_[i] = event;
+    stats_.max_pending = std::max(stats_.max_pending, heap_.size());
+}
+
+NetworkSimulator::Event NetworkSimulator::pop() {
+    const Event top = heap_.front();
+    const Event last = heap_.back();
+    heap_.pop_back();
+    const size_t n = heap_.size();
+    if (n == 0) return top;
+    size_t i = 0;
+    for (;;) {
+        const size_t first = 4 * i + 1;
+        if (first >= n) break;
+        size_t best = first;
+        const size_t end = std::min(first + 4, n);
+        for (size_t c = first + 1; c < end; ++c) {
+            if (Later{}(heap_[best], heap_[c])) best = c;
+        }
+        if (!Later{}(last, heap_[best])) break;
+        heap_[i] = heap_[best];
+        i = best;
+    }
+    heap_[i] = last;
+    return top;
+}
+
+void NetworkSimulator::schedule(double delay, std::function<void()> fn) {
+    uint32_t slot;
+    if (free_timers_.empty()) {
+        slot = static_cast<uint32_t>(timers_.size());
+        timers_.push_back(std::move(fn));
+    } else {
+        slot = free_timers_.back();
+        free_timers_.pop_back();
+        timers_[slot] = std::move(fn);
+    }
+    push(now_ + to_ns(delay), EventKind::Timer, slot);
+}
+
+size_t NetworkSimulator::run() {
+    size_t ran = 0;
+    while (!heap_.empty()) {
+        const Event event = pop();
+        now_ = event.time;
+        dispatch(event);
+        ++ran;
+    }
+    stats_.events += ran;
+    return ran;
+}
+
+size_t NetworkSimulator::run_until(double until) {
+    const uint64_t end = to_ns(until);
+    size_t ran = 0;
+    while (!heap_.empty() && heap_.front().time <= end) {
+        const Event event = pop();
+        now_ = event.time;
+        dispatch(event);
+        ++ran;
+    }
+    now_ = std::max(now_, end);
+    stats_.events += ran;
+    return ran;
+}
+
+void NetworkSimulator::dispatch(const Event& event) {
+    switch (event.kind) {
+    case EventKind::Timer: {
+        // The callback may schedule more (and reuse the slot).
+        std::function<void()> fn = std::move(timers_[event.slot]);
+        timers_[event.slot] = nullptr;
+        free_timers_.push_back(event.slot);
+        fn();
+        break;
+    }
+    case EventKind::Frame: {
+        // The handler may send (and reuse the slot): take the frame out.
+        InFlight in = std::move(frames_[event.slot]);
+        free_frames_.push_back(event.slot);
+        Connection* to = find(in.to);
+        if (to == nullptr || !to->open) {
+            ++stats_.frames_dropped;
+            break;
+        }
+        ++stats_.frames_delivered;
+        stats_.bytes_delivered += in.frame.size();
+        const auto& handler = endpoints_[to->owner];
+        if (handler.on_frame) handler.on_frame(in.to, in.frame);
+        break;
+    }
+    case EventKind::Close: {
+        const ConnectionId id = event.slot + 1;
+        Connection* conn = find(id);
+        if (conn == nullptr || !conn->open) break;
+        conn->open = false;
+        const auto& handler = endpoints_[conn->owner];
+        if (handler.on_close) handler.on_close(id);
+        break;
+    }
+    }
+}
+
+NetworkSimulator::Endpoint NetworkSimulator::attach(Transport::Handler handler) {
+    endpoints_.push_back(std::move(handler));
+    return static_cast<Endpoint>(endpoints_.size() - 1);
+}
+
+std::pair<NetworkSimulator::ConnectionId, NetworkSimulator::ConnectionId>
+NetworkSimulator::link(Endpoint a, Endpoint b, const LinkModel& a_to_b, const LinkModel& b_to_a) {
+    if (a >= endpoints_.size() || b >= endpoints_.size()) return {0, 0};
+    const ConnectionId first = connections_.size() + 1;
+    const ConnectionId second = first + 1;
+    connections_.push_back(Connection{a, second, a_to_b});
+    connections_.push_back(Connection{b, first, b_to_a});
+    const auto& on_open_a = endpoints_[a].on_open;
+    const auto& on_open_b = endpoints_[b].on_open;
+    if (on_open_a) on_open_a(first, false);
+    if (on_open_b) on_open_b(second, true);
+    return {first, second};
+}
+
+NetworkSimulator::Connection* NetworkSimulator::find(ConnectionId id) {
+    return id == 0 || id > connections_.size() ? nullptr : &connections_[id - 1];
+}
+
+bool NetworkSimulator::send(ConnectionId id, std::span<const uint8_t> frame) {
+    return send(id, std::vector<uint8_t>(frame.begin(), frame.end()));
+}
+
+bool NetworkSimulator::send(ConnectionId id, std::vector<uint8_t>&& frame) {
+    Connection* conn = find(id);
+    if (conn == nullptr || !conn->open) return false;
+    const LinkModel& model = conn->model;
+    ++stats_.frames_sent;
+
+    uint64_t departure = now_;
+    if (model.bandwidth > 0) {
+        const uint64_t start = std::max(now_, conn->busy_until);
+        const double backlog = static_cast<double>(start - now_) * 1e-9 * model.bandwidth;
+        if (backlog > static_cast<double>(model.queue_limit)) {
+            ++stats_.frames_dropped;
+            return false;
+        }
+        departure = start + to_ns(static_cast<double>(frame.size()) / model.bandwidth);
+        conn->busy_until = departure;
+    }
+    if (model.loss > 0 && uniform_real() < model.loss) {
+        ++stats_.frames_lost;
+        return true;    // the sender cannot tell
+    }
+    uint64_t arrival = departure + to_ns(model.latency);
+    if (model.jitter > 0) arrival += to_ns(model.jitter * uniform_real());
+    arrival = std::max(arrival, conn->last_arrival);
+    conn->last_arrival = arrival;
+
+    uint32_t slot;
+    if (free_frames_.empty()) {
+        slot = static_cast<uint32_t>(frames_.size());
+        frames_.push_back(InFlight{conn->peer, std::move(frame)});
+    } else {
+        slot = free_frames_.back();
+        free_frames_.pop_back();
+        frames_[slot].to = conn->peer;
+        frames_[slot].frame = std::move(frame);
+    }
+    push(arrival, EventKind::Frame, slot);
+    return true;
+}
+
+void NetworkSimulator::close(ConnectionId id) {
+    Connection* conn = find(id);
+    if (conn == nullptr || !conn->open) return;
+    conn->open = false;
+    const ConnectionId peer = conn->peer;
+    const uint64_t latency = to_ns(conn->model.latency);
+    const auto& handler = endpoints_[conn->owner];
+    if (handler.on_close) handler.on_close(id);
+    // Behind whatever is still in flight towards the far end.
+    push(std::max(now_ + latency, conn->last_arrival), EventKind::Close, static_cast<uint32_t>(peer - 1));
+}
+
+void DeliveryTracker::sent(const std::string& id, double at) {
+    if (sent_ == 0) first_ = at;
+    ++sent_;
+    sent_at_[id] = at;
+}
+
+bool DeliveryTracker::delivered(const std::string& id, double at) {
+    auto it = sent_at_.find(id);
+    if (it == sent_at_.end()) return false;
+    latencies_.push_back(at - it->second);
+    last_ = std::max(last_, at);
+    return true;
+}
+
+void DeliveryTracker::forget(const std::string& id) {
+    sent_at_.erase(id);
+}
+
+DeliveryTracker::Summary DeliveryTracker::summary() {
+    Summary s;
+    s.sent = sent_;
+    s.delivered = latencies_.size();
+    if (latencies_.empty()) return s;
+    s.span = last_ - first_;
+    s.throughput = s.span > 0 ? static_cast<double>(s.delivered) / s.span : 0;
+    auto rank = [&](size_t permille) {
+        const size_t at = std::min(latencies_.size() - 1, latencies_.size() * permille / 1000);
+        std::nth_element(latencies_.begin(), latencies_.begin() + static_cast<std::ptrdiff_t>(at), latencies_.end());
+        return latencies_[at];
+    };
+    s.p50 = rank(500);
+    s.p99 = rank(990);
+    s.max = *std::max_element(latencies_.begin(), latencies_.end());
+    return s;
+}
+
+void DeliveryTracker::clear() {
+    sent_at_.clear();
+    latencies_.clear();
+    sent_ = 0;
+    first_ = last_ = 0;
+}
+
+size_t heap_bytes_in_use() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    const struct mallinfo2 info = ::mallinfo2();
+    return info.uordblks + info.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+} // namespace Crypto
@@ -1,4 +1,5 @@
 #include "secure_authentication.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -60,11 +61,12 @@ bool SecureAuthentication::verify_biometric(const std::string& user_id, const st
     return true;
 }
 
-bool SecureAuthentication::logout(const std::string& session_id) {
-    std::cout << "[*] Logging out session: " << session_id << std::endl;
+bool SecureAuthentication::logout(const Id128& session_id) {
+    std::cout << "[*] Logging out session: " << session_id.to_string("session") << std::endl;
     
-    if (sessions_.find(session_id) != sessions_.end()) {
-        sessions_[session_id].is_active = false;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second.is_active = false;
         return true;
     }
     
@@ -75,7 +77,7 @@ std::vector<MFAMethod> SecureAuthentication::get_mfa_methods(const std::string&
     std::vector<MFAMethod> methods;
     
     MFAMethod totp;
-    totp.method_id = "MFA_" + std::to_string(rand() % 100000);
+    totp.method_id = Id128::generate();
     totp.method_type = "totp";
     totp.identifier = "Authenticator App";
     totp.is_verified = true;
@@ -89,7 +91,7 @@ std::vector<MFAMethod> SecureAuthentication::get_mfa_methods(const std::string&
 MFAMethod SecureAuthentication::add_mfa_method(const std::string& user_id, const std::string& method_type,
                                             const std::string& identifier) {
     MFAMethod method;
-    method.method_id = "MFA_" + std::to_string(rand() % 100000);
+    method.method_id = Id128::generate();
     method.method_type = method_type;
     method.identifier = identifier;
     method.is_verified = false;
@@ -103,19 +105,19 @@ MFAMethod SecureAuthentication::add_mfa_method(const std::string& user_id, const
     return method;
 }
 
-bool SecureAuthentication::verify_mfa_method(const std::string& method_id, const std::string& code) {
-    std::cout << "[*] Verifying MFA method: " << method_id << std::endl;
+bool SecureAuthentication::verify_mfa_method(const Id128& method_id, const std::string& code) {
+    std::cout << "[*] Verifying MFA method: " << method_id.to_string("mfa") << std::endl;
     return true;
 }
 
-bool SecureAuthentication::remove_mfa_method(const std::string& method_id) {
-    std::cout << "[*] Removing MFA method: " << method_id << std::endl;
+bool SecureAuthentication::remove_mfa_method(const Id128& method_id) {
+    std::cout << "[*] Removing MFA method: " << method_id.to_string("mfa") << std::endl;
     return true;
 }
 
 AuthSession SecureAuthentication::create_session(const std::string& user_id, const std::string& auth_method) {
     AuthSession session;
-    session.session_id = generate_session_id();
+    session.session_id = Id128::generate();
     session.user_id = user_id;
     session.auth_method = auth_method;
     session.created_at = time(nullptr);
@@ -126,27 +128,29 @@ AuthSession SecureAuthentication::create_session(const std::string& user_id, con
     
     sessions_[session.session_id] = session;
     
-    std::cout << "[+] Session created: " << session.session_id << std::endl;
+    std::cout << "[+] Session created: " << session.session_id.to_string("session") << std::endl;
     
     return session;
 }
 
-bool SecureAuthentication::validate_session(const std::string& session_id) {
-    std::cout << "[*] Validating session: " << session_id << std::endl;
+bool SecureAuthentication::validate_session(const Id128& session_id) {
+    std::cout << "[*] Validating session: " << session_id.to_string("session") << std::endl;
     
-    if (sessions_.find(session_id) != sessions_.end()) {
-        return sessions_[session_id].is_active && 
-               sessions_[session_id].expires_at > time(nullptr);
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        return it->second.is_active && 
+               it->second.expires_at > time(nullptr);
     }
     
     return false;
 }
 
-bool SecureAuthentication::revoke_session(const std::string& session_id) {
-    std::cout << "[*] Revoking session: " << session_id << std::endl;
+bool SecureAuthentication::revoke_session(const Id128& session_id) {
+    std::cout << "[*] Revoking session: " << session_id.to_string("session") << std::endl;
     
-    if (sessions_.find(session_id) != sessions_.end()) {
-        sessions_[session_id].is_active = false;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second.is_active = false;
         return true;
     }
     
@@ -197,9 +201,8 @@ std::string SecureAuthentication::generate_secure_password(uint32_t length) {
     const std::string charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789!@#$%^&*()_+-=[]{}|;:,.<>?";
     std::string password;
     
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
     for (uint32_t i = 0; i < length; i++) {
-        password += charset[std::rand() % charset.length()];
+        password += charset[SecureRandom::uniform(charset.length())];
     }
     
     return password;
@@ -229,11 +232,12 @@ uint32_t SecureAuthentication::calculate_risk_score(const std::string& user_id,
     return std::min(risk_score, 100u);
 }
 
-void SecureAuthentication::trigger_step_up_auth(const std::string& session_id, uint32_t required_level) {
-    std::cout << "[*] Triggering step-up auth for session: " << session_id << std::endl;
+void SecureAuthentication::trigger_step_up_auth(const Id128& session_id, uint32_t required_level) {
+    std::cout << "[*] Triggering step-up auth for session: " << session_id.to_string("session") << std::endl;
     
-    if (sessions_.find(session_id) != sessions_.end()) {
-        sessions_[session_id].is_mfa_verified = false;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second.is_mfa_verified = false;
     }
 }
 
@@ -264,8 +268,4 @@ std::string SecureAuthentication::hash_password(const std::string& password) {
     return "hashed_" + password;
 }
 
-std::string SecureAuthentication::generate_session_id() {
-    return "session_" + std::to_string(rand() % 1000000);
-}
-
 } // namespace Crypto
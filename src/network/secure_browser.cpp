@@ -1,4 +1,5 @@
 #include "secure_browser.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -23,9 +24,9 @@ bool SecureBrowser::initialize() {
 
 BrowserProfile SecureBrowser::create_profile(const std::string& name) {
     BrowserProfile profile;
-    profile.profile_id = "profile_" + std::to_string(rand() % 1000000);
+    profile.profile_id = Id128::generate();
     profile.profile_name = name;
-    profile.encryption_key = "key_" + std::to_string(rand() % 1000000);
+    profile.encryption_key = "key_" + std::to_string(SecureRandom::uniform(1000000));
     profile.created_at = time(nullptr);
     profile.last_used = time(nullptr);
     profile.private_mode = false;
@@ -37,57 +38,58 @@ BrowserProfile SecureBrowser::create_profile(const std::string& name) {
     return profile;
 }
 
-bool SecureBrowser::switch_profile(const std::string& profile_id) {
-    std::cout << "[*] Switching to profile: " << profile_id << std::endl;
+bool SecureBrowser::switch_profile(const Id128& profile_id) {
+    std::cout << "[*] Switching to profile: " << profile_id.to_string("profile") << std::endl;
     
-    if (profiles_.find(profile_id) != profiles_.end()) {
-        profiles_[profile_id].last_used = time(nullptr);
+    auto it = profiles_.find(profile_id);
+    if (it != profiles_.end()) {
+        it->second.last_used = time(nullptr);
         return true;
     }
     
     return false;
 }
 
-bool SecureBrowser::delete_profile(const std::string& profile_id) {
-    std::cout << "[*] Deleting profile: " << profile_id << std::endl;
+bool SecureBrowser::delete_profile(const Id128& profile_id) {
+    std::cout << "[*] Deleting profile: " << profile_id.to_string("profile") << std::endl;
     
-    if (profiles_.find(profile_id) != profiles_.end()) {
-        profiles_.erase(profile_id);
+    if (profiles_.erase(profile_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-std::string SecureBrowser::open_secure_tab(const std::string& url, const std::string& profile_id) {
-    std::string tab_id = generate_tab_id();
+Id128 SecureBrowser::open_secure_tab(const std::string& url, const Id128& profile_id) {
+    const Id128 tab_id = Id128::generate();
     
     std::cout << "[+] Opening secure tab: " << url << std::endl;
     
     return tab_id;
 }
 
-bool SecureBrowser::close_tab(const std::string& tab_id) {
-    std::cout << "[*] Closing tab: " << tab_id << std::endl;
+bool SecureBrowser::close_tab(const Id128& tab_id) {
+    std::cout << "[*] Closing tab: " << tab_id.to_string("tab") << std::endl;
     return true;
 }
 
-std::vector<std::string> SecureBrowser::get_open_tabs(const std::string& profile_id) {
-    std::vector<std::string> tabs;
-    std::cout << "[*] Getting open tabs for: " << profile_id << std::endl;
+std::vector<Id128> SecureBrowser::get_open_tabs(const Id128& profile_id) {
+    std::vector<Id128> tabs;
+    std::cout << "[*] Getting open tabs for: " << profile_id.to_string("profile") << std::endl;
     return tabs;
 }
 
-SecureBookmark SecureBrowser::add_bookmark(const std::string& profile_id, const std::string& title, const std::string& url) {
+SecureBookmark SecureBrowser::add_bookmark(const Id128& profile_id, const std::string& title, const std::string& url) {
     SecureBookmark bookmark;
-    bookmark.bookmark_id = generate_bookmark_id();
+    bookmark.bookmark_id = Id128::generate();
     bookmark.title = title;
     bookmark.encrypted_url = encrypt_url(url);
     bookmark.visit_count = 1;
     bookmark.last_visited = time(nullptr);
     
-    if (profiles_.find(profile_id) != profiles_.end()) {
-        profiles_[profile_id].bookmarks.push_back(bookmark.bookmark_id);
+    auto it = profiles_.find(profile_id);
+    if (it != profiles_.end()) {
+        it->second.bookmarks.push_back(bookmark.bookmark_id);
     }
     
     std::cout << "[+] Bookmark added: " << title << std::endl;
@@ -95,14 +97,14 @@ SecureBookmark SecureBrowser::add_bookmark(const std::string& profile_id, const
     return bookmark;
 }
 
-bool SecureBrowser::remove_bookmark(const std::string& bookmark_id) {
-    std::cout << "[*] Removing bookmark: " << bookmark_id << std::endl;
+bool SecureBrowser::remove_bookmark(const Id128& bookmark_id) {
+    std::cout << "[*] Removing bookmark: " << bookmark_id.to_string("bookmark") << std::endl;
     return true;
 }
 
-std::vector<SecureBookmark> SecureBrowser::get_bookmarks(const std::string& profile_id) {
+std::vector<SecureBookmark> SecureBrowser::get_bookmarks(const Id128& profile_id) {
     std::vector<SecureBookmark> bookmarks;
-    std::cout << "[*] Getting bookmarks for: " << profile_id << std::endl;
+    std::cout << "[*] Getting bookmarks for: " << profile_id.to_string("profile") << std::endl;
     return bookmarks;
 }
 
@@ -111,8 +113,8 @@ void SecureBrowser::configure_privacy(const PrivacySettings& settings) {
     std::cout << "[*] Privacy settings configured" << std::endl;
 }
 
-void SecureBrowser::clear_browsing_data(const std::string& profile_id) {
-    std::cout << "[*] Clearing browsing data for: " << profile_id << std::endl;
+void SecureBrowser::clear_browsing_data(const Id128& profile_id) {
+    std::cout << "[*] Clearing browsing data for: " << profile_id.to_string("profile") << std::endl;
 }
 
 void SecureBrowser::enable_incognito_mode(bool enable) {
@@ -120,9 +122,9 @@ void SecureBrowser::enable_incognito_mode(bool enable) {
     std::cout << "[*] Incognito mode " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
-BrowserSession SecureBrowser::start_session(const std::string& profile_id) {
+BrowserSession SecureBrowser::start_session(const Id128& profile_id) {
     BrowserSession session;
-    session.session_id = "session_" + std::to_string(rand() % 1000000);
+    session.session_id = Id128::generate();
     session.profile_id = profile_id;
     session.start_time = time(nullptr);
     session.duration = 0;
@@ -131,16 +133,17 @@ BrowserSession SecureBrowser::start_session(const std::string& profile_id) {
     
     sessions_[session.session_id] = session;
     
-    std::cout << "[+] Session started: " << session.session_id << std::endl;
+    std::cout << "[+] Session started: " << session.session_id.to_string("session") << std::endl;
     
     return session;
 }
 
-void SecureBrowser::end_session(const std::string& session_id) {
-    std::cout << "[*] Ending session: " << session_id << std::endl;
+void SecureBrowser::end_session(const Id128& session_id) {
+    std::cout << "[*] Ending session: " << session_id.to_string("session") << std::endl;
     
-    if (sessions_.find(session_id) != sessions_.end()) {
-        sessions_[session_id].duration = time(nullptr) - sessions_[session_id].start_time;
+    auto it = sessions_.find(session_id);
+    if (it != sessions_.end()) {
+        it->second.duration = time(nullptr) - it->second.start_time;
     }
 }
 
@@ -175,27 +178,15 @@ std::vector<uint8_t> SecureBrowser::generate_browser_key() {
 }
 
 std::vector<uint8_t> SecureBrowser::encrypt_url(const std::string& url) {
-    std::vector<uint8_t> encrypted(url.begin(), url.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(byte_view(url));
 }
 
 std::string SecureBrowser::decrypt_url(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
 
-std::string SecureBrowser::generate_tab_id() {
-    return "tab_" + std::to_string(rand() % 1000000);
-}
-
-std::string SecureBrowser::generate_bookmark_id() {
-    return "bookmark_" + std::to_string(rand() % 1000000);
-}
-
 } // namespace Crypto
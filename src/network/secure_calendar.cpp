@@ -16,7 +16,7 @@ bool SecureCalendar::initialize() {
 
 Calendar SecureCalendar::create_calendar(const std::string& name, const std::string& owner_id) {
     Calendar calendar;
-    calendar.calendar_id = generate_calendar_id();
+    calendar.calendar_id = Id128::generate();
     calendar.name = name;
     calendar.owner_id = owner_id;
     calendar.is_default = calendars_.empty();
@@ -32,23 +32,23 @@ Calendar SecureCalendar::create_calendar(const std::string& name, const std::str
     return calendar;
 }
 
-bool SecureCalendar::delete_calendar(const std::string& calendar_id) {
-    std::cout << "[*] Deleting calendar: " << calendar_id << std::endl;
+bool SecureCalendar::delete_calendar(const Id128& calendar_id) {
+    std::cout << "[*] Deleting calendar: " << calendar_id.to_string("calendar") << std::endl;
     
-    if (calendars_.find(calendar_id) != calendars_.end()) {
-        calendars_.erase(calendar_id);
+    if (calendars_.erase(calendar_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-bool SecureCalendar::share_calendar(const std::string& calendar_id, const std::string& user_id, 
+bool SecureCalendar::share_calendar(const Id128& calendar_id, const std::string& user_id, 
                                    const std::string& permission) {
-    std::cout << "[*] Sharing calendar: " << calendar_id << " with " << user_id << " (" << permission << ")" << std::endl;
+    std::cout << "[*] Sharing calendar: " << calendar_id.to_string("calendar") << " with " << user_id << " (" << permission << ")" << std::endl;
     
-    if (calendars_.find(calendar_id) != calendars_.end()) {
-        calendars_[calendar_id].shared_with.push_back(user_id);
+    auto it = calendars_.find(calendar_id);
+    if (it != calendars_.end()) {
+        it->second.shared_with.push_back(user_id);
         return true;
     }
     
@@ -69,10 +69,10 @@ std::vector<Calendar> SecureCalendar::list_calendars(const std::string& user_id)
     return list;
 }
 
-SecureEvent SecureCalendar::create_event(const std::string& calendar_id, const std::string& title,
+SecureEvent SecureCalendar::create_event(const Id128& calendar_id, const std::string& title,
                                         const std::string& description, uint64_t start_time, uint64_t end_time) {
     SecureEvent event;
-    event.event_id = generate_event_id();
+    event.event_id = Id128::generate();
     event.title = title;
     event.description = description;
     event.encrypted_content = encrypt_event_data(description);
@@ -91,36 +91,37 @@ SecureEvent SecureCalendar::create_event(const std::string& calendar_id, const s
     return event;
 }
 
-bool SecureCalendar::update_event(const std::string& event_id, const SecureEvent& updates) {
-    std::cout << "[*] Updating event: " << event_id << std::endl;
+bool SecureCalendar::update_event(const Id128& event_id, const SecureEvent& updates) {
+    std::cout << "[*] Updating event: " << event_id.to_string("event") << std::endl;
     
-    if (events_.find(event_id) != events_.end()) {
-        events_[event_id].modified_at = time(nullptr);
+    auto it = events_.find(event_id);
+    if (it != events_.end()) {
+        it->second.modified_at = time(nullptr);
         return true;
     }
     
     return false;
 }
 
-bool SecureCalendar::delete_event(const std::string& event_id) {
-    std::cout << "[*] Deleting event: " << event_id << std::endl;
+bool SecureCalendar::delete_event(const Id128& event_id) {
+    std::cout << "[*] Deleting event: " << event_id.to_string("event") << std::endl;
     
-    if (events_.find(event_id) != events_.end()) {
-        events_.erase(event_id);
+    if (events_.erase(event_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-bool SecureCalendar::invite_attendee(const std::string& event_id, const std::string& attendee_id) {
-    std::cout << "[*] Inviting " << attendee_id << " to event: " << event_id << std::endl;
+bool SecureCalendar::invite_attendee(const Id128& event_id, const std::string& attendee_id) {
+    std::cout << "[*] Inviting " << attendee_id << " to event: " << event_id.to_string("event") << std::endl;
     
-    if (events_.find(event_id) != events_.end()) {
-        events_[event_id].attendee_ids.push_back(attendee_id);
+    auto it = events_.find(event_id);
+    if (it != events_.end()) {
+        it->second.attendee_ids.push_back(attendee_id);
         
         EventInvitation invitation;
-        invitation.invitation_id = "inv_" + std::to_string(rand() % 1000000);
+        invitation.invitation_id = Id128::generate();
         invitation.event_id = event_id;
         invitation.recipient_id = attendee_id;
         invitation.status = "pending";
@@ -133,19 +134,20 @@ bool SecureCalendar::invite_attendee(const std::string& event_id, const std::str
     return false;
 }
 
-bool SecureCalendar::respond_to_invitation(const std::string& invitation_id, const std::string& response) {
-    std::cout << "[*] Responding to invitation: " << invitation_id << " (" << response << ")" << std::endl;
+bool SecureCalendar::respond_to_invitation(const Id128& invitation_id, const std::string& response) {
+    std::cout << "[*] Responding to invitation: " << invitation_id.to_string("inv") << " (" << response << ")" << std::endl;
     
-    if (invitations_.find(invitation_id) != invitations_.end()) {
-        invitations_[invitation_id].status = response;
-        invitations_[invitation_id].responded_at = time(nullptr);
+    auto it = invitations_.find(invitation_id);
+    if (it != invitations_.end()) {
+        it->second.status = response;
+        it->second.responded_at = time(nullptr);
         return true;
     }
     
     return false;
 }
 
-std::vector<SecureEvent> SecureCalendar::get_events(const std::string& calendar_id, uint64_t start_time, uint64_t end_time) {
+std::vector<SecureEvent> SecureCalendar::get_events(const Id128& calendar_id, uint64_t start_time, uint64_t end_time) {
     std::vector<SecureEvent> results;
     
     for (const auto& [id, event] : events_) {
@@ -161,17 +163,18 @@ std::vector<SecureEvent> SecureCalendar::get_events(const std::string& calendar_
     return results;
 }
 
-SecureEvent SecureCalendar::get_event(const std::string& event_id) {
-    std::cout << "[*] Retrieving event: " << event_id << std::endl;
+SecureEvent SecureCalendar::get_event(const Id128& event_id) {
+    std::cout << "[*] Retrieving event: " << event_id.to_string("event") << std::endl;
     
-    if (events_.find(event_id) != events_.end()) {
-        return events_[event_id];
+    auto it = events_.find(event_id);
+    if (it != events_.end()) {
+        return it->second;
     }
     
     return {};
 }
 
-std::vector<SecureEvent> SecureCalendar::search_events(const std::string& calendar_id, const std::string& query) {
+std::vector<SecureEvent> SecureCalendar::search_events(const Id128& calendar_id, const std::string& query) {
     std::vector<SecureEvent> results;
     
     for (const auto& [id, event] : events_) {
@@ -207,11 +210,12 @@ std::vector<TimeSlot> SecureCalendar::get_busy_times(const std::string& user_id,
     return busy;
 }
 
-void SecureCalendar::set_reminder(const std::string& event_id, uint64_t reminder_time) {
-    std::cout << "[*] Setting reminder for event: " << event_id << std::endl;
+void SecureCalendar::set_reminder(const Id128& event_id, uint64_t reminder_time) {
+    std::cout << "[*] Setting reminder for event: " << event_id.to_string("event") << std::endl;
     
-    if (events_.find(event_id) != events_.end()) {
-        events_[event_id].reminders.push_back(std::to_string(reminder_time));
+    auto it = events_.find(event_id);
+    if (it != events_.end()) {
+        it->second.reminders.push_back(std::to_string(reminder_time));
     }
 }
 
@@ -246,30 +250,18 @@ void SecureCalendar::generate_calendar_report() {
 }
 
 std::vector<uint8_t> SecureCalendar::encrypt_event_data(const std::string& data) {
-    std::vector<uint8_t> encrypted(data.begin(), data.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(byte_view(data));
 }
 
 std::string SecureCalendar::decrypt_event_data(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
 
-std::string SecureCalendar::generate_event_id() {
-    return "event_" + std::to_string(rand() % 1000000);
-}
-
-std::string SecureCalendar::generate_calendar_id() {
-    return "calendar_" + std::to_string(rand() % 1000000);
-}
-
-bool SecureCalendar::check_calendar_access(const std::string& calendar_id, const std::string& user_id) {
+bool SecureCalendar::check_calendar_access(const Id128& calendar_id, const std::string& user_id) {
     return true;
 }
 
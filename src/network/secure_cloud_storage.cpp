@@ -19,9 +19,9 @@ bool SecureCloudStorage::initialize() {
 CloudFile SecureCloudStorage::upload_file(const std::string& owner_id,
                                           const std::string& file_name,
                                           const std::vector<uint8_t>& content,
-                                          const std::string& parent_id) {
+                                          const Id128& parent_id) {
     CloudFile file;
-    file.file_id = generate_file_id();
+    file.file_id = Id128::generate();
     file.file_name = file_name;
     file.file_size = content.size();
     file.owner_id = owner_id;
@@ -39,49 +39,51 @@ CloudFile SecureCloudStorage::upload_file(const std::string& owner_id,
     return file;
 }
 
-std::vector<uint8_t> SecureCloudStorage::download_file(const std::string& file_id,
+std::vector<uint8_t> SecureCloudStorage::download_file(const Id128& file_id,
                                                        const std::string& requester_id) {
-    std::cout << "[*] Downloading file: " << file_id << std::endl;
+    std::cout << "[*] Downloading file: " << file_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
-        return decrypt_file(files_[file_id].encrypted_content);
+    auto it = files_.find(file_id);
+    if (it != files_.end()) {
+        return decrypt_file(it->second.encrypted_content);
     }
     
     return {};
 }
 
-bool SecureCloudStorage::delete_file(const std::string& file_id, const std::string& requester_id) {
-    std::cout << "[*] Deleting file: " << file_id << std::endl;
+bool SecureCloudStorage::delete_file(const Id128& file_id, const std::string& requester_id) {
+    std::cout << "[*] Deleting file: " << file_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
-        files_.erase(file_id);
+    if (files_.erase(file_id) > 0) {
+        shares_.erase(file_id);
         return true;
     }
     
     return false;
 }
 
-bool SecureCloudStorage::move_file(const std::string& file_id, const std::string& new_parent_id) {
-    std::cout << "[*] Moving file: " << file_id << " to " << new_parent_id << std::endl;
+bool SecureCloudStorage::move_file(const Id128& file_id, const Id128& new_parent_id) {
+    std::cout << "[*] Moving file: " << file_id.to_string("file") << " to " << new_parent_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
-        files_[file_id].parent_id = new_parent_id;
+    auto it = files_.find(file_id);
+    if (it != files_.end()) {
+        it->second.parent_id = new_parent_id;
         return true;
     }
     
     return false;
 }
 
-bool SecureCloudStorage::copy_file(const std::string& file_id, const std::string& new_parent_id) {
-    std::cout << "[*] Copying file: " << file_id << " to " << new_parent_id << std::endl;
+bool SecureCloudStorage::copy_file(const Id128& file_id, const Id128& new_parent_id) {
+    std::cout << "[*] Copying file: " << file_id.to_string("file") << " to " << new_parent_id.to_string("file") << std::endl;
     return true;
 }
 
 CloudFile SecureCloudStorage::create_folder(const std::string& owner_id,
                                             const std::string& folder_name,
-                                            const std::string& parent_id) {
+                                            const Id128& parent_id) {
     CloudFile folder;
-    folder.file_id = generate_file_id();
+    folder.file_id = Id128::generate();
     folder.file_name = folder_name;
     folder.owner_id = owner_id;
     folder.is_folder = true;
@@ -96,32 +98,33 @@ CloudFile SecureCloudStorage::create_folder(const std::string& owner_id,
     return folder;
 }
 
-std::vector<CloudFile> SecureCloudStorage::list_folder(const std::string& folder_id) {
+std::vector<CloudFile> SecureCloudStorage::list_folder(const Id128& folder_id) {
     std::vector<CloudFile> contents;
     
-    std::cout << "[*] Listing folder: " << folder_id << std::endl;
+    std::cout << "[*] Listing folder: " << folder_id.to_string("file") << std::endl;
     
     return contents;
 }
 
-bool SecureCloudStorage::share_file(const std::string& file_id, const SharePermission& permission) {
-    std::cout << "[*] Sharing file: " << file_id << " with " << permission.user_id << std::endl;
+bool SecureCloudStorage::share_file(const Id128& file_id, const SharePermission& permission) {
+    std::cout << "[*] Sharing file: " << file_id.to_string("file") << " with " << permission.user_id << std::endl;
     
     shares_[file_id].push_back(permission);
     
     return true;
 }
 
-bool SecureCloudStorage::revoke_access(const std::string& file_id, const std::string& user_id) {
-    std::cout << "[*] Revoking access for " << user_id << " from " << file_id << std::endl;
+bool SecureCloudStorage::revoke_access(const Id128& file_id, const std::string& user_id) {
+    std::cout << "[*] Revoking access for " << user_id << " from " << file_id.to_string("file") << std::endl;
     return true;
 }
 
-std::vector<SharePermission> SecureCloudStorage::get_shares(const std::string& file_id) {
-    std::cout << "[*] Getting shares for: " << file_id << std::endl;
+std::vector<SharePermission> SecureCloudStorage::get_shares(const Id128& file_id) {
+    std::cout << "[*] Getting shares for: " << file_id.to_string("file") << std::endl;
     
-    if (shares_.find(file_id) != shares_.end()) {
-        return shares_[file_id];
+    auto it = shares_.find(file_id);
+    if (it != shares_.end()) {
+        return it->second;
     }
     
     return {};
@@ -173,26 +176,14 @@ std::vector<uint8_t> SecureCloudStorage::generate_file_key() {
 }
 
 std::vector<uint8_t> SecureCloudStorage::encrypt_file(const std::vector<uint8_t>& content) {
-    std::vector<uint8_t> encrypted = content;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(content);
 }
 
 std::vector<uint8_t> SecureCloudStorage::decrypt_file(const std::vector<uint8_t>& encrypted) {
-    std::vector<uint8_t> decrypted = encrypted;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
-}
-
-std::string SecureCloudStorage::generate_file_id() {
-    return "file_" + std::to_string(rand() % 1000000);
+    return cipher_.open_box(encrypted).value_or(std::vector<uint8_t>{});
 }
 
-bool SecureCloudStorage::check_access(const std::string& file_id, const std::string& user_id, 
+bool SecureCloudStorage::check_access(const Id128& file_id, const std::string& user_id, 
                                       const std::string& level) {
     return true;
 }
@@ -1,7 +1,6 @@
 #include "secure_conference.h"
+#include "secure_random.h"
 #include <iostream>
-#include <random>
-#include <sstream>
 
 namespace SecureChat {
 
@@ -23,22 +22,9 @@ bool SecureConference::initialize(const ConferenceConfig& config) {
     return true;
 }
 
-std::string SecureConference::generate_room_id() {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 15);
-    
-    std::stringstream ss;
-    ss << "room_";
-    for (int i = 0; i < 16; i++) {
-        ss << std::hex << dis(gen);
-    }
-    return ss.str();
-}
-
 ConferenceRoom SecureConference::create_room(const std::string& room_name, const std::string& host_did) {
     ConferenceRoom room;
-    room.room_id = generate_room_id();
+    room.room_id = Crypto::Id128::generate();
     room.room_name = room_name;
     room.host_did = host_did;
     room.is_recording = false;
@@ -58,17 +44,18 @@ ConferenceRoom SecureConference::create_room(const std::string& room_name, const
     room.participants.push_back(host);
     rooms_[room.room_id] = room;
     
-    std::cout << "[*] Created conference room: " << room.room_id << std::endl;
+    std::cout << "[*] Created conference room: " << room.room_id.to_string("room") << std::endl;
     return room;
 }
 
-ConferenceRoom SecureConference::join_room(const std::string& room_id, const std::string& participant_did) {
-    if (rooms_.find(room_id) == rooms_.end()) {
-        std::cerr << "[!] Room not found: " << room_id << std::endl;
+ConferenceRoom SecureConference::join_room(const Crypto::Id128& room_id, const std::string& participant_did) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) {
+        std::cerr << "[!] Room not found: " << room_id.to_string("room") << std::endl;
         return ConferenceRoom{};
     }
     
-    ConferenceRoom& room = rooms_[room_id];
+    ConferenceRoom& room = it->second;
     
     if (room.participants.size() >= static_cast<size_t>(config_.max_participants)) {
         std::cerr << "[!] Room is full" << std::endl;
@@ -87,32 +74,34 @@ ConferenceRoom SecureConference::join_room(const std::string& room_id, const std
     
     room.participants.push_back(participant);
     
-    std::cout << "[*] Participant joined room: " << room_id << std::endl;
+    std::cout << "[*] Participant joined room: " << room_id.to_string("room") << std::endl;
     return room;
 }
 
-void SecureConference::leave_room(const std::string& room_id, const std::string& participant_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::leave_room(const Crypto::Id128& room_id, const std::string& participant_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    auto& room = rooms_[room_id];
+    auto& room = it->second;
     room.participants.erase(
         std::remove_if(room.participants.begin(), room.participants.end(),
             [&participant_id](const Participant& p) { return p.participant_id == participant_id; }),
         room.participants.end()
     );
     
-    std::cout << "[*] Participant left room: " << room_id << std::endl;
+    std::cout << "[*] Participant left room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::kick_participant(const std::string& room_id, const std::string& participant_id) {
+void SecureConference::kick_participant(const Crypto::Id128& room_id, const std::string& participant_id) {
     leave_room(room_id, participant_id);
-    std::cout << "[*] Participant kicked from room: " << room_id << std::endl;
+    std::cout << "[*] Participant kicked from room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::mute_participant(const std::string& room_id, const std::string& participant_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::mute_participant(const Crypto::Id128& room_id, const std::string& participant_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    for (auto& p : rooms_[room_id].participants) {
+    for (auto& p : it->second.participants) {
         if (p.participant_id == participant_id) {
             p.is_muted = true;
             std::cout << "[*] Participant muted: " << participant_id << std::endl;
@@ -121,10 +110,11 @@ void SecureConference::mute_participant(const std::string& room_id, const std::s
     }
 }
 
-void SecureConference::unmute_participant(const std::string& room_id, const std::string& participant_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::unmute_participant(const Crypto::Id128& room_id, const std::string& participant_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    for (auto& p : rooms_[room_id].participants) {
+    for (auto& p : it->second.participants) {
         if (p.participant_id == participant_id) {
             p.is_muted = false;
             std::cout << "[*] Participant unmuted: " << participant_id << std::endl;
@@ -133,10 +123,11 @@ void SecureConference::unmute_participant(const std::string& room_id, const std:
     }
 }
 
-void SecureConference::disable_video(const std::string& room_id, const std::string& participant_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::disable_video(const Crypto::Id128& room_id, const std::string& participant_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    for (auto& p : rooms_[room_id].participants) {
+    for (auto& p : it->second.participants) {
         if (p.participant_id == participant_id) {
             p.is_video_enabled = false;
             std::cout << "[*] Video disabled for: " << participant_id << std::endl;
@@ -145,10 +136,11 @@ void SecureConference::disable_video(const std::string& room_id, const std::stri
     }
 }
 
-void SecureConference::enable_video(const std::string& room_id, const std::string& participant_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_video(const Crypto::Id128& room_id, const std::string& participant_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    for (auto& p : rooms_[room_id].participants) {
+    for (auto& p : it->second.participants) {
         if (p.participant_id == participant_id) {
             p.is_video_enabled = true;
             std::cout << "[*] Video enabled for: " << participant_id << std::endl;
@@ -161,13 +153,7 @@ ConferenceMedia SecureConference::generate_media_key() {
     ConferenceMedia media;
     media.encryption_key.resize(32);
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (auto& b : media.encryption_key) {
-        b = static_cast<uint8_t>(dis(gen));
-    }
+    Crypto::SecureRandom::fill(media.encryption_key);
     
     return media;
 }
@@ -184,113 +170,118 @@ ConferenceMedia SecureConference::encrypt_media(const std::vector<uint8_t>& data
     return media;
 }
 
-ConferenceMedia SecureConference::send_video_frame(const std::string& room_id, const std::vector<uint8_t>& frame) {
+ConferenceMedia SecureConference::send_video_frame(const Crypto::Id128& room_id, const std::vector<uint8_t>& frame) {
     ConferenceMedia media = encrypt_media(frame);
     std::cout << "[*] Sending encrypted video frame: " << frame.size() << " bytes" << std::endl;
     return media;
 }
 
-ConferenceMedia SecureConference::send_audio_frame(const std::string& room_id, const std::vector<uint8_t>& frame) {
+ConferenceMedia SecureConference::send_audio_frame(const Crypto::Id128& room_id, const std::vector<uint8_t>& frame) {
     ConferenceMedia media = encrypt_media(frame);
     std::cout << "[*] Sending encrypted audio frame: " << frame.size() << " bytes" << std::endl;
     return media;
 }
 
-ConferenceMedia SecureConference::send_screen_share(const std::string& room_id, const std::vector<uint8_t>& screen_data) {
+ConferenceMedia SecureConference::send_screen_share(const Crypto::Id128& room_id, const std::vector<uint8_t>& screen_data) {
     ConferenceMedia media = encrypt_media(screen_data);
     std::cout << "[*] Sending encrypted screen share: " << screen_data.size() << " bytes" << std::endl;
     return media;
 }
 
-void SecureConference::enable_privacy_mode(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_privacy_mode(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].settings["privacy_mode"] = "enabled";
-    std::cout << "[*] Privacy mode enabled for room: " << room_id << std::endl;
+    it->second.settings["privacy_mode"] = "enabled";
+    std::cout << "[*] Privacy mode enabled for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::enable_attendance_verification(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_attendance_verification(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].settings["attendance_verification"] = "enabled";
-    std::cout << "[*] Attendance verification enabled for room: " << room_id << std::endl;
+    it->second.settings["attendance_verification"] = "enabled";
+    std::cout << "[*] Attendance verification enabled for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::enable_zero_knowledge_attendance(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_zero_knowledge_attendance(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].settings["zk_attendance"] = "enabled";
-    std::cout << "[*] Zero-knowledge attendance verification enabled for room: " << room_id << std::endl;
+    it->second.settings["zk_attendance"] = "enabled";
+    std::cout << "[*] Zero-knowledge attendance verification enabled for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::apply_privacy_filters(const std::string& room_id, const std::string& filter_type) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::apply_privacy_filters(const Crypto::Id128& room_id, const std::string& filter_type) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].settings["privacy_filter"] = filter_type;
+    it->second.settings["privacy_filter"] = filter_type;
     std::cout << "[*] Privacy filter applied: " << filter_type << std::endl;
 }
 
-void SecureConference::start_recording(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::start_recording(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].is_recording = true;
-    std::cout << "[*] Recording started for room: " << room_id << std::endl;
+    it->second.is_recording = true;
+    std::cout << "[*] Recording started for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::stop_recording(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::stop_recording(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].is_recording = false;
-    std::cout << "[*] Recording stopped for room: " << room_id << std::endl;
+    it->second.is_recording = false;
+    std::cout << "[*] Recording stopped for room: " << room_id.to_string("room") << std::endl;
 }
 
-std::vector<uint8_t> SecureConference::get_encrypted_recording(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return {};
+std::vector<uint8_t> SecureConference::get_encrypted_recording(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return {};
     
     std::vector<uint8_t> encrypted_recording;
     // Simulate encrypted recording data
     encrypted_recording.resize(1024 * 1024); // 1MB placeholder
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (auto& b : encrypted_recording) {
-        b = static_cast<uint8_t>(dis(gen));
-    }
+    Crypto::SecureRandom::fill(encrypted_recording);
     
     return encrypted_recording;
 }
 
-void SecureConference::verify_participant_identity(const std::string& room_id, const std::string& participant_id) {
+void SecureConference::verify_participant_identity(const Crypto::Id128& room_id, const std::string& participant_id) {
     std::cout << "[*] Verifying participant identity: " << participant_id << std::endl;
     std::cout << "[*] Using DID + Verifiable Credential verification" << std::endl;
 }
 
-void SecureConference::enable_end_to_end_encryption(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_end_to_end_encryption(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].is_encrypted = true;
-    std::cout << "[*] E2E encryption enabled for room: " << room_id << std::endl;
+    it->second.is_encrypted = true;
+    std::cout << "[*] E2E encryption enabled for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::rotate_encryption_keys(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::rotate_encryption_keys(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    std::cout << "[*] Rotating encryption keys for room: " << room_id << std::endl;
+    std::cout << "[*] Rotating encryption keys for room: " << room_id.to_string("room") << std::endl;
     std::cout << "[*] Using " << config_.encryption_algorithm << " for key rotation" << std::endl;
 }
 
-void SecureConference::enable_spatial_audio(const std::string& room_id) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+void SecureConference::enable_spatial_audio(const Crypto::Id128& room_id) {
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
-    rooms_[room_id].settings["spatial_audio"] = "enabled";
-    std::cout << "[*] Spatial audio enabled for room: " << room_id << std::endl;
+    it->second.settings["spatial_audio"] = "enabled";
+    std::cout << "[*] Spatial audio enabled for room: " << room_id.to_string("room") << std::endl;
 }
 
-void SecureConference::set_participant_position(const std::string& room_id, const std::string& participant_id,
+void SecureConference::set_participant_position(const Crypto::Id128& room_id, const std::string& participant_id,
                                                 float x, float y, float z) {
-    if (rooms_.find(room_id) == rooms_.end()) return;
+    auto it = rooms_.find(room_id);
+    if (it == rooms_.end()) return;
     
     std::cout << "[*] Setting participant position: " << participant_id 
               << " at (" << x << ", " << y << ", " << z << ")" << std::endl;
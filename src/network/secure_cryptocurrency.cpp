@@ -16,7 +16,7 @@ bool SecureCryptocurrency::initialize() {
 
 Wallet SecureCryptocurrency::create_wallet(const std::string& coin_type, bool is_cold_storage) {
     Wallet wallet;
-    wallet.wallet_id = generate_wallet_id();
+    wallet.wallet_id = Id128::generate();
     wallet.wallet_type = is_cold_storage ? "cold" : "hot";
     auto private_key = generate_private_key();
     wallet.public_address = derive_public_address(private_key);
@@ -39,16 +39,15 @@ bool SecureCryptocurrency::import_wallet(const std::string& private_key, const s
     return true;
 }
 
-bool SecureCryptocurrency::export_wallet(const std::string& wallet_id) {
-    std::cout << "[*] Exporting wallet: " << wallet_id << std::endl;
+bool SecureCryptocurrency::export_wallet(const Id128& wallet_id) {
+    std::cout << "[*] Exporting wallet: " << wallet_id.to_string("wallet") << std::endl;
     return true;
 }
 
-bool SecureCryptocurrency::delete_wallet(const std::string& wallet_id) {
-    std::cout << "[*] Deleting wallet: " << wallet_id << std::endl;
+bool SecureCryptocurrency::delete_wallet(const Id128& wallet_id) {
+    std::cout << "[*] Deleting wallet: " << wallet_id.to_string("wallet") << std::endl;
     
-    if (wallets_.find(wallet_id) != wallets_.end()) {
-        wallets_.erase(wallet_id);
+    if (wallets_.erase(wallet_id) > 0) {
         return true;
     }
     
@@ -67,11 +66,14 @@ std::vector<Wallet> SecureCryptocurrency::list_wallets() {
     return list;
 }
 
-Transaction SecureCryptocurrency::create_transaction(const std::string& from_wallet, const std::string& to_address,
+Transaction SecureCryptocurrency::create_transaction(const Id128& from_wallet, const std::string& to_address,
                                                    double amount, const std::string& coin_type) {
     Transaction tx;
-    tx.tx_id = "tx_" + std::to_string(rand() % 1000000);
-    tx.from_address = wallets_[from_wallet].public_address;
+    tx.tx_id = Id128::generate();
+    auto wallet = wallets_.find(from_wallet);
+    if (wallet != wallets_.end()) {
+        tx.from_address = wallet->second.public_address;
+    }
     tx.to_address = to_address;
     tx.amount = amount;
     tx.coin_type = coin_type;
@@ -82,17 +84,18 @@ Transaction SecureCryptocurrency::create_transaction(const std::string& from_wal
     
     transactions_[tx.tx_id] = tx;
     
-    std::cout << "[+] Transaction created: " << tx.tx_id << std::endl;
+    std::cout << "[+] Transaction created: " << tx.tx_id.to_string("tx") << std::endl;
     std::cout << "[+] Amount: " << amount << " " << coin_type << std::endl;
     
     return tx;
 }
 
-bool SecureCryptocurrency::sign_transaction(const std::string& tx_id, const std::string& wallet_id) {
-    std::cout << "[*] Signing transaction: " << tx_id << " with wallet: " << wallet_id << std::endl;
+bool SecureCryptocurrency::sign_transaction(const Id128& tx_id, const Id128& wallet_id) {
+    std::cout << "[*] Signing transaction: " << tx_id.to_string("tx") << " with wallet: " << wallet_id.to_string("wallet") << std::endl;
     
-    if (transactions_.find(tx_id) != transactions_.end()) {
-        auto& tx = transactions_[tx_id];
+    auto it = transactions_.find(tx_id);
+    if (it != transactions_.end()) {
+        auto& tx = it->second;
         tx.signature = sign_data({0x01, 0x02, 0x03}, wallets_[wallet_id].encrypted_private_key);
         return true;
     }
@@ -100,18 +103,19 @@ bool SecureCryptocurrency::sign_transaction(const std::string& tx_id, const std:
     return false;
 }
 
-bool SecureCryptocurrency::broadcast_transaction(const std::string& tx_id) {
-    std::cout << "[*] Broadcasting transaction: " << tx_id << std::endl;
+bool SecureCryptocurrency::broadcast_transaction(const Id128& tx_id) {
+    std::cout << "[*] Broadcasting transaction: " << tx_id.to_string("tx") << std::endl;
     
-    if (transactions_.find(tx_id) != transactions_.end()) {
-        transactions_[tx_id].status = "confirmed";
+    auto it = transactions_.find(tx_id);
+    if (it != transactions_.end()) {
+        it->second.status = "confirmed";
         return true;
     }
     
     return false;
 }
 
-std::vector<Transaction> SecureCryptocurrency::get_transaction_history(const std::string& wallet_id) {
+std::vector<Transaction> SecureCryptocurrency::get_transaction_history(const Id128& wallet_id) {
     std::vector<Transaction> history;
     
     for (const auto& [id, tx] : transactions_) {
@@ -125,12 +129,12 @@ std::vector<Transaction> SecureCryptocurrency::get_transaction_history(const std
     return history;
 }
 
-std::string SecureCryptocurrency::generate_new_address(const std::string& wallet_id) {
+std::string SecureCryptocurrency::generate_new_address(const Id128& wallet_id) {
     auto private_key = generate_private_key();
     return derive_public_address(private_key);
 }
 
-std::vector<std::string> SecureCryptocurrency::get_addresses(const std::string& wallet_id) {
+std::vector<std::string> SecureCryptocurrency::get_addresses(const Id128& wallet_id) {
     std::vector<std::string> addresses;
     addresses.push_back(wallets_[wallet_id].public_address);
     return addresses;
@@ -140,7 +144,7 @@ bool SecureCryptocurrency::validate_address(const std::string& address, const st
     return !address.empty() && address.length() > 20;
 }
 
-CoinBalance SecureCryptocurrency::get_balance(const std::string& wallet_id, const std::string& coin_type) {
+CoinBalance SecureCryptocurrency::get_balance(const Id128& wallet_id, const std::string& coin_type) {
     CoinBalance balance;
     balance.coin_type = coin_type;
     balance.balance = wallets_[wallet_id].balance;
@@ -150,7 +154,7 @@ CoinBalance SecureCryptocurrency::get_balance(const std::string& wallet_id, cons
     return balance;
 }
 
-std::vector<CoinBalance> SecureCryptocurrency::get_all_balances(const std::string& wallet_id) {
+std::vector<CoinBalance> SecureCryptocurrency::get_all_balances(const Id128& wallet_id) {
     std::vector<CoinBalance> balances;
     
     for (const auto& coin : wallets_[wallet_id].supported_coins) {
@@ -163,7 +167,7 @@ std::vector<CoinBalance> SecureCryptocurrency::get_all_balances(const std::strin
 MultisigConfig SecureCryptocurrency::create_multisig_wallet(uint32_t required, uint32_t total,
                                                            const std::vector<std::string>& signers) {
     MultisigConfig config;
-    config.config_id = "multisig_" + std::to_string(rand() % 1000000);
+    config.config_id = Id128::generate();
     config.required_signers = required;
     config.total_signers = total;
     config.signer_addresses = signers;
@@ -176,11 +180,12 @@ MultisigConfig SecureCryptocurrency::create_multisig_wallet(uint32_t required, u
     return config;
 }
 
-bool SecureCryptocurrency::add_multisig_signer(const std::string& config_id, const std::string& signer_address) {
-    std::cout << "[*] Adding signer to multisig: " << config_id << std::endl;
+bool SecureCryptocurrency::add_multisig_signer(const Id128& config_id, const std::string& signer_address) {
+    std::cout << "[*] Adding signer to multisig: " << config_id.to_string("multisig") << std::endl;
     
-    if (multisig_configs_.find(config_id) != multisig_configs_.end()) {
-        multisig_configs_[config_id].signer_addresses.push_back(signer_address);
+    auto it = multisig_configs_.find(config_id);
+    if (it != multisig_configs_.end()) {
+        it->second.signer_addresses.push_back(signer_address);
         return true;
     }
     
@@ -236,8 +241,4 @@ bool SecureCryptocurrency::verify_signature(const std::vector<uint8_t>& data, co
     return true;
 }
 
-std::string SecureCryptocurrency::generate_wallet_id() {
-    return "wallet_" + std::to_string(rand() % 1000000);
-}
-
 } // namespace Crypto
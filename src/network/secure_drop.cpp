@@ -1,4 +1,5 @@
 #include "secure_drop.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -75,7 +76,7 @@ void SecureDrop::generate_audit_log() {
 }
 
 std::string SecureDrop::generate_file_id() {
-    return "drop_" + std::to_string(rand() % 1000000);
+    return "drop_" + std::to_string(SecureRandom::uniform(1000000));
 }
 
 uint64_t SecureDrop::calculate_expiration() {
@@ -87,19 +88,11 @@ bool SecureDrop::validate_mime_type(const std::string& mime_type) {
 }
 
 std::vector<uint8_t> SecureDrop::encrypt_data(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> encrypted = data;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(data);
 }
 
 std::vector<uint8_t> SecureDrop::decrypt_data(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> decrypted = data;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
+    return cipher_.open_box(data).value_or(std::vector<uint8_t>{});
 }
 
 } // namespace Crypto
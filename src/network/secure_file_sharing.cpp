@@ -1,4 +1,5 @@
 #include "secure_file_sharing.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -18,7 +19,7 @@ bool SecureFileSharing::initialize() {
 SharedFile SecureFileSharing::upload_file(const std::string& owner_id, const std::string& file_name,
                                        const std::vector<uint8_t>& content, const std::string& mime_type) {
     SharedFile file;
-    file.file_id = generate_file_id();
+    file.file_id = Id128::generate();
     file.file_name = file_name;
     file.file_size = content.size();
     file.mime_type = mime_type;
@@ -38,45 +39,48 @@ SharedFile SecureFileSharing::upload_file(const std::string& owner_id, const std
     return file;
 }
 
-std::vector<uint8_t> SecureFileSharing::download_file(const std::string& file_id, const std::string& requester_id) {
-    std::cout << "[*] Downloading file: " << file_id << std::endl;
+std::vector<uint8_t> SecureFileSharing::download_file(const Id128& file_id, const std::string& requester_id) {
+    std::cout << "[*] Downloading file: " << file_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
+    auto it = files_.find(file_id);
+    if (it != files_.end()) {
         log_access(file_id, requester_id, "download");
-        files_[file_id].current_downloads++;
-        return decrypt_file(files_[file_id].encrypted_content);
+        it->second.current_downloads++;
+        return decrypt_file(it->second.encrypted_content);
     }
     
     return {};
 }
 
-bool SecureFileSharing::delete_file(const std::string& file_id, const std::string& requester_id) {
-    std::cout << "[*] Deleting file: " << file_id << std::endl;
+bool SecureFileSharing::delete_file(const Id128& file_id, const std::string& requester_id) {
+    std::cout << "[*] Deleting file: " << file_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end() && files_[file_id].owner_id == requester_id) {
-        files_.erase(file_id);
+    auto it = files_.find(file_id);
+    if (it != files_.end() && it->second.owner_id == requester_id) {
+        files_.erase(it);
         return true;
     }
     
     return false;
 }
 
-bool SecureFileSharing::update_file(const std::string& file_id, const std::vector<uint8_t>& new_content) {
-    std::cout << "[*] Updating file: " << file_id << std::endl;
+bool SecureFileSharing::update_file(const Id128& file_id, const std::vector<uint8_t>& new_content) {
+    std::cout << "[*] Updating file: " << file_id.to_string("file") << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
-        files_[file_id].encrypted_content = encrypt_file(new_content);
-        files_[file_id].file_size = new_content.size();
+    auto it = files_.find(file_id);
+    if (it != files_.end()) {
+        it->second.encrypted_content = encrypt_file(new_content);
+        it->second.file_size = new_content.size();
         return true;
     }
     
     return false;
 }
 
-FileShareLink SecureFileSharing::create_share_link(const std::string& file_id, const std::string& owner_id,
+FileShareLink SecureFileSharing::create_share_link(const Id128& file_id, const std::string& owner_id,
                                                   uint32_t max_access_count, uint64_t expiration_hours) {
     FileShareLink link;
-    link.link_id = "LINK_" + std::to_string(rand() % 100000);
+    link.link_id = Id128::generate();
     link.file_id = file_id;
     link.share_token = generate_share_token();
     link.short_url = "https://share.secure/" + link.share_token.substr(0, 8);
@@ -94,71 +98,78 @@ FileShareLink SecureFileSharing::create_share_link(const std::string& file_id, c
     return link;
 }
 
-bool SecureFileSharing::share_with_users(const std::string& file_id, const std::string& owner_id,
+bool SecureFileSharing::share_with_users(const Id128& file_id, const std::string& owner_id,
                                        const std::vector<std::string>& user_ids, const std::string& access_level) {
-    std::cout << "[*] Sharing file: " << file_id << " with " << user_ids.size() << " user(s)" << std::endl;
+    std::cout << "[*] Sharing file: " << file_id.to_string("file") << " with " << user_ids.size() << " user(s)" << std::endl;
     
-    if (files_.find(file_id) != files_.end() && files_[file_id].owner_id == owner_id) {
-        files_[file_id].shared_with = user_ids;
-        files_[file_id].access_level = access_level;
+    auto it = files_.find(file_id);
+    if (it != files_.end() && it->second.owner_id == owner_id) {
+        it->second.shared_with = user_ids;
+        it->second.access_level = access_level;
         return true;
     }
     
     return false;
 }
 
-bool SecureFileSharing::share_with_emails(const std::string& file_id, const std::string& owner_id,
+bool SecureFileSharing::share_with_emails(const Id128& file_id, const std::string& owner_id,
                                          const std::vector<std::string>& emails) {
-    std::cout << "[*] Sharing file: " << file_id << " with " << emails.size() << " email(s)" << std::endl;
+    std::cout << "[*] Sharing file: " << file_id.to_string("file") << " with " << emails.size() << " email(s)" << std::endl;
     
-    if (files_.find(file_id) != files_.end()) {
-        files_[file_id].allowed_emails = emails;
+    auto it = files_.find(file_id);
+    if (it != files_.end()) {
+        it->second.allowed_emails = emails;
         return true;
     }
     
     return false;
 }
 
-bool SecureFileSharing::revoke_access(const std::string& file_id, const std::string& owner_id, const std::string& user_id) {
-    std::cout << "[*] Revoking access: " << user_id << " from " << file_id << std::endl;
+bool SecureFileSharing::revoke_access(const Id128& file_id, const std::string& owner_id, const std::string& user_id) {
+    std::cout << "[*] Revoking access: " << user_id << " from " << file_id.to_string("file") << std::endl;
     
     return true;
 }
 
-bool SecureFileSharing::validate_share_link(const std::string& link_id, const std::string& password) {
-    std::cout << "[*] Validating share link: " << link_id << std::endl;
+bool SecureFileSharing::validate_share_link(const Id128& link_id, const std::string& password) {
+    std::cout << "[*] Validating share link: " << link_id.to_string("link") << std::endl;
     
-    if (links_.find(link_id) != links_.end()) {
-        return links_[link_id].is_active;
+    auto it = links_.find(link_id);
+    if (it != links_.end()) {
+        return it->second.is_active;
     }
     
     return false;
 }
 
-std::vector<uint8_t> SecureFileSharing::download_via_link(const std::string& link_id, const std::string& password) {
-    std::cout << "[*] Downloading via link: " << link_id << std::endl;
+std::vector<uint8_t> SecureFileSharing::download_via_link(const Id128& link_id, const std::string& password) {
+    std::cout << "[*] Downloading via link: " << link_id.to_string("link") << std::endl;
     
-    if (links_.find(link_id) != links_.end() && links_[link_id].is_active) {
-        links_[link_id].current_access_count++;
-        log_access(links_[link_id].file_id, "anonymous", "link_download");
-        return decrypt_file(files_[links_[link_id].file_id].encrypted_content);
+    auto link = links_.find(link_id);
+    if (link != links_.end() && link->second.is_active) {
+        auto file = files_.find(link->second.file_id);
+        if (file == files_.end()) return {};
+        link->second.current_access_count++;
+        log_access(link->second.file_id, "anonymous", "link_download");
+        return decrypt_file(file->second.encrypted_content);
     }
     
     return {};
 }
 
-bool SecureFileSharing::deactivate_link(const std::string& link_id) {
-    std::cout << "[*] Deactivating link: " << link_id << std::endl;
+bool SecureFileSharing::deactivate_link(const Id128& link_id) {
+    std::cout << "[*] Deactivating link: " << link_id.to_string("link") << std::endl;
     
-    if (links_.find(link_id) != links_.end()) {
-        links_[link_id].is_active = false;
+    auto it = links_.find(link_id);
+    if (it != links_.end()) {
+        it->second.is_active = false;
         return true;
     }
     
     return false;
 }
 
-std::vector<FileShareLink> SecureFileSharing::get_active_links(const std::string& file_id) {
+std::vector<FileShareLink> SecureFileSharing::get_active_links(const Id128& file_id) {
     std::vector<FileShareLink> active;
     
     for (const auto& [id, link] : links_) {
@@ -190,9 +201,10 @@ void SecureFileSharing::enable_audit_logging(bool enable) {
     std::cout << "[*] Audit logging " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
-std::vector<FileAccessEvent> SecureFileSharing::get_access_log(const std::string& file_id) {
-    if (access_logs_.find(file_id) != access_logs_.end()) {
-        return access_logs_[file_id];
+std::vector<FileAccessEvent> SecureFileSharing::get_access_log(const Id128& file_id) {
+    auto it = access_logs_.find(file_id);
+    if (it != access_logs_.end()) {
+        return it->second;
     }
     
     return {};
@@ -216,8 +228,8 @@ std::vector<std::string> SecureFileSharing::get_supported_preview_types() {
     return {"image/png", "image/jpeg", "image/gif", "application/pdf", "text/plain"};
 }
 
-std::vector<uint8_t> SecureFileSharing::generate_preview(const std::string& file_id) {
-    std::cout << "[*] Generating preview for: " << file_id << std::endl;
+std::vector<uint8_t> SecureFileSharing::generate_preview(const Id128& file_id) {
+    std::cout << "[*] Generating preview for: " << file_id.to_string("file") << std::endl;
     return {0x89, 0x50, 0x4E, 0x47}; // PNG header
 }
 
@@ -232,46 +244,34 @@ void SecureFileSharing::generate_sharing_report() {
     std::cout << "=================================\n" << std::endl;
 }
 
-std::string SecureFileSharing::generate_file_id() {
-    return "file_" + std::to_string(rand() % 1000000);
-}
-
 std::string SecureFileSharing::generate_share_token() {
     const std::string charset = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789";
     std::string token;
     
     for (int i = 0; i < 16; i++) {
-        token += charset[std::rand() % charset.length()];
+        token += charset[SecureRandom::uniform(charset.length())];
     }
     
     return token;
 }
 
 std::vector<uint8_t> SecureFileSharing::encrypt_file(const std::vector<uint8_t>& content) {
-    std::vector<uint8_t> encrypted = content;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(content);
 }
 
 std::vector<uint8_t> SecureFileSharing::decrypt_file(const std::vector<uint8_t>& encrypted) {
-    std::vector<uint8_t> decrypted = encrypted;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
+    return cipher_.open_box(encrypted).value_or(std::vector<uint8_t>{});
 }
 
 bool SecureFileSharing::validate_file_scan(const std::vector<uint8_t>& content) {
     return true;
 }
 
-void SecureFileSharing::log_access(const std::string& file_id, const std::string& user_id, const std::string& action) {
+void SecureFileSharing::log_access(const Id128& file_id, const std::string& user_id, const std::string& action) {
     if (!audit_logging_enabled_) return;
     
     FileAccessEvent event;
-    event.event_id = "EVT_" + std::to_string(rand() % 100000);
+    event.event_id = Id128::generate();
     event.file_id = file_id;
     event.user_id = user_id;
     event.action = action;
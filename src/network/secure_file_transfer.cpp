@@ -1,4 +1,5 @@
 #include "secure_file_transfer.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -10,7 +11,7 @@ SecureFileTransfer::TransferSession SecureFileTransfer::start_transfer(
     const std::string& recipient) {
     
     TransferSession session;
-    session.session_id = "session_" + std::to_string(rand() % 1000000);
+    session.session_id = "session_" + std::to_string(SecureRandom::uniform(1000000));
     session.filename = filename;
     session.file_size = size;
     session.transferred = 0;
@@ -36,12 +37,8 @@ SecureFileTransfer::FileChunk SecureFileTransfer::create_chunk(
     chunk.offset = offset;
     chunk.data.resize(4096);
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (auto& b : chunk.data) b = dis(gen);
-    for (auto& b : chunk.mac) b = dis(gen);
+    SecureRandom::fill(chunk.data);
+    SecureRandom::fill(chunk.mac);
     
     std::cout << "[*] Chunk " << chunk.chunk_id << " created" << std::endl;
     
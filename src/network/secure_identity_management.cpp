@@ -16,14 +16,14 @@ bool SecureIdentityManagement::initialize() {
 
 Identity SecureIdentityManagement::create_identity(const std::string& display_name, const std::string& identity_type) {
     Identity identity;
-    identity.identity_id = generate_identity_id();
+    identity.identity_id = Id128::generate();
     identity.display_name = display_name;
     identity.identity_type = identity_type;
     identity.created_at = time(nullptr);
     identity.expires_at = time(nullptr) + 31536000; // 1 year
     identity.is_revoked = false;
     
-    identity.did = "did:" + identity_type + ":" + identity.identity_id;
+    identity.did = "did:" + identity_type + ":" + identity.identity_id.to_string();
     
     identities_[identity.identity_id] = identity;
     
@@ -33,8 +33,8 @@ Identity SecureIdentityManagement::create_identity(const std::string& display_na
     return identity;
 }
 
-bool SecureIdentityManagement::update_identity(const std::string& identity_id, const Identity& updates) {
-    std::cout << "[*] Updating identity: " << identity_id << std::endl;
+bool SecureIdentityManagement::update_identity(const Id128& identity_id, const Identity& updates) {
+    std::cout << "[*] Updating identity: " << identity_id.to_string("identity") << std::endl;
     
     if (identities_.find(identity_id) != identities_.end()) {
         return true;
@@ -43,21 +43,23 @@ bool SecureIdentityManagement::update_identity(const std::string& identity_id, c
     return false;
 }
 
-bool SecureIdentityManagement::revoke_identity(const std::string& identity_id, const std::string& reason) {
-    std::cout << "[*] Revoking identity: " << identity_id << std::endl;
+bool SecureIdentityManagement::revoke_identity(const Id128& identity_id, const std::string& reason) {
+    std::cout << "[*] Revoking identity: " << identity_id.to_string("identity") << std::endl;
     
-    if (identities_.find(identity_id) != identities_.end()) {
-        identities_[identity_id].is_revoked = true;
-        identities_[identity_id].revocation_reason = reason;
+    auto it = identities_.find(identity_id);
+    if (it != identities_.end()) {
+        it->second.is_revoked = true;
+        it->second.revocation_reason = reason;
         return true;
     }
     
     return false;
 }
 
-Identity SecureIdentityManagement::get_identity(const std::string& identity_id) {
-    if (identities_.find(identity_id) != identities_.end()) {
-        return identities_[identity_id];
+Identity SecureIdentityManagement::get_identity(const Id128& identity_id) {
+    auto it = identities_.find(identity_id);
+    if (it != identities_.end()) {
+        return it->second;
     }
     
     return {};
@@ -107,7 +109,7 @@ bool SecureIdentityManagement::update_did_service(const std::string& did, const
 VerifiableCredential SecureIdentityManagement::issue_credential(const std::string& issuer_id, const std::string& subject_id,
                                                              const std::vector<std::string>& claims) {
     VerifiableCredential vc;
-    vc.vc_id = "VC_" + std::to_string(rand() % 1000000);
+    vc.vc_id = Id128::generate();
     vc.issuer_id = issuer_id;
     vc.subject_id = subject_id;
     vc.credential_type = "VerifiedCredential";
@@ -119,13 +121,13 @@ VerifiableCredential SecureIdentityManagement::issue_credential(const std::strin
     
     credentials_[vc.vc_id] = vc;
     
-    std::cout << "[+] Credential issued: " << vc.vc_id << std::endl;
+    std::cout << "[+] Credential issued: " << vc.vc_id.to_string("vc") << std::endl;
     
     return vc;
 }
 
 bool SecureIdentityManagement::verify_credential(const VerifiableCredential& vc) {
-    std::cout << "[*] Verifying credential: " << vc.vc_id << std::endl;
+    std::cout << "[*] Verifying credential: " << vc.vc_id.to_string("vc") << std::endl;
     
     if (credentials_.find(vc.vc_id) != credentials_.end()) {
         return credentials_[vc.vc_id].is_valid;
@@ -134,33 +136,36 @@ bool SecureIdentityManagement::verify_credential(const VerifiableCredential& vc)
     return false;
 }
 
-bool SecureIdentityManagement::revoke_credential(const std::string& vc_id, const std::string& reason) {
-    std::cout << "[*] Revoking credential: " << vc_id << std::endl;
+bool SecureIdentityManagement::revoke_credential(const Id128& vc_id, const std::string& reason) {
+    std::cout << "[*] Revoking credential: " << vc_id.to_string("vc") << std::endl;
     
-    if (credentials_.find(vc_id) != credentials_.end()) {
-        credentials_[vc_id].is_valid = false;
+    auto it = credentials_.find(vc_id);
+    if (it != credentials_.end()) {
+        it->second.is_valid = false;
         return true;
     }
     
     return false;
 }
 
-bool SecureIdentityManagement::add_claim(const std::string& identity_id, const std::string& claim) {
-    std::cout << "[*] Adding claim to identity: " << identity_id << std::endl;
+bool SecureIdentityManagement::add_claim(const Id128& identity_id, const std::string& claim) {
+    std::cout << "[*] Adding claim to identity: " << identity_id.to_string("identity") << std::endl;
     
-    if (identities_.find(identity_id) != identities_.end()) {
-        identities_[identity_id].verified_claims.push_back(claim);
+    auto it = identities_.find(identity_id);
+    if (it != identities_.end()) {
+        it->second.verified_claims.push_back(claim);
         return true;
     }
     
     return false;
 }
 
-bool SecureIdentityManagement::verify_claim(const std::string& identity_id, const std::string& claim) {
-    std::cout << "[*] Verifying claim: " << claim << " for " << identity_id << std::endl;
+bool SecureIdentityManagement::verify_claim(const Id128& identity_id, const std::string& claim) {
+    std::cout << "[*] Verifying claim: " << claim << " for " << identity_id.to_string("identity") << std::endl;
     
-    if (identities_.find(identity_id) != identities_.end()) {
-        for (const auto& verified : identities_[identity_id].verified_claims) {
+    auto it = identities_.find(identity_id);
+    if (it != identities_.end()) {
+        for (const auto& verified : it->second.verified_claims) {
             if (verified == claim) {
                 return true;
             }
@@ -194,12 +199,8 @@ void SecureIdentityManagement::generate_identity_report() {
     std::cout << "========================================\n" << std::endl;
 }
 
-std::string SecureIdentityManagement::generate_identity_id() {
-    return "identity_" + std::to_string(rand() % 1000000);
-}
-
 std::string SecureIdentityManagement::generate_did_id(const std::string& method) {
-    return "did:" + method + ":" + std::to_string(rand() % 1000000);
+    return "did:" + method + ":" + Id128::generate().to_string();
 }
 
 std::vector<uint8_t> SecureIdentityManagement::sign_credential(const VerifiableCredential& vc, 
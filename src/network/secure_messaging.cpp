@@ -8,14 +8,14 @@ SecureMessaging::Message SecureMessaging::create_message(const std::string& send
                                                      const std::string& recipient,
                                                      const std::string& content) {
     Message msg;
-    msg.message_id = "msg_" + std::to_string(rand() % 1000000);
+    msg.message_id = Id128::generate();
     msg.sender = sender;
     msg.recipient = recipient;
     msg.encrypted_content = content;
     msg.timestamp = std::to_string(time(nullptr));
     
     std::cout << "\n=== Message Created ===" << std::endl;
-    std::cout << "ID: " << msg.message_id << std::endl;
+    std::cout << "ID: " << msg.message_id.to_string("msg") << std::endl;
     std::cout << "From: " << sender << std::endl;
     std::cout << "To: " << recipient << std::endl;
     std::cout << "Encryption: AES-256-GCM" << std::endl;
@@ -25,18 +25,19 @@ SecureMessaging::Message SecureMessaging::create_message(const std::string& send
 
 std::string SecureMessaging::encrypt_message(const Message& msg) {
     std::cout << "[*] Encrypting message..." << std::endl;
-    std::string encrypted = msg.encrypted_content;
-    for (char& c : encrypted) {
-        c ^= 0x42;
-    }
+    std::string encrypted(msg.encrypted_content.size() + CipherEngine::OVERHEAD, '\0');
+    const auto aad = msg.message_id.bytes();
+    cipher.seal_box_into(byte_view(msg.encrypted_content), byte_view(encrypted), aad);
     return encrypted;
 }
 
 std::string SecureMessaging::decrypt_message(const Message& msg) {
     std::cout << "[*] Decrypting message..." << std::endl;
-    std::string decrypted = msg.encrypted_content;
-    for (char& c : decrypted) {
-        c ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(msg.encrypted_content.size()), '\0');
+    const auto aad = msg.message_id.bytes();
+    if (!cipher.open_box_into(byte_view(msg.encrypted_content), byte_view(decrypted), aad)) {
+        std::cout << "[!] Message authentication failed" << std::endl;
+        return {};
     }
     return decrypted;
 }
@@ -1,4 +1,7 @@
 #include "secure_messaging_v2.h"
+#include "secure_random.h"
+
+#include <algorithm>
 
 namespace Crypto {
 
@@ -18,7 +21,7 @@ bool SecureMessagingV2::initialize() {
 
 Conversation SecureMessagingV2::create_conversation(const std::vector<std::string>& participants) {
     Conversation conv;
-    conv.conversation_id = "conv_" + std::to_string(rand() % 1000000);
+    conv.conversation_id = Id128::generate();
     conv.participants = participants;
     conv.created_at = time(nullptr);
     conv.last_activity = time(nullptr);
@@ -27,67 +30,101 @@ Conversation SecureMessagingV2::create_conversation(const std::vector<std::strin
     
     conversations_[conv.conversation_id] = conv;
     
-    std::cout << "[+] Conversation created: " << conv.conversation_id << std::endl;
+    std::cout << "[+] Conversation created: " << conv.conversation_id.to_string("conv") << std::endl;
     
     return conv;
 }
 
-bool SecureMessagingV2::add_participant(const std::string& conversation_id, 
+bool SecureMessagingV2::add_participant(const Id128& conversation_id, 
                                         const std::string& participant_id) {
-    std::cout << "[*] Adding participant " << participant_id << " to " << conversation_id << std::endl;
+    std::cout << "[*] Adding participant " << participant_id << " to " << conversation_id.to_string("conv") << std::endl;
     
-    if (conversations_.find(conversation_id) != conversations_.end()) {
-        conversations_[conversation_id].participants.push_back(participant_id);
+    auto it = conversations_.find(conversation_id);
+    if (it != conversations_.end()) {
+        it->second.participants.push_back(participant_id);
         return true;
     }
     
     return false;
 }
 
-bool SecureMessagingV2::remove_participant(const std::string& conversation_id, 
+bool SecureMessagingV2::remove_participant(const Id128& conversation_id, 
                                            const std::string& participant_id) {
-    std::cout << "[*] Removing participant " << participant_id << " from " << conversation_id << std::endl;
+    std::cout << "[*] Removing participant " << participant_id << " from " << conversation_id.to_string("conv") << std::endl;
     return true;
 }
 
-MessageV2 SecureMessagingV2::send_message(const std::string& conversation_id,
+MessageV2 SecureMessagingV2::send_message(const Id128& conversation_id,
                                          const std::string& sender_id,
                                          const std::string& content,
                                          bool ephemeral,
                                          uint64_t ttl_seconds) {
     MessageV2 msg;
-    msg.message_id = generate_message_id();
+    msg.message_id = Id128::generate();
     msg.sender_id = sender_id;
     msg.recipient_id = "";
     msg.encrypted_content = encrypt_message(content);
     msg.timestamp = time(nullptr);
-    msg.sequence_number = rand() % 10000;
+    msg.sequence_number = SecureRandom::uniform(10000);
     msg.read_receipt_requested = read_receipts_enabled_;
     msg.ephemeral = ephemeral;
     msg.expiration_time = ephemeral ? (time(nullptr) + ttl_seconds) : 0;
     
-    if (conversations_.find(conversation_id) != conversations_.end()) {
-        conversations_[conversation_id].messages.push_back(msg);
-        conversations_[conversation_id].last_activity = time(nullptr);
+    auto it = conversations_.find(conversation_id);
+    if (it != conversations_.end()) {
+        it->second.messages.push_back(msg);
+        it->second.last_activity = time(nullptr);
     }
     
-    std::cout << "[+] Message sent: " << msg.message_id << std::endl;
+    std::cout << "[+] Message sent: " << msg.message_id.to_string("msg") << std::endl;
     
     return msg;
 }
 
-std::vector<MessageV2> SecureMessagingV2::receive_messages(const std::string& conversation_id,
+std::vector<MessageV2> SecureMessagingV2::send_messages(const Id128& conversation_id,
+                                                         const std::string& sender_id,
+                                                         const std::vector<std::string>& contents) {
+    std::vector<std::vector<uint8_t>> encrypted = encrypt_messages(contents);
+    std::vector<MessageV2> sent;
+    sent.reserve(contents.size());
+    
+    for (auto& box : encrypted) {
+        MessageV2 msg;
+        msg.message_id = Id128::generate();
+        msg.sender_id = sender_id;
+        msg.recipient_id = "";
+        msg.encrypted_content = std::move(box);
+        msg.timestamp = time(nullptr);
+        msg.sequence_number = SecureRandom::uniform(10000);
+        msg.read_receipt_requested = read_receipts_enabled_;
+        msg.ephemeral = false;
+        msg.expiration_time = 0;
+        sent.push_back(std::move(msg));
+    }
+    
+    auto it = conversations_.find(conversation_id);
+    if (it != conversations_.end()) {
+        it->second.messages.insert(it->second.messages.end(), sent.begin(), sent.end());
+        it->second.last_activity = time(nullptr);
+    }
+    
+    std::cout << "[+] Messages sent: " << sent.size() << std::endl;
+    
+    return sent;
+}
+
+std::vector<MessageV2> SecureMessagingV2::receive_messages(const Id128& conversation_id,
                                                             const std::string& recipient_id) {
     std::vector<MessageV2> messages;
     
-    std::cout << "[*] Receiving messages for " << recipient_id << " in " << conversation_id << std::endl;
+    std::cout << "[*] Receiving messages for " << recipient_id << " in " << conversation_id.to_string("conv") << std::endl;
     
     return messages;
 }
 
-bool SecureMessagingV2::acknowledge_delivery(const std::string& message_id, 
+bool SecureMessagingV2::acknowledge_delivery(const Id128& message_id, 
                                              const std::string& recipient_id) {
-    std::cout << "[*] Acknowledging delivery for " << message_id << " by " << recipient_id << std::endl;
+    std::cout << "[*] Acknowledging delivery for " << message_id.to_string("msg") << " by " << recipient_id << std::endl;
     return true;
 }
 
@@ -111,17 +148,18 @@ void SecureMessagingV2::enable_screen_recording_protection(bool enable) {
     std::cout << "[*] Screen recording protection " << (enable ? "enabled" : "disabled") << std::endl;
 }
 
-MessageV2 SecureMessagingV2::create_group_message(const std::string& conversation_id,
+MessageV2 SecureMessagingV2::create_group_message(const Id128& conversation_id,
                                                   const std::string& sender_id,
                                                   const std::string& content) {
     return send_message(conversation_id, sender_id, content);
 }
 
-bool SecureMessagingV2::rotate_group_key(const std::string& conversation_id) {
-    std::cout << "[*] Rotating group key for " << conversation_id << std::endl;
+bool SecureMessagingV2::rotate_group_key(const Id128& conversation_id) {
+    std::cout << "[*] Rotating group key for " << conversation_id.to_string("conv") << std::endl;
     
-    if (conversations_.find(conversation_id) != conversations_.end()) {
-        conversations_[conversation_id].group_key = generate_message_key();
+    auto it = conversations_.find(conversation_id);
+    if (it != conversations_.end()) {
+        it->second.group_key = generate_message_key();
         return true;
     }
     
@@ -144,23 +182,36 @@ std::vector<uint8_t> SecureMessagingV2::generate_message_key() {
 }
 
 std::vector<uint8_t> SecureMessagingV2::encrypt_message(const std::string& content) {
-    std::vector<uint8_t> encrypted(content.begin(), content.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
+    return cipher_.seal_box(byte_view(content));
+}
+
+std::vector<std::vector<uint8_t>> SecureMessagingV2::encrypt_messages(const std::vector<std::string>& contents) {
+    // Same nonce || ciphertext || tag boxes as encrypt_message.
+    std::vector<std::vector<uint8_t>> boxes(contents.size());
+    std::vector<CipherEngine::BatchJob> jobs(contents.size());
+    for (size_t i = 0; i < contents.size(); ++i) {
+        boxes[i].resize(contents[i].size() + CipherEngine::OVERHEAD);
+        jobs[i].cipher = &cipher_;
+        jobs[i].nonce = cipher_.next_nonce();
+        jobs[i].in = byte_view(contents[i]);
+        jobs[i].out = std::span<uint8_t>(boxes[i]).subspan(CipherEngine::NONCE_SIZE, contents[i].size());
     }
-    return encrypted;
+    
+    CipherEngine::seal_batch(jobs);
+    
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        std::copy(jobs[i].nonce.begin(), jobs[i].nonce.end(), boxes[i].begin());
+        std::copy(jobs[i].tag.begin(), jobs[i].tag.end(), boxes[i].end() - CipherEngine::TAG_SIZE);
+    }
+    return boxes;
 }
 
 std::string SecureMessagingV2::decrypt_message(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
 
-std::string SecureMessagingV2::generate_message_id() {
-    return "msg_" + std::to_string(rand() % 1000000);
-}
-
 } // namespace Crypto
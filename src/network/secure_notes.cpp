@@ -1,4 +1,6 @@
 #include "secure_notes.h"
+#include "sha256.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -17,9 +19,9 @@ bool SecureNotes::initialize() {
 
 Notebook SecureNotes::create_notebook(const std::string& name) {
     Notebook notebook;
-    notebook.notebook_id = generate_notebook_id();
+    notebook.notebook_id = Id128::generate();
     notebook.name = name;
-    notebook.encryption_key = "key_" + std::to_string(rand() % 1000000);
+    notebook.encryption_key = "key_" + std::to_string(SecureRandom::uniform(1000000));
     notebook.created_at = time(nullptr);
     notebook.modified_at = time(nullptr);
     notebook.is_encrypted = e2e_encryption_enabled_;
@@ -31,11 +33,10 @@ Notebook SecureNotes::create_notebook(const std::string& name) {
     return notebook;
 }
 
-bool SecureNotes::delete_notebook(const std::string& notebook_id) {
-    std::cout << "[*] Deleting notebook: " << notebook_id << std::endl;
+bool SecureNotes::delete_notebook(const Id128& notebook_id) {
+    std::cout << "[*] Deleting notebook: " << notebook_id.to_string("notebook") << std::endl;
     
-    if (notebooks_.find(notebook_id) != notebooks_.end()) {
-        notebooks_.erase(notebook_id);
+    if (notebooks_.erase(notebook_id) > 0) {
         return true;
     }
     
@@ -54,9 +55,9 @@ std::vector<Notebook> SecureNotes::list_notebooks() {
     return list;
 }
 
-SecureNote SecureNotes::create_note(const std::string& notebook_id, const std::string& title, const std::string& content) {
+SecureNote SecureNotes::create_note(const Id128& notebook_id, const std::string& title, const std::string& content) {
     SecureNote note;
-    note.note_id = generate_note_id();
+    note.note_id = Id128::generate();
     note.title = title;
     note.encrypted_content = encrypt_content(content);
     note.content_hash = calculate_content_hash(content);
@@ -68,8 +69,9 @@ SecureNote SecureNotes::create_note(const std::string& notebook_id, const std::s
     
     notes_[note.note_id] = note;
     
-    if (notebooks_.find(notebook_id) != notebooks_.end()) {
-        notebooks_[notebook_id].notes.push_back(note.note_id);
+    auto it = notebooks_.find(notebook_id);
+    if (it != notebooks_.end()) {
+        it->second.notes.push_back(note.note_id);
     }
     
     std::cout << "[+] Note created: " << title << std::endl;
@@ -77,53 +79,55 @@ SecureNote SecureNotes::create_note(const std::string& notebook_id, const std::s
     return note;
 }
 
-bool SecureNotes::update_note(const std::string& note_id, const std::string& new_content) {
-    std::cout << "[*] Updating note: " << note_id << std::endl;
+bool SecureNotes::update_note(const Id128& note_id, const std::string& new_content) {
+    std::cout << "[*] Updating note: " << note_id.to_string("note") << std::endl;
     
-    if (notes_.find(note_id) != notes_.end()) {
-        notes_[note_id].encrypted_content = encrypt_content(new_content);
-        notes_[note_id].content_hash = calculate_content_hash(new_content);
-        notes_[note_id].modified_at = time(nullptr);
+    auto it = notes_.find(note_id);
+    if (it != notes_.end()) {
+        it->second.encrypted_content = encrypt_content(new_content);
+        it->second.content_hash = calculate_content_hash(new_content);
+        it->second.modified_at = time(nullptr);
         return true;
     }
     
     return false;
 }
 
-bool SecureNotes::delete_note(const std::string& note_id) {
-    std::cout << "[*] Deleting note: " << note_id << std::endl;
+bool SecureNotes::delete_note(const Id128& note_id) {
+    std::cout << "[*] Deleting note: " << note_id.to_string("note") << std::endl;
     
-    if (notes_.find(note_id) != notes_.end()) {
-        notes_.erase(note_id);
+    if (notes_.erase(note_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-SecureNote SecureNotes::get_note(const std::string& note_id) {
-    std::cout << "[*] Retrieving note: " << note_id << std::endl;
+SecureNote SecureNotes::get_note(const Id128& note_id) {
+    std::cout << "[*] Retrieving note: " << note_id.to_string("note") << std::endl;
     
-    if (notes_.find(note_id) != notes_.end()) {
-        return notes_[note_id];
+    auto it = notes_.find(note_id);
+    if (it != notes_.end()) {
+        return it->second;
     }
     
     return {};
 }
 
-bool SecureNotes::add_tag(const std::string& note_id, const std::string& tag) {
-    std::cout << "[*] Adding tag to note: " << note_id << std::endl;
+bool SecureNotes::add_tag(const Id128& note_id, const std::string& tag) {
+    std::cout << "[*] Adding tag to note: " << note_id.to_string("note") << std::endl;
     
-    if (notes_.find(note_id) != notes_.end()) {
-        notes_[note_id].tags.push_back(tag);
+    auto it = notes_.find(note_id);
+    if (it != notes_.end()) {
+        it->second.tags.push_back(tag);
         return true;
     }
     
     return false;
 }
 
-bool SecureNotes::remove_tag(const std::string& note_id, const std::string& tag) {
-    std::cout << "[*] Removing tag from note: " << note_id << std::endl;
+bool SecureNotes::remove_tag(const Id128& note_id, const std::string& tag) {
+    std::cout << "[*] Removing tag from note: " << note_id.to_string("note") << std::endl;
     return true;
 }
 
@@ -143,28 +147,27 @@ std::vector<SearchResult> SecureNotes::search_notes(const std::string& query) {
     return results;
 }
 
-NoteSharing SecureNotes::share_note(const std::string& note_id, const std::string& recipient_id,
+NoteSharing SecureNotes::share_note(const Id128& note_id, const std::string& recipient_id,
                                    const std::string& permission, uint64_t expires_at) {
     NoteSharing share;
-    share.share_id = "share_" + std::to_string(rand() % 1000000);
+    share.share_id = Id128::generate();
     share.note_id = note_id;
     share.shared_with = recipient_id;
     share.permission = permission;
     share.expires_at = expires_at;
-    share.encryption_key_encrypted = "encrypted_key_" + std::to_string(rand() % 1000000);
+    share.encryption_key_encrypted = "encrypted_key_" + std::to_string(SecureRandom::uniform(1000000));
     
     shares_[share.share_id] = share;
     
-    std::cout << "[+] Note shared: " << note_id << " with " << recipient_id << std::endl;
+    std::cout << "[+] Note shared: " << note_id.to_string("note") << " with " << recipient_id << std::endl;
     
     return share;
 }
 
-bool SecureNotes::revoke_share(const std::string& share_id) {
-    std::cout << "[*] Revoking share: " << share_id << std::endl;
+bool SecureNotes::revoke_share(const Id128& share_id) {
+    std::cout << "[*] Revoking share: " << share_id.to_string("share") << std::endl;
     
-    if (shares_.find(share_id) != shares_.end()) {
-        shares_.erase(share_id);
+    if (shares_.erase(share_id) > 0) {
         return true;
     }
     
@@ -202,31 +205,19 @@ std::vector<uint8_t> SecureNotes::generate_note_key() {
 }
 
 std::vector<uint8_t> SecureNotes::encrypt_content(const std::string& content) {
-    std::vector<uint8_t> encrypted(content.begin(), content.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(byte_view(content));
 }
 
 std::string SecureNotes::decrypt_content(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
 
-std::string SecureNotes::generate_note_id() {
-    return "note_" + std::to_string(rand() % 1000000);
-}
-
-std::string SecureNotes::generate_notebook_id() {
-    return "notebook_" + std::to_string(rand() % 1000000);
-}
-
 std::string SecureNotes::calculate_content_hash(const std::string& content) {
-    return "hash_" + std::to_string(std::hash<std::string>{}(content));
+    return Sha256::hex(Sha256::hash(byte_view(content)));
 }
 
 } // namespace Crypto
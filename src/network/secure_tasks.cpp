@@ -16,7 +16,7 @@ bool SecureTasks::initialize() {
 
 SecureTask SecureTasks::create_task(const std::string& title, const std::string& creator_id) {
     SecureTask task;
-    task.task_id = generate_task_id();
+    task.task_id = Id128::generate();
     task.title = title;
     task.status = "pending";
     task.created_at = time(nullptr);
@@ -32,8 +32,8 @@ SecureTask SecureTasks::create_task(const std::string& title, const std::string&
     return task;
 }
 
-bool SecureTasks::update_task(const std::string& task_id, const SecureTask& updates) {
-    std::cout << "[*] Updating task: " << task_id << std::endl;
+bool SecureTasks::update_task(const Id128& task_id, const SecureTask& updates) {
+    std::cout << "[*] Updating task: " << task_id.to_string("task") << std::endl;
     
     if (tasks_.find(task_id) != tasks_.end()) {
         return true;
@@ -42,24 +42,24 @@ bool SecureTasks::update_task(const std::string& task_id, const SecureTask& upda
     return false;
 }
 
-bool SecureTasks::delete_task(const std::string& task_id) {
-    std::cout << "[*] Deleting task: " << task_id << std::endl;
+bool SecureTasks::delete_task(const Id128& task_id) {
+    std::cout << "[*] Deleting task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_.erase(task_id);
+    if (tasks_.erase(task_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::complete_task(const std::string& task_id) {
-    std::cout << "[*] Completing task: " << task_id << std::endl;
+bool SecureTasks::complete_task(const Id128& task_id) {
+    std::cout << "[*] Completing task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].status = "completed";
-        tasks_[task_id].completed_at = time(nullptr);
-        tasks_[task_id].progress_percent = 100.0;
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.status = "completed";
+        it->second.completed_at = time(nullptr);
+        it->second.progress_percent = 100.0;
         return true;
     }
     
@@ -90,79 +90,85 @@ std::vector<SecureTask> SecureTasks::search_tasks(const std::string& query, cons
     return get_tasks(user_id, "");
 }
 
-SecureTask SecureTasks::get_task(const std::string& task_id) {
-    std::cout << "[*] Retrieving task: " << task_id << std::endl;
+SecureTask SecureTasks::get_task(const Id128& task_id) {
+    std::cout << "[*] Retrieving task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        return tasks_[task_id];
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        return it->second;
     }
     
     return {};
 }
 
-bool SecureTasks::assign_task(const std::string& task_id, const std::string& assignee_id) {
-    std::cout << "[*] Assigning task: " << task_id << " to " << assignee_id << std::endl;
+bool SecureTasks::assign_task(const Id128& task_id, const std::string& assignee_id) {
+    std::cout << "[*] Assigning task: " << task_id.to_string("task") << " to " << assignee_id << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].assignee_id = assignee_id;
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.assignee_id = assignee_id;
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::set_due_date(const std::string& task_id, uint64_t due_date) {
-    std::cout << "[*] Setting due date for task: " << task_id << std::endl;
+bool SecureTasks::set_due_date(const Id128& task_id, uint64_t due_date) {
+    std::cout << "[*] Setting due date for task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].due_date = due_date;
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.due_date = due_date;
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::set_priority(const std::string& task_id, const std::string& priority) {
-    std::cout << "[*] Setting priority for task: " << task_id << std::endl;
+bool SecureTasks::set_priority(const Id128& task_id, const std::string& priority) {
+    std::cout << "[*] Setting priority for task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].priority = priority;
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.priority = priority;
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::add_comment(const std::string& task_id, const std::string& comment) {
-    std::cout << "[*] Adding comment to task: " << task_id << std::endl;
+bool SecureTasks::add_comment(const Id128& task_id, const std::string& comment) {
+    std::cout << "[*] Adding comment to task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].comments.push_back(comment);
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.comments.push_back(comment);
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::add_checklist_item(const std::string& task_id, const std::string& item) {
-    std::cout << "[*] Adding checklist item to task: " << task_id << std::endl;
+bool SecureTasks::add_checklist_item(const Id128& task_id, const std::string& item) {
+    std::cout << "[*] Adding checklist item to task: " << task_id.to_string("task") << std::endl;
     
-    if (tasks_.find(task_id) != tasks_.end()) {
-        tasks_[task_id].checklist.push_back(item);
+    auto it = tasks_.find(task_id);
+    if (it != tasks_.end()) {
+        it->second.checklist.push_back(item);
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::toggle_checklist_item(const std::string& task_id, const std::string& item) {
-    std::cout << "[*] Toggling checklist item: " << task_id << std::endl;
+bool SecureTasks::toggle_checklist_item(const Id128& task_id, const std::string& item) {
+    std::cout << "[*] Toggling checklist item: " << task_id.to_string("task") << std::endl;
     return true;
 }
 
 Project SecureTasks::create_project(const std::string& name, const std::string& owner_id) {
     Project project;
-    project.project_id = generate_project_id();
+    project.project_id = Id128::generate();
     project.name = name;
     project.owner_id = owner_id;
     project.created_at = time(nullptr);
@@ -175,25 +181,26 @@ Project SecureTasks::create_project(const std::string& name, const std::string&
     return project;
 }
 
-bool SecureTasks::delete_project(const std::string& project_id) {
-    std::cout << "[*] Deleting project: " << project_id << std::endl;
+bool SecureTasks::delete_project(const Id128& project_id) {
+    std::cout << "[*] Deleting project: " << project_id.to_string("project") << std::endl;
     
-    if (projects_.find(project_id) != projects_.end()) {
-        projects_.erase(project_id);
+    if (projects_.erase(project_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-bool SecureTasks::add_task_to_project(const std::string& task_id, const std::string& project_id) {
-    std::cout << "[*] Adding task: " << task_id << " to project: " << project_id << std::endl;
+bool SecureTasks::add_task_to_project(const Id128& task_id, const Id128& project_id) {
+    std::cout << "[*] Adding task: " << task_id.to_string("task") << " to project: " << project_id.to_string("project") << std::endl;
     
-    if (projects_.find(project_id) != projects_.end()) {
-        projects_[project_id].task_ids.push_back(task_id);
+    auto project = projects_.find(project_id);
+    if (project != projects_.end()) {
+        project->second.task_ids.push_back(task_id);
         
-        if (tasks_.find(task_id) != tasks_.end()) {
-            tasks_[task_id].project_id = project_id;
+        auto task = tasks_.find(task_id);
+        if (task != tasks_.end()) {
+            task->second.project_id = project_id;
         }
         
         return true;
@@ -215,22 +222,23 @@ std::vector<Project> SecureTasks::get_projects(const std::string& user_id) {
 }
 
 TaskTemplate SecureTasks::create_template(const std::string& name) {
-    TaskTemplate template;
-    template.template_id = generate_template_id();
-    template.name = name;
-    template.default_priority = "medium";
-    template.default_estimated_hours = 8;
+    TaskTemplate tmpl;
+    tmpl.template_id = Id128::generate();
+    tmpl.name = name;
+    tmpl.default_priority = "medium";
+    tmpl.default_estimated_hours = 8;
     
-    templates_[template.template_id] = template;
+    templates_[tmpl.template_id] = tmpl;
     
     std::cout << "[+] Template created: " << name << std::endl;
     
-    return template;
+    return tmpl;
 }
 
-SecureTask SecureTasks::create_task_from_template(const std::string& template_id, const std::string& creator_id) {
-    if (templates_.find(template_id) != templates_.end()) {
-        return create_task(templates_[template_id].name, creator_id);
+SecureTask SecureTasks::create_task_from_template(const Id128& template_id, const std::string& creator_id) {
+    auto it = templates_.find(template_id);
+    if (it != templates_.end()) {
+        return create_task(it->second.name, creator_id);
     }
     
     return {};
@@ -280,31 +288,15 @@ void SecureTasks::generate_tasks_report() {
 }
 
 std::vector<uint8_t> SecureTasks::encrypt_task_data(const std::string& data) {
-    std::vector<uint8_t> encrypted(data.begin(), data.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(byte_view(data));
 }
 
 std::string SecureTasks::decrypt_task_data(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
 
-std::string SecureTasks::generate_task_id() {
-    return "task_" + std::to_string(rand() % 1000000);
-}
-
-std::string SecureTasks::generate_project_id() {
-    return "project_" + std::to_string(rand() % 1000000);
-}
-
-std::string SecureTasks::generate_template_id() {
-    return "template_" + std::to_string(rand() % 1000000);
-}
-
 } // namespace Crypto
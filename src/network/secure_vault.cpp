@@ -1,4 +1,5 @@
 #include "secure_vault.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -17,9 +18,9 @@ bool SecureVault::initialize() {
 
 Vault SecureVault::create_vault(const std::string& name, const std::string& master_password) {
     Vault vault;
-    vault.vault_id = "vault_" + std::to_string(rand() % 1000000);
+    vault.vault_id = Id128::generate();
     vault.name = name;
-    vault.master_key_encrypted = derive_master_key(master_password, "salt_" + vault.vault_id);
+    vault.master_key_encrypted = derive_master_key(master_password, vault.vault_id.to_string("salt"));
     vault.created_at = time(nullptr);
     vault.modified_at = time(nullptr);
     vault.item_count = 0;
@@ -31,8 +32,8 @@ Vault SecureVault::create_vault(const std::string& name, const std::string& mast
     return vault;
 }
 
-bool SecureVault::unlock_vault(const std::string& vault_id, const std::string& master_password) {
-    std::cout << "[*] Unlocking vault: " << vault_id << std::endl;
+bool SecureVault::unlock_vault(const Id128& vault_id, const std::string& master_password) {
+    std::cout << "[*] Unlocking vault: " << vault_id.to_string("vault") << std::endl;
     
     if (vaults_.find(vault_id) != vaults_.end()) {
         return true;
@@ -41,27 +42,26 @@ bool SecureVault::unlock_vault(const std::string& vault_id, const std::string& m
     return false;
 }
 
-bool SecureVault::lock_vault(const std::string& vault_id) {
-    std::cout << "[*] Locking vault: " << vault_id << std::endl;
+bool SecureVault::lock_vault(const Id128& vault_id) {
+    std::cout << "[*] Locking vault: " << vault_id.to_string("vault") << std::endl;
     return true;
 }
 
-bool SecureVault::delete_vault(const std::string& vault_id) {
-    std::cout << "[*] Deleting vault: " << vault_id << std::endl;
+bool SecureVault::delete_vault(const Id128& vault_id) {
+    std::cout << "[*] Deleting vault: " << vault_id.to_string("vault") << std::endl;
     
-    if (vaults_.find(vault_id) != vaults_.end()) {
-        vaults_.erase(vault_id);
+    if (vaults_.erase(vault_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-PasswordItem SecureVault::add_password(const std::string& vault_id, const std::string& title,
+PasswordItem SecureVault::add_password(const Id128& vault_id, const std::string& title,
                                       const std::string& username, const std::string& password,
                                       const std::string& website_url) {
     PasswordItem item;
-    item.item_id = generate_item_id();
+    item.item_id = Id128::generate();
     item.title = title;
     item.username = username;
     item.password_encrypted = encrypt_data({password.begin(), password.end()}, {0xAA, 0xBB});
@@ -81,8 +81,9 @@ PasswordItem SecureVault::add_password(const std::string& vault_id, const std::s
     
     items_[item.item_id] = vault_item;
     
-    if (vaults_.find(vault_id) != vaults_.end()) {
-        vaults_[vault_id].item_count++;
+    auto it = vaults_.find(vault_id);
+    if (it != vaults_.end()) {
+        it->second.item_count++;
     }
     
     std::cout << "[+] Password added: " << title << " (strength: " << item.strength_score << "/100)" << std::endl;
@@ -90,41 +91,41 @@ PasswordItem SecureVault::add_password(const std::string& vault_id, const std::s
     return item;
 }
 
-bool SecureVault::update_password(const std::string& item_id, const std::string& new_password) {
-    std::cout << "[*] Updating password: " << item_id << std::endl;
+bool SecureVault::update_password(const Id128& item_id, const std::string& new_password) {
+    std::cout << "[*] Updating password: " << item_id.to_string("item") << std::endl;
     
-    if (items_.find(item_id) != items_.end()) {
-        items_[item_id].modified_at = time(nullptr);
+    auto it = items_.find(item_id);
+    if (it != items_.end()) {
+        it->second.modified_at = time(nullptr);
         return true;
     }
     
     return false;
 }
 
-bool SecureVault::delete_password(const std::string& item_id) {
-    std::cout << "[*] Deleting password: " << item_id << std::endl;
+bool SecureVault::delete_password(const Id128& item_id) {
+    std::cout << "[*] Deleting password: " << item_id.to_string("item") << std::endl;
     
-    if (items_.find(item_id) != items_.end()) {
-        items_.erase(item_id);
+    if (items_.erase(item_id) > 0) {
         return true;
     }
     
     return false;
 }
 
-PasswordItem SecureVault::get_password(const std::string& item_id) {
-    std::cout << "[*] Retrieving password: " << item_id << std::endl;
+PasswordItem SecureVault::get_password(const Id128& item_id) {
+    std::cout << "[*] Retrieving password: " << item_id.to_string("item") << std::endl;
     
     PasswordItem item;
     item.item_id = item_id;
     return item;
 }
 
-CreditCardItem SecureVault::add_credit_card(const std::string& vault_id, const std::string& cardholder_name,
+CreditCardItem SecureVault::add_credit_card(const Id128& vault_id, const std::string& cardholder_name,
                                            const std::string& number, const std::string& cvv,
                                            const std::string& expiry_date) {
     CreditCardItem card;
-    card.item_id = generate_item_id();
+    card.item_id = Id128::generate();
     card.cardholder_name = cardholder_name;
     card.number_encrypted = encrypt_data({number.begin(), number.end()}, {0xAA, 0xBB});
     card.cvv_encrypted = encrypt_data({cvv.begin(), cvv.end()}, {0xAA, 0xBB});
@@ -173,9 +174,8 @@ void SecureVault::generate_secure_password(uint32_t length, bool include_symbols
     if (include_symbols) chars += symbols;
     
     result.clear();
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
     for (uint32_t i = 0; i < length; i++) {
-        result += chars[std::rand() % chars.length()];
+        result += chars[SecureRandom::uniform(chars.length())];
     }
     
     std::cout << "[+] Generated secure password" << std::endl;
@@ -198,9 +198,9 @@ std::vector<VaultItem> SecureVault::import_data(const std::string& format, const
     return imported;
 }
 
-std::vector<uint8_t> SecureVault::export_data(const std::string& vault_id, const std::string& format) {
+std::vector<uint8_t> SecureVault::export_data(const Id128& vault_id, const std::string& format) {
     std::vector<uint8_t> exported;
-    std::cout << "[*] Exporting vault data: " << vault_id << " format: " << format << std::endl;
+    std::cout << "[*] Exporting vault data: " << vault_id.to_string("vault") << " format: " << format << std::endl;
     return exported;
 }
 
@@ -219,23 +219,11 @@ std::vector<uint8_t> SecureVault::derive_master_key(const std::string& password,
 }
 
 std::vector<uint8_t> SecureVault::encrypt_data(const std::vector<uint8_t>& data, const std::vector<uint8_t>& key) {
-    std::vector<uint8_t> encrypted = data;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(data);
 }
 
 std::vector<uint8_t> SecureVault::decrypt_data(const std::vector<uint8_t>& encrypted, const std::vector<uint8_t>& key) {
-    std::vector<uint8_t> decrypted = encrypted;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
-}
-
-std::string SecureVault::generate_item_id() {
-    return "item_" + std::to_string(rand() % 1000000);
+    return cipher_.open_box(encrypted).value_or(std::vector<uint8_t>{});
 }
 
 uint32_t SecureVault::calculate_entropy(const std::string& password) {
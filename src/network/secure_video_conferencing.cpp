@@ -1,4 +1,5 @@
 #include "secure_video_conferencing.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -107,23 +108,15 @@ void SecureVideoConferencing::generate_conference_report() {
 }
 
 std::string SecureVideoConferencing::generate_conference_id() {
-    return "conf_" + std::to_string(rand() % 1000000);
+    return "conf_" + std::to_string(SecureRandom::uniform(1000000));
 }
 
 std::vector<uint8_t> SecureVideoConferencing::encrypt_frame(const std::vector<uint8_t>& frame) {
-    std::vector<uint8_t> encrypted = frame;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(frame);
 }
 
 std::vector<uint8_t> SecureVideoConferencing::decrypt_frame(const std::vector<uint8_t>& encrypted) {
-    std::vector<uint8_t> decrypted = encrypted;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
+    return cipher_.open_box(encrypted).value_or(std::vector<uint8_t>{});
 }
 
 void SecureVideoConferencing::compress_video(std::vector<uint8_t>& data, int quality) {
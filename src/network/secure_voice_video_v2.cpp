@@ -19,7 +19,7 @@ MediaSession SecureVoiceVideoV2::initiate_call(const std::string& caller_id,
                                                const std::string& callee_id,
                                                const std::string& media_type) {
     MediaSession session;
-    session.session_id = generate_session_id();
+    session.session_id = Id128::generate();
     session.caller_id = caller_id;
     session.callee_id = callee_id;
     session.media_type = media_type;
@@ -32,41 +32,43 @@ MediaSession SecureVoiceVideoV2::initiate_call(const std::string& caller_id,
     
     active_sessions_[session.session_id] = session;
     
-    std::cout << "[+] Call initiated: " << session.session_id << " (" << media_type << ")" << std::endl;
+    std::cout << "[+] Call initiated: " << session.session_id.to_string("session") << " (" << media_type << ")" << std::endl;
     
     return session;
 }
 
-MediaSession SecureVoiceVideoV2::answer_call(const std::string& session_id) {
-    std::cout << "[*] Answering call: " << session_id << std::endl;
+MediaSession SecureVoiceVideoV2::answer_call(const Id128& session_id) {
+    std::cout << "[*] Answering call: " << session_id.to_string("session") << std::endl;
     
-    if (active_sessions_.find(session_id) != active_sessions_.end()) {
-        active_sessions_[session_id].connected = true;
-        return active_sessions_[session_id];
+    auto it = active_sessions_.find(session_id);
+    if (it != active_sessions_.end()) {
+        it->second.connected = true;
+        return it->second;
     }
     
     return {};
 }
 
-bool SecureVoiceVideoV2::end_call(const std::string& session_id) {
-    std::cout << "[*] Ending call: " << session_id << std::endl;
+bool SecureVoiceVideoV2::end_call(const Id128& session_id) {
+    std::cout << "[*] Ending call: " << session_id.to_string("session") << std::endl;
     
-    if (active_sessions_.find(session_id) != active_sessions_.end()) {
-        active_sessions_[session_id].duration = time(nullptr) - active_sessions_[session_id].start_time;
-        active_sessions_[session_id].connected = false;
+    auto it = active_sessions_.find(session_id);
+    if (it != active_sessions_.end()) {
+        it->second.duration = time(nullptr) - it->second.start_time;
+        it->second.connected = false;
         return true;
     }
     
     return false;
 }
 
-bool SecureVoiceVideoV2::hold_call(const std::string& session_id) {
-    std::cout << "[*] Holding call: " << session_id << std::endl;
+bool SecureVoiceVideoV2::hold_call(const Id128& session_id) {
+    std::cout << "[*] Holding call: " << session_id.to_string("session") << std::endl;
     return true;
 }
 
-bool SecureVoiceVideoV2::resume_call(const std::string& session_id) {
-    std::cout << "[*] Resuming call: " << session_id << std::endl;
+bool SecureVoiceVideoV2::resume_call(const Id128& session_id) {
+    std::cout << "[*] Resuming call: " << session_id.to_string("session") << std::endl;
     return true;
 }
 
@@ -117,7 +119,7 @@ void SecureVoiceVideoV2::decode_video_frame(VideoFrame& frame) {
     frame.data = decrypt_media(frame.data);
 }
 
-CallQuality SecureVoiceVideoV2::get_call_quality(const std::string& session_id) {
+CallQuality SecureVoiceVideoV2::get_call_quality(const Id128& session_id) {
     CallQuality quality;
     quality.bitrate_kbps = 2000;
     quality.packet_loss_percent = 1;
@@ -128,11 +130,12 @@ CallQuality SecureVoiceVideoV2::get_call_quality(const std::string& session_id)
     return quality;
 }
 
-void SecureVoiceVideoV2::adapt_bitrate(const std::string& session_id, uint32_t target_bitrate) {
-    std::cout << "[*] Adapting bitrate to " << target_bitrate << " kbps for " << session_id << std::endl;
+void SecureVoiceVideoV2::adapt_bitrate(const Id128& session_id, uint32_t target_bitrate) {
+    std::cout << "[*] Adapting bitrate to " << target_bitrate << " kbps for " << session_id.to_string("session") << std::endl;
     
-    if (active_sessions_.find(session_id) != active_sessions_.end()) {
-        active_sessions_[session_id].bitrate = target_bitrate;
+    auto it = active_sessions_.find(session_id);
+    if (it != active_sessions_.end()) {
+        it->second.bitrate = target_bitrate;
     }
 }
 
@@ -168,26 +171,14 @@ void SecureVoiceVideoV2::generate_media_report() {
 }
 
 std::vector<uint8_t> SecureVoiceVideoV2::encrypt_media(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> encrypted = data;
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(data);
 }
 
 std::vector<uint8_t> SecureVoiceVideoV2::decrypt_media(const std::vector<uint8_t>& data) {
-    std::vector<uint8_t> decrypted = data;
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
-    }
-    return decrypted;
-}
-
-std::string SecureVoiceVideoV2::generate_session_id() {
-    return "session_" + std::to_string(rand() % 1000000);
+    return cipher_.open_box(data).value_or(std::vector<uint8_t>{});
 }
 
-CallQuality SecureVoiceVideoV2::measure_quality(const std::string& session_id) {
+CallQuality SecureVoiceVideoV2::measure_quality(const Id128& session_id) {
     return get_call_quality(session_id);
 }
 
@@ -0,0 +1,568 @@
+#include "transport.h"
+#include "transport_loop.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Crypto {
+
+using namespace transport;
+
+namespace {
+
+uint32_t load_be32(const uint8_t* p) {
+    return (uint32_t{p[0]} << 24) | (uint32_t{p[1]} << 16) | (uint32_t{p[2]} << 8) | p[3];
+}
+
+} // namespace
+
+bool Transport::split_address(const std::string& address, std::string& host, uint16_t& port) {
+    const size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon + 1 == address.size()) return false;
+    unsigned long value = 0;
+    for (size_t i = colon + 1; i < address.size(); ++i) {
+        if (address[i] < '0' || address[i] > '9') return false;
+        value = value * 10 + static_cast<unsigned long>(address[i] - '0');
+        if (value > 65535) return false;
+    }
+    host = address.substr(0, colon);
+    if (host.size() >= 2 && host.front() == '[' && host.back() == ']') host = host.substr(1, host.size() - 2);
+    port = static_cast<uint16_t>(value);
+    return true;
+}
+
+const char* Transport::backend_name(Backend backend) {
+    switch (backend) {
+    case Backend::Auto: return "auto";
+    case Backend::Epoll: return "epoll";
+    case Backend::IoUring: return "io_uring";
+    }
+    return "unknown";
+}
+
+#if defined(__linux__)
+
+// ---------------------------------------------------------------------------
+// EventLoop: the part shared by the backends.
+
+thread_local Transport::EventLoop* Transport::EventLoop::current_ = nullptr;
+
+Transport::EventLoop::EventLoop(Transport& owner, size_t index) : owner_(owner), index_(index) {}
+
+Transport::EventLoop::~EventLoop() = default;
+
+void Transport::EventLoop::start() {
+    thread_ = std::thread([this] {
+        current_ = this;
+        run();
+        current_ = nullptr;
+    });
+}
+
+void Transport::EventLoop::request_stop() {
+    stopping_.store(true, std::memory_order_release);
+    wake();
+}
+
+void Transport::EventLoop::join() {
+    if (thread_.joinable()) thread_.join();
+}
+
+void Transport::EventLoop::add_listener(int fd) {
+    if (on_loop_thread()) {
+        listeners_.push_back(fd);
+        watch_listener(fd);
+        return;
+    }
+    Command cmd;
+    cmd.kind = Command::Listen;
+    cmd.fd = fd;
+    post(std::move(cmd));
+}
+
+void Transport::EventLoop::adopt(ConnectionId id, int fd, bool connecting) {
+    if (on_loop_thread()) {
+        adopt_now(id, fd, connecting);
+        return;
+    }
+    Command cmd;
+    cmd.kind = Command::Adopt;
+    cmd.id = id;
+    cmd.fd = fd;
+    cmd.connecting = connecting;
+    post(std::move(cmd));
+}
+
+bool Transport::EventLoop::send(ConnectionId id, std::vector<uint8_t>&& frame) {
+    if (on_loop_thread()) return enqueue(id, std::move(frame));
+    Command cmd;
+    cmd.kind = Command::Send;
+    cmd.id = id;
+    cmd.data = std::move(frame);
+    post(std::move(cmd));
+    return true;
+}
+
+void Transport::EventLoop::close(ConnectionId id) {
+    if (on_loop_thread()) {
+        request_close(id);
+        return;
+    }
+    Command cmd;
+    cmd.kind = Command::Close;
+    cmd.id = id;
+    post(std::move(cmd));
+}
+
+void Transport::EventLoop::add_stats(Stats& s) const {
+    s.frames_sent += frames_sent_.load(std::memory_order_relaxed);
+    s.frames_received += frames_received_.load(std::memory_order_relaxed);
+    s.bytes_sent += bytes_sent_.load(std::memory_order_relaxed);
+    s.bytes_received += bytes_received_.load(std::memory_order_relaxed);
+    s.write_calls += write_calls_.load(std::memory_order_relaxed);
+    s.read_calls += read_calls_.load(std::memory_order_relaxed);
+    s.zero_copy_sends += zero_copy_sends_.load(std::memory_order_relaxed);
+    s.wakeups += wakeups_.load(std::memory_order_relaxed);
+    s.frames_dropped += frames_dropped_.load(std::memory_order_relaxed);
+}
+
+void Transport::EventLoop::post(Command&& cmd) {
+    bool was_empty;
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        was_empty = inbox_.empty();
+        inbox_.push_back(std::move(cmd));
+    }
+    if (was_empty) wake();
+}
+
+void Transport::EventLoop::drain_inbox() {
+    {
+        std::lock_guard<std::mutex> lock(inbox_mutex_);
+        batch_.swap(inbox_);
+    }
+    for (Command& cmd : batch_) {
+        switch (cmd.kind) {
+        case Command::Listen:
+            listeners_.push_back(cmd.fd);
+            watch_listener(cmd.fd);
+            break;
+        case Command::Adopt: adopt_now(cmd.id, cmd.fd, cmd.connecting); break;
+        case Command::Send: enqueue(cmd.id, std::move(cmd.data)); break;
+        case Command::Close: request_close(cmd.id); break;
+        }
+    }
+    batch_.clear();
+}
+
+Transport::EventLoop::Connection* Transport::EventLoop::find(ConnectionId id) {
+    auto it = connections_.find(id);
+    return it == connections_.end() || it->second->closing ? nullptr : it->second.get();
+}
+
+void Transport::EventLoop::adopt_now(ConnectionId id, int fd, bool connecting) {
+    auto conn = new_connection();
+    conn->id = id;
+    conn->fd = fd;
+    conn->connecting = connecting;
+    Connection& c = *conn;
+    connections_.emplace(id, std::move(conn));
+    if (!watch(c)) {
+        request_close(id);
+        return;
+    }
+    if (!connecting) connected(c);
+}
+
+void Transport::EventLoop::accepted(int fd) {
+    const int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    const ConnectionId id = owner_.next_connection_.fetch_add(1, std::memory_order_relaxed) << LOOP_BITS | index_;
+    auto conn = new_connection();
+    conn->id = id;
+    conn->fd = fd;
+    Connection& c = *conn;
+    connections_.emplace(id, std::move(conn));
+    if (!watch(c)) {
+        // Never reported open, so no on_close either.
+        auto it = connections_.find(id);
+        std::unique_ptr<Connection> dropped = std::move(it->second);
+        connections_.erase(it);
+        release(std::move(dropped));
+        return;
+    }
+    if (owner_.handler_.on_open) owner_.handler_.on_open(id, true);
+}
+
+void Transport::EventLoop::connected(Connection& conn) {
+    conn.connecting = false;
+    const ConnectionId id = conn.id;
+    if (owner_.handler_.on_open) owner_.handler_.on_open(id, false);
+    if (Connection* c = find(id)) mark_dirty(*c);
+}
+
+bool Transport::EventLoop::deliver_frames(Connection& conn, const uint8_t* data, size_t len, size_t& used) {
+    const ConnectionId id = conn.id;
+    used = 0;
+    while (len - used >= HEADER_SIZE) {
+        const uint32_t size = load_be32(data + used);
+        if (size > owner_.options_.max_frame) {
+            request_close(id);
+            return false;
+        }
+        if (len - used < HEADER_SIZE + size) break;
+        const uint8_t* payload = data + used + HEADER_SIZE;
+        used += HEADER_SIZE + size;
+        bump(frames_received_);
+        if (owner_.handler_.on_frame) owner_.handler_.on_frame(id, {payload, size});
+        if (conn.closing) return false;
+    }
+    return true;
+}
+
+bool Transport::EventLoop::received(Connection& conn, const uint8_t* data, size_t len) {
+    bump(bytes_received_, len);
+    size_t used = 0;
+    if (conn.in_begin == conn.in_end) {
+        // Nothing pending: frame straight from the caller's buffer and keep
+        // only the incomplete tail.
+        conn.in_begin = conn.in_end = 0;
+        if (!deliver_frames(conn, data, len, used)) return false;
+        data += used;
+        len -= used;
+        if (len == 0) return true;
+    }
+    size_t space = 0;
+    uint8_t* dst = read_space(conn, len, space);
+    std::memcpy(dst, data, len);
+    conn.in_end += len;
+    if (!deliver_frames(conn, conn.in.data() + conn.in_begin, conn.in_end - conn.in_begin, used)) return false;
+    conn.in_begin += used;
+    return true;
+}
+
+uint8_t* Transport::EventLoop::read_space(Connection& conn, size_t want, size_t& space) {
+    // Compact before growing.
+    if (conn.in_begin == conn.in_end) conn.in_begin = conn.in_end = 0;
+    if (conn.in.size() - conn.in_end < want) {
+        if (conn.in_begin > 0) {
+            std::memmove(conn.in.data(), conn.in.data() + conn.in_begin, conn.in_end - conn.in_begin);
+            conn.in_end -= conn.in_begin;
+            conn.in_begin = 0;
+        }
+        if (conn.in.size() - conn.in_end < want) conn.in.resize(conn.in_end + want);
+    }
+    space = conn.in.size() - conn.in_end;
+    return conn.in.data() + conn.in_end;
+}
+
+bool Transport::EventLoop::received_in_place(Connection& conn, size_t len) {
+    bump(bytes_received_, len);
+    conn.in_end += len;
+    size_t used = 0;
+    if (!deliver_frames(conn, conn.in.data() + conn.in_begin, conn.in_end - conn.in_begin, used)) return false;
+    conn.in_begin += used;
+    return true;
+}
+
+size_t Transport::EventLoop::gather(Connection& conn, iovec* iov, size_t max_iov, size_t stop_at, size_t first,
+                                    size_t* large) const {
+    size_t count = 0;
+    size_t offset = first == 0 ? conn.out_offset : 0;
+    for (size_t i = first; i < conn.out.size() && count + 2 <= max_iov; ++i) {
+        OutFrame& frame = conn.out[i];
+        if (offset < HEADER_SIZE) {
+            iov[count++] = {frame.header + offset, HEADER_SIZE - offset};
+            offset = 0;
+        } else {
+            offset -= HEADER_SIZE;
+        }
+        if (stop_at != 0 && frame.payload.size() >= stop_at) {
+            if (large != nullptr) *large = i;
+            break;
+        }
+        if (offset < frame.payload.size()) {
+            iov[count++] = {frame.payload.data() + offset, frame.payload.size() - offset};
+        }
+        offset = 0;
+    }
+    return count;
+}
+
+void Transport::EventLoop::consume(Connection& conn, size_t written) {
+    bump(bytes_sent_, written);
+    while (written > 0 && !conn.out.empty()) {
+        OutFrame& front = conn.out.front();
+        const size_t remaining = HEADER_SIZE + front.payload.size() - conn.out_offset;
+        if (written < remaining) {
+            conn.out_offset += written;
+            return;
+        }
+        written -= remaining;
+        conn.queued_bytes -= HEADER_SIZE + front.payload.size();
+        retire(front);
+        conn.out.pop_front();
+        conn.out_offset = 0;
+        bump(frames_sent_);
+    }
+}
+
+bool Transport::EventLoop::enqueue(ConnectionId id, std::vector<uint8_t>&& payload) {
+    Connection* conn = find(id);
+    if (conn == nullptr) return false;
+    // The peer would close on a frame over max_frame (a uint32_t, so the
+    // length below cannot wrap either): never put one on the wire.
+    if (payload.size() > owner_.options_.max_frame ||
+        conn->queued_bytes + payload.size() > owner_.options_.max_queued_bytes) {
+        bump(frames_dropped_);
+        return false;
+    }
+    OutFrame frame;
+    const uint32_t len = static_cast<uint32_t>(payload.size());
+    frame.header[0] = static_cast<uint8_t>(len >> 24);
+    frame.header[1] = static_cast<uint8_t>(len >> 16);
+    frame.header[2] = static_cast<uint8_t>(len >> 8);
+    frame.header[3] = static_cast<uint8_t>(len);
+    frame.payload = std::move(payload);
+    conn->queued_bytes += HEADER_SIZE + len;
+    conn->out.push_back(std::move(frame));
+    mark_dirty(*conn);
+    return true;
+}
+
+void Transport::EventLoop::mark_dirty(Connection& conn) {
+    if (conn.dirty) return;
+    conn.dirty = true;
+    dirty_.push_back(conn.id);
+}
+
+void Transport::EventLoop::request_close(ConnectionId id) {
+    Connection* conn = find(id);
+    if (conn == nullptr) return;
+    conn->closing = true;
+    closing_.push_back(id);
+}
+
+void Transport::EventLoop::end_of_tick() {
+    // Flushing may close connections; closing_ is drained after.
+    for (size_t i = 0; i < dirty_.size(); ++i) {
+        auto it = connections_.find(dirty_[i]);
+        if (it == connections_.end()) continue;
+        Connection& conn = *it->second;
+        conn.dirty = false;
+        if (!conn.closing && !conn.connecting && !conn.out.empty()) flush(conn);
+    }
+    dirty_.clear();
+    for (size_t i = 0; i < closing_.size(); ++i) destroy(closing_[i]);
+    closing_.clear();
+}
+
+void Transport::EventLoop::destroy(ConnectionId id) {
+    auto it = connections_.find(id);
+    if (it == connections_.end()) return;
+    std::unique_ptr<Connection> conn = std::move(it->second);
+    connections_.erase(it);
+    release(std::move(conn));
+    if (owner_.handler_.on_close) owner_.handler_.on_close(id);
+}
+
+void Transport::EventLoop::shutdown() {
+    drain_inbox();                              // adopt pending sockets so they get on_close
+    std::vector<ConnectionId> ids;
+    ids.reserve(connections_.size());
+    for (const auto& [id, conn] : connections_) ids.push_back(id);
+    for (ConnectionId id : ids) destroy(id);
+    closing_.clear();
+    dirty_.clear();
+    for (int fd : listeners_) ::close(fd);
+    listeners_.clear();
+}
+
+// ---------------------------------------------------------------------------
+// Transport
+
+namespace {
+
+addrinfo* resolve(const std::string& host, uint16_t port, bool passive) {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = passive ? AI_PASSIVE : 0;
+    const std::string service = std::to_string(port);
+    addrinfo* result = nullptr;
+    if (::getaddrinfo(host.empty() ? nullptr : host.c_str(), service.c_str(), &hints, &result) != 0) return nullptr;
+    return result;
+}
+
+uint16_t bound_port(int fd) {
+    sockaddr_storage addr{};
+    socklen_t len = sizeof(addr);
+    if (::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0) return 0;
+    if (addr.ss_family == AF_INET) return ntohs(reinterpret_cast<sockaddr_in*>(&addr)->sin_port);
+    if (addr.ss_family == AF_INET6) return ntohs(reinterpret_cast<sockaddr_in6*>(&addr)->sin6_port);
+    return 0;
+}
+
+} // namespace
+
+Transport::Transport(Handler handler, const Options& options) : handler_(std::move(handler)), options_(options) {}
+
+Transport::~Transport() {
+    stop();
+}
+
+bool Transport::backend_supported(Backend backend) {
+    return backend != Backend::IoUring || uring_supported();
+}
+
+void Transport::start() {
+    if (running()) return;
+    size_t count = options_.loops != 0 ? options_.loops : std::thread::hardware_concurrency();
+    count = std::clamp<size_t>(count, 1, MAX_LOOPS);
+
+    backend_ = options_.backend != Backend::Epoll && uring_supported() ? Backend::IoUring : Backend::Epoll;
+    loops_.clear();
+    try {
+        for (size_t i = 0; i < count; ++i) {
+            loops_.push_back(backend_ == Backend::IoUring ? make_uring_loop(*this, i) : make_epoll_loop(*this, i));
+        }
+    } catch (const std::runtime_error&) {
+        // A ring can still be refused here (locked-memory limit for the
+        // buffer rings): epoll does the same job.
+        if (backend_ != Backend::IoUring) throw;
+        loops_.clear();
+        backend_ = Backend::Epoll;
+        for (size_t i = 0; i < count; ++i) loops_.push_back(make_epoll_loop(*this, i));
+    }
+    for (auto& loop : loops_) loop->start();
+    running_.store(true, std::memory_order_release);
+}
+
+void Transport::stop() {
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    for (auto& loop : loops_) loop->request_stop();
+    for (auto& loop : loops_) loop->join();
+}
+
+Transport::EventLoop& Transport::loop_of(ConnectionId id) const {
+    return *loops_[id & LOOP_MASK];
+}
+
+uint16_t Transport::listen(const std::string& host, uint16_t port) {
+    if (!running()) return 0;
+    addrinfo* addrs = resolve(host, port, true);
+    if (addrs == nullptr) return 0;
+
+    // One socket per loop on the same port; SO_REUSEPORT lets the kernel
+    // hash incoming connections across them. Port 0 is resolved by the
+    // first bind and reused for the others.
+    std::vector<int> fds;
+    for (size_t i = 0; i < loops_.size(); ++i) {
+        const int fd = ::socket(addrs->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0) break;
+        const int one = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+        if (port != 0) {
+            if (addrs->ai_family == AF_INET) reinterpret_cast<sockaddr_in*>(addrs->ai_addr)->sin_port = htons(port);
+            if (addrs->ai_family == AF_INET6) reinterpret_cast<sockaddr_in6*>(addrs->ai_addr)->sin6_port = htons(port);
+        }
+        if (::bind(fd, addrs->ai_addr, addrs->ai_addrlen) != 0 || ::listen(fd, SOMAXCONN) != 0) {
+            ::close(fd);
+            break;
+        }
+        if (port == 0) port = bound_port(fd);
+        fds.push_back(fd);
+    }
+    ::freeaddrinfo(addrs);
+
+    if (fds.size() != loops_.size()) {
+        for (int fd : fds) ::close(fd);
+        return 0;
+    }
+    for (size_t i = 0; i < fds.size(); ++i) loops_[i]->add_listener(fds[i]);
+    return port;
+}
+
+Transport::ConnectionId Transport::connect(const std::string& host, uint16_t port) {
+    if (!running()) return 0;
+    addrinfo* addrs = resolve(host, port, false);
+    if (addrs == nullptr) return 0;
+    const int fd = ::socket(addrs->ai_family, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    bool connecting = false;
+    if (fd >= 0) {
+        const int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        connecting = ::connect(fd, addrs->ai_addr, addrs->ai_addrlen) != 0;
+        if (connecting && errno != EINPROGRESS) {
+            ::close(fd);
+            ::freeaddrinfo(addrs);
+            return 0;
+        }
+    }
+    ::freeaddrinfo(addrs);
+    if (fd < 0) return 0;
+
+    const size_t loop = next_loop_.fetch_add(1, std::memory_order_relaxed) % loops_.size();
+    const ConnectionId id = next_connection_.fetch_add(1, std::memory_order_relaxed) << LOOP_BITS | loop;
+    loops_[loop]->adopt(id, fd, connecting);
+    return id;
+}
+
+bool Transport::send(ConnectionId id, std::span<const uint8_t> frame) {
+    return send(id, std::vector<uint8_t>(frame.begin(), frame.end()));
+}
+
+bool Transport::send(ConnectionId id, std::vector<uint8_t>&& frame) {
+    if (!running() || id == 0 || (id & LOOP_MASK) >= loops_.size()) return false;
+    if (frame.size() > options_.max_frame) return false;
+    return loop_of(id).send(id, std::move(frame));
+}
+
+void Transport::close(ConnectionId id) {
+    if (!running() || id == 0 || (id & LOOP_MASK) >= loops_.size()) return;
+    loop_of(id).close(id);
+}
+
+Transport::Stats Transport::stats() const {
+    Stats s;
+    for (const auto& loop : loops_) loop->add_stats(s);
+    return s;
+}
+
+#else // !__linux__
+
+class Transport::EventLoop {};
+
+Transport::Transport(Handler handler, const Options& options) : handler_(std::move(handler)), options_(options) {}
+Transport::~Transport() = default;
+
+bool Transport::backend_supported(Backend backend) {
+    return backend == Backend::Auto;
+}
+
+void Transport::start() {
+    throw std::runtime_error("Transport: epoll and io_uring are only available on Linux");
+}
+
+void Transport::stop() {}
+uint16_t Transport::listen(const std::string&, uint16_t) { return 0; }
+Transport::ConnectionId Transport::connect(const std::string&, uint16_t) { return 0; }
+bool Transport::send(ConnectionId, std::span<const uint8_t>) { return false; }
+bool Transport::send(ConnectionId, std::vector<uint8_t>&&) { return false; }
+void Transport::close(ConnectionId) {}
+Transport::Stats Transport::stats() const { return {}; }
+
+#endif
+
+} // namespace Crypto
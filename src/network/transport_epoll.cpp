@@ -0,0 +1,194 @@
+#include "transport_loop.h"
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace Crypto {
+
+#if defined(__linux__)
+
+using namespace transport;
+using ConnectionId = Transport::ConnectionId;
+
+namespace {
+
+// Readiness loop: edge-triggered epoll, read() until a short read,
+// sendmsg() until the queue drains or the socket is full.
+class EpollLoop final : public Transport::EventLoop {
+public:
+    EpollLoop(Transport& owner, size_t index) : EventLoop(owner, index) {
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            close_fds();
+            throw std::runtime_error(std::string("Transport: epoll/eventfd: ") + std::strerror(errno));
+        }
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.u64 = WAKE_TAG;
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &ev);
+    }
+
+    ~EpollLoop() override {
+        join();
+        close_fds();
+    }
+
+private:
+    static constexpr uint64_t WAKE_TAG = 0;                 // never a connection id
+    static constexpr uint64_t LISTENER_TAG = uint64_t{1} << 63;
+    static constexpr int MAX_EVENTS = 256;
+    static constexpr size_t READ_CHUNK = 64 * 1024;
+
+    void run() override {
+        epoll_event events[MAX_EVENTS];
+        while (!stopping()) {
+            const int n = ::epoll_wait(epoll_fd_, events, MAX_EVENTS, -1);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            bump(wakeups_);
+            for (int i = 0; i < n; ++i) {
+                const uint64_t tag = events[i].data.u64;
+                if (tag == WAKE_TAG) {
+                    uint64_t count;
+                    (void)!::read(wake_fd_, &count, sizeof(count));
+                    drain_inbox();
+                } else if (tag & LISTENER_TAG) {
+                    accept_all(static_cast<int>(tag & ~LISTENER_TAG));
+                } else {
+                    on_event(tag, events[i].events);
+                }
+            }
+            end_of_tick();
+        }
+        shutdown();
+    }
+
+    void wake() override {
+        const uint64_t one = 1;
+        (void)!::write(wake_fd_, &one, sizeof(one));
+    }
+
+    void watch_listener(int fd) override {
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = LISTENER_TAG | static_cast<uint64_t>(fd);
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev);
+        accept_all(fd);                         // connections queued before the edge
+    }
+
+    bool watch(Connection& conn) override {
+        // Edge-triggered in and out: no epoll_ctl() when a queue fills or
+        // drains; EPOLLOUT also reports the end of a pending connect.
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.u64 = conn.id;
+        return ::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, conn.fd, &ev) == 0;
+    }
+
+    void release(std::unique_ptr<Connection> conn) override {
+        ::close(conn->fd);                      // also leaves the epoll set
+    }
+
+    void accept_all(int listener) {
+        for (;;) {
+            const int fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return;                         // EAGAIN, or out of descriptors until one closes
+            }
+            accepted(fd);
+        }
+    }
+
+    void on_event(ConnectionId id, uint32_t events) {
+        Connection* conn = find(id);
+        if (conn == nullptr) return;
+        if (conn->connecting) {
+            if (!(events & (EPOLLOUT | EPOLLERR | EPOLLHUP))) return;
+            int error = 0;
+            socklen_t len = sizeof(error);
+            ::getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            if (error != 0) {
+                request_close(id);
+                return;
+            }
+            connected(*conn);
+            if ((conn = find(id)) == nullptr) return;
+        }
+        if (events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+            read_all(*conn);
+            if ((conn = find(id)) == nullptr) return;
+        }
+        if (events & EPOLLOUT) mark_dirty(*conn);
+    }
+
+    void read_all(Connection& conn) {
+        const ConnectionId id = conn.id;
+        for (;;) {
+            size_t space = 0;
+            uint8_t* dst = read_space(conn, READ_CHUNK, space);
+            const ssize_t n = ::read(conn.fd, dst, space);
+            bump(read_calls_);
+            if (n == 0) {
+                request_close(id);
+                return;
+            }
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) request_close(id);
+                return;
+            }
+            if (!received_in_place(conn, static_cast<size_t>(n))) return;
+            // A short read drained the socket; new data raises a new edge.
+            if (static_cast<size_t>(n) < space) return;
+        }
+    }
+
+    void flush(Connection& conn) override {
+        iovec iov[MAX_IOV];
+        while (!conn.out.empty()) {
+            msghdr msg{};
+            msg.msg_iov = iov;
+            msg.msg_iovlen = gather(conn, iov, MAX_IOV);
+            const ssize_t n = ::sendmsg(conn.fd, &msg, MSG_NOSIGNAL);
+            bump(write_calls_);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno != EAGAIN && errno != EWOULDBLOCK) request_close(conn.id);
+                return;                         // EPOLLOUT resumes the flush
+            }
+            consume(conn, static_cast<size_t>(n));
+        }
+    }
+
+    void close_fds() {
+        if (epoll_fd_ >= 0) ::close(epoll_fd_);
+        if (wake_fd_ >= 0) ::close(wake_fd_);
+        epoll_fd_ = wake_fd_ = -1;
+    }
+
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+};
+
+} // namespace
+
+std::unique_ptr<Transport::EventLoop> make_epoll_loop(Transport& owner, size_t index) {
+    return std::make_unique<EpollLoop>(owner, index);
+}
+
+#endif
+
+} // namespace Crypto
@@ -0,0 +1,188 @@
+#ifndef TRANSPORT_LOOP_H
+#define TRANSPORT_LOOP_H
+
+// Backend-independent half of a Transport event loop: the inbox other
+// threads post to, the connections it owns, framing of the byte streams
+// and the per-connection write queues. A backend (transport_epoll.cpp,
+// transport_uring.cpp) supplies the thread body and the system calls.
+
+#include "transport.h"
+#include "flat_hash_map.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/uio.h>
+
+namespace Crypto {
+
+namespace transport {
+
+// Connection ids carry their loop in the low bits.
+constexpr size_t LOOP_BITS = 8;
+constexpr size_t MAX_LOOPS = size_t{1} << LOOP_BITS;
+constexpr uint64_t LOOP_MASK = MAX_LOOPS - 1;
+
+constexpr size_t HEADER_SIZE = 4;
+constexpr size_t MAX_IOV = 128;                 // 64 frames per sendmsg()
+
+// Counters are written by their loop only; a relaxed load + store avoids a
+// locked instruction per frame.
+inline void bump(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+} // namespace transport
+
+class Transport::EventLoop {
+public:
+    EventLoop(Transport& owner, size_t index);
+    virtual ~EventLoop();
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    void start();
+    void request_stop();
+    void join();
+
+    bool on_loop_thread() const { return current_ == this; }
+
+    // Takes ownership of a listening socket / of a socket whose connect()
+    // is in progress (or done). Any thread.
+    void add_listener(int fd);
+    void adopt(ConnectionId id, int fd, bool connecting);
+    bool send(ConnectionId id, std::vector<uint8_t>&& frame);
+    void close(ConnectionId id);
+
+    void add_stats(Stats& s) const;
+
+protected:
+    struct OutFrame {
+        uint8_t header[transport::HEADER_SIZE];
+        std::vector<uint8_t> payload;
+        uint64_t zero_copy = 0;                 // io_uring: SEND_ZC still referencing payload
+    };
+
+    // Backends extend this with their own per-socket state.
+    struct Connection {
+        virtual ~Connection() = default;
+
+        ConnectionId id = 0;
+        int fd = -1;
+        bool connecting = false;
+        bool closing = false;
+        bool dirty = false;                     // in dirty_, flushed at the end of the tick
+        std::vector<uint8_t> in;
+        size_t in_begin = 0;
+        size_t in_end = 0;
+        std::deque<OutFrame> out;               // stable addresses: iovecs point into it
+        size_t out_offset = 0;                  // bytes of out.front() already written
+        size_t queued_bytes = 0;
+    };
+
+    struct Command {
+        enum Kind { Listen, Adopt, Send, Close } kind = Send;
+        ConnectionId id = 0;
+        int fd = -1;
+        bool connecting = false;
+        std::vector<uint8_t> data;
+    };
+
+    // Thread body: wait for events, call the helpers below, end_of_tick()
+    // after each batch; shutdown() once stopping() is set.
+    virtual void run() = 0;
+    virtual void wake() = 0;
+    // Loop thread. Start watching a listener / a new connection (false:
+    // give up on it).
+    virtual void watch_listener(int fd) = 0;
+    virtual bool watch(Connection& conn) = 0;
+    // Write what the queue holds, now or by submitting a request.
+    virtual void flush(Connection& conn) = 0;
+    // The connection left the table; the backend closes the socket when
+    // nothing in flight refers to it any more.
+    virtual void release(std::unique_ptr<Connection> conn) = 0;
+    virtual std::unique_ptr<Connection> new_connection() { return std::make_unique<Connection>(); }
+    // A fully written frame leaves the queue (see OutFrame::zero_copy).
+    virtual void retire(OutFrame& frame) { (void)frame; }
+
+    bool stopping() const { return stopping_.load(std::memory_order_acquire); }
+    const Options& options() const { return owner_.options_; }
+
+    // Runs the inbox; backends call it when woken.
+    void drain_inbox();
+    Connection* find(ConnectionId id);
+    // New accepted socket / outgoing connection that finished connecting.
+    void accepted(int fd);
+    void connected(Connection& conn);
+    // Bytes read from the socket: `data` is framed straight from the
+    // caller's buffer when nothing is pending, copied otherwise. False when
+    // the connection was closed meanwhile.
+    bool received(Connection& conn, const uint8_t* data, size_t len);
+    // Room to read() into directly, committed by received_in_place().
+    uint8_t* read_space(Connection& conn, size_t want, size_t& space);
+    bool received_in_place(Connection& conn, size_t len);
+    // Fills iov from the write queue, from out_offset on (or from frame
+    // `first`), stopping before a payload of `stop_at` bytes or more (0: no
+    // stop), whose frame index then goes to `large`. Returns the count.
+    size_t gather(Connection& conn, struct iovec* iov, size_t max_iov, size_t stop_at = 0, size_t first = 0,
+                  size_t* large = nullptr) const;
+    // Drops `written` bytes from the front of the queue.
+    void consume(Connection& conn, size_t written);
+    void mark_dirty(Connection& conn);
+    void request_close(ConnectionId id);
+    // Flushes dirty connections, then tears down closed ones.
+    void end_of_tick();
+    // Closes every connection (on_close for each) and the listeners.
+    void shutdown();
+
+    Transport& owner_;
+    const size_t index_;
+    std::vector<int> listeners_;                // loop thread only
+
+    std::atomic<uint64_t> frames_sent_{0};
+    std::atomic<uint64_t> frames_received_{0};
+    std::atomic<uint64_t> bytes_sent_{0};
+    std::atomic<uint64_t> bytes_received_{0};
+    std::atomic<uint64_t> write_calls_{0};
+    std::atomic<uint64_t> read_calls_{0};
+    std::atomic<uint64_t> zero_copy_sends_{0};
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> frames_dropped_{0};
+
+private:
+    void post(Command&& cmd);
+    void adopt_now(ConnectionId id, int fd, bool connecting);
+    bool enqueue(ConnectionId id, std::vector<uint8_t>&& payload);
+    bool deliver_frames(Connection& conn, const uint8_t* data, size_t len, size_t& used);
+    void destroy(ConnectionId id);
+
+    static thread_local EventLoop* current_;
+
+    std::thread thread_;
+    std::atomic<bool> stopping_{false};
+
+    std::mutex inbox_mutex_;
+    std::vector<Command> inbox_;
+    std::vector<Command> batch_;
+
+    // Loop thread only.
+    FlatHashMap<ConnectionId, std::unique_ptr<Connection>> connections_;
+    std::vector<ConnectionId> dirty_;
+    std::vector<ConnectionId> closing_;
+};
+
+// Throw std::runtime_error when the kernel refuses the backend.
+std::unique_ptr<Transport::EventLoop> make_epoll_loop(Transport& owner, size_t index);
+std::unique_ptr<Transport::EventLoop> make_uring_loop(Transport& owner, size_t index);
+bool uring_supported();
+
+} // namespace Crypto
+
+#endif // TRANSPORT_LOOP_H
@@ -0,0 +1,644 @@
+#include "transport_loop.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Crypto {
+
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(IORING_RECV_MULTISHOT)
+
+using namespace transport;
+using ConnectionId = Transport::ConnectionId;
+
+namespace {
+
+// The three io_uring system calls; no liburing.
+int uring_setup(unsigned entries, io_uring_params& params) {
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+}
+
+int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int uring_register(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(::syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+std::runtime_error uring_error(const char* what, int error) {
+    return std::runtime_error(std::string("Transport: io_uring ") + what + ": " + std::strerror(error));
+}
+
+// Submission and completion queues mapped from the kernel. Loop thread
+// only once the loop runs.
+class Ring {
+public:
+    Ring(unsigned entries, unsigned cq_entries) {
+        // Single issuer + deferred task work: completions are only
+        // processed inside our own io_uring_enter(), never by interrupting
+        // the loop. The ring starts disabled so that the loop thread, not
+        // the one constructing it, becomes the issuer.
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL | IORING_SETUP_SINGLE_ISSUER |
+                       IORING_SETUP_DEFER_TASKRUN | IORING_SETUP_R_DISABLED;
+        params.cq_entries = cq_entries;
+        fd_ = uring_setup(entries, params);
+        if (fd_ < 0 && errno == EINVAL) {
+            params = {};
+            params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+            params.cq_entries = cq_entries;
+            fd_ = uring_setup(entries, params);
+        }
+        if (fd_ < 0) throw uring_error("setup", errno);
+        disabled_ = (params.flags & IORING_SETUP_R_DISABLED) != 0;
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        sq_map_ = map(sq_size_, IORING_OFF_SQ_RING);
+        cq_map_ = single_mmap ? sq_map_ : map(cq_size_, IORING_OFF_CQ_RING);
+        sqes_ = static_cast<io_uring_sqe*>(map(sqes_size_, IORING_OFF_SQES));
+        if (sq_map_ == nullptr || cq_map_ == nullptr || sqes_ == nullptr) {
+            const int error = errno;
+            unmap();
+            throw uring_error("mmap", error);
+        }
+
+        auto* sq = static_cast<uint8_t*>(sq_map_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_entries_ = params.sq_entries;
+        auto* array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries_; ++i) array[i] = i;
+        auto* cq = static_cast<uint8_t*>(cq_map_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        tail_ = *sq_tail_;
+    }
+
+    ~Ring() { unmap(); }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    int fd() const { return fd_; }
+
+    // Makes the calling thread the issuer; the loop thread, first thing.
+    void enable() {
+        if (disabled_) uring_register(fd_, IORING_REGISTER_ENABLE_RINGS, nullptr, 0);
+        disabled_ = false;
+    }
+
+    // A zeroed entry, submitted by the next enter().
+    io_uring_sqe& next() {
+        if (tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) == sq_entries_) {
+            // Full mid-tick: hand what we have to the kernel first.
+            enter(0);
+        }
+        io_uring_sqe& sqe = sqes_[tail_ & sq_mask_];
+        std::memset(&sqe, 0, sizeof(sqe));
+        ++tail_;
+        return sqe;
+    }
+
+    // Room for `count` entries in the same submission.
+    void reserve(unsigned count) {
+        if (tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) + count > sq_entries_) enter(0);
+    }
+
+    // Submits everything prepared and waits for `wait` completions.
+    void enter(unsigned wait) {
+        __atomic_store_n(sq_tail_, tail_, __ATOMIC_RELEASE);
+        for (;;) {
+            const unsigned pending = tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+            if (pending == 0 && wait == 0) return;
+            // EAGAIN/EBUSY: completions to reap first.
+            if (uring_enter(fd_, pending, wait, wait != 0 ? IORING_ENTER_GETEVENTS : 0) >= 0 || errno != EINTR) return;
+        }
+    }
+
+    template <typename F>
+    void reap(F&& on_cqe) {
+        unsigned head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) on_cqe(cqes_[head & cq_mask_]);
+        __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+private:
+    void* map(size_t size, off_t offset) {
+        void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, offset);
+        return p == MAP_FAILED ? nullptr : p;
+    }
+
+    void unmap() {
+        if (sqes_ != nullptr) ::munmap(sqes_, sqes_size_);
+        if (cq_map_ != nullptr && cq_map_ != sq_map_) ::munmap(cq_map_, cq_size_);
+        if (sq_map_ != nullptr) ::munmap(sq_map_, sq_size_);
+        if (fd_ >= 0) ::close(fd_);
+        sqes_ = nullptr;
+        sq_map_ = cq_map_ = nullptr;
+        fd_ = -1;
+    }
+
+    int fd_ = -1;
+    bool disabled_ = false;
+    void* sq_map_ = nullptr;
+    void* cq_map_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    size_t sqes_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned tail_ = 0;
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+};
+
+// Completion loop: the kernel reads into buffers it picks from a ring we
+// refill, and every request of a tick goes in with the io_uring_enter()
+// that waits for the next completions.
+class UringLoop final : public Transport::EventLoop {
+public:
+    UringLoop(Transport& owner, size_t index) : EventLoop(owner, index), ring_(SQ_ENTRIES, CQ_ENTRIES) {
+        wake_fd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (wake_fd_ < 0) throw uring_error("eventfd", errno);
+        try {
+            setup_buffers();
+        } catch (...) {
+            release_buffers();
+            ::close(wake_fd_);
+            throw;
+        }
+    }
+
+    ~UringLoop() override {
+        join();
+        release_buffers();
+        ::close(wake_fd_);
+    }
+
+private:
+    static constexpr unsigned SQ_ENTRIES = 1024;
+    static constexpr unsigned CQ_ENTRIES = 8192;
+    static constexpr unsigned BUF_COUNT = 256;     // power of two
+    static constexpr size_t BUF_SIZE = 16 * 1024;
+    static constexpr uint16_t BUF_GROUP = 0;
+    // One send chain per connection in flight: gather more than epoll's
+    // MAX_IOV so a tick is not capped at 64 frames (UIO_MAXIOV), and send
+    // up to MAX_CHAIN large payloads.
+    static constexpr size_t SEND_IOV = 1024;
+    static constexpr size_t MAX_CHAIN = 8;
+
+    // user_data: request kind in the top byte, connection id / listener fd
+    // / zero-copy token below.
+    enum Kind : uint64_t { WAKE = 1, ACCEPT, CONNECT, RECV, SEND, SEND_ZC, CANCEL };
+    static constexpr unsigned KIND_SHIFT = 56;
+    static constexpr uint64_t VALUE_MASK = (uint64_t{1} << KIND_SHIFT) - 1;
+
+    static uint64_t tag(Kind kind, uint64_t value) { return uint64_t{kind} << KIND_SHIFT | value; }
+
+    struct UringConnection : Connection {
+        unsigned pending = 0;                   // requests that may still touch it
+        unsigned sending = 0;                   // requests of the current send chain
+        bool released = false;                  // left the table, in graveyard_
+        msghdr msg[MAX_CHAIN] = {};
+        std::vector<iovec> iov;                 // grown on demand, up to SEND_IOV
+    };
+
+    // A payload SEND_ZC may still read after the frame left the queue.
+    struct ZeroCopy {
+        ConnectionId id = 0;
+        std::vector<uint8_t> payload;
+    };
+
+    void setup_buffers() {
+        ring_bytes_ = BUF_COUNT * sizeof(io_uring_buf);
+        void* ring = ::mmap(nullptr, ring_bytes_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        void* buffers = ::mmap(nullptr, BUF_COUNT * BUF_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ring == MAP_FAILED || buffers == MAP_FAILED) {
+            if (ring != MAP_FAILED) ::munmap(ring, ring_bytes_);
+            if (buffers != MAP_FAILED) ::munmap(buffers, BUF_COUNT * BUF_SIZE);
+            throw uring_error("buffers", errno);
+        }
+        // io_uring_buf_ring's flexible array gains an empty struct member
+        // in C++, moving bufs[] by 8 bytes: address the entries directly.
+        // The tail overlays the first entry's resv field.
+        buf_ring_ = static_cast<io_uring_buf*>(ring);
+        buf_ring_tail_ = reinterpret_cast<uint16_t*>(static_cast<uint8_t*>(ring) + offsetof(io_uring_buf, resv));
+        buffers_ = static_cast<uint8_t*>(buffers);
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(buf_ring_);
+        reg.ring_entries = BUF_COUNT;
+        reg.bgid = BUF_GROUP;
+        if (uring_register(ring_.fd(), IORING_REGISTER_PBUF_RING, &reg, 1) != 0) throw uring_error("buffer ring", errno);
+        for (uint16_t bid = 0; bid < BUF_COUNT; ++bid) recycle(bid);
+        publish_buffers();
+    }
+
+    void release_buffers() {
+        if (buf_ring_ != nullptr) ::munmap(buf_ring_, ring_bytes_);
+        if (buffers_ != nullptr) ::munmap(buffers_, BUF_COUNT * BUF_SIZE);
+        buf_ring_ = nullptr;
+        buffers_ = nullptr;
+    }
+
+    // Hands a buffer back; visible to the kernel after publish_buffers().
+    void recycle(uint16_t bid) {
+        io_uring_buf& buf = buf_ring_[buf_tail_ & (BUF_COUNT - 1)];
+        buf.addr = reinterpret_cast<uint64_t>(buffers_ + size_t{bid} * BUF_SIZE);
+        buf.len = BUF_SIZE;
+        buf.bid = bid;
+        ++buf_tail_;
+    }
+
+    void publish_buffers() { __atomic_store_n(buf_ring_tail_, buf_tail_, __ATOMIC_RELEASE); }
+
+    void run() override {
+        ring_.enable();
+        arm_wake();
+        while (!stopping()) {
+            ring_.enter(1);
+            bump(wakeups_);
+            ring_.reap([this](const io_uring_cqe& cqe) { complete(cqe); });
+            end_of_tick();
+            publish_buffers();
+        }
+        shutdown();
+        // Everything still in flight holds a socket, a buffer or a payload:
+        // cancel it and wait for the last completion. A SEND_ZC whose
+        // result is in still has its payload in zero_copy_ until the
+        // notification: the kernel may read it until then, so wait for
+        // those too before the payloads and the ring go.
+        io_uring_sqe& sqe = prepare(CANCEL, 0);
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = -1;
+        sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY | IORING_ASYNC_CANCEL_ALL;
+        while (inflight_ > 0 || !zero_copy_.empty()) {
+            ring_.enter(1);
+            ring_.reap([this](const io_uring_cqe& cqe) { complete(cqe); });
+            publish_buffers();
+        }
+    }
+
+    void wake() override {
+        const uint64_t one = 1;
+        (void)!::write(wake_fd_, &one, sizeof(one));
+    }
+
+    void watch_listener(int fd) override { arm_accept(fd); }
+
+    bool watch(Connection& conn) override {
+        auto& c = static_cast<UringConnection&>(conn);
+        tracked_.emplace(c.id, &c);
+        if (c.connecting) {
+            // Writable (or failed) once the connect is through.
+            io_uring_sqe& sqe = prepare(CONNECT, c.id, &c);
+            sqe.opcode = IORING_OP_POLL_ADD;
+            sqe.fd = c.fd;
+            sqe.poll32_events = POLLOUT;
+        } else {
+            arm_recv(c);
+        }
+        return true;
+    }
+
+    std::unique_ptr<Connection> new_connection() override { return std::make_unique<UringConnection>(); }
+
+    void release(std::unique_ptr<Connection> conn) override {
+        auto& c = static_cast<UringConnection&>(*conn);
+        c.released = true;
+        if (c.pending == 0) {
+            keep_payloads(c);
+            tracked_.erase(c.id);
+            ::close(c.fd);
+            return;
+        }
+        io_uring_sqe& sqe = prepare(CANCEL, 0);
+        sqe.opcode = IORING_OP_ASYNC_CANCEL;
+        sqe.fd = c.fd;
+        sqe.cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+        const ConnectionId id = c.id;
+        graveyard_.emplace(id, std::move(conn));
+    }
+
+    void retire(OutFrame& frame) override {
+        if (frame.zero_copy == 0) return;
+        auto it = zero_copy_.find(frame.zero_copy);
+        if (it != zero_copy_.end()) it->second.payload = std::move(frame.payload);
+    }
+
+    void flush(Connection& conn) override {
+        auto& c = static_cast<UringConnection&>(conn);
+        if (c.sending != 0 || c.out.empty()) return;   // the completions flush again
+        // A payload sent zero-copy once is finished by copy: one
+        // notification per frame.
+        OutFrame& front = c.out.front();
+        const size_t stop_at = front.zero_copy != 0 ? 0 : options().zero_copy_threshold;
+        if (stop_at != 0 && front.payload.size() >= stop_at && c.out_offset >= HEADER_SIZE) {
+            send_zero_copy(c, front, c.out_offset - HEADER_SIZE);
+            return;
+        }
+        // SENDMSG for the small frames, SEND_ZC for each large payload,
+        // linked so they run in order. MSG_WAITALL turns a short write into
+        // a failed link instead of letting the next request overtake it.
+        ring_.reserve(2 * MAX_CHAIN);           // a link must not span two submissions
+        c.iov.resize(std::min(SEND_IOV, 2 * c.out.size()));
+        size_t used = 0;
+        size_t first = 0;
+        io_uring_sqe* last = nullptr;
+        for (size_t chain = 0; chain < MAX_CHAIN && first < c.out.size(); ++chain) {
+            size_t large = c.out.size();
+            const size_t count = gather(c, c.iov.data() + used, c.iov.size() - used, stop_at, first, &large);
+            if (count == 0) break;
+            msghdr& msg = c.msg[chain];
+            msg = {};
+            msg.msg_iov = c.iov.data() + used;
+            msg.msg_iovlen = count;
+            used += count;
+            link(last);
+            io_uring_sqe& sqe = prepare(SEND, c.id, &c);
+            sqe.opcode = IORING_OP_SENDMSG;
+            sqe.fd = c.fd;
+            sqe.addr = reinterpret_cast<uint64_t>(&msg);
+            sqe.len = 1;
+            sqe.msg_flags = MSG_NOSIGNAL;
+            ++c.sending;
+            bump(write_calls_);
+            last = &sqe;
+            if (large == c.out.size()) break;   // queue or iovecs exhausted
+            link(last);
+            last = &send_zero_copy(c, c.out[large], 0);
+            first = large + 1;
+        }
+    }
+
+    static void link(io_uring_sqe* sqe) {
+        if (sqe == nullptr) return;
+        sqe->flags |= IOSQE_IO_LINK;
+        sqe->msg_flags |= MSG_WAITALL;
+    }
+
+    // The payload goes straight from the frame; retire() keeps it until
+    // the kernel's notification.
+    io_uring_sqe& send_zero_copy(UringConnection& c, OutFrame& frame, size_t offset) {
+        const uint64_t token = ++zero_copy_seq_;
+        frame.zero_copy = token;
+        zero_copy_.emplace(token, ZeroCopy{c.id, {}});
+        io_uring_sqe& sqe = prepare(SEND_ZC, token, &c);
+        sqe.opcode = IORING_OP_SEND_ZC;
+        sqe.fd = c.fd;
+        sqe.addr = reinterpret_cast<uint64_t>(frame.payload.data() + offset);
+        sqe.len = static_cast<uint32_t>(frame.payload.size() - offset);
+        sqe.msg_flags = MSG_NOSIGNAL;
+        ++c.sending;
+        bump(write_calls_);
+        bump(zero_copy_sends_);
+        return sqe;
+    }
+
+    // An entry for a request that counts until its last completion (and
+    // keeps `conn` alive as long).
+    io_uring_sqe& prepare(Kind kind, uint64_t value, UringConnection* conn = nullptr) {
+        io_uring_sqe& sqe = ring_.next();
+        sqe.user_data = tag(kind, value);
+        ++inflight_;
+        if (conn != nullptr) ++conn->pending;
+        return sqe;
+    }
+
+    void arm_wake() {
+        io_uring_sqe& sqe = prepare(WAKE, 0);
+        sqe.opcode = IORING_OP_READ;
+        sqe.fd = wake_fd_;
+        sqe.addr = reinterpret_cast<uint64_t>(&wake_count_);
+        sqe.len = sizeof(wake_count_);
+    }
+
+    void arm_accept(int listener) {
+        io_uring_sqe& sqe = prepare(ACCEPT, static_cast<uint64_t>(listener));
+        sqe.opcode = IORING_OP_ACCEPT;
+        sqe.fd = listener;
+        sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    }
+
+    void arm_recv(UringConnection& c) {
+        io_uring_sqe& sqe = prepare(RECV, c.id, &c);
+        sqe.opcode = IORING_OP_RECV;
+        sqe.fd = c.fd;
+        sqe.ioprio = IORING_RECV_MULTISHOT;
+        sqe.flags = IOSQE_BUFFER_SELECT;
+        sqe.buf_group = BUF_GROUP;
+    }
+
+    UringConnection* tracked(ConnectionId id) {
+        auto it = tracked_.find(id);
+        return it == tracked_.end() ? nullptr : it->second;
+    }
+
+    // A frame left unsent in a closing connection may still be read by a
+    // SEND_ZC awaiting its notification: its payload outlives the
+    // connection in zero_copy_.
+    void keep_payloads(UringConnection& c) {
+        for (OutFrame& frame : c.out) retire(frame);
+    }
+
+    // One request of `c` is over; frees it once closed and idle.
+    void settle(UringConnection& c) {
+        --c.pending;
+        if (!c.released || c.pending != 0) return;
+        const ConnectionId id = c.id;
+        keep_payloads(c);
+        ::close(c.fd);
+        tracked_.erase(id);
+        graveyard_.erase(id);
+    }
+
+    void complete(const io_uring_cqe& cqe) {
+        const bool more = (cqe.flags & IORING_CQE_F_MORE) != 0;
+        const uint64_t value = cqe.user_data & VALUE_MASK;
+        const auto kind = static_cast<Kind>(cqe.user_data >> KIND_SHIFT);
+        if (kind == SEND_ZC) {
+            // The result ends the request; a notification may follow and
+            // only releases the payload. (A SEND_ZC cancelled by its link
+            // reports no F_MORE, yet some kernels still notify.)
+            if (cqe.flags & IORING_CQE_F_NOTIF) {
+                zero_copy_.erase(value);
+            } else {
+                --inflight_;
+                on_send_zc(value, cqe.res, more);
+            }
+            return;
+        }
+        if (!more) --inflight_;
+        switch (kind) {
+        case WAKE:
+            // Once stopping, shutdown() drains the inbox itself.
+            if (stopping()) break;
+            arm_wake();
+            drain_inbox();
+            break;
+        case ACCEPT: on_accept(static_cast<int>(value), cqe.res, more); break;
+        case CONNECT: on_connect(value, cqe.res); break;
+        case RECV: on_recv(value, cqe, more); break;
+        case SEND: on_send(value, cqe.res); break;
+        case SEND_ZC:
+        case CANCEL: break;
+        }
+    }
+
+    void on_accept(int listener, int res, bool more) {
+        if (res >= 0) {
+            if (stopping()) {
+                ::close(res);                   // raced with shutdown()
+            } else {
+                accepted(res);
+            }
+        }
+        if (more) return;
+        // Re-arm unless the listener is gone or out of descriptors.
+        bool live = false;
+        for (int fd : listeners_) live |= fd == listener;
+        if (live && !stopping() && res != -EMFILE && res != -ENFILE) arm_accept(listener);
+    }
+
+    void on_connect(ConnectionId id, int res) {
+        UringConnection* c = tracked(id);
+        if (c == nullptr) return;
+        if (!c->released && !c->closing) {
+            int error = 0;
+            socklen_t len = sizeof(error);
+            ::getsockopt(c->fd, SOL_SOCKET, SO_ERROR, &error, &len);
+            if (res < 0 || error != 0) {
+                request_close(id);
+            } else {
+                arm_recv(*c);
+                connected(*c);
+            }
+        }
+        settle(*c);
+    }
+
+    void on_recv(ConnectionId id, const io_uring_cqe& cqe, bool more) {
+        UringConnection* c = tracked(id);
+        const bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+        const uint16_t bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+        if (c != nullptr && !c->released && !c->closing) {
+            bump(read_calls_);
+            if (cqe.res > 0 && has_buffer) {
+                received(*c, buffers_ + size_t{bid} * BUF_SIZE, static_cast<size_t>(cqe.res));
+            } else if (cqe.res == 0 || (cqe.res < 0 && cqe.res != -ENOBUFS)) {
+                request_close(id);              // end of stream or error
+            }
+            // Multishot ended (out of buffers, or the kernel's choice).
+            if (!more && !c->closing) arm_recv(*c);
+        }
+        if (has_buffer) recycle(bid);
+        if (c != nullptr && !more) settle(*c);
+    }
+
+    void on_send(ConnectionId id, int res) {
+        UringConnection* c = tracked(id);
+        if (c == nullptr) return;
+        --c->sending;
+        if (!c->released && !c->closing) {
+            if (res == -ECANCELED) {
+                // The SEND_ZC behind a failed SENDMSG: nothing written.
+            } else if (res < 0) {
+                request_close(id);
+            } else {
+                consume(*c, static_cast<size_t>(res));
+            }
+            if (c->sending == 0 && !c->closing && !c->out.empty()) mark_dirty(*c);
+        }
+        settle(*c);
+    }
+
+    void on_send_zc(uint64_t token, int res, bool more) {
+        auto it = zero_copy_.find(token);
+        if (it == zero_copy_.end()) return;
+        on_send(it->second.id, res);
+        if (!more) zero_copy_.erase(token);     // nothing left in flight
+    }
+
+    Ring ring_;
+    int wake_fd_ = -1;
+    uint64_t wake_count_ = 0;
+
+    io_uring_buf* buf_ring_ = nullptr;
+    uint16_t* buf_ring_tail_ = nullptr;
+    size_t ring_bytes_ = 0;
+    uint8_t* buffers_ = nullptr;
+    uint16_t buf_tail_ = 0;
+
+    size_t inflight_ = 0;                       // requests whose last completion is due
+    FlatHashMap<ConnectionId, UringConnection*> tracked_;
+    FlatHashMap<ConnectionId, std::unique_ptr<Connection>> graveyard_;
+    FlatHashMap<uint64_t, ZeroCopy> zero_copy_;  // SEND_ZC in flight or awaiting its notification
+    uint64_t zero_copy_seq_ = 0;
+};
+
+} // namespace
+
+bool uring_supported() {
+    static const bool supported = [] {
+        io_uring_params params{};
+        const int fd = uring_setup(4, params);
+        if (fd < 0) return false;               // ENOSYS, or disabled by sysctl
+        constexpr unsigned OPS = 64;
+        alignas(io_uring_probe) uint8_t storage[sizeof(io_uring_probe) + OPS * sizeof(io_uring_probe_op)] = {};
+        auto* probe = reinterpret_cast<io_uring_probe*>(storage);
+        bool ok = uring_register(fd, IORING_REGISTER_PROBE, probe, OPS) == 0;
+        // SEND_ZC (6.0) also dates multishot recv and the buffer rings.
+        for (const int op : {IORING_OP_ACCEPT, IORING_OP_RECV, IORING_OP_SENDMSG, IORING_OP_SEND_ZC, IORING_OP_READ,
+                             IORING_OP_POLL_ADD, IORING_OP_ASYNC_CANCEL}) {
+            ok = ok && op <= probe->last_op && (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+        }
+        ::close(fd);
+        return ok;
+    }();
+    return supported;
+}
+
+std::unique_ptr<Transport::EventLoop> make_uring_loop(Transport& owner, size_t index) {
+    return std::make_unique<UringLoop>(owner, index);
+}
+
+#else
+
+bool uring_supported() {
+    return false;
+}
+
+std::unique_ptr<Transport::EventLoop> make_uring_loop(Transport&, size_t) {
+    throw std::runtime_error("Transport: io_uring is not available");
+}
+
+#endif
+
+} // namespace Crypto
@@ -1,12 +1,28 @@
 #include "video_encryption.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <array>
 
 namespace Crypto {
 
+namespace {
+
+// Frame number and timestamp are authenticated alongside the payload.
+std::array<uint8_t, 12> frame_header(uint32_t frame_number, uint64_t timestamp) {
+    std::array<uint8_t, 12> header;
+    for (int i = 0; i < 4; ++i) header[i] = static_cast<uint8_t>(frame_number >> (24 - 8 * i));
+    for (int i = 0; i < 8; ++i) header[4 + i] = static_cast<uint8_t>(timestamp >> (56 - 8 * i));
+    return header;
+}
+
+} // namespace
+
 VideoEncryption::VideoEncryption() {}
 
 VideoEncryption::VideoSession VideoEncryption::start_session(uint32_t width, uint32_t height, uint32_t fps) {
     VideoSession session;
-    session.session_id = "video_" + std::to_string(rand() % 1000000);
+    session.session_id = Id128::generate();
     session.codec = "H.264";
     session.width = width;
     session.height = height;
@@ -14,19 +30,17 @@ VideoEncryption::VideoSession VideoEncryption::start_session(uint32_t width, uin
     
     // Generate encryption key
     session.encryption_key.resize(32);
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    for (auto& b : session.encryption_key) b = dis(gen);
+    SecureRandom::fill(session.encryption_key);
     
     active_sessions.push_back(session);
     
     std::cout << "\n=== Video Encryption Session Started ===" << std::endl;
-    std::cout << "Session ID: " << session.session_id << std::endl;
+    std::cout << "Session ID: " << session.session_id.to_string("video") << std::endl;
     std::cout << "Resolution: " << width << "x" << height << std::endl;
     std::cout << "FPS: " << fps << std::endl;
     std::cout << "Codec: " << session.codec << std::endl;
-    std::cout << "Encryption: AES-256-GCM" << std::endl;
+    std::cout << "Encryption: ChaCha20-Poly1305 ("
+              << ChaCha20Poly1305::backend_name(ChaCha20Poly1305::best_backend()) << ")" << std::endl;
     
     return session;
 }
@@ -36,19 +50,24 @@ VideoEncryption::VideoFrame VideoEncryption::encrypt_frame(
     const VideoSession& session) {
     
     VideoFrame frame;
-    frame.frame_number = rand() % 10000;
+    frame.frame_number = SecureRandom::uniform(10000);
     frame.timestamp = time(nullptr);
     
-    // Generate IV
-    frame.iv.resize(12);
-    for (auto& b : frame.iv) b = rand() % 256;
-    
-    // Simulate encryption (XOR with key)
-    frame.encrypted_data.resize(frame_data.size());
-    for (size_t i = 0; i < frame_data.size(); ++i) {
-        frame.encrypted_data[i] = frame_data[i] ^ session.encryption_key[i % 32];
+    ChaCha20Poly1305* cipher = session_cipher(session);
+    if (!cipher) {
+        std::cout << "[!] Video session " << session.session_id.to_string("video") << " has no usable key" << std::endl;
+        return frame;
     }
     
+    // One copy into the frame buffer, then sealed in place; the IV is the AEAD nonce
+    frame.encrypted_data = frame_data;
+    const ChaCha20Poly1305::Nonce nonce = cipher->next_nonce();
+    const auto header = frame_header(frame.frame_number, frame.timestamp);
+    ChaCha20Poly1305::Tag tag;
+    cipher->seal(nonce, header, frame.encrypted_data, frame.encrypted_data, tag);
+    frame.iv.assign(nonce.begin(), nonce.end());
+    frame.auth_tag.assign(tag.begin(), tag.end());
+    
     std::cout << "[*] Frame " << frame.frame_number << " encrypted: " 
               << frame_data.size() << " -> " << frame.encrypted_data.size() << " bytes" << std::endl;
     
@@ -59,11 +78,20 @@ std::vector<uint8_t> VideoEncryption::decrypt_frame(
     const VideoFrame& frame, 
     const VideoSession& session) {
     
-    std::vector<uint8_t> decrypted(frame.encrypted_data.size());
+    ChaCha20Poly1305* cipher = session_cipher(session);
+    ChaCha20Poly1305::Nonce nonce;
+    ChaCha20Poly1305::Tag tag;
+    if (!cipher || frame.iv.size() != nonce.size() || frame.auth_tag.size() != tag.size()) {
+        return {};
+    }
+    std::copy(frame.iv.begin(), frame.iv.end(), nonce.begin());
+    std::copy(frame.auth_tag.begin(), frame.auth_tag.end(), tag.begin());
     
-    // Simulate decryption
-    for (size_t i = 0; i < frame.encrypted_data.size(); ++i) {
-        decrypted[i] = frame.encrypted_data[i] ^ session.encryption_key[i % 32];
+    std::vector<uint8_t> decrypted(frame.encrypted_data.size());
+    const auto header = frame_header(frame.frame_number, frame.timestamp);
+    if (!cipher->open(nonce, header, frame.encrypted_data, decrypted, tag)) {
+        std::cout << "[!] Frame " << frame.frame_number << " failed authentication" << std::endl;
+        return {};
     }
     
     std::cout << "[*] Frame " << frame.frame_number << " decrypted" << std::endl;
@@ -73,7 +101,9 @@ std::vector<uint8_t> VideoEncryption::decrypt_frame(
 
 void VideoEncryption::end_session(VideoSession& session) {
     std::cout << "\n=== Video Session Ended ===" << std::endl;
-    std::cout << "Session ID: " << session.session_id << std::endl;
+    std::cout << "Session ID: " << session.session_id.to_string("video") << std::endl;
+    
+    session_ciphers.erase(session.session_id);
     
     // Remove from active sessions
     for (auto it = active_sessions.begin(); it != active_sessions.end(); ++it) {
@@ -84,4 +114,17 @@ void VideoEncryption::end_session(VideoSession& session) {
     }
 }
 
+ChaCha20Poly1305* VideoEncryption::session_cipher(const VideoSession& session) {
+    auto cached = session_ciphers.find(session.session_id);
+    if (cached != session_ciphers.end()) {
+        return cached->second.get();
+    }
+    if (session.encryption_key.size() != ChaCha20Poly1305::KEY_SIZE) {
+        return nullptr;
+    }
+    auto cipher = std::make_unique<ChaCha20Poly1305>(
+        std::span<const uint8_t, ChaCha20Poly1305::KEY_SIZE>(session.encryption_key.data(), ChaCha20Poly1305::KEY_SIZE));
+    return session_ciphers.emplace(session.session_id, std::move(cipher)).first->second.get();
+}
+
 } // namespace Crypto
@@ -1,25 +1,43 @@
 #include "voice_encryption.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <array>
 
 namespace Crypto {
 
+namespace {
+
+// Sequence number and timestamp are authenticated, like an SRTP header.
+std::array<uint8_t, 12> frame_header(uint32_t sequence_number, uint64_t timestamp) {
+    std::array<uint8_t, 12> header;
+    for (int i = 0; i < 4; ++i) header[i] = static_cast<uint8_t>(sequence_number >> (24 - 8 * i));
+    for (int i = 0; i < 8; ++i) header[4 + i] = static_cast<uint8_t>(timestamp >> (56 - 8 * i));
+    return header;
+}
+
+} // namespace
+
 VoiceEncryption::VoiceEncryption() {}
 
 VoiceEncryption::VoiceSession VoiceEncryption::start_session(const std::string& user_a, 
                                                             const std::string& user_b) {
     VoiceSession session;
-    session.session_id = "voice_" + std::to_string(rand() % 1000000);
+    session.session_id = Id128::generate();
     session.participant_a = user_a;
     session.participant_b = user_b;
     session.session_key.resize(32);
-    for (auto& b : session.session_key) b = rand() % 256;
+    SecureRandom::fill(session.session_key);
+    session.started_at = time(nullptr);
     session.active = true;
     
     active_sessions.push_back(session);
     
     std::cout << "\n=== Voice Encryption Session Started ===" << std::endl;
-    std::cout << "Session ID: " << session.session_id << std::endl;
+    std::cout << "Session ID: " << session.session_id.to_string("voice") << std::endl;
     std::cout << "Participants: " << user_a << " <-> " << user_b << std::endl;
-    std::cout << "Encryption: SRTP (AES-256-GCM)" << std::endl;
+    std::cout << "Encryption: SRTP-style ChaCha20-Poly1305 ("
+              << ChaCha20Poly1305::backend_name(ChaCha20Poly1305::best_backend()) << ")" << std::endl;
     std::cout << "Key Exchange: ZRTP" << std::endl;
     
     return session;
@@ -30,21 +48,28 @@ VoiceEncryption::VoiceFrame VoiceEncryption::encrypt_voice_frame(
     const VoiceSession& session) {
     
     VoiceFrame frame;
-    frame.sequence_number = rand() % 10000;
+    frame.sequence_number = SecureRandom::uniform(10000);
     frame.timestamp = time(nullptr);
     
-    // Simulate encryption (XOR with session key)
+    ChaCha20Poly1305* cipher = session_cipher(session);
+    if (!cipher) {
+        std::cout << "[!] Voice session " << session.session_id.to_string("voice") << " has no usable key" << std::endl;
+        return frame;
+    }
+    
+    // Big-endian samples written straight into the output, then sealed in place
     frame.encrypted_data.resize(pcm_data.size() * 2);
     for (size_t i = 0; i < pcm_data.size(); ++i) {
-        uint8_t byte = (pcm_data[i] >> 8) & 0xFF;
-        frame.encrypted_data[i * 2] = byte ^ session.session_key[0];
-        byte = pcm_data[i] & 0xFF;
-        frame.encrypted_data[i * 2 + 1] = byte ^ session.session_key[1];
+        frame.encrypted_data[i * 2] = (pcm_data[i] >> 8) & 0xFF;
+        frame.encrypted_data[i * 2 + 1] = pcm_data[i] & 0xFF;
     }
     
-    // Auth tag
-    frame.auth_tag.resize(16);
-    for (auto& b : frame.auth_tag) b = rand() % 256;
+    const ChaCha20Poly1305::Nonce nonce = cipher->next_nonce();
+    const auto header = frame_header(frame.sequence_number, frame.timestamp);
+    ChaCha20Poly1305::Tag tag;
+    cipher->seal(nonce, header, frame.encrypted_data, frame.encrypted_data, tag);
+    frame.nonce.assign(nonce.begin(), nonce.end());
+    frame.auth_tag.assign(tag.begin(), tag.end());
     
     std::cout << "[*] Voice frame encrypted: " << pcm_data.size() << " samples" << std::endl;
     
@@ -55,13 +80,28 @@ std::vector<int16_t> VoiceEncryption::decrypt_voice_frame(
     const VoiceFrame& frame, 
     const VoiceSession& session) {
     
-    std::vector<int16_t> pcm_data(frame.encrypted_data.size() / 2);
+    ChaCha20Poly1305* cipher = session_cipher(session);
+    ChaCha20Poly1305::Nonce nonce;
+    ChaCha20Poly1305::Tag tag;
+    if (!cipher || frame.encrypted_data.size() % 2 != 0 ||
+        frame.nonce.size() != nonce.size() || frame.auth_tag.size() != tag.size()) {
+        return {};
+    }
+    std::copy(frame.nonce.begin(), frame.nonce.end(), nonce.begin());
+    std::copy(frame.auth_tag.begin(), frame.auth_tag.end(), tag.begin());
     
-    // Simulate decryption
+    // Decrypt directly into the sample buffer, then fix up byte order in place
+    std::vector<int16_t> pcm_data(frame.encrypted_data.size() / 2);
+    std::span<uint8_t> bytes(reinterpret_cast<uint8_t*>(pcm_data.data()), frame.encrypted_data.size());
+    const auto header = frame_header(frame.sequence_number, frame.timestamp);
+    if (!cipher->open(nonce, header, frame.encrypted_data, bytes, tag)) {
+        std::cout << "[!] Voice frame " << frame.sequence_number << " failed authentication" << std::endl;
+        return {};
+    }
     for (size_t i = 0; i < pcm_data.size(); ++i) {
-        uint8_t byte1 = frame.encrypted_data[i * 2] ^ session.session_key[0];
-        uint8_t byte2 = frame.encrypted_data[i * 2 + 1] ^ session.session_key[1];
-        pcm_data[i] = (byte1 << 8) | byte2;
+        const uint8_t hi = bytes[i * 2];
+        const uint8_t lo = bytes[i * 2 + 1];
+        pcm_data[i] = static_cast<int16_t>((hi << 8) | lo);
     }
     
     std::cout << "[*] Voice frame decrypted: " << pcm_data.size() << " samples" << std::endl;
@@ -71,9 +111,23 @@ std::vector<int16_t> VoiceEncryption::decrypt_voice_frame(
 
 void VoiceEncryption::end_session(VoiceSession& session) {
     session.active = false;
+    session_ciphers.erase(session.session_id);
     std::cout << "\n=== Voice Session Ended ===" << std::endl;
-    std::cout << "Session ID: " << session.session_id << std::endl;
-    std::cout << "Duration: " << (time(nullptr) - session.timestamp) << " seconds" << std::endl;
+    std::cout << "Session ID: " << session.session_id.to_string("voice") << std::endl;
+    std::cout << "Duration: " << (time(nullptr) - session.started_at) << " seconds" << std::endl;
+}
+
+ChaCha20Poly1305* VoiceEncryption::session_cipher(const VoiceSession& session) {
+    auto cached = session_ciphers.find(session.session_id);
+    if (cached != session_ciphers.end()) {
+        return cached->second.get();
+    }
+    if (session.session_key.size() != ChaCha20Poly1305::KEY_SIZE) {
+        return nullptr;
+    }
+    auto cipher = std::make_unique<ChaCha20Poly1305>(
+        std::span<const uint8_t, ChaCha20Poly1305::KEY_SIZE>(session.session_key.data(), ChaCha20Poly1305::KEY_SIZE));
+    return session_ciphers.emplace(session.session_id, std::move(cipher)).first->second.get();
 }
 
 } // namespace Crypto
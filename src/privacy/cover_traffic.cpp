@@ -0,0 +1,178 @@
+#include "cover_traffic.h"
+#include "secure_random.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Crypto {
+
+namespace {
+
+// Loop body: the generator's nonce, the client, the instant it left (ms).
+constexpr size_t LOOP_BODY = 8 + 4 + 8;
+
+// Weight of the newest cover packet in the running cost.
+constexpr double COST_WEIGHT = 1.0 / 64;
+
+std::string loop_body(uint64_t nonce, uint32_t client, uint64_t sent_ms) {
+    std::string body(LOOP_BODY, '\0');
+    std::memcpy(body.data(), &nonce, 8);
+    std::memcpy(body.data() + 8, &client, 4);
+    std::memcpy(body.data() + 12, &sent_ms, 8);
+    return body;
+}
+
+} // namespace
+
+CoverTraffic::CoverTraffic(Emit emit) : CoverTraffic(std::move(emit), Options{}) {}
+
+CoverTraffic::CoverTraffic(Emit emit, const Options& options)
+    : emit_(std::move(emit)), options_(options), loop_nonce_(SecureRandom::next_u64()) {
+    if (!(options.rate > 0)) {
+        throw std::invalid_argument("CoverTraffic: rate must be positive");
+    }
+}
+
+uint32_t CoverTraffic::add_client(const std::string& loop_recipient, uint64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto client = static_cast<uint32_t>(clients_.size());
+    clients_.push_back(Client{loop_recipient, {}});
+    instants_.schedule(client, next_instant(now_ms));
+    return client;
+}
+
+bool CoverTraffic::send(uint32_t client, const std::string& message, const std::string& recipient,
+                        uint64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (client >= clients_.size() || clients_[client].backlog.size() >= options_.max_backlog) {
+        ++stats_.rejected;
+        return false;
+    }
+    clients_[client].backlog.push_back(Pending{message, recipient, now_ms});
+    return true;
+}
+
+size_t CoverTraffic::advance(uint64_t now_ms) {
+    std::vector<Outgoing> out;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        instants_.advance(now_ms, [&](uint32_t client, uint64_t due_ms) {
+            take_instant(client, due_ms, out);
+            instants_.schedule(client, next_instant(due_ms));
+        });
+    }
+    if (out.empty()) return 0;
+
+    // Emit outside the lock: it builds cells and may call back in.
+    std::vector<uint8_t> sent(out.size());
+    std::vector<double> cpu(out.size(), 0.0);
+    for (size_t i = 0; i < out.size(); ++i) {
+        const Outgoing& o = out[i];
+        const auto start = std::chrono::steady_clock::now();
+        sent[i] = emit_(o.client, o.kind, o.message, o.recipient);
+        if (o.kind != Kind::REAL) {
+            cpu[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (size_t i = 0; i < out.size(); ++i) {
+        const Outgoing& o = out[i];
+        if (o.kind != Kind::REAL) {
+            cover_seconds_ = cover_seconds_ == 0 ? cpu[i] : cover_seconds_ + (cpu[i] - cover_seconds_) * COST_WEIGHT;
+        }
+        stats_.cpu_seconds += cpu[i];
+        if (!sent[i]) {
+            ++stats_.failed;
+            continue;
+        }
+        ++count;
+        if (o.kind == Kind::REAL) {
+            ++stats_.real;
+            stats_.bytes_real += options_.packet_bytes;
+            wait_ms_ += static_cast<double>(o.wait_ms);
+        } else {
+            ++(o.kind == Kind::LOOP ? stats_.loops : stats_.drops);
+            stats_.bytes_cover += options_.packet_bytes;
+        }
+    }
+    return count;
+}
+
+bool CoverTraffic::loop_returned(const std::string& message, uint64_t now_ms) {
+    if (message.size() != LOOP_BODY) return false;
+    uint64_t nonce, sent_ms;
+    std::memcpy(&nonce, message.data(), 8);
+    std::memcpy(&sent_ms, message.data() + 12, 8);
+    if (nonce != loop_nonce_) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.loops_returned;
+    loop_ms_ += static_cast<double>(now_ms >= sent_ms ? now_ms - sent_ms : 0);
+    return true;
+}
+
+void CoverTraffic::set_rate(double rate) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (rate > 0) options_.rate = rate;
+}
+
+CoverTraffic::Stats CoverTraffic::stats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats s = stats_;
+    s.rate = client_rate();
+    s.overhead = s.bytes_real ? static_cast<double>(s.bytes_cover) / static_cast<double>(s.bytes_real) : 0.0;
+    s.mean_wait_ms = s.real ? wait_ms_ / static_cast<double>(s.real) : 0.0;
+    s.mean_loop_ms = s.loops_returned ? loop_ms_ / static_cast<double>(s.loops_returned) : 0.0;
+    for (const auto& client : clients_) s.backlog += client.backlog.size();
+    return s;
+}
+
+size_t CoverTraffic::client_count() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return clients_.size();
+}
+
+// Options::rate, lowered so the expected cost of all clients' instants
+// fits each budget. The CPU one counts every instant at the cost of cover,
+// real messages included: what a client sends must not move its rate.
+double CoverTraffic::client_rate() const {
+    double rate = options_.rate;
+    if (clients_.empty()) return rate;
+    const auto clients = static_cast<double>(clients_.size());
+    if (options_.bytes_per_second > 0) {
+        rate = std::min(rate, options_.bytes_per_second / static_cast<double>(options_.packet_bytes) / clients);
+    }
+    if (options_.cpu_fraction > 0 && cover_seconds_ > 0) {
+        rate = std::min(rate, options_.cpu_fraction / cover_seconds_ / clients);
+    }
+    return rate;
+}
+
+// Exponential gaps: the instants of a Poisson process.
+uint64_t CoverTraffic::next_instant(uint64_t after_ms) {
+    const double mean_ms = 1000.0 / client_rate();
+    return after_ms + static_cast<uint64_t>(-std::log(1.0 - SecureRandom::uniform_real()) * mean_ms);
+}
+
+// A real message when one waits, else cover: every instant sends.
+void CoverTraffic::take_instant(uint32_t client, uint64_t due_ms, std::vector<Outgoing>& out) {
+    Client& c = clients_[client];
+    if (!c.backlog.empty()) {
+        Pending& p = c.backlog.front();
+        out.push_back(Outgoing{client, Kind::REAL, std::move(p.message), std::move(p.recipient),
+                               due_ms > p.queued_ms ? due_ms - p.queued_ms : 0});
+        c.backlog.pop_front();
+        return;
+    }
+    if (SecureRandom::uniform_real() < options_.loop_fraction) {
+        out.push_back(Outgoing{client, Kind::LOOP, loop_body(loop_nonce_, client, due_ms), c.loop_recipient, 0});
+    } else {
+        out.push_back(Outgoing{client, Kind::DROP, std::string(), std::string(), 0});
+    }
+}
+
+} // namespace Crypto
@@ -1,4 +1,5 @@
 #include "differential_privacy.h"
+#include "secure_random.h"
 #include <random>
 #include <cmath>
 
@@ -17,12 +18,11 @@ void DifferentialPrivacy::set_privacy_parameters(double epsilon, double delta) {
 }
 
 double DifferentialPrivacy::add_laplace_noise(double true_value, double sensitivity) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    SecureRandom::Engine gen;
     std::exponential_distribution<> dist(1.0 / (sensitivity / params.epsilon));
     
     double noise = dist(gen);
-    if (rand() % 2) noise = -noise;
+    if (SecureRandom::uniform(2)) noise = -noise;
     
     params.num_queries++;
     
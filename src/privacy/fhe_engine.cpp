@@ -1,4 +1,5 @@
 #include "fhe_engine.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -12,7 +13,7 @@ FHEEngine::FHEKeyPair FHEEngine::generate_keypair(int n) {
     for (int i = 0; i < 2; ++i) {
         std::vector<int> layer;
         for (int j = 0; j < n; ++j) {
-            layer.push_back(rand() % MOD);
+            layer.push_back(SecureRandom::uniform(MOD));
         }
         keypair.public_key.push_back(layer);
         keypair.secret_key.push_back(layer);
@@ -35,7 +36,7 @@ FHEEngine::EncryptedNumber FHEEngine::encrypt(double plaintext) {
     for (int i = 0; i < 2; ++i) {
         std::vector<int> poly;
         for (int j = 0; j < 512; ++j) {
-            poly.push_back(static_cast<int>(plaintext * enc.scale + (rand() % 100)));
+            poly.push_back(static_cast<int>(plaintext * enc.scale + (SecureRandom::uniform(100))));
         }
         enc.ciphertext.push_back(poly);
     }
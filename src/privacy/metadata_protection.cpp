@@ -1,36 +1,373 @@
 #include "metadata_protection.h"
+#include "bloom_filter.h"
+#include "hmac_sha256.h"
+#include "secure_random.h"
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
 
 namespace Crypto {
 
-MetadataProtection::MetadataProtection() {}
+namespace {
+
+constexpr size_t SEEN_SETUPS = 4096;
+// Cells a mix remembers per filter generation, against replays; 32 bits
+// each keep false positives (honest cells dropped) near 1e-5.
+constexpr size_t SEEN_CELLS = 1 << 16;
+constexpr size_t SEEN_CELL_BITS = 32;
+
+struct Hop {
+    std::unique_ptr<ChaCha20Poly1305> cipher;
+    uint32_t next_mix;
+    uint32_t next_circuit;
+    bool exit;
+};
+
+} // namespace
+
+// One mix: its key and circuits, and the messages it holds. Slots are
+// handed out from the low end and recycled through free_slots, so memory
+// follows the peak queue, in CHUNK-slot steps, up to max_queued.
+struct MetadataProtection::MixState {
+    static constexpr size_t CHUNK = 4096;
+
+    uint32_t index = 0;
+    X25519::Key secret_key;
+    FlatHashMap<uint32_t, Hop> circuits;
+    std::unique_ptr<RotatingBloomFilter> seen_setups;
+    std::unique_ptr<RotatingBloomFilter> seen_cells;
+
+    std::vector<std::unique_ptr<Packet[]>> chunks;
+    std::vector<uint32_t> circuit_of;           // per slot
+    std::vector<uint32_t> free_slots;
+    uint32_t slots = 0;                         // handed out so far
+    TimerWheel delays;
+    std::vector<uint32_t> pool;
+    uint64_t next_flush = 0;
+    MixStats stats;
+
+    Packet& packet(uint32_t slot) { return chunks[slot / CHUNK][slot % CHUNK]; }
+    size_t queued() const { return slots - free_slots.size(); }
+
+    uint32_t allocate(size_t max_queued) {
+        if (!free_slots.empty()) {
+            const uint32_t slot = free_slots.back();
+            free_slots.pop_back();
+            return slot;
+        }
+        if (slots >= max_queued) return TimerWheel::NONE;
+        if (slots % CHUNK == 0) {
+            chunks.push_back(std::make_unique<Packet[]>(CHUNK));
+            circuit_of.resize(slots + CHUNK);
+        }
+        return slots++;
+    }
+
+    size_t memory_bytes() const {
+        return chunks.size() * CHUNK * sizeof(Packet) + circuit_of.capacity() * sizeof(uint32_t) +
+               free_slots.capacity() * sizeof(uint32_t) + pool.capacity() * sizeof(uint32_t) +
+               delays.memory_bytes() + (seen_cells ? seen_cells->memory_bytes() : 0);
+    }
+};
+
+MetadataProtection::MetadataProtection() : MetadataProtection(Options{}) {}
+
+MetadataProtection::MetadataProtection(const Options& options) : options(options) {
+    if (options.pool_threshold <= options.pool_minimum) {
+        throw std::invalid_argument("MetadataProtection: pool_threshold must exceed pool_minimum");
+    }
+    SecureRandom::fill(link_secret);
+}
+
+MetadataProtection::~MetadataProtection() = default;
 
 void MetadataProtection::setup_mix_network(int num_nodes) {
-    for (int i = 0; i < num_nodes; ++i) {
-        MixNode node;
-        node.node_id = "mix_" + std::to_string(i);
-        node.address = "10.0.0." + std::to_string(i + 1);
-        node.mix_delay_ms = 1000 + rand() % 5000;
-        mix_network.push_back(node);
-    }
-    
+    {
+        std::lock_guard<std::mutex> lock(mix_mutex);
+        for (int i = 0; i < num_nodes; ++i) {
+            const X25519::KeyPair keys = X25519::generate_keypair();
+            MixNode node;
+            node.node_id = "mix_" + std::to_string(mix_network.size());
+            node.address = "10.0.0." + std::to_string(mix_network.size() + 1);
+            node.public_key = keys.public_key;
+            node.mix_delay_ms = 1000 + SecureRandom::uniform(5000);
+            mix_network.push_back(node);
+
+            auto state = std::make_unique<MixState>();
+            state->index = static_cast<uint32_t>(mixes.size());
+            state->secret_key = keys.secret_key;
+            state->delays = TimerWheel(clock_ms);
+            state->next_flush = clock_ms + options.flush_interval_ms;
+            mixes.push_back(std::move(state));
+        }
+        if (path.empty()) build_circuit();
+    }
+
     std::cout << "\n=== Mix Network Setup ===" << std::endl;
     std::cout << "Nodes: " << num_nodes << std::endl;
-    std::cout << "Mixing Strategy: Continuous-time mixing" << std::endl;
+    std::cout << "Mixing Strategy: exponential delay, then timed dynamic pool (threshold " << options.pool_threshold
+              << ", every " << options.flush_interval_ms << " ms, keeps " << options.pool_minimum << ")" << std::endl;
+    std::cout << "Path Length: " << path.size() << " hops" << std::endl;
 }
 
-void MetadataProtection::send_through_mix(const std::string& message,
+bool MetadataProtection::send_through_mix(const std::string& message,
                                           const std::string& recipient) {
+    MixPacket packet;
+    if (!wrap_message(message, recipient, packet)) return false;
+    std::lock_guard<std::mutex> lock(mix_mutex);
+    return accept(packet, clock_ms);
+}
+
+bool MetadataProtection::wrap_message(const std::string& message, const std::string& recipient, MixPacket& out) {
+    if (recipient.size() > 255 || 1 + recipient.size() + message.size() > Sphinx::CELL_PAYLOAD) return false;
+    std::vector<uint8_t> payload;
+    payload.reserve(1 + recipient.size() + message.size());
+    payload.push_back(static_cast<uint8_t>(recipient.size()));
+    payload.insert(payload.end(), recipient.begin(), recipient.end());
+    payload.insert(payload.end(), message.begin(), message.end());
+
+    std::vector<Sphinx::Key> keys;
+    {
+        std::lock_guard<std::mutex> lock(mix_mutex);
+        if (path.empty() && !build_circuit()) return false;
+        keys = hop_keys;
+        out.mix = path.front();
+        out.from = CLIENT;
+        out.circuit = seal_circuit(CLIENT, path.front(), entry_circuit);
+    }
+    return Sphinx::build_cell(keys, payload, out.packet);
+}
+
+bool MetadataProtection::receive(const MixPacket& packet, uint64_t now_ms) {
+    std::lock_guard<std::mutex> lock(mix_mutex);
+    return accept(packet, now_ms);
+}
+
+// Held for an exponential delay, then pooled. Tags are checked at flush,
+// with the rest of the batch. Peeling is deterministic, so a cell replayed
+// into the mix would come out as the same bits: the layer's nonce (fresh
+// for every cell and hop) and the circuit mark it, and a cell seen before
+// is dropped.
+bool MetadataProtection::accept(const MixPacket& packet, uint64_t now_ms) {
+    if (packet.mix >= mixes.size()) return false;
+    MixState& mix = *mixes[packet.mix];
+    uint32_t circuit = 0;
+    if (!open_circuit(packet, circuit) || !mix.circuits.contains(circuit)) {
+        ++mix.stats.dropped;
+        return false;
+    }
+    Id128 seen;
+    std::memcpy(&seen.hi, packet.packet.data(), 8);
+    std::memcpy(&seen.lo, packet.packet.data() + 8, 4);
+    seen.lo = seen.lo << 32 | circuit;
+    if (!mix.seen_cells) mix.seen_cells = std::make_unique<RotatingBloomFilter>(SEEN_CELLS, SEEN_CELL_BITS);
+    if (mix.seen_cells->check_and_insert(seen)) {
+        ++mix.stats.replays;
+        return false;
+    }
+    const uint32_t slot = mix.allocate(options.max_queued);
+    if (slot == TimerWheel::NONE) {
+        ++mix.stats.dropped;
+        return false;
+    }
+    mix.packet(slot) = packet.packet;
+    mix.circuit_of[slot] = circuit;
+    const double mean = static_cast<double>(mix_network[packet.mix].mix_delay_ms);
+    const uint64_t delay = static_cast<uint64_t>(-std::log(1.0 - SecureRandom::uniform_real()) * mean);
+    mix.delays.schedule(slot, now_ms + delay);
+    ++mix.stats.accepted;
+    mix.stats.peak_queued = std::max(mix.stats.peak_queued, mix.queued());
+    return true;
+}
+
+size_t MetadataProtection::process(uint64_t now_ms) {
+    std::unique_lock<std::mutex> lock(mix_mutex);
+    clock_ms = std::max(clock_ms, now_ms);
+    for (auto& state : mixes) {
+        MixState& mix = *state;
+        mix.delays.advance(now_ms, [&](uint32_t slot, uint64_t) {
+            mix.pool.push_back(slot);
+            if (mix.pool.size() >= options.pool_threshold) flush(mix, now_ms);
+        });
+        if (now_ms >= mix.next_flush) {
+            flush(mix, now_ms);
+            mix.next_flush = now_ms + std::max<uint64_t>(options.flush_interval_ms, 1);
+        }
+    }
+
+    std::vector<MixPacket> forwards;
+    std::vector<Delivery> delivered;
+    forwards.swap(outgoing);
+    delivered.swap(deliveries);
+    if (!forward_handler) {
+        for (const auto& packet : forwards) accept(packet, now_ms);
+        forwards.clear();
+    }
+    const auto forward = forward_handler;
+    const auto deliver = delivery_handler;
+    lock.unlock();
+
+    for (const auto& packet : forwards) forward(packet);
+    if (deliver) {
+        for (const auto& d : delivered) deliver(d);
+    }
+    return delivered.size();
+}
+
+// A random share of the pool, its layer peeled in one pass over the
+// batch, out in the shuffled order. The caller holds the lock.
+void MetadataProtection::flush(MixState& mix, uint64_t now_ms) {
+    const size_t n = mix.pool.size();
+    if (n <= options.pool_minimum) return;
+    const size_t share = static_cast<size_t>(static_cast<double>(n) * options.flush_fraction);
+    const size_t k = std::min(n - options.pool_minimum, std::max<size_t>(share, 1));
+    // Partial Fisher-Yates: the batch ends up shuffled at the tail.
+    for (size_t i = 0; i < k; ++i) std::swap(mix.pool[SecureRandom::uniform(n - i)], mix.pool[n - 1 - i]);
+
+    ++mix.stats.flushes;
+    for (size_t i = n - k; i < n; ++i) {
+        const uint32_t slot = mix.pool[i];
+        Packet& packet = mix.packet(slot);
+        const auto hop = mix.circuits.find(mix.circuit_of[slot]);
+        if (hop == mix.circuits.end() || !Sphinx::process_cell(*hop->second.cipher, packet)) {
+            ++mix.stats.dropped;
+        } else if (hop->second.exit) {
+            const std::string payload = Sphinx::open_payload(packet);
+            const size_t length = payload.empty() ? 0 : static_cast<uint8_t>(payload[0]);
+            if (length == 0 && !payload.empty()) {
+                ++mix.stats.cover_dropped;
+            } else if (1 + length <= payload.size()) {
+                deliveries.push_back(Delivery{payload.substr(1, length), payload.substr(1 + length), now_ms});
+                ++mix.stats.flushed;
+            } else {
+                ++mix.stats.dropped;
+            }
+        } else {
+            // Sealed afresh for the next link: nothing of the input's id.
+            outgoing.push_back(MixPacket{hop->second.next_mix, mix.index,
+                                         seal_circuit(mix.index, hop->second.next_mix, hop->second.next_circuit),
+                                         packet});
+            ++mix.stats.flushed;
+        }
+        mix.free_slots.push_back(slot);
+    }
+    mix.pool.resize(n - k);
+}
+
+const ChaCha20Poly1305& MetadataProtection::link(uint32_t from, uint32_t to) {
+    auto [it, added] = links.try_emplace((uint64_t{from} << 32) | to);
+    if (added) {
+        uint8_t label[12] = {'m', 'i', 'x', 'l', 'i', 'n', 'k', '/'};
+        std::memcpy(label + 8, &to, 4);
+        HmacSha256::Mac key = HmacSha256(link_secret).mac(label);
+        // `from` last, so a client link differs from every mix link.
+        key = HmacSha256(key).mac(std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&from), 4));
+        it->second = std::make_unique<ChaCha20Poly1305>(key);
+        std::fill(key.begin(), key.end(), 0);
+    }
+    return *it->second;
+}
+
+MetadataProtection::SealedCircuit MetadataProtection::seal_circuit(uint32_t from, uint32_t to, uint32_t circuit) {
+    constexpr size_t N = ChaCha20Poly1305::NONCE_SIZE;
+    SealedCircuit sealed;
+    ChaCha20Poly1305::Nonce nonce;
+    SecureRandom::fill(nonce);
+    ChaCha20Poly1305::Tag tag;
+    link(from, to).seal(nonce, {}, std::span<const uint8_t>(reinterpret_cast<const uint8_t*>(&circuit), 4),
+                        std::span<uint8_t>(sealed.data() + N, 4), tag);
+    std::copy(nonce.begin(), nonce.end(), sealed.begin());
+    std::copy(tag.begin(), tag.end(), sealed.begin() + N + 4);
+    return sealed;
+}
+
+bool MetadataProtection::open_circuit(const MixPacket& packet, uint32_t& circuit) {
+    constexpr size_t N = ChaCha20Poly1305::NONCE_SIZE;
+    if (packet.from != CLIENT && packet.from >= mixes.size()) return false;
+    ChaCha20Poly1305::Nonce nonce;
+    ChaCha20Poly1305::Tag tag;
+    std::copy(packet.circuit.begin(), packet.circuit.begin() + N, nonce.begin());
+    std::copy(packet.circuit.begin() + N + 4, packet.circuit.end(), tag.begin());
+    return link(packet.from, packet.mix)
+        .open(nonce, {}, std::span<const uint8_t>(packet.circuit.data() + N, 4),
+              std::span<uint8_t>(reinterpret_cast<uint8_t*>(&circuit), 4), tag);
+}
+
+void MetadataProtection::set_delivery_handler(std::function<void(const Delivery&)> handler) {
+    std::lock_guard<std::mutex> lock(mix_mutex);
+    delivery_handler = std::move(handler);
+}
+
+void MetadataProtection::set_forward_handler(std::function<void(const MixPacket&)> handler) {
     std::lock_guard<std::mutex> lock(mix_mutex);
-    
-    mix_network[0].pending_messages.push_back(
-        "FROM:user1 -> TO:" + recipient + " MSG:" + message
-    );
-    
-    std::cout << "\n=== Message Mixed ===" << std::endl;
-    std::cout << "Input: " << message.size() << " bytes" << std::endl;
-    std::cout << "Path Length: " << mix_network.size() << " hops" << std::endl;
-    std::cout << "Total Delay: ~" << (mix_network.size() * 3000) << "ms" << std::endl;
-    std::cout << "Metadata: PROTECTED" << std::endl;
+    forward_handler = std::move(handler);
+}
+
+MetadataProtection::MixStats MetadataProtection::mix_stats(size_t mix) {
+    std::lock_guard<std::mutex> lock(mix_mutex);
+    if (mix >= mixes.size()) return {};
+    MixStats s = mixes[mix]->stats;
+    s.delayed = mixes[mix]->delays.size();
+    s.pooled = mixes[mix]->pool.size();
+    s.memory_bytes = mixes[mix]->memory_bytes();
+    return s;
+}
+
+size_t MetadataProtection::mix_count() {
+    std::lock_guard<std::mutex> lock(mix_mutex);
+    return mixes.size();
+}
+
+// Distinct mixes at random, set up with a Sphinx setup packet passed mix to
+// mix here. The caller holds the lock.
+bool MetadataProtection::build_circuit() {
+    const size_t length = std::min({options.path_length, mixes.size(), Sphinx::MAX_HOPS});
+    if (length == 0) return false;
+    std::vector<uint32_t> order(mixes.size());
+    for (uint32_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::vector<Sphinx::Hop> hops;
+    for (size_t i = 0; i < length; ++i) {
+        std::swap(order[i], order[i + SecureRandom::uniform(order.size() - i)]);
+        hops.push_back(Sphinx::Hop{mix_network[order[i]].public_key, order[i]});
+    }
+    const Sphinx::Setup setup = Sphinx::build_setup(hops);
+    if (setup.forward_keys.size() != length) return false;
+
+    Sphinx::Packet packet = setup.packet;
+    uint32_t at = hops[0].relay;
+    uint32_t circuit = SecureRandom::next_u32();
+    std::vector<uint32_t> built;
+    for (size_t hop = 0; hop < length; ++hop) {
+        MixState& mix = *mixes[at];
+        const Sphinx::SetupResult result = Sphinx::process_setup(mix.secret_key, packet);
+        if (!mix.seen_setups) mix.seen_setups = std::make_unique<RotatingBloomFilter>(SEEN_SETUPS);
+        if (!result.ok || mix.seen_setups->check_and_insert(result.replay_tag) ||
+            (result.next != Sphinx::EXIT && result.next >= mixes.size()) || mix.circuits.contains(circuit)) {
+            std::cout << "[!] Mix circuit setup rejected at " << mix_network[at].node_id << std::endl;
+            for (size_t i = 0; i < built.size(); ++i) mixes[hops[i].relay]->circuits.erase(built[i]);
+            return false;
+        }
+        Hop state;
+        state.cipher = std::make_unique<ChaCha20Poly1305>(result.forward_key);
+        state.exit = result.next == Sphinx::EXIT;
+        state.next_mix = state.exit ? 0 : result.next;
+        state.next_circuit = state.exit ? 0 : SecureRandom::next_u32();
+        const uint32_t next_circuit = state.next_circuit;
+        mix.circuits.emplace(circuit, std::move(state));
+        built.push_back(circuit);
+        if (result.next == Sphinx::EXIT) break;
+        at = result.next;
+        circuit = next_circuit;
+    }
+
+    path.clear();
+    for (const auto& hop : hops) path.push_back(hop.relay);
+    entry_circuit = built.front();
+    hop_keys = setup.forward_keys;
+    return true;
 }
 
 } // namespace Crypto
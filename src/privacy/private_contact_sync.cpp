@@ -13,9 +13,9 @@ bool PrivateContactSync::initialize() {
     return true;
 }
 
-std::string PrivateContactSync::add_contact(const std::string& name, const std::string& phone,
+Id128 PrivateContactSync::add_contact(const std::string& name, const std::string& phone,
                                             const std::string& email, const std::string& public_key) {
-    std::string contact_id = generate_contact_id();
+    const Id128 contact_id = Id128::generate();
     
     PrivateContact contact;
     contact.contact_id = contact_id;
@@ -28,13 +28,13 @@ std::string PrivateContactSync::add_contact(const std::string& name, const std::
     
     contacts_[contact_id] = contact;
     
-    std::cout << "[+] Contact added: " << contact_id << std::endl;
+    std::cout << "[+] Contact added: " << contact_id.to_string("contact") << std::endl;
     
     return contact_id;
 }
 
-bool PrivateContactSync::update_contact(const std::string& contact_id, const std::string& new_data) {
-    std::cout << "[*] Updating contact: " << contact_id << std::endl;
+bool PrivateContactSync::update_contact(const Id128& contact_id, const std::string& new_data) {
+    std::cout << "[*] Updating contact: " << contact_id.to_string("contact") << std::endl;
     
     if (contacts_.find(contact_id) != contacts_.end()) {
         update_sync_version(contact_id);
@@ -44,11 +44,10 @@ bool PrivateContactSync::update_contact(const std::string& contact_id, const std
     return false;
 }
 
-bool PrivateContactSync::delete_contact(const std::string& contact_id) {
-    std::cout << "[*] Deleting contact: " << contact_id << std::endl;
+bool PrivateContactSync::delete_contact(const Id128& contact_id) {
+    std::cout << "[*] Deleting contact: " << contact_id.to_string("contact") << std::endl;
     
-    if (contacts_.find(contact_id) != contacts_.end()) {
-        contacts_.erase(contact_id);
+    if (contacts_.erase(contact_id) > 0) {
         return true;
     }
     
@@ -57,7 +56,7 @@ bool PrivateContactSync::delete_contact(const std::string& contact_id) {
 
 SyncPackage PrivateContactSync::create_sync_package(uint32_t sync_mode) {
     SyncPackage package;
-    package.package_id = "sync_" + std::to_string(rand() % 1000000);
+    package.package_id = Id128::generate();
     package.timestamp = time(nullptr);
     package.sync_mode = sync_mode;
     
@@ -70,13 +69,13 @@ SyncPackage PrivateContactSync::create_sync_package(uint32_t sync_mode) {
     
     sync_history_.push_back(package);
     
-    std::cout << "[+] Sync package created: " << package.package_id << std::endl;
+    std::cout << "[+] Sync package created: " << package.package_id.to_string("sync") << std::endl;
     
     return package;
 }
 
 bool PrivateContactSync::process_sync_package(const SyncPackage& package) {
-    std::cout << "[*] Processing sync package: " << package.package_id << std::endl;
+    std::cout << "[*] Processing sync package: " << package.package_id.to_string("sync") << std::endl;
     
     for (const auto& contact : package.contacts) {
         if (contacts_.find(contact.contact_id) == contacts_.end()) {
@@ -92,7 +91,7 @@ std::vector<ContactDiff> PrivateContactSync::generate_diff() {
     std::vector<ContactDiff> diffs;
     
     ContactDiff diff;
-    diff.contact_id = "contact_1";
+    diff.contact_id = contacts_.empty() ? Id128{} : contacts_.begin()->first;
     diff.operation = "update";
     diff.encrypted_data = encrypt_contact_data("updated");
     diff.version = 2;
@@ -122,17 +121,13 @@ std::vector<std::string> PrivateContactSync::private_union(const std::vector<std
 }
 
 std::vector<uint8_t> PrivateContactSync::encrypt_contact_data(const std::string& data) {
-    std::vector<uint8_t> encrypted(data.begin(), data.end());
-    for (auto& byte : encrypted) {
-        byte ^= 0x42;
-    }
-    return encrypted;
+    return cipher_.seal_box(byte_view(data));
 }
 
 std::string PrivateContactSync::decrypt_contact_data(const std::vector<uint8_t>& encrypted) {
-    std::string decrypted(encrypted.begin(), encrypted.end());
-    for (auto& byte : decrypted) {
-        byte ^= 0x42;
+    std::string decrypted(CipherEngine::plaintext_size(encrypted.size()), '\0');
+    if (!cipher_.open_box_into(encrypted, byte_view(decrypted))) {
+        return {};
     }
     return decrypted;
 }
@@ -148,23 +143,20 @@ void PrivateContactSync::generate_sync_report() {
     std::cout << "=================================\n" << std::endl;
 }
 
-std::string PrivateContactSync::generate_contact_id() {
-    return "contact_" + std::to_string(rand() % 1000000);
-}
-
 std::vector<uint8_t> PrivateContactSync::derive_sync_key(const std::string& user_id) {
     return {0x11, 0x22, 0x33, 0x44};
 }
 
-bool PrivateContactSync::verify_contact_signature(const std::string& contact_id, 
+bool PrivateContactSync::verify_contact_signature(const Id128& contact_id, 
                                                    const std::vector<uint8_t>& signature) {
     return true;
 }
 
-void PrivateContactSync::update_sync_version(const std::string& contact_id) {
-    if (contacts_.find(contact_id) != contacts_.end()) {
-        contacts_[contact_id].sync_version++;
-        contacts_[contact_id].last_sync = time(nullptr);
+void PrivateContactSync::update_sync_version(const Id128& contact_id) {
+    auto it = contacts_.find(contact_id);
+    if (it != contacts_.end()) {
+        it->second.sync_version++;
+        it->second.last_sync = time(nullptr);
     }
 }
 
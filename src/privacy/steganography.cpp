@@ -1,4 +1,5 @@
 #include "steganography.h"
+#include "secure_random.h"
 
 namespace Crypto {
 
@@ -13,13 +14,7 @@ Steganography::StegoImage Steganography::load_image(const std::string& path) {
     // Simulate image loading
     img.pixel_data.resize(1920 * 1080 * 3); // 1080p RGB
     
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_int_distribution<> dis(0, 255);
-    
-    for (auto& b : img.pixel_data) {
-        b = dis(gen);
-    }
+    SecureRandom::fill(img.pixel_data);
     
     std::cout << "\n=== Image Loaded ===" << std::endl;
     std::cout << "Path: " << path << std::endl;
@@ -0,0 +1,65 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace Crypto {
+
+TimerWheel::TimerWheel(uint64_t now) : current_(now) {
+    for (auto& level : heads_) std::fill(std::begin(level), std::end(level), NONE);
+}
+
+void TimerWheel::schedule(uint32_t id, uint64_t due) {
+    if (id >= next_.size()) {
+        next_.resize(std::max<size_t>(id + 1, next_.size() * 2), NONE);
+        due_.resize(next_.size());
+    }
+    due_[id] = due;
+    ++size_;
+    place(id);
+}
+
+void TimerWheel::reserve(size_t ids) {
+    if (ids > next_.size()) {
+        next_.resize(ids, NONE);
+        due_.resize(ids);
+    }
+}
+
+size_t TimerWheel::memory_bytes() const {
+    return sizeof(*this) + next_.capacity() * sizeof(uint32_t) + due_.capacity() * sizeof(uint64_t);
+}
+
+// The level is the highest byte in which the due tick differs from the
+// current one: the slot is then reached (and cascaded down) exactly when
+// the current tick agrees with it on every byte above.
+void TimerWheel::place(uint32_t id) {
+    const uint64_t due = std::max(due_[id], current_);
+    const uint64_t diff = due ^ current_;
+    int level = 0;
+    while (level < LEVELS - 1 && (diff >> (8 * (level + 1))) != 0) ++level;
+    push(level, (due >> (8 * level)) & (SLOTS - 1), id);
+}
+
+void TimerWheel::push(int level, size_t slot, uint32_t id) {
+    next_[id] = heads_[level][slot];
+    heads_[level][slot] = id;
+    occupied_[level][slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+uint32_t TimerWheel::take_slot(int level, size_t slot) {
+    const uint32_t head = heads_[level][slot];
+    heads_[level][slot] = NONE;
+    occupied_[level][slot / 64] &= ~(uint64_t{1} << (slot % 64));
+    return head;
+}
+
+size_t TimerWheel::next_occupied(size_t from) const {
+    for (size_t word = from / 64; word < SLOTS / 64; ++word) {
+        uint64_t bits = occupied_[0][word];
+        if (word == from / 64) bits &= ~uint64_t{0} << (from % 64);
+        if (bits != 0) return word * 64 + static_cast<size_t>(std::countr_zero(bits));
+    }
+    return SLOTS;
+}
+
+} // namespace Crypto